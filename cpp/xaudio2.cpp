@@ -3,6 +3,8 @@
 
 #include <FAPOBase.h>
 
+#include <stdlib.h>
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // IXAudio2VoiceCallback
@@ -59,6 +61,60 @@ static void FAUDIOCALL OnVoiceProcessingPassStart(
 #endif // XAUDIO2_VERSION >= 1
 }
 
+// Applications tend to implement the callbacks they don't need as empty
+// methods, which would still cost a thunk and a virtual call on every voice,
+// every pass. An empty method compiles down to a lone return, so with
+// FAUDIO_SKIP_EMPTY_CALLBACKS=1 the code each vtable slot points to is checked
+// and those callbacks are left NULL, which FAudio skips. Anything that isn't
+// recognized is called as usual.
+//
+// This reads the application's code, which faults if it is mapped execute-only,
+// and only knows what common compilers emit, so it is never done by default.
+static bool skip_empty_callbacks()
+{
+	const char *env = getenv("FAUDIO_SKIP_EMPTY_CALLBACKS");
+	return env != NULL && *env == '1';
+}
+
+static bool is_empty_method(const void *method)
+{
+	const uint8_t *code = (const uint8_t *) method;
+
+	// follow incremental linking thunks, but not forever
+	for (int i = 0; i < 4; ++i)
+	{
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+		// endbr32/endbr64
+		if (	code[0] == 0xF3 && code[1] == 0x0F && code[2] == 0x1E &&
+			(code[3] == 0xFA || code[3] == 0xFB)	)
+		{
+			code += 4;
+		}
+
+		if (code[0] == 0xE9) // jmp rel32
+		{
+			code += 5 + *reinterpret_cast<const int32_t *>(code + 1);
+			continue;
+		}
+		if (code[0] == 0xEB) // jmp rel8
+		{
+			code += 2 + (int8_t) code[1];
+			continue;
+		}
+
+		// ret, or ret imm16 for __stdcall
+		return code[0] == 0xC3 || code[0] == 0xC2;
+#elif defined(_M_ARM64) || defined(__aarch64__)
+		// ret
+		return	code[0] == 0xC0 && code[1] == 0x03 &&
+			code[2] == 0x5F && code[3] == 0xD6;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
 FAudioVoiceCppCallback *wrap_voice_callback(IXAudio2VoiceCallback *com_interface)
 {
 	if (com_interface == NULL)
@@ -67,15 +123,29 @@ FAudioVoiceCppCallback *wrap_voice_callback(IXAudio2VoiceCallback *com_interface
 	}
 
 	FAudioVoiceCppCallback *cb = new FAudioVoiceCppCallback();
-	cb->callbacks.OnBufferEnd = OnBufferEnd;
+	cb->callbacks.OnVoiceProcessingPassStart = OnVoiceProcessingPassStart;
+	cb->callbacks.OnVoiceProcessingPassEnd = OnVoiceProcessingPassEnd;
+	cb->callbacks.OnStreamEnd = OnStreamEnd;
 	cb->callbacks.OnBufferStart = OnBufferStart;
+	cb->callbacks.OnBufferEnd = OnBufferEnd;
 	cb->callbacks.OnLoopEnd = OnLoopEnd;
-	cb->callbacks.OnStreamEnd = OnStreamEnd;
 	cb->callbacks.OnVoiceError = OnVoiceError;
-	cb->callbacks.OnVoiceProcessingPassEnd = OnVoiceProcessingPassEnd;
-	cb->callbacks.OnVoiceProcessingPassStart = OnVoiceProcessingPassStart;
 	cb->com = com_interface;
 
+	if (skip_empty_callbacks())
+	{
+		// slots are in the order IXAudio2VoiceCallback declares them
+		void **vtable = *reinterpret_cast<void ***>(com_interface);
+
+		if (is_empty_method(vtable[0])) cb->callbacks.OnVoiceProcessingPassStart = NULL;
+		if (is_empty_method(vtable[1])) cb->callbacks.OnVoiceProcessingPassEnd = NULL;
+		if (is_empty_method(vtable[2])) cb->callbacks.OnStreamEnd = NULL;
+		if (is_empty_method(vtable[3])) cb->callbacks.OnBufferStart = NULL;
+		if (is_empty_method(vtable[4])) cb->callbacks.OnBufferEnd = NULL;
+		if (is_empty_method(vtable[5])) cb->callbacks.OnLoopEnd = NULL;
+		if (is_empty_method(vtable[6])) cb->callbacks.OnVoiceError = NULL;
+	}
+
 	return cb;
 }
 
@@ -1324,7 +1394,7 @@ public:
 
 	COM_METHOD(HRESULT) CommitChanges(UINT32 OperationSet)
 	{
-		return FAudio_CommitChanges(faudio);
+		return FAudio_CommitOperationSet(faudio, OperationSet);
 	}
 
 	COM_METHOD(void) GetPerformanceData(XAUDIO2_PERFORMANCE_DATA *pPerfData)
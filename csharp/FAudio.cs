@@ -400,6 +400,13 @@ public static class FAudio
 		IntPtr audio /* FAudio* */
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern uint FAudio_CommitOperationSet(
+		IntPtr audio, /* FAudio* */
+		uint OperationSet
+	);
+
+	/* DEPRECATED, use FAudio_CommitOperationSet! */
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern uint FAudio_CommitChanges(
 		IntPtr audio /* FAudio* */
@@ -525,6 +532,18 @@ public static class FAudio
 		uint OperationSet
 	);
 
+	/* The pointer overloads below are for calls made every frame. Everything
+	 * they take is blittable, so stackalloc'd or pinned memory goes straight
+	 * to FAudio without any allocation or copy.
+	 */
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FAudioVoice_SetChannelVolumes(
+		IntPtr voice, /* FAudioVoice* */
+		uint Channels,
+		float* pVolumes,
+		uint OperationSet
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern void FAudioVoice_GetChannelVolumes(
 		IntPtr voice, /* FAudioVoice* */
@@ -532,6 +551,13 @@ public static class FAudio
 		float[] pVolumes
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void FAudioVoice_GetChannelVolumes(
+		IntPtr voice, /* FAudioVoice* */
+		uint Channels,
+		float* pVolumes
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern uint FAudioVoice_SetOutputMatrix(
 		IntPtr voice, /* FAudioVoice* */
@@ -542,6 +568,16 @@ public static class FAudio
 		uint OperationSet
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FAudioVoice_SetOutputMatrix(
+		IntPtr voice, /* FAudioVoice* */
+		IntPtr pDestinationVoice, /* FAudioVoice* */
+		uint SourceChannels,
+		uint DestinationChannels,
+		float* pLevelMatrix,
+		uint OperationSet
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern void FAudioVoice_GetOutputMatrix(
 		IntPtr voice, /* FAudioVoice* */
@@ -551,6 +587,15 @@ public static class FAudio
 		float[] pLevelMatrix
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void FAudioVoice_GetOutputMatrix(
+		IntPtr voice, /* FAudioVoice* */
+		IntPtr pDestinationVoice, /* FAudioVoice* */
+		uint SourceChannels,
+		uint DestinationChannels,
+		float* pLevelMatrix
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern void FAudioVoice_DestroyVoice(
 		IntPtr voice /* FAudioVoice* */
@@ -579,6 +624,13 @@ public static class FAudio
 		IntPtr pBufferWMA /* const FAudioBufferWMA* */
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FAudioSourceVoice_SubmitSourceBuffer(
+		IntPtr voice, /* FAudioSourceVoice* */
+		FAudioBuffer* pBuffer,
+		FAudioBufferWMA* pBufferWMA
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern uint FAudioSourceVoice_FlushSourceBuffers(
 		IntPtr voice /* FAudioSourceVoice* */
@@ -602,6 +654,13 @@ public static class FAudio
 		uint Flags
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void FAudioSourceVoice_GetState(
+		IntPtr voice, /* FAudioSourceVoice* */
+		FAudioVoiceState* pVoiceState,
+		uint Flags
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern uint FAudioSourceVoice_SetFrequencyRatio(
 		IntPtr voice, /* FAudioSourceVoice* */
@@ -1603,6 +1662,14 @@ public static class FAudio
 		float[] pMatrixCoefficients
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FACTWave_SetMatrixCoefficients(
+		IntPtr pWave, /* FACTWave* */
+		uint uSrcChannelCount,
+		uint uDstChannelCount,
+		float* pMatrixCoefficients
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern uint FACTWave_GetProperties(
 		IntPtr pWave, /* FACTWave* */
@@ -1641,6 +1708,14 @@ public static class FAudio
 		float[] pMatrixCoefficients
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FACTCue_SetMatrixCoefficients(
+		IntPtr pCue, /* FACTCue* */
+		uint uSrcChannelCount,
+		uint uDstChannelCount,
+		float* pMatrixCoefficients
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	private static extern ushort FACTCue_GetVariableIndex(
 		IntPtr pCue, /* FACTCue* */
@@ -1697,6 +1772,15 @@ public static class FAudio
 		float[] pLevelMatrix /* SourceChannels * DestinationChannels */
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FACTCue_SetOutputVoiceMatrix(
+		IntPtr pCue, /* FACTCue* */
+		IntPtr pDestinationVoice, /* Optional FAudioVoice* */
+		uint SourceChannels,
+		uint DestinationChannels,
+		float* pLevelMatrix /* SourceChannels * DestinationChannels */
+	);
+
 	#endregion
 
 	#region F3DAudio API
@@ -1903,6 +1987,36 @@ public static class FAudio
 		ref F3DAUDIO_DSP_SETTINGS pDSPSettings
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void F3DAudioCalculate(
+		byte* Instance, // F3DAUDIO_HANDLE
+		F3DAUDIO_LISTENER* pListener,
+		F3DAUDIO_EMITTER* pEmitter,
+		uint Flags,
+		F3DAUDIO_DSP_SETTINGS* pDSPSettings
+	);
+
+	/* See "extensions/CalculateBatchEXT.txt" for more information. */
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern void F3DAudioCalculateBatchEXT(
+		byte[] Instance, // F3DAUDIO_HANDLE
+		ref F3DAUDIO_LISTENER pListener,
+		F3DAUDIO_EMITTER[] pEmitters,
+		uint EmitterCount,
+		uint Flags,
+		[In, Out] F3DAUDIO_DSP_SETTINGS[] pDSPSettings
+	);
+
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void F3DAudioCalculateBatchEXT(
+		byte* Instance, // F3DAUDIO_HANDLE
+		F3DAUDIO_LISTENER* pListener,
+		F3DAUDIO_EMITTER* pEmitters,
+		uint EmitterCount,
+		uint Flags,
+		F3DAUDIO_DSP_SETTINGS* pDSPSettings
+	);
+
 	#endregion
 
 	#region FACT3D API
@@ -1984,12 +2098,26 @@ public static class FAudio
 		ref F3DAUDIO_DSP_SETTINGS pDSPSettings
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FACT3DCalculate(
+		byte* F3DInstance, // F3DAUDIO_HANDLE
+		F3DAUDIO_LISTENER* pListener,
+		F3DAUDIO_EMITTER* pEmitter,
+		F3DAUDIO_DSP_SETTINGS* pDSPSettings
+	);
+
 	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
 	public static extern uint FACT3DApply(
 		ref F3DAUDIO_DSP_SETTINGS pDSPSettings,
 		IntPtr pCue /* FACTCue* */
 	);
 
+	[DllImport(nativeLibName, CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe uint FACT3DApply(
+		F3DAUDIO_DSP_SETTINGS* pDSPSettings,
+		IntPtr pCue /* FACTCue* */
+	);
+
 	#endregion
 
 	#region XNA Song API
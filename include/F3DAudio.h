@@ -221,6 +221,30 @@ typedef struct F3DAUDIO_DSP_SETTINGS
 	float ListenerVelocityComponent;
 } F3DAUDIO_DSP_SETTINGS;
 
+/* See "extensions/IncrementalCalculateEXT.txt" for more information. */
+typedef struct F3DAUDIO_INCREMENTAL_STATE_EXT
+{
+	/* Set by the application */
+	float PositionThreshold;
+	float OrientationThreshold;
+	float VelocityThreshold;
+
+	/* Set to 1 whenever the DSP settings are recalculated */
+	uint8_t Changed;
+
+	/* Kept by F3DAudio, zero them to force a recalculation */
+	uint8_t Valid;
+	uint32_t Flags;
+	F3DAUDIO_VECTOR ListenerOrientFront;
+	F3DAUDIO_VECTOR ListenerOrientTop;
+	F3DAUDIO_VECTOR ListenerPosition;
+	F3DAUDIO_VECTOR ListenerVelocity;
+	F3DAUDIO_VECTOR EmitterOrientFront;
+	F3DAUDIO_VECTOR EmitterOrientTop;
+	F3DAUDIO_VECTOR EmitterPosition;
+	F3DAUDIO_VECTOR EmitterVelocity;
+} F3DAUDIO_INCREMENTAL_STATE_EXT;
+
 #pragma pack(pop)
 
 /* Functions */
@@ -239,6 +263,26 @@ F3DAUDIOAPI void F3DAudioCalculate(
 	F3DAUDIO_DSP_SETTINGS *pDSPSettings
 );
 
+/* See "extensions/CalculateBatchEXT.txt" for more information. */
+F3DAUDIOAPI void F3DAudioCalculateBatchEXT(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER *pEmitters,
+	uint32_t EmitterCount,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings
+);
+
+/* See "extensions/IncrementalCalculateEXT.txt" for more information. */
+F3DAUDIOAPI void F3DAudioCalculateIncrementalEXT(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER *pEmitter,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings,
+	F3DAUDIO_INCREMENTAL_STATE_EXT *pState
+);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
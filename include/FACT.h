@@ -93,6 +93,10 @@ typedef struct FACTFileIOCallbacks
 	FACTGetOverlappedResultCallback getOverlappedResultCallback;
 } FACTFileIOCallbacks;
 
+/* Called from within the FACT call that caused the notification, on the same
+ * thread. For FACTNOTIFICATIONTYPE_*DESTROYED notifications, the object is
+ * still allocated, but is being destroyed and must not be used.
+ */
 typedef void (FACTCALL * FACTNotificationCallback)(
 	const FACTNotification *pNotification
 );
@@ -366,6 +370,15 @@ typedef struct FACTNotification
 
 static const uint32_t FACT_FLAG_MANAGEDATA =		0x00000001;
 
+/* See "extensions/FixedUpdateRateEXT.txt" for more information. */
+static const uint32_t FACT_FLAG_FIXED_UPDATE_RATE_EXT =	0x00010000;
+
+/* See "extensions/MappedWaveBankEXT.txt" for more information. */
+static const uint32_t FACT_FLAG_PREFETCH_WAVES_EXT =	0x00020000;
+
+/* See "extensions/LazySoundBankEXT.txt" for more information. */
+static const uint32_t FACT_FLAG_LAZY_SOUNDBANK_EXT =	0x00040000;
+
 static const uint32_t FACT_FLAG_STOP_RELEASE =		0x00000000;
 static const uint32_t FACT_FLAG_STOP_IMMEDIATE =	0x00000001;
 
@@ -499,6 +512,98 @@ FACTAPI uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine);
 
 FACTAPI uint32_t FACTAudioEngine_DoWork(FACTAudioEngine *pEngine);
 
+/* See "extensions/VoicePoolEXT.txt" for more information. */
+FACTAPI uint32_t FACTAudioEngine_SetVoicePoolLimitEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nMaxIdleVoices
+);
+
+/* See "extensions/VoiceBudgetEXT.txt" for more information. */
+FACTAPI uint32_t FACTAudioEngine_SetVoiceBudgetEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nMaxAudibleWaves
+);
+
+/* See "extensions/ThreadSchedulingEXT.txt" for more information. */
+#define FACT_THREAD_API_EXT	0
+#define FACT_THREAD_STREAM_EXT	1
+
+FACTAPI uint32_t FACTAudioEngine_SetThreadSchedulingEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nThread,
+	uint32_t dwFlags,
+	uint64_t qwAffinityMask
+);
+
+FACTAPI uint32_t FACTAudioEngine_GetThreadSchedulingEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nThread,
+	uint32_t *pdwGranted
+);
+
+/* See "extensions/LockStatsEXT.txt" for more information. */
+#define FACT_LOCK_API_EXT	0
+#define FACT_LOCK_STREAM_EXT	1
+#define FACT_LOCK_SOUNDBANK_EXT	2
+#define FACT_LOCK_WAVEBANK_EXT	3
+
+FACTAPI uint32_t FACTAudioEngine_GetLockStatsEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nLock,
+	FAudioLockStatsEXT *pStats
+);
+
+/* See "extensions/EngineStatsEXT.txt" for more information. */
+typedef struct FACTEngineStatsEXT
+{
+	uint64_t TickCount;
+	uint32_t LastTickMicroseconds;
+	uint32_t MaxTickMicroseconds;
+	uint32_t CuesUpdated;
+	uint32_t RPCEvaluations;
+	uint32_t ActiveVoices;
+	uint32_t IdleVoices;
+	uint32_t VirtualWaves;
+	uint32_t LateStreamBuffers;
+	uint64_t VoicesCreated;
+	uint64_t VoicesReused;
+	uint64_t VoicesDestroyed;
+} FACTEngineStatsEXT;
+
+typedef struct FACTWaveBankStatsEXT
+{
+	uint64_t BytesRead;
+	uint64_t ReadCount;
+	uint64_t ReadMicroseconds;
+	uint32_t LastReadMicroseconds;
+	uint32_t MaxReadMicroseconds;
+	uint32_t LateBuffers;
+} FACTWaveBankStatsEXT;
+
+FACTAPI uint32_t FACTAudioEngine_GetStatsEXT(
+	FACTAudioEngine *pEngine,
+	FACTEngineStatsEXT *pStats
+);
+
+/* See "extensions/MemoryUsageEXT.txt" for more information. */
+typedef struct FACTMemoryUsageEXT
+{
+	uint32_t BankBytes;
+	uint32_t StreamBytes;
+	uint32_t TranscodeBytes;
+} FACTMemoryUsageEXT;
+
+FACTAPI uint32_t FACTAudioEngine_GetMemoryUsageEXT(
+	FACTAudioEngine *pEngine,
+	FACTMemoryUsageEXT *pUsage
+);
+
+/* See "extensions/TaskPoolEXT.txt" for more information. */
+FACTAPI uint32_t FACTAudioEngine_SetTaskPoolEXT(
+	FACTAudioEngine *pEngine,
+	FAudioTaskPoolEXT *pPool
+);
+
 FACTAPI uint32_t FACTAudioEngine_CreateSoundBank(
 	FACTAudioEngine *pEngine,
 	const void *pvBuffer,
@@ -517,6 +622,33 @@ FACTAPI uint32_t FACTAudioEngine_CreateInMemoryWaveBank(
 	FACTWaveBank **ppWaveBank
 );
 
+/* See "extensions/MappedWaveBankEXT.txt" for more information. */
+FACTAPI uint32_t FACTAudioEngine_CreateMappedWaveBankEXT(
+	FACTAudioEngine *pEngine,
+	const char *szPath,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	FACTWaveBank **ppWaveBank
+);
+
+/* See "extensions/TranscodeEXT.txt" for more information. */
+typedef struct FACTTranscodeParametersEXT
+{
+	uint32_t maxBytes;
+	uint16_t categoryCount;
+	const uint16_t *categories;
+} FACTTranscodeParametersEXT;
+
+FACTAPI uint32_t FACTAudioEngine_CreateTranscodedWaveBankEXT(
+	FACTAudioEngine *pEngine,
+	const void *pvBuffer,
+	uint32_t dwSize,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	const FACTTranscodeParametersEXT *pParams,
+	FACTWaveBank **ppWaveBank
+);
+
 FACTAPI uint32_t FACTAudioEngine_CreateStreamingWaveBank(
 	FACTAudioEngine *pEngine,
 	const FACTStreamingParameters *pParms,
@@ -668,6 +800,12 @@ FACTAPI uint32_t FACTSoundBank_GetState(
 	uint32_t *pdwState
 );
 
+/* See "extensions/LazySoundBankEXT.txt" for more information. */
+FACTAPI uint32_t FACTSoundBank_PreloadCueEXT(
+	FACTSoundBank *pSoundBank,
+	uint16_t nCueIndex
+);
+
 /* WaveBank Interface */
 
 FACTAPI uint32_t FACTWaveBank_Destroy(FACTWaveBank *pWaveBank);
@@ -717,6 +855,12 @@ FACTAPI uint32_t FACTWaveBank_Stop(
 	uint32_t dwFlags
 );
 
+/* See "extensions/EngineStatsEXT.txt" for more information. */
+FACTAPI uint32_t FACTWaveBank_GetStatsEXT(
+	FACTWaveBank *pWaveBank,
+	FACTWaveBankStatsEXT *pStats
+);
+
 /* Wave Interface */
 
 FACTAPI uint32_t FACTWave_Destroy(FACTWave *pWave);
@@ -114,6 +114,22 @@ FACTAPI uint32_t FACT3DApply(
 	FACTCue *pCue
 );
 
+/* See "extensions/IncrementalCalculateEXT.txt" for more information. */
+
+FACTAPI uint32_t FACT3DCalculateIncrementalEXT(
+	F3DAUDIO_HANDLE F3DInstance,
+	const F3DAUDIO_LISTENER *pListener,
+	F3DAUDIO_EMITTER *pEmitter,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings,
+	F3DAUDIO_INCREMENTAL_STATE_EXT *pState
+);
+
+FACTAPI uint32_t FACT3DApplyIncrementalEXT(
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings,
+	FACTCue *pCue,
+	F3DAUDIO_INCREMENTAL_STATE_EXT *pState
+);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -191,6 +191,27 @@ FAPOAPI void FAPOBase_ProcessThru(
 	uint8_t MixWithOutput
 );
 
+/* Parameters are kept in the three blocks passed to CreateFAPOBase, which
+ * are used as a lock-free triple buffer:
+ *
+ * - SetParameters may be called from any thread, even while Process runs.
+ *   It never waits on Process, only on another SetParameters of the same
+ *   effect, for as long as that one takes to copy its parameters.
+ * - BeginProcess returns the newest parameters set before it was called,
+ *   and the block stays put until the next BeginProcess. ParametersChanged
+ *   says whether BeginProcess is about to move to a newer block.
+ * - GetParameters returns the parameters as of the last BeginProcess. Call
+ *   it on the thread that runs Process, or when Process isn't running.
+ *
+ * Producers (fProducer) work the other way around: Process fills the block
+ * returned by BeginProcess, EndProcess publishes it, and GetParameters
+ * returns the newest published block. A producer should skip both calls
+ * on passes where it produces nothing.
+ *
+ * FAudio calls SetParameters on the application's thread for effects that
+ * use FAPOBase_SetParameters as it is, without locking out the mixer.
+ */
+
 FAPOAPI void FAPOBase_SetParameters(
 	FAPOBase *fapo,
 	const void* pParameters,
@@ -499,6 +499,12 @@ FAUDIOAPI uint32_t FAudio_StartEngine(FAudio *audio);
 
 FAUDIOAPI void FAudio_StopEngine(FAudio *audio);
 
+FAUDIOAPI uint32_t FAudio_CommitOperationSet(
+	FAudio *audio,
+	uint32_t OperationSet
+);
+
+/* DEPRECATED, This function will be removed in FAudio 2.0! */
 FAUDIOAPI uint32_t FAudio_CommitChanges(FAudio *audio);
 
 FAUDIOAPI void FAudio_GetPerformanceData(
@@ -776,6 +782,17 @@ FAUDIOAPI uint32_t FAudioCOMConstructWithCustomAllocatorEXT(
 	FAudioReallocFunc customRealloc
 );
 
+#define FAUDIO_BUFFER_ALIGNMENT_EXT	64
+
+typedef void* (FAUDIOCALL * FAudioAlignedMallocFunc)(size_t size, size_t alignment);
+typedef void (FAUDIOCALL * FAudioAlignedFreeFunc)(void* ptr);
+
+FAUDIOAPI uint32_t FAudio_SetAlignedAllocatorEXT(
+	FAudio *audio,
+	FAudioAlignedMallocFunc customAlignedMalloc,
+	FAudioAlignedFreeFunc customAlignedFree
+);
+
 /* FAudio Engine Procedure API
  * See "extensions/EngineProcedureEXT.txt" for more information.
  */
@@ -788,6 +805,361 @@ FAUDIOAPI void FAudio_SetEngineProcedureEXT(
 	void *user
 );
 
+/* FAudio Device Period API
+ * See "extensions/DevicePeriodEXT.txt" for more information.
+ */
+FAUDIOAPI uint32_t FAudio_SetDevicePeriodEXT(
+	FAudio *audio,
+	uint32_t periodFrames
+);
+
+FAUDIOAPI void FAudio_GetDevicePeriodEXT(
+	FAudio *audio,
+	uint32_t *periodFrames,
+	uint32_t *latencyFrames
+);
+
+/* FAudio Render Ahead API
+ * See "extensions/RenderAheadEXT.txt" for more information.
+ */
+#define FAUDIO_MAX_RENDER_AHEAD_EXT	8
+
+FAUDIOAPI uint32_t FAudio_SetRenderAheadEXT(
+	FAudio *audio,
+	uint32_t periods
+);
+
+FAUDIOAPI void FAudio_GetRenderAheadEXT(
+	FAudio *audio,
+	uint32_t *periods,
+	uint32_t *underruns
+);
+
+/* FAudio Device Format API
+ * See "extensions/DeviceFormatEXT.txt" for more information.
+ */
+#define FAUDIO_DEVICE_FORMAT_DEFAULT_EXT	0
+#define FAUDIO_DEVICE_FORMAT_F32_EXT		1
+#define FAUDIO_DEVICE_FORMAT_S16_EXT		2
+#define FAUDIO_DEVICE_FORMAT_S24_EXT		3
+#define FAUDIO_DEVICE_FORMAT_S32_EXT		4
+
+FAUDIOAPI uint32_t FAudio_SetDeviceFormatEXT(
+	FAudio *audio,
+	uint32_t format,
+	uint8_t dither
+);
+
+FAUDIOAPI void FAudio_GetDeviceFormatEXT(
+	FAudio *audio,
+	uint32_t *format,
+	uint8_t *dither
+);
+
+/* FAudio Parallel Mix API
+ * See "extensions/ParallelMixEXT.txt" for more information.
+ */
+#define FAUDIO_PARALLEL_MIX_EXT		0x00800000
+
+/* FAudio Offline Render API
+ * See "extensions/OfflineRenderEXT.txt" for more information.
+ */
+#define FAUDIO_OFFLINE_RENDER_EXT	0x00400000
+
+FAUDIOAPI uint32_t FAudio_RenderEXT(
+	FAudio *audio,
+	float *output,
+	uint32_t frames
+);
+
+/* FAudio Resampler Quality API
+ * See "extensions/ResamplerQualityEXT.txt" for more information.
+ */
+#define FAUDIO_VOICE_RESAMPLE_NEAREST_EXT	0x00010000
+#define FAUDIO_VOICE_RESAMPLE_SINC_EXT		0x00020000
+
+/* FAudio Buffer Pool API
+ * See "extensions/BufferPoolEXT.txt" for more information.
+ */
+#define FAUDIO_MAX_BUFFER_POOL_EXT	65535
+
+FAUDIOAPI uint32_t FAudio_SetBufferPoolEXT(
+	FAudio *audio,
+	uint32_t capacity
+);
+
+FAUDIOAPI void FAudio_GetBufferPoolEXT(
+	FAudio *audio,
+	uint32_t *capacity,
+	uint32_t *overflows
+);
+
+/* FAudio Decode Ahead API
+ * See "extensions/DecodeAheadEXT.txt" for more information.
+ */
+#define FAUDIO_MAX_DECODE_AHEAD_EXT	16
+
+FAUDIOAPI uint32_t FAudio_SetDecodeAheadEXT(
+	FAudio *audio,
+	uint32_t blocks
+);
+
+FAUDIOAPI void FAudio_GetDecodeAheadEXT(
+	FAudio *audio,
+	uint32_t *blocks
+);
+
+/* FAudio Block Cache API
+ * See "extensions/BlockCacheEXT.txt" for more information.
+ */
+FAUDIOAPI uint32_t FAudio_SetBlockCacheEXT(
+	FAudio *audio,
+	uint32_t bytes
+);
+
+FAUDIOAPI void FAudio_GetBlockCacheEXT(
+	FAudio *audio,
+	uint32_t *bytes,
+	uint32_t *used,
+	uint32_t *hits,
+	uint32_t *misses
+);
+
+/* FAudio Predecode API
+ * See "extensions/PredecodeEXT.txt" for more information.
+ */
+#define FAUDIO_VOICE_PREDECODE_EXT	0x00040000
+
+/* FAudio Keep Denormals API
+ * See "extensions/KeepDenormalsEXT.txt" for more information.
+ */
+#define FAUDIO_KEEP_DENORMALS_EXT	0x00200000
+
+/* FAudio Decoder Pool API
+ * See "extensions/DecoderPoolEXT.txt" for more information.
+ */
+FAUDIOAPI uint32_t FAudio_WarmDecoderPoolEXT(
+	FAudio *audio,
+	const FAudioWaveFormatEx *pFormat,
+	uint32_t count
+);
+
+FAUDIOAPI void FAudio_FlushDecoderPoolEXT(FAudio *audio);
+
+FAUDIOAPI void FAudio_GetDecoderPoolEXT(
+	FAudio *audio,
+	uint32_t *idle,
+	uint32_t *hits,
+	uint32_t *misses
+);
+
+/* FAudio Padded Buffers API
+ * See "extensions/PaddedBuffersEXT.txt" for more information.
+ */
+#define FAUDIO_BUFFER_PADDED_EXT	0x00010000
+#define FAUDIO_BUFFER_PADDING_EXT	64
+
+/* FAudio Thread Scheduling API
+ * See "extensions/ThreadSchedulingEXT.txt" for more information.
+ */
+#define FAUDIO_THREAD_MIX_EXT		0
+#define FAUDIO_THREAD_MIX_WORKER_EXT	1
+#define FAUDIO_THREAD_PREDECODE_EXT	2
+
+#define FAUDIO_THREAD_REALTIME_EXT	0x00000001
+#define FAUDIO_THREAD_AFFINITY_EXT	0x00000002
+
+FAUDIOAPI uint32_t FAudio_SetThreadSchedulingEXT(
+	FAudio *audio,
+	uint32_t thread,
+	uint32_t flags,
+	uint64_t affinityMask
+);
+
+FAUDIOAPI uint32_t FAudio_GetThreadSchedulingEXT(
+	FAudio *audio,
+	uint32_t thread,
+	uint32_t *granted
+);
+
+/* FAudio Voice Profile API
+ * See "extensions/VoiceProfileEXT.txt" for more information.
+ */
+#define FAUDIO_VOICE_PROFILE_EXT	0x00080000
+
+typedef struct FAudioVoicePerformanceDataEXT
+{
+	uint64_t DecodeCycles;
+	uint64_t ResampleCycles;
+	uint64_t FilterCycles;
+	uint64_t EffectCycles;
+	uint64_t SendCycles;
+	uint64_t FramesProcessed;
+} FAudioVoicePerformanceDataEXT;
+
+FAUDIOAPI uint32_t FAudioVoice_GetPerformanceDataEXT(
+	FAudioVoice *voice,
+	FAudioVoicePerformanceDataEXT *pPerfData,
+	uint64_t *pEffectCycles,
+	uint32_t EffectCount
+);
+
+/* FAudio Trace API
+ * See "extensions/TraceEXT.txt" for more information.
+ */
+#define FAUDIO_DEFAULT_TRACE_EVENTS_EXT	65536
+
+typedef size_t (FAUDIOCALL * FAudioTraceWriteFuncEXT)(
+	void *user,
+	const void *data,
+	size_t size
+);
+
+FAUDIOAPI uint32_t FAudio_StartTraceEXT(
+	FAudio *audio,
+	uint32_t traceMask,
+	uint32_t eventsPerThread
+);
+
+FAUDIOAPI void FAudio_StopTraceEXT(FAudio *audio);
+
+FAUDIOAPI uint32_t FAudio_DumpTraceEXT(
+	FAudio *audio,
+	FAudioTraceWriteFuncEXT writeFunc,
+	void *user
+);
+
+/* FAudio Lock Stats API
+ * See "extensions/LockStatsEXT.txt" for more information.
+ */
+#define FAUDIO_LOCK_SOURCE_EXT		0
+#define FAUDIO_LOCK_SUBMIX_EXT		1
+#define FAUDIO_LOCK_CALLBACK_EXT	2
+#define FAUDIO_LOCK_OPERATION_EXT	3
+#define FAUDIO_LOCK_BLOCK_CACHE_EXT	4
+#define FAUDIO_LOCK_PREDECODE_EXT	5
+#define FAUDIO_LOCK_DECODER_POOL_EXT	6
+#define FAUDIO_LOCK_PERFORMANCE_EXT	7
+#define FAUDIO_LOCK_VOICE_SEND_EXT	8
+#define FAUDIO_LOCK_VOICE_EFFECT_EXT	9
+#define FAUDIO_LOCK_VOICE_FILTER_EXT	10
+#define FAUDIO_LOCK_VOICE_VOLUME_EXT	11
+#define FAUDIO_LOCK_VOICE_BUFFER_EXT	12
+#define FAUDIO_LOCK_COUNT_EXT		13
+
+typedef struct FAudioLockStatsEXT
+{
+	uint64_t Acquisitions;
+	uint64_t ContendedAcquisitions;
+	uint64_t WaitCycles;
+	uint64_t MaxWaitCycles;
+	uint64_t MixerContendedAcquisitions;
+	uint64_t MixerWaitCycles;
+} FAudioLockStatsEXT;
+
+FAUDIOAPI uint32_t FAudio_GetLockStatsEXT(
+	FAudio *audio,
+	uint32_t lock,
+	FAudioLockStatsEXT *pStats
+);
+
+/* FAudio Sub-Block Mix API
+ * See "extensions/SubBlockMixEXT.txt" for more information.
+ */
+#define FAUDIO_MIN_SUB_BLOCK_EXT	16
+
+FAUDIOAPI uint32_t FAudio_SetSubBlockSizeEXT(
+	FAudio *audio,
+	uint32_t frames
+);
+
+FAUDIOAPI void FAudio_GetSubBlockSizeEXT(
+	FAudio *audio,
+	uint32_t *frames
+);
+
+/* FAudio Task Pool API
+ * See "extensions/TaskPoolEXT.txt" for more information.
+ */
+typedef struct FAudioTaskPoolEXT FAudioTaskPoolEXT;
+
+typedef void (FAUDIOCALL * FAudioTaskFuncEXT)(void *taskData);
+
+typedef void (FAUDIOCALL * FAudioSubmitTaskFuncEXT)(
+	void *user,
+	FAudioTaskFuncEXT task,
+	void *taskData,
+	uint32_t delayUs,
+	uint32_t deadlineUs
+);
+
+FAUDIOAPI uint32_t FAudioCreateTaskPoolEXT(
+	FAudioTaskPoolEXT **ppPool,
+	uint32_t threadCount
+);
+
+FAUDIOAPI uint32_t FAudioCreateCustomTaskPoolEXT(
+	FAudioTaskPoolEXT **ppPool,
+	uint32_t threadCount,
+	FAudioSubmitTaskFuncEXT submitFunc,
+	void *user
+);
+
+FAUDIOAPI uint32_t FAudioTaskPoolEXT_AddRef(FAudioTaskPoolEXT *pool);
+FAUDIOAPI uint32_t FAudioTaskPoolEXT_Release(FAudioTaskPoolEXT *pool);
+
+FAUDIOAPI uint32_t FAudio_SetTaskPoolEXT(
+	FAudio *audio,
+	FAudioTaskPoolEXT *pool
+);
+
+/* FAudio Memory Usage API
+ * See "extensions/MemoryUsageEXT.txt" for more information.
+ */
+typedef struct FAudioMemoryUsageEXT
+{
+	uint32_t TotalBytes;
+	uint32_t ScratchBytes;
+	uint32_t VoiceBytes;
+	uint32_t EffectBytes;
+	uint32_t DecodeBytes;
+} FAudioMemoryUsageEXT;
+
+FAUDIOAPI uint32_t FAudio_GetMemoryUsageEXT(
+	FAudio *audio,
+	FAudioMemoryUsageEXT *pUsage
+);
+
+FAUDIOAPI uint32_t FAudio_TrimEXT(FAudio *audio);
+
+/* FAudio Governor API
+ * See "extensions/GovernorEXT.txt" for more information.
+ */
+#define FAUDIO_GOVERNOR_NONE_EXT	0
+#define FAUDIO_GOVERNOR_RESAMPLE_EXT	1
+#define FAUDIO_GOVERNOR_SEND_FILTER_EXT	2
+#define FAUDIO_GOVERNOR_METER_EXT	3
+#define FAUDIO_GOVERNOR_VIRTUALIZE_EXT	4
+
+typedef struct FAudioGovernorEXT
+{
+	float RaiseLoad;
+	float LowerLoad;
+	uint32_t HoldMilliseconds;
+	float QuietVolume;
+	uint32_t MeterDecimation;
+} FAudioGovernorEXT;
+
+FAUDIOAPI uint32_t FAudio_SetGovernorEXT(
+	FAudio *audio,
+	const FAudioGovernorEXT *pGovernor
+);
+
+FAUDIOAPI uint32_t FAudio_GetGovernorLevelEXT(
+	FAudio *audio,
+	uint32_t *pLevel
+);
+
 
 /* FAudio I/O API */
 
@@ -822,6 +1194,8 @@ typedef struct FAudioIOStream
 
 FAUDIOAPI FAudioIOStream* FAudio_fopen(const char *path);
 FAUDIOAPI FAudioIOStream* FAudio_memopen(void *mem, int len);
+/* See "extensions/MappedWaveBankEXT.txt" for more information. */
+FAUDIOAPI FAudioIOStream* FAudio_mmapopen(const char *path);
 FAUDIOAPI uint8_t* FAudio_memptr(FAudioIOStream *io, size_t offset);
 FAUDIOAPI void FAudio_close(FAudioIOStream *io);
 
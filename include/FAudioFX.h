@@ -38,6 +38,9 @@ extern "C" {
 extern const FAudioGUID FAudioFX_CLSID_AudioVolumeMeter;
 extern const FAudioGUID FAudioFX_CLSID_AudioReverb;
 
+/* See "extensions/ConvolutionReverbEXT.txt" for more information. */
+extern const FAudioGUID FAudioFX_CLSID_ConvolutionReverbEXT;
+
 /* Structures */
 
 #pragma pack(push, 1)
@@ -92,6 +95,12 @@ typedef struct FAudioFXReverbI3DL2Parameters
 	float HFReference;
 } FAudioFXReverbI3DL2Parameters;
 
+/* See "extensions/ConvolutionReverbEXT.txt" for more information. */
+typedef struct FAudioFXConvolutionParametersEXT
+{
+	float WetDryMix;
+} FAudioFXConvolutionParametersEXT;
+
 #pragma pack(pop)
 
 /* Constants */
@@ -220,6 +229,14 @@ typedef struct FAudioFXReverbI3DL2Parameters
 #define FAUDIOFX_I3DL2_PRESET_PLATE \
 	{100, -1000, -200,0.0f, 1.30f,0.90f,     0,0.002f,     0,0.010f,100.0f, 75.0f,5000.0f}
 
+/* See "extensions/ConvolutionReverbEXT.txt" for more information. */
+
+#define FAUDIOFX_CONVOLUTION_NON_UNIFORM_EXT		0x0001
+
+#define FAUDIOFX_CONVOLUTION_MIN_WET_DRY_MIX		0.0f
+#define FAUDIOFX_CONVOLUTION_MAX_WET_DRY_MIX		100.0f
+#define FAUDIOFX_CONVOLUTION_DEFAULT_WET_DRY_MIX	100.0f
+
 /* Functions */
 
 FAUDIOAPI uint32_t FAudioCreateVolumeMeter(FAPO** ppApo, uint32_t Flags);
@@ -241,6 +258,31 @@ FAUDIOAPI uint32_t FAudioCreateReverbWithCustomAllocatorEXT(
 	FAudioReallocFunc customRealloc
 );
 
+/* See "extensions/ConvolutionReverbEXT.txt" for more information. */
+FAUDIOAPI uint32_t FAudioCreateConvolutionReverbEXT(
+	FAPO** ppApo,
+	uint32_t Flags,
+	const float *pImpulseResponse,
+	uint32_t ImpulseFrameCount,
+	uint16_t ImpulseChannelCount
+);
+FAUDIOAPI uint32_t FAudioCreateConvolutionReverbWithCustomAllocatorEXT(
+	FAPO** ppApo,
+	uint32_t Flags,
+	const float *pImpulseResponse,
+	uint32_t ImpulseFrameCount,
+	uint16_t ImpulseChannelCount,
+	FAudioMallocFunc customMalloc,
+	FAudioFreeFunc customFree,
+	FAudioReallocFunc customRealloc
+);
+
+/* See "extensions/VolumeMeterDecimationEXT.txt" for more information. */
+FAUDIOAPI uint32_t FAudioSetVolumeMeterDecimationEXT(
+	FAPO* pApo,
+	uint32_t Passes
+);
+
 FAUDIOAPI void ReverbConvertI3DL2ToNative(
 	const FAudioFXReverbI3DL2Parameters *pI3DL2,
 	FAudioFXReverbParameters *pNative
@@ -83,7 +83,8 @@
 
 /* F3DAUDIO_HANDLE Structure */
 #define SPEAKERMASK(Instance)		*((uint32_t*)	&Instance[0])
-#define SPEAKERCOUNT(Instance)		*((uint32_t*)	&Instance[4])
+#define SPEAKERCOUNT(Instance)		*((uint16_t*)	&Instance[4])
+#define SPEAKERCONFIG(Instance)		*((uint16_t*)	&Instance[6])
 #define SPEAKER_LF_INDEX(Instance)	*((uint32_t*)	&Instance[8])
 #define SPEEDOFSOUND(Instance)		*((float*)	&Instance[12])
 #define SPEEDOFSOUNDEPSILON(Instance)	*((float*)	&Instance[16])
@@ -137,6 +138,8 @@ F3DAUDIOAPI uint32_t F3DAudioCheckInitParams(
 	return PARAM_CHECK_OK;
 }
 
+static uint16_t FindConfigInfo(uint32_t speakerConfigMask);
+
 void F3DAudioInitialize(
 	uint32_t SpeakerChannelMask,
 	float SpeedOfSound,
@@ -155,6 +158,7 @@ void F3DAudioInitialize(
 	}
 
 	SPEAKERMASK(Instance) = SpeakerChannelMask;
+	SPEAKERCONFIG(Instance) = FindConfigInfo(SpeakerChannelMask);
 	SPEEDOFSOUND(Instance) = SpeedOfSound;
 
 	/* "Convert" raw float to int... */
@@ -182,7 +186,7 @@ void F3DAudioInitialize(
 		speakerCount += 1;
 		SpeakerChannelMask &= SpeakerChannelMask - 1;
 	}
-	SPEAKERCOUNT(Instance) = speakerCount;
+	SPEAKERCOUNT(Instance) = (uint16_t) speakerCount;
 }
 
 
@@ -231,6 +235,31 @@ typedef struct F3DAUDIO_BASIS
 	F3DAUDIO_VECTOR top;
 } F3DAUDIO_BASIS;
 
+/* Where an emitter is, as seen by the listener. Everything the calculations
+ * need from the positions, velocities and orientations is here, so that
+ * F3DAudioCalculateBatchEXT can work it out for many emitters at once; see
+ * FAudio_INTERNAL_EmitterLanes.
+ */
+typedef struct F3DAUDIO_GEOMETRY
+{
+	F3DAUDIO_VECTOR emitterToListener;
+	float distance;
+	float normalizedDistance;
+
+	/* Cosines of the angles of the listener's and the emitter's cones */
+	float listenerFront;
+	float emitterFront;
+
+	/* Velocities along emitterToListener */
+	float listenerVelocity;
+	float emitterVelocity;
+
+	/* The emitter in the listener's front-right plane */
+	float planeFront;
+	float planeRight;
+	float radialDistance;
+} F3DAUDIO_GEOMETRY;
+
 /* CHECK UTILITY FUNCTIONS */
 
 static inline uint8_t CheckCone(F3DAUDIO_CONE *pCone)
@@ -450,7 +479,7 @@ static inline float ComputeDistanceAttenuation(
 	float res;
 	float alpha;
 	uint32_t n_points;
-	size_t i;
+	size_t i, lo, mid;
 	if (pCurve)
 	{
 		F3DAUDIO_DISTANCE_CURVE_POINT* points = pCurve->pPoints;
@@ -460,10 +489,31 @@ static inline float ComputeDistanceAttenuation(
 		 * -Adrien
 		 */
 
-		/* We advance i up until our normalizedDistance lies between the distances of
-		 * the i_th and (i-1)_th points, or we reach the last point.
+		/* We look for the i where our normalizedDistance lies between the distances of
+		 * the i_th and (i-1)_th points, or we reach the last point. The points are in
+		 * strict ascending order, so we can bisect rather than walk the whole curve.
 		 */
-		for (i = 1; (i < n_points) && (normalizedDistance >= points[i].Distance); i += 1);
+		i = n_points;
+		if (normalizedDistance < points[n_points - 1].Distance)
+		{
+			/* normalizedDistance < points[i].Distance, and >= points[lo].Distance
+			 * unless lo is 0
+			 */
+			lo = 0;
+			i = n_points - 1;
+			while ((i - lo) > 1)
+			{
+				mid = (lo + i) / 2;
+				if (normalizedDistance < points[mid].Distance)
+				{
+					i = mid;
+				}
+				else
+				{
+					lo = mid;
+				}
+			}
+		}
 		if (i == n_points)
 		{
 			/* We've reached the last point, so we use its value directly.
@@ -608,11 +658,14 @@ typedef struct
 	uint32_t numNonLFSpeakers;
 
 	int32_t LFSpeakerIdx;
+
+	/* Which speakers an azimuth lies between, see FindSpeakerAzimuths */
+	const uint8_t *sectorSpeakers;
 } ConfigInfo;
 
 /* It is absolutely necessary that these are stored in increasing, *positive*
- * azimuth order (i.e. all angles between [0; 2PI]), as we'll do a linear
- * interval search inside FindSpeakerAzimuths.
+ * azimuth order (i.e. all angles between [0; 2PI]), as FindSpeakerAzimuths
+ * relies on the speakers being given as consecutive intervals.
  * -Adrien
  */
 
@@ -699,6 +752,44 @@ const SpeakerInfo k7Point1SurroundConfigSpeakers[] =
 	{ SPEAKER_AZIMUTH_FRONT_LEFT,	0 },
 };
 
+/* Every speaker azimuth is a multiple of PI/8, so each of the 16 sectors of
+ * PI/8 lies between the same two speakers. For each configuration, sector k,
+ * the azimuths in [k * PI/8; (k + 1) * PI/8), starts at speakers[table[k]].
+ */
+#define AZIMUTH_SECTORS 16
+const uint8_t kMonoConfigSectors[AZIMUTH_SECTORS] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+const uint8_t kStereoConfigSectors[AZIMUTH_SECTORS] =
+{
+	1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1
+};
+const uint8_t kSurroundConfigSectors[AZIMUTH_SECTORS] =
+{
+	0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 3, 3
+};
+const uint8_t kQuadConfigSectors[AZIMUTH_SECTORS] =
+{
+	3, 3, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3
+};
+const uint8_t k5Point1ConfigSectors[AZIMUTH_SECTORS] =
+{
+	0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4
+};
+const uint8_t k7Point1ConfigSectors[AZIMUTH_SECTORS] =
+{
+	0, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 6
+};
+const uint8_t k5Point1SurroundConfigSectors[AZIMUTH_SECTORS] =
+{
+	0, 0, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 4, 4
+};
+const uint8_t k7Point1SurroundConfigSectors[AZIMUTH_SECTORS] =
+{
+	0, 0, 1, 1, 2, 2, 3, 3, 3, 3, 4, 4, 5, 5, 6, 6
+};
+
 /* With that organization, the index of the LF speaker into the matrix array
  * strangely looks *exactly* like the mystery field in the F3DAUDIO_HANDLE!!
  * We're keeping a separate field within ConfigInfo because it makes the code
@@ -707,32 +798,64 @@ const SpeakerInfo k7Point1SurroundConfigSpeakers[] =
  */
 const ConfigInfo kSpeakersConfigInfo[] =
 {
-	{ SPEAKER_MONO,			kMonoConfigSpeakers,		ARRAY_COUNT(kMonoConfigSpeakers),		-1 },
-	{ SPEAKER_STEREO,		kStereoConfigSpeakers,		ARRAY_COUNT(kStereoConfigSpeakers),		-1 },
-	{ SPEAKER_2POINT1,		k2Point1ConfigSpeakers,		ARRAY_COUNT(k2Point1ConfigSpeakers),		 2 },
-	{ SPEAKER_SURROUND,		kSurroundConfigSpeakers,	ARRAY_COUNT(kSurroundConfigSpeakers),		-1 },
-	{ SPEAKER_QUAD,			kQuadConfigSpeakers,		ARRAY_COUNT(kQuadConfigSpeakers),		-1 },
-	{ SPEAKER_4POINT1,		k4Point1ConfigSpeakers,		ARRAY_COUNT(k4Point1ConfigSpeakers),		 2 },
-	{ SPEAKER_5POINT1,		k5Point1ConfigSpeakers,		ARRAY_COUNT(k5Point1ConfigSpeakers),		 3 },
-	{ SPEAKER_7POINT1,		k7Point1ConfigSpeakers,		ARRAY_COUNT(k7Point1ConfigSpeakers),		 3 },
-	{ SPEAKER_5POINT1_SURROUND,	k5Point1SurroundConfigSpeakers,	ARRAY_COUNT(k5Point1SurroundConfigSpeakers),	 3 },
-	{ SPEAKER_7POINT1_SURROUND,	k7Point1SurroundConfigSpeakers,	ARRAY_COUNT(k7Point1SurroundConfigSpeakers),	 3 },
+	{ SPEAKER_MONO,			kMonoConfigSpeakers,		ARRAY_COUNT(kMonoConfigSpeakers),		-1,	kMonoConfigSectors },
+	{ SPEAKER_STEREO,		kStereoConfigSpeakers,		ARRAY_COUNT(kStereoConfigSpeakers),		-1,	kStereoConfigSectors },
+	{ SPEAKER_2POINT1,		k2Point1ConfigSpeakers,		ARRAY_COUNT(k2Point1ConfigSpeakers),		 2,	kStereoConfigSectors },
+	{ SPEAKER_SURROUND,		kSurroundConfigSpeakers,	ARRAY_COUNT(kSurroundConfigSpeakers),		-1,	kSurroundConfigSectors },
+	{ SPEAKER_QUAD,			kQuadConfigSpeakers,		ARRAY_COUNT(kQuadConfigSpeakers),		-1,	kQuadConfigSectors },
+	{ SPEAKER_4POINT1,		k4Point1ConfigSpeakers,		ARRAY_COUNT(k4Point1ConfigSpeakers),		 2,	kQuadConfigSectors },
+	{ SPEAKER_5POINT1,		k5Point1ConfigSpeakers,		ARRAY_COUNT(k5Point1ConfigSpeakers),		 3,	k5Point1ConfigSectors },
+	{ SPEAKER_7POINT1,		k7Point1ConfigSpeakers,		ARRAY_COUNT(k7Point1ConfigSpeakers),		 3,	k7Point1ConfigSectors },
+	{ SPEAKER_5POINT1_SURROUND,	k5Point1SurroundConfigSpeakers,	ARRAY_COUNT(k5Point1SurroundConfigSpeakers),	 3,	k5Point1SurroundConfigSectors },
+	{ SPEAKER_7POINT1_SURROUND,	k7Point1SurroundConfigSpeakers,	ARRAY_COUNT(k7Point1SurroundConfigSpeakers),	 3,	k7Point1SurroundConfigSectors },
 };
 
-/* A simple linear search is absolutely OK for 10 elements. */
-static const ConfigInfo* GetConfigInfo(uint32_t speakerConfigMask)
+/* A simple linear search is absolutely OK for 10 elements, and it is only done
+ * once, by F3DAudioInitialize; the handle keeps the index.
+ */
+static uint16_t FindConfigInfo(uint32_t speakerConfigMask)
 {
-	uint32_t i;
+	uint16_t i;
 	for (i = 0; i < ARRAY_COUNT(kSpeakersConfigInfo); i += 1)
 	{
 		if (kSpeakersConfigInfo[i].configMask == speakerConfigMask)
 		{
-			return &kSpeakersConfigInfo[i];
+			return i;
 		}
 	}
 
 	FAudio_assert(0 && "Config info not found!");
-	return NULL;
+	return 0;
+}
+
+static inline const ConfigInfo* GetConfigInfo(const F3DAUDIO_HANDLE Instance)
+{
+	FAudio_assert(SPEAKERCONFIG(Instance) < ARRAY_COUNT(kSpeakersConfigInfo));
+	return &kSpeakersConfigInfo[SPEAKERCONFIG(Instance)];
+}
+
+/* Whether emitterAzimuth is between speaker i and the next one */
+static inline uint8_t IsBetweenSpeakers(
+	const ConfigInfo* config,
+	uint32_t i,
+	float emitterAzimuth
+) {
+	const float a0 = config->speakers[i].azimuth;
+	const float a1 = config->speakers[(i + 1) % config->numNonLFSpeakers].azimuth;
+
+	if (a0 < a1)
+	{
+		return emitterAzimuth >= a0 && emitterAzimuth < a1;
+	}
+	/* It is possible for a speaker pair to enclose the singulary at 0 == 2PI:
+	 * consider for example the quad config, which has a front left speaker
+	 * at 7PI/4 and a front right speaker at PI/4. In that case a0 = 7PI/4 and
+	 * a1 = PI/4, and the way we know whether our current azimuth lies between
+	 * that pair is by checking whether the azimuth is greather than 7PI/4 or
+	 * whether it's less than PI/4. (By contract, currentAzimuth is always less
+	 * than 2PI.)
+	 */
+	return emitterAzimuth >= a0 || emitterAzimuth < a1;
 }
 
 /* Given a configuration, this function finds the azimuths of the two speakers
@@ -745,48 +868,35 @@ static inline void FindSpeakerAzimuths(
 	uint8_t skipCenter,
 	const SpeakerInfo **speakerInfo
 ) {
-	uint32_t i, nexti = 0;
-	float a0 = 0.0f, a1 = 0.0f;
+	uint32_t i, nexti, sector;
+	float a0, a1;
 
 	FAudio_assert(config != NULL);
 
 	/* We want to find, given an azimuth, which speakers are the closest
 	 * ones (in terms of angle) to that azimuth.
-	 * This is done by iterating through the list of speaker azimuths, as
-	 * given to us by the current ConfigInfo (which stores speaker azimuths
-	 * in increasing order of azimuth for each possible speaker configuration;
-	 * each speaker azimuth is defined to be between 0 and 2PI by construction).
+	 * The sector table gives the speaker interval the azimuth lies in
+	 * (the speaker azimuths are given to us by the current ConfigInfo in
+	 * increasing order, each between 0 and 2PI by construction). Azimuths
+	 * right on a speaker may round into the neighboring sector, so the
+	 * interval is checked, and the neighbors tried if it is off by one.
 	 */
-	for (i = 0; i < config->numNonLFSpeakers; i += 1)
+	sector = (uint32_t) (emitterAzimuth * (AZIMUTH_SECTORS / F3DAUDIO_2PI));
+	i = config->sectorSpeakers[FAudio_min(sector, AZIMUTH_SECTORS - 1)];
+	if (!IsBetweenSpeakers(config, i, emitterAzimuth))
 	{
-		/* a0 and a1 are the azimuths of candidate speakers */
-		a0 = config->speakers[i].azimuth;
-		nexti = (i + 1) % config->numNonLFSpeakers;
-		a1 = config->speakers[nexti].azimuth;
-
-		if (a0 < a1)
+		if (IsBetweenSpeakers(config, (i + 1) % config->numNonLFSpeakers, emitterAzimuth))
 		{
-			if (emitterAzimuth >= a0 && emitterAzimuth < a1)
-			{
-				break;
-			}
+			i = (i + 1) % config->numNonLFSpeakers;
 		}
-		/* It is possible for a speaker pair to enclose the singulary at 0 == 2PI:
-		 * consider for example the quad config, which has a front left speaker
-		 * at 7PI/4 and a front right speaker at PI/4. In that case a0 = 7PI/4 and
-		 * a1 = PI/4, and the way we know whether our current azimuth lies between
-		 * that pair is by checking whether the azimuth is greather than 7PI/4 or
-		 * whether it's less than PI/4. (By contract, currentAzimuth is always less
-		 * than 2PI.)
-		 */
 		else
 		{
-			if (emitterAzimuth >= a0 || emitterAzimuth < a1)
-			{
-				break;
-			}
+			i = (i == 0) ? (config->numNonLFSpeakers - 1) : (i - 1);
 		}
 	}
+	nexti = (i + 1) % config->numNonLFSpeakers;
+	a0 = config->speakers[i].azimuth;
+	a1 = config->speakers[nexti].azimuth;
 	FAudio_assert(emitterAzimuth >= a0 || emitterAzimuth < a1);
 
 	/* skipCenter means that we don't want to use the center speaker.
@@ -933,6 +1043,36 @@ static inline void ComputeInnerRadiusDiffusionFactors(
 	diffusionFactors[DIFFUSION_SPEAKERS_OPPOSITE] = os;
 }
 
+/* ComputeChannelPlane finds where an emitter channel is in the listener's
+ * front-right plane: front and right are its coordinates there, radialDistance
+ * its distance to the listener in that plane.
+ */
+static inline void ComputeChannelPlane(
+	const F3DAUDIO_BASIS *listenerBasis,
+	F3DAUDIO_VECTOR channelPosition,
+	float *front,
+	float *right,
+	float *radialDistance
+) {
+	float elevation;
+	F3DAUDIO_VECTOR projTopVec, projPlane;
+
+	/* We project against the listener basis' top vector to get the elevation of the
+	 * current emitter channel position.
+	 */
+	elevation = VectorDot(listenerBasis->top, channelPosition);
+
+	/* To obtain the projection in the front-right plane of the listener's basis of the
+	 * emitter channel position, we simply remove the projection against the top vector.
+	 * The radial distance is then the length of the projected vector.
+	 */
+	projTopVec = VectorScale(listenerBasis->top, elevation);
+	projPlane = VectorSub(channelPosition, projTopVec);
+	*radialDistance = VectorLength(projPlane);
+	*front = VectorDot(listenerBasis->front, projPlane);
+	*right = VectorDot(listenerBasis->right, projPlane);
+}
+
 /* ComputeEmitterChannelCoefficients handles the coefficients calculation for 1
  * column of the matrix. It uses ComputeInnerRadiusDiffusionFactors to separate
  * into three discrete cases; and for each case does the right repartition of
@@ -943,21 +1083,19 @@ static inline void ComputeInnerRadiusDiffusionFactors(
  */
 static inline void ComputeEmitterChannelCoefficients(
 	const ConfigInfo *curConfig,
-	const F3DAUDIO_BASIS *listenerBasis,
 	float innerRadius,
-	F3DAUDIO_VECTOR channelPosition,
+	float x,
+	float y,
+	float radialDistance,
 	float attenuation,
 	uint32_t flags,
 	uint32_t currentChannel,
 	uint32_t numSrcChannels,
 	float *pMatrixCoefficients
 ) {
-	float elevation, radialDistance;
-	F3DAUDIO_VECTOR projTopVec, projPlane;
 	uint8_t skipCenter = (flags & F3DAUDIO_CALCULATE_ZEROCENTER) ? 1 : 0;
 	DiffusionSpeakerFactors diffusionFactors = { 0.0f };
 
-	float x, y;
 	float emitterAzimuth;
 	float energyPerChannel;
 	float totalEnergy;
@@ -967,19 +1105,6 @@ static inline void ComputeEmitterChannelCoefficients(
 	float a0, a1, val;
 	uint32_t i0, i1;
 
-	/* We project against the listener basis' top vector to get the elevation of the
-	 * current emitter channel position.
-	 */
-	elevation = VectorDot(listenerBasis->top, channelPosition);
-
-	/* To obtain the projection in the front-right plane of the listener's basis of the
-	 * emitter channel position, we simply remove the projection against the top vector.
-	 * The radial distance is then the length of the projected vector.
-	 */
-	projTopVec = VectorScale(listenerBasis->top, elevation);
-	projPlane = VectorSub(channelPosition, projTopVec);
-	radialDistance = VectorLength(projPlane);
-
 	ComputeInnerRadiusDiffusionFactors(
 		radialDistance,
 		innerRadius,
@@ -1024,9 +1149,6 @@ static inline void ComputeEmitterChannelCoefficients(
 	{
 		const float totalEnergy = diffusionFactors[DIFFUSION_SPEAKERS_MATCHING] * attenuation;
 
-		x = VectorDot(listenerBasis->front, projPlane);
-		y = VectorDot(listenerBasis->right, projPlane);
-
 		/* Now, a critical point: We shouldn't be sending sound to
 		 * matching speakers when x and y are close to 0. That's the
 		 * contract we get from ComputeInnerRadiusDiffusionFactors,
@@ -1076,9 +1198,6 @@ static inline void ComputeEmitterChannelCoefficients(
 		/* This code is similar to the matching speakers code above. */
 		const float totalEnergy = diffusionFactors[DIFFUSION_SPEAKERS_OPPOSITE] * attenuation;
 
-		x = VectorDot(listenerBasis->front, projPlane);
-		y = VectorDot(listenerBasis->right, projPlane);
-
 		/* Similarly, we expect atan2 to be well behaved here. */
 		emitterAzimuth = FAudio_atan2f(y, x);
 
@@ -1166,33 +1285,30 @@ static inline void ComputeEmitterChannelCoefficients(
  * -Adrien
  */
 static inline void CalculateMatrix(
-	uint32_t ChannelMask,
+	const ConfigInfo *curConfig,
 	uint32_t Flags,
 	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_BASIS *listenerBasis,
 	const F3DAUDIO_EMITTER *pEmitter,
+	const F3DAUDIO_GEOMETRY *geometry,
 	uint32_t SrcChannelCount,
 	uint32_t DstChannelCount,
-	F3DAUDIO_VECTOR emitterToListener,
-	float eToLDistance,
-	float normalizedDistance,
 	float* MatrixCoefficients
 ) {
 	uint32_t iEC;
-	float curEmAzimuth;
-	const ConfigInfo* curConfig = GetConfigInfo(ChannelMask);
+	float curEmAzimuth, front, right, radialDistance;
 	float attenuation = ComputeDistanceAttenuation(
-		normalizedDistance,
+		geometry->normalizedDistance,
 		pEmitter->pVolumeCurve
 	);
 	/* TODO: this could be skipped if the destination has no LFE */
 	float LFEattenuation = ComputeDistanceAttenuation(
-		normalizedDistance,
+		geometry->normalizedDistance,
 		pEmitter->pLFECurve
 	);
 
 	F3DAUDIO_VECTOR listenerToEmitter;
 	F3DAUDIO_VECTOR listenerToEmChannel;
-	F3DAUDIO_BASIS listenerBasis;
 
 	/* Note: For both cone calculations, the angle might be NaN or infinite
 	 * if distance == 0... ComputeConeParameter *does* check for this
@@ -1207,13 +1323,10 @@ static inline void CalculateMatrix(
 		 * this case
 		 * -Adrien
 		 */
-		const float angle = -FAudio_acosf(
-			VectorDot(pListener->OrientFront, emitterToListener) /
-			eToLDistance
-		);
+		const float angle = -FAudio_acosf(geometry->listenerFront);
 
 		const float listenerConeParam = ComputeConeParameter(
-			eToLDistance,
+			geometry->distance,
 			angle,
 			pListener->pCone->InnerAngle,
 			pListener->pCone->OuterAngle,
@@ -1227,13 +1340,10 @@ static inline void CalculateMatrix(
 	/* See note above. */
 	if (pEmitter->pCone && pEmitter->ChannelCount == 1)
 	{
-		const float angle = FAudio_acosf(
-			VectorDot(pEmitter->OrientFront, emitterToListener) /
-			eToLDistance
-		);
+		const float angle = FAudio_acosf(geometry->emitterFront);
 
 		const float emitterConeParam = ComputeConeParameter(
-			eToLDistance,
+			geometry->distance,
 			angle,
 			pEmitter->pCone->InnerAngle,
 			pEmitter->pCone->OuterAngle,
@@ -1265,14 +1375,6 @@ static inline void CalculateMatrix(
 	}
 	else
 	{
-		listenerToEmitter = VectorScale(emitterToListener, -1.0f);
-
-		/* Remember here that the coordinate system is Left-Handed. */
-		listenerBasis.front = pListener->OrientFront;
-		listenerBasis.right = VectorCross(pListener->OrientTop, pListener->OrientFront);
-		listenerBasis.top = pListener->OrientTop;
-
-
 		/* Handling the mono-channel emitter case separately is easier
 		 * than having it as a separate case of a for-loop; indeed, in
 		 * this case, we need to ignore the non-relevant values from the
@@ -1280,13 +1382,13 @@ static inline void CalculateMatrix(
 		 */
 		if (pEmitter->ChannelCount == 1)
 		{
-			listenerToEmChannel = listenerToEmitter;
-
+			/* The geometry already has the emitter in the plane */
 			ComputeEmitterChannelCoefficients(
 				curConfig,
-				&listenerBasis,
 				pEmitter->InnerRadius,
-				listenerToEmChannel,
+				geometry->planeFront,
+				geometry->planeRight,
+				geometry->radialDistance,
 				attenuation,
 				Flags,
 				0 /* currentChannel */,
@@ -1298,6 +1400,8 @@ static inline void CalculateMatrix(
 		{
 			const F3DAUDIO_VECTOR emitterRight = VectorCross(pEmitter->OrientTop, pEmitter->OrientFront);
 
+			listenerToEmitter = VectorScale(geometry->emitterToListener, -1.0f);
+
 			for (iEC = 0; iEC < pEmitter->ChannelCount; iEC += 1)
 			{
 				const float emChAzimuth = pEmitter->pChannelAzimuths[iEC];
@@ -1324,11 +1428,19 @@ static inline void CalculateMatrix(
 						emitterBaseToChannel
 					);
 
+					ComputeChannelPlane(
+						listenerBasis,
+						listenerToEmChannel,
+						&front,
+						&right,
+						&radialDistance
+					);
 					ComputeEmitterChannelCoefficients(
 						curConfig,
-						&listenerBasis,
 						pEmitter->InnerRadius,
-						listenerToEmChannel,
+						front,
+						right,
+						radialDistance,
 						attenuation,
 						Flags,
 						iEC,
@@ -1360,10 +1472,8 @@ static inline void CalculateMatrix(
  */
 static inline void CalculateDoppler(
 	float SpeedOfSound,
-	const F3DAUDIO_LISTENER* pListener,
 	const F3DAUDIO_EMITTER* pEmitter,
-	F3DAUDIO_VECTOR emitterToListener,
-	float eToLDistance,
+	const F3DAUDIO_GEOMETRY *geometry,
 	float* listenerVelocityComponent,
 	float* emitterVelocityComponent,
 	float* DopplerFactor
@@ -1371,19 +1481,9 @@ static inline void CalculateDoppler(
 	float scaledSpeedOfSound;
 	*DopplerFactor = 1.0f;
 
-	/* Project... */
-	if (eToLDistance != 0.0f)
-	{
-		*listenerVelocityComponent =
-			VectorDot(emitterToListener, pListener->Velocity) / eToLDistance;
-		*emitterVelocityComponent =
-			VectorDot(emitterToListener, pEmitter->Velocity) / eToLDistance;
-	}
-	else
-	{
-		*listenerVelocityComponent = 0.0f;
-		*emitterVelocityComponent = 0.0f;
-	}
+	/* Projected, with the rest of the geometry... */
+	*listenerVelocityComponent = geometry->listenerVelocity;
+	*emitterVelocityComponent = geometry->emitterVelocity;
 
 	if (pEmitter->DopplerScaler > 0.0f)
 	{
@@ -1419,54 +1519,102 @@ static inline void CalculateDoppler(
 	}
 }
 
-void F3DAudioCalculate(
+/* Remember here that the coordinate system is Left-Handed. */
+static inline void ComputeListenerBasis(
+	const F3DAUDIO_LISTENER *pListener,
+	F3DAUDIO_BASIS *listenerBasis
+) {
+	listenerBasis->front = pListener->OrientFront;
+	listenerBasis->right = VectorCross(pListener->OrientTop, pListener->OrientFront);
+	listenerBasis->top = pListener->OrientTop;
+}
+
+/* The scalar version of FAudio_INTERNAL_EmitterLanes, for a single emitter.
+ * The two have to do the same float ops in the same order.
+ */
+static inline void ComputeGeometry(
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_BASIS *listenerBasis,
+	const F3DAUDIO_EMITTER *pEmitter,
+	F3DAUDIO_GEOMETRY *geometry
+) {
+	const F3DAUDIO_VECTOR emitterToListener = VectorSub(
+		pListener->Position,
+		pEmitter->Position
+	);
+	const float distance = VectorLength(emitterToListener);
+
+	geometry->emitterToListener = emitterToListener;
+	geometry->distance = distance;
+	geometry->normalizedDistance = distance / pEmitter->CurveDistanceScaler;
+	geometry->listenerFront = VectorDot(pListener->OrientFront, emitterToListener) / distance;
+	geometry->emitterFront = VectorDot(pEmitter->OrientFront, emitterToListener) / distance;
+	if (distance != 0.0f)
+	{
+		geometry->listenerVelocity =
+			VectorDot(emitterToListener, pListener->Velocity) / distance;
+		geometry->emitterVelocity =
+			VectorDot(emitterToListener, pEmitter->Velocity) / distance;
+	}
+	else
+	{
+		geometry->listenerVelocity = 0.0f;
+		geometry->emitterVelocity = 0.0f;
+	}
+	ComputeChannelPlane(
+		listenerBasis,
+		VectorScale(emitterToListener, -1.0f),
+		&geometry->planeFront,
+		&geometry->planeRight,
+		&geometry->radialDistance
+	);
+}
+
+#define DEFAULT_POINTS(name, x1, y1, x2, y2) \
+	static F3DAUDIO_DISTANCE_CURVE_POINT name##Points[2] = \
+	{ \
+		{ x1, y1 }, \
+		{ x2, y2 } \
+	}; \
+	static F3DAUDIO_DISTANCE_CURVE name##Default = \
+	{ \
+		(F3DAUDIO_DISTANCE_CURVE_POINT*) &name##Points[0], 2 \
+	};
+DEFAULT_POINTS(lpfDirect, 0.0f, 1.0f, 1.0f, 0.75f)
+DEFAULT_POINTS(lpfReverb, 0.0f, 0.75f, 1.0f, 0.75f)
+DEFAULT_POINTS(reverb, 0.0f, 1.0f, 1.0f, 0.0f)
+#undef DEFAULT_POINTS
+
+/* Everything but the geometry, which F3DAudioCalculate computes for one
+ * emitter and F3DAudioCalculateBatchEXT for many at once.
+ */
+static void CalculateFromGeometry(
 	const F3DAUDIO_HANDLE Instance,
 	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_BASIS *listenerBasis,
 	const F3DAUDIO_EMITTER *pEmitter,
+	const F3DAUDIO_GEOMETRY *geometry,
 	uint32_t Flags,
 	F3DAUDIO_DSP_SETTINGS *pDSPSettings
 ) {
 	uint32_t i;
-	F3DAUDIO_VECTOR emitterToListener;
-	float eToLDistance, normalizedDistance, dp;
-
-	#define DEFAULT_POINTS(name, x1, y1, x2, y2) \
-		static F3DAUDIO_DISTANCE_CURVE_POINT name##Points[2] = \
-		{ \
-			{ x1, y1 }, \
-			{ x2, y2 } \
-		}; \
-		static F3DAUDIO_DISTANCE_CURVE name##Default = \
-		{ \
-			(F3DAUDIO_DISTANCE_CURVE_POINT*) &name##Points[0], 2 \
-		};
-	DEFAULT_POINTS(lpfDirect, 0.0f, 1.0f, 1.0f, 0.75f)
-	DEFAULT_POINTS(lpfReverb, 0.0f, 0.75f, 1.0f, 0.75f)
-	DEFAULT_POINTS(reverb, 0.0f, 1.0f, 1.0f, 0.0f)
-	#undef DEFAULT_POINTS
 
 	/* For XACT, this calculates "Distance" */
-	emitterToListener = VectorSub(pListener->Position, pEmitter->Position);
-	eToLDistance = VectorLength(emitterToListener);
-	pDSPSettings->EmitterToListenerDistance = eToLDistance;
+	pDSPSettings->EmitterToListenerDistance = geometry->distance;
 
 	F3DAudioCheckCalculateParams(Instance, pListener, pEmitter, Flags, pDSPSettings);
 
-	/* This is used by MATRIX, LPF, and REVERB */
-	normalizedDistance = eToLDistance / pEmitter->CurveDistanceScaler;
-
 	if (Flags & F3DAUDIO_CALCULATE_MATRIX)
 	{
 		CalculateMatrix(
-			SPEAKERMASK(Instance),
+			GetConfigInfo(Instance),
 			Flags,
 			pListener,
+			listenerBasis,
 			pEmitter,
+			geometry,
 			pDSPSettings->SrcChannelCount,
 			pDSPSettings->DstChannelCount,
-			emitterToListener,
-			eToLDistance,
-			normalizedDistance,
 			pDSPSettings->pMatrixCoefficients
 		);
 	}
@@ -1474,7 +1622,7 @@ void F3DAudioCalculate(
 	if (Flags & F3DAUDIO_CALCULATE_LPF_DIRECT)
 	{
 		pDSPSettings->LPFDirectCoefficient = ComputeDistanceAttenuation(
-			normalizedDistance,
+			geometry->normalizedDistance,
 			(pEmitter->pLPFDirectCurve != NULL) ?
 				pEmitter->pLPFDirectCurve :
 				&lpfDirectDefault
@@ -1484,7 +1632,7 @@ void F3DAudioCalculate(
 	if (Flags & F3DAUDIO_CALCULATE_LPF_REVERB)
 	{
 		pDSPSettings->LPFReverbCoefficient = ComputeDistanceAttenuation(
-			normalizedDistance,
+			geometry->normalizedDistance,
 			(pEmitter->pLPFReverbCurve != NULL) ?
 				pEmitter->pLPFReverbCurve :
 				&lpfReverbDefault
@@ -1494,7 +1642,7 @@ void F3DAudioCalculate(
 	if (Flags & F3DAUDIO_CALCULATE_REVERB)
 	{
 		pDSPSettings->ReverbLevel = ComputeDistanceAttenuation(
-			normalizedDistance,
+			geometry->normalizedDistance,
 			(pEmitter->pReverbCurve != NULL) ?
 				pEmitter->pReverbCurve :
 				&reverbDefault
@@ -1506,10 +1654,8 @@ void F3DAudioCalculate(
 	{
 		CalculateDoppler(
 			SPEEDOFSOUND(Instance),
-			pListener,
 			pEmitter,
-			emitterToListener,
-			eToLDistance,
+			geometry,
 			&pDSPSettings->ListenerVelocityComponent,
 			&pDSPSettings->EmitterVelocityComponent,
 			&pDSPSettings->DopplerFactor
@@ -1523,15 +1669,16 @@ void F3DAudioCalculate(
 		 * Below that distance, the emitter angle is considered to be PI/2.
 		 */
 		#define EMITTER_ANGLE_NULL_DISTANCE 1.2e-7
-		if (eToLDistance < EMITTER_ANGLE_NULL_DISTANCE)
+		if (geometry->distance < EMITTER_ANGLE_NULL_DISTANCE)
 		{
 			pDSPSettings->EmitterToListenerAngle = F3DAUDIO_PI / 2.0f;
 		}
 		else
 		{
 			/* Note: pEmitter->OrientFront is normalized. */
-			dp = VectorDot(emitterToListener, pEmitter->OrientFront) / eToLDistance;
-			pDSPSettings->EmitterToListenerAngle = FAudio_acosf(dp);
+			pDSPSettings->EmitterToListenerAngle = FAudio_acosf(
+				geometry->emitterFront
+			);
 		}
 	}
 
@@ -1547,4 +1694,159 @@ void F3DAudioCalculate(
 	}
 }
 
+void F3DAudioCalculate(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER *pEmitter,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings
+) {
+	F3DAUDIO_BASIS listenerBasis;
+	F3DAUDIO_GEOMETRY geometry;
+
+	ComputeListenerBasis(pListener, &listenerBasis);
+	ComputeGeometry(pListener, &listenerBasis, pEmitter, &geometry);
+	CalculateFromGeometry(
+		Instance,
+		pListener,
+		&listenerBasis,
+		pEmitter,
+		&geometry,
+		Flags,
+		pDSPSettings
+	);
+}
+
+void F3DAudioCalculateBatchEXT(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER *pEmitters,
+	uint32_t EmitterCount,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings
+) {
+	uint32_t start, count, padded, i, j;
+	F3DAUDIO_BASIS listenerBasis;
+	F3DAUDIO_GEOMETRY geometry;
+	F3DAudioListenerFrame frame;
+	F3DAudioEmitterLanes lanes;
+	const F3DAUDIO_EMITTER *emitter;
+
+	/* The listener is the same for every emitter, set it up once */
+	ComputeListenerBasis(pListener, &listenerBasis);
+	#define FRAME_VECTOR(dst, v) \
+		frame.dst[0] = v.x; \
+		frame.dst[1] = v.y; \
+		frame.dst[2] = v.z;
+	FRAME_VECTOR(front, listenerBasis.front)
+	FRAME_VECTOR(right, listenerBasis.right)
+	FRAME_VECTOR(top, listenerBasis.top)
+	FRAME_VECTOR(position, pListener->Position)
+	FRAME_VECTOR(velocity, pListener->Velocity)
+	#undef FRAME_VECTOR
+
+	for (start = 0; start < EmitterCount; start += count)
+	{
+		count = FAudio_min(EmitterCount - start, F3DAUDIO_BATCH_LANES);
+
+		/* The lanes past the last emitter repeat it */
+		padded = (count + 3) & ~3;
+		for (i = 0; i < padded; i += 1)
+		{
+			emitter = &pEmitters[start + FAudio_min(i, count - 1)];
+			#define LANE_VECTOR(dst, v) \
+				lanes.dst[0][i] = v.x; \
+				lanes.dst[1][i] = v.y; \
+				lanes.dst[2][i] = v.z;
+			LANE_VECTOR(position, emitter->Position)
+			LANE_VECTOR(velocity, emitter->Velocity)
+			LANE_VECTOR(front, emitter->OrientFront)
+			#undef LANE_VECTOR
+			lanes.curveDistanceScaler[i] = emitter->CurveDistanceScaler;
+		}
+
+		FAudio_INTERNAL_EmitterLanes(&frame, &lanes, padded);
+
+		for (i = 0; i < count; i += 1)
+		{
+			geometry.emitterToListener = Vec(
+				lanes.toListener[0][i],
+				lanes.toListener[1][i],
+				lanes.toListener[2][i]
+			);
+			geometry.distance = lanes.distance[i];
+			geometry.normalizedDistance = lanes.normalizedDistance[i];
+			geometry.listenerFront = lanes.listenerFront[i];
+			geometry.emitterFront = lanes.emitterFront[i];
+			geometry.listenerVelocity = lanes.listenerVelocity[i];
+			geometry.emitterVelocity = lanes.emitterVelocity[i];
+			geometry.planeFront = lanes.plane[0][i];
+			geometry.planeRight = lanes.plane[1][i];
+			geometry.radialDistance = lanes.radius[i];
+
+			j = start + i;
+			CalculateFromGeometry(
+				Instance,
+				pListener,
+				&listenerBasis,
+				&pEmitters[j],
+				&geometry,
+				Flags,
+				&pDSPSettings[j]
+			);
+		}
+	}
+}
+
+/* Whether any component of u and v differs by more than threshold */
+static inline uint8_t VectorMoved(
+	F3DAUDIO_VECTOR u,
+	F3DAUDIO_VECTOR v,
+	float threshold
+) {
+	return (	FAudio_fabsf(u.x - v.x) > threshold ||
+			FAudio_fabsf(u.y - v.y) > threshold ||
+			FAudio_fabsf(u.z - v.z) > threshold	);
+}
+
+void F3DAudioCalculateIncrementalEXT(
+	const F3DAUDIO_HANDLE Instance,
+	const F3DAUDIO_LISTENER *pListener,
+	const F3DAUDIO_EMITTER *pEmitter,
+	uint32_t Flags,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings,
+	F3DAUDIO_INCREMENTAL_STATE_EXT *pState
+) {
+	/* Everything is compared to the state of the last recalculation, not
+	 * that of the last call, so that slow movement still adds up.
+	 */
+	if (	pState->Valid &&
+		pState->Flags == Flags &&
+		!VectorMoved(pState->ListenerPosition, pListener->Position, pState->PositionThreshold) &&
+		!VectorMoved(pState->EmitterPosition, pEmitter->Position, pState->PositionThreshold) &&
+		!VectorMoved(pState->ListenerOrientFront, pListener->OrientFront, pState->OrientationThreshold) &&
+		!VectorMoved(pState->ListenerOrientTop, pListener->OrientTop, pState->OrientationThreshold) &&
+		!VectorMoved(pState->EmitterOrientFront, pEmitter->OrientFront, pState->OrientationThreshold) &&
+		!VectorMoved(pState->EmitterOrientTop, pEmitter->OrientTop, pState->OrientationThreshold) &&
+		!VectorMoved(pState->ListenerVelocity, pListener->Velocity, pState->VelocityThreshold) &&
+		!VectorMoved(pState->EmitterVelocity, pEmitter->Velocity, pState->VelocityThreshold)	)
+	{
+		return;
+	}
+
+	F3DAudioCalculate(Instance, pListener, pEmitter, Flags, pDSPSettings);
+
+	pState->Changed = 1;
+	pState->Valid = 1;
+	pState->Flags = Flags;
+	pState->ListenerOrientFront = pListener->OrientFront;
+	pState->ListenerOrientTop = pListener->OrientTop;
+	pState->ListenerPosition = pListener->Position;
+	pState->ListenerVelocity = pListener->Velocity;
+	pState->EmitterOrientFront = pEmitter->OrientFront;
+	pState->EmitterOrientTop = pEmitter->OrientTop;
+	pState->EmitterPosition = pEmitter->Position;
+	pState->EmitterVelocity = pEmitter->Velocity;
+}
+
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
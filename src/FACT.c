@@ -49,7 +49,6 @@ uint32_t FACTCreateEngineWithCustomAllocatorEXT(
 	FAudioFreeFunc customFree,
 	FAudioReallocFunc customRealloc
 ) {
-	/* TODO: Anything fun with dwCreationFlags? */
 	*ppEngine = (FACTAudioEngine*) customMalloc(sizeof(FACTAudioEngine));
 	if (*ppEngine == NULL)
 	{
@@ -59,35 +58,45 @@ uint32_t FACTCreateEngineWithCustomAllocatorEXT(
 	(*ppEngine)->sbLock = FAudio_PlatformCreateMutex();
 	(*ppEngine)->wbLock = FAudio_PlatformCreateMutex();
 	(*ppEngine)->apiLock = FAudio_PlatformCreateMutex();
+	FAudio_INTERNAL_InitThreadSchedule(&(*ppEngine)->threadSchedules[0]);
+	FAudio_INTERNAL_InitThreadSchedule(&(*ppEngine)->threadSchedules[1]);
 	(*ppEngine)->pMalloc = customMalloc;
 	(*ppEngine)->pFree = customFree;
 	(*ppEngine)->pRealloc = customRealloc;
 	(*ppEngine)->refcount = 1;
+	(*ppEngine)->creationFlags = dwCreationFlags;
+	(*ppEngine)->maxIdleVoices = FACT_VOICE_POOL_DEFAULT_LIMIT;
 	return 0;
 }
 
 uint32_t FACTAudioEngine_AddRef(FACTAudioEngine *pEngine)
 {
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	pEngine->refcount += 1;
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return pEngine->refcount;
 }
 
 uint32_t FACTAudioEngine_Release(FACTAudioEngine *pEngine)
 {
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	pEngine->refcount -= 1;
 	if (pEngine->refcount > 0)
 	{
-		FAudio_PlatformUnlockMutex(pEngine->apiLock);
+		FACT_INTERNAL_UnlockAPI(pEngine);
 		return pEngine->refcount;
 	}
 	FACTAudioEngine_ShutDown(pEngine);
 	FAudio_PlatformDestroyMutex(pEngine->sbLock);
 	FAudio_PlatformDestroyMutex(pEngine->wbLock);
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	FAudio_PlatformDestroyMutex(pEngine->apiLock);
+	FAudio_INTERNAL_FreeThreadSchedule(&pEngine->threadSchedules[0]);
+	FAudio_INTERNAL_FreeThreadSchedule(&pEngine->threadSchedules[1]);
+	if (pEngine->taskPool != NULL)
+	{
+		FAudioTaskPoolEXT_Release(pEngine->taskPool);
+	}
 	pEngine->pFree(pEngine);
 	return 0;
 }
@@ -96,9 +105,9 @@ uint32_t FACTAudioEngine_GetRendererCount(
 	FACTAudioEngine *pEngine,
 	uint16_t *pnRendererCount
 ) {
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	*pnRendererCount = (uint16_t) FAudio_PlatformGetDeviceCount();
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -109,7 +118,7 @@ uint32_t FACTAudioEngine_GetRendererDetails(
 ) {
 	FAudioDeviceDetails deviceDetails;
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 
 	FAudio_PlatformGetDeviceDetails(
 		nRendererIndex,
@@ -131,7 +140,7 @@ uint32_t FACTAudioEngine_GetRendererDetails(
 		FAudioDefaultGameDevice
 	)) != 0;
 
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -139,13 +148,13 @@ uint32_t FACTAudioEngine_GetFinalMixFormat(
 	FACTAudioEngine *pEngine,
 	FAudioWaveFormatExtensible *pFinalMixFormat
 ) {
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	FAudio_memcpy(
 		pFinalMixFormat,
 		pEngine->audio->mixFormat,
 		sizeof(FAudioWaveFormatExtensible)
 	);
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -159,13 +168,13 @@ uint32_t FACTAudioEngine_Initialize(
 	FAudioEffectDescriptor reverbDesc;
 	FAudioEffectChain reverbChain;
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 
 	/* Parse the file */
 	parseRet = FACT_INTERNAL_ParseAudioEngine(pEngine, pParams);
 	if (parseRet != 0)
 	{
-		FAudio_PlatformUnlockMutex(pEngine->apiLock);
+		FACT_INTERNAL_UnlockAPI(pEngine);
 		return parseRet;
 	}
 
@@ -187,7 +196,9 @@ uint32_t FACTAudioEngine_Initialize(
 	if (pEngine->audio == NULL)
 	{
 		FAudio_assert(pParams->pMasteringVoice == NULL);
-		FAudioCreate(&pEngine->audio, 0, FAUDIO_DEFAULT_PROCESSOR);
+		FAudioCOMConstructEXT(&pEngine->audio, FAUDIO_TARGET_VERSION);
+		FAudio_SetTaskPoolEXT(pEngine->audio, pEngine->taskPool);
+		FAudio_Initialize(pEngine->audio, 0, FAUDIO_DEFAULT_PROCESSOR);
 	}
 
 	/* Create the audio device */
@@ -246,19 +257,41 @@ uint32_t FACTAudioEngine_Initialize(
 	}
 
 	pEngine->initialized = 1;
-	pEngine->apiThread = FAudio_PlatformCreateThread(
-		FACT_INTERNAL_APIThread,
-		"FACT Thread",
-		pEngine
-	);
+	if (pEngine->taskPool != NULL)
+	{
+		FAudio_INTERNAL_StartPoolLoop(
+			&pEngine->apiLoop,
+			pEngine->taskPool,
+			FACT_INTERNAL_APITick,
+			pEngine,
+			FACT_API_DEADLINE_US
+		);
+
+		/* The first tick, the thread would do this as soon as it starts */
+		FAudio_INTERNAL_WakePoolLoop(&pEngine->apiLoop);
+	}
+	else
+	{
+		if (!(pEngine->creationFlags & FACT_FLAG_FIXED_UPDATE_RATE_EXT))
+		{
+			pEngine->apiWake = FAudio_PlatformCreateSemaphore(0);
+		}
+		pEngine->apiThread = FAudio_PlatformCreateThread(
+			FACT_INTERNAL_APIThread,
+			"FACT Thread",
+			pEngine
+		);
+	}
 
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
 uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 {
-	uint32_t i, refcount;
+	uint32_t refcount, creationFlags, maxIdleVoices, maxAudibleWaves;
+	FAudioThreadSchedule threadSchedules[2];
+	FAudioTaskPoolEXT *taskPool;
 	FAudioMutex mutex;
 	FAudioMallocFunc pMalloc;
 	FAudioFreeFunc pFree;
@@ -266,8 +299,26 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 
 	/* Close thread, then lock ASAP */
 	pEngine->initialized = 0;
-	FAudio_PlatformWaitThread(pEngine->apiThread, NULL);
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	if (pEngine->apiLoop.pool != NULL)
+	{
+		/* Also stops the Cues below from waking it again */
+		FAudio_INTERNAL_StopPoolLoop(&pEngine->apiLoop);
+	}
+	else
+	{
+		if (pEngine->apiWake != NULL)
+		{
+			FAudio_PlatformPostSemaphore(pEngine->apiWake);
+		}
+		FAudio_PlatformWaitThread(pEngine->apiThread, NULL);
+	}
+	FACT_INTERNAL_LockAPI(pEngine);
+	if (pEngine->apiWake != NULL)
+	{
+		/* Stopping the Cues below would still try to wake the thread */
+		FAudio_PlatformDestroySemaphore(pEngine->apiWake);
+		pEngine->apiWake = NULL;
+	}
 
 	/* Stop the platform stream before freeing stuff! */
 	FAudio_StopEngine(pEngine->audio);
@@ -284,40 +335,21 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 		FACTSoundBank_Destroy((FACTSoundBank*) pEngine->sbList->entry);
 	}
 
-	/* Category data */
-	for (i = 0; i < pEngine->categoryCount; i += 1)
-	{
-		pEngine->pFree(pEngine->categoryNames[i]);
-	}
-	pEngine->pFree(pEngine->categoryNames);
-	pEngine->pFree(pEngine->categories);
+	/* Categories, variables, RPCs and DSP presets */
+	FACT_INTERNAL_FreeArena(&pEngine->arena, pEngine->pFree);
 
-	/* Variable data */
-	for (i = 0; i < pEngine->variableCount; i += 1)
-	{
-		pEngine->pFree(pEngine->variableNames[i]);
-	}
-	pEngine->pFree(pEngine->variableNames);
-	pEngine->pFree(pEngine->variables);
-	pEngine->pFree(pEngine->globalVariableValues);
+	/* Every Sound instance is gone with the SoundBanks */
+	FACT_INTERNAL_TrimSoundPool(pEngine);
 
-	/* RPC data */
-	for (i = 0; i < pEngine->rpcCount; i += 1)
-	{
-		pEngine->pFree(pEngine->rpcs[i].points);
-	}
-	pEngine->pFree(pEngine->rpcs);
-	pEngine->pFree(pEngine->rpcCodes);
+	/* Every stream is gone with the WaveBanks */
+	FACT_INTERNAL_StopStreamThread(pEngine);
 
-	/* DSP data */
-	for (i = 0; i < pEngine->dspPresetCount; i += 1)
+	/* Audio resources */
+	FACT_INTERNAL_TrimVoicePool(pEngine, 0);
+	if (pEngine->budget != NULL)
 	{
-		pEngine->pFree(pEngine->dspPresets[i].parameters);
+		pEngine->pFree(pEngine->budget);
 	}
-	pEngine->pFree(pEngine->dspPresets);
-	pEngine->pFree(pEngine->dspPresetCodes);
-
-	/* Audio resources */
 	if (pEngine->reverbVoice != NULL)
 	{
 		FAudioVoice_DestroyVoice(pEngine->reverbVoice);
@@ -327,6 +359,15 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 
 	/* Finally. */
 	refcount = pEngine->refcount;
+	creationFlags = pEngine->creationFlags;
+	maxIdleVoices = pEngine->maxIdleVoices;
+	maxAudibleWaves = pEngine->maxAudibleWaves;
+	FAudio_memcpy(
+		threadSchedules,
+		pEngine->threadSchedules,
+		sizeof(threadSchedules)
+	);
+	taskPool = pEngine->taskPool;
 	mutex = pEngine->apiLock;
 	pMalloc = pEngine->pMalloc;
 	pFree = pEngine->pFree;
@@ -336,9 +377,18 @@ uint32_t FACTAudioEngine_ShutDown(FACTAudioEngine *pEngine)
 	pEngine->pFree = pFree;
 	pEngine->pRealloc = pRealloc;
 	pEngine->refcount = refcount;
+	pEngine->creationFlags = creationFlags;
+	pEngine->maxIdleVoices = maxIdleVoices;
+	pEngine->maxAudibleWaves = maxAudibleWaves;
+	FAudio_memcpy(
+		pEngine->threadSchedules,
+		threadSchedules,
+		sizeof(threadSchedules)
+	);
+	pEngine->taskPool = taskPool;
 	pEngine->apiLock = mutex;
 
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -346,38 +396,236 @@ uint32_t FACTAudioEngine_DoWork(FACTAudioEngine *pEngine)
 {
 	uint8_t i;
 	FACTCue *cue;
+
+	FACT_INTERNAL_LockAPI(pEngine);
+
+	/* Everything FACT3DApply did since the last frame goes at once. From
+	 * now on the API thread leaves this to us, see FACT_INTERNAL_APIThread.
+	 */
+	pEngine->frameCommits = 1;
+	FAudio_CommitOperationSet(pEngine->audio, FACT_OPERATIONSET_3D);
+
+	cue = pEngine->activeCues;
+	while (cue != NULL)
+	{
+		if (cue->playingSound != NULL)
+		for (i = 0; i < cue->playingSound->sound->trackCount; i += 1)
+		{
+			if (	cue->playingSound->tracks[i].upcomingWave.wave == NULL &&
+				cue->playingSound->tracks[i].waveEvtInst->loopCount > 0	)
+			{
+				FACT_INTERNAL_GetNextWave(
+					cue,
+					cue->playingSound->sound,
+					&cue->playingSound->sound->tracks[i],
+					&cue->playingSound->tracks[i],
+					cue->playingSound->tracks[i].waveEvt,
+					cue->playingSound->tracks[i].waveEvtInst
+				);
+			}
+		}
+		cue = cue->activeNext;
+	}
+
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return 0;
+}
+
+uint32_t FACTAudioEngine_SetVoicePoolLimitEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nMaxIdleVoices
+) {
+	FACT_INTERNAL_LockAPI(pEngine);
+	pEngine->maxIdleVoices = nMaxIdleVoices;
+	FACT_INTERNAL_TrimVoicePool(pEngine, nMaxIdleVoices);
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return 0;
+}
+
+uint32_t FACTAudioEngine_SetVoiceBudgetEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nMaxAudibleWaves
+) {
+	FACT_INTERNAL_LockAPI(pEngine);
+	pEngine->maxAudibleWaves = nMaxAudibleWaves;
+
+	/* The thread virtualizes and resumes Waves to match */
+	FACT_INTERNAL_WakeAPIThread(pEngine);
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return 0;
+}
+
+uint32_t FACTAudioEngine_SetThreadSchedulingEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nThread,
+	uint32_t dwFlags,
+	uint64_t qwAffinityMask
+) {
+	if (nThread > FACT_THREAD_STREAM_EXT)
+	{
+		return 1;
+	}
+
+	/* Not under apiLock, the engine thread applies it before locking */
+	FAudio_INTERNAL_SetThreadSchedule(
+		&pEngine->threadSchedules[nThread],
+		dwFlags,
+		qwAffinityMask
+	);
+	return 0;
+}
+
+uint32_t FACTAudioEngine_GetThreadSchedulingEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nThread,
+	uint32_t *pdwGranted
+) {
+	if (nThread > FACT_THREAD_STREAM_EXT)
+	{
+		return 1;
+	}
+
+	FAudio_PlatformLockMutex(pEngine->threadSchedules[nThread].lock);
+	*pdwGranted = pEngine->threadSchedules[nThread].granted;
+	FAudio_PlatformUnlockMutex(pEngine->threadSchedules[nThread].lock);
+	return 0;
+}
+
+uint32_t FACTAudioEngine_GetLockStatsEXT(
+	FACTAudioEngine *pEngine,
+	uint32_t nLock,
+	FAudioLockStatsEXT *pStats
+) {
+	FAudioMutex lock;
+
+	FAudio_zero(pStats, sizeof(FAudioLockStatsEXT));
+	switch (nLock)
+	{
+	case FACT_LOCK_API_EXT:
+		lock = pEngine->apiLock;
+		break;
+	case FACT_LOCK_STREAM_EXT:
+		lock = pEngine->streamLock;
+		break;
+	case FACT_LOCK_SOUNDBANK_EXT:
+		lock = pEngine->sbLock;
+		break;
+	case FACT_LOCK_WAVEBANK_EXT:
+		lock = pEngine->wbLock;
+		break;
+	default:
+		return 1;
+	}
+
+#ifdef FAUDIO_DISABLE_LOCK_STATS
+	(void) lock;
+	return 1;
+#else
+	FAudio_PlatformGetMutexStats(lock, pStats);
+	return 0;
+#endif /* FAUDIO_DISABLE_LOCK_STATS */
+}
+
+uint32_t FACTAudioEngine_GetStatsEXT(
+	FACTAudioEngine *pEngine,
+	FACTEngineStatsEXT *pStats
+) {
+	FACT_INTERNAL_LockAPI(pEngine);
+	FAudio_memcpy(pStats, &pEngine->stats, sizeof(FACTEngineStatsEXT));
+	pStats->ActiveVoices = pEngine->activeVoiceCount;
+	pStats->IdleVoices = pEngine->idleVoiceCount;
+	pStats->VirtualWaves = pEngine->virtualWaveCount;
+
+	/* No streaming thread, nothing could have run late */
+	if (pEngine->streamLock != NULL)
+	{
+		FAudio_PlatformLockMutex(pEngine->streamLock);
+		pStats->LateStreamBuffers = pEngine->stats.LateStreamBuffers;
+		FAudio_PlatformUnlockMutex(pEngine->streamLock);
+	}
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return 0;
+}
+
+uint32_t FACTAudioEngine_GetMemoryUsageEXT(
+	FACTAudioEngine *pEngine,
+	FACTMemoryUsageEXT *pUsage
+) {
 	LinkedList *list;
+	FACTStream *stream;
+	uint32_t i;
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
+	pUsage->BankBytes = (uint32_t) FACT_INTERNAL_GetArenaSize(
+		&pEngine->arena
+	);
+	for (list = pEngine->sbList; list != NULL; list = list->next)
+	{
+		pUsage->BankBytes += (uint32_t) FACT_INTERNAL_GetArenaSize(
+			&((FACTSoundBank*) list->entry)->arena
+		);
+	}
+	for (list = pEngine->wbList; list != NULL; list = list->next)
+	{
+		pUsage->BankBytes += (uint32_t) FACT_INTERNAL_GetArenaSize(
+			&((FACTWaveBank*) list->entry)->arena
+		);
+	}
 
-	list = pEngine->sbList;
-	while (list != NULL)
+	/* Streams come and go with their Waves, under streamLock */
+	pUsage->StreamBytes = 0;
+	pUsage->TranscodeBytes = 0;
+	if (pEngine->streamLock != NULL)
 	{
-		cue = ((FACTSoundBank*) list->entry)->cueList;
-		while (cue != NULL)
+		FAudio_PlatformLockMutex(pEngine->streamLock);
+		for (list = pEngine->wbList; list != NULL; list = list->next)
 		{
-			if (cue->playingSound != NULL)
-			for (i = 0; i < cue->playingSound->sound->trackCount; i += 1)
+			pUsage->TranscodeBytes +=
+				((FACTWaveBank*) list->entry)->transcodeBytes;
+		}
+		for (stream = pEngine->streams; stream != NULL; stream = stream->next)
+		{
+			for (i = 0; i < stream->bufferCount; i += 1)
 			{
-				if (	cue->playingSound->tracks[i].upcomingWave.wave == NULL &&
-					cue->playingSound->tracks[i].waveEvtInst->loopCount > 0	)
+				pUsage->StreamBytes += stream->bufferSize;
+				if (stream->buffers[i].decodedBytes != NULL)
 				{
-					FACT_INTERNAL_GetNextWave(
-						cue,
-						cue->playingSound->sound,
-						&cue->playingSound->sound->tracks[i],
-						&cue->playingSound->tracks[i],
-						cue->playingSound->tracks[i].waveEvt,
-						cue->playingSound->tracks[i].waveEvtInst
+					pUsage->StreamBytes += (
+						sizeof(uint32_t) *
+						(stream->bufferSize / stream->packetAlign)
 					);
 				}
 			}
-			cue = cue->next;
 		}
-		list = list->next;
+		FAudio_PlatformUnlockMutex(pEngine->streamLock);
+	}
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return 0;
+}
+
+uint32_t FACTAudioEngine_SetTaskPoolEXT(
+	FACTAudioEngine *pEngine,
+	FAudioTaskPoolEXT *pPool
+) {
+	FACT_INTERNAL_LockAPI(pEngine);
+
+	/* The threads, or the loops replacing them, start with the engine */
+	if (pEngine->initialized)
+	{
+		FACT_INTERNAL_UnlockAPI(pEngine);
+		return 1;
 	}
 
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	if (pPool != NULL)
+	{
+		FAudioTaskPoolEXT_AddRef(pPool);
+	}
+	if (pEngine->taskPool != NULL)
+	{
+		FAudioTaskPoolEXT_Release(pEngine->taskPool);
+	}
+	pEngine->taskPool = pPool;
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -390,14 +638,15 @@ uint32_t FACTAudioEngine_CreateSoundBank(
 	FACTSoundBank **ppSoundBank
 ) {
 	uint32_t retval;
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	retval = FACT_INTERNAL_ParseSoundBank(
 		pEngine,
 		pvBuffer,
 		dwSize,
+		dwFlags,
 		ppSoundBank
 	);
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return retval;
 }
 
@@ -410,7 +659,7 @@ uint32_t FACTAudioEngine_CreateInMemoryWaveBank(
 	FACTWaveBank **ppWaveBank
 ) {
 	uint32_t retval;
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	retval = FACT_INTERNAL_ParseWaveBank(
 		pEngine,
 		FAudio_memopen((void*) pvBuffer, dwSize),
@@ -420,7 +669,75 @@ uint32_t FACTAudioEngine_CreateInMemoryWaveBank(
 		0,
 		ppWaveBank
 	);
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return retval;
+}
+
+uint32_t FACTAudioEngine_CreateMappedWaveBankEXT(
+	FACTAudioEngine *pEngine,
+	const char *szPath,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	FACTWaveBank **ppWaveBank
+) {
+	uint32_t retval;
+	FAudioIOStream *io;
+
+	io = FAudio_mmapopen(szPath);
+	if (io == NULL)
+	{
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	FACT_INTERNAL_LockAPI(pEngine);
+	retval = FACT_INTERNAL_ParseWaveBank(
+		pEngine,
+		io,
+		0,
+		FACT_INTERNAL_DefaultReadFile,
+		FACT_INTERNAL_DefaultGetOverlappedResult,
+		0,
+		ppWaveBank
+	);
+	if (retval == 0)
+	{
+		(*ppWaveBank)->prefetch = (
+			(dwFlags & FACT_FLAG_PREFETCH_WAVES_EXT) != 0
+		);
+	}
+	else
+	{
+		FAudio_close(io);
+	}
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return retval;
+}
+
+uint32_t FACTAudioEngine_CreateTranscodedWaveBankEXT(
+	FACTAudioEngine *pEngine,
+	const void *pvBuffer,
+	uint32_t dwSize,
+	uint32_t dwFlags,
+	uint32_t dwAllocAttributes,
+	const FACTTranscodeParametersEXT *pParams,
+	FACTWaveBank **ppWaveBank
+) {
+	uint32_t retval;
+	FACT_INTERNAL_LockAPI(pEngine);
+	retval = FACT_INTERNAL_ParseWaveBank(
+		pEngine,
+		FAudio_memopen((void*) pvBuffer, dwSize),
+		0,
+		FACT_INTERNAL_DefaultReadFile,
+		FACT_INTERNAL_DefaultGetOverlappedResult,
+		0,
+		ppWaveBank
+	);
+	if (retval == 0)
+	{
+		FACT_INTERNAL_InitTranscodes(*ppWaveBank, pParams);
+	}
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return retval;
 }
 
@@ -430,7 +747,7 @@ uint32_t FACTAudioEngine_CreateStreamingWaveBank(
 	FACTWaveBank **ppWaveBank
 ) {
 	uint32_t retval;
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	retval = FACT_INTERNAL_ParseWaveBank(
 		pEngine,
 		pParms->file,
@@ -440,7 +757,11 @@ uint32_t FACTAudioEngine_CreateStreamingWaveBank(
 		1,
 		ppWaveBank
 	);
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	if (retval == 0)
+	{
+		(*ppWaveBank)->packetSize = pParms->packetSize;
+	}
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return retval;
 }
 
@@ -496,7 +817,7 @@ uint32_t FACTAudioEngine_RegisterNotification(
 	FAudio_assert(pNotificationDescription != NULL);
 	FAudio_assert(pEngine->notificationCallback != NULL);
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 
 	if (pNotificationDescription->type == FACTNOTIFICATIONTYPE_CUEDESTROYED)
 	{
@@ -523,7 +844,7 @@ uint32_t FACTAudioEngine_RegisterNotification(
 		FAudio_assert(0 && "TODO: Unimplemented notification!");
 	}
 
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -535,7 +856,7 @@ uint32_t FACTAudioEngine_UnRegisterNotification(
 	FAudio_assert(pNotificationDescription != NULL);
 	FAudio_assert(pEngine->notificationCallback != NULL);
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 
 	if (pNotificationDescription->type == FACTNOTIFICATIONTYPE_CUEDESTROYED)
 	{
@@ -558,7 +879,7 @@ uint32_t FACTAudioEngine_UnRegisterNotification(
 		FAudio_assert(0 && "TODO: Unimplemented notification!");
 	}
 
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -567,16 +888,16 @@ uint16_t FACTAudioEngine_GetCategory(
 	const char *szFriendlyName
 ) {
 	uint16_t i;
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	for (i = 0; i < pEngine->categoryCount; i += 1)
 	{
 		if (FAudio_strcmp(szFriendlyName, pEngine->categoryNames[i]) == 0)
 		{
-			FAudio_PlatformUnlockMutex(pEngine->apiLock);
+			FACT_INTERNAL_UnlockAPI(pEngine);
 			return i;
 		}
 	}
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return FACTCATEGORY_INVALID;
 }
 
@@ -614,7 +935,7 @@ uint32_t FACTAudioEngine_Stop(
 	FACTCue *cue, *backup;
 	LinkedList *list;
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	list = pEngine->sbList;
 	while (list != NULL)
 	{
@@ -650,7 +971,7 @@ uint32_t FACTAudioEngine_Stop(
 		}
 		list = list->next;
 	}
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -660,7 +981,7 @@ uint32_t FACTAudioEngine_SetVolume(
 	float volume
 ) {
 	uint16_t i;
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	pEngine->categories[nCategory].currentVolume = (
 		pEngine->categories[nCategory].volume *
 		volume
@@ -676,7 +997,8 @@ uint32_t FACTAudioEngine_SetVolume(
 			);
 		}
 	}
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_WakeAPIThread(pEngine);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -688,7 +1010,7 @@ uint32_t FACTAudioEngine_Pause(
 	FACTCue *cue;
 	LinkedList *list;
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pEngine);
 	list = pEngine->sbList;
 	while (list != NULL)
 	{
@@ -708,7 +1030,7 @@ uint32_t FACTAudioEngine_Pause(
 		}
 		list = list->next;
 	}
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pEngine);
 	return 0;
 }
 
@@ -717,18 +1039,14 @@ uint16_t FACTAudioEngine_GetGlobalVariableIndex(
 	const char *szFriendlyName
 ) {
 	uint16_t i;
-	FAudio_PlatformLockMutex(pEngine->apiLock);
-	for (i = 0; i < pEngine->variableCount; i += 1)
-	{
-		if (	FAudio_strcmp(szFriendlyName, pEngine->variableNames[i]) == 0 &&
-			!(pEngine->variables[i].accessibility & 0x04)	)
-		{
-			FAudio_PlatformUnlockMutex(pEngine->apiLock);
-			return i;
-		}
-	}
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
-	return FACTVARIABLEINDEX_INVALID;
+	FACT_INTERNAL_LockAPI(pEngine);
+	i = FACT_INTERNAL_FindName(
+		&pEngine->globalVariableTable,
+		pEngine->variableNames,
+		szFriendlyName
+	);
+	FACT_INTERNAL_UnlockAPI(pEngine);
+	return i;
 }
 
 uint32_t FACTAudioEngine_SetGlobalVariable(
@@ -738,19 +1056,21 @@ uint32_t FACTAudioEngine_SetGlobalVariable(
 ) {
 	FACTVariable *var;
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
-
+	/* No apiLock, so the game never waits for the engine thread here */
 	var = &pEngine->variables[nIndex];
 	FAudio_assert(var->accessibility & 0x01);
 	FAudio_assert(!(var->accessibility & 0x02));
 	FAudio_assert(!(var->accessibility & 0x04));
-	pEngine->globalVariableValues[nIndex] = FAudio_clamp(
-		nValue,
-		var->minValue,
-		var->maxValue
+	FACT_INTERNAL_StoreVariable(
+		&pEngine->globalVariableValues[nIndex],
+		FAudio_clamp(
+			nValue,
+			var->minValue,
+			var->maxValue
+		)
 	);
 
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	FACT_INTERNAL_WakeAPIThread(pEngine);
 	return 0;
 }
 
@@ -761,14 +1081,12 @@ uint32_t FACTAudioEngine_GetGlobalVariable(
 ) {
 	FACTVariable *var;
 
-	FAudio_PlatformLockMutex(pEngine->apiLock);
-
 	var = &pEngine->variables[nIndex];
 	FAudio_assert(var->accessibility & 0x01);
 	FAudio_assert(!(var->accessibility & 0x04));
-	*pnValue = pEngine->globalVariableValues[nIndex];
-
-	FAudio_PlatformUnlockMutex(pEngine->apiLock);
+	*pnValue = FACT_INTERNAL_LoadVariable(
+		&pEngine->globalVariableValues[nIndex]
+	);
 	return 0;
 }
 
@@ -784,19 +1102,14 @@ uint16_t FACTSoundBank_GetCueIndex(
 		return FACTINDEX_INVALID;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
-	for (i = 0; i < pSoundBank->cueCount; i += 1)
-	{
-		if (FAudio_strcmp(szFriendlyName, pSoundBank->cueNames[i]) == 0)
-		{
-			FAudio_PlatformUnlockMutex(
-				pSoundBank->parentEngine->apiLock
-			);
-			return i;
-		}
-	}
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
-	return FACTINDEX_INVALID;
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
+	i = FACT_INTERNAL_FindName(
+		&pSoundBank->cueTable,
+		pSoundBank->cueNames,
+		szFriendlyName
+	);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
+	return i;
 }
 
 uint32_t FACTSoundBank_GetNumCues(
@@ -809,9 +1122,9 @@ uint32_t FACTSoundBank_GetNumCues(
 		return 0;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 	*pnNumCues = pSoundBank->cueCount;
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 	return 0;
 }
 
@@ -826,7 +1139,7 @@ uint32_t FACTSoundBank_GetCueProperties(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 
 	FAudio_strlcpy(
 		pProperties->friendlyName,
@@ -866,7 +1179,7 @@ uint32_t FACTSoundBank_GetCueProperties(
 	pProperties->maxInstances = pSoundBank->cues[nCueIndex].instanceLimit;
 	pProperties->currentInstances = pSoundBank->cues[nCueIndex].instanceCount;
 
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 	return 0;
 }
 
@@ -889,7 +1202,7 @@ uint32_t FACTSoundBank_Prepare(
 	*ppCue = (FACTCue*) pSoundBank->parentEngine->pMalloc(sizeof(FACTCue));
 	FAudio_zero(*ppCue, sizeof(FACTCue));
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 
 	/* Engine references */
 	(*ppCue)->parentBank = pSoundBank;
@@ -901,14 +1214,10 @@ uint32_t FACTSoundBank_Prepare(
 	(*ppCue)->data = &pSoundBank->cues[nCueIndex];
 	if ((*ppCue)->data->flags & 0x04)
 	{
-		for (i = 0; i < pSoundBank->soundCount; i += 1)
-		{
-			if ((*ppCue)->data->sbCode == pSoundBank->soundCodes[i])
-			{
-				(*ppCue)->sound = &pSoundBank->sounds[i];
-				break;
-			}
-		}
+		(*ppCue)->sound = FACT_INTERNAL_GetSound(
+			pSoundBank,
+			(*ppCue)->data->sbCode
+		);
 	}
 	else
 	{
@@ -956,7 +1265,7 @@ uint32_t FACTSoundBank_Prepare(
 		latest->next = *ppCue;
 	}
 
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 	return 0;
 }
 
@@ -974,7 +1283,7 @@ uint32_t FACTSoundBank_Play(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 
 	FACTSoundBank_Prepare(
 		pSoundBank,
@@ -994,7 +1303,7 @@ uint32_t FACTSoundBank_Play(
 	}
 	FACTCue_Play(result);
 
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 	return 0;
 }
 
@@ -1013,7 +1322,7 @@ uint32_t FACTSoundBank_Play3D(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 
 	FACTSoundBank_Prepare(
 		pSoundBank,
@@ -1034,7 +1343,7 @@ uint32_t FACTSoundBank_Play3D(
 	FACT3DApply(pDSPSettings, result);
 	FACTCue_Play(result);
 
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 	return 0;
 }
 
@@ -1049,7 +1358,7 @@ uint32_t FACTSoundBank_Stop(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 	cue = pSoundBank->cueList;
 	while (cue != NULL)
 	{
@@ -1075,21 +1384,20 @@ uint32_t FACTSoundBank_Stop(
 			cue = cue->next;
 		}
 	}
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 	return 0;
 }
 
 uint32_t FACTSoundBank_Destroy(FACTSoundBank *pSoundBank)
 {
-	uint16_t i, j, k;
-	FAudioMutex mutex;
+	FACTAudioEngine *engine;
 	FACTNotification note;
 	if (pSoundBank == NULL)
 	{
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 
 	/* Synchronously destroys all cues that are associated */
 	while (pSoundBank->cueList != NULL)
@@ -1108,85 +1416,11 @@ uint32_t FACTSoundBank_Destroy(FACTSoundBank *pSoundBank)
 		);
 	}
 
-	/* SoundBank Name */
-	pSoundBank->parentEngine->pFree(pSoundBank->name);
-
-	/* Cue data */
-	pSoundBank->parentEngine->pFree(pSoundBank->cues);
-
-	/* WaveBank Name data */
-	for (i = 0; i < pSoundBank->wavebankCount; i += 1)
-	{
-		pSoundBank->parentEngine->pFree(pSoundBank->wavebankNames[i]);
-	}
-	pSoundBank->parentEngine->pFree(pSoundBank->wavebankNames);
-
-	/* Sound data */
-	for (i = 0; i < pSoundBank->soundCount; i += 1)
-	{
-		for (j = 0; j < pSoundBank->sounds[i].trackCount; j += 1)
-		{
-			for (k = 0; k < pSoundBank->sounds[i].tracks[j].eventCount; k += 1)
-			{
-				#define MATCH(t) \
-					pSoundBank->sounds[i].tracks[j].events[k].type == t
-				if (	MATCH(FACTEVENT_PLAYWAVE) ||
-					MATCH(FACTEVENT_PLAYWAVETRACKVARIATION) ||
-					MATCH(FACTEVENT_PLAYWAVEEFFECTVARIATION) ||
-					MATCH(FACTEVENT_PLAYWAVETRACKEFFECTVARIATION)	)
-				{
-					if (pSoundBank->sounds[i].tracks[j].events[k].wave.isComplex)
-					{
-						pSoundBank->parentEngine->pFree(
-							pSoundBank->sounds[i].tracks[j].events[k].wave.complex.tracks
-						);
-						pSoundBank->parentEngine->pFree(
-							pSoundBank->sounds[i].tracks[j].events[k].wave.complex.wavebanks
-						);
-						pSoundBank->parentEngine->pFree(
-							pSoundBank->sounds[i].tracks[j].events[k].wave.complex.weights
-						);
-					}
-				}
-				#undef MATCH
-			}
-			pSoundBank->parentEngine->pFree(
-				pSoundBank->sounds[i].tracks[j].events
-			);
-		}
-		pSoundBank->parentEngine->pFree(pSoundBank->sounds[i].tracks);
-		pSoundBank->parentEngine->pFree(pSoundBank->sounds[i].rpcCodes);
-		pSoundBank->parentEngine->pFree(pSoundBank->sounds[i].dspCodes);
-	}
-	pSoundBank->parentEngine->pFree(pSoundBank->sounds);
-	pSoundBank->parentEngine->pFree(pSoundBank->soundCodes);
-
-	/* Variation data */
-	for (i = 0; i < pSoundBank->variationCount; i += 1)
-	{
-		pSoundBank->parentEngine->pFree(
-			pSoundBank->variations[i].entries
-		);
-	}
-	pSoundBank->parentEngine->pFree(pSoundBank->variations);
-	pSoundBank->parentEngine->pFree(pSoundBank->variationCodes);
-
-	/* Transition data */
-	for (i = 0; i < pSoundBank->transitionCount; i += 1)
-	{
-		pSoundBank->parentEngine->pFree(
-			pSoundBank->transitions[i].entries
-		);
-	}
-	pSoundBank->parentEngine->pFree(pSoundBank->transitions);
-	pSoundBank->parentEngine->pFree(pSoundBank->transitionCodes);
-
-	/* Cue Name data */
-	for (i = 0; i < pSoundBank->cueCount; i += 1)
-	{
-		pSoundBank->parentEngine->pFree(pSoundBank->cueNames[i]);
-	}
-	pSoundBank->parentEngine->pFree(pSoundBank->cueNames);
+	/* Every name, Sound, Cue and table */
+	FACT_INTERNAL_FreeArena(
+		&pSoundBank->arena,
+		pSoundBank->parentEngine->pFree
+	);
 
 	/* Finally. */
 	if (pSoundBank->notifyOnDestroy)
@@ -1196,9 +1430,9 @@ uint32_t FACTSoundBank_Destroy(FACTSoundBank *pSoundBank)
 		pSoundBank->parentEngine->notificationCallback(&note);
 	}
 
-	mutex = pSoundBank->parentEngine->apiLock;
-	pSoundBank->parentEngine->pFree(pSoundBank);
-	FAudio_PlatformUnlockMutex(mutex);
+	engine = pSoundBank->parentEngine;
+	engine->pFree(pSoundBank);
+	FACT_INTERNAL_UnlockAPI(engine);
 	return 0;
 }
 
@@ -1213,15 +1447,13 @@ uint32_t FACTSoundBank_GetState(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
 
 	if (pSoundBank == NULL)
 	{
 		*pdwState = 0;
 
-		FAudio_PlatformUnlockMutex(
-			pSoundBank->parentEngine->apiLock
-		);
+		FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 		return 0;
 	}
 	*pdwState = FACT_STATE_PREPARED;
@@ -1230,14 +1462,77 @@ uint32_t FACTSoundBank_GetState(
 		if (pSoundBank->cues[i].instanceCount > 0)
 		{
 			*pdwState |= FACT_STATE_INUSE;
-			FAudio_PlatformUnlockMutex(
-				pSoundBank->parentEngine->apiLock
-			);
+			FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 			return 0;
 		}
 	}
 
-	FAudio_PlatformUnlockMutex(pSoundBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
+	return 0;
+}
+
+uint32_t FACTSoundBank_PreloadCueEXT(
+	FACTSoundBank *pSoundBank,
+	uint16_t nCueIndex
+) {
+	uint16_t i, j, first, last;
+	FACTCueData *data;
+	FACTVariationTable *variation;
+
+	if (pSoundBank == NULL)
+	{
+		return 1;
+	}
+
+	/* FACTINDEX_INVALID preloads every Cue */
+	if (nCueIndex == FACTINDEX_INVALID)
+	{
+		first = 0;
+		last = pSoundBank->cueCount;
+	}
+	else if (nCueIndex < pSoundBank->cueCount)
+	{
+		first = nCueIndex;
+		last = nCueIndex + 1;
+	}
+	else
+	{
+		return 1;
+	}
+
+	FACT_INTERNAL_LockAPI(pSoundBank->parentEngine);
+
+	for (i = first; i < last; i += 1)
+	{
+		data = &pSoundBank->cues[i];
+		if (data->flags & 0x04)
+		{
+			FACT_INTERNAL_GetSound(pSoundBank, data->sbCode);
+			continue;
+		}
+
+		variation = NULL;
+		for (j = 0; j < pSoundBank->variationCount; j += 1)
+		{
+			if (data->sbCode == pSoundBank->variationCodes[j])
+			{
+				variation = &pSoundBank->variations[j];
+				break;
+			}
+		}
+		if (variation != NULL && variation->isComplex)
+		{
+			for (j = 0; j < variation->entryCount; j += 1)
+			{
+				FACT_INTERNAL_GetSound(
+					pSoundBank,
+					variation->entries[j].soundCode
+				);
+			}
+		}
+	}
+
+	FACT_INTERNAL_UnlockAPI(pSoundBank->parentEngine);
 	return 0;
 }
 
@@ -1247,14 +1542,16 @@ uint32_t FACTWaveBank_Destroy(FACTWaveBank *pWaveBank)
 {
 	uint32_t i;
 	FACTWave *wave;
-	FAudioMutex mutex;
+	FACTSoundBank *sb;
+	LinkedList *list;
+	FACTAudioEngine *engine;
 	FACTNotification note;
 	if (pWaveBank == NULL)
 	{
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
 
 	/* Synchronously destroys any cues that are using the wavebank */
 	while (pWaveBank->waveList != NULL)
@@ -1280,25 +1577,32 @@ uint32_t FACTWaveBank_Destroy(FACTWaveBank *pWaveBank)
 			pWaveBank->parentEngine->wbLock,
 			pWaveBank->parentEngine->pFree
 		);
-	}
 
-	/* Free everything, finally. */
-	pWaveBank->parentEngine->pFree(pWaveBank->name);
-	pWaveBank->parentEngine->pFree(pWaveBank->entries);
-	pWaveBank->parentEngine->pFree(pWaveBank->entryRefs);
-	if (pWaveBank->seekTables != NULL)
-	{
-		for (i = 0; i < pWaveBank->entryCount; i += 1)
+		/* SoundBanks have to look for this WaveBank again */
+		list = pWaveBank->parentEngine->sbList;
+		while (list != NULL)
 		{
-			if (pWaveBank->seekTables[i].entries != NULL)
+			sb = (FACTSoundBank*) list->entry;
+			for (i = 0; i < sb->wavebankCount; i += 1)
 			{
-				pWaveBank->parentEngine->pFree(
-					pWaveBank->seekTables[i].entries
-				);
+				if (sb->wavebanks[i] == pWaveBank)
+				{
+					sb->wavebanks[i] = NULL;
+				}
 			}
+			list = list->next;
 		}
-		pWaveBank->parentEngine->pFree(pWaveBank->seekTables);
 	}
+
+	/* Free everything, finally. */
+	if (pWaveBank->transcodes != NULL)
+	{
+		FACT_INTERNAL_DestroyTranscodes(pWaveBank);
+	}
+	FACT_INTERNAL_FreeArena(
+		&pWaveBank->arena,
+		pWaveBank->parentEngine->pFree
+	);
 	FAudio_close(pWaveBank->io);
 	if (pWaveBank->notifyOnDestroy)
 	{
@@ -1308,9 +1612,9 @@ uint32_t FACTWaveBank_Destroy(FACTWaveBank *pWaveBank)
 	}
 	FAudio_PlatformDestroyMutex(pWaveBank->waveLock);
 
-	mutex = pWaveBank->parentEngine->apiLock;
-	pWaveBank->parentEngine->pFree(pWaveBank);
-	FAudio_PlatformUnlockMutex(mutex);
+	engine = pWaveBank->parentEngine;
+	engine->pFree(pWaveBank);
+	FACT_INTERNAL_UnlockAPI(engine);
 	return 0;
 }
 
@@ -1325,14 +1629,12 @@ uint32_t FACTWaveBank_GetState(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
 
 	if (pWaveBank == NULL)
 	{
 		*pdwState = 0;
-		FAudio_PlatformUnlockMutex(
-			pWaveBank->parentEngine->apiLock
-		);
+		FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
 		return 0;
 	}
 	*pdwState = FACT_STATE_PREPARED;
@@ -1341,14 +1643,12 @@ uint32_t FACTWaveBank_GetState(
 		if (pWaveBank->entryRefs[i] > 0)
 		{
 			*pdwState |= FACT_STATE_INUSE;
-			FAudio_PlatformUnlockMutex(
-				pWaveBank->parentEngine->apiLock
-			);
+			FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
 			return 0;
 		}
 	}
 
-	FAudio_PlatformUnlockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
 	return 0;
 }
 
@@ -1361,9 +1661,9 @@ uint32_t FACTWaveBank_GetNumWaves(
 		*pnNumWaves = 0;
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
 	*pnNumWaves = pWaveBank->entryCount;
-	FAudio_PlatformUnlockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
 	return 0;
 }
 
@@ -1371,8 +1671,21 @@ uint16_t FACTWaveBank_GetWaveIndex(
 	FACTWaveBank *pWaveBank,
 	const char *szFriendlyName
 ) {
-	FAudio_assert(0 && "WaveBank name tables are not supported!");
-	return 0;
+	uint16_t i;
+	if (pWaveBank == NULL)
+	{
+		return FACTINDEX_INVALID;
+	}
+
+	/* Banks built without entry names have an empty table */
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
+	i = FACT_INTERNAL_FindName(
+		&pWaveBank->entryTable,
+		pWaveBank->entryNames,
+		szFriendlyName
+	);
+	FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
+	return i;
 }
 
 uint32_t FACTWaveBank_GetWaveProperties(
@@ -1386,7 +1699,7 @@ uint32_t FACTWaveBank_GetWaveProperties(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
 
 	entry = &pWaveBank->entries[nWaveIndex];
 
@@ -1415,7 +1728,7 @@ uint32_t FACTWaveBank_GetWaveProperties(
 	pWaveProperties->loopRegion = entry->LoopRegion;
 	pWaveProperties->streaming = pWaveBank->streaming;
 
-	FAudio_PlatformUnlockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
 	return 0;
 }
 
@@ -1429,8 +1742,6 @@ uint32_t FACTWaveBank_Prepare(
 ) {
 	FAudioBuffer buffer;
 	FAudioBufferWMA bufferWMA;
-	FAudioVoiceSends sends;
-	FAudioSendDescriptor send;
 	FAudioADPCMWaveFormat format;
 	FACTWaveBankEntry *entry;
 	if (pWaveBank == NULL)
@@ -1441,7 +1752,7 @@ uint32_t FACTWaveBank_Prepare(
 
 	*ppWave = (FACTWave*) pWaveBank->parentEngine->pMalloc(sizeof(FACTWave));
 
-	FAudio_PlatformLockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
 
 	entry = &pWaveBank->entries[nWaveIndex];
 
@@ -1456,6 +1767,7 @@ uint32_t FACTWaveBank_Prepare(
 	(*ppWave)->volume = 1.0f;
 	(*ppWave)->pitch = 0;
 	(*ppWave)->loopCount = nLoopCount;
+	(*ppWave)->virtualized = 0;
 
 	/* TODO: Convert dwPlayOffset to a byte offset */
 	FAudio_assert(dwPlayOffset == 0);
@@ -1471,14 +1783,30 @@ uint32_t FACTWaveBank_Prepare(
 	}
 #endif
 
+	/* A transcoded Wave that's ready plays its PCM16 instead */
+	(*ppWave)->transcode = NULL;
+	if (	pWaveBank->transcodes != NULL &&
+		pWaveBank->transcodes[nWaveIndex].selected	)
+	{
+		(*ppWave)->transcode = FACT_INTERNAL_UseTranscode(
+			pWaveBank,
+			nWaveIndex
+		);
+	}
+
 	/* Create the voice */
-	send.Flags = 0;
-	send.pOutputVoice = pWaveBank->parentEngine->master;
-	sends.SendCount = 1;
-	sends.pSends = &send;
+	FAudio_zero(&format, sizeof(format));
 	format.wfx.nChannels = entry->Format.nChannels;
 	format.wfx.nSamplesPerSec = entry->Format.nSamplesPerSec;
-	if (entry->Format.wFormatTag == 0x0)
+	if ((*ppWave)->transcode != NULL)
+	{
+		format.wfx.wFormatTag = FAUDIO_FORMAT_PCM;
+		format.wfx.wBitsPerSample = 16;
+		format.wfx.nBlockAlign = format.wfx.nChannels * 2;
+		format.wfx.nAvgBytesPerSec = format.wfx.nBlockAlign * format.wfx.nSamplesPerSec;
+		format.wfx.cbSize = 0;
+	}
+	else if (entry->Format.wFormatTag == 0x0)
 	{
 		format.wfx.wFormatTag = FAUDIO_FORMAT_PCM;
 		format.wfx.wBitsPerSample = 8 << entry->Format.wBitsPerSample;
@@ -1525,73 +1853,48 @@ uint32_t FACTWaveBank_Prepare(
 	{
 		FAudio_assert(0 && "Rebuild your WaveBanks with ADPCM!");
 	}
-	(*ppWave)->callback.callback.OnBufferEnd = pWaveBank->streaming ?
-		FACT_INTERNAL_OnBufferEnd :
-		NULL;
-	(*ppWave)->callback.callback.OnBufferStart = NULL;
-	(*ppWave)->callback.callback.OnLoopEnd = NULL;
-	(*ppWave)->callback.callback.OnStreamEnd = FACT_INTERNAL_OnStreamEnd;
-	(*ppWave)->callback.callback.OnVoiceError = NULL;
-	(*ppWave)->callback.callback.OnVoiceProcessingPassEnd = NULL;
-	(*ppWave)->callback.callback.OnVoiceProcessingPassStart = NULL;
-	(*ppWave)->callback.wave = *ppWave;
 	(*ppWave)->srcChannels = format.wfx.nChannels;
-	FAudio_CreateSourceVoice(
-		pWaveBank->parentEngine->audio,
-		&(*ppWave)->voice,
-		&format.wfx,
-		FAUDIO_VOICE_USEFILTER, /* FIXME: Can this be optional? */
-		4.0f,
-		(FAudioVoiceCallback*) &(*ppWave)->callback,
-		&sends,
-		NULL
+	(*ppWave)->pooledVoice = FACT_INTERNAL_AcquireVoice(
+		pWaveBank->parentEngine,
+		&format
 	);
+	(*ppWave)->pooledVoice->callback.callback.OnBufferEnd = pWaveBank->streaming ?
+		FACT_INTERNAL_OnBufferEnd :
+		NULL;
+	(*ppWave)->pooledVoice->callback.wave = *ppWave;
+	(*ppWave)->voice = (*ppWave)->pooledVoice->voice;
 	if (pWaveBank->streaming)
 	{
-		/* Init stream cache info */
-		if (format.wfx.wFormatTag == FAUDIO_FORMAT_PCM)
+		/* Reads and submits the first buffer, the streaming thread does
+		 * the rest
+		 */
+		FACT_INTERNAL_CreateStream(*ppWave, &format);
+	}
+	else
+	{
+		(*ppWave)->stream = NULL;
+
+		buffer.Flags = FAUDIO_END_OF_STREAM;
+		if ((*ppWave)->transcode != NULL)
 		{
-			(*ppWave)->streamSize = (
-				format.wfx.nSamplesPerSec *
-				format.wfx.nChannels *
-				(format.wfx.wBitsPerSample / 8)
-			);
+			buffer.AudioBytes = (*ppWave)->transcode->bytes;
+			buffer.pAudioData = (uint8_t*) (*ppWave)->transcode->pcm;
 		}
-		else if (format.wfx.wFormatTag == FAUDIO_FORMAT_MSADPCM)
+		else
 		{
-			(*ppWave)->streamSize = (
-				format.wfx.nSamplesPerSec /
-				format.wSamplesPerBlock *
-				format.wfx.nBlockAlign
+			buffer.AudioBytes = entry->PlayRegion.dwLength;
+			buffer.pAudioData = FAudio_memptr(
+				pWaveBank->io,
+				entry->PlayRegion.dwOffset
 			);
 		}
-		else
+		if (pWaveBank->prefetch)
 		{
-			/* Screw it, load the whole thing */
-			(*ppWave)->streamSize = entry->PlayRegion.dwLength;
+			FAudio_PlatformWillNeed(
+				buffer.pAudioData,
+				entry->PlayRegion.dwLength
+			);
 		}
-		(*ppWave)->streamCache = (uint8_t*) pWaveBank->parentEngine->pMalloc(
-			(*ppWave)->streamSize
-		);
-		(*ppWave)->streamOffset = entry->PlayRegion.dwOffset;
-
-		/* FIXME: Streaming doesn't support subregions right now >_< */
-		FAudio_assert(entry->LoopRegion.dwStartSample == 0);
-		FAudio_assert(entry->LoopRegion.dwTotalSamples == entry->Duration);
-
-		/* Read and submit first buffer from the WaveBank */
-		FACT_INTERNAL_OnBufferEnd(&(*ppWave)->callback.callback, NULL);
-	}
-	else
-	{
-		(*ppWave)->streamCache = NULL;
-
-		buffer.Flags = FAUDIO_END_OF_STREAM;
-		buffer.AudioBytes = entry->PlayRegion.dwLength;
-		buffer.pAudioData = FAudio_memptr(
-			pWaveBank->io,
-			entry->PlayRegion.dwOffset
-		);
 		buffer.PlayBegin = 0;
 		buffer.PlayLength = entry->Duration;
 		if (nLoopCount == 0)
@@ -1638,7 +1941,7 @@ uint32_t FACTWaveBank_Prepare(
 		pWaveBank->parentEngine->pMalloc
 	);
 
-	FAudio_PlatformUnlockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
 	return 0;
 }
 
@@ -1655,7 +1958,7 @@ uint32_t FACTWaveBank_Play(
 		*ppWave = NULL;
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
 	FACTWaveBank_Prepare(
 		pWaveBank,
 		nWaveIndex,
@@ -1665,7 +1968,7 @@ uint32_t FACTWaveBank_Play(
 		ppWave
 	);
 	FACTWave_Play(*ppWave);
-	FAudio_PlatformUnlockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
 	return 0;
 }
 
@@ -1680,7 +1983,7 @@ uint32_t FACTWaveBank_Stop(
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWaveBank->parentEngine);
 	list = pWaveBank->waveList;
 	while (list != NULL)
 	{
@@ -1691,7 +1994,35 @@ uint32_t FACTWaveBank_Stop(
 		}
 		list = list->next;
 	}
-	FAudio_PlatformUnlockMutex(pWaveBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWaveBank->parentEngine);
+	return 0;
+}
+
+uint32_t FACTWaveBank_GetStatsEXT(
+	FACTWaveBank *pWaveBank,
+	FACTWaveBankStatsEXT *pStats
+) {
+	FACTAudioEngine *engine;
+	if (pWaveBank == NULL)
+	{
+		FAudio_zero(pStats, sizeof(FACTWaveBankStatsEXT));
+		return 1;
+	}
+
+	engine = pWaveBank->parentEngine;
+	FACT_INTERNAL_LockAPI(engine);
+
+	/* Reads are counted under streamLock, which comes with the thread */
+	if (engine->streamLock != NULL)
+	{
+		FAudio_PlatformLockMutex(engine->streamLock);
+	}
+	FAudio_memcpy(pStats, &pWaveBank->stats, sizeof(FACTWaveBankStatsEXT));
+	if (engine->streamLock != NULL)
+	{
+		FAudio_PlatformUnlockMutex(engine->streamLock);
+	}
+	FACT_INTERNAL_UnlockAPI(engine);
 	return 0;
 }
 
@@ -1699,14 +2030,14 @@ uint32_t FACTWaveBank_Stop(
 
 uint32_t FACTWave_Destroy(FACTWave *pWave)
 {
-	FAudioMutex mutex;
+	FACTAudioEngine *engine;
 	FACTNotification note;
 	if (pWave == NULL)
 	{
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
 
 	/* Stop before we start deleting everything */
 	FACTWave_Stop(pWave, FACT_FLAG_STOP_IMMEDIATE);
@@ -1718,10 +2049,18 @@ uint32_t FACTWave_Destroy(FACTWave *pWave)
 		pWave->parentBank->parentEngine->pFree
 	);
 
-	FAudioVoice_DestroyVoice(pWave->voice);
-	if (pWave->streamCache != NULL)
+	if (pWave->stream != NULL)
+	{
+		FACT_INTERNAL_DestroyStream(pWave->stream);
+	}
+	FACT_INTERNAL_ReleaseVoice(
+		pWave->parentBank->parentEngine,
+		pWave->pooledVoice
+	);
+	if (pWave->transcode != NULL)
 	{
-		pWave->parentBank->parentEngine->pFree(pWave->streamCache);
+		/* The voice is flushed, the PCM can be evicted again */
+		FACT_INTERNAL_ReleaseTranscode(pWave->parentBank, pWave->transcode);
 	}
 	if (pWave->notifyOnDestroy)
 	{
@@ -1730,9 +2069,9 @@ uint32_t FACTWave_Destroy(FACTWave *pWave)
 		pWave->parentBank->parentEngine->notificationCallback(&note);
 	}
 
-	mutex = pWave->parentBank->parentEngine->apiLock;
-	pWave->parentBank->parentEngine->pFree(pWave);
-	FAudio_PlatformUnlockMutex(mutex);
+	engine = pWave->parentBank->parentEngine;
+	engine->pFree(pWave);
+	FACT_INTERNAL_UnlockAPI(engine);
 	return 0;
 }
 
@@ -1742,7 +2081,7 @@ uint32_t FACTWave_Play(FACTWave *pWave)
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
 	FAudio_assert(!(pWave->state & (FACT_STATE_PLAYING | FACT_STATE_STOPPING)));
 	pWave->state |= FACT_STATE_PLAYING;
 	pWave->state &= ~(
@@ -1750,7 +2089,13 @@ uint32_t FACTWave_Play(FACTWave *pWave)
 		FACT_STATE_STOPPED
 	);
 	FAudioSourceVoice_Start(pWave->voice, 0, 0);
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
+
+	/* This may put us over the budget */
+	if (pWave->parentBank->parentEngine->maxAudibleWaves > 0)
+	{
+		FACT_INTERNAL_WakeAPIThread(pWave->parentBank->parentEngine);
+	}
+	FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 	return 0;
 }
 
@@ -1760,7 +2105,7 @@ uint32_t FACTWave_Stop(FACTWave *pWave, uint32_t dwFlags)
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
 
 	/* There are two ways that a Wave might be stopped immediately:
 	 * 1. The program explicitly asks for it
@@ -1777,6 +2122,17 @@ uint32_t FACTWave_Stop(FACTWave *pWave, uint32_t dwFlags)
 		);
 		FAudioSourceVoice_Stop(pWave->voice, 0, 0);
 		FAudioSourceVoice_FlushSourceBuffers(pWave->voice);
+		if (pWave->virtualized)
+		{
+			pWave->virtualized = 0;
+			pWave->parentBank->parentEngine->virtualWaveCount -= 1;
+		}
+	}
+	else if (pWave->virtualized)
+	{
+		/* Same as ExitLoop, the thread plays out the rest */
+		pWave->state |= FACT_STATE_STOPPING;
+		pWave->virtualLoops = 0;
 	}
 	else
 	{
@@ -1784,7 +2140,7 @@ uint32_t FACTWave_Stop(FACTWave *pWave, uint32_t dwFlags)
 		FAudioSourceVoice_ExitLoop(pWave->voice, 0);
 	}
 
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 	return 0;
 }
 
@@ -1794,30 +2150,47 @@ uint32_t FACTWave_Pause(FACTWave *pWave, int32_t fPause)
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
+
+	/* Virtual Waves have no voice keeping time, so catch up to now */
+	if (pWave->virtualized)
+	{
+		FACT_INTERNAL_AdvanceVirtualWave(pWave, FAudio_timems());
+	}
 
 	/* FIXME: Does the Cue STOPPING/STOPPED rule apply here too? */
 	if (pWave->state & (FACT_STATE_STOPPING | FACT_STATE_STOPPED))
 	{
-		FAudio_PlatformUnlockMutex(
-			pWave->parentBank->parentEngine->apiLock
-		);
+		FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 		return 0;
 	}
 
-	/* All we do is set the flag, the mixer handles the rest */
+	/* All we do is set the flag, the mixer handles the rest. Virtual
+	 * Waves have no voice playing, the thread checks the flag instead.
+	 */
 	if (fPause)
 	{
 		pWave->state |= FACT_STATE_PAUSED;
-		FAudioSourceVoice_Stop(pWave->voice, 0, 0);
+		if (!pWave->virtualized)
+		{
+			FAudioSourceVoice_Stop(pWave->voice, 0, 0);
+		}
 	}
 	else
 	{
 		pWave->state &= ~FACT_STATE_PAUSED;
-		FAudioSourceVoice_Start(pWave->voice, 0, 0);
+		if (!pWave->virtualized)
+		{
+			FAudioSourceVoice_Start(pWave->voice, 0, 0);
+		}
+		else
+		{
+			/* The thread decides whether it can be heard again */
+			FACT_INTERNAL_WakeAPIThread(pWave->parentBank->parentEngine);
+		}
 	}
 
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 	return 0;
 }
 
@@ -1828,9 +2201,9 @@ uint32_t FACTWave_GetState(FACTWave *pWave, uint32_t *pdwState)
 		*pdwState = 0;
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
 	*pdwState = pWave->state;
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 	return 0;
 }
 
@@ -1840,7 +2213,12 @@ uint32_t FACTWave_SetPitch(FACTWave *pWave, int16_t pitch)
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
+	if (pWave->virtualized)
+	{
+		/* Everything up to now went by at the old pitch */
+		FACT_INTERNAL_AdvanceVirtualWave(pWave, FAudio_timems());
+	}
 	pWave->pitch = FAudio_clamp(
 		pitch,
 		FACTPITCH_MIN_TOTAL,
@@ -1851,7 +2229,7 @@ uint32_t FACTWave_SetPitch(FACTWave *pWave, int16_t pitch)
 		(float) FAudio_pow(2.0, pWave->pitch / 1200.0),
 		0
 	);
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 	return 0;
 }
 
@@ -1861,7 +2239,7 @@ uint32_t FACTWave_SetVolume(FACTWave *pWave, float volume)
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
 	pWave->volume = FAudio_clamp(
 		volume,
 		FACTVOLUME_MIN,
@@ -1872,7 +2250,7 @@ uint32_t FACTWave_SetVolume(FACTWave *pWave, float volume)
 		pWave->volume,
 		0
 	);
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 	return 0;
 }
 
@@ -1882,58 +2260,18 @@ uint32_t FACTWave_SetMatrixCoefficients(
 	uint32_t uDstChannelCount,
 	float *pMatrixCoefficients
 ) {
-	uint32_t i;
-	float *mtxDst, *mtxSrc;
 	if (pWave == NULL)
 	{
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
-
-	/* There seems to be this weird feature in XACT where the channel count
-	 * can be completely wrong and it'll go to the right place.
-	 * I guess these XACT functions do some extra work to merge coefficients
-	 * but I have no idea where it really happens and XAudio2 definitely
-	 * does NOT like it when this is wrong, so here it goes...
-	 * -flibit
-	 */
-	if (uSrcChannelCount == 1 && pWave->srcChannels == 2)
-	{
-		mtxDst = pMatrixCoefficients + ((uDstChannelCount - 1) * 2);
-		mtxSrc = pMatrixCoefficients + (uDstChannelCount - 1);
-		for (i = 0; i < uDstChannelCount; i += 1)
-		{
-			mtxDst[0] = *mtxSrc;
-			mtxDst[1] = *mtxSrc;
-			mtxDst -= 2;
-			mtxSrc -= 1;
-		}
-		uSrcChannelCount = 2;
-	}
-	else if (uSrcChannelCount == 2 && pWave->srcChannels == 1)
-	{
-		mtxDst = pMatrixCoefficients;
-		mtxSrc = pMatrixCoefficients;
-		for (i = 0; i < uDstChannelCount; i += 1)
-		{
-			*mtxDst = (mtxSrc[0] + mtxSrc[1]) / 2.0f;
-			mtxDst += 1;
-			mtxSrc += 2;
-		}
-		uSrcChannelCount = 1;
-	}
-
-	FAudioVoice_SetOutputMatrix(
-		pWave->voice,
-		pWave->voice->sends.pSends->pOutputVoice,
+	FACT_INTERNAL_SetWaveMatrix(
+		pWave,
 		uSrcChannelCount,
 		uDstChannelCount,
 		pMatrixCoefficients,
-		0
+		FAUDIO_COMMIT_NOW
 	);
-
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
 	return 0;
 }
 
@@ -1945,7 +2283,7 @@ uint32_t FACTWave_GetProperties(
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pWave->parentBank->parentEngine);
 
 	FACTWaveBank_GetWaveProperties(
 		pWave->parentBank,
@@ -1956,7 +2294,7 @@ uint32_t FACTWave_GetProperties(
 	/* FIXME: This is unsupported on PC, do we care about this? */
 	pProperties->backgroundMusic = 0;
 
-	FAudio_PlatformUnlockMutex(pWave->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pWave->parentBank->parentEngine);
 	return 0;
 }
 
@@ -1965,17 +2303,27 @@ uint32_t FACTWave_GetProperties(
 uint32_t FACTCue_Destroy(FACTCue *pCue)
 {
 	FACTCue *cue, *prev;
-	FAudioMutex mutex;
+	FACTAudioEngine *engine;
 	FACTNotification note;
 	if (pCue == NULL)
 	{
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
 
 	/* Stop before we start deleting everything */
 	FACTCue_Stop(pCue, FACT_FLAG_STOP_IMMEDIATE);
+	FACT_INTERNAL_DeactivateCue(pCue);
+
+	/* A simple Wave that played to the end is still around, since Stop
+	 * has nothing to do for a Cue that's already stopped
+	 */
+	if (pCue->simpleWave != NULL)
+	{
+		FACTWave_Destroy(pCue->simpleWave);
+		pCue->simpleWave = NULL;
+	}
 
 	if (pCue->parentBank != NULL)
 	{
@@ -2010,9 +2358,9 @@ uint32_t FACTCue_Destroy(FACTCue *pCue)
 		pCue->parentBank->parentEngine->notificationCallback(&note);
 	}
 
-	mutex = pCue->parentBank->parentEngine->apiLock;
-	pCue->parentBank->parentEngine->pFree(pCue);
-	FAudio_PlatformUnlockMutex(mutex);
+	engine = pCue->parentBank->parentEngine;
+	engine->pFree(pCue);
+	FACT_INTERNAL_UnlockAPI(engine);
 	return 0;
 }
 
@@ -2031,7 +2379,7 @@ uint32_t FACTCue_Play(FACTCue *pCue)
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
 
 	FAudio_assert(!(pCue->state & (FACT_STATE_PLAYING | FACT_STATE_STOPPING)));
 
@@ -2050,9 +2398,11 @@ uint32_t FACTCue_Play(FACTCue *pCue)
 				FACT_STATE_STOPPING |
 				FACT_STATE_PAUSED
 			);
-			FAudio_PlatformUnlockMutex(
-				pCue->parentBank->parentEngine->apiLock
-			);
+
+			/* Managed Cues still need the thread to destroy them */
+			FACT_INTERNAL_ActivateCue(pCue);
+			FACT_INTERNAL_WakeAPIThread(pCue->parentBank->parentEngine);
+			FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 			return 1;
 		}
 		else if (data->maxInstanceBehavior == 1) /* Queue */
@@ -2135,9 +2485,10 @@ uint32_t FACTCue_Play(FACTCue *pCue)
 	/* Need an initial sound to play */
 	if (!FACT_INTERNAL_CreateSound(pCue, fadeInMS))
 	{
-		FAudio_PlatformUnlockMutex(
-			pCue->parentBank->parentEngine->apiLock
-		);
+		/* Same as above when the category limit fails us */
+		FACT_INTERNAL_ActivateCue(pCue);
+		FACT_INTERNAL_WakeAPIThread(pCue->parentBank->parentEngine);
+		FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 		return 1;
 	}
 	data->instanceCount += 1;
@@ -2164,7 +2515,9 @@ uint32_t FACTCue_Play(FACTCue *pCue)
 		FACTWave_Play(pCue->simpleWave);
 	}
 
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_ActivateCue(pCue);
+	FACT_INTERNAL_WakeAPIThread(pCue->parentBank->parentEngine);
+	FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 	return 0;
 }
 
@@ -2174,14 +2527,12 @@ uint32_t FACTCue_Stop(FACTCue *pCue, uint32_t dwFlags)
 	{
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
 
 	/* If we're already stopped, there's nothing to do... */
 	if (pCue->state & FACT_STATE_STOPPED)
 	{
-		FAudio_PlatformUnlockMutex(
-			pCue->parentBank->parentEngine->apiLock
-		);
+		FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 		return 0;
 	}
 
@@ -2191,9 +2542,7 @@ uint32_t FACTCue_Stop(FACTCue *pCue, uint32_t dwFlags)
 	if (	(pCue->state & FACT_STATE_STOPPING) &&
 		!(dwFlags & FACT_FLAG_STOP_IMMEDIATE)	)
 	{
-		FAudio_PlatformUnlockMutex(
-			pCue->parentBank->parentEngine->apiLock
-		);
+		FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 		return 0;
 	}
 
@@ -2249,7 +2598,10 @@ uint32_t FACTCue_Stop(FACTCue *pCue, uint32_t dwFlags)
 		pCue->state |= FACT_STATE_STOPPING;
 	}
 
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
+	/* The thread takes it off the list, destroying it if it's managed */
+	FACT_INTERNAL_ActivateCue(pCue);
+	FACT_INTERNAL_WakeAPIThread(pCue->parentBank->parentEngine);
+	FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 	return 0;
 }
 
@@ -2260,9 +2612,9 @@ uint32_t FACTCue_GetState(FACTCue *pCue, uint32_t *pdwState)
 		*pdwState = 0;
 		return 1;
 	}
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
 	*pdwState = pCue->state;
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 	return 0;
 }
 
@@ -2272,51 +2624,13 @@ uint32_t FACTCue_SetMatrixCoefficients(
 	uint32_t uDstChannelCount,
 	float *pMatrixCoefficients
 ) {
-	uint8_t i;
-
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
-
-	/* See FACTCue.matrixCoefficients declaration */
-	FAudio_assert(uSrcChannelCount > 0 && uSrcChannelCount < 3);
-	FAudio_assert(uDstChannelCount > 0 && uDstChannelCount < 9);
-
-	/* Local storage */
-	pCue->srcChannels = uSrcChannelCount;
-	pCue->dstChannels = uDstChannelCount;
-	FAudio_memcpy(
-		pCue->matrixCoefficients,
+	FACT_INTERNAL_SetCueMatrix(
+		pCue,
+		uSrcChannelCount,
+		uDstChannelCount,
 		pMatrixCoefficients,
-		sizeof(float) * uSrcChannelCount * uDstChannelCount
+		FAUDIO_COMMIT_NOW
 	);
-	pCue->active3D = 1;
-
-	/* Apply to Waves if they exist */
-	if (pCue->simpleWave != NULL)
-	{
-		FACTWave_SetMatrixCoefficients(
-			pCue->simpleWave,
-			uSrcChannelCount,
-			uDstChannelCount,
-			pMatrixCoefficients
-		);
-	}
-	else if (pCue->playingSound != NULL)
-	{
-		for (i = 0; i < pCue->playingSound->sound->trackCount; i += 1)
-		{
-			if (pCue->playingSound->tracks[i].activeWave.wave != NULL)
-			{
-				FACTWave_SetMatrixCoefficients(
-					pCue->playingSound->tracks[i].activeWave.wave,
-					uSrcChannelCount,
-					uDstChannelCount,
-					pMatrixCoefficients
-				);
-			}
-		}
-	}
-
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
 	return 0;
 }
 
@@ -2329,20 +2643,14 @@ uint16_t FACTCue_GetVariableIndex(
 	{
 		return FACTVARIABLEINDEX_INVALID;
 	}
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
-	for (i = 0; i < pCue->parentBank->parentEngine->variableCount; i += 1)
-	{
-		if (	FAudio_strcmp(szFriendlyName, pCue->parentBank->parentEngine->variableNames[i]) == 0 &&
-			pCue->parentBank->parentEngine->variables[i].accessibility & 0x04	)
-		{
-			FAudio_PlatformUnlockMutex(
-				pCue->parentBank->parentEngine->apiLock
-			);
-			return i;
-		}
-	}
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
-	return FACTVARIABLEINDEX_INVALID;
+	FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
+	i = FACT_INTERNAL_FindName(
+		&pCue->parentBank->parentEngine->cueVariableTable,
+		pCue->parentBank->parentEngine->variableNames,
+		szFriendlyName
+	);
+	FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
+	return i;
 }
 
 uint32_t FACTCue_SetVariable(
@@ -2361,19 +2669,21 @@ uint32_t FACTCue_SetVariable(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
-
+	/* No apiLock, so the game never waits for the engine thread here */
 	var = &pCue->parentBank->parentEngine->variables[nIndex];
 	FAudio_assert(var->accessibility & 0x01);
 	FAudio_assert(!(var->accessibility & 0x02));
 	FAudio_assert(var->accessibility & 0x04);
-	pCue->variableValues[nIndex] = FAudio_clamp(
-		nValue,
-		var->minValue,
-		var->maxValue
+	FACT_INTERNAL_StoreVariable(
+		&pCue->variableValues[nIndex],
+		FAudio_clamp(
+			nValue,
+			var->minValue,
+			var->maxValue
+		)
 	);
 
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_WakeAPIThread(pCue->parentBank->parentEngine);
 	return 0;
 }
 
@@ -2394,22 +2704,23 @@ uint32_t FACTCue_GetVariable(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
-
 	var = &pCue->parentBank->parentEngine->variables[nIndex];
 	FAudio_assert(var->accessibility & 0x01);
 	FAudio_assert(var->accessibility & 0x04);
 
 	if (nIndex == 0) /* NumCueInstances */
 	{
+		/* This one does change under apiLock */
+		FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
 		*nValue = pCue->parentBank->cues[pCue->index].instanceCount;
+		FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 	}
 	else
 	{
-		*nValue = pCue->variableValues[nIndex];
+		*nValue = FACT_INTERNAL_LoadVariable(
+			&pCue->variableValues[nIndex]
+		);
 	}
-
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
 	return 0;
 }
 
@@ -2421,14 +2732,12 @@ uint32_t FACTCue_Pause(FACTCue *pCue, int32_t fPause)
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
 
 	/* "A stopping or stopped cue cannot be paused." */
 	if (pCue->state & (FACT_STATE_STOPPING | FACT_STATE_STOPPED))
 	{
-		FAudio_PlatformUnlockMutex(
-			pCue->parentBank->parentEngine->apiLock
-		);
+		FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 		return 0;
 	}
 
@@ -2439,10 +2748,12 @@ uint32_t FACTCue_Pause(FACTCue *pCue, int32_t fPause)
 	if (fPause)
 	{
 		pCue->state |= FACT_STATE_PAUSED;
+		FACT_INTERNAL_DeactivateCue(pCue);
 	}
 	else
 	{
 		pCue->state &= ~FACT_STATE_PAUSED;
+		FACT_INTERNAL_ActivateCue(pCue);
 	}
 
 	/* Pause the Waves */
@@ -2464,7 +2775,8 @@ uint32_t FACTCue_Pause(FACTCue *pCue, int32_t fPause)
 		}
 	}
 
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_WakeAPIThread(pCue->parentBank->parentEngine);
+	FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 	return 0;
 }
 
@@ -2483,7 +2795,7 @@ uint32_t FACTCue_GetProperties(
 		return 1;
 	}
 
-	FAudio_PlatformLockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_LockAPI(pCue->parentBank->parentEngine);
 
 	/* Alloc container (including variable length array space) */
 	allocSize = sizeof(FACTCueInstanceProperties);
@@ -2563,7 +2875,7 @@ uint32_t FACTCue_GetProperties(
 		}
 	}
 
-	FAudio_PlatformUnlockMutex(pCue->parentBank->parentEngine->apiLock);
+	FACT_INTERNAL_UnlockAPI(pCue->parentBank->parentEngine);
 
 	*ppProperties = cueProps;
 	return 0;
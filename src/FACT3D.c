@@ -25,6 +25,7 @@
  */
 
 #include "FACT3D.h"
+#include "FACT_internal.h"
 
 uint32_t FACT3DInitialize(
 	FACTAudioEngine *pEngine,
@@ -58,12 +59,11 @@ uint32_t FACT3DInitialize(
 	return 0;
 }
 
-uint32_t FACT3DCalculate(
-	F3DAUDIO_HANDLE F3DInstance,
-	const F3DAUDIO_LISTENER *pListener,
-	F3DAUDIO_EMITTER *pEmitter,
-	F3DAUDIO_DSP_SETTINGS *pDSPSettings
-) {
+/* Fills in the defaults that XACT uses for whatever the emitter leaves out.
+ * Returns 0 for channel counts with no default layout.
+ */
+static uint8_t FACT3D_INTERNAL_PrepareEmitter(F3DAUDIO_EMITTER *pEmitter)
+{
 	static F3DAUDIO_DISTANCE_CURVE_POINT DefaultCurvePoints[2] =
 	{
 		{ 0.0f, 1.0f },
@@ -74,11 +74,6 @@ uint32_t FACT3DCalculate(
 		(F3DAUDIO_DISTANCE_CURVE_POINT*) &DefaultCurvePoints[0], 2
 	};
 
-	if (pListener == NULL || pEmitter == NULL || pDSPSettings == NULL)
-	{
-		return 0;
-	}
-
 	if (pEmitter->ChannelCount > 1 && pEmitter->pChannelAzimuths == NULL)
 	{
 		pEmitter->ChannelRadius = 1.0f;
@@ -121,21 +116,79 @@ uint32_t FACT3DCalculate(
 	{
 		pEmitter->pLFECurve = &DefaultCurve;
 	}
+	return 1;
+}
+
+#define FACT3D_CALCULATE_FLAGS ( \
+	F3DAUDIO_CALCULATE_MATRIX | \
+	F3DAUDIO_CALCULATE_DOPPLER | \
+	F3DAUDIO_CALCULATE_EMITTER_ANGLE \
+)
+
+uint32_t FACT3DCalculate(
+	F3DAUDIO_HANDLE F3DInstance,
+	const F3DAUDIO_LISTENER *pListener,
+	F3DAUDIO_EMITTER *pEmitter,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings
+) {
+	if (pListener == NULL || pEmitter == NULL || pDSPSettings == NULL)
+	{
+		return 0;
+	}
+
+	if (!FACT3D_INTERNAL_PrepareEmitter(pEmitter))
+	{
+		return 0;
+	}
 
 	F3DAudioCalculate(
 		F3DInstance,
 		pListener,
 		pEmitter,
-		(
-			F3DAUDIO_CALCULATE_MATRIX |
-			F3DAUDIO_CALCULATE_DOPPLER |
-			F3DAUDIO_CALCULATE_EMITTER_ANGLE
-		),
+		FACT3D_CALCULATE_FLAGS,
 		pDSPSettings
 	);
 	return 0;
 }
 
+uint32_t FACT3DCalculateIncrementalEXT(
+	F3DAUDIO_HANDLE F3DInstance,
+	const F3DAUDIO_LISTENER *pListener,
+	F3DAUDIO_EMITTER *pEmitter,
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings,
+	F3DAUDIO_INCREMENTAL_STATE_EXT *pState
+) {
+	if (pState == NULL)
+	{
+		return FACT3DCalculate(
+			F3DInstance,
+			pListener,
+			pEmitter,
+			pDSPSettings
+		);
+	}
+
+	if (pListener == NULL || pEmitter == NULL || pDSPSettings == NULL)
+	{
+		return 0;
+	}
+
+	if (!FACT3D_INTERNAL_PrepareEmitter(pEmitter))
+	{
+		return 0;
+	}
+
+	F3DAudioCalculateIncrementalEXT(
+		F3DInstance,
+		pListener,
+		pEmitter,
+		FACT3D_CALCULATE_FLAGS,
+		pDSPSettings,
+		pState
+	);
+	return 0;
+}
+
 uint32_t FACT3DApply(
 	F3DAUDIO_DSP_SETTINGS *pDSPSettings,
 	FACTCue *pCue
@@ -145,11 +198,15 @@ uint32_t FACT3DApply(
 		return 0;
 	}
 
-	FACTCue_SetMatrixCoefficients(
+	/* Unchanged matrices are skipped, the rest are applied together on
+	 * FACTAudioEngine_DoWork
+	 */
+	FACT_INTERNAL_SetCueMatrix(
 		pCue,
 		pDSPSettings->SrcChannelCount,
 		pDSPSettings->DstChannelCount,
-		pDSPSettings->pMatrixCoefficients
+		pDSPSettings->pMatrixCoefficients,
+		FACT_OPERATIONSET_3D
 	);
 	FACTCue_SetVariable(
 		pCue,
@@ -169,4 +226,28 @@ uint32_t FACT3DApply(
 	return 0;
 }
 
+uint32_t FACT3DApplyIncrementalEXT(
+	F3DAUDIO_DSP_SETTINGS *pDSPSettings,
+	FACTCue *pCue,
+	F3DAUDIO_INCREMENTAL_STATE_EXT *pState
+) {
+	if (pState == NULL)
+	{
+		return FACT3DApply(pDSPSettings, pCue);
+	}
+
+	if (pDSPSettings == NULL || pCue == NULL)
+	{
+		return 0;
+	}
+
+	/* Nothing was recalculated, so the cue already has these settings */
+	if (!pState->Changed)
+	{
+		return 0;
+	}
+	pState->Changed = 0;
+	return FACT3DApply(pDSPSettings, pCue);
+}
+
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
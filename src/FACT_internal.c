@@ -74,9 +74,7 @@ void FACT_INTERNAL_GetNextWave(
 ) {
 	FAudioSendDescriptor reverbDesc[2];
 	FAudioVoiceSends reverbSends;
-	const char *wbName;
 	FACTWaveBank *wb = NULL;
-	LinkedList *list;
 	uint16_t wbTrack;
 	uint8_t wbIndex;
 	uint8_t loopCount = 0;
@@ -157,17 +155,7 @@ void FACT_INTERNAL_GetNextWave(
 		wbIndex = evt->wave.simple.wavebank;
 		wbTrack = evt->wave.simple.track;
 	}
-	wbName = cue->parentBank->wavebankNames[wbIndex];
-	list = cue->parentBank->parentEngine->wbList;
-	while (list != NULL)
-	{
-		wb = (FACTWaveBank*) list->entry;
-		if (FAudio_strcmp(wbName, wb->name) == 0)
-		{
-			break;
-		}
-		list = list->next;
-	}
+	wb = FACT_INTERNAL_GetWaveBank(cue->parentBank, wbIndex);
 	FAudio_assert(wb != NULL);
 
 	/* Generate the Wave */
@@ -359,9 +347,7 @@ uint8_t FACT_INTERNAL_CreateSound(FACTCue *cue, uint16_t fadeInMS)
 {
 	int32_t i, j, k;
 	float max, next, weight;
-	const char *wbName;
 	FACTWaveBank *wb = NULL;
-	LinkedList *list;
 	FACTEvent *evt;
 	FACTEventInstance *evtInst;
 	FACTSound *baseSound = NULL;
@@ -454,32 +440,19 @@ uint8_t FACT_INTERNAL_CreateSound(FACTCue *cue, uint16_t fadeInMS)
 
 		if (cue->variation->isComplex)
 		{
-			/* Grab the Sound via the code. FIXME: Do this at load time? */
-			for (j = 0; j < cue->parentBank->soundCount; j += 1)
-			{
-				if (cue->variation->entries[i].soundCode == cue->parentBank->soundCodes[j])
-				{
-					baseSound = &cue->parentBank->sounds[j];
-					break;
-				}
-			}
+			/* Grab the Sound via the code */
+			baseSound = FACT_INTERNAL_GetSound(
+				cue->parentBank,
+				cue->variation->entries[i].soundCode
+			);
 		}
 		else
 		{
 			/* Pull in the WaveBank... */
-			wbName = cue->parentBank->wavebankNames[
+			wb = FACT_INTERNAL_GetWaveBank(
+				cue->parentBank,
 				cue->variation->entries[i].simple.wavebank
-			];
-			list = cue->parentBank->parentEngine->wbList;
-			while (list != NULL)
-			{
-				wb = (FACTWaveBank*) list->entry;
-				if (FAudio_strcmp(wbName, wb->name) == 0)
-				{
-					break;
-				}
-				list = list->next;
-			}
+			);
 			FAudio_assert(wb != NULL);
 
 			/* Generate the wave... */
@@ -598,8 +571,9 @@ uint8_t FACT_INTERNAL_CreateSound(FACTCue *cue, uint16_t fadeInMS)
 			category->instanceCount += 1;
 		}
 
-		newSound = (FACTSoundInstance*) cue->parentBank->parentEngine->pMalloc(
-			sizeof(FACTSoundInstance)
+		newSound = FACT_INTERNAL_AllocSound(
+			cue->parentBank->parentEngine,
+			baseSound
 		);
 		newSound->parentCue = cue;
 		newSound->sound = baseSound;
@@ -619,9 +593,6 @@ uint8_t FACT_INTERNAL_CreateSound(FACTCue *cue, uint16_t fadeInMS)
 			newSound->fadeStart = 0;
 			newSound->fadeTarget = 0;
 		}
-		newSound->tracks = (FACTTrackInstance*) cue->parentBank->parentEngine->pMalloc(
-			sizeof(FACTTrackInstance) * newSound->sound->trackCount
-		);
 		for (i = 0; i < newSound->sound->trackCount; i += 1)
 		{
 			newSound->tracks[i].rpcData.rpcVolume = 0.0f;
@@ -644,9 +615,6 @@ uint8_t FACT_INTERNAL_CreateSound(FACTCue *cue, uint16_t fadeInMS)
 			newSound->tracks[i].upcomingWave.baseQFactor = FAUDIO_DEFAULT_FILTER_ONEOVERQ;
 			newSound->tracks[i].upcomingWave.baseFrequency = FAUDIO_DEFAULT_FILTER_FREQUENCY;
 
-			newSound->tracks[i].events = (FACTEventInstance*) cue->parentBank->parentEngine->pMalloc(
-				sizeof(FACTEventInstance) * newSound->sound->tracks[i].eventCount
-			);
 			for (j = 0; j < newSound->sound->tracks[i].eventCount; j += 1)
 			{
 				evt = &newSound->sound->tracks[i].events[j];
@@ -718,24 +686,18 @@ uint8_t FACT_INTERNAL_CreateSound(FACTCue *cue, uint16_t fadeInMS)
 		cue->maxRpcReleaseTime = 0;
 		for (i = 0; i < newSound->sound->trackCount; i += 1)
 		{
-			for (j = 0; j < newSound->sound->tracks[i].rpcCodeCount; j += 1)
+			for (j = 0; j < newSound->sound->tracks[i].rpcCount; j += 1)
 			{
-				rpc = FACT_INTERNAL_GetRPC(
-					newSound->parentCue->parentBank->parentEngine,
-					newSound->sound->tracks[i].rpcCodes[j]
-				);
+				rpc = &cue->parentBank->parentEngine->rpcs[
+					newSound->sound->tracks[i].rpcIndices[j]
+				];
 				if (	rpc->parameter == RPC_PARAMETER_VOLUME &&
-					cue->parentBank->parentEngine->variables[rpc->variable].accessibility & 0x04	)
+					cue->parentBank->parentEngine->variables[rpc->variable].special == VARIABLE_SPECIAL_RELEASETIME	)
 				{
-					if (FAudio_strcmp(
-						newSound->parentCue->parentBank->parentEngine->variableNames[rpc->variable],
-						"ReleaseTime"
-					) == 0) {
-						lastX = rpc->points[rpc->pointCount - 1].x;
-						if (lastX > cue->maxRpcReleaseTime)
-						{
-							cue->maxRpcReleaseTime = (uint32_t) lastX /* bleh */;
-						}
+					lastX = rpc->points[rpc->pointCount - 1].x;
+					if (lastX > cue->maxRpcReleaseTime)
+					{
+						cue->maxRpcReleaseTime = (uint32_t) lastX /* bleh */;
 					}
 				}
 			}
@@ -766,11 +728,7 @@ void FACT_INTERNAL_DestroySound(FACTSoundInstance *sound)
 				sound->tracks[i].upcomingWave.wave
 			);
 		}
-		sound->parentCue->parentBank->parentEngine->pFree(
-			sound->tracks[i].events
-		);
 	}
-	sound->parentCue->parentBank->parentEngine->pFree(sound->tracks);
 
 	if (sound->sound->category != FACTCATEGORY_INVALID)
 	{
@@ -785,7 +743,53 @@ void FACT_INTERNAL_DestroySound(FACTSoundInstance *sound)
 		sound->parentCue->state &= ~(FACT_STATE_PLAYING | FACT_STATE_STOPPING);
 		sound->parentCue->data->instanceCount -= 1;
 	}
-	sound->parentCue->parentBank->parentEngine->pFree(sound);
+	FACT_INTERNAL_FreeSound(
+		sound->parentCue->parentBank->parentEngine,
+		sound
+	);
+}
+
+void FACT_INTERNAL_ActivateCue(FACTCue *cue)
+{
+	FACTAudioEngine *engine = cue->parentBank->parentEngine;
+
+	if (cue->active)
+	{
+		return;
+	}
+
+	cue->activePrev = NULL;
+	cue->activeNext = engine->activeCues;
+	if (engine->activeCues != NULL)
+	{
+		engine->activeCues->activePrev = cue;
+	}
+	engine->activeCues = cue;
+	cue->active = 1;
+}
+
+void FACT_INTERNAL_DeactivateCue(FACTCue *cue)
+{
+	if (!cue->active)
+	{
+		return;
+	}
+
+	if (cue->activePrev != NULL)
+	{
+		cue->activePrev->activeNext = cue->activeNext;
+	}
+	else
+	{
+		cue->parentBank->parentEngine->activeCues = cue->activeNext;
+	}
+	if (cue->activeNext != NULL)
+	{
+		cue->activeNext->activePrev = cue->activePrev;
+	}
+	cue->activePrev = NULL;
+	cue->activeNext = NULL;
+	cue->active = 0;
 }
 
 void FACT_INTERNAL_BeginFadeOut(FACTSoundInstance *sound, uint16_t fadeOutMS)
@@ -816,23 +820,1985 @@ void FACT_INTERNAL_BeginReleaseRPC(FACTSoundInstance *sound, uint16_t releaseMS)
 	sound->fadeTarget = releaseMS;
 }
 
-/* RPC Helper Functions */
+/* Sound Pool Functions */
 
-FACTRPC* FACT_INTERNAL_GetRPC(
+FACTSoundInstance* FACT_INTERNAL_AllocSound(
 	FACTAudioEngine *engine,
-	uint32_t code
+	FACTSound *sound
 ) {
-	uint16_t i;
-	for (i = 0; i < engine->rpcCount; i += 1)
+	FACTSoundSlot *slot;
+	FACTSoundInstance *result;
+	FACTEventInstance *events;
+	uint8_t i;
+
+	FAudio_assert(sound->instanceSize <= engine->soundSlotSize);
+	if (engine->idleSounds != NULL)
 	{
-		if (engine->rpcCodes[i] == code)
+		slot = engine->idleSounds;
+		engine->idleSounds = slot->next;
+	}
+	else
+	{
+		slot = (FACTSoundSlot*) engine->pMalloc(
+			sizeof(FACTSoundSlot) + engine->soundSlotSize
+		);
+		slot->size = engine->soundSlotSize;
+	}
+	slot->next = NULL;
+
+	result = (FACTSoundInstance*) (slot + 1);
+	result->tracks = (FACTTrackInstance*) (result + 1);
+	events = (FACTEventInstance*) (result->tracks + sound->trackCount);
+	for (i = 0; i < sound->trackCount; i += 1)
+	{
+		result->tracks[i].events = events;
+		events += sound->tracks[i].eventCount;
+	}
+	return result;
+}
+
+void FACT_INTERNAL_FreeSound(
+	FACTAudioEngine *engine,
+	FACTSoundInstance *sound
+) {
+	FACTSoundSlot *slot = ((FACTSoundSlot*) sound) - 1;
+
+	/* Too small for what's been parsed since, can't reuse it */
+	if (slot->size < engine->soundSlotSize)
+	{
+		engine->pFree(slot);
+		return;
+	}
+	slot->next = engine->idleSounds;
+	engine->idleSounds = slot;
+}
+
+void FACT_INTERNAL_GrowSoundPool(FACTAudioEngine *engine, size_t slotSize)
+{
+	if (slotSize > engine->soundSlotSize)
+	{
+		engine->soundSlotSize = slotSize;
+		FACT_INTERNAL_TrimSoundPool(engine);
+	}
+}
+
+void FACT_INTERNAL_TrimSoundPool(FACTAudioEngine *engine)
+{
+	FACTSoundSlot *slot;
+	while (engine->idleSounds != NULL)
+	{
+		slot = engine->idleSounds;
+		engine->idleSounds = slot->next;
+		engine->pFree(slot);
+	}
+}
+
+/* Voice Pool Functions */
+
+static uint8_t FACT_INTERNAL_IsPoolable(const FAudioADPCMWaveFormat *format)
+{
+	/* The xWMA and XMA2 decoders keep their state between buffers */
+	return (	format->wfx.wFormatTag == FAUDIO_FORMAT_PCM ||
+			format->wfx.wFormatTag == FAUDIO_FORMAT_MSADPCM	);
+}
+
+static void FACT_INTERNAL_GetMasterSends(
+	FACTAudioEngine *engine,
+	FAudioVoiceSends *sends,
+	FAudioSendDescriptor *send
+) {
+	send->Flags = 0;
+	send->pOutputVoice = engine->master;
+	sends->SendCount = 1;
+	sends->pSends = send;
+}
+
+FACTPooledVoice* FACT_INTERNAL_AcquireVoice(
+	FACTAudioEngine *engine,
+	const FAudioADPCMWaveFormat *format
+) {
+	FACTPooledVoice *pooled, *prev;
+	FAudioVoiceSends sends;
+	FAudioSendDescriptor send;
+
+	/* The format is zeroed before it's filled in, so memcmp is fine */
+	prev = NULL;
+	pooled = engine->idleVoices;
+	while (pooled != NULL)
+	{
+		if (FAudio_memcmp(
+			&pooled->format,
+			format,
+			sizeof(FAudioADPCMWaveFormat)
+		) == 0) {
+			if (prev == NULL)
+			{
+				engine->idleVoices = pooled->next;
+			}
+			else
+			{
+				prev->next = pooled->next;
+			}
+			pooled->next = NULL;
+			engine->idleVoiceCount -= 1;
+			engine->activeVoiceCount += 1;
+			engine->stats.VoicesReused += 1;
+			return pooled;
+		}
+		prev = pooled;
+		pooled = pooled->next;
+	}
+
+	pooled = (FACTPooledVoice*) engine->pMalloc(sizeof(FACTPooledVoice));
+	FAudio_zero(pooled, sizeof(FACTPooledVoice));
+	FAudio_memcpy(&pooled->format, format, sizeof(FAudioADPCMWaveFormat));
+	pooled->callback.callback.OnStreamEnd = FACT_INTERNAL_OnStreamEnd;
+	FACT_INTERNAL_GetMasterSends(engine, &sends, &send);
+	FAudio_CreateSourceVoice(
+		engine->audio,
+		&pooled->voice,
+		&pooled->format.wfx,
+		FAUDIO_VOICE_USEFILTER, /* FIXME: Can this be optional? */
+		4.0f,
+		(FAudioVoiceCallback*) &pooled->callback,
+		&sends,
+		NULL
+	);
+	engine->activeVoiceCount += 1;
+	engine->stats.VoicesCreated += 1;
+	return pooled;
+}
+
+void FACT_INTERNAL_ReleaseVoice(
+	FACTAudioEngine *engine,
+	FACTPooledVoice *pooled
+) {
+	FAudioVoiceSends sends;
+	FAudioSendDescriptor send;
+	FAudioFilterParameters filter;
+
+	engine->activeVoiceCount -= 1;
+	if (	!FACT_INTERNAL_IsPoolable(&pooled->format) ||
+		engine->idleVoiceCount >= engine->maxIdleVoices	)
+	{
+		FAudioVoice_DestroyVoice(pooled->voice);
+		engine->pFree(pooled);
+		engine->stats.VoicesDestroyed += 1;
+		return;
+	}
+
+	/* The Wave stopped and flushed the voice, but a mix may still be in
+	 * one of its callbacks. Those run under bufferLock, so wait for it.
+	 * Any changes still queued, like FACT3DApply's, were for the old Wave.
+	 */
+	FAudio_PlatformLockMutex(pooled->voice->src.bufferLock);
+	pooled->callback.wave = NULL;
+	FAudio_PlatformUnlockMutex(pooled->voice->src.bufferLock);
+	FAudio_OPERATIONSET_ClearAllForVoice(pooled->voice);
+
+	/* Back to how AcquireVoice creates them. This resets the matrix too. */
+	FACT_INTERNAL_GetMasterSends(engine, &sends, &send);
+	FAudioVoice_SetOutputVoices(pooled->voice, &sends);
+	FAudioVoice_SetVolume(pooled->voice, 1.0f, FAUDIO_COMMIT_NOW);
+	FAudioSourceVoice_SetFrequencyRatio(
+		pooled->voice,
+		1.0f,
+		FAUDIO_COMMIT_NOW
+	);
+	filter.Type = FAUDIO_DEFAULT_FILTER_TYPE;
+	filter.Frequency = FAUDIO_DEFAULT_FILTER_FREQUENCY;
+	filter.OneOverQ = FAUDIO_DEFAULT_FILTER_ONEOVERQ;
+	FAudioVoice_SetFilterParameters(
+		pooled->voice,
+		&filter,
+		FAUDIO_COMMIT_NOW
+	);
+
+	pooled->next = engine->idleVoices;
+	engine->idleVoices = pooled;
+	engine->idleVoiceCount += 1;
+}
+
+void FACT_INTERNAL_TrimVoicePool(FACTAudioEngine *engine, uint32_t maxIdle)
+{
+	FACTPooledVoice **link, *pooled, *next;
+	uint32_t i;
+
+	/* Keep the newest ones, they're at the front */
+	link = &engine->idleVoices;
+	for (i = 0; i < maxIdle && *link != NULL; i += 1)
+	{
+		link = &(*link)->next;
+	}
+	pooled = *link;
+	*link = NULL;
+
+	while (pooled != NULL)
+	{
+		next = pooled->next;
+		FAudioVoice_DestroyVoice(pooled->voice);
+		engine->pFree(pooled);
+		engine->idleVoiceCount -= 1;
+		engine->stats.VoicesDestroyed += 1;
+		pooled = next;
+	}
+}
+
+/* Voice Budget Functions */
+
+static inline uint8_t FACT_INTERNAL_CanVirtualize(FACTWave *wave)
+{
+	/* Streams and the WMA/XMA decoders can't pick up from a sample offset */
+	uint32_t tag = wave->parentBank->entries[wave->index].Format.wFormatTag;
+	return wave->stream == NULL && (tag == 0x0 || tag == 0x2);
+}
+
+static inline double FACT_INTERNAL_GetVirtualRate(FACTWave *wave)
+{
+	/* Samples per millisecond, at the pitch the voice would be playing */
+	return (
+		wave->parentBank->entries[wave->index].Format.nSamplesPerSec *
+		FAudio_pow(2.0, wave->pitch / 1200.0) /
+		1000.0
+	);
+}
+
+static uint8_t FACT_INTERNAL_GetWavePriority(FACTWave *wave)
+{
+	/* Same order as maxInstanceBehavior's Replace Lowest Priority */
+	if (wave->parentCue == NULL)
+	{
+		/* Played by the application itself */
+		return 0xFF;
+	}
+	if (wave->parentCue->playingSound != NULL)
+	{
+		return wave->parentCue->playingSound->sound->priority;
+	}
+
+	/* Simple Variations play Waves without a Sound */
+	return 0;
+}
+
+static void FACT_INTERNAL_VirtualizeWave(FACTWave *wave, uint32_t timestamp)
+{
+	FAudioBufferEntry *entry;
+
+	/* The mixer holds bufferLock, so once we have it the voice stays put */
+	FAudioSourceVoice_Stop(wave->voice, 0, FAUDIO_COMMIT_NOW);
+	FAudio_PlatformLockMutex(wave->voice->src.bufferLock);
+	entry = wave->voice->src.bufferList;
+	if (entry == NULL)
+	{
+		/* It just finished, OnStreamEnd takes it from here */
+		FAudio_PlatformUnlockMutex(wave->voice->src.bufferLock);
+		return;
+	}
+	wave->virtualPosition = wave->voice->src.curBufferOffset;
+	wave->virtualEnd = entry->buffer.PlayBegin + entry->buffer.PlayLength;
+	wave->virtualLoopBegin = entry->buffer.LoopBegin;
+	wave->virtualLoopLength = entry->buffer.LoopLength;
+	wave->virtualLoops = entry->buffer.LoopCount;
+	FAudio_PlatformUnlockMutex(wave->voice->src.bufferLock);
+
+	/* Stopped, so this drops the buffer without any callbacks */
+	FAudioSourceVoice_FlushSourceBuffers(wave->voice);
+
+	wave->virtualized = 1;
+	wave->virtualTime = timestamp;
+	wave->parentBank->parentEngine->virtualWaveCount += 1;
+}
+
+static void FACT_INTERNAL_ResumeWave(FACTWave *wave)
+{
+	FAudioBuffer buffer;
+	FACTWaveBankEntry *entry = &wave->parentBank->entries[wave->index];
+
+	buffer.Flags = FAUDIO_END_OF_STREAM;
+	if (wave->transcode != NULL)
+	{
+		buffer.AudioBytes = wave->transcode->bytes;
+		buffer.pAudioData = (uint8_t*) wave->transcode->pcm;
+	}
+	else
+	{
+		buffer.AudioBytes = entry->PlayRegion.dwLength;
+		buffer.pAudioData = FAudio_memptr(
+			wave->parentBank->io,
+			entry->PlayRegion.dwOffset
+		);
+	}
+	buffer.PlayBegin = (uint32_t) wave->virtualPosition;
+	buffer.PlayLength = wave->virtualEnd - buffer.PlayBegin;
+	if (wave->virtualLoops == 0)
+	{
+		buffer.LoopBegin = 0;
+		buffer.LoopLength = 0;
+		buffer.LoopCount = 0;
+	}
+	else
+	{
+		buffer.LoopBegin = wave->virtualLoopBegin;
+		buffer.LoopLength = wave->virtualLoopLength;
+		buffer.LoopCount = wave->virtualLoops;
+	}
+	buffer.pContext = NULL;
+	FAudioSourceVoice_SubmitSourceBuffer(wave->voice, &buffer, NULL);
+	if (!(wave->state & FACT_STATE_PAUSED))
+	{
+		FAudioSourceVoice_Start(wave->voice, 0, 0);
+	}
+
+	wave->virtualized = 0;
+	wave->parentBank->parentEngine->virtualWaveCount -= 1;
+}
+
+void FACT_INTERNAL_AdvanceVirtualWave(FACTWave *wave, uint32_t timestamp)
+{
+	double loopEnd, offset;
+	uint32_t elapsed = timestamp - wave->virtualTime;
+
+	wave->virtualTime = timestamp;
+	if (wave->state & FACT_STATE_PAUSED)
+	{
+		return;
+	}
+
+	wave->virtualPosition += elapsed * FACT_INTERNAL_GetVirtualRate(wave);
+
+	/* Go back around the loop the way the voice would have */
+	loopEnd = (double) wave->virtualLoopBegin + wave->virtualLoopLength;
+	while (wave->virtualLoops > 0 && wave->virtualPosition >= loopEnd)
+	{
+		if (wave->virtualLoops == FAUDIO_LOOP_INFINITE)
 		{
-			return &engine->rpcs[i];
+			offset = wave->virtualPosition - wave->virtualLoopBegin;
+			wave->virtualPosition = wave->virtualLoopBegin + offset - (
+				wave->virtualLoopLength *
+				FAudio_floor(offset / wave->virtualLoopLength)
+			);
+			break;
+		}
+		wave->virtualPosition -= wave->virtualLoopLength;
+		wave->virtualLoops -= 1;
+	}
+
+	if (wave->virtualPosition >= wave->virtualEnd)
+	{
+		wave->virtualized = 0;
+		wave->parentBank->parentEngine->virtualWaveCount -= 1;
+		FACT_INTERNAL_FinishWave(wave);
+	}
+}
+
+static int FACT_INTERNAL_CompareBudgetEntries(const void *a, const void *b)
+{
+	const FACTBudgetEntry *x = (const FACTBudgetEntry*) a;
+	const FACTBudgetEntry *y = (const FACTBudgetEntry*) b;
+
+	/* Highest priority first, then the loudest, then whoever is audible */
+	if (x->priority != y->priority)
+	{
+		return (x->priority > y->priority) ? -1 : 1;
+	}
+	if (x->volume != y->volume)
+	{
+		return (x->volume > y->volume) ? -1 : 1;
+	}
+	return (int) x->wave->virtualized - (int) y->wave->virtualized;
+}
+
+void FACT_INTERNAL_AdvanceVirtualWaves(
+	FACTAudioEngine *engine,
+	uint32_t timestamp
+) {
+	LinkedList *wbList, *waveList;
+	FACTWave *wave;
+
+	if (engine->virtualWaveCount == 0)
+	{
+		return;
+	}
+
+	for (wbList = engine->wbList; wbList != NULL; wbList = wbList->next)
+	{
+		waveList = ((FACTWaveBank*) wbList->entry)->waveList;
+		for (; waveList != NULL; waveList = waveList->next)
+		{
+			wave = (FACTWave*) waveList->entry;
+			if (wave->virtualized)
+			{
+				FACT_INTERNAL_AdvanceVirtualWave(wave, timestamp);
+			}
+		}
+	}
+}
+
+uint32_t FACT_INTERNAL_UpdateVoiceBudget(
+	FACTAudioEngine *engine,
+	uint32_t timestamp,
+	uint32_t maxWait
+) {
+	LinkedList *wbList, *waveList;
+	FACTWave *wave;
+	uint32_t i, count, audible, level;
+	double remaining;
+
+	/* The mixer's governor may want fewer Waves than the budget does */
+	FAudio_GetGovernorLevelEXT(engine->audio, &level);
+	if (	engine->maxAudibleWaves == 0 &&
+		engine->virtualWaveCount == 0 &&
+		level < FAUDIO_GOVERNOR_VIRTUALIZE_EXT	)
+	{
+		return maxWait;
+	}
+
+	/* Everything that's playing, or would be without the budget */
+	count = 0;
+	audible = engine->maxAudibleWaves;
+	for (wbList = engine->wbList; wbList != NULL; wbList = wbList->next)
+	{
+		waveList = ((FACTWaveBank*) wbList->entry)->waveList;
+		for (; waveList != NULL; waveList = waveList->next)
+		{
+			wave = (FACTWave*) waveList->entry;
+			if (	!(wave->state & FACT_STATE_PLAYING) ||
+				(wave->state & (FACT_STATE_PAUSED | FACT_STATE_STOPPED))	)
+			{
+				continue;
+			}
+			if (!FACT_INTERNAL_CanVirtualize(wave))
+			{
+				/* These always play, but they still count */
+				if (audible > 0)
+				{
+					audible -= 1;
+				}
+				continue;
+			}
+
+			if (count == engine->budgetCapacity)
+			{
+				engine->budgetCapacity = FAudio_max(
+					engine->budgetCapacity * 2,
+					16
+				);
+				engine->budget = (FACTBudgetEntry*) engine->pRealloc(
+					engine->budget,
+					sizeof(FACTBudgetEntry) * engine->budgetCapacity
+				);
+			}
+			engine->budget[count].wave = wave;
+			engine->budget[count].priority = FACT_INTERNAL_GetWavePriority(wave);
+			engine->budget[count].volume = wave->volume;
+			count += 1;
+		}
+	}
+	if (engine->maxAudibleWaves == 0)
+	{
+		audible = count;
+	}
+	if (level >= FAUDIO_GOVERNOR_VIRTUALIZE_EXT)
+	{
+		audible = FAudio_min(
+			audible,
+			count - (count + FACT_GOVERNOR_SHED_DIVISOR - 1) / FACT_GOVERNOR_SHED_DIVISOR
+		);
+	}
+
+	FAudio_qsort(
+		engine->budget,
+		count,
+		sizeof(FACTBudgetEntry),
+		FACT_INTERNAL_CompareBudgetEntries
+	);
+	for (i = 0; i < count; i += 1)
+	{
+		wave = engine->budget[i].wave;
+		if (i < audible)
+		{
+			if (wave->virtualized)
+			{
+				FACT_INTERNAL_ResumeWave(wave);
+			}
+		}
+		else if (!wave->virtualized)
+		{
+			FACT_INTERNAL_VirtualizeWave(wave, timestamp);
+		}
+	}
+
+	/* Nothing plays them out, so wake up in time to finish them */
+	for (i = audible; i < count; i += 1)
+	{
+		wave = engine->budget[i].wave;
+		if (!wave->virtualized || wave->virtualLoops == FAUDIO_LOOP_INFINITE)
+		{
+			continue;
+		}
+		remaining = (
+			wave->virtualEnd - wave->virtualPosition +
+			(double) wave->virtualLoops * wave->virtualLoopLength
+		);
+		maxWait = FAudio_min(
+			maxWait,
+			(uint32_t) (remaining / FACT_INTERNAL_GetVirtualRate(wave)) + 1
+		);
+	}
+
+	/* Waves played without a Cue don't wake us when they end, so check
+	 * for room to resume the virtual ones every so often
+	 */
+	if (engine->virtualWaveCount > 0)
+	{
+		maxWait = FAudio_min(maxWait, FACT_API_PLAYING_MS);
+	}
+
+	return maxWait;
+}
+
+/* Streaming Functions */
+
+static uint32_t FACT_INTERNAL_GetStreamBufferSize(
+	FACTWave *wave,
+	const FAudioADPCMWaveFormat *format
+) {
+	FACTWaveBank *wb = wave->parentBank;
+	uint32_t size, unit, a, b, t;
+
+	if (format->wfx.wFormatTag == FAUDIO_FORMAT_PCM)
+	{
+		size = (
+			format->wfx.nSamplesPerSec *
+			format->wfx.nChannels *
+			(format->wfx.wBitsPerSample / 8)
+		);
+	}
+	else if (format->wfx.wFormatTag == FAUDIO_FORMAT_MSADPCM)
+	{
+		size = (
+			format->wfx.nSamplesPerSec /
+			format->wSamplesPerBlock *
+			format->wfx.nBlockAlign
+		);
+	}
+	else if (	wb->seekTables != NULL &&
+			wb->seekTables[wave->index].entryCount > 0	)
+	{
+		/* xWMA/XMA2, in whole packets. Each chunk is submitted with the
+		 * part of the seek table that covers its packets.
+		 */
+		size = format->wfx.nAvgBytesPerSec;
+	}
+	else
+	{
+		/* No seek table, so load the whole thing */
+		return wb->entries[wave->index].PlayRegion.dwLength;
+	}
+	if (wb->packetSize > 0)
+	{
+		size = wb->packetSize * FACT_STREAM_SECTOR_SIZE;
+	}
+
+	/* The voice needs whole blocks. Entries start on the bank's alignment,
+	 * so if a whole number of blocks also fills a whole number of aligned
+	 * units, every read stays aligned.
+	 */
+	unit = format->wfx.nBlockAlign;
+	if (wb->alignment > 0)
+	{
+		a = unit;
+		b = wb->alignment;
+		while (b != 0)
+		{
+			t = a % b;
+			a = b;
+			b = t;
+		}
+		if (unit / a * wb->alignment <= size)
+		{
+			unit = unit / a * wb->alignment;
+		}
+	}
+	size -= size % unit;
+	return FAudio_max(size, unit);
+}
+
+static void FACT_INTERNAL_GetStreamPackets(
+	FACTStream *stream,
+	FACTStreamBuffer *buffer
+) {
+	FACTSeekTable *table;
+	uint32_t first, base, i;
+
+	/* The table holds the decoded size at the end of each packet, from
+	 * the start of the Wave. The voice wants it from the start of the
+	 * buffer.
+	 */
+	table = &stream->wave->parentBank->seekTables[stream->wave->index];
+	first = (buffer->offset - stream->begin) / stream->packetAlign;
+	buffer->packetCount = FAudio_min(
+		(buffer->size + stream->packetAlign - 1) / stream->packetAlign,
+		table->entryCount - first
+	);
+	base = (first > 0) ? table->entries[first - 1] : 0;
+	for (i = 0; i < buffer->packetCount; i += 1)
+	{
+		buffer->decodedBytes[i] = table->entries[first + i] - base;
+	}
+}
+
+/* Streams are read in whole blocks: frames for PCM, ADPCM blocks and xWMA or
+ * XMA2 packets. These offsets are from the start of the PlayRegion.
+ */
+static uint32_t FACT_INTERNAL_StreamBlockSize(FACTStream *stream)
+{
+	if (stream->packetAlign > 0)
+	{
+		return stream->packetAlign;
+	}
+	if (	stream->format.wfx.wFormatTag == FAUDIO_FORMAT_PCM ||
+		stream->format.wfx.wFormatTag == FAUDIO_FORMAT_MSADPCM	)
+	{
+		return stream->format.wfx.nBlockAlign;
+	}
+
+	/* No seek table, so it's all one piece */
+	return stream->length;
+}
+
+/* The first sample of the block at offset */
+static uint32_t FACT_INTERNAL_StreamSampleAt(
+	FACTStream *stream,
+	uint32_t offset
+) {
+	FACTSeekTable *table;
+	uint32_t packet;
+
+	if (offset >= stream->length)
+	{
+		return stream->duration;
+	}
+	if (stream->packetAlign > 0)
+	{
+		table = &stream->wave->parentBank->seekTables[stream->wave->index];
+		packet = offset / stream->packetAlign;
+		if (packet == 0)
+		{
+			return 0;
+		}
+		return table->entries[packet - 1] / (
+			stream->format.wfx.nChannels *
+			(stream->format.wfx.wBitsPerSample / 8)
+		);
+	}
+	if (stream->format.wfx.wFormatTag == FAUDIO_FORMAT_PCM)
+	{
+		return offset / stream->format.wfx.nBlockAlign;
+	}
+	if (stream->format.wfx.wFormatTag == FAUDIO_FORMAT_MSADPCM)
+	{
+		return (
+			offset /
+			stream->format.wfx.nBlockAlign *
+			stream->format.wSamplesPerBlock
+		);
+	}
+	return 0;
+}
+
+/* The offset of the block that holds sample */
+static uint32_t FACT_INTERNAL_StreamOffsetOf(
+	FACTStream *stream,
+	uint32_t sample
+) {
+	FACTSeekTable *table;
+	uint32_t target, lo, hi, mid;
+
+	if (stream->packetAlign > 0)
+	{
+		/* First packet that decodes past the sample */
+		table = &stream->wave->parentBank->seekTables[stream->wave->index];
+		target = sample * (
+			stream->format.wfx.nChannels *
+			(stream->format.wfx.wBitsPerSample / 8)
+		);
+		lo = 0;
+		hi = table->entryCount - 1;
+		while (lo < hi)
+		{
+			mid = (lo + hi) / 2;
+			if (table->entries[mid] > target)
+			{
+				hi = mid;
+			}
+			else
+			{
+				lo = mid + 1;
+			}
+		}
+		return lo * stream->packetAlign;
+	}
+	if (stream->format.wfx.wFormatTag == FAUDIO_FORMAT_PCM)
+	{
+		return sample * stream->format.wfx.nBlockAlign;
+	}
+	if (stream->format.wfx.wFormatTag == FAUDIO_FORMAT_MSADPCM)
+	{
+		return (
+			sample /
+			stream->format.wSamplesPerBlock *
+			stream->format.wfx.nBlockAlign
+		);
+	}
+	return 0;
+}
+
+/* Call with streamLock, or before the stream is linked */
+static FACTStreamBuffer* FACT_INTERNAL_NextStreamBuffer(FACTStream *stream)
+{
+	FACTStreamBuffer *buffer = &stream->buffers[stream->nextRead];
+	uint32_t passOffset, chunkSample, nextSample;
+
+	if (	buffer->state != FACT_STREAM_BUFFER_FREE ||
+		stream->done ||
+		(stream->wave->state & FACT_STATE_STOPPED)	)
+	{
+		return NULL;
+	}
+
+	/* Read up to the end of the block that holds the pass's last sample */
+	passOffset = FAudio_min(
+		stream->length,
+		FACT_INTERNAL_StreamOffsetOf(stream, stream->passEnd - 1) +
+			FACT_INTERNAL_StreamBlockSize(stream)
+	);
+	buffer->offset = stream->begin + stream->readOffset;
+	buffer->size = FAudio_min(
+		stream->bufferSize,
+		passOffset - stream->readOffset
+	);
+	buffer->flags = 0;
+	if (stream->packetAlign > 0)
+	{
+		FACT_INTERNAL_GetStreamPackets(stream, buffer);
+	}
+
+	/* Either end can land in the middle of a packet */
+	chunkSample = FACT_INTERNAL_StreamSampleAt(stream, stream->readOffset);
+	stream->readOffset += buffer->size;
+	if (stream->readOffset >= passOffset)
+	{
+		nextSample = stream->passEnd;
+	}
+	else
+	{
+		nextSample = FACT_INTERNAL_StreamSampleAt(
+			stream,
+			stream->readOffset
+		);
+	}
+	buffer->playBegin = stream->readSample - chunkSample;
+	buffer->playLength = nextSample - stream->readSample;
+	stream->readSample = nextSample;
+
+	if (stream->readSample >= stream->passEnd)
+	{
+		if (stream->loopCount > 0)
+		{
+			/* Back to the loop start. It's queued right behind the
+			 * loop end, so the voice never waits for it.
+			 */
+			if (stream->loopCount != 255)
+			{
+				stream->loopCount -= 1;
+			}
+			stream->readSample = stream->loopBegin;
+			stream->readOffset = FACT_INTERNAL_StreamOffsetOf(
+				stream,
+				stream->loopBegin
+			);
+			stream->passEnd = stream->loopEnd;
+		}
+		else if (stream->passEnd < stream->duration)
+		{
+			/* Done looping, play out whatever comes after the loop */
+			stream->readOffset = FACT_INTERNAL_StreamOffsetOf(
+				stream,
+				stream->readSample
+			);
+			stream->passEnd = stream->duration;
+		}
+		else
+		{
+			buffer->flags = FAUDIO_END_OF_STREAM;
+			stream->done = 1;
+		}
+	}
+
+	buffer->state = FACT_STREAM_BUFFER_READING;
+	stream->nextRead = (stream->nextRead + 1) % stream->bufferCount;
+	return buffer;
+}
+
+/* Call without streamLock, this is the part that blocks. Returns how long
+ * the read took, in microseconds.
+ */
+static uint32_t FACT_INTERNAL_ReadStreamBuffer(
+	FACTStream *stream,
+	FACTStreamBuffer *buffer
+) {
+	FACTWaveBank *wb = stream->wave->parentBank;
+	FACTOverlapped ovlp;
+	uint32_t read;
+	uint64_t start = FAudio_timeus();
+
+	ovlp.Internal = NULL;
+	ovlp.InternalHigh = NULL;
+	ovlp.Offset = buffer->offset;
+	ovlp.OffsetHigh = 0; /* I sure hope so... */
+	ovlp.hEvent = NULL;
+	wb->parentEngine->pReadFile(
+		wb->io,
+		buffer->data,
+		buffer->size,
+		NULL,
+		&ovlp
+	);
+	wb->parentEngine->pGetOverlappedResult(
+		wb->io,
+		&ovlp,
+		&read,
+		1
+	);
+	return (uint32_t) (FAudio_timeus() - start);
+}
+
+/* Call with streamLock */
+static void FACT_INTERNAL_CountStreamRead(
+	FACTWaveBank *wb,
+	FACTStreamBuffer *buffer,
+	uint32_t readTime
+) {
+	wb->stats.BytesRead += buffer->size;
+	wb->stats.ReadCount += 1;
+	wb->stats.ReadMicroseconds += readTime;
+	wb->stats.LastReadMicroseconds = readTime;
+	wb->stats.MaxReadMicroseconds = FAudio_max(
+		wb->stats.MaxReadMicroseconds,
+		readTime
+	);
+}
+
+/* Call with the voice's bufferLock, then streamLock */
+static void FACT_INTERNAL_SubmitStreamBuffers(FACTStream *stream)
+{
+	FAudioBuffer buffer;
+	FAudioBufferWMA bufferWMA;
+	FACTStreamBuffer *next;
+	FACTWave *wave = stream->wave;
+	FACTWaveBankEntry *entry = &wave->parentBank->entries[wave->index];
+
+	/* Unused properties */
+	buffer.LoopBegin = 0;
+	buffer.LoopLength = 0;
+	buffer.LoopCount = 0;
+
+	next = &stream->buffers[stream->nextSubmit];
+	while (	next->state == FACT_STREAM_BUFFER_READY &&
+		stream->linked &&
+		!(wave->state & FACT_STATE_STOPPED)	)
+	{
+		buffer.Flags = next->flags;
+		buffer.AudioBytes = next->size;
+		buffer.pAudioData = next->data;
+		buffer.pContext = next;
+		if (next->decodedBytes != NULL)
+		{
+			buffer.PlayBegin = next->playBegin;
+			buffer.PlayLength = next->playLength;
+			bufferWMA.pDecodedPacketCumulativeBytes = next->decodedBytes;
+			bufferWMA.PacketCount = next->packetCount;
+			FAudioSourceVoice_SubmitSourceBuffer(
+				wave->voice,
+				&buffer,
+				&bufferWMA
+			);
+		}
+		else if (	entry->Format.wFormatTag == 0x1 ||
+				entry->Format.wFormatTag == 0x3	)
+		{
+			buffer.PlayBegin = 0;
+			buffer.PlayLength = 0;
+			bufferWMA.pDecodedPacketCumulativeBytes =
+				wave->parentBank->seekTables[wave->index].entries;
+			bufferWMA.PacketCount =
+				wave->parentBank->seekTables[wave->index].entryCount;
+			FAudioSourceVoice_SubmitSourceBuffer(
+				wave->voice,
+				&buffer,
+				&bufferWMA
+			);
+		}
+		else
+		{
+			buffer.PlayBegin = 0;
+			buffer.PlayLength = 0;
+			FAudioSourceVoice_SubmitSourceBuffer(
+				wave->voice,
+				&buffer,
+				NULL
+			);
+		}
+		next->state = FACT_STREAM_BUFFER_QUEUED;
+		stream->nextSubmit = (stream->nextSubmit + 1) % stream->bufferCount;
+		next = &stream->buffers[stream->nextSubmit];
+	}
+}
+
+/* Transcode Functions */
+
+static uint8_t FACT_INTERNAL_IsTranscodeCategory(
+	uint16_t category,
+	const FACTTranscodeParametersEXT *params
+) {
+	uint16_t i;
+	for (i = 0; i < params->categoryCount; i += 1)
+	{
+		if (params->categories[i] == category)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void FACT_INTERNAL_SelectTranscode(
+	FACTWaveBank *wb,
+	uint16_t index
+) {
+	if (	index < wb->entryCount &&
+		wb->entries[index].Format.wFormatTag == 0x2	)
+	{
+		wb->transcodes[index].selected = 1;
+	}
+}
+
+/* Every Wave a Sound of one of the categories plays from this WaveBank. Only
+ * the SoundBanks loaded so far are known, and lazy ones only know the Sounds
+ * parsed so far, so neither is looked at.
+ */
+static void FACT_INTERNAL_SelectTranscodeCategories(
+	FACTWaveBank *wb,
+	const FACTTranscodeParametersEXT *params
+) {
+	LinkedList *list;
+	FACTSoundBank *sb;
+	FACTSound *sound;
+	FACTEvent *evt;
+	uint16_t i, j, k, l;
+
+	for (list = wb->parentEngine->sbList; list != NULL; list = list->next)
+	{
+		sb = (FACTSoundBank*) list->entry;
+		if (sb->lazy)
+		{
+			continue;
+		}
+		for (i = 0; i < sb->soundCount; i += 1)
+		{
+			sound = &sb->sounds[i];
+			if (!FACT_INTERNAL_IsTranscodeCategory(sound->category, params))
+			{
+				continue;
+			}
+			for (j = 0; j < sound->trackCount; j += 1)
+			{
+				for (k = 0; k < sound->tracks[j].eventCount; k += 1)
+				{
+					evt = &sound->tracks[j].events[k];
+					if (	evt->type != FACTEVENT_PLAYWAVE &&
+						evt->type != FACTEVENT_PLAYWAVETRACKVARIATION &&
+						evt->type != FACTEVENT_PLAYWAVEEFFECTVARIATION &&
+						evt->type != FACTEVENT_PLAYWAVETRACKEFFECTVARIATION	)
+					{
+						continue;
+					}
+					if (!evt->wave.isComplex)
+					{
+						if (FAudio_strcmp(
+							sb->wavebankNames[evt->wave.simple.wavebank],
+							wb->name
+						) == 0) {
+							FACT_INTERNAL_SelectTranscode(
+								wb,
+								evt->wave.simple.track
+							);
+						}
+						continue;
+					}
+					for (l = 0; l < evt->wave.complex.trackCount; l += 1)
+					{
+						if (FAudio_strcmp(
+							sb->wavebankNames[evt->wave.complex.wavebanks[l]],
+							wb->name
+						) == 0) {
+							FACT_INTERNAL_SelectTranscode(
+								wb,
+								evt->wave.complex.tracks[l]
+							);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void FACT_INTERNAL_InitTranscodes(
+	FACTWaveBank *wb,
+	const FACTTranscodeParametersEXT *params
+) {
+	FACTAudioEngine *engine = wb->parentEngine;
+	FACTWaveBankEntry *entry;
+	FACTTranscode *transcode;
+	uint32_t i, align, frames;
+
+	wb->transcodes = (FACTTranscode*) FACT_INTERNAL_ArenaAlloc(
+		&wb->arena,
+		sizeof(FACTTranscode) * wb->entryCount,
+		engine->pMalloc
+	);
+	FAudio_zero(wb->transcodes, sizeof(FACTTranscode) * wb->entryCount);
+	wb->transcodeLimit = params->maxBytes;
+
+	if (params->categoryCount == 0)
+	{
+		for (i = 0; i < wb->entryCount; i += 1)
+		{
+			FACT_INTERNAL_SelectTranscode(wb, (uint16_t) i);
+		}
+	}
+	else
+	{
+		FACT_INTERNAL_SelectTranscodeCategories(wb, params);
+	}
+
+	/* Queue them all up front, in bank order. None of these has been
+	 * used yet, so none evicts another once the limit is reached.
+	 */
+	FACT_INTERNAL_StartStreamThread(engine);
+	FAudio_PlatformLockMutex(engine->streamLock);
+	for (i = 0; i < wb->entryCount; i += 1)
+	{
+		transcode = &wb->transcodes[i];
+		if (!transcode->selected)
+		{
+			continue;
+		}
+		entry = &wb->entries[i];
+		align = (entry->Format.wBlockAlign + 22) * entry->Format.nChannels;
+		frames = ((align / entry->Format.nChannels) - 6) * 2;
+		transcode->blockCount = entry->PlayRegion.dwLength / align;
+		transcode->bytes = (
+			transcode->blockCount *
+			frames *
+			entry->Format.nChannels *
+			sizeof(int16_t)
+		);
+		transcode->state = FACT_TRANSCODE_QUEUED;
+		wb->transcodePending += 1;
+	}
+	wb->transcodeNext = engine->transcodeBanks;
+	engine->transcodeBanks = wb;
+	wb->transcodeLinked = 1;
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+	FACT_INTERNAL_WakeStreamThread(engine);
+}
+
+/* Evicts the least recently used PCM that isn't playing, but only PCM used
+ * before the entry that needs the room. Returns 0 if it still doesn't fit.
+ */
+static uint8_t FACT_INTERNAL_MakeTranscodeRoom(
+	FACTWaveBank *wb,
+	FACTTranscode *transcode
+) {
+	FACTTranscode *oldest, *other;
+	uint32_t i;
+
+	if (wb->transcodeLimit == 0)
+	{
+		return 1;
+	}
+	while (wb->transcodeBytes + transcode->bytes > wb->transcodeLimit)
+	{
+		oldest = NULL;
+		for (i = 0; i < wb->entryCount; i += 1)
+		{
+			other = &wb->transcodes[i];
+			if (	other->state != FACT_TRANSCODE_READY ||
+				other->refs > 0 ||
+				(int32_t) (other->lastUsed - transcode->lastUsed) >= 0	)
+			{
+				continue;
+			}
+			if (	oldest == NULL ||
+				(int32_t) (other->lastUsed - oldest->lastUsed) < 0	)
+			{
+				oldest = other;
+			}
+		}
+		if (oldest == NULL)
+		{
+			return 0;
+		}
+		wb->parentEngine->pFree(oldest->pcm);
+		oldest->pcm = NULL;
+		oldest->state = FACT_TRANSCODE_NONE;
+		wb->transcodeBytes -= oldest->bytes;
+	}
+	return 1;
+}
+
+/* Decodes up to FACT_TRANSCODE_STEP_BLOCKS of the first Wave waiting, so a
+ * stream that needs a read waits for at most that. Called with streamLock
+ * held, returns with it released.
+ */
+static uint32_t FACT_INTERNAL_TranscodeStep(FACTAudioEngine *engine)
+{
+	FACTWaveBank *wb;
+	FACTWaveBankEntry *entry;
+	FACTTranscode *transcode;
+	uint32_t i, first, count, frames;
+	uint16_t align;
+	const uint8_t *data;
+
+	/* Find the first Wave that's waiting */
+	transcode = NULL;
+	for (wb = engine->transcodeBanks; wb != NULL; wb = wb->transcodeNext)
+	{
+		if (wb->transcodePending == 0)
+		{
+			continue;
+		}
+		for (i = 0; i < wb->entryCount; i += 1)
+		{
+			if (	wb->transcodes[i].state == FACT_TRANSCODE_QUEUED ||
+				wb->transcodes[i].state == FACT_TRANSCODE_BUSY	)
+			{
+				transcode = &wb->transcodes[i];
+				break;
+			}
+		}
+		if (transcode != NULL)
+		{
+			break;
+		}
+	}
+	if (transcode == NULL)
+	{
+		FAudio_PlatformUnlockMutex(engine->streamLock);
+		return FACT_API_WAIT_FOREVER;
+	}
+
+	if (transcode->state == FACT_TRANSCODE_QUEUED)
+	{
+		if (!FACT_INTERNAL_MakeTranscodeRoom(wb, transcode))
+		{
+			/* It keeps playing as ADPCM until it's used again */
+			transcode->state = FACT_TRANSCODE_NONE;
+			wb->transcodePending -= 1;
+			FAudio_PlatformUnlockMutex(engine->streamLock);
+			return 0;
+		}
+		transcode->pcm = (int16_t*) engine->pMalloc(transcode->bytes);
+		transcode->nextBlock = 0;
+		transcode->state = FACT_TRANSCODE_BUSY;
+		wb->transcodeBytes += transcode->bytes;
+	}
+
+	/* FACTWaveBank_Destroy waits for this, so the data stays around */
+	entry = &wb->entries[transcode - wb->transcodes];
+	align = (entry->Format.wBlockAlign + 22) * entry->Format.nChannels;
+	frames = ((align / entry->Format.nChannels) - 6) * 2;
+	first = transcode->nextBlock;
+	count = FAudio_min(
+		FACT_TRANSCODE_STEP_BLOCKS,
+		transcode->blockCount - first
+	);
+	wb->transcodeBusy = 1;
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+
+	data = (const uint8_t*) FAudio_memptr(
+		wb->io,
+		entry->PlayRegion.dwOffset
+	);
+	FAudio_INTERNAL_TranscodeMSADPCM(
+		data + (first * align),
+		count,
+		align,
+		entry->Format.nChannels,
+		transcode->pcm + (first * frames * entry->Format.nChannels)
+	);
+
+	FAudio_PlatformLockMutex(engine->streamLock);
+	transcode->nextBlock += count;
+	if (transcode->nextBlock == transcode->blockCount)
+	{
+		transcode->state = FACT_TRANSCODE_READY;
+		wb->transcodePending -= 1;
+	}
+	wb->transcodeBusy = 0;
+	if (wb->transcodeWaiting)
+	{
+		wb->transcodeWaiting = 0;
+		FAudio_PlatformPostSemaphore(engine->streamDone);
+	}
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+	return 0;
+}
+
+FACTTranscode* FACT_INTERNAL_UseTranscode(FACTWaveBank *wb, uint16_t index)
+{
+	FACTAudioEngine *engine = wb->parentEngine;
+	FACTTranscode *transcode = &wb->transcodes[index];
+	uint8_t wake = 0;
+
+	FAudio_PlatformLockMutex(engine->streamLock);
+	wb->transcodeClock += 1;
+	transcode->lastUsed = wb->transcodeClock;
+	if (transcode->state == FACT_TRANSCODE_READY)
+	{
+		transcode->refs += 1;
+	}
+	else
+	{
+		/* Evicted or never fit, try again for next time */
+		if (transcode->state == FACT_TRANSCODE_NONE)
+		{
+			transcode->state = FACT_TRANSCODE_QUEUED;
+			wb->transcodePending += 1;
+			wake = 1;
+		}
+		transcode = NULL;
+	}
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+
+	if (wake)
+	{
+		FACT_INTERNAL_WakeStreamThread(engine);
+	}
+	return transcode;
+}
+
+void FACT_INTERNAL_ReleaseTranscode(FACTWaveBank *wb, FACTTranscode *transcode)
+{
+	FAudio_PlatformLockMutex(wb->parentEngine->streamLock);
+	transcode->refs -= 1;
+	FAudio_PlatformUnlockMutex(wb->parentEngine->streamLock);
+}
+
+void FACT_INTERNAL_DestroyTranscodes(FACTWaveBank *wb)
+{
+	FACTAudioEngine *engine = wb->parentEngine;
+	FACTWaveBank **link;
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(engine->streamLock);
+	if (wb->transcodeLinked)
+	{
+		link = &engine->transcodeBanks;
+		while (*link != wb)
+		{
+			link = &(*link)->transcodeNext;
+		}
+		*link = wb->transcodeNext;
+		wb->transcodeLinked = 0;
+	}
+	while (wb->transcodeBusy)
+	{
+		wb->transcodeWaiting = 1;
+		FAudio_PlatformUnlockMutex(engine->streamLock);
+		FAudio_PlatformWaitSemaphore(engine->streamDone);
+		FAudio_PlatformLockMutex(engine->streamLock);
+	}
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+
+	/* Every Wave is gone, so nothing plays any of it anymore */
+	for (i = 0; i < wb->entryCount; i += 1)
+	{
+		if (wb->transcodes[i].pcm != NULL)
+		{
+			engine->pFree(wb->transcodes[i].pcm);
+		}
+	}
+	wb->transcodes = NULL;
+	wb->transcodeBytes = 0;
+}
+
+/* Reads one buffer, for the first stream that has one free. Returns 0 to be
+ * called again right away, FACT_API_WAIT_FOREVER if there was nothing to read.
+ */
+static uint32_t FACT_INTERNAL_StreamStep(void* enginePtr)
+{
+	FACTAudioEngine *engine = (FACTAudioEngine*) enginePtr;
+	FACTStream *stream, **link;
+	FACTStreamBuffer *buffer;
+	FAudioMutex bufferLock;
+	uint32_t readTime;
+
+	FAudio_PlatformLockMutex(engine->streamLock);
+	if (engine->streamQuit)
+	{
+		FAudio_PlatformUnlockMutex(engine->streamLock);
+		return FACT_API_WAIT_FOREVER;
+	}
+
+	/* Find the first stream with a free buffer */
+	buffer = NULL;
+	for (link = &engine->streams; *link != NULL; link = &(*link)->next)
+	{
+		buffer = FACT_INTERNAL_NextStreamBuffer(*link);
+		if (buffer != NULL)
+		{
+			break;
+		}
+	}
+	if (buffer == NULL)
+	{
+		/* Nothing to read, so there's time to transcode */
+		return FACT_INTERNAL_TranscodeStep(engine);
+	}
+
+	/* Move it to the back, so that one stream can't hog the disk */
+	stream = *link;
+	*link = stream->next;
+	while (*link != NULL)
+	{
+		link = &(*link)->next;
+	}
+	*link = stream;
+	stream->next = NULL;
+
+	/* FACT_INTERNAL_DestroyStream waits for this, so the Wave and its
+	 * voice stay around until we're done with them.
+	 */
+	stream->busy = 1;
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+	readTime = FACT_INTERNAL_ReadStreamBuffer(stream, buffer);
+
+	/* The voice callbacks run with bufferLock held, so take it first */
+	bufferLock = stream->wave->voice->src.bufferLock;
+	FAudio_PlatformLockMutex(bufferLock);
+	FAudio_PlatformLockMutex(engine->streamLock);
+	FACT_INTERNAL_CountStreamRead(
+		stream->wave->parentBank,
+		buffer,
+		readTime
+	);
+	buffer->state = FACT_STREAM_BUFFER_READY;
+	FACT_INTERNAL_SubmitStreamBuffers(stream);
+	stream->busy = 0;
+	if (stream->waiting)
+	{
+		stream->waiting = 0;
+		FAudio_PlatformPostSemaphore(engine->streamDone);
+	}
+	FAudio_PlatformUnlockMutex(bufferLock);
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+	return 0;
+}
+
+static int32_t FACT_INTERNAL_StreamThread(void* enginePtr)
+{
+	FACTAudioEngine *engine = (FACTAudioEngine*) enginePtr;
+	FAudioThreadScheduler scheduler;
+	uint8_t quit;
+
+	FAudio_zero(&scheduler, sizeof(scheduler));
+	while (1)
+	{
+		FAudio_INTERNAL_ApplyThreadSchedule(
+			&engine->threadSchedules[FACT_THREAD_STREAM_EXT],
+			&scheduler,
+			FAUDIO_THREAD_PRIORITY_NORMAL
+		);
+		if (FACT_INTERNAL_StreamStep(engine) == 0)
+		{
+			continue;
+		}
+
+		FAudio_PlatformLockMutex(engine->streamLock);
+		quit = engine->streamQuit;
+		FAudio_PlatformUnlockMutex(engine->streamLock);
+		if (quit)
+		{
+			break;
+		}
+		FAudio_PlatformWaitSemaphore(engine->streamWake);
+	}
+
+	return 0;
+}
+
+FACTStream* FACT_INTERNAL_CreateStream(
+	FACTWave *wave,
+	const FAudioADPCMWaveFormat *format
+) {
+	FACTAudioEngine *engine = wave->parentBank->parentEngine;
+	FACTWaveBankEntry *entry = &wave->parentBank->entries[wave->index];
+	FACTStream *stream;
+	FACTStreamBuffer *buffer;
+	uint32_t count, unit, readTime;
+	uint8_t i;
+
+	stream = (FACTStream*) engine->pMalloc(sizeof(FACTStream));
+	FAudio_zero(stream, sizeof(FACTStream));
+	stream->wave = wave;
+	stream->begin = entry->PlayRegion.dwOffset;
+	stream->length = entry->PlayRegion.dwLength;
+	stream->duration = entry->Duration;
+	stream->loopCount = wave->loopCount;
+	FAudio_memcpy(&stream->format, format, sizeof(FAudioADPCMWaveFormat));
+	stream->bufferSize = FACT_INTERNAL_GetStreamBufferSize(wave, format);
+	if (	format->wfx.wFormatTag != FAUDIO_FORMAT_PCM &&
+		format->wfx.wFormatTag != FAUDIO_FORMAT_MSADPCM &&
+		wave->parentBank->seekTables != NULL &&
+		wave->parentBank->seekTables[wave->index].entryCount > 0	)
+	{
+		stream->packetAlign = format->wfx.nBlockAlign;
+
+		/* Packets past the end of the seek table can't be decoded */
+		stream->length = FAudio_min(
+			stream->length,
+			wave->parentBank->seekTables[wave->index].entryCount *
+				stream->packetAlign
+		);
+	}
+
+	/* The loop region is in samples, no region loops the whole Wave */
+	stream->loopBegin = entry->LoopRegion.dwStartSample;
+	stream->loopEnd = stream->loopBegin + entry->LoopRegion.dwTotalSamples;
+	if (	entry->LoopRegion.dwTotalSamples == 0 ||
+		stream->loopEnd > stream->duration	)
+	{
+		stream->loopEnd = stream->duration;
+	}
+	if (stream->loopBegin >= stream->loopEnd)
+	{
+		stream->loopBegin = 0;
+	}
+	if (format->wfx.wFormatTag == FAUDIO_FORMAT_MSADPCM)
+	{
+		/* Voices start and stop ADPCM buffers on whole blocks */
+		stream->loopBegin -= stream->loopBegin % format->wSamplesPerBlock;
+		if (stream->loopEnd < stream->duration)
+		{
+			stream->loopEnd -= stream->loopEnd % format->wSamplesPerBlock;
+			if (stream->loopEnd <= stream->loopBegin)
+			{
+				stream->loopEnd = FAudio_min(
+					stream->loopBegin + format->wSamplesPerBlock,
+					stream->duration
+				);
+			}
+		}
+	}
+	else if (	format->wfx.wFormatTag != FAUDIO_FORMAT_PCM &&
+			stream->packetAlign == 0	)
+	{
+		/* Loaded in one piece, so a pass is the whole Wave */
+		stream->loopBegin = 0;
+		stream->loopEnd = stream->duration;
+	}
+	stream->passEnd = (stream->loopCount > 0) ?
+		stream->loopEnd :
+		stream->duration;
+
+	/* Short Waves don't need a full buffer */
+	unit = FACT_INTERNAL_StreamBlockSize(stream);
+	stream->bufferSize = FAudio_min(
+		stream->bufferSize,
+		(stream->length + unit - 1) / unit * unit
+	);
+
+	/* A short Wave that doesn't loop never needs all of them */
+	count = FACT_STREAM_BUFFER_COUNT;
+	if (stream->loopCount == 0)
+	{
+		count = FAudio_min(
+			count,
+			(	stream->length +
+				stream->bufferSize - 1	) / stream->bufferSize
+		);
+	}
+	stream->bufferCount = (uint8_t) FAudio_max(count, 1);
+	for (i = 0; i < stream->bufferCount; i += 1)
+	{
+		stream->buffers[i].data = (uint8_t*) engine->pMalloc(
+			stream->bufferSize
+		);
+		stream->buffers[i].state = FACT_STREAM_BUFFER_FREE;
+		if (stream->packetAlign > 0)
+		{
+			stream->buffers[i].decodedBytes = (uint32_t*) engine->pMalloc(
+				sizeof(uint32_t) *
+				(stream->bufferSize / stream->packetAlign)
+			);
+		}
+	}
+	wave->stream = stream;
+
+	FACT_INTERNAL_StartStreamThread(engine);
+
+	/* Read the first buffer now, so the Wave is ready to play once it's
+	 * prepared. The streaming thread reads the rest.
+	 */
+	buffer = FACT_INTERNAL_NextStreamBuffer(stream);
+	readTime = FACT_INTERNAL_ReadStreamBuffer(stream, buffer);
+
+	FAudio_PlatformLockMutex(wave->voice->src.bufferLock);
+	FAudio_PlatformLockMutex(engine->streamLock);
+	FACT_INTERNAL_CountStreamRead(wave->parentBank, buffer, readTime);
+	buffer->state = FACT_STREAM_BUFFER_READY;
+	stream->linked = 1;
+	stream->next = engine->streams;
+	engine->streams = stream;
+	FACT_INTERNAL_SubmitStreamBuffers(stream);
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+	FAudio_PlatformUnlockMutex(wave->voice->src.bufferLock);
+
+	FACT_INTERNAL_WakeStreamThread(engine);
+	return stream;
+}
+
+void FACT_INTERNAL_DestroyStream(FACTStream *stream)
+{
+	FACTAudioEngine *engine = stream->wave->parentBank->parentEngine;
+	FACTStream **link;
+	uint8_t i;
+
+	FAudio_PlatformLockMutex(engine->streamLock);
+	link = &engine->streams;
+	while (*link != stream)
+	{
+		link = &(*link)->next;
+	}
+	*link = stream->next;
+	stream->linked = 0;
+	while (stream->busy)
+	{
+		stream->waiting = 1;
+		FAudio_PlatformUnlockMutex(engine->streamLock);
+		FAudio_PlatformWaitSemaphore(engine->streamDone);
+		FAudio_PlatformLockMutex(engine->streamLock);
+	}
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+
+	/* The Wave is stopped, but a read may have finished and been submitted
+	 * after FACTWave_Stop's flush. The voice is about to be pooled, so
+	 * nothing of ours can stay queued on it.
+	 */
+	FAudioSourceVoice_FlushSourceBuffers(stream->wave->voice);
+
+	for (i = 0; i < stream->bufferCount; i += 1)
+	{
+		engine->pFree(stream->buffers[i].data);
+		if (stream->buffers[i].decodedBytes != NULL)
+		{
+			engine->pFree(stream->buffers[i].decodedBytes);
+		}
+	}
+	stream->wave->stream = NULL;
+	engine->pFree(stream);
+}
+
+void FACT_INTERNAL_StartStreamThread(FACTAudioEngine *engine)
+{
+	if (engine->streamLock != NULL)
+	{
+		return;
+	}
+
+	engine->streamLock = FAudio_PlatformCreateMutex();
+	engine->streamDone = FAudio_PlatformCreateSemaphore(0);
+	engine->streamQuit = 0;
+	if (engine->taskPool != NULL)
+	{
+		FAudio_INTERNAL_StartPoolLoop(
+			&engine->streamLoop,
+			engine->taskPool,
+			FACT_INTERNAL_StreamStep,
+			engine,
+			FACT_STREAM_DEADLINE_US
+		);
+	}
+	else
+	{
+		engine->streamWake = FAudio_PlatformCreateSemaphore(0);
+		engine->streamThread = FAudio_PlatformCreateThread(
+			FACT_INTERNAL_StreamThread,
+			"FACT Streaming Thread",
+			engine
+		);
+	}
+}
+
+void FACT_INTERNAL_WakeStreamThread(FACTAudioEngine *engine)
+{
+	if (engine->streamLoop.pool != NULL)
+	{
+		FAudio_INTERNAL_WakePoolLoop(&engine->streamLoop);
+	}
+	else
+	{
+		FAudio_PlatformPostSemaphore(engine->streamWake);
+	}
+}
+
+void FACT_INTERNAL_StopStreamThread(FACTAudioEngine *engine)
+{
+	if (engine->streamLock == NULL)
+	{
+		return;
+	}
+
+	FAudio_PlatformLockMutex(engine->streamLock);
+	engine->streamQuit = 1;
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+	if (engine->streamLoop.pool != NULL)
+	{
+		FAudio_INTERNAL_StopPoolLoop(&engine->streamLoop);
+	}
+	else
+	{
+		FAudio_PlatformPostSemaphore(engine->streamWake);
+		FAudio_PlatformWaitThread(engine->streamThread, NULL);
+		FAudio_PlatformDestroySemaphore(engine->streamWake);
+	}
+
+	FAudio_PlatformDestroySemaphore(engine->streamDone);
+	FAudio_PlatformDestroyMutex(engine->streamLock);
+	engine->streamThread = NULL;
+	engine->streamWake = NULL;
+	engine->streamLock = NULL;
+}
+
+/* 3D Helper Functions */
+
+void FACT_INTERNAL_SetWaveMatrix(
+	FACTWave *wave,
+	uint32_t srcChannels,
+	uint32_t dstChannels,
+	const float *matrix,
+	uint32_t operationSet
+) {
+	uint32_t i;
+	float merged[2 * 8];
+
+	FACT_INTERNAL_LockAPI(wave->parentBank->parentEngine);
+
+	/* There seems to be this weird feature in XACT where the channel count
+	 * can be completely wrong and it'll go to the right place.
+	 * I guess these XACT functions do some extra work to merge coefficients
+	 * but I have no idea where it really happens and XAudio2 definitely
+	 * does NOT like it when this is wrong, so here it goes...
+	 * -flibit
+	 */
+	if (srcChannels == 1 && wave->srcChannels == 2)
+	{
+		for (i = 0; i < dstChannels; i += 1)
+		{
+			merged[i * 2] = matrix[i];
+			merged[i * 2 + 1] = matrix[i];
+		}
+		matrix = merged;
+		srcChannels = 2;
+	}
+	else if (srcChannels == 2 && wave->srcChannels == 1)
+	{
+		for (i = 0; i < dstChannels; i += 1)
+		{
+			merged[i] = (matrix[i * 2] + matrix[i * 2 + 1]) / 2.0f;
+		}
+		matrix = merged;
+		srcChannels = 1;
+	}
+
+	FAudioVoice_SetOutputMatrix(
+		wave->voice,
+		wave->voice->sends.pSends->pOutputVoice,
+		srcChannels,
+		dstChannels,
+		matrix,
+		operationSet
+	);
+
+	FACT_INTERNAL_UnlockAPI(wave->parentBank->parentEngine);
+}
+
+void FACT_INTERNAL_SetCueMatrix(
+	FACTCue *cue,
+	uint32_t srcChannels,
+	uint32_t dstChannels,
+	const float *matrix,
+	uint32_t operationSet
+) {
+	uint8_t i;
+
+	FACT_INTERNAL_LockAPI(cue->parentBank->parentEngine);
+
+	/* See FACTCue.matrixCoefficients declaration */
+	FAudio_assert(srcChannels > 0 && srcChannels < 3);
+	FAudio_assert(dstChannels > 0 && dstChannels < 9);
+
+	/* The waves already have this matrix, don't bother their voices */
+	if (	cue->active3D &&
+		cue->srcChannels == srcChannels &&
+		cue->dstChannels == dstChannels &&
+		FAudio_memcmp(
+			cue->matrixCoefficients,
+			matrix,
+			sizeof(float) * srcChannels * dstChannels
+		) == 0	)
+	{
+		FACT_INTERNAL_UnlockAPI(cue->parentBank->parentEngine);
+		return;
+	}
+
+	/* Local storage */
+	cue->srcChannels = srcChannels;
+	cue->dstChannels = dstChannels;
+	FAudio_memcpy(
+		cue->matrixCoefficients,
+		matrix,
+		sizeof(float) * srcChannels * dstChannels
+	);
+	cue->active3D = 1;
+
+	/* Apply to Waves if they exist */
+	if (cue->simpleWave != NULL)
+	{
+		FACT_INTERNAL_SetWaveMatrix(
+			cue->simpleWave,
+			srcChannels,
+			dstChannels,
+			matrix,
+			operationSet
+		);
+	}
+	else if (cue->playingSound != NULL)
+	{
+		for (i = 0; i < cue->playingSound->sound->trackCount; i += 1)
+		{
+			if (cue->playingSound->tracks[i].activeWave.wave != NULL)
+			{
+				FACT_INTERNAL_SetWaveMatrix(
+					cue->playingSound->tracks[i].activeWave.wave,
+					srcChannels,
+					dstChannels,
+					matrix,
+					operationSet
+				);
+			}
+		}
+	}
+
+	/* Nobody else is going to commit these, see FACT_INTERNAL_APIThread */
+	if (	operationSet == FACT_OPERATIONSET_3D &&
+		!cue->parentBank->parentEngine->frameCommits	)
+	{
+		FACT_INTERNAL_WakeAPIThread(cue->parentBank->parentEngine);
+	}
+
+	FACT_INTERNAL_UnlockAPI(cue->parentBank->parentEngine);
+}
+
+/* RPC Helper Functions */
+
+FACTRPC* FACT_INTERNAL_GetRPC(
+	FACTAudioEngine *engine,
+	uint32_t code
+) {
+	uint16_t i;
+	for (i = 0; i < engine->rpcCount; i += 1)
+	{
+		if (engine->rpcCodes[i] == code)
+		{
+			return &engine->rpcs[i];
+		}
+	}
+
+	FAudio_assert(0 && "RPC code not found!");
+	return NULL;
+}
+
+/* Arena Functions */
+
+/* Enough for any of the parsed types */
+#define FACT_ARENA_ALIGN 8
+#define FACT_ARENA_MIN_BLOCK 4096
+
+void FACT_INTERNAL_InitArena(FACTArena *arena, size_t blockSize)
+{
+	arena->blocks = NULL;
+	arena->blockSize = FAudio_max(blockSize, FACT_ARENA_MIN_BLOCK);
+}
+
+void* FACT_INTERNAL_ArenaAlloc(
+	FACTArena *arena,
+	size_t size,
+	FAudioMallocFunc pMalloc
+) {
+	FACTArenaBlock *block = arena->blocks;
+	uint8_t *result;
+
+	size = (size + (FACT_ARENA_ALIGN - 1)) & ~(FACT_ARENA_ALIGN - 1);
+	if (block == NULL || (block->size - block->used) < size)
+	{
+		if (block != NULL)
+		{
+			arena->blockSize *= 2;
+		}
+		while (arena->blockSize < size)
+		{
+			arena->blockSize *= 2;
+		}
+		block = (FACTArenaBlock*) pMalloc(
+			sizeof(FACTArenaBlock) + arena->blockSize
+		);
+		block->next = arena->blocks;
+		block->size = arena->blockSize;
+		block->used = 0;
+		arena->blocks = block;
+	}
+
+	result = ((uint8_t*) (block + 1)) + block->used;
+	block->used += size;
+	return result;
+}
+
+void FACT_INTERNAL_FreeArena(FACTArena *arena, FAudioFreeFunc pFree)
+{
+	FACTArenaBlock *block = arena->blocks, *next;
+	while (block != NULL)
+	{
+		next = block->next;
+		pFree(block);
+		block = next;
+	}
+	arena->blocks = NULL;
+}
+
+size_t FACT_INTERNAL_GetArenaSize(const FACTArena *arena)
+{
+	const FACTArenaBlock *block;
+	size_t size = 0;
+	for (block = arena->blocks; block != NULL; block = block->next)
+	{
+		size += sizeof(FACTArenaBlock) + block->size;
+	}
+	return size;
+}
+
+/* Name Lookup Functions */
+
+static uint32_t FACT_INTERNAL_HashName(const char *name)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+	while (*name != '\0')
+	{
+		hash ^= (uint8_t) *name;
+		hash *= 16777619u;
+		name += 1;
+	}
+	return hash;
+}
+
+void FACT_INTERNAL_BuildNameTable(
+	FACTNameTable *table,
+	char **names,
+	const uint16_t *indices,
+	uint16_t count,
+	FACTArena *arena,
+	FAudioMallocFunc pMalloc
+) {
+	uint32_t i, slot, slotCount;
+	uint16_t index;
+
+	/* At most half full, so probe sequences stay short */
+	slotCount = 4;
+	while (slotCount < (uint32_t) count * 2)
+	{
+		slotCount *= 2;
+	}
+	table->mask = slotCount - 1;
+	table->slots = (uint16_t*) FACT_INTERNAL_ArenaAlloc(
+		arena,
+		sizeof(uint16_t) * slotCount,
+		pMalloc
+	);
+	FAudio_zero(table->slots, sizeof(uint16_t) * slotCount);
+
+	for (i = 0; i < count; i += 1)
+	{
+		index = (indices != NULL) ? indices[i] : (uint16_t) i;
+		slot = FACT_INTERNAL_HashName(names[index]) & table->mask;
+		while (table->slots[slot] != 0)
+		{
+			slot = (slot + 1) & table->mask;
+		}
+		table->slots[slot] = index + 1;
+	}
+}
+
+uint16_t FACT_INTERNAL_FindName(
+	const FACTNameTable *table,
+	char **names,
+	const char *name
+) {
+	uint32_t slot;
+	uint16_t index;
+
+	if (table->slots == NULL)
+	{
+		return FACTINDEX_INVALID;
+	}
+
+	slot = FACT_INTERNAL_HashName(name) & table->mask;
+	while (table->slots[slot] != 0)
+	{
+		index = table->slots[slot] - 1;
+		if (FAudio_strcmp(name, names[index]) == 0)
+		{
+			return index;
+		}
+		slot = (slot + 1) & table->mask;
+	}
+	return FACTINDEX_INVALID;
+}
+
+FACTWaveBank* FACT_INTERNAL_GetWaveBank(FACTSoundBank *sb, uint8_t index)
+{
+	LinkedList *list;
+	FACTWaveBank *wb;
+
+	if (sb->wavebanks[index] == NULL)
+	{
+		list = sb->parentEngine->wbList;
+		while (list != NULL)
+		{
+			wb = (FACTWaveBank*) list->entry;
+			if (FAudio_strcmp(sb->wavebankNames[index], wb->name) == 0)
+			{
+				sb->wavebanks[index] = wb;
+				break;
+			}
+			list = list->next;
 		}
 	}
-
-	FAudio_assert(0 && "RPC code not found!");
-	return NULL;
+	return sb->wavebanks[index];
 }
 
 float FACT_INTERNAL_CalculateRPC(
@@ -840,7 +2806,7 @@ float FACT_INTERNAL_CalculateRPC(
 	float var
 ) {
 	float result;
-	uint8_t i;
+	uint8_t lo, hi, mid;
 
 	/* Min/Max */
 	if (var <= rpc->points[0].x)
@@ -854,31 +2820,39 @@ float FACT_INTERNAL_CalculateRPC(
 		return rpc->points[rpc->pointCount - 1].y;
 	}
 
-	/* Something between points... TODO: Non-linear curves */
-	result = 0.0f;
-	for (i = 0; i < rpc->pointCount - 1; i += 1)
+	/* Something between points... TODO: Non-linear curves
+	 * The points are in ascending order, so bisect for the line that var
+	 * is on, keeping points[lo].x < var <= points[hi].x.
+	 */
+	lo = 0;
+	hi = rpc->pointCount - 1;
+	while ((hi - lo) > 1)
 	{
-		/* y = b */
-		result = rpc->points[i].y;
-		if (var >= rpc->points[i].x && var <= rpc->points[i + 1].x)
+		mid = (lo + hi) / 2;
+		if (var <= rpc->points[mid].x)
 		{
-			/* y += mx */
-			result +=
-				((rpc->points[i + 1].y - rpc->points[i].y) /
-				(rpc->points[i + 1].x - rpc->points[i].x)) *
-					(var - rpc->points[i].x);
-
-			/* Pre-algebra, rockin'! */
-			break;
+			hi = mid;
+		}
+		else
+		{
+			lo = mid;
 		}
 	}
+
+	/* y = b */
+	result = rpc->points[lo].y;
+
+	/* y += mx */
+	result += rpc->points[lo].slope * (var - rpc->points[lo].x);
+
+	/* Pre-algebra, rockin'! */
 	return result;
 }
 
 void FACT_INTERNAL_UpdateRPCs(
 	FACTCue *cue,
-	uint8_t codeCount,
-	uint32_t *codes,
+	uint8_t rpcCount,
+	uint16_t *rpcIndices,
 	FACTInstanceRPCData *data,
 	uint32_t timestamp,
 	uint32_t elapsedTrack
@@ -889,31 +2863,25 @@ void FACT_INTERNAL_UpdateRPCs(
 	float variableValue;
 	FACTAudioEngine *engine = cue->parentBank->parentEngine;
 
-	if (codeCount > 0)
+	if (rpcCount > 0)
 	{
 		/* Do NOT overwrite Frequency! */
 		data->rpcVolume = 0.0f;
 		data->rpcPitch = 0.0f;
 		data->rpcReverbSend = 0.0f;
 		data->rpcFilterQFactor = FAUDIO_DEFAULT_FILTER_ONEOVERQ;
-		for (i = 0; i < codeCount; i += 1)
+		engine->rpcEvaluations += rpcCount;
+		for (i = 0; i < rpcCount; i += 1)
 		{
-			rpc = FACT_INTERNAL_GetRPC(
-				engine,
-				codes[i]
-			);
+			rpc = &engine->rpcs[rpcIndices[i]];
 			if (engine->variables[rpc->variable].accessibility & 0x04)
 			{
-				if (FAudio_strcmp(
-					engine->variableNames[rpc->variable],
-					"AttackTime"
-				) == 0) {
+				if (engine->variables[rpc->variable].special == VARIABLE_SPECIAL_ATTACKTIME)
+				{
 					variableValue = (float) elapsedTrack;
 				}
-				else if (FAudio_strcmp(
-					engine->variableNames[rpc->variable],
-					"ReleaseTime"
-				) == 0) {
+				else if (engine->variables[rpc->variable].special == VARIABLE_SPECIAL_RELEASETIME)
+				{
 					if (cue->playingSound->fadeType == 3) /* Release RPC */
 					{
 						variableValue = (float) (timestamp - cue->playingSound->fadeStart);
@@ -994,6 +2962,7 @@ void FACT_INTERNAL_UpdateEngine(FACTAudioEngine *engine)
 						&engine->rpcs[i],
 						engine->globalVariableValues[engine->rpcs[i].variable]
 					);
+					engine->rpcEvaluations += 1;
 					engine->dspPresets[j].parameters[par].value = FAudio_clamp(
 						rpcResult,
 						engine->dspPresets[j].parameters[par].minVal,
@@ -1336,8 +3305,8 @@ uint8_t FACT_INTERNAL_UpdateSound(FACTSoundInstance *sound, uint32_t timestamp)
 	sound->rpcData.rpcFilterFreq = -1.0f;
 	FACT_INTERNAL_UpdateRPCs(
 		sound->parentCue,
-		sound->sound->rpcCodeCount,
-		sound->sound->rpcCodes,
+		sound->sound->rpcCount,
+		sound->sound->rpcIndices,
 		&sound->rpcData,
 		timestamp,
 		elapsedCue - sound->tracks[0].events[0].timestamp
@@ -1347,8 +3316,8 @@ uint8_t FACT_INTERNAL_UpdateSound(FACTSoundInstance *sound, uint32_t timestamp)
 		sound->tracks[i].rpcData.rpcFilterFreq = sound->rpcData.rpcFilterFreq;
 		FACT_INTERNAL_UpdateRPCs(
 			sound->parentCue,
-			sound->sound->tracks[i].rpcCodeCount,
-			sound->sound->tracks[i].rpcCodes,
+			sound->sound->tracks[i].rpcCount,
+			sound->sound->tracks[i].rpcIndices,
 			&sound->tracks[i].rpcData,
 			timestamp,
 			elapsedCue - sound->sound->tracks[i].events[0].timestamp
@@ -1515,11 +3484,7 @@ void FACT_INTERNAL_UpdateCue(FACTCue *cue)
 							sound->tracks[i].upcomingWave.wave
 						);
 					}
-					cue->parentBank->parentEngine->pFree(
-						sound->tracks[i].events
-					);
 				}
-				cue->parentBank->parentEngine->pFree(sound->tracks);
 
 				if (sound->sound->category != FACTCATEGORY_INVALID)
 				{
@@ -1527,6 +3492,10 @@ void FACT_INTERNAL_UpdateCue(FACTCue *cue)
 						sound->sound->category
 					].instanceCount -= 1;
 				}
+				FACT_INTERNAL_FreeSound(
+					cue->parentBank->parentEngine,
+					sound
+				);
 			}
 
 			/* TODO: Reset cue times? Transition tables...?
@@ -1539,23 +3508,175 @@ void FACT_INTERNAL_UpdateCue(FACTCue *cue)
 	}
 }
 
+/* API Lock Functions */
+
+void FACT_INTERNAL_LockAPI(FACTAudioEngine *engine)
+{
+	FAudio_PlatformLockMutex(engine->apiLock);
+}
+
+void FACT_INTERNAL_UnlockAPI(FACTAudioEngine *engine)
+{
+	FAudio_PlatformUnlockMutex(engine->apiLock);
+}
+
+void FACT_INTERNAL_StoreVariable(float *variable, float value)
+{
+	union
+	{
+		float f;
+		int32_t i;
+	} bits;
+	int32_t old;
+
+	bits.f = value;
+	do
+	{
+		old = FAudio_PlatformAtomicGet((volatile int32_t*) variable);
+	} while (!FAudio_PlatformAtomicCompareExchange(
+		(volatile int32_t*) variable,
+		old,
+		bits.i
+	));
+}
+
+float FACT_INTERNAL_LoadVariable(float *variable)
+{
+	union
+	{
+		float f;
+		int32_t i;
+	} bits;
+
+	bits.i = FAudio_PlatformAtomicGet((volatile int32_t*) variable);
+	return bits.f;
+}
+
 /* FACT Thread */
 
-int32_t FACT_INTERNAL_APIThread(void* enginePtr)
+void FACT_INTERNAL_WakeAPIThread(FACTAudioEngine *engine)
+{
+	/* One post is enough, the thread clears this when it wakes up */
+	if (	(engine->apiWake != NULL || engine->apiLoop.pool != NULL) &&
+		FAudio_PlatformAtomicCompareExchange(&engine->wakePosted, 0, 1)	)
+	{
+		FACT_INTERNAL_PostAPIWake(engine);
+	}
+}
+
+void FACT_INTERNAL_PostAPIWake(FACTAudioEngine *engine)
+{
+	if (engine->apiWake != NULL)
+	{
+		FAudio_PlatformPostSemaphore(engine->apiWake);
+	}
+	else if (	engine->apiLoop.pool != NULL &&
+			!(engine->creationFlags & FACT_FLAG_FIXED_UPDATE_RATE_EXT)	)
+	{
+		FAudio_INTERNAL_WakePoolLoop(&engine->apiLoop);
+	}
+}
+
+static uint8_t FACT_INTERNAL_HasTimeRPC(
+	FACTAudioEngine *engine,
+	uint8_t rpcCount,
+	uint16_t *rpcIndices
+) {
+	uint8_t i;
+	FACTRPC *rpc;
+	for (i = 0; i < rpcCount; i += 1)
+	{
+		rpc = &engine->rpcs[rpcIndices[i]];
+		if (engine->variables[rpc->variable].special != VARIABLE_SPECIAL_NONE)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* How long until this Sound needs another update, at most maxWait */
+static uint32_t FACT_INTERNAL_GetSoundWait(
+	FACTSoundInstance *sound,
+	uint32_t timestamp,
+	uint32_t maxWait
+) {
+	uint8_t i, j;
+	uint32_t elapsedCue;
+	FACTEventInstance *evtInst;
+	FACTAudioEngine *engine = sound->parentCue->parentBank->parentEngine;
+
+	/* Volume changes every update until the fade is over */
+	if (sound->fadeType != 0)
+	{
+		return FACT_API_TICK_MS;
+	}
+
+	if (FACT_INTERNAL_HasTimeRPC(
+		engine,
+		sound->sound->rpcCount,
+		sound->sound->rpcIndices
+	)) {
+		return FACT_API_TICK_MS;
+	}
+
+	/* Same time as FACT_INTERNAL_UpdateSound */
+	elapsedCue = timestamp - (sound->parentCue->start - sound->parentCue->elapsed);
+
+	for (i = 0; i < sound->sound->trackCount; i += 1)
+	{
+		if (FACT_INTERNAL_HasTimeRPC(
+			engine,
+			sound->sound->tracks[i].rpcCount,
+			sound->sound->tracks[i].rpcIndices
+		)) {
+			return FACT_API_TICK_MS;
+		}
+
+		for (j = 0; j < sound->sound->tracks[i].eventCount; j += 1)
+		{
+			evtInst = &sound->tracks[i].events[j];
+			if (evtInst->finished)
+			{
+				continue;
+			}
+
+			/* Events that are due but not finished are ramping,
+			 * repeating or waiting on something, check often
+			 */
+			if (elapsedCue >= evtInst->timestamp)
+			{
+				return FACT_API_TICK_MS;
+			}
+			maxWait = FAudio_min(
+				maxWait,
+				evtInst->timestamp - elapsedCue
+			);
+		}
+	}
+
+	return maxWait;
+}
+
+/* One update of every active Cue. Returns the ms until the next one is due,
+ * 0 for right away or FACT_API_WAIT_FOREVER to wait for the application.
+ */
+uint32_t FACT_INTERNAL_APITick(void *enginePtr)
 {
 	FACTAudioEngine *engine = (FACTAudioEngine*) enginePtr;
-	LinkedList *sbList;
 	FACTCue *cue, *cBackup;
-	uint32_t timestamp, updateTime;
+	uint32_t timestamp, updateTime, wait, cueCount, tickTime;
+	uint64_t tickStart;
 
-	/* Needs to match the audio thread priority, or else the scheduler will
-	 * let this thread sit around with a lock while the audio thread spins
-	 * infinitely!
-	 */
-	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+	/* ShutDown wakes us up too */
+	if (!engine->initialized)
+	{
+		return FACT_API_WAIT_FOREVER;
+	}
 
-threadstart:
-	FAudio_PlatformLockMutex(engine->apiLock);
+	FACT_INTERNAL_LockAPI(engine);
+	tickStart = FAudio_timeus();
+	cueCount = 0;
 
 	/* We want the timestamp to be uniform across all Cues.
 	 * Oftentimes many Cues are played at once with the expectation
@@ -1565,56 +3686,130 @@ threadstart:
 	 */
 	timestamp = FAudio_timems();
 
-	FACT_INTERNAL_UpdateEngine(engine);
+	/* Anything posted from here on needs another pass */
+	FAudio_PlatformAtomicCompareExchange(&engine->wakePosted, 1, 0);
+	wait = FACT_API_WAIT_FOREVER;
 
-	sbList = engine->sbList;
-	while (sbList != NULL)
+	/* Applications that never call DoWork get their 3D changes here */
+	if (!engine->frameCommits)
 	{
-		cue = ((FACTSoundBank*) sbList->entry)->cueList;
-		while (cue != NULL)
-		{
-			FACT_INTERNAL_UpdateCue(cue);
+		FAudio_CommitOperationSet(engine->audio, FACT_OPERATIONSET_3D);
+	}
 
-			if (cue->state & FACT_STATE_PAUSED)
-			{
-				cue = cue->next;
-				continue;
-			}
+	FACT_INTERNAL_UpdateEngine(engine);
 
-			if (cue->playingSound != NULL)
-			{
-				if (FACT_INTERNAL_UpdateSound(cue->playingSound, timestamp))
-				{
-					FACT_INTERNAL_DestroySound(cue->playingSound);
-				}
-			}
+	/* Virtual Waves that end now are cleared out with the rest below */
+	FACT_INTERNAL_AdvanceVirtualWaves(engine, timestamp);
+
+	cue = engine->activeCues;
+	while (cue != NULL)
+	{
+		/* Destroying this Cue takes it off the list */
+		cBackup = cue->activeNext;
 
-			/* Destroy if it's done and not user-handled. */
-			if (cue->managed && (cue->state & FACT_STATE_STOPPED))
+		FACT_INTERNAL_UpdateCue(cue);
+		cueCount += 1;
+
+		if (cue->playingSound != NULL)
+		{
+			if (FACT_INTERNAL_UpdateSound(cue->playingSound, timestamp))
 			{
-				cBackup = cue->next;
-				FACTCue_Destroy(cue);
-				cue = cBackup;
+				FACT_INTERNAL_DestroySound(cue->playingSound);
 			}
 			else
 			{
-				cue = cue->next;
+				wait = FACT_INTERNAL_GetSoundWait(
+					cue->playingSound,
+					timestamp,
+					FAudio_min(wait, FACT_API_PLAYING_MS)
+				);
 			}
 		}
-		sbList = sbList->next;
+
+		/* Destroy if it's done and not user-handled. */
+		if (cue->managed && (cue->state & FACT_STATE_STOPPED))
+		{
+			FACTCue_Destroy(cue);
+		}
+		else if (!(cue->state & (FACT_STATE_PLAYING | FACT_STATE_STOPPING)))
+		{
+			/* Nothing to do until it's played again */
+			FACT_INTERNAL_DeactivateCue(cue);
+		}
+		cue = cBackup;
 	}
 
-	FAudio_PlatformUnlockMutex(engine->apiLock);
+	/* With every Wave for this pass playing, enforce the budget */
+	wait = FACT_INTERNAL_UpdateVoiceBudget(engine, timestamp, wait);
+
+	tickTime = (uint32_t) (FAudio_timeus() - tickStart);
+	engine->stats.TickCount += 1;
+	engine->stats.LastTickMicroseconds = tickTime;
+	engine->stats.MaxTickMicroseconds = FAudio_max(
+		engine->stats.MaxTickMicroseconds,
+		tickTime
+	);
+	engine->stats.CuesUpdated = cueCount;
+	engine->stats.RPCEvaluations = engine->rpcEvaluations;
+	engine->rpcEvaluations = 0;
+
+	FACT_INTERNAL_UnlockAPI(engine);
+
+	/* FIXME: 10ms is based on the XAudio2 update time...? */
+	updateTime = FAudio_timems() - timestamp;
+	if (engine->creationFlags & FACT_FLAG_FIXED_UPDATE_RATE_EXT)
+	{
+		wait = FACT_API_TICK_MS;
+	}
+	else if (wait == FACT_API_WAIT_FOREVER)
+	{
+		/* Nothing is playing, wait for the application */
+		return FACT_API_WAIT_FOREVER;
+	}
+	return (updateTime < wait) ? (wait - updateTime) : 0;
+}
+
+int32_t FACT_INTERNAL_APIThread(void* enginePtr)
+{
+	FACTAudioEngine *engine = (FACTAudioEngine*) enginePtr;
+	FAudioThreadScheduler scheduler;
+	uint32_t wait;
+
+	/* Needs to match the audio thread priority, or else the scheduler will
+	 * let this thread sit around with a lock while the audio thread spins
+	 * infinitely!
+	 */
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+	FAudio_zero(&scheduler, sizeof(scheduler));
 
-	if (engine->initialized)
+	while (engine->initialized)
 	{
-		/* FIXME: 10ms is based on the XAudio2 update time...? */
-		updateTime = FAudio_timems() - timestamp;
-		if (updateTime < 10)
+		FAudio_INTERNAL_ApplyThreadSchedule(
+			&engine->threadSchedules[FACT_THREAD_API_EXT],
+			&scheduler,
+			FAUDIO_THREAD_PRIORITY_HIGH
+		);
+		wait = FACT_INTERNAL_APITick(engine);
+		if (!engine->initialized)
+		{
+			break;
+		}
+
+		if (engine->creationFlags & FACT_FLAG_FIXED_UPDATE_RATE_EXT)
+		{
+			if (wait > 0)
+			{
+				FAudio_sleep(wait);
+			}
+		}
+		else if (wait == FACT_API_WAIT_FOREVER)
+		{
+			FAudio_PlatformWaitSemaphore(engine->apiWake);
+		}
+		else if (wait > 0)
 		{
-			FAudio_sleep(10 - updateTime);
+			FAudio_PlatformWaitSemaphoreTimeout(engine->apiWake, wait);
 		}
-		goto threadstart;
 	}
 
 	return 0;
@@ -1624,108 +3819,59 @@ threadstart:
 
 void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext)
 {
-	FAudioBuffer buffer;
-	FAudioBufferWMA bufferWMA;
 	FACTWaveCallback *c = (FACTWaveCallback*) callback;
-	FACTWaveBankEntry *entry;
-	FACTOverlapped ovlp;
-	uint32_t end, left, read;
-	uint16_t align;
-
-	entry = &c->wave->parentBank->entries[c->wave->index];
-	align = (entry->Format.wBlockAlign + 22) * entry->Format.nChannels;
-
-	/* TODO: Loop regions */
-	end = entry->PlayRegion.dwOffset + entry->PlayRegion.dwLength;
-	left = entry->PlayRegion.dwLength - (c->wave->streamOffset - entry->PlayRegion.dwOffset);
-
-	/* Don't bother if we're EOS or the Wave has stopped*/
-	if (	(c->wave->streamOffset >= end) ||
-		(c->wave->state & FACT_STATE_STOPPED)	)
-	{
-		return;
-	}
-
-	/* Assign buffer memory */
-	buffer.pAudioData = c->wave->streamCache;
-	buffer.AudioBytes = FAudio_min(
-		c->wave->streamSize,
-		left
-	);
+	FACTStreamBuffer *buffer = (FACTStreamBuffer*) pContext;
+	FACTStream *stream = c->wave->stream;
+	FACTAudioEngine *engine = c->wave->parentBank->parentEngine;
+	uint8_t i;
 
-	/* Last buffer in the stream? */
-	if (	buffer.AudioBytes < c->wave->streamSize &&
-		c->wave->loopCount == 0	)
-	{
-		buffer.Flags = FAUDIO_END_OF_STREAM;
-	}
-	else
+	/* We're on the mixer thread, so never wait for the disk here. Queue
+	 * whatever the streaming thread has already read and let it refill
+	 * the buffer that just finished.
+	 */
+	FAudio_PlatformLockMutex(engine->streamLock);
+	buffer->state = FACT_STREAM_BUFFER_FREE;
+	if (stream->linked)
 	{
-		buffer.Flags = 0;
-	}
-
-	/* Read! */
-	ovlp.Internal = NULL;
-	ovlp.InternalHigh = NULL;
-	ovlp.Offset = c->wave->streamOffset;
-	ovlp.OffsetHigh = 0; /* I sure hope so... */
-	ovlp.hEvent = NULL;
-	c->wave->parentBank->parentEngine->pReadFile(
-		c->wave->parentBank->io,
-		c->wave->streamCache,
-		buffer.AudioBytes,
-		NULL,
-		&ovlp
-	);
-	c->wave->parentBank->parentEngine->pGetOverlappedResult(
-		c->wave->parentBank->io,
-		&ovlp,
-		&read,
-		1
-	);
+		FACT_INTERNAL_SubmitStreamBuffers(stream);
+		FACT_INTERNAL_WakeStreamThread(engine);
 
-	/* Loop if applicable */
-	c->wave->streamOffset += buffer.AudioBytes;
-	if (	c->wave->streamOffset >= end &&
-		c->wave->loopCount > 0	)
-	{
-		if (c->wave->loopCount != 255)
+		/* Nothing left queued before the end means the voice is about to
+		 * run dry, the next read didn't make it in time
+		 */
+		if (	!(buffer->flags & FAUDIO_END_OF_STREAM) &&
+			!(c->wave->state & FACT_STATE_STOPPED)	)
 		{
-			c->wave->loopCount -= 1;
+			for (i = 0; i < stream->bufferCount; i += 1)
+			{
+				if (stream->buffers[i].state == FACT_STREAM_BUFFER_QUEUED)
+				{
+					break;
+				}
+			}
+			if (i == stream->bufferCount)
+			{
+				c->wave->parentBank->stats.LateBuffers += 1;
+				engine->stats.LateStreamBuffers += 1;
+			}
 		}
-		/* TODO: Loop start */
-		c->wave->streamOffset = entry->PlayRegion.dwOffset;
 	}
+	FAudio_PlatformUnlockMutex(engine->streamLock);
+}
 
-	/* Unused properties */
-	buffer.PlayBegin = 0;
-	buffer.PlayLength = 0;
-	buffer.LoopBegin = 0;
-	buffer.LoopLength = 0;
-	buffer.LoopCount = 0;
-	buffer.pContext = NULL;
+void FACT_INTERNAL_FinishWave(FACTWave *wave)
+{
+	wave->state = FACT_STATE_STOPPED;
 
-	/* Submit, finally. */
-	if (	entry->Format.wFormatTag == 0x1 ||
-		entry->Format.wFormatTag == 0x3	)
-	{
-		bufferWMA.pDecodedPacketCumulativeBytes =
-			c->wave->parentBank->seekTables[c->wave->index].entries;
-		bufferWMA.PacketCount =
-			c->wave->parentBank->seekTables[c->wave->index].entryCount;
-		FAudioSourceVoice_SubmitSourceBuffer(
-			c->wave->voice,
-			&buffer,
-			&bufferWMA
-		);
-	}
-	else
+	if (	wave->parentCue != NULL &&
+		wave->parentCue->simpleWave == wave	)
 	{
-		FAudioSourceVoice_SubmitSourceBuffer(
-			c->wave->voice,
-			&buffer,
-			NULL
+		wave->parentCue->state |= FACT_STATE_STOPPED;
+		wave->parentCue->state &= ~(
+			FACT_STATE_PLAYING |
+			FACT_STATE_STOPPING
 		);
+		wave->parentCue->data->instanceCount -= 1;
 	}
 }
 
@@ -1733,17 +3879,12 @@ void FACT_INTERNAL_OnStreamEnd(FAudioVoiceCallback *callback)
 {
 	FACTWaveCallback *c = (FACTWaveCallback*) callback;
 
-	c->wave->state = FACT_STATE_STOPPED;
+	FACT_INTERNAL_FinishWave(c->wave);
 
-	if (	c->wave->parentCue != NULL &&
-		c->wave->parentCue->simpleWave == c->wave	)
+	/* Not under apiLock, so post even if a wake is already pending */
+	if (c->wave->parentCue != NULL)
 	{
-		c->wave->parentCue->state |= FACT_STATE_STOPPED;
-		c->wave->parentCue->state &= ~(
-			FACT_STATE_PLAYING |
-			FACT_STATE_STOPPING
-		);
-		c->wave->parentCue->data->instanceCount -= 1;
+		FACT_INTERNAL_PostAPIWake(c->wave->parentBank->parentEngine);
 	}
 }
 
@@ -1753,21 +3894,31 @@ int32_t FACTCALL FACT_INTERNAL_DefaultReadFile(
 	void *hFile,
 	void *buffer,
 	uint32_t nNumberOfBytesToRead,
-	uint32_t *lpNumberOfBytesRead, /* Not referenced! */
+	uint32_t *lpNumberOfBytesRead,
 	FACTOverlapped *lpOverlapped
 ) {
 	FAudioIOStream *io = (FAudioIOStream*) hFile;
+	size_t read;
 	lpOverlapped->Internal = (void*) 0x00000103; /* STATUS_PENDING */
 	FAudio_PlatformLockMutex((FAudioMutex) io->lock);
 	io->seek(io->data, (size_t) lpOverlapped->Pointer, FAUDIO_SEEK_SET);
-	lpOverlapped->InternalHigh = (void*) (size_t) (io->read(
+
+	/* Count bytes, not items, so reads past EOF come back short instead
+	 * of empty, just like ReadFile
+	 */
+	read = io->read(
 		io->data,
 		buffer,
-		nNumberOfBytesToRead,
-		1
-	) * nNumberOfBytesToRead);
+		1,
+		nNumberOfBytesToRead
+	);
 	FAudio_PlatformUnlockMutex((FAudioMutex) io->lock);
+	lpOverlapped->InternalHigh = (void*) read;
 	lpOverlapped->Internal = 0; /* STATUS_SUCCESS */
+	if (lpNumberOfBytesRead != NULL)
+	{
+		*lpNumberOfBytesRead = (uint32_t) read;
+	}
 	return 1;
 }
 
@@ -1781,8 +3932,82 @@ int32_t FACTCALL FACT_INTERNAL_DefaultGetOverlappedResult(
 	return 1;
 }
 
-/* Parsing functions */
-
+/* Parsing functions */
+
+/* Bank headers are parsed with lots of tiny reads, so they go through a
+ * read-ahead cache of whole sectors. Anything too big for the cache is read
+ * straight into the caller's buffer.
+ */
+#define FACT_READ_CACHE_SIZE (16 * FACT_STREAM_SECTOR_SIZE)
+
+typedef struct FACTReadCache
+{
+	void *io;
+	FACTReadFileCallback pRead;
+	FACTGetOverlappedResultCallback pOverlap;
+	uint8_t *data;
+	uint32_t offset;
+	uint32_t size;
+} FACTReadCache;
+
+static uint32_t FACT_INTERNAL_ReadDirect(
+	FACTReadCache *cache,
+	void *dst,
+	uint32_t offset,
+	uint32_t size
+) {
+	FACTOverlapped ovlp;
+	uint32_t read;
+
+	ovlp.Internal = NULL;
+	ovlp.InternalHigh = NULL;
+	ovlp.Offset = offset;
+	ovlp.OffsetHigh = 0; /* I sure hope so... */
+	ovlp.hEvent = NULL;
+	cache->pRead(cache->io, dst, size, NULL, &ovlp);
+	cache->pOverlap(cache->io, &ovlp, &read, 1);
+	return read;
+}
+
+static uint32_t FACT_INTERNAL_ReadCached(
+	FACTReadCache *cache,
+	void *dst,
+	uint32_t offset,
+	uint32_t size
+) {
+	uint32_t end;
+
+	if (size > FACT_READ_CACHE_SIZE - FACT_STREAM_SECTOR_SIZE)
+	{
+		return FACT_INTERNAL_ReadDirect(cache, dst, offset, size);
+	}
+
+	end = cache->offset + cache->size;
+	if (offset < cache->offset || (offset + size) > end)
+	{
+		cache->offset = offset & ~(FACT_STREAM_SECTOR_SIZE - 1);
+		cache->size = FACT_INTERNAL_ReadDirect(
+			cache,
+			cache->data,
+			cache->offset,
+			FACT_READ_CACHE_SIZE
+		);
+		end = cache->offset + cache->size;
+	}
+
+	/* Short read at EOF */
+	if (offset >= end)
+	{
+		return 0;
+	}
+	if ((offset + size) > end)
+	{
+		size = end - offset;
+	}
+	FAudio_memcpy(dst, cache->data + (offset - cache->offset), size);
+	return size;
+}
+
 #define READ_FUNC(type, size, suffix, swapped) \
 	static inline type read_##suffix(uint8_t **ptr, const uint8_t swapendian) \
 	{ \
@@ -1831,6 +4056,7 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 	uint16_t blob1Count, blob2Count;
 	size_t memsize;
 	uint16_t i, j;
+	uint16_t *indices;
 
 	uint8_t *ptr = (uint8_t*) pParams->pGlobalSettingsBuffer;
 	uint8_t *start = ptr;
@@ -1857,6 +4083,14 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 		return -1; /* TODO: VERSION TOO OLD */
 	}
 
+	/* Most of what we parse is bigger than it is in the file */
+	FACT_INTERNAL_InitArena(
+		&pEngine->arena,
+		pParams->globalSettingsBufferSize * 4
+	);
+	#define ALLOC(size) \
+		FACT_INTERNAL_ArenaAlloc(&pEngine->arena, size, pEngine->pMalloc)
+
 	/* Object counts */
 	pEngine->categoryCount = read_u16(&ptr, se);
 	pEngine->variableCount = read_u16(&ptr, se);
@@ -1881,7 +4115,7 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 
 	/* Category data */
 	FAudio_assert((ptr - start) == categoryOffset);
-	pEngine->categories = (FACTAudioCategory*) pEngine->pMalloc(
+	pEngine->categories = (FACTAudioCategory*) ALLOC(
 		sizeof(FACTAudioCategory) * pEngine->categoryCount
 	);
 	for (i = 0; i < pEngine->categoryCount; i += 1)
@@ -1901,7 +4135,7 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 
 	/* Variable data */
 	FAudio_assert((ptr - start) == variableOffset);
-	pEngine->variables = (FACTVariable*) pEngine->pMalloc(
+	pEngine->variables = (FACTVariable*) ALLOC(
 		sizeof(FACTVariable) * pEngine->variableCount
 	);
 	for (i = 0; i < pEngine->variableCount; i += 1)
@@ -1913,7 +4147,7 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 	}
 
 	/* Global variable storage. Some unused data for non-global vars */
-	pEngine->globalVariableValues = (float*) pEngine->pMalloc(
+	pEngine->globalVariableValues = (float*) ALLOC(
 		sizeof(float) * pEngine->variableCount
 	);
 	for (i = 0; i < pEngine->variableCount; i += 1)
@@ -1925,11 +4159,11 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 	if (pEngine->rpcCount > 0)
 	{
 		FAudio_assert((ptr - start) == rpcOffset);
-		pEngine->rpcs = (FACTRPC*) pEngine->pMalloc(
+		pEngine->rpcs = (FACTRPC*) ALLOC(
 			sizeof(FACTRPC) *
 			pEngine->rpcCount
 		);
-		pEngine->rpcCodes = (uint32_t*) pEngine->pMalloc(
+		pEngine->rpcCodes = (uint32_t*) ALLOC(
 			sizeof(uint32_t) *
 			pEngine->rpcCount
 		);
@@ -1939,7 +4173,7 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 			pEngine->rpcs[i].variable = read_u16(&ptr, se);
 			pEngine->rpcs[i].pointCount = read_u8(&ptr, se);
 			pEngine->rpcs[i].parameter = read_u16(&ptr, se);
-			pEngine->rpcs[i].points = (FACTRPCPoint*) pEngine->pMalloc(
+			pEngine->rpcs[i].points = (FACTRPCPoint*) ALLOC(
 				sizeof(FACTRPCPoint) *
 				pEngine->rpcs[i].pointCount
 			);
@@ -1948,6 +4182,21 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 				pEngine->rpcs[i].points[j].x = read_f32(&ptr, se);
 				pEngine->rpcs[i].points[j].y = read_f32(&ptr, se);
 				pEngine->rpcs[i].points[j].type = read_u8(&ptr, se);
+				pEngine->rpcs[i].points[j].slope = 0.0f;
+			}
+
+			/* Precompute the lines between the points, so that
+			 * FACT_INTERNAL_CalculateRPC has nothing to divide
+			 */
+			for (j = 1; j < pEngine->rpcs[i].pointCount; j += 1)
+			{
+				pEngine->rpcs[i].points[j - 1].slope = (
+					pEngine->rpcs[i].points[j].y -
+					pEngine->rpcs[i].points[j - 1].y
+				) / (
+					pEngine->rpcs[i].points[j].x -
+					pEngine->rpcs[i].points[j - 1].x
+				);
 			}
 		}
 	}
@@ -1956,11 +4205,11 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 	if (pEngine->dspPresetCount > 0)
 	{
 		FAudio_assert((ptr - start) == dspPresetOffset);
-		pEngine->dspPresets = (FACTDSPPreset*) pEngine->pMalloc(
+		pEngine->dspPresets = (FACTDSPPreset*) ALLOC(
 			sizeof(FACTDSPPreset) *
 			pEngine->dspPresetCount
 		);
-		pEngine->dspPresetCodes = (uint32_t*) pEngine->pMalloc(
+		pEngine->dspPresetCodes = (uint32_t*) ALLOC(
 			sizeof(uint32_t) *
 			pEngine->dspPresetCount
 		);
@@ -1969,7 +4218,7 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 			pEngine->dspPresetCodes[i] = (uint32_t) (ptr - start);
 			pEngine->dspPresets[i].accessibility = read_u8(&ptr, se);
 			pEngine->dspPresets[i].parameterCount = read_u32(&ptr, se);
-			pEngine->dspPresets[i].parameters = (FACTDSPParameter*) pEngine->pMalloc(
+			pEngine->dspPresets[i].parameters = (FACTDSPParameter*) ALLOC(
 				sizeof(FACTDSPParameter) *
 				pEngine->dspPresets[i].parameterCount
 			); /* This will be filled in just a moment... */
@@ -2000,14 +4249,14 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 
 	/* Category Name data */
 	FAudio_assert((ptr - start) == categoryNameOffset);
-	pEngine->categoryNames = (char**) pEngine->pMalloc(
+	pEngine->categoryNames = (char**) ALLOC(
 		sizeof(char*) *
 		pEngine->categoryCount
 	);
 	for (i = 0; i < pEngine->categoryCount; i += 1)
 	{
 		memsize = FAudio_strlen((char*) ptr) + 1; /* Dastardly! */
-		pEngine->categoryNames[i] = (char*) pEngine->pMalloc(memsize);
+		pEngine->categoryNames[i] = (char*) ALLOC(memsize);
 		FAudio_memcpy(pEngine->categoryNames[i], ptr, memsize);
 		ptr += memsize;
 	}
@@ -2022,17 +4271,71 @@ uint32_t FACT_INTERNAL_ParseAudioEngine(
 
 	/* Variable Name data */
 	FAudio_assert((ptr - start) == variableNameOffset);
-	pEngine->variableNames = (char**) pEngine->pMalloc(
+	pEngine->variableNames = (char**) ALLOC(
 		sizeof(char*) *
 		pEngine->variableCount
 	);
 	for (i = 0; i < pEngine->variableCount; i += 1)
 	{
 		memsize = FAudio_strlen((char*) ptr) + 1; /* Dastardly! */
-		pEngine->variableNames[i] = (char*) pEngine->pMalloc(memsize);
+		pEngine->variableNames[i] = (char*) ALLOC(memsize);
 		FAudio_memcpy(pEngine->variableNames[i], ptr, memsize);
 		ptr += memsize;
+
+		/* Only Cue variables can be special */
+		pEngine->variables[i].special = VARIABLE_SPECIAL_NONE;
+		if (pEngine->variables[i].accessibility & 0x04)
+		{
+			if (FAudio_strcmp(pEngine->variableNames[i], "AttackTime") == 0)
+			{
+				pEngine->variables[i].special = VARIABLE_SPECIAL_ATTACKTIME;
+			}
+			else if (FAudio_strcmp(pEngine->variableNames[i], "ReleaseTime") == 0)
+			{
+				pEngine->variables[i].special = VARIABLE_SPECIAL_RELEASETIME;
+			}
+		}
+	}
+
+	/* Variable name lookups, one table each for global and Cue variables */
+	indices = (uint16_t*) pEngine->pMalloc(
+		sizeof(uint16_t) *
+		pEngine->variableCount
+	);
+	for (i = 0, j = 0; i < pEngine->variableCount; i += 1)
+	{
+		if (!(pEngine->variables[i].accessibility & 0x04))
+		{
+			indices[j] = i;
+			j += 1;
+		}
 	}
+	FACT_INTERNAL_BuildNameTable(
+		&pEngine->globalVariableTable,
+		pEngine->variableNames,
+		indices,
+		j,
+		&pEngine->arena,
+		pEngine->pMalloc
+	);
+	for (i = 0, j = 0; i < pEngine->variableCount; i += 1)
+	{
+		if (pEngine->variables[i].accessibility & 0x04)
+		{
+			indices[j] = i;
+			j += 1;
+		}
+	}
+	FACT_INTERNAL_BuildNameTable(
+		&pEngine->cueVariableTable,
+		pEngine->variableNames,
+		indices,
+		j,
+		&pEngine->arena,
+		pEngine->pMalloc
+	);
+	pEngine->pFree(indices);
+	#undef ALLOC
 
 	/* Finally. */
 	FAudio_assert((ptr - start) == pParams->globalSettingsBufferSize);
@@ -2043,6 +4346,7 @@ void FACT_INTERNAL_ParseTrackEvents(
 	uint8_t **ptr,
 	uint8_t se,
 	FACTTrack *track,
+	FACTArena *arena,
 	FAudioMallocFunc pMalloc
 ) {
 	uint32_t evtInfo;
@@ -2050,8 +4354,11 @@ void FACT_INTERNAL_ParseTrackEvents(
 	uint8_t i;
 	uint16_t j;
 
+	#define ALLOC(size) \
+		FACT_INTERNAL_ArenaAlloc(arena, size, pMalloc)
+
 	track->eventCount = read_u8(ptr, se);
-	track->events = (FACTEvent*) pMalloc(
+	track->events = (FACTEvent*) ALLOC(
 		sizeof(FACTEvent) *
 		track->eventCount
 	);
@@ -2099,15 +4406,15 @@ void FACT_INTERNAL_ParseTrackEvents(
 			track->events[i].wave.complex.trackCount = read_u16(ptr, se);
 			track->events[i].wave.complex.variation = read_u16(ptr, se);
 			*ptr += 4; /* Unknown values */
-			track->events[i].wave.complex.tracks = (uint16_t*) pMalloc(
+			track->events[i].wave.complex.tracks = (uint16_t*) ALLOC(
 				sizeof(uint16_t) *
 				track->events[i].wave.complex.trackCount
 			);
-			track->events[i].wave.complex.wavebanks = (uint8_t*) pMalloc(
+			track->events[i].wave.complex.wavebanks = (uint8_t*) ALLOC(
 				sizeof(uint8_t) *
 				track->events[i].wave.complex.trackCount
 			);
-			track->events[i].wave.complex.weights = (uint8_t*) pMalloc(
+			track->events[i].wave.complex.weights = (uint8_t*) ALLOC(
 				sizeof(uint8_t) *
 				track->events[i].wave.complex.trackCount
 			);
@@ -2171,15 +4478,15 @@ void FACT_INTERNAL_ParseTrackEvents(
 			track->events[i].wave.complex.trackCount = read_u16(ptr, se);
 			track->events[i].wave.complex.variation = read_u16(ptr, se);
 			*ptr += 4; /* Unknown values */
-			track->events[i].wave.complex.tracks = (uint16_t*) pMalloc(
+			track->events[i].wave.complex.tracks = (uint16_t*) ALLOC(
 				sizeof(uint16_t) *
 				track->events[i].wave.complex.trackCount
 			);
-			track->events[i].wave.complex.wavebanks = (uint8_t*) pMalloc(
+			track->events[i].wave.complex.wavebanks = (uint8_t*) ALLOC(
 				sizeof(uint8_t) *
 				track->events[i].wave.complex.trackCount
 			);
-			track->events[i].wave.complex.weights = (uint8_t*) pMalloc(
+			track->events[i].wave.complex.weights = (uint8_t*) ALLOC(
 				sizeof(uint8_t) *
 				track->events[i].wave.complex.trackCount
 			);
@@ -2250,12 +4557,326 @@ void FACT_INTERNAL_ParseTrackEvents(
 		}
 		#undef EVTTYPE
 	}
+	#undef ALLOC
+}
+
+/* Sounds are parsed with the rest of the SoundBank, or the first time they are
+ * used with FACT_FLAG_LAZY_SOUNDBANK_EXT. Returns the end of the Sound.
+ */
+static uint8_t* FACT_INTERNAL_ParseSound(
+	FACTSoundBank *sb,
+	FACTSound *sound,
+	uint8_t *ptr,
+	const uint8_t *start,
+	uint8_t se
+) {
+	FACTAudioEngine *pEngine = sb->parentEngine;
+	size_t memsize;
+	uint16_t j;
+	uint8_t k;
+	uint8_t *ptrBookmark;
+
+	#define ALLOC(size) \
+		FACT_INTERNAL_ArenaAlloc(&sb->arena, size, pEngine->pMalloc)
+
+	sound->flags = read_u8(&ptr, se);
+	sound->category = read_u16(&ptr, se);
+	sound->volume = read_volbyte(&ptr, se);
+	sound->pitch = read_s16(&ptr, se);
+	sound->priority = read_u8(&ptr, se);
+
+	/* Length of sound entry, unused */
+	ptr += 2;
+
+	/* Simple/Complex Track data */
+	if (sound->flags & 0x01)
+	{
+		sound->trackCount = read_u8(&ptr, se);
+		memsize = sizeof(FACTTrack) * sound->trackCount;
+		sound->tracks = (FACTTrack*) ALLOC(memsize);
+		FAudio_zero(sound->tracks, memsize);
+	}
+	else
+	{
+		sound->trackCount = 1;
+		memsize = sizeof(FACTTrack) * sound->trackCount;
+		sound->tracks = (FACTTrack*) ALLOC(memsize);
+		FAudio_zero(sound->tracks, memsize);
+		sound->tracks[0].volume = 0.0f;
+		sound->tracks[0].filter = 0xFF;
+		sound->tracks[0].eventCount = 1;
+		sound->tracks[0].events = (FACTEvent*) ALLOC(
+			sizeof(FACTEvent)
+		);
+		FAudio_zero(
+			sound->tracks[0].events,
+			sizeof(FACTEvent)
+		);
+		sound->tracks[0].events[0].type = FACTEVENT_PLAYWAVE;
+		sound->tracks[0].events[0].wave.position = 0; /* FIXME */
+		sound->tracks[0].events[0].wave.angle = 0; /* FIXME */
+		sound->tracks[0].events[0].wave.simple.track = read_u16(&ptr, se);
+		sound->tracks[0].events[0].wave.simple.wavebank = read_u8(&ptr, se);
+	}
+
+	/* RPC Code data */
+	if (sound->flags & 0x0E)
+	{
+		const uint16_t rpcDataLength = read_u16(&ptr, se);
+		ptrBookmark = ptr - 2;
+
+		#define COPYRPCBLOCK(loc) \
+			(loc)->rpcCount = read_u8(&ptr, se); \
+			(loc)->rpcIndices = (uint16_t*) ALLOC( \
+				sizeof(uint16_t) * (loc)->rpcCount \
+			); \
+			for (k = 0; k < (loc)->rpcCount; k += 1) \
+			{ \
+				(loc)->rpcIndices[k] = (uint16_t) ( \
+					FACT_INTERNAL_GetRPC( \
+						pEngine, \
+						read_u32(&ptr, se) \
+					) - pEngine->rpcs \
+				); \
+			}
+
+		/* Sound has attached RPCs */
+		if (sound->flags & 0x02)
+		{
+			COPYRPCBLOCK(sound)
+		}
+		else
+		{
+			sound->rpcCount = 0;
+			sound->rpcIndices = NULL;
+		}
+
+		/* Tracks have attached RPCs */
+		if (sound->flags & 0x04)
+		{
+			for (j = 0; j < sound->trackCount; j += 1)
+			{
+				COPYRPCBLOCK(&sound->tracks[j])
+			}
+		}
+		else
+		{
+			for (j = 0; j < sound->trackCount; j += 1)
+			{
+				sound->tracks[j].rpcCount = 0;
+				sound->tracks[j].rpcIndices = NULL;
+			}
+		}
+
+		#undef COPYRPCBLOCK
+
+		/* FIXME: Does 0x08 mean something for RPCs...? */
+		FAudio_assert((ptr - ptrBookmark) == rpcDataLength);
+	}
+	else
+	{
+		sound->rpcCount = 0;
+		sound->rpcIndices = NULL;
+		for (j = 0; j < sound->trackCount; j += 1)
+		{
+			sound->tracks[j].rpcCount = 0;
+			sound->tracks[j].rpcIndices = NULL;
+		}
+	}
+
+	/* DSP Preset Code data */
+	if (sound->flags & 0x10)
+	{
+		/* DSP presets length, unused */
+		ptr += 2;
+
+		sound->dspCodeCount = read_u8(&ptr, se);
+		memsize = sizeof(uint32_t) * sound->dspCodeCount;
+		sound->dspCodes = (uint32_t*) ALLOC(memsize);
+		FAudio_memcpy(sound->dspCodes, ptr, memsize);
+		ptr += memsize;
+	}
+	else
+	{
+		sound->dspCodeCount = 0;
+		sound->dspCodes = NULL;
+	}
+
+	/* Track data */
+	if (sound->flags & 0x01)
+	{
+		for (j = 0; j < sound->trackCount; j += 1)
+		{
+			sound->tracks[j].volume = read_volbyte(&ptr, se);
+
+			sound->tracks[j].code = read_u32(&ptr, se);
+
+			sound->tracks[j].filter = read_u8(&ptr, se);
+			if (sound->tracks[j].filter & 0x01)
+			{
+				sound->tracks[j].filter =
+					(sound->tracks[j].filter >> 1) & 0x02;
+			}
+			else
+			{
+				/* Huh...? */
+				sound->tracks[j].filter = 0xFF;
+			}
+
+			sound->tracks[j].qfactor = read_u8(&ptr, se);
+			sound->tracks[j].frequency = read_u16(&ptr, se);
+		}
+
+		/* All Track events are stored at the end of the block */
+		for (j = 0; j < sound->trackCount; j += 1)
+		{
+			FAudio_assert((ptr - start) == sound->tracks[j].code);
+			FACT_INTERNAL_ParseTrackEvents(
+				&ptr,
+				se,
+				&sound->tracks[j],
+				&sb->arena,
+				pEngine->pMalloc
+			);
+		}
+	}
+
+	memsize = (
+		sizeof(FACTSoundInstance) +
+		sizeof(FACTTrackInstance) * sound->trackCount
+	);
+	for (j = 0; j < sound->trackCount; j += 1)
+	{
+		memsize += sizeof(FACTEventInstance) * sound->tracks[j].eventCount;
+	}
+	sound->instanceSize = (uint32_t) memsize;
+	FACT_INTERNAL_GrowSoundPool(pEngine, memsize);
+
+	#undef ALLOC
+	return ptr;
+}
+
+FACTSound* FACT_INTERNAL_GetSound(FACTSoundBank *sb, uint32_t code)
+{
+	uint16_t lo = 0, hi = sb->soundCount, mid;
+
+	/* soundCodes is sorted, they are offsets into the file */
+	while (lo < hi)
+	{
+		mid = lo + (hi - lo) / 2;
+		if (sb->soundCodes[mid] < code)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	if (lo == sb->soundCount || sb->soundCodes[lo] != code)
+	{
+		FAudio_assert(0 && "Sound code not found!");
+		return NULL;
+	}
+
+	/* NULL tracks means nobody has touched this one yet */
+	if (sb->sounds[lo].tracks == NULL)
+	{
+		FACT_INTERNAL_ParseSound(
+			sb,
+			&sb->sounds[lo],
+			(uint8_t*) sb->data + code,
+			sb->data,
+			sb->swapEndian
+		);
+	}
+	return &sb->sounds[lo];
+}
+
+static int FACT_INTERNAL_CompareCodes(const void *a, const void *b)
+{
+	const uint32_t codeA = *((const uint32_t*) a);
+	const uint32_t codeB = *((const uint32_t*) b);
+	return (codeA > codeB) - (codeA < codeB);
+}
+
+/* Lazy SoundBanks only know about the Sounds their Cues and Variations point
+ * to, sorted by code, so GetSound can find them without parsing the others
+ */
+static void FACT_INTERNAL_IndexSounds(FACTSoundBank *sb)
+{
+	FACTAudioEngine *pEngine = sb->parentEngine;
+	uint32_t *codes;
+	uint32_t count, unique, i, j;
+
+	count = 0;
+	for (i = 0; i < sb->cueCount; i += 1)
+	{
+		count += (sb->cues[i].flags & 0x04) != 0;
+	}
+	for (i = 0; i < sb->variationCount; i += 1)
+	{
+		if (sb->variations[i].isComplex)
+		{
+			count += sb->variations[i].entryCount;
+		}
+	}
+
+	codes = (uint32_t*) pEngine->pMalloc(sizeof(uint32_t) * (count + 1));
+	count = 0;
+	for (i = 0; i < sb->cueCount; i += 1)
+	{
+		if (sb->cues[i].flags & 0x04)
+		{
+			codes[count] = sb->cues[i].sbCode;
+			count += 1;
+		}
+	}
+	for (i = 0; i < sb->variationCount; i += 1)
+	{
+		if (sb->variations[i].isComplex)
+		{
+			for (j = 0; j < sb->variations[i].entryCount; j += 1)
+			{
+				codes[count] = sb->variations[i].entries[j].soundCode;
+				count += 1;
+			}
+		}
+	}
+	FAudio_qsort(codes, count, sizeof(uint32_t), FACT_INTERNAL_CompareCodes);
+
+	unique = 0;
+	for (i = 0; i < count; i += 1)
+	{
+		if (unique == 0 || codes[i] != codes[unique - 1])
+		{
+			codes[unique] = codes[i];
+			unique += 1;
+		}
+	}
+
+	FAudio_assert(unique <= sb->soundCount);
+	sb->soundCount = (uint16_t) unique;
+	sb->soundCodes = (uint32_t*) FACT_INTERNAL_ArenaAlloc(
+		&sb->arena,
+		sizeof(uint32_t) * unique,
+		pEngine->pMalloc
+	);
+	FAudio_memcpy(sb->soundCodes, codes, sizeof(uint32_t) * unique);
+	sb->sounds = (FACTSound*) FACT_INTERNAL_ArenaAlloc(
+		&sb->arena,
+		sizeof(FACTSound) * unique,
+		pEngine->pMalloc
+	);
+	FAudio_zero(sb->sounds, sizeof(FACTSound) * unique);
+	pEngine->pFree(codes);
 }
 
 uint32_t FACT_INTERNAL_ParseSoundBank(
 	FACTAudioEngine *pEngine,
 	const void *pvBuffer,
 	uint32_t dwSize,
+	uint32_t dwFlags,
 	FACTSoundBank **ppSoundBank
 ) {
 	FACTSoundBank *sb;
@@ -2273,7 +4894,6 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 		soundOffset;
 	size_t memsize;
 	uint16_t i, j, cur;
-	uint8_t *ptrBookmark;
 
 	uint8_t *ptr = (uint8_t*) pvBuffer;
 	uint8_t *start = ptr;
@@ -2305,6 +4925,16 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 	sb->parentEngine = pEngine;
 	sb->cueList = NULL;
 	sb->notifyOnDestroy = 0;
+	sb->data = (const uint8_t*) pvBuffer;
+	sb->swapEndian = se;
+	sb->lazy = (dwFlags & FACT_FLAG_LAZY_SOUNDBANK_EXT) != 0;
+
+	/* Most of what we parse is bigger than it is in the file, but lazy
+	 * banks leave the biggest part, the Sounds, for later
+	 */
+	FACT_INTERNAL_InitArena(&sb->arena, sb->lazy ? dwSize : dwSize * 4);
+	#define ALLOC(size) \
+		FACT_INTERNAL_ArenaAlloc(&sb->arena, size, pEngine->pMalloc)
 
 	cueSimpleCount = read_u16(&ptr, se);
 	cueComplexCount = read_u16(&ptr, se);
@@ -2336,195 +4966,72 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 
 	/* SoundBank Name */
 	memsize = FAudio_strlen((char*) ptr) + 1; /* Dastardly! */
-	sb->name = (char*) pEngine->pMalloc(memsize);
+	sb->name = (char*) ALLOC(memsize);
 	FAudio_memcpy(sb->name, ptr, memsize);
 	ptr += 64;
 
 	/* WaveBank Name data */
 	FAudio_assert((ptr - start) == wavebankNameOffset);
-	sb->wavebankNames = (char**) pEngine->pMalloc(
+	sb->wavebankNames = (char**) ALLOC(
 		sizeof(char*) *
 		sb->wavebankCount
 	);
 	for (i = 0; i < sb->wavebankCount; i += 1)
 	{
 		memsize = FAudio_strlen((char*) ptr) + 1;
-		sb->wavebankNames[i] = (char*) pEngine->pMalloc(memsize);
+		sb->wavebankNames[i] = (char*) ALLOC(memsize);
 		FAudio_memcpy(sb->wavebankNames[i], ptr, memsize);
 		ptr += 64;
 	}
+	memsize = sizeof(FACTWaveBank*) * sb->wavebankCount;
+	sb->wavebanks = (FACTWaveBank**) ALLOC(memsize);
+	FAudio_zero(sb->wavebanks, memsize);
 
 	/* Sound data */
 	FAudio_assert((ptr - start) == soundOffset);
-	sb->sounds = (FACTSound*) pEngine->pMalloc(
-		sizeof(FACTSound) *
-		sb->soundCount
-	);
-	sb->soundCodes = (uint32_t*) pEngine->pMalloc(
-		sizeof(uint32_t) *
-		sb->soundCount
-	);
-	for (i = 0; i < sb->soundCount; i += 1)
+	if (sb->lazy)
 	{
-		sb->soundCodes[i] = (uint32_t) (ptr - start);
-		sb->sounds[i].flags = read_u8(&ptr, se);
-		sb->sounds[i].category = read_u16(&ptr, se);
-		sb->sounds[i].volume = read_volbyte(&ptr, se);
-		sb->sounds[i].pitch = read_s16(&ptr, se);
-		sb->sounds[i].priority = read_u8(&ptr, se);
-
-		/* Length of sound entry, unused */
-		ptr += 2;
-
-		/* Simple/Complex Track data */
-		if (sb->sounds[i].flags & 0x01)
-		{
-			sb->sounds[i].trackCount = read_u8(&ptr, se);
-			memsize = sizeof(FACTTrack) * sb->sounds[i].trackCount;
-			sb->sounds[i].tracks = (FACTTrack*) pEngine->pMalloc(memsize);
-			FAudio_zero(sb->sounds[i].tracks, memsize);
-		}
-		else
-		{
-			sb->sounds[i].trackCount = 1;
-			memsize = sizeof(FACTTrack) * sb->sounds[i].trackCount;
-			sb->sounds[i].tracks = (FACTTrack*) pEngine->pMalloc(memsize);
-			FAudio_zero(sb->sounds[i].tracks, memsize);
-			sb->sounds[i].tracks[0].volume = 0.0f;
-			sb->sounds[i].tracks[0].filter = 0xFF;
-			sb->sounds[i].tracks[0].eventCount = 1;
-			sb->sounds[i].tracks[0].events = (FACTEvent*) pEngine->pMalloc(
-				sizeof(FACTEvent)
-			);
-			FAudio_zero(
-				sb->sounds[i].tracks[0].events,
-				sizeof(FACTEvent)
-			);
-			sb->sounds[i].tracks[0].events[0].type = FACTEVENT_PLAYWAVE;
-			sb->sounds[i].tracks[0].events[0].wave.position = 0; /* FIXME */
-			sb->sounds[i].tracks[0].events[0].wave.angle = 0; /* FIXME */
-			sb->sounds[i].tracks[0].events[0].wave.simple.track = read_u16(&ptr, se);
-			sb->sounds[i].tracks[0].events[0].wave.simple.wavebank = read_u8(&ptr, se);
-		}
-
-		/* RPC Code data */
-		if (sb->sounds[i].flags & 0x0E)
-		{
-			const uint16_t rpcDataLength = read_u16(&ptr, se);
-			ptrBookmark = ptr - 2;
-
-			#define COPYRPCBLOCK(loc) \
-				loc.rpcCodeCount = read_u8(&ptr, se); \
-				memsize = sizeof(uint32_t) * loc.rpcCodeCount; \
-				loc.rpcCodes = (uint32_t*) pEngine->pMalloc(memsize); \
-				FAudio_memcpy(loc.rpcCodes, ptr, memsize); \
-				ptr += memsize;
-
-			/* Sound has attached RPCs */
-			if (sb->sounds[i].flags & 0x02)
-			{
-				COPYRPCBLOCK(sb->sounds[i])
-			}
-			else
-			{
-				sb->sounds[i].rpcCodeCount = 0;
-				sb->sounds[i].rpcCodes = NULL;
-			}
-
-			/* Tracks have attached RPCs */
-			if (sb->sounds[i].flags & 0x04)
-			{
-				for (j = 0; j < sb->sounds[i].trackCount; j += 1)
-				{
-					COPYRPCBLOCK(sb->sounds[i].tracks[j])
-				}
-			}
-			else
-			{
-				for (j = 0; j < sb->sounds[i].trackCount; j += 1)
-				{
-					sb->sounds[i].tracks[j].rpcCodeCount = 0;
-					sb->sounds[i].tracks[j].rpcCodes = NULL;
-				}
-			}
-
-			#undef COPYRPCBLOCK
-
-			/* FIXME: Does 0x08 mean something for RPCs...? */
-			FAudio_assert((ptr - ptrBookmark) == rpcDataLength);
-		}
-		else
+		/* Skip to the Cues, IndexSounds finds the Sounds later */
+		if (cueSimpleCount > 0)
 		{
-			sb->sounds[i].rpcCodeCount = 0;
-			sb->sounds[i].rpcCodes = NULL;
-			for (j = 0; j < sb->sounds[i].trackCount; j += 1)
-			{
-				sb->sounds[i].tracks[j].rpcCodeCount = 0;
-				sb->sounds[i].tracks[j].rpcCodes = NULL;
-			}
+			ptr = start + cueSimpleOffset;
 		}
-
-		/* DSP Preset Code data */
-		if (sb->sounds[i].flags & 0x10)
+		else if (cueComplexCount > 0)
 		{
-			/* DSP presets length, unused */
-			ptr += 2;
-
-			sb->sounds[i].dspCodeCount = read_u8(&ptr, se);
-			memsize = sizeof(uint32_t) * sb->sounds[i].dspCodeCount;
-			sb->sounds[i].dspCodes = (uint32_t*) pEngine->pMalloc(memsize);
-			FAudio_memcpy(sb->sounds[i].dspCodes, ptr, memsize);
-			ptr += memsize;
+			ptr = start + cueComplexOffset;
 		}
 		else
 		{
-			sb->sounds[i].dspCodeCount = 0;
-			sb->sounds[i].dspCodes = NULL;
+			ptr = start + cueHashOffset;
 		}
-
-		/* Track data */
-		if (sb->sounds[i].flags & 0x01)
+	}
+	else
+	{
+		sb->sounds = (FACTSound*) ALLOC(
+			sizeof(FACTSound) *
+			sb->soundCount
+		);
+		sb->soundCodes = (uint32_t*) ALLOC(
+			sizeof(uint32_t) *
+			sb->soundCount
+		);
+		for (i = 0; i < sb->soundCount; i += 1)
 		{
-			for (j = 0; j < sb->sounds[i].trackCount; j += 1)
-			{
-				sb->sounds[i].tracks[j].volume = read_volbyte(&ptr, se);
-
-				sb->sounds[i].tracks[j].code = read_u32(&ptr, se);
-
-				sb->sounds[i].tracks[j].filter = read_u8(&ptr, se);
-				if (sb->sounds[i].tracks[j].filter & 0x01)
-				{
-					sb->sounds[i].tracks[j].filter =
-						(sb->sounds[i].tracks[j].filter >> 1) & 0x02;
-				}
-				else
-				{
-					/* Huh...? */
-					sb->sounds[i].tracks[j].filter = 0xFF;
-				}
-
-				sb->sounds[i].tracks[j].qfactor = read_u8(&ptr, se);
-				sb->sounds[i].tracks[j].frequency = read_u16(&ptr, se);
-			}
-
-			/* All Track events are stored at the end of the block */
-			for (j = 0; j < sb->sounds[i].trackCount; j += 1)
-			{
-				FAudio_assert((ptr - start) == sb->sounds[i].tracks[j].code);
-				FACT_INTERNAL_ParseTrackEvents(
-					&ptr,
-					se,
-					&sb->sounds[i].tracks[j],
-					pEngine->pMalloc
-				);
-			}
+			sb->soundCodes[i] = (uint32_t) (ptr - start);
+			ptr = FACT_INTERNAL_ParseSound(
+				sb,
+				&sb->sounds[i],
+				ptr,
+				start,
+				se
+			);
 		}
 	}
 
 	/* All Cue data */
 	sb->variationCount = 0;
 	sb->transitionCount = 0;
-	sb->cues = (FACTCueData*) pEngine->pMalloc(
+	sb->cues = (FACTCueData*) ALLOC(
 		sizeof(FACTCueData) *
 		sb->cueCount
 	);
@@ -2578,11 +5085,11 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 	if (sb->variationCount > 0)
 	{
 		FAudio_assert((ptr - start) == variationOffset);
-		sb->variations = (FACTVariationTable*) pEngine->pMalloc(
+		sb->variations = (FACTVariationTable*) ALLOC(
 			sizeof(FACTVariationTable) *
 			sb->variationCount
 		);
-		sb->variationCodes = (uint32_t*) pEngine->pMalloc(
+		sb->variationCodes = (uint32_t*) ALLOC(
 			sizeof(uint32_t) *
 			sb->variationCount
 		);
@@ -2600,7 +5107,7 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 		ptr += 2; /* Unknown value */
 		sb->variations[i].variable = read_s16(&ptr, se);
 		memsize = sizeof(FACTVariation) * sb->variations[i].entryCount;
-		sb->variations[i].entries = (FACTVariation*) pEngine->pMalloc(
+		sb->variations[i].entries = (FACTVariation*) ALLOC(
 			memsize
 		);
 		FAudio_zero(sb->variations[i].entries, memsize);
@@ -2662,11 +5169,11 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 	if (sb->transitionCount > 0)
 	{
 		FAudio_assert((ptr - start) == transitionOffset);
-		sb->transitions = (FACTTransitionTable*) pEngine->pMalloc(
+		sb->transitions = (FACTTransitionTable*) ALLOC(
 			sizeof(FACTTransitionTable) *
 			sb->transitionCount
 		);
-		sb->transitionCodes = (uint32_t*) pEngine->pMalloc(
+		sb->transitionCodes = (uint32_t*) ALLOC(
 			sizeof(uint32_t) *
 			sb->transitionCount
 		);
@@ -2681,7 +5188,7 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 		sb->transitionCodes[i] = (uint32_t) (ptr - start);
 		sb->transitions[i].entryCount = read_u32(&ptr, se);
 		memsize = sizeof(FACTTransition) * sb->transitions[i].entryCount;
-		sb->transitions[i].entries = (FACTTransition*) pEngine->pMalloc(
+		sb->transitions[i].entries = (FACTTransition*) ALLOC(
 			memsize
 		);
 		FAudio_zero(sb->transitions[i].entries, memsize);
@@ -2698,6 +5205,11 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 		}
 	}
 
+	if (sb->lazy)
+	{
+		FACT_INTERNAL_IndexSounds(sb);
+	}
+
 	/* Cue Hash data? No idea what this is... */
 	FAudio_assert((ptr - start) == cueHashOffset);
 	ptr += 2 * cueTotalAlign;
@@ -2708,17 +5220,26 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 
 	/* Cue Name data */
 	FAudio_assert((ptr - start) == cueNameOffset);
-	sb->cueNames = (char**) pEngine->pMalloc(
+	sb->cueNames = (char**) ALLOC(
 		sizeof(char*) *
 		sb->cueCount
 	);
 	for (i = 0; i < sb->cueCount; i += 1)
 	{
 		memsize = FAudio_strlen((char*) ptr) + 1;
-		sb->cueNames[i] = (char*) pEngine->pMalloc(memsize);
+		sb->cueNames[i] = (char*) ALLOC(memsize);
 		FAudio_memcpy(sb->cueNames[i], ptr, memsize);
 		ptr += memsize;
 	}
+	FACT_INTERNAL_BuildNameTable(
+		&sb->cueTable,
+		sb->cueNames,
+		NULL,
+		sb->cueCount,
+		&sb->arena,
+		pEngine->pMalloc
+	);
+	#undef ALLOC
 
 	/* Add to the Engine SoundBank list */
 	LinkedList_AddEntry(
@@ -2760,21 +5281,23 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 	FACTWaveBankData wbinfo;
 	uint32_t compactEntry;
 	int32_t seekTableOffset;
-	FACTOverlapped ovlp;
+	FACTReadCache cache;
+	uint32_t pos;
 	uint32_t read;
 
-	ovlp.Internal = NULL;
-	ovlp.InternalHigh = NULL;
-	ovlp.OffsetHigh = 0; /* I sure hope so... */
-	ovlp.hEvent = NULL;
+	cache.io = io;
+	cache.pRead = pRead;
+	cache.pOverlap = pOverlap;
+	cache.data = (uint8_t*) pEngine->pMalloc(FACT_READ_CACHE_SIZE);
+	cache.offset = 0;
+	cache.size = 0;
 
 	#define SEEKSET(loc) \
-		ovlp.Offset = offset + loc;
+		pos = offset + loc;
 	#define SEEKCUR(loc) \
-		ovlp.Offset += loc;
+		pos += loc;
 	#define READ(dst, size) \
-		pRead(io, dst, size, NULL, &ovlp); \
-		pOverlap(io, &ovlp, &read, 1); \
+		read = FACT_INTERNAL_ReadCached(&cache, dst, pos, size); \
 		SEEKCUR(read)
 
 	SEEKSET(0)
@@ -2795,6 +5318,7 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 		header.dwVersion != FACT_CONTENT_VERSION ||
 		header.dwHeaderVersion != 44	)
 	{
+		pEngine->pFree(cache.data);
 		return -1; /* TODO: NOT XACT FILE */
 	}
 
@@ -2804,6 +5328,18 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 	wb->waveLock = FAudio_PlatformCreateMutex();
 	wb->io = io;
 	wb->notifyOnDestroy = 0;
+	wb->packetSize = 0;
+	wb->prefetch = 0;
+	wb->transcodes = NULL;
+	wb->transcodeLimit = 0;
+	wb->transcodeBytes = 0;
+	wb->transcodeClock = 0;
+	wb->transcodePending = 0;
+	wb->transcodeLinked = 0;
+	wb->transcodeBusy = 0;
+	wb->transcodeWaiting = 0;
+	wb->transcodeNext = NULL;
+	FAudio_zero(&wb->stats, sizeof(FACTWaveBankStatsEXT));
 
 	/* WaveBank Data */
 	SEEKSET(header.Segments[FACT_WAVEBANK_SEGIDX_BANKDATA].dwOffset)
@@ -2819,15 +5355,31 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 		DOSWAP_64(wbinfo.BuildTime);
 	}
 	wb->streaming = (wbinfo.dwFlags & FACT_WAVEBANK_TYPE_STREAMING);
+	wb->alignment = wbinfo.dwAlignment;
 	wb->entryCount = wbinfo.dwEntryCount;
+	FACT_INTERNAL_InitArena(
+		&wb->arena,
+		wbinfo.dwEntryCount * (
+			sizeof(FACTWaveBankEntry) +
+			sizeof(uint32_t) + /* entryRefs */
+			sizeof(FACTSeekTable) +
+			sizeof(char*) + wbinfo.dwEntryNameElementSize + 1 +
+			sizeof(uint16_t) * 4 + /* entryTable */
+			FACT_ARENA_ALIGN * 2
+		) +
+		header.Segments[FACT_WAVEBANK_SEGIDX_SEEKTABLES].dwLength +
+		sizeof(wbinfo.szBankName)
+	);
+	#define ALLOC(size) \
+		FACT_INTERNAL_ArenaAlloc(&wb->arena, size, pEngine->pMalloc)
 	memsize = FAudio_strlen(wbinfo.szBankName) + 1;
-	wb->name = (char*) pEngine->pMalloc(memsize);
+	wb->name = (char*) ALLOC(memsize);
 	FAudio_memcpy(wb->name, wbinfo.szBankName, memsize);
 	memsize = sizeof(FACTWaveBankEntry) * wbinfo.dwEntryCount;
-	wb->entries = (FACTWaveBankEntry*) pEngine->pMalloc(memsize);
+	wb->entries = (FACTWaveBankEntry*) ALLOC(memsize);
 	FAudio_zero(wb->entries, memsize);
 	memsize = sizeof(uint32_t) * wbinfo.dwEntryCount;
-	wb->entryRefs = (uint32_t*) pEngine->pMalloc(memsize);
+	wb->entryRefs = (uint32_t*) ALLOC(memsize);
 	FAudio_zero(wb->entryRefs, memsize);
 
 	/* FIXME: How much do we care about this? */
@@ -2918,7 +5470,7 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 		header.Segments[FACT_WAVEBANK_SEGIDX_SEEKTABLES].dwLength > 0	)
 	{
 		/* The seek table data layout is an absolute disaster! */
-		wb->seekTables = (FACTSeekTable*) pEngine->pMalloc(
+		wb->seekTables = (FACTSeekTable*) ALLOC(
 			wbinfo.dwEntryCount * sizeof(FACTSeekTable)
 		);
 		for (i = 0; i < wbinfo.dwEntryCount; i += 1)
@@ -2955,7 +5507,7 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 			{
 				DOSWAP_32(wb->seekTables[i].entryCount);
 			}
-			wb->seekTables[i].entries = (uint32_t*) pEngine->pMalloc(
+			wb->seekTables[i].entries = (uint32_t*) ALLOC(
 				wb->seekTables[i].entryCount * sizeof(uint32_t)
 			);
 			READ(
@@ -2976,12 +5528,50 @@ uint32_t FACT_INTERNAL_ParseWaveBank(
 		wb->seekTables = NULL;
 	}
 
-	/* TODO: WaveBank Entry Names
-	if (wbinfo.dwFlags & FACT_WAVEBANK_FLAGS_ENTRYNAMES)
+	/* WaveBank Entry Names */
+	if (	wbinfo.dwFlags & FACT_WAVEBANK_FLAGS_ENTRYNAMES &&
+		wbinfo.dwEntryNameElementSize > 0 &&
+		wbinfo.dwEntryCount < FACTINDEX_INVALID	)
 	{
 		SEEKSET(header.Segments[FACT_WAVEBANK_SEGIDX_ENTRYNAMES].dwOffset)
+
+		/* Fixed-size records that may use every byte, so the strings
+		 * get their own terminators, after the pointers in one block
+		 */
+		memsize = wbinfo.dwEntryNameElementSize + 1;
+		wb->entryNames = (char**) ALLOC(
+			(sizeof(char*) + memsize) * wbinfo.dwEntryCount
+		);
+		for (i = 0; i < wbinfo.dwEntryCount; i += 1)
+		{
+			wb->entryNames[i] = (
+				(char*) (wb->entryNames + wbinfo.dwEntryCount) +
+				memsize * i
+			);
+			READ(wb->entryNames[i], wbinfo.dwEntryNameElementSize)
+			wb->entryNames[i][wbinfo.dwEntryNameElementSize] = '\0';
+		}
+		FACT_INTERNAL_BuildNameTable(
+			&wb->entryTable,
+			wb->entryNames,
+			NULL,
+			(uint16_t) wbinfo.dwEntryCount,
+			&wb->arena,
+			pEngine->pMalloc
+		);
 	}
-	*/
+	else
+	{
+		wb->entryNames = NULL;
+		wb->entryTable.slots = NULL;
+		wb->entryTable.mask = 0;
+	}
+
+	#undef SEEKSET
+	#undef SEEKCUR
+	#undef READ
+	#undef ALLOC
+	pEngine->pFree(cache.data);
 
 	/* Add to the Engine WaveBank list */
 	LinkedList_AddEntry(
@@ -44,12 +44,50 @@ typedef struct FACTAudioCategory
 	float currentVolume;
 } FACTAudioCategory;
 
+/* Open addressing, so that duplicate names find the first one like a linear
+ * search would. Slots hold the name's index plus one, 0 is an empty slot.
+ */
+typedef struct FACTNameTable
+{
+	uint16_t *slots;
+	uint32_t mask;
+} FACTNameTable;
+
+/* Everything parsed out of a bank is allocated together and freed together.
+ * The first block is sized from the file, so most banks fit in one, and any
+ * further blocks double in size.
+ */
+typedef struct FACTArenaBlock FACTArenaBlock;
+
+struct FACTArenaBlock
+{
+	FACTArenaBlock *next;
+	size_t size;
+	size_t used;
+};
+
+typedef struct FACTArena
+{
+	FACTArenaBlock *blocks;
+	size_t blockSize;
+} FACTArena;
+
+typedef enum FACTVariableSpecial
+{
+	VARIABLE_SPECIAL_NONE,
+	VARIABLE_SPECIAL_ATTACKTIME,
+	VARIABLE_SPECIAL_RELEASETIME
+} FACTVariableSpecial;
+
 typedef struct FACTVariable
 {
 	uint8_t accessibility;
 	float initialValue;
 	float minValue;
 	float maxValue;
+
+	/* Cue variables the engine computes, found by name at parse time */
+	uint8_t special; /* FACTVariableSpecial */
 } FACTVariable;
 
 typedef struct FACTRPCPoint
@@ -57,6 +95,9 @@ typedef struct FACTRPCPoint
 	float x;
 	float y;
 	uint8_t type;
+
+	/* Of the line to the next point, 0 for the last one */
+	float slope;
 } FACTRPCPoint;
 
 typedef enum FACTRPCParameter
@@ -202,8 +243,9 @@ typedef struct FACTTrack
 	uint8_t qfactor;
 	uint16_t frequency;
 
-	uint8_t rpcCodeCount;
-	uint32_t *rpcCodes;
+	/* Indices into engine->rpcs, resolved from the codes at parse time */
+	uint8_t rpcCount;
+	uint16_t *rpcIndices;
 
 	uint8_t eventCount;
 	FACTEvent *events;
@@ -218,12 +260,15 @@ typedef struct FACTSound
 	uint8_t priority;
 
 	uint8_t trackCount;
-	uint8_t rpcCodeCount;
+	uint8_t rpcCount;
 	uint8_t dspCodeCount;
 
 	FACTTrack *tracks;
-	uint32_t *rpcCodes;
+	uint16_t *rpcIndices; /* See FACTTrack.rpcIndices */
 	uint32_t *dspCodes;
+
+	/* FACTSoundInstance, then its tracks, then every track's events */
+	uint32_t instanceSize;
 } FACTSound;
 
 typedef struct FACTCueData
@@ -358,6 +403,17 @@ typedef struct FACTSoundInstance
 	FACTCue *parentCue;
 } FACTSoundInstance;
 
+/* Sound instances are allocated whole, tracks and events included, from slots
+ * big enough for the largest Sound parsed so far. Freed slots are kept until
+ * ShutDown, or until a bigger Sound is parsed.
+ */
+typedef struct FACTSoundSlot FACTSoundSlot;
+struct FACTSoundSlot
+{
+	FACTSoundSlot *next;
+	size_t size;
+};
+
 /* Internal Wave Types */
 
 typedef struct FACTWaveCallback
@@ -366,6 +422,129 @@ typedef struct FACTWaveCallback
 	FACTWave *wave;
 } FACTWaveCallback;
 
+/* Source voices outlive their Waves, so that FACTWaveBank_Prepare can reuse
+ * them. The callback belongs to the voice and points at its current Wave.
+ */
+typedef struct FACTPooledVoice FACTPooledVoice;
+struct FACTPooledVoice
+{
+	FAudioSourceVoice *voice;
+	FACTWaveCallback callback;
+	FAudioADPCMWaveFormat format;
+	FACTPooledVoice *next;
+};
+
+#define FACT_VOICE_POOL_DEFAULT_LIMIT 32
+
+/* One playing Wave competing for the voice budget, see
+ * FACT_INTERNAL_UpdateVoiceBudget
+ */
+typedef struct FACTBudgetEntry
+{
+	FACTWave *wave;
+	uint8_t priority;
+	float volume;
+} FACTBudgetEntry;
+
+/* At FAUDIO_GOVERNOR_VIRTUALIZE_EXT, this share of the Waves that can be made
+ * virtual are, lowest priority first
+ */
+#define FACT_GOVERNOR_SHED_DIVISOR 4
+
+/* Streaming Waves read ahead on the engine's streaming thread, so the voice
+ * callbacks never touch the disk. Buffers go FREE -> READING -> READY ->
+ * QUEUED -> FREE, and are submitted in the order they were read.
+ */
+#define FACT_STREAM_BUFFER_COUNT 3
+#define FACT_STREAM_SECTOR_SIZE 2048
+#define FACT_STREAM_DEADLINE_US 50000	/* Per read, on a task pool */
+
+typedef enum FACTStreamBufferState
+{
+	FACT_STREAM_BUFFER_FREE,
+	FACT_STREAM_BUFFER_READING,
+	FACT_STREAM_BUFFER_READY,
+	FACT_STREAM_BUFFER_QUEUED
+} FACTStreamBufferState;
+
+typedef struct FACTStreamBuffer
+{
+	uint8_t *data;
+	uint32_t offset;
+	uint32_t size;
+	uint32_t flags;
+	uint8_t state;
+
+	/* Samples to skip and play, for chunks that don't start or end on a
+	 * packet boundary. Only used for xWMA/XMA2, other formats are read in
+	 * whole frames or blocks.
+	 */
+	uint32_t playBegin;
+	uint32_t playLength;
+
+	/* xWMA/XMA2 chunks get their own slice of the seek table */
+	uint32_t *decodedBytes;
+	uint32_t packetCount;
+} FACTStreamBuffer;
+
+typedef struct FACTStream FACTStream;
+struct FACTStream
+{
+	FACTWave *wave;
+	FACTStream *next;
+	uint8_t linked;
+	uint8_t busy; /* Streaming thread is reading into this stream */
+	uint8_t waiting; /* FACT_INTERNAL_DestroyStream wants busy cleared */
+
+	FACTStreamBuffer buffers[FACT_STREAM_BUFFER_COUNT];
+	uint8_t bufferCount;
+	uint8_t nextRead;
+	uint8_t nextSubmit;
+	uint32_t bufferSize;
+	uint32_t packetAlign; /* xWMA/XMA2 packet size, 0 if not chunked */
+
+	/* Where the next read starts, from the start of the PlayRegion */
+	uint32_t readOffset;
+	uint32_t readSample;
+	uint32_t passEnd; /* The sample this pass through the Wave stops at */
+	uint8_t done;
+
+	uint32_t begin;
+	uint32_t length;
+	uint32_t duration;
+	uint32_t loopBegin;
+	uint32_t loopEnd;
+	uint8_t loopCount;
+	FAudioADPCMWaveFormat format;
+};
+
+/* ADPCM Waves of a transcoded WaveBank play as PCM16 once the streaming
+ * thread has decoded them, see TranscodeEXT. Entries go NONE -> QUEUED ->
+ * BUSY -> READY, and back to NONE when evicted. All of it is under the
+ * engine's streamLock, except that the thread decodes with it released.
+ */
+#define FACT_TRANSCODE_STEP_BLOCKS 64	/* Decoded between stream reads */
+
+typedef enum FACTTranscodeState
+{
+	FACT_TRANSCODE_NONE,
+	FACT_TRANSCODE_QUEUED,
+	FACT_TRANSCODE_BUSY,
+	FACT_TRANSCODE_READY
+} FACTTranscodeState;
+
+typedef struct FACTTranscode
+{
+	uint8_t selected; /* By the policy, or this is always NONE */
+	uint8_t state;
+	uint32_t blockCount;
+	uint32_t nextBlock;
+	uint32_t bytes;
+	int16_t *pcm;
+	uint32_t refs; /* Waves playing the PCM, which can't be evicted */
+	uint32_t lastUsed; /* From the WaveBank's transcodeClock */
+} FACTTranscode;
+
 /* Public XACT Types */
 
 struct FACTAudioEngine
@@ -381,8 +560,13 @@ struct FACTAudioEngine
 	uint16_t dspPresetCount;
 	uint16_t dspParameterCount;
 
+	/* Everything ParseAudioEngine allocates */
+	FACTArena arena;
+
 	char **categoryNames;
 	char **variableNames;
+	FACTNameTable globalVariableTable;
+	FACTNameTable cueVariableTable;
 	uint32_t *rpcCodes;
 	uint32_t *dspPresetCodes;
 
@@ -394,6 +578,7 @@ struct FACTAudioEngine
 	/* Engine references */
 	LinkedList *sbList;
 	LinkedList *wbList;
+	FACTCue *activeCues;
 	FAudioMutex sbLock;
 	FAudioMutex wbLock;
 	float *globalVariableValues;
@@ -403,10 +588,61 @@ struct FACTAudioEngine
 	FAudioMasteringVoice *master;
 	FAudioSubmixVoice *reverbVoice;
 
+	/* Stopped source voices, newest first, see FACT_INTERNAL_AcquireVoice */
+	FACTPooledVoice *idleVoices;
+	uint32_t idleVoiceCount;
+	uint32_t maxIdleVoices;
+
+	/* Freed Sound instances, see FACT_INTERNAL_AllocSound */
+	FACTSoundSlot *idleSounds;
+	size_t soundSlotSize;
+
+	/* Playing Waves over this many are made virtual, 0 for no limit */
+	uint32_t maxAudibleWaves;
+	uint32_t virtualWaveCount;
+	FACTBudgetEntry *budget;
+	uint32_t budgetCapacity;
+
+	/* FACTAudioEngine_GetStatsEXT. The engine thread fills in the tick's
+	 * figures under apiLock, LateStreamBuffers is counted under streamLock.
+	 */
+	FACTEngineStatsEXT stats;
+	uint32_t rpcEvaluations; /* Since the last tick */
+	uint32_t activeVoiceCount; /* Pooled voices that belong to a Wave */
+
+	/* Task pool, kept through ShutDown. With one, the engine and streaming
+	 * threads are loops on the pool instead.
+	 */
+	FAudioTaskPoolEXT *taskPool;
+	FAudioPoolLoop apiLoop;
+	FAudioPoolLoop streamLoop;
+
 	/* Engine thread */
 	FAudioThread apiThread;
 	FAudioMutex apiLock;
+	FAudioSemaphore apiWake;
+	volatile int32_t wakePosted;
 	uint8_t initialized;
+	uint32_t creationFlags;
+
+	/* Whether DoWork commits FACT3DApply's changes; until then the
+	 * engine thread does
+	 */
+	uint8_t frameCommits;
+
+	/* Streaming thread, created with the first streaming Wave */
+	FAudioThread streamThread;
+	FAudioMutex streamLock;
+	FAudioSemaphore streamWake;
+	FAudioSemaphore streamDone;
+	FACTStream *streams;
+	uint8_t streamQuit;
+
+	/* WaveBanks with Waves left to transcode, under streamLock */
+	FACTWaveBank *transcodeBanks;
+
+	/* FACT_THREAD_*_EXT, kept through ShutDown like the limits above */
+	FAudioThreadSchedule threadSchedules[2];
 
 	/* Allocator callbacks */
 	FAudioMallocFunc pMalloc;
@@ -421,6 +657,9 @@ struct FACTSoundBank
 	FACTCue *cueList;
 	uint8_t notifyOnDestroy;
 
+	/* Everything ParseSoundBank allocates */
+	FACTArena arena;
+
 	/* Array sizes */
 	uint16_t cueCount;
 	uint8_t wavebankCount;
@@ -431,6 +670,18 @@ struct FACTSoundBank
 	/* Strings, strings everywhere! */
 	char **wavebankNames;
 	char **cueNames;
+	FACTNameTable cueTable;
+
+	/* Resolved from wavebankNames as they are needed, see GetWaveBank */
+	FACTWaveBank **wavebanks;
+
+	/* Kept for FACT_FLAG_LAZY_SOUNDBANK_EXT, which parses Sounds as they
+	 * are first used. Lazy banks only have the Sounds that Cues and
+	 * Variations point to, so soundCount may be less than the file's.
+	 */
+	const uint8_t *data;
+	uint8_t swapEndian;
+	uint8_t lazy;
 
 	/* Actual SoundBank information */
 	char *name;
@@ -453,14 +704,38 @@ struct FACTWaveBank
 
 	/* Actual WaveBank information */
 	char *name;
+	/* Everything ParseWaveBank allocates */
+	FACTArena arena;
+
 	uint32_t entryCount;
 	FACTWaveBankEntry *entries;
+	char **entryNames; /* NULL without FACT_WAVEBANK_FLAGS_ENTRYNAMES */
+	FACTNameTable entryTable;
 	uint32_t *entryRefs;
 	FACTSeekTable *seekTables;
 
 	/* I/O information */
 	uint16_t streaming;
+	uint16_t packetSize; /* In sectors, from FACTStreamingParameters */
+	uint32_t alignment;
+	uint8_t prefetch; /* FACT_FLAG_PREFETCH_WAVES_EXT */
 	void* io;
+
+	/* TranscodeEXT, NULL unless created with a policy. The rest is
+	 * under the engine's streamLock.
+	 */
+	FACTTranscode *transcodes;
+	uint32_t transcodeLimit;
+	uint32_t transcodeBytes;
+	uint32_t transcodeClock;
+	uint32_t transcodePending; /* QUEUED or BUSY */
+	uint8_t transcodeLinked;
+	uint8_t transcodeBusy; /* The streaming thread is decoding for us */
+	uint8_t transcodeWaiting; /* FACTWaveBank_Destroy wants busy cleared */
+	FACTWaveBank *transcodeNext;
+
+	/* FACTWaveBank_GetStatsEXT, streaming only, under streamLock */
+	FACTWaveBankStatsEXT stats;
 };
 
 struct FACTWave
@@ -477,15 +752,27 @@ struct FACTWave
 	int16_t pitch;
 	uint8_t loopCount;
 
-	/* Stream data */
-	uint32_t streamSize;
-	uint32_t streamOffset;
-	uint8_t *streamCache;
+	/* Virtual Waves keep their place without a voice playing them. The
+	 * position is in samples, the rest is the buffer they started with.
+	 */
+	uint8_t virtualized;
+	uint8_t virtualLoops;
+	uint32_t virtualTime;
+	double virtualPosition;
+	uint32_t virtualEnd;
+	uint32_t virtualLoopBegin;
+	uint32_t virtualLoopLength;
+
+	/* Stream data, NULL unless the WaveBank is streaming */
+	FACTStream *stream;
+
+	/* The PCM16 this Wave plays instead of its ADPCM, see TranscodeEXT */
+	FACTTranscode *transcode;
 
 	/* FAudio references */
 	uint16_t srcChannels;
 	FAudioSourceVoice *voice;
-	FACTWaveCallback callback;
+	FACTPooledVoice *pooledVoice;
 };
 
 struct FACTCue
@@ -497,6 +784,11 @@ struct FACTCue
 	uint16_t index;
 	uint8_t notifyOnDestroy;
 
+	/* Engine activeCues list, see FACT_INTERNAL_ActivateCue */
+	FACTCue *activePrev;
+	FACTCue *activeNext;
+	uint8_t active;
+
 	/* Sound data */
 	FACTCueData *data;
 	union
@@ -548,12 +840,165 @@ void FACT_INTERNAL_DestroySound(FACTSoundInstance *sound);
 void FACT_INTERNAL_BeginFadeOut(FACTSoundInstance *sound, uint16_t fadeOutMS);
 void FACT_INTERNAL_BeginReleaseRPC(FACTSoundInstance *sound, uint16_t releaseMS);
 
+/* Cues the engine thread has to update: playing, stopping, or stopped and
+ * waiting for the thread to notice. Play, Stop and resuming add a Cue, pausing
+ * and Destroy remove it, and the thread drops Cues once they have stopped.
+ */
+void FACT_INTERNAL_ActivateCue(FACTCue *cue);
+void FACT_INTERNAL_DeactivateCue(FACTCue *cue);
+
+/* Voice Pool Functions */
+
+FACTPooledVoice* FACT_INTERNAL_AcquireVoice(
+	FACTAudioEngine *engine,
+	const FAudioADPCMWaveFormat *format
+);
+void FACT_INTERNAL_ReleaseVoice(
+	FACTAudioEngine *engine,
+	FACTPooledVoice *pooled
+);
+void FACT_INTERNAL_TrimVoicePool(FACTAudioEngine *engine, uint32_t maxIdle);
+
+/* Sound Pool Functions */
+
+FACTSoundInstance* FACT_INTERNAL_AllocSound(
+	FACTAudioEngine *engine,
+	FACTSound *sound
+);
+void FACT_INTERNAL_FreeSound(
+	FACTAudioEngine *engine,
+	FACTSoundInstance *sound
+);
+void FACT_INTERNAL_GrowSoundPool(FACTAudioEngine *engine, size_t slotSize);
+void FACT_INTERNAL_TrimSoundPool(FACTAudioEngine *engine);
+
+/* Voice Budget Functions */
+
+/* Moves virtual Waves along, finishing the ones that reach their end */
+void FACT_INTERNAL_AdvanceVirtualWave(FACTWave *wave, uint32_t timestamp);
+void FACT_INTERNAL_AdvanceVirtualWaves(
+	FACTAudioEngine *engine,
+	uint32_t timestamp
+);
+
+/* Makes the Waves over the budget virtual and resumes the ones that fit,
+ * returning how long the thread can wait before a virtual Wave ends
+ */
+uint32_t FACT_INTERNAL_UpdateVoiceBudget(
+	FACTAudioEngine *engine,
+	uint32_t timestamp,
+	uint32_t maxWait
+);
+
+/* Streaming Functions */
+
+FACTStream* FACT_INTERNAL_CreateStream(
+	FACTWave *wave,
+	const FAudioADPCMWaveFormat *format
+);
+void FACT_INTERNAL_DestroyStream(FACTStream *stream);
+void FACT_INTERNAL_StartStreamThread(FACTAudioEngine *engine);
+void FACT_INTERNAL_WakeStreamThread(FACTAudioEngine *engine);
+void FACT_INTERNAL_StopStreamThread(FACTAudioEngine *engine);
+
+/* Transcode Functions */
+
+void FACT_INTERNAL_InitTranscodes(
+	FACTWaveBank *wb,
+	const FACTTranscodeParametersEXT *params
+);
+FACTTranscode* FACT_INTERNAL_UseTranscode(FACTWaveBank *wb, uint16_t index);
+void FACT_INTERNAL_ReleaseTranscode(FACTWaveBank *wb, FACTTranscode *transcode);
+void FACT_INTERNAL_DestroyTranscodes(FACTWaveBank *wb);
+
+/* 3D Helper Functions */
+
+/* FACT3DApply queues its matrices here, FACTAudioEngine_DoWork commits them */
+#define FACT_OPERATIONSET_3D 0x46414333 /* 'FAC3' */
+
+void FACT_INTERNAL_SetWaveMatrix(
+	FACTWave *wave,
+	uint32_t srcChannels,
+	uint32_t dstChannels,
+	const float *matrix,
+	uint32_t operationSet
+);
+void FACT_INTERNAL_SetCueMatrix(
+	FACTCue *cue,
+	uint32_t srcChannels,
+	uint32_t dstChannels,
+	const float *matrix,
+	uint32_t operationSet
+);
+
 /* RPC Helper Functions */
 
 FACTRPC* FACT_INTERNAL_GetRPC(FACTAudioEngine *engine, uint32_t code);
 
+/* Arena Functions */
+
+void FACT_INTERNAL_InitArena(FACTArena *arena, size_t blockSize);
+void* FACT_INTERNAL_ArenaAlloc(
+	FACTArena *arena,
+	size_t size,
+	FAudioMallocFunc pMalloc
+);
+void FACT_INTERNAL_FreeArena(FACTArena *arena, FAudioFreeFunc pFree);
+size_t FACT_INTERNAL_GetArenaSize(const FACTArena *arena);
+
+/* Name Lookup Functions */
+
+void FACT_INTERNAL_BuildNameTable(
+	FACTNameTable *table,
+	char **names,
+	const uint16_t *indices, /* NULL for all of them */
+	uint16_t count,
+	FACTArena *arena,
+	FAudioMallocFunc pMalloc
+);
+uint16_t FACT_INTERNAL_FindName(
+	const FACTNameTable *table,
+	char **names,
+	const char *name
+);
+
+/* Finds the WaveBank by name the first time, remembering it after that */
+FACTWaveBank* FACT_INTERNAL_GetWaveBank(FACTSoundBank *sb, uint8_t index);
+
+/* Finds the Sound by code, parsing it first if the SoundBank is lazy */
+FACTSound* FACT_INTERNAL_GetSound(FACTSoundBank *sb, uint32_t code);
+
+/* API Lock Functions */
+
+/* apiLock is recursive */
+void FACT_INTERNAL_LockAPI(FACTAudioEngine *engine);
+void FACT_INTERNAL_UnlockAPI(FACTAudioEngine *engine);
+
+/* Application-writable variables are read by the engine thread without
+ * apiLock, so they are stored with the atomics
+ */
+void FACT_INTERNAL_StoreVariable(float *variable, float value);
+float FACT_INTERNAL_LoadVariable(float *variable);
+
 /* FACT Thread */
 
+/* Fades, ramps and time-based RPCs are updated at this rate. Otherwise the
+ * thread sleeps until the next event is due, checking in at least this often
+ * while anything plays, and waits to be woken once nothing does.
+ */
+#define FACT_API_TICK_MS	10
+#define FACT_API_PLAYING_MS	100
+#define FACT_API_WAIT_FOREVER	FAUDIO_POOL_LOOP_IDLE	/* Same for task pools */
+
+#define FACT_API_DEADLINE_US	(FACT_API_TICK_MS * 1000)
+
+/* Safe to call without apiLock, after any change the thread has to act on */
+void FACT_INTERNAL_WakeAPIThread(FACTAudioEngine *engine);
+
+/* Wakes it even if a wake is already pending */
+void FACT_INTERNAL_PostAPIWake(FACTAudioEngine *engine);
+
+uint32_t FACT_INTERNAL_APITick(void *enginePtr);
 int32_t FACT_INTERNAL_APIThread(void* enginePtr);
 
 /* FAudio callbacks */
@@ -561,6 +1006,9 @@ int32_t FACT_INTERNAL_APIThread(void* enginePtr);
 void FACT_INTERNAL_OnBufferEnd(FAudioVoiceCallback *callback, void* pContext);
 void FACT_INTERNAL_OnStreamEnd(FAudioVoiceCallback *callback);
 
+/* What OnStreamEnd does to the Wave and its Cue, for virtual Waves too */
+void FACT_INTERNAL_FinishWave(FACTWave *wave);
+
 /* FAudioIOStream functions */
 
 int32_t FACTCALL FACT_INTERNAL_DefaultReadFile(
@@ -588,6 +1036,7 @@ uint32_t FACT_INTERNAL_ParseSoundBank(
 	FACTAudioEngine *pEngine,
 	const void *pvBuffer,
 	uint32_t dwSize,
+	uint32_t dwFlags,
 	FACTSoundBank **ppSoundBank
 );
 uint32_t FACT_INTERNAL_ParseWaveBank(
@@ -89,8 +89,10 @@ void CreateFAPOBaseWithCustomAllocatorEXT(
 	fapo->m_fIsLocked = 0;
 	fapo->m_pParameterBlocks = pParameterBlocks;
 	fapo->m_pCurrentParameters = pParameterBlocks;
-	fapo->m_pCurrentParametersInternal = pParameterBlocks;
-	fapo->m_uCurrentParametersIndex = 0;
+	fapo->m_pCurrentParametersInternal = pParameterBlocks + (
+		uParameterBlockByteSize * 2
+	);
+	fapo->m_uCurrentParametersIndex = 1; /* See FAPOBase_INTERNAL_Write */
 	fapo->m_uParameterBlockByteSize = uParameterBlockByteSize;
 	fapo->m_fNewerResultsReady = 0;
 	fapo->m_fProducer = fProducer;
@@ -387,6 +389,118 @@ void FAPOBase_ProcessThru(
 	}
 }
 
+/* The three parameter blocks are a triple buffer. The writer fills a block of
+ * its own, then swaps it with the one in the middle, and the reader swaps its
+ * own block with the middle one when that holds something newer. Neither side
+ * ever touches the block the other one owns, so neither waits for the other.
+ *
+ * For effects that take parameters the writer is SetParameters and the reader
+ * is Process; producers like the volume meter run the other way around.
+ * m_uCurrentParametersIndex holds the middle block's index and these flags:
+ */
+#define FAPOBASE_INDEX_MASK	0x3
+#define FAPOBASE_NEWER_BLOCK	0x4	/* The reader hasn't taken it yet */
+#define FAPOBASE_WRITING	0x8	/* Makes concurrent writers take turns */
+
+static inline uint8_t* FAPOBase_INTERNAL_Block(FAPOBase *fapo, int32_t index)
+{
+	return fapo->m_pParameterBlocks + (
+		fapo->m_uParameterBlockByteSize *
+		(index & FAPOBASE_INDEX_MASK)
+	);
+}
+
+static inline int32_t FAPOBase_INTERNAL_Index(FAPOBase *fapo, uint8_t *block)
+{
+	return (int32_t) (
+		(block - fapo->m_pParameterBlocks) /
+		fapo->m_uParameterBlockByteSize
+	);
+}
+
+static void FAPOBase_INTERNAL_Write(
+	FAPOBase *fapo,
+	const void* pParameters,
+	uint32_t ParameterByteSize
+) {
+	volatile int32_t *middle = (volatile int32_t*) &fapo->m_uCurrentParametersIndex;
+	int32_t old;
+
+	if (fapo->m_uParameterBlockByteSize == 0)
+	{
+		return;
+	}
+
+	/* Writers only ever wait on each other, for a memcpy at most */
+	do
+	{
+		old = FAudio_PlatformAtomicGet(middle);
+	} while (	(old & FAPOBASE_WRITING) ||
+			!FAudio_PlatformAtomicCompareExchange(
+				middle,
+				old,
+				old | FAPOBASE_WRITING
+			)	);
+
+	if (pParameters != NULL)
+	{
+		FAudio_memcpy(
+			fapo->m_pCurrentParametersInternal,
+			pParameters,
+			ParameterByteSize
+		);
+	}
+
+	/* Publish our block, the middle one is ours to write next time */
+	do
+	{
+		old = FAudio_PlatformAtomicGet(middle);
+	} while (!FAudio_PlatformAtomicCompareExchange(
+		middle,
+		old,
+		FAPOBase_INTERNAL_Index(fapo, fapo->m_pCurrentParametersInternal) |
+			FAPOBASE_NEWER_BLOCK |
+			FAPOBASE_WRITING
+	));
+	fapo->m_pCurrentParametersInternal = FAPOBase_INTERNAL_Block(fapo, old);
+
+	/* Only now can the next writer trust m_pCurrentParametersInternal */
+	do
+	{
+		old = FAudio_PlatformAtomicGet(middle);
+	} while (!FAudio_PlatformAtomicCompareExchange(
+		middle,
+		old,
+		old & ~FAPOBASE_WRITING
+	));
+}
+
+static void FAPOBase_INTERNAL_Read(FAPOBase *fapo)
+{
+	volatile int32_t *middle = (volatile int32_t*) &fapo->m_uCurrentParametersIndex;
+	int32_t old;
+
+	if (fapo->m_uParameterBlockByteSize == 0)
+	{
+		return;
+	}
+
+	do
+	{
+		old = FAudio_PlatformAtomicGet(middle);
+		if (!(old & FAPOBASE_NEWER_BLOCK))
+		{
+			return;
+		}
+	} while (!FAudio_PlatformAtomicCompareExchange(
+		middle,
+		old,
+		(old & FAPOBASE_WRITING) |
+			FAPOBase_INTERNAL_Index(fapo, fapo->m_pCurrentParameters)
+	));
+	fapo->m_pCurrentParameters = FAPOBase_INTERNAL_Block(fapo, old);
+}
+
 void FAPOBase_SetParameters(
 	FAPOBase *fapo,
 	const void* pParameters,
@@ -401,23 +515,8 @@ void FAPOBase_SetParameters(
 		ParameterByteSize
 	);
 
-	/* Increment parameter block index... */
-	fapo->m_uCurrentParametersIndex += 1;
-	if (fapo->m_uCurrentParametersIndex == 3)
-	{
-		fapo->m_uCurrentParametersIndex = 0;
-	}
-	fapo->m_pCurrentParametersInternal = fapo->m_pParameterBlocks + (
-		fapo->m_uParameterBlockByteSize *
-		fapo->m_uCurrentParametersIndex
-	);
-
-	/* Copy to what will eventually be the next parameter update */
-	FAudio_memcpy(
-		fapo->m_pCurrentParametersInternal,
-		pParameters,
-		ParameterByteSize
-	);
+	/* This is what the next Process will pick up */
+	FAPOBase_INTERNAL_Write(fapo, pParameters, ParameterByteSize);
 }
 
 void FAPOBase_GetParameters(
@@ -425,6 +524,12 @@ void FAPOBase_GetParameters(
 	void* pParameters,
 	uint32_t ParameterByteSize
 ) {
+	/* Producers publish their results at the end of every Process */
+	if (fapo->m_fProducer)
+	{
+		FAPOBase_INTERNAL_Read(fapo);
+	}
+
 	/* Copy what's current as of the last Process */
 	FAudio_memcpy(
 		pParameters,
@@ -442,20 +547,35 @@ void FAPOBase_OnSetParameters(
 
 uint8_t FAPOBase_ParametersChanged(FAPOBase *fapo)
 {
-	/* Internal will get updated when SetParameters is called */
-	return fapo->m_pCurrentParametersInternal != fapo->m_pCurrentParameters;
+	/* The middle block is newer until BeginProcess takes it */
+	return (FAudio_PlatformAtomicGet(
+		(volatile int32_t*) &fapo->m_uCurrentParametersIndex
+	) & FAPOBASE_NEWER_BLOCK) != 0;
 }
 
 uint8_t* FAPOBase_BeginProcess(FAPOBase *fapo)
 {
-	/* Set the latest block as "current", this is what Process will use now */
-	fapo->m_pCurrentParameters = fapo->m_pCurrentParametersInternal;
+	/* Producers fill their own block, EndProcess publishes it */
+	if (fapo->m_fProducer)
+	{
+		return fapo->m_pCurrentParametersInternal;
+	}
+
+	/* Take the latest block, if there is one. This is what Process uses. */
+	FAPOBase_INTERNAL_Read(fapo);
 	return fapo->m_pCurrentParameters;
 }
 
 void FAPOBase_EndProcess(FAPOBase *fapo)
 {
-	/* I'm 100% sure my parameter block increment is wrong... */
+	if (fapo->m_fProducer)
+	{
+		FAPOBase_INTERNAL_Write(fapo, NULL, 0);
+	}
 }
 
+#undef FAPOBASE_INDEX_MASK
+#undef FAPOBASE_NEWER_BLOCK
+#undef FAPOBASE_WRITING
+
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -121,9 +121,103 @@ typedef struct FAPOFXEcho
 {
 	FAPOBase base;
 
-	/* TODO */
+	uint16_t channels;
+	uint32_t sampleRate;
+
+	/* The delay line, interleaved like the buffers it echoes */
+	float *buffer;
+	uint32_t capacity;	/* In frames, enough for FAPOFXECHO_MAX_DELAY */
+	uint32_t write_idx;
+	uint32_t delay;		/* In frames */
+	uint32_t lastDelay;	/* Faded out over the buffer after a change */
+
+	FAudioEffectTail tail;
 } FAPOFXEcho;
 
+static inline uint32_t FAPOFXEcho_INTERNAL_DelayFrames(
+	FAPOFXEcho *fapo,
+	float delay
+) {
+	uint32_t frames = (uint32_t) (
+		FAudio_clamp(delay, FAPOFXECHO_MIN_DELAY, FAPOFXECHO_MAX_DELAY) *
+		fapo->sampleRate /
+		1000.0f
+	);
+	return FAudio_clamp(frames, 1, fapo->capacity - 1);
+}
+
+/* How long the echoes take to fall below FAUDIO_EFFECT_TAIL_SILENCE */
+static inline uint32_t FAPOFXEcho_INTERNAL_TailFrames(
+	FAPOFXEcho *fapo,
+	float feedback
+) {
+	float repeats = 1.0f;
+	float frames;
+
+	if (feedback >= FAPOFXECHO_MAX_FEEDBACK)
+	{
+		return 0xFFFFFFFF;
+	}
+	if (feedback > 0.0f)
+	{
+		repeats += (float) (
+			FAudio_log(FAUDIO_EFFECT_TAIL_SILENCE) * 0.5 /
+			FAudio_log(feedback)
+		);
+	}
+	frames = repeats * fapo->delay;
+	if (frames >= 4294967040.0f)
+	{
+		return 0xFFFFFFFF;
+	}
+	return (uint32_t) frames;
+}
+
+uint32_t FAPOFXEcho_LockForProcess(
+	FAPOFXEcho *fapo,
+	uint32_t InputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pInputLockedParameters,
+	uint32_t OutputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pOutputLockedParameters
+) {
+	FAPOFXEchoParameters params;
+	uint16_t channels = pInputLockedParameters->pFormat->nChannels;
+	uint32_t sampleRate = pInputLockedParameters->pFormat->nSamplesPerSec;
+	uint32_t capacity;
+
+	/* Allocated once, at the longest delay, so changing the delay is
+	 * free. A lock with the same format keeps the old buffer.
+	 */
+	capacity = (uint32_t) (FAPOFXECHO_MAX_DELAY * sampleRate / 1000.0f) + 1;
+	if (	fapo->buffer == NULL ||
+		capacity * channels != fapo->capacity * fapo->channels	)
+	{
+		fapo->base.pFree(fapo->buffer);
+		fapo->buffer = (float*) fapo->base.pMalloc(
+			sizeof(float) * capacity * channels
+		);
+	}
+	fapo->channels = channels;
+	fapo->sampleRate = sampleRate;
+	fapo->capacity = capacity;
+	FAudio_zero(fapo->buffer, sizeof(float) * capacity * channels);
+	fapo->write_idx = 0;
+
+	FAPOBase_GetParameters(&fapo->base, &params, sizeof(params));
+	fapo->delay = FAPOFXEcho_INTERNAL_DelayFrames(fapo, params.Delay);
+	fapo->lastDelay = fapo->delay;
+	fapo->tail.silentFrames = 0;
+	fapo->tail.idle = 1;
+
+	return FAPOBase_LockForProcess(
+		&fapo->base,
+		InputLockedParameterCount,
+		pInputLockedParameters,
+		OutputLockedParameterCount,
+		pOutputLockedParameters
+	);
+}
+
 uint32_t FAPOFXEcho_Initialize(
 	FAPOFXEcho *fapo,
 	const void* pData,
@@ -150,16 +244,156 @@ void FAPOFXEcho_Process(
 	FAPOProcessBufferParameters* pOutputProcessParameters,
 	int32_t IsEnabled
 ) {
-	FAPOBase_BeginProcess(&fapo->base);
+	FAPOFXEchoParameters *params;
+	float *samples = (float*) pInputProcessParameters->pBuffer;
+	float *delayed, *lastDelayed, *line;
+	float wet, dry, feedback, energy, fade, step, d, x;
+	uint32_t frames, done, span, i, j, c, read, lastRead;
 
-	/* TODO */
+	params = (FAPOFXEchoParameters*) FAPOBase_BeginProcess(&fapo->base);
+	pOutputProcessParameters->BufferFlags = pInputProcessParameters->BufferFlags;
+
+	/* Processing is in place, so a disabled echo has nothing to do */
+	if (!IsEnabled)
+	{
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
+	frames = pInputProcessParameters->ValidFrameCount;
+	fapo->delay = FAPOFXEcho_INTERNAL_DelayFrames(fapo, params->Delay);
+
+	/* The echoes have died out, nothing to do until there is input again */
+	if (FAudio_INTERNAL_EffectTailIdle(
+		&fapo->tail,
+		pInputProcessParameters->BufferFlags,
+		frames
+	)) {
+		fapo->lastDelay = fapo->delay;
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+		pOutputProcessParameters->BufferFlags = FAPO_BUFFER_SILENT;
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
+	if (pInputProcessParameters->BufferFlags == FAPO_BUFFER_SILENT)
+	{
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+	}
+
+	wet = FAudio_clamp(
+		params->WetDryMix,
+		FAPOFXECHO_MIN_WETDRYMIX,
+		FAPOFXECHO_MAX_WETDRYMIX
+	);
+	dry = 1.0f - wet;
+	feedback = FAudio_clamp(
+		params->Feedback,
+		FAPOFXECHO_MIN_FEEDBACK,
+		FAPOFXECHO_MAX_FEEDBACK
+	);
+
+	/* A new delay fades in over this buffer, reading both taps */
+	fade = 0.0f;
+	step = 1.0f / frames;
+
+	/* Spans are cut at the ends of the line, and are never longer than the
+	 * delay so that they only read frames written by earlier spans.
+	 */
+	energy = 0.0f;
+	for (done = 0; done < frames; done += span)
+	{
+		read = (fapo->write_idx + fapo->capacity - fapo->delay) % fapo->capacity;
+		span = FAudio_min(frames - done, fapo->capacity - fapo->write_idx);
+		span = FAudio_min(span, fapo->capacity - read);
+		span = FAudio_min(span, fapo->delay);
+
+		line = fapo->buffer + (fapo->write_idx * fapo->channels);
+		delayed = fapo->buffer + (read * fapo->channels);
+		if (fapo->lastDelay == fapo->delay)
+		{
+			for (i = 0; i < span * fapo->channels; i += 1)
+			{
+				d = delayed[i];
+				x = samples[i];
+				line[i] = x + (feedback * d);
+				samples[i] = (dry * x) + (wet * d);
+				energy += samples[i] * samples[i];
+			}
+		}
+		else
+		{
+			lastRead = (
+				fapo->write_idx + fapo->capacity - fapo->lastDelay
+			) % fapo->capacity;
+			span = FAudio_min(span, fapo->capacity - lastRead);
+			span = FAudio_min(span, fapo->lastDelay);
+			lastDelayed = fapo->buffer + (lastRead * fapo->channels);
+			for (i = 0; i < span; i += 1, fade += step)
+			{
+				for (c = 0; c < fapo->channels; c += 1)
+				{
+					j = (i * fapo->channels) + c;
+					d = (	(lastDelayed[j] * (1.0f - fade)) +
+						(delayed[j] * fade)	);
+					x = samples[j];
+					line[j] = x + (feedback * d);
+					samples[j] = (dry * x) + (wet * d);
+					energy += samples[j] * samples[j];
+				}
+			}
+		}
+
+		samples += span * fapo->channels;
+		fapo->write_idx += span;
+		if (fapo->write_idx == fapo->capacity)
+		{
+			fapo->write_idx = 0;
+		}
+	}
+	fapo->lastDelay = fapo->delay;
+
+	pOutputProcessParameters->BufferFlags = (energy < FAUDIO_EFFECT_TAIL_SILENCE) ?
+		FAPO_BUFFER_SILENT :
+		FAPO_BUFFER_VALID;
+
+	/* Go idle with a clean line, so waking up is like starting over */
+	if (FAudio_INTERNAL_EffectTailEnded(
+		&fapo->tail,
+		FAPOFXEcho_INTERNAL_TailFrames(fapo, feedback),
+		energy
+	)) {
+		FAudio_zero(
+			fapo->buffer,
+			sizeof(float) * fapo->capacity * fapo->channels
+		);
+	}
 
 	FAPOBase_EndProcess(&fapo->base);
 }
 
+void FAPOFXEcho_Reset(FAPOFXEcho *fapo)
+{
+	FAPOBase_Reset(&fapo->base);
+
+	/* Reset is called before the echo is locked too */
+	if (fapo->buffer != NULL)
+	{
+		FAudio_zero(
+			fapo->buffer,
+			sizeof(float) * fapo->capacity * fapo->channels
+		);
+	}
+	fapo->write_idx = 0;
+	fapo->lastDelay = fapo->delay;
+	fapo->tail.silentFrames = 0;
+	fapo->tail.idle = 1;
+}
+
 void FAPOFXEcho_Free(void* fapo)
 {
 	FAPOFXEcho *echo = (FAPOFXEcho*) fapo;
+	echo->base.pFree(echo->buffer);
 	echo->base.pFree(echo->base.m_pParameterBlocks);
 	echo->base.pFree(fapo);
 }
@@ -212,6 +446,15 @@ uint32_t FAPOFXCreateEcho(
 	}
 
 	/* Initialize... */
+	result->channels = 0;
+	result->sampleRate = 0;
+	result->buffer = NULL;
+	result->capacity = 0;
+	result->write_idx = 0;
+	result->delay = 0;
+	result->lastDelay = 0;
+	result->tail.silentFrames = 0;
+	result->tail.idle = 1;
 	FAudio_memcpy(
 		&FXEchoProperties_LEGACY.clsid,
 		&FAPOFX_CLSID_FXEcho_LEGACY,
@@ -236,8 +479,12 @@ uint32_t FAPOFXCreateEcho(
 	/* Function table... */
 	result->base.base.Initialize = (InitializeFunc)
 		FAPOFXEcho_Initialize;
+	result->base.base.LockForProcess = (LockForProcessFunc)
+		FAPOFXEcho_LockForProcess;
 	result->base.base.Process = (ProcessFunc)
 		FAPOFXEcho_Process;
+	result->base.base.Reset = (ResetFunc)
+		FAPOFXEcho_Reset;
 	result->base.Destructor = FAPOFXEcho_Free;
 
 	/* Finally. */
@@ -29,6 +29,9 @@
 
 /* FXEQ FAPO Implementation */
 
+#define PI 3.1415926536f
+#define LN_2 0.6931471806f
+
 const FAudioGUID FAPOFX_CLSID_FXEQ =
 {
 	0xF5E01117,
@@ -121,9 +124,87 @@ typedef struct FAPOFXEQ
 {
 	FAPOBase base;
 
-	/* TODO */
+	uint16_t channels;
+	uint32_t sampleRate;
+	FAudioBiquadCascade cascade;
 } FAPOFXEQ;
 
+/* Peaking filters from the Audio EQ Cookbook, with the bandwidth in octaves.
+ * The gain is linear and applies at the center frequency, so a band with a
+ * gain of 1 passes everything through unchanged.
+ */
+static void FAPOFXEQ_INTERNAL_SetBand(
+	FAPOFXEQ *fapo,
+	uint32_t band,
+	float frequency,
+	float gain,
+	float bandwidth
+) {
+	float w0, sin_w0, cos_w0, x, alpha, A, a0;
+
+	/* The range allows centers past Nyquist at low sample rates */
+	frequency = FAudio_clamp(
+		frequency,
+		FAPOFXEQ_MIN_FREQUENCY_CENTER,
+		FAudio_min(FAPOFXEQ_MAX_FREQUENCY_CENTER, fapo->sampleRate * 0.45f)
+	);
+	gain = FAudio_clamp(gain, FAPOFXEQ_MIN_GAIN, FAPOFXEQ_MAX_GAIN);
+	bandwidth = FAudio_clamp(
+		bandwidth,
+		FAPOFXEQ_MIN_BANDWIDTH,
+		FAPOFXEQ_MAX_BANDWIDTH
+	);
+
+	w0 = (2.0f * PI * frequency) / (float) fapo->sampleRate;
+	sin_w0 = (float) FAudio_sin(w0);
+	cos_w0 = (float) FAudio_cos(w0);
+	x = (LN_2 * 0.5f) * bandwidth * w0 / sin_w0;
+	alpha = sin_w0 * (float) (FAudio_exp(x) - FAudio_exp(-x)) * 0.5f;
+	A = FAudio_sqrtf(gain);
+
+	/* The cascade's a are the cookbook's b, and the other way around */
+	a0 = 1.0f + (alpha / A);
+	fapo->cascade.a0[band] = (1.0f + (alpha * A)) / a0;
+	fapo->cascade.a1[band] = (-2.0f * cos_w0) / a0;
+	fapo->cascade.a2[band] = (1.0f - (alpha * A)) / a0;
+	fapo->cascade.b1[band] = (-2.0f * cos_w0) / a0;
+	fapo->cascade.b2[band] = (1.0f - (alpha / A)) / a0;
+}
+
+static void FAPOFXEQ_INTERNAL_SetParameters(
+	FAPOFXEQ *fapo,
+	const FAPOFXEQParameters *params
+) {
+	FAPOFXEQ_INTERNAL_SetBand(
+		fapo,
+		0,
+		params->FrequencyCenter0,
+		params->Gain0,
+		params->Bandwidth0
+	);
+	FAPOFXEQ_INTERNAL_SetBand(
+		fapo,
+		1,
+		params->FrequencyCenter1,
+		params->Gain1,
+		params->Bandwidth1
+	);
+	FAPOFXEQ_INTERNAL_SetBand(
+		fapo,
+		2,
+		params->FrequencyCenter2,
+		params->Gain2,
+		params->Bandwidth2
+	);
+	FAPOFXEQ_INTERNAL_SetBand(
+		fapo,
+		3,
+		params->FrequencyCenter3,
+		params->Gain3,
+		params->Bandwidth3
+	);
+}
+
 uint32_t FAPOFXEQ_Initialize(
 	FAPOFXEQ *fapo,
 	const void* pData,
@@ -142,6 +223,53 @@ uint32_t FAPOFXEQ_Initialize(
 	return 0;
 }
 
+uint32_t FAPOFXEQ_LockForProcess(
+	FAPOFXEQ *fapo,
+	uint32_t InputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pInputLockedParameters,
+	uint32_t OutputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pOutputLockedParameters
+) {
+	FAPOFXEQParameters params;
+	uint32_t stride;
+
+	if (	pInputLockedParameters->pFormat->nSamplesPerSec < FAPOFXEQ_MIN_FRAMERATE ||
+		pInputLockedParameters->pFormat->nSamplesPerSec > FAPOFXEQ_MAX_FRAMERATE	)
+	{
+		return FAPO_E_FORMAT_UNSUPPORTED;
+	}
+
+	fapo->channels = pInputLockedParameters->pFormat->nChannels;
+	fapo->sampleRate = pInputLockedParameters->pFormat->nSamplesPerSec;
+
+	/* The delay elements, for every channel of every band */
+	stride = FAUDIO_EQ_STRIDE(fapo->channels);
+	if (stride != fapo->cascade.stride)
+	{
+		fapo->base.pFree(fapo->cascade.delay);
+		fapo->cascade.delay = (float*) fapo->base.pMalloc(
+			sizeof(float) * FAUDIO_EQ_BANDS * 2 * stride
+		);
+		fapo->cascade.stride = stride;
+	}
+	FAudio_zero(
+		fapo->cascade.delay,
+		sizeof(float) * FAUDIO_EQ_BANDS * 2 * stride
+	);
+
+	/* The coefficients depend on the sample rate */
+	FAPOBase_GetParameters(&fapo->base, &params, sizeof(params));
+	FAPOFXEQ_INTERNAL_SetParameters(fapo, &params);
+
+	return FAPOBase_LockForProcess(
+		&fapo->base,
+		InputLockedParameterCount,
+		pInputLockedParameters,
+		OutputLockedParameterCount,
+		pOutputLockedParameters
+	);
+}
+
 void FAPOFXEQ_Process(
 	FAPOFXEQ *fapo,
 	uint32_t InputProcessParameterCount,
@@ -150,16 +278,61 @@ void FAPOFXEQ_Process(
 	FAPOProcessBufferParameters* pOutputProcessParameters,
 	int32_t IsEnabled
 ) {
-	FAPOBase_BeginProcess(&fapo->base);
+	FAPOFXEQParameters *params;
+	uint8_t update_params = FAPOBase_ParametersChanged(&fapo->base);
 
-	/* TODO */
+	params = (FAPOFXEQParameters*) FAPOBase_BeginProcess(&fapo->base);
+
+	/* Only recompute the coefficients when they have changed */
+	if (update_params)
+	{
+		FAPOFXEQ_INTERNAL_SetParameters(fapo, params);
+	}
+
+	/* Processing is in place, so a disabled EQ has nothing to do. Silent
+	 * input is still filtered so that the bands can ring out.
+	 */
+	pOutputProcessParameters->BufferFlags = pInputProcessParameters->BufferFlags;
+	if (IsEnabled)
+	{
+		if (pInputProcessParameters->BufferFlags == FAPO_BUFFER_SILENT)
+		{
+			FAudio_zero(
+				pInputProcessParameters->pBuffer,
+				pInputProcessParameters->ValidFrameCount *
+				fapo->channels *
+				sizeof(float)
+			);
+		}
+		FAudio_INTERNAL_ProcessBiquadCascade(
+			&fapo->cascade,
+			(float*) pInputProcessParameters->pBuffer,
+			pInputProcessParameters->ValidFrameCount,
+			fapo->channels
+		);
+	}
 
 	FAPOBase_EndProcess(&fapo->base);
 }
 
+void FAPOFXEQ_Reset(FAPOFXEQ *fapo)
+{
+	FAPOBase_Reset(&fapo->base);
+
+	/* Reset is called before the EQ is locked too */
+	if (fapo->cascade.delay != NULL)
+	{
+		FAudio_zero(
+			fapo->cascade.delay,
+			sizeof(float) * FAUDIO_EQ_BANDS * 2 * fapo->cascade.stride
+		);
+	}
+}
+
 void FAPOFXEQ_Free(void* fapo)
 {
 	FAPOFXEQ *eq = (FAPOFXEQ*) fapo;
+	eq->base.pFree(eq->cascade.delay);
 	eq->base.pFree(eq->base.m_pParameterBlocks);
 	eq->base.pFree(fapo);
 }
@@ -221,6 +394,9 @@ uint32_t FAPOFXCreateEQ(
 	}
 
 	/* Initialize... */
+	result->channels = 0;
+	result->sampleRate = 0;
+	FAudio_zero(&result->cascade, sizeof(result->cascade));
 	FAudio_memcpy(
 		&FXEQProperties_LEGACY.clsid,
 		&FAPOFX_CLSID_FXEQ_LEGACY,
@@ -245,8 +421,12 @@ uint32_t FAPOFXCreateEQ(
 	/* Function table... */
 	result->base.base.Initialize = (InitializeFunc)
 		FAPOFXEQ_Initialize;
+	result->base.base.LockForProcess = (LockForProcessFunc)
+		FAPOFXEQ_LockForProcess;
 	result->base.base.Process = (ProcessFunc)
 		FAPOFXEQ_Process;
+	result->base.base.Reset = (ResetFunc)
+		FAPOFXEQ_Reset;
 	result->base.Destructor = FAPOFXEQ_Free;
 
 	/* Finally. */
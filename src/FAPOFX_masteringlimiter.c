@@ -117,13 +117,112 @@ static FAPORegistrationProperties FXMasteringLimiterProperties_LEGACY =
 	/*.MaxOutputBufferCount =*/ 1
 };
 
+/* The limiter delays its output by this much, so that it can turn the gain
+ * down before a peak comes out rather than after it did.
+ */
+#define LIMITER_LOOKAHEAD_MS 2
+
+/* The Release parameter is in tens of milliseconds */
+#define LIMITER_RELEASE_MS 10.0f
+
 typedef struct FAPOFXMasteringLimiter
 {
 	FAPOBase base;
 
-	/* TODO */
+	uint16_t channels;
+	uint32_t sampleRate;
+
+	/* The look-ahead delay line, interleaved, and one peak per frame of
+	 * the buffer being processed. Both are allocated in one block.
+	 */
+	float *buffer;
+	float *peaks;
+	uint32_t lookahead;	/* In frames */
+	uint32_t maxFrames;
+	uint32_t write_idx;
+
+	/* The peaks of the look-ahead window in decreasing order, with the
+	 * frame each one was found at. The first is the window's maximum.
+	 */
+	float *dequePeaks;
+	uint32_t *dequeFrames;
+	uint32_t dequeHead;
+	uint32_t dequeCount;
+	uint32_t frame;
+
+	/* The gain the window needs, after release, for every frame of the
+	 * window. What comes out is their mean, so the gain ramps down over
+	 * the look-ahead and never gets louder than any frame in it allows.
+	 */
+	float *gains;
+	uint32_t gainIdx;
+	float gain;
+
+	FAudioEffectTail tail;
 } FAPOFXMasteringLimiter;
 
+static void FAPOFXMasteringLimiter_INTERNAL_Clear(FAPOFXMasteringLimiter *fapo)
+{
+	uint32_t i;
+
+	FAudio_zero(fapo->buffer, sizeof(float) * fapo->lookahead * fapo->channels);
+	for (i = 0; i <= fapo->lookahead; i += 1)
+	{
+		fapo->gains[i] = 1.0f;
+	}
+	fapo->write_idx = 0;
+	fapo->dequeHead = 0;
+	fapo->dequeCount = 0;
+	fapo->frame = 0;
+	fapo->gainIdx = 0;
+	fapo->gain = 1.0f;
+	fapo->tail.silentFrames = 0;
+	fapo->tail.idle = 1;
+}
+
+uint32_t FAPOFXMasteringLimiter_LockForProcess(
+	FAPOFXMasteringLimiter *fapo,
+	uint32_t InputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pInputLockedParameters,
+	uint32_t OutputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pOutputLockedParameters
+) {
+	uint32_t window;
+
+	fapo->channels = pInputLockedParameters->pFormat->nChannels;
+	fapo->sampleRate = pInputLockedParameters->pFormat->nSamplesPerSec;
+	fapo->lookahead = FAudio_max(
+		(LIMITER_LOOKAHEAD_MS * fapo->sampleRate) / 1000,
+		1
+	);
+	fapo->maxFrames = pInputLockedParameters->MaxFrameCount;
+	window = fapo->lookahead + 1;
+
+	/* Everything is allocated here, once per lock */
+	fapo->base.pFree(fapo->buffer);
+	fapo->buffer = (float*) fapo->base.pMalloc(
+		sizeof(float) * (
+			(fapo->lookahead * fapo->channels) +
+			fapo->maxFrames +
+			(window * 2)
+		) +
+		sizeof(uint32_t) * window
+	);
+	fapo->peaks = fapo->buffer + (fapo->lookahead * fapo->channels);
+	fapo->dequePeaks = fapo->peaks + fapo->maxFrames;
+	fapo->gains = fapo->dequePeaks + window;
+	fapo->dequeFrames = (uint32_t*) (fapo->gains + window);
+	FAPOFXMasteringLimiter_INTERNAL_Clear(fapo);
+
+	return FAPOBase_LockForProcess(
+		&fapo->base,
+		InputLockedParameterCount,
+		pInputLockedParameters,
+		OutputLockedParameterCount,
+		pOutputLockedParameters
+	);
+}
+
 uint32_t FAPOFXMasteringLimiter_Initialize(
 	FAPOFXMasteringLimiter *fapo,
 	const void* pData,
@@ -150,16 +249,166 @@ void FAPOFXMasteringLimiter_Process(
 	FAPOProcessBufferParameters* pOutputProcessParameters,
 	int32_t IsEnabled
 ) {
-	FAPOBase_BeginProcess(&fapo->base);
+	FAPOFXMasteringLimiterParameters *params;
+	float *samples = (float*) pInputProcessParameters->pBuffer;
+	float *line;
+	float threshold, release, peak, target, sum, gain, x, energy;
+	uint32_t frames, window, i, c, tailIdx;
+
+	params = (FAPOFXMasteringLimiterParameters*) FAPOBase_BeginProcess(
+		&fapo->base
+	);
+	pOutputProcessParameters->BufferFlags = pInputProcessParameters->BufferFlags;
 
-	/* TODO */
+	/* Processing is in place, so a disabled limiter has nothing to do */
+	if (!IsEnabled)
+	{
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
+	frames = pInputProcessParameters->ValidFrameCount;
+	FAudio_assert(frames <= fapo->maxFrames);
+
+	/* Silence in, silence out, once the delay line has emptied */
+	if (FAudio_INTERNAL_EffectTailIdle(
+		&fapo->tail,
+		pInputProcessParameters->BufferFlags,
+		frames
+	)) {
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+		pOutputProcessParameters->BufferFlags = FAPO_BUFFER_SILENT;
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+	if (pInputProcessParameters->BufferFlags == FAPO_BUFFER_SILENT)
+	{
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+	}
+
+	/* The threshold is in thousandths of full scale */
+	threshold = FAudio_clamp(
+		params->Loudness,
+		FAPOFXMASTERINGLIMITER_MIN_LOUDNESS,
+		FAPOFXMASTERINGLIMITER_MAX_LOUDNESS
+	) / 1000.0f;
+	release = (float) FAudio_exp(
+		-1000.0f / (
+			FAudio_clamp(
+				params->Release,
+				FAPOFXMASTERINGLIMITER_MIN_RELEASE,
+				FAPOFXMASTERINGLIMITER_MAX_RELEASE
+			) *
+			LIMITER_RELEASE_MS *
+			fapo->sampleRate
+		)
+	);
+
+	FAudio_INTERNAL_FramePeaks(samples, fapo->peaks, frames, fapo->channels);
+
+	/* Summed again for every buffer, so rounding can't pile up */
+	window = fapo->lookahead + 1;
+	sum = 0.0f;
+	for (i = 0; i < window; i += 1)
+	{
+		sum += fapo->gains[i];
+	}
+
+	energy = 0.0f;
+	for (i = 0; i < frames; i += 1, fapo->frame += 1)
+	{
+		/* Push this frame's peak, dropping every smaller one before
+		 * it, and the maximum once it has left the window. Each peak
+		 * goes in and out once, so this is O(1) per frame.
+		 */
+		peak = fapo->peaks[i];
+		while (fapo->dequeCount > 0)
+		{
+			tailIdx = (fapo->dequeHead + fapo->dequeCount - 1) % window;
+			if (fapo->dequePeaks[tailIdx] > peak)
+			{
+				break;
+			}
+			fapo->dequeCount -= 1;
+		}
+		tailIdx = (fapo->dequeHead + fapo->dequeCount) % window;
+		fapo->dequePeaks[tailIdx] = peak;
+		fapo->dequeFrames[tailIdx] = fapo->frame;
+		fapo->dequeCount += 1;
+		if ((fapo->frame - fapo->dequeFrames[fapo->dequeHead]) > fapo->lookahead)
+		{
+			fapo->dequeHead = (fapo->dequeHead + 1) % window;
+			fapo->dequeCount -= 1;
+		}
+
+		/* Drop to the gain the loudest peak in the window needs right
+		 * away, and recover from it slowly. Either way the gain stays
+		 * at or below what every frame in the window allows.
+		 */
+		peak = fapo->dequePeaks[fapo->dequeHead];
+		target = (peak > threshold) ? (threshold / peak) : 1.0f;
+		if (target < fapo->gain)
+		{
+			fapo->gain = target;
+		}
+		else
+		{
+			fapo->gain = target + ((fapo->gain - target) * release);
+		}
+		sum += fapo->gain - fapo->gains[fapo->gainIdx];
+		fapo->gains[fapo->gainIdx] = fapo->gain;
+		fapo->gainIdx += 1;
+		if (fapo->gainIdx == window)
+		{
+			fapo->gainIdx = 0;
+		}
+		gain = sum / window;
+
+		/* Swap this frame into the delay line, the oldest one out */
+		line = fapo->buffer + (fapo->write_idx * fapo->channels);
+		for (c = 0; c < fapo->channels; c += 1)
+		{
+			x = line[c];
+			line[c] = samples[c];
+			samples[c] = x * gain;
+			energy += samples[c] * samples[c];
+		}
+		samples += fapo->channels;
+		fapo->write_idx += 1;
+		if (fapo->write_idx == fapo->lookahead)
+		{
+			fapo->write_idx = 0;
+		}
+	}
+
+	pOutputProcessParameters->BufferFlags = (energy < FAUDIO_EFFECT_TAIL_SILENCE) ?
+		FAPO_BUFFER_SILENT :
+		FAPO_BUFFER_VALID;
+
+	/* Only the look-ahead is left to come out once the input stops */
+	if (FAudio_INTERNAL_EffectTailEnded(&fapo->tail, fapo->lookahead, energy))
+	{
+		FAPOFXMasteringLimiter_INTERNAL_Clear(fapo);
+	}
 
 	FAPOBase_EndProcess(&fapo->base);
 }
 
+void FAPOFXMasteringLimiter_Reset(FAPOFXMasteringLimiter *fapo)
+{
+	FAPOBase_Reset(&fapo->base);
+
+	/* Reset is called before the limiter is locked too */
+	if (fapo->buffer != NULL)
+	{
+		FAPOFXMasteringLimiter_INTERNAL_Clear(fapo);
+	}
+}
+
 void FAPOFXMasteringLimiter_Free(void* fapo)
 {
 	FAPOFXMasteringLimiter *limiter = (FAPOFXMasteringLimiter*) fapo;
+	limiter->base.pFree(limiter->buffer);
 	limiter->base.pFree(limiter->base.m_pParameterBlocks);
 	limiter->base.pFree(fapo);
 }
@@ -211,6 +460,14 @@ uint32_t FAPOFXCreateMasteringLimiter(
 	}
 
 	/* Initialize... */
+	result->channels = 0;
+	result->sampleRate = 0;
+	result->buffer = NULL;
+	result->lookahead = 0;
+	result->maxFrames = 0;
+	result->gain = 1.0f;
+	result->tail.silentFrames = 0;
+	result->tail.idle = 1;
 	FAudio_memcpy(
 		&FXMasteringLimiterProperties_LEGACY.clsid,
 		&FAPOFX_CLSID_FXMasteringLimiter_LEGACY,
@@ -235,8 +492,12 @@ uint32_t FAPOFXCreateMasteringLimiter(
 	/* Function table... */
 	result->base.base.Initialize = (InitializeFunc)
 		FAPOFXMasteringLimiter_Initialize;
+	result->base.base.LockForProcess = (LockForProcessFunc)
+		FAPOFXMasteringLimiter_LockForProcess;
 	result->base.base.Process = (ProcessFunc)
 		FAPOFXMasteringLimiter_Process;
+	result->base.base.Reset = (ResetFunc)
+		FAPOFXMasteringLimiter_Reset;
 	result->base.Destructor = FAPOFXMasteringLimiter_Free;
 
 	/* Finally. */
@@ -25,6 +25,7 @@
  */
 
 #include "FAPOFX.h"
+#include "FAudioFX.h"
 #include "FAudio_internal.h"
 
 /* FXReverb FAPO Implementation */
@@ -121,9 +122,133 @@ typedef struct FAPOFXReverb
 {
 	FAPOBase base;
 
-	/* TODO */
+	uint16_t channels;
+	uint32_t sampleRate;
+
+	/* FXReverb is FAudioFX's reverb network with fewer knobs */
+	DspReverb *reverb;
+	FAudioFXReverbParameters native;
+	FAudioEffectTail tail;
 } FAPOFXReverb;
 
+/* Diffusion scales both diffusion stages of the network. RoomSize scales the
+ * decay time and the delays before the reflections and before the late
+ * reverberation, so that a bigger room takes longer to answer and to die
+ * out. Everything else is left at FAudioFX's defaults, fully wet.
+ */
+static void FAPOFXReverb_INTERNAL_SetParameters(
+	FAPOFXReverb *fapo,
+	const FAPOFXReverbParameters *params
+) {
+	FAudioFXReverbParameters *native = &fapo->native;
+	float diffusion = FAudio_clamp(
+		params->Diffusion,
+		FAPOFXREVERB_MIN_DIFFUSION,
+		FAPOFXREVERB_MAX_DIFFUSION
+	);
+	float roomSize = FAudio_clamp(
+		params->RoomSize,
+		FAPOFXREVERB_MIN_ROOMSIZE,
+		FAPOFXREVERB_MAX_ROOMSIZE
+	);
+
+	native->WetDryMix = FAUDIOFX_REVERB_DEFAULT_WET_DRY_MIX;
+	native->ReflectionsDelay = (uint32_t) (roomSize * 30.0f);
+	native->ReverbDelay = (uint8_t) (roomSize * 30.0f);
+	native->RearDelay = FAUDIOFX_REVERB_DEFAULT_REAR_DELAY;
+	native->PositionLeft = FAUDIOFX_REVERB_DEFAULT_POSITION;
+	native->PositionRight = FAUDIOFX_REVERB_DEFAULT_POSITION;
+	native->PositionMatrixLeft = FAUDIOFX_REVERB_DEFAULT_POSITION_MATRIX;
+	native->PositionMatrixRight = FAUDIOFX_REVERB_DEFAULT_POSITION_MATRIX;
+	native->EarlyDiffusion = (uint8_t) (
+		diffusion * FAUDIOFX_REVERB_MAX_DIFFUSION + 0.5f
+	);
+	native->LateDiffusion = native->EarlyDiffusion;
+	native->LowEQGain = FAUDIOFX_REVERB_DEFAULT_LOW_EQ_GAIN;
+	native->LowEQCutoff = FAUDIOFX_REVERB_DEFAULT_LOW_EQ_CUTOFF;
+	native->HighEQGain = FAUDIOFX_REVERB_DEFAULT_HIGH_EQ_GAIN;
+	native->HighEQCutoff = FAUDIOFX_REVERB_DEFAULT_HIGH_EQ_CUTOFF;
+	native->RoomFilterFreq = FAUDIOFX_REVERB_DEFAULT_ROOM_FILTER_FREQ;
+	native->RoomFilterMain = FAUDIOFX_REVERB_DEFAULT_ROOM_FILTER_MAIN;
+	native->RoomFilterHF = FAUDIOFX_REVERB_DEFAULT_ROOM_FILTER_HF;
+	native->ReflectionsGain = FAUDIOFX_REVERB_DEFAULT_REFLECTIONS_GAIN;
+	native->ReverbGain = FAUDIOFX_REVERB_DEFAULT_REVERB_GAIN;
+	native->DecayTime = FAUDIOFX_REVERB_MIN_DECAY_TIME + (roomSize * 3.0f);
+	native->Density = diffusion * FAUDIOFX_REVERB_MAX_DENSITY;
+	native->RoomSize = roomSize * FAUDIOFX_REVERB_MAX_ROOM_SIZE;
+
+	DspReverb_SetParameters(fapo->reverb, native);
+}
+
+/* How long the network keeps ringing after its input stops */
+static inline uint32_t FAPOFXReverb_INTERNAL_TailFrames(FAPOFXReverb *fapo)
+{
+	return (uint32_t) ((
+		fapo->native.DecayTime +
+		(	fapo->native.ReflectionsDelay +
+			fapo->native.ReverbDelay +
+			fapo->native.RearDelay	) / 1000.0f
+	) * fapo->sampleRate);
+}
+
+uint32_t FAPOFXReverb_LockForProcess(
+	FAPOFXReverb *fapo,
+	uint32_t InputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pInputLockedParameters,
+	uint32_t OutputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pOutputLockedParameters
+) {
+	FAPOFXReverbParameters params;
+	uint16_t channels = pInputLockedParameters->pFormat->nChannels;
+	uint32_t sampleRate = pInputLockedParameters->pFormat->nSamplesPerSec;
+
+	/* The network only runs at these rates, mono or stereo, in place */
+	if (	sampleRate < FAUDIOFX_REVERB_MIN_FRAMERATE ||
+		sampleRate > FAUDIOFX_REVERB_MAX_FRAMERATE ||
+		(channels != 1 && channels != 2)	)
+	{
+		return FAPO_E_FORMAT_UNSUPPORTED;
+	}
+
+	/* The delay lines are sized for the sample rate, so a lock with the
+	 * same format keeps the old network.
+	 */
+	if (	fapo->reverb == NULL ||
+		channels != fapo->channels ||
+		sampleRate != fapo->sampleRate	)
+	{
+		if (fapo->reverb != NULL)
+		{
+			DspReverb_Destroy(fapo->reverb, fapo->base.pFree);
+		}
+		fapo->reverb = DspReverb_Create(
+			sampleRate,
+			channels,
+			channels,
+			fapo->base.pMalloc
+		);
+	}
+	else
+	{
+		DspReverb_Reset(fapo->reverb);
+	}
+	fapo->channels = channels;
+	fapo->sampleRate = sampleRate;
+
+	FAPOBase_GetParameters(&fapo->base, &params, sizeof(params));
+	FAPOFXReverb_INTERNAL_SetParameters(fapo, &params);
+	fapo->tail.silentFrames = 0;
+	fapo->tail.idle = 1;
+
+	return FAPOBase_LockForProcess(
+		&fapo->base,
+		InputLockedParameterCount,
+		pInputLockedParameters,
+		OutputLockedParameterCount,
+		pOutputLockedParameters
+	);
+}
+
 uint32_t FAPOFXReverb_Initialize(
 	FAPOFXReverb *fapo,
 	const void* pData,
@@ -150,16 +275,90 @@ void FAPOFXReverb_Process(
 	FAPOProcessBufferParameters* pOutputProcessParameters,
 	int32_t IsEnabled
 ) {
-	FAPOBase_BeginProcess(&fapo->base);
+	FAPOFXReverbParameters *params;
+	uint8_t update_params = FAPOBase_ParametersChanged(&fapo->base);
+	float *samples = (float*) pInputProcessParameters->pBuffer;
+	uint32_t frames = pInputProcessParameters->ValidFrameCount;
+	float total;
+
+	params = (FAPOFXReverbParameters*) FAPOBase_BeginProcess(&fapo->base);
+	pOutputProcessParameters->BufferFlags = pInputProcessParameters->BufferFlags;
+
+	/* The network's coefficients cost a few exps, only redo them on change */
+	if (update_params)
+	{
+		FAPOFXReverb_INTERNAL_SetParameters(fapo, params);
+	}
 
-	/* TODO */
+	/* Processing is in place, so a disabled reverb has nothing to do */
+	if (!IsEnabled)
+	{
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
+	/* The tail has died out, nothing to do until there is input again */
+	if (FAudio_INTERNAL_EffectTailIdle(
+		&fapo->tail,
+		pInputProcessParameters->BufferFlags,
+		frames
+	)) {
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+		pOutputProcessParameters->BufferFlags = FAPO_BUFFER_SILENT;
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
+	if (pInputProcessParameters->BufferFlags == FAPO_BUFFER_SILENT)
+	{
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+	}
+
+	/* 1 -> 1 and 2 -> 2 are both safe to run in place */
+	total = DspReverb_Process(
+		fapo->reverb,
+		samples,
+		samples,
+		frames * fapo->channels,
+		fapo->channels
+	);
+
+	pOutputProcessParameters->BufferFlags = (total < FAUDIO_EFFECT_TAIL_SILENCE) ?
+		FAPO_BUFFER_SILENT :
+		FAPO_BUFFER_VALID;
+
+	/* Go idle with a clean network, so waking up is like starting over */
+	if (FAudio_INTERNAL_EffectTailEnded(
+		&fapo->tail,
+		FAPOFXReverb_INTERNAL_TailFrames(fapo),
+		total
+	)) {
+		DspReverb_Reset(fapo->reverb);
+	}
 
 	FAPOBase_EndProcess(&fapo->base);
 }
 
+void FAPOFXReverb_Reset(FAPOFXReverb *fapo)
+{
+	FAPOBase_Reset(&fapo->base);
+
+	/* Reset is called before the reverb is locked too */
+	if (fapo->reverb != NULL)
+	{
+		DspReverb_Reset(fapo->reverb);
+	}
+	fapo->tail.silentFrames = 0;
+	fapo->tail.idle = 1;
+}
+
 void FAPOFXReverb_Free(void* fapo)
 {
 	FAPOFXReverb *reverb = (FAPOFXReverb*) fapo;
+	if (reverb->reverb != NULL)
+	{
+		DspReverb_Destroy(reverb->reverb, reverb->base.pFree);
+	}
 	reverb->base.pFree(reverb->base.m_pParameterBlocks);
 	reverb->base.pFree(fapo);
 }
@@ -211,6 +410,12 @@ uint32_t FAPOFXCreateReverb(
 	}
 
 	/* Initialize... */
+	result->channels = 0;
+	result->sampleRate = 0;
+	result->reverb = NULL;
+	FAudio_zero(&result->native, sizeof(result->native));
+	result->tail.silentFrames = 0;
+	result->tail.idle = 1;
 	FAudio_memcpy(
 		&FXReverbProperties_LEGACY.clsid,
 		&FAPOFX_CLSID_FXReverb_LEGACY,
@@ -235,8 +440,12 @@ uint32_t FAPOFXCreateReverb(
 	/* Function table... */
 	result->base.base.Initialize = (InitializeFunc)
 		FAPOFXReverb_Initialize;
+	result->base.base.LockForProcess = (LockForProcessFunc)
+		FAPOFXReverb_LockForProcess;
 	result->base.base.Process = (ProcessFunc)
 		FAPOFXReverb_Process;
+	result->base.base.Reset = (ResetFunc)
+		FAPOFXReverb_Reset;
 	result->base.Destructor = FAPOFXReverb_Free;
 
 	/* Finally. */
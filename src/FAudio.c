@@ -100,6 +100,7 @@ uint32_t FAudioCOMConstructWithCustomAllocatorEXT(
 	FAudioFreeFunc customFree,
 	FAudioReallocFunc customRealloc
 ) {
+	uint32_t i;
 	FAudio_PlatformAddRef();
 	*ppFAudio = (FAudio*) customMalloc(sizeof(FAudio));
 	FAudio_zero(*ppFAudio, sizeof(FAudio));
@@ -114,10 +115,74 @@ uint32_t FAudioCOMConstructWithCustomAllocatorEXT(
 	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->submixLock)
 	(*ppFAudio)->callbackLock = FAudio_PlatformCreateMutex();
 	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->callbackLock)
+	(*ppFAudio)->operationLock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->operationLock)
+	(*ppFAudio)->blockCache.lock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->blockCache.lock)
+	(*ppFAudio)->predecoder.lock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->predecoder.lock)
+	(*ppFAudio)->decoderPool.lock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->decoderPool.lock)
+	(*ppFAudio)->perfLock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->perfLock)
+	(*ppFAudio)->cacheLock = FAudio_PlatformCreateMutex();
+	LOG_MUTEX_CREATE((*ppFAudio), (*ppFAudio)->cacheLock)
+	(*ppFAudio)->perfQueryCycles = FAudio_timecycles();
+	for (i = 0; i < 3; i += 1)
+	{
+		FAudio_INTERNAL_InitThreadSchedule(&(*ppFAudio)->threadSchedules[i]);
+	}
 	(*ppFAudio)->pMalloc = customMalloc;
 	(*ppFAudio)->pFree = customFree;
 	(*ppFAudio)->pRealloc = customRealloc;
+	(*ppFAudio)->bufferPoolSize = FAUDIO_DEFAULT_BUFFER_POOL;
+	(*ppFAudio)->decodeAhead = FAUDIO_DEFAULT_DECODE_AHEAD;
+	(*ppFAudio)->deviceDither = 1;
 	(*ppFAudio)->refcount = 1;
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	/* Traces everything, written out on the final FAudio_Release */
+	if (FAudio_getenv("FAUDIO_TRACE_FILE") != NULL)
+	{
+		FAudio_StartTraceEXT(*ppFAudio, ~0u, 0);
+	}
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+	return 0;
+}
+
+uint32_t FAudio_SetAlignedAllocatorEXT(
+	FAudio *audio,
+	FAudioAlignedMallocFunc customAlignedMalloc,
+	FAudioAlignedFreeFunc customAlignedFree
+) {
+	LOG_API_ENTER(audio)
+
+	/* Every aligned buffer belongs to a voice, so none exist yet */
+	if (	audio->master != NULL ||
+		audio->sources.count > 0 ||
+		audio->submixes.count > 0	)
+	{
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Aligned allocator must be set before any voice is created"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+	if ((customAlignedMalloc == NULL) != (customAlignedFree == NULL))
+	{
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Aligned malloc and free must be set together"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	audio->pAlignedMalloc = customAlignedMalloc;
+	audio->pAlignedFree = customAlignedFree;
+	LOG_API_EXIT(audio)
 	return 0;
 }
 
@@ -131,22 +196,70 @@ uint32_t FAudio_AddRef(FAudio *audio)
 
 uint32_t FAudio_Release(FAudio *audio)
 {
-	uint32_t refcount;
+	uint32_t refcount, i;
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	const char *env;
+	void *file;
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 	LOG_API_ENTER(audio)
 	audio->refcount -= 1;
 	refcount = audio->refcount;
 	if (audio->refcount == 0)
 	{
 		FAudio_StopEngine(audio);
-		audio->pFree(audio->decodeCache);
-		audio->pFree(audio->resampleCache);
-		audio->pFree(audio->effectChainCache);
+		FAudio_INTERNAL_DestroyMixWorkers(audio);
+		FAudio_OPERATIONSET_ClearAll(audio);
+		FAudio_INTERNAL_FreeBufferPool(audio);
+		FAudio_INTERNAL_StopPredecoder(audio);
+		if (audio->taskPool != NULL)
+		{
+			FAudioTaskPoolEXT_Release(audio->taskPool);
+		}
+		FAudio_INTERNAL_FreeBlockCache(audio);
+#ifdef HAVE_FFMPEG
+		FAudio_FFMPEG_freepool(audio);
+#endif /* HAVE_FFMPEG */
+		FAudio_INTERNAL_VoiceTableFree(audio, &audio->sources);
+		FAudio_INTERNAL_VoiceTableFree(audio, &audio->submixes);
 		LOG_MUTEX_DESTROY(audio, audio->sourceLock)
 		FAudio_PlatformDestroyMutex(audio->sourceLock);
 		LOG_MUTEX_DESTROY(audio, audio->submixLock)
 		FAudio_PlatformDestroyMutex(audio->submixLock);
 		LOG_MUTEX_DESTROY(audio, audio->callbackLock)
 		FAudio_PlatformDestroyMutex(audio->callbackLock);
+		LOG_MUTEX_DESTROY(audio, audio->operationLock)
+		FAudio_PlatformDestroyMutex(audio->operationLock);
+		LOG_MUTEX_DESTROY(audio, audio->blockCache.lock)
+		FAudio_PlatformDestroyMutex(audio->blockCache.lock);
+		LOG_MUTEX_DESTROY(audio, audio->predecoder.lock)
+		FAudio_PlatformDestroyMutex(audio->predecoder.lock);
+		LOG_MUTEX_DESTROY(audio, audio->decoderPool.lock)
+		FAudio_PlatformDestroyMutex(audio->decoderPool.lock);
+		LOG_MUTEX_DESTROY(audio, audio->perfLock)
+		FAudio_PlatformDestroyMutex(audio->perfLock);
+		LOG_MUTEX_DESTROY(audio, audio->cacheLock)
+		FAudio_PlatformDestroyMutex(audio->cacheLock);
+		for (i = 0; i < 3; i += 1)
+		{
+			FAudio_INTERNAL_FreeThreadSchedule(&audio->threadSchedules[i]);
+		}
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+		env = FAudio_getenv("FAUDIO_TRACE_FILE");
+		if (env != NULL && audio->trace.eventCount > 0)
+		{
+			file = FAudio_PlatformOpenWriteFile(env);
+			if (file != NULL)
+			{
+				FAudio_INTERNAL_DumpTrace(
+					audio,
+					FAudio_PlatformWriteFile,
+					file
+				);
+				FAudio_PlatformCloseWriteFile(file);
+			}
+		}
+		FAudio_INTERNAL_FreeTrace(audio);
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 		audio->pFree(audio);
 		FAudio_PlatformRelease();
 	}
@@ -181,15 +294,46 @@ uint32_t FAudio_Initialize(
 	uint32_t Flags,
 	FAudioProcessor XAudio2Processor
 ) {
+	uint32_t threads;
+
 	LOG_API_ENTER(audio)
-	FAudio_assert(Flags == 0);
-	FAudio_assert(XAudio2Processor == FAUDIO_DEFAULT_PROCESSOR);
+	FAudio_assert((Flags & ~(
+		FAUDIO_PARALLEL_MIX_EXT |
+		FAUDIO_OFFLINE_RENDER_EXT |
+		FAUDIO_KEEP_DENORMALS_EXT
+	)) == 0);
+
+	audio->offline = (Flags & FAUDIO_OFFLINE_RENDER_EXT) != 0;
+	audio->keepDenormals = (Flags & FAUDIO_KEEP_DENORMALS_EXT) != 0;
+
+	if (Flags & FAUDIO_PARALLEL_MIX_EXT)
+	{
+		/* The processor value is a mask, one mix thread per bit */
+		if (XAudio2Processor == FAUDIO_DEFAULT_PROCESSOR)
+		{
+			/* Or one share per pool thread, plus the audio thread's */
+			threads = (audio->taskPool != NULL) ?
+				audio->taskPool->threadCount + 1 :
+				FAudio_PlatformGetProcessorCount();
+		}
+		else
+		{
+			for (threads = 0; XAudio2Processor != 0; threads += 1)
+			{
+				XAudio2Processor &= XAudio2Processor - 1;
+			}
+		}
+	}
+	else
+	{
+		FAudio_assert(XAudio2Processor == FAUDIO_DEFAULT_PROCESSOR);
+		threads = 1;
+	}
 
 	/* FIXME: This is lazy... */
-	audio->decodeCache = (float*) audio->pMalloc(sizeof(float));
-	audio->resampleCache = (float*) audio->pMalloc(sizeof(float));
 	audio->decodeSamples = 1;
 	audio->resampleSamples = 1;
+	FAudio_INTERNAL_CreateMixWorkers(audio, threads);
 
 	FAudio_StartEngine(audio);
 	LOG_API_EXIT(audio)
@@ -240,7 +384,7 @@ uint32_t FAudio_CreateSourceVoice(
 	LOG_API_ENTER(audio)
 	LOG_FORMAT(audio, pSourceFormat);
 
-	*ppSourceVoice = (FAudioSourceVoice*) audio->pMalloc(sizeof(FAudioVoice));
+	*ppSourceVoice = (FAudioSourceVoice*) FAudio_INTERNAL_Malloc(audio, sizeof(FAudioVoice));
 	FAudio_zero(*ppSourceVoice, sizeof(FAudioSourceVoice));
 	(*ppSourceVoice)->audio = audio;
 	(*ppSourceVoice)->type = FAUDIO_VOICE_SOURCE;
@@ -248,6 +392,7 @@ uint32_t FAudio_CreateSourceVoice(
 	(*ppSourceVoice)->filter.Type = FAUDIO_DEFAULT_FILTER_TYPE;
 	(*ppSourceVoice)->filter.Frequency = FAUDIO_DEFAULT_FILTER_FREQUENCY;
 	(*ppSourceVoice)->filter.OneOverQ = FAUDIO_DEFAULT_FILTER_ONEOVERQ;
+	(*ppSourceVoice)->mixFilter = (*ppSourceVoice)->filter;
 	(*ppSourceVoice)->sendLock = FAudio_PlatformCreateMutex();
 	LOG_MUTEX_CREATE(audio, (*ppSourceVoice)->sendLock)
 	(*ppSourceVoice)->effectLock = FAudio_PlatformCreateMutex();
@@ -266,7 +411,8 @@ uint32_t FAudio_CreateSourceVoice(
 		pSourceFormat->wFormatTag == FAUDIO_FORMAT_XMAUDIO2 ||
 		pSourceFormat->wFormatTag == FAUDIO_FORMAT_WMAUDIO2	)
 	{
-		FAudioWaveFormatExtensible *fmtex = (FAudioWaveFormatExtensible*) audio->pMalloc(
+		FAudioWaveFormatExtensible *fmtex = (FAudioWaveFormatExtensible*) FAudio_INTERNAL_Malloc(
+			audio,
 			sizeof(FAudioWaveFormatExtensible)
 		);
 		/* convert PCM to EXTENSIBLE */
@@ -300,7 +446,8 @@ uint32_t FAudio_CreateSourceVoice(
 	else
 	{
 		/* direct copy anything else */
-		(*ppSourceVoice)->src.format = (FAudioWaveFormatEx*) audio->pMalloc(
+		(*ppSourceVoice)->src.format = (FAudioWaveFormatEx*) FAudio_INTERNAL_Malloc(
+			audio,
 			sizeof(FAudioWaveFormatEx) + pSourceFormat->cbSize
 		);
 		FAudio_memcpy(
@@ -362,6 +509,10 @@ uint32_t FAudio_CreateSourceVoice(
 			{
 				(*ppSourceVoice)->src.decode = FAudio_INTERNAL_DecodeWMAERROR;
 			}
+			else if (Flags & FAUDIO_VOICE_PREDECODE_EXT)
+			{
+				FAudio_INTERNAL_StartPredecoder(audio);
+			}
 #else
 			FAudio_assert(0 && "xWMA is not supported!");
 			(*ppSourceVoice)->src.decode = FAudio_INTERNAL_DecodeWMAERROR;
@@ -378,6 +529,19 @@ uint32_t FAudio_CreateSourceVoice(
 		(*ppSourceVoice)->src.decode = ((*ppSourceVoice)->src.format->nChannels == 2) ?
 			FAudio_INTERNAL_DecodeStereoMSADPCM :
 			FAudio_INTERNAL_DecodeMonoMSADPCM;
+		if (Flags & FAUDIO_VOICE_PREDECODE_EXT)
+		{
+			FAudio_INTERNAL_StartPredecoder(audio);
+		}
+		(*ppSourceVoice)->src.adpcmCacheBlocks = audio->decodeAhead;
+		(*ppSourceVoice)->src.adpcmCache = (float*) FAudio_INTERNAL_AlignedMalloc(
+			audio,
+			sizeof(float) *
+			audio->decodeAhead *
+			(((*ppSourceVoice)->src.format->nBlockAlign / (*ppSourceVoice)->src.format->nChannels) - 6) * 2 *
+			(*ppSourceVoice)->src.format->nChannels,
+			FAUDIO_MEMORY_DECODE
+		);
 	}
 	else
 	{
@@ -397,18 +561,47 @@ uint32_t FAudio_CreateSourceVoice(
 		(*ppSourceVoice)->src.resample = FAudio_INTERNAL_ResampleGeneric;
 	}
 
+	/* Resampler quality, linear unless asked otherwise */
+	if (Flags & FAUDIO_VOICE_RESAMPLE_SINC_EXT)
+	{
+		(*ppSourceVoice)->src.resampleHistory = (float*) FAudio_INTERNAL_Malloc(
+			audio,
+			sizeof(float) *
+			SINC_HISTORY_FRAMES *
+			(*ppSourceVoice)->src.format->nChannels
+		);
+		FAudio_zero(
+			(*ppSourceVoice)->src.resampleHistory,
+			sizeof(float) *
+			SINC_HISTORY_FRAMES *
+			(*ppSourceVoice)->src.format->nChannels
+		);
+	}
+	else if (Flags & FAUDIO_VOICE_RESAMPLE_NEAREST_EXT)
+	{
+		(*ppSourceVoice)->src.resample = FAudio_INTERNAL_ResampleNearest;
+	}
+
 	(*ppSourceVoice)->src.curBufferOffset = 0;
 
+	/* Hold the caches at our size until we're in the table */
+	FAudio_INTERNAL_ReserveCaches(audio);
+
 	/* Sends/Effects */
 	FAudioVoice_SetEffectChain(*ppSourceVoice, pEffectChain);
 	FAudioVoice_SetOutputVoices(*ppSourceVoice, pSendList);
 
 	/* Default Levels */
 	(*ppSourceVoice)->volume = 1.0f;
-	(*ppSourceVoice)->channelVolume = (float*) audio->pMalloc(
-		sizeof(float) * (*ppSourceVoice)->outputChannels
+	(*ppSourceVoice)->channelVolume = (float*) FAudio_INTERNAL_Malloc(
+		audio,
+		sizeof(float) * (*ppSourceVoice)->outputChannels * 2
 	);
-	for (i = 0; i < (*ppSourceVoice)->outputChannels; i += 1)
+	(*ppSourceVoice)->mixChannelVolume = (
+		(*ppSourceVoice)->channelVolume +
+		(*ppSourceVoice)->outputChannels
+	);
+	for (i = 0; i < (*ppSourceVoice)->outputChannels * 2; i += 1)
 	{
 		(*ppSourceVoice)->channelVolume[i] = 1.0f;
 	}
@@ -416,7 +609,8 @@ uint32_t FAudio_CreateSourceVoice(
 	/* Filters */
 	if (Flags & FAUDIO_VOICE_USEFILTER)
 	{
-		(*ppSourceVoice)->filterState = (FAudioFilterState*) audio->pMalloc(
+		(*ppSourceVoice)->filterState = (FAudioFilterState*) FAudio_INTERNAL_Malloc(
+			audio,
 			sizeof(FAudioFilterState) * (*ppSourceVoice)->src.format->nChannels
 		);
 		FAudio_zero(
@@ -426,6 +620,8 @@ uint32_t FAudio_CreateSourceVoice(
 	}
 
 	/* Sample Storage */
+	FAudio_PlatformLockMutex(audio->cacheLock);
+	LOG_MUTEX_LOCK(audio, audio->cacheLock)
 	(*ppSourceVoice)->src.decodeSamples = (uint32_t) FAudio_ceil(
 		audio->updateSize *
 		(double) MaxFrequencyRatio *
@@ -436,16 +632,18 @@ uint32_t FAudio_CreateSourceVoice(
 		audio,
 		(*ppSourceVoice)->src.decodeSamples * (*ppSourceVoice)->src.format->nChannels
 	);
+	FAudio_PlatformUnlockMutex(audio->cacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->cacheLock)
 
 	LOG_INFO(audio, "-> %p", *ppSourceVoice);
 
 	/* Add to list, finally. */
-	LinkedList_PrependEntry(
-		&audio->sources,
-		*ppSourceVoice,
-		audio->sourceLock,
-		audio->pMalloc
-	);
+	FAudio_PlatformLockMutex(audio->sourceLock);
+	LOG_MUTEX_LOCK(audio, audio->sourceLock)
+	FAudio_INTERNAL_VoiceTableAdd(audio, &audio->sources, *ppSourceVoice);
+	FAudio_PlatformUnlockMutex(audio->sourceLock);
+	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
+	FAudio_INTERNAL_UnreserveCaches(audio);
 	FAudio_AddRef(audio);
 
 	LOG_API_EXIT(audio)
@@ -466,7 +664,7 @@ uint32_t FAudio_CreateSubmixVoice(
 
 	LOG_API_ENTER(audio)
 
-	*ppSubmixVoice = (FAudioSubmixVoice*) audio->pMalloc(sizeof(FAudioVoice));
+	*ppSubmixVoice = (FAudioSubmixVoice*) FAudio_INTERNAL_Malloc(audio, sizeof(FAudioVoice));
 	FAudio_zero(*ppSubmixVoice, sizeof(FAudioSubmixVoice));
 	(*ppSubmixVoice)->audio = audio;
 	(*ppSubmixVoice)->type = FAUDIO_VOICE_SUBMIX;
@@ -474,6 +672,7 @@ uint32_t FAudio_CreateSubmixVoice(
 	(*ppSubmixVoice)->filter.Type = FAUDIO_DEFAULT_FILTER_TYPE;
 	(*ppSubmixVoice)->filter.Frequency = FAUDIO_DEFAULT_FILTER_FREQUENCY;
 	(*ppSubmixVoice)->filter.OneOverQ = FAUDIO_DEFAULT_FILTER_ONEOVERQ;
+	(*ppSubmixVoice)->mixFilter = (*ppSubmixVoice)->filter;
 	(*ppSubmixVoice)->sendLock = FAudio_PlatformCreateMutex();
 	LOG_MUTEX_CREATE(audio, (*ppSubmixVoice)->sendLock)
 	(*ppSubmixVoice)->effectLock = FAudio_PlatformCreateMutex();
@@ -488,16 +687,47 @@ uint32_t FAudio_CreateSubmixVoice(
 	(*ppSubmixVoice)->mix.inputSampleRate = InputSampleRate;
 	(*ppSubmixVoice)->mix.processingStage = ProcessingStage;
 
-	/* Sends/Effects */
+	/* Sample Storage, before the sends need the input size */
+	(*ppSubmixVoice)->mix.inputSamples = (uint32_t) FAudio_ceil(
+		audio->updateSize *
+		InputChannels *
+		(double) InputSampleRate /
+		(double) audio->master->master.inputSampleRate
+	);
+	(*ppSubmixVoice)->mix.inputCache = (float*) FAudio_INTERNAL_AlignedMalloc(
+		audio,
+		sizeof(float) * (*ppSubmixVoice)->mix.inputSamples,
+		FAUDIO_MEMORY_SCRATCH
+	);
+	FAudio_zero( /* Zero this now, for the first update */
+		(*ppSubmixVoice)->mix.inputCache,
+		sizeof(float) * (*ppSubmixVoice)->mix.inputSamples
+	);
+	(*ppSubmixVoice)->mix.resampleHistory = (float*) FAudio_INTERNAL_Malloc(
+		audio,
+		sizeof(float) * InputChannels
+	);
+	FAudio_zero(
+		(*ppSubmixVoice)->mix.resampleHistory,
+		sizeof(float) * InputChannels
+	);
+
+	/* Sends/Effects, holding the caches at our size until we're added */
+	FAudio_INTERNAL_ReserveCaches(audio);
 	FAudioVoice_SetEffectChain(*ppSubmixVoice, pEffectChain);
 	FAudioVoice_SetOutputVoices(*ppSubmixVoice, pSendList);
 
 	/* Default Levels */
 	(*ppSubmixVoice)->volume = 1.0f;
-	(*ppSubmixVoice)->channelVolume = (float*) audio->pMalloc(
-		sizeof(float) * (*ppSubmixVoice)->outputChannels
+	(*ppSubmixVoice)->channelVolume = (float*) FAudio_INTERNAL_Malloc(
+		audio,
+		sizeof(float) * (*ppSubmixVoice)->outputChannels * 2
+	);
+	(*ppSubmixVoice)->mixChannelVolume = (
+		(*ppSubmixVoice)->channelVolume +
+		(*ppSubmixVoice)->outputChannels
 	);
-	for (i = 0; i < (*ppSubmixVoice)->outputChannels; i += 1)
+	for (i = 0; i < (*ppSubmixVoice)->outputChannels * 2; i += 1)
 	{
 		(*ppSubmixVoice)->channelVolume[i] = 1.0f;
 	}
@@ -505,7 +735,8 @@ uint32_t FAudio_CreateSubmixVoice(
 	/* Filters */
 	if (Flags & FAUDIO_VOICE_USEFILTER)
 	{
-		(*ppSubmixVoice)->filterState = (FAudioFilterState*) audio->pMalloc(
+		(*ppSubmixVoice)->filterState = (FAudioFilterState*) FAudio_INTERNAL_Malloc(
+			audio,
 			sizeof(FAudioFilterState) * InputChannels
 		);
 		FAudio_zero(
@@ -514,28 +745,14 @@ uint32_t FAudio_CreateSubmixVoice(
 		);
 	}
 
-	/* Sample Storage */
-	(*ppSubmixVoice)->mix.inputSamples = (uint32_t) FAudio_ceil(
-		audio->updateSize *
-		InputChannels *
-		(double) InputSampleRate /
-		(double) audio->master->master.inputSampleRate
-	);
-	(*ppSubmixVoice)->mix.inputCache = (float*) audio->pMalloc(
-		sizeof(float) * (*ppSubmixVoice)->mix.inputSamples
-	);
-	FAudio_zero( /* Zero this now, for the first update */
-		(*ppSubmixVoice)->mix.inputCache,
-		sizeof(float) * (*ppSubmixVoice)->mix.inputSamples
-	);
-
-	/* Add to list, finally. */
-	FAudio_INTERNAL_InsertSubmixSorted(
-		&audio->submixes,
-		*ppSubmixVoice,
-		audio->submixLock,
-		audio->pMalloc
-	);
+	/* Add to list, finally. The graph puts it in stage order. */
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+	FAudio_INTERNAL_VoiceTableAdd(audio, &audio->submixes, *ppSubmixVoice);
+	FAudio_INTERNAL_InvalidateSubmixGraph(audio);
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+	FAudio_INTERNAL_UnreserveCaches(audio);
 	FAudio_AddRef(audio);
 
 	LOG_API_EXIT(audio)
@@ -558,7 +775,7 @@ uint32_t FAudio_CreateMasteringVoice(
 	/* For now we only support one allocated master voice at a time */
 	FAudio_assert(audio->master == NULL);
 
-	*ppMasteringVoice = (FAudioMasteringVoice*) audio->pMalloc(sizeof(FAudioVoice));
+	*ppMasteringVoice = (FAudioMasteringVoice*) FAudio_INTERNAL_Malloc(audio, sizeof(FAudioVoice));
 	FAudio_zero(*ppMasteringVoice, sizeof(FAudioMasteringVoice));
 	(*ppMasteringVoice)->audio = audio;
 	(*ppMasteringVoice)->type = FAUDIO_VOICE_MASTER;
@@ -580,15 +797,18 @@ uint32_t FAudio_CreateMasteringVoice(
 		details.OutputFormat.Format.nSamplesPerSec :
 		InputSampleRate;
 
-	/* Sends/Effects */
+	/* Sends */
 	FAudio_zero(&(*ppMasteringVoice)->sends, sizeof(FAudioVoiceSends));
-	FAudioVoice_SetEffectChain(*ppMasteringVoice, pEffectChain);
 
 	/* Platform Device */
 	audio->master = *ppMasteringVoice;
 	FAudio_AddRef(audio);
+	FAudio_INTERNAL_ResizeBufferPool(audio);
 	FAudio_PlatformInit(audio, DeviceIndex);
 
+	/* Effects, now that the device has decided updateSize and the format */
+	FAudioVoice_SetEffectChain(*ppMasteringVoice, pEffectChain);
+
 	LOG_API_EXIT(audio)
 	return 0;
 }
@@ -651,116 +871,588 @@ void FAudio_SetEngineProcedureEXT(
 	LOG_API_EXIT(audio)
 }
 
-uint32_t FAudio_StartEngine(FAudio *audio)
-{
+uint32_t FAudio_SetDevicePeriodEXT(
+	FAudio *audio,
+	uint32_t periodFrames
+) {
 	LOG_API_ENTER(audio)
-	audio->active = 1;
+
+	/* The period is fixed once the device is open */
+	if (audio->master != NULL)
+	{
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Device period must be set before the mastering voice is created"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	audio->devicePeriod = periodFrames;
 	LOG_API_EXIT(audio)
 	return 0;
 }
 
-void FAudio_StopEngine(FAudio *audio)
-{
+void FAudio_GetDevicePeriodEXT(
+	FAudio *audio,
+	uint32_t *periodFrames,
+	uint32_t *latencyFrames
+) {
 	LOG_API_ENTER(audio)
-	audio->active = 0;
+	if (audio->master == NULL)
+	{
+		*periodFrames = 0;
+		*latencyFrames = 0;
+	}
+	else
+	{
+		*periodFrames = audio->updateSize;
+		*latencyFrames = audio->deviceLatency;
+	}
 	LOG_API_EXIT(audio)
 }
 
-uint32_t FAudio_CommitChanges(FAudio *audio)
-{
+uint32_t FAudio_SetRenderAheadEXT(
+	FAudio *audio,
+	uint32_t periods
+) {
 	LOG_API_ENTER(audio)
-	FAudio_assert(0 && "Batching is not supported!");
+
+	/* The render thread is started along with the device */
+	if (audio->master != NULL)
+	{
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Render-ahead must be set before the mastering voice is created"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+	if (periods > FAUDIO_MAX_RENDER_AHEAD_EXT)
+	{
+		LOG_ERROR(
+			audio,
+			"Render-ahead of %u periods is over the limit of %u",
+			periods,
+			FAUDIO_MAX_RENDER_AHEAD_EXT
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	audio->renderAhead = periods;
 	LOG_API_EXIT(audio)
 	return 0;
 }
 
-void FAudio_GetPerformanceData(
+void FAudio_GetRenderAheadEXT(
 	FAudio *audio,
-	FAudioPerformanceData *pPerfData
+	uint32_t *periods,
+	uint32_t *underruns
 ) {
-	LinkedList *list;
-	FAudioSourceVoice *source;
-
 	LOG_API_ENTER(audio)
+	*periods = audio->renderAhead;
+	*underruns = audio->renderUnderruns;
+	LOG_API_EXIT(audio)
+}
 
-	FAudio_zero(pPerfData, sizeof(FAudioPerformanceData));
+uint32_t FAudio_SetDeviceFormatEXT(
+	FAudio *audio,
+	uint32_t format,
+	uint8_t dither
+) {
+	LOG_API_ENTER(audio)
 
-	FAudio_PlatformLockMutex(audio->sourceLock);
-	LOG_MUTEX_LOCK(audio, audio->sourceLock)
-	list = audio->sources;
-	while (list != NULL)
+	/* The format is picked when the device is opened */
+	if (audio->master != NULL)
 	{
-		source = (FAudioSourceVoice*) list->entry;
-		pPerfData->TotalSourceVoiceCount += 1;
-		if (source->src.active)
-		{
-			pPerfData->ActiveSourceVoiceCount += 1;
-		}
-		list = list->next;
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Device format must be set before the mastering voice is created"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
 	}
-	FAudio_PlatformUnlockMutex(audio->sourceLock);
-	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
-
-	FAudio_PlatformLockMutex(audio->submixLock);
-	LOG_MUTEX_LOCK(audio, audio->submixLock)
-	list = audio->submixes;
-	while (list != NULL)
+	if (format > FAUDIO_DEVICE_FORMAT_S32_EXT)
 	{
-		pPerfData->ActiveSubmixVoiceCount += 1;
-		list = list->next;
+		LOG_ERROR(
+			audio,
+			"Unknown device format %u",
+			format
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
 	}
-	FAudio_PlatformUnlockMutex(audio->submixLock);
-	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
 
+	audio->deviceFormatRequest = format;
+	audio->deviceDither = dither != 0;
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+void FAudio_GetDeviceFormatEXT(
+	FAudio *audio,
+	uint32_t *format,
+	uint8_t *dither
+) {
+	LOG_API_ENTER(audio)
+	*format = (audio->master == NULL) ?
+		FAUDIO_DEVICE_FORMAT_DEFAULT_EXT :
+		audio->deviceFormat;
+	*dither = audio->deviceDither && (
+		*format == FAUDIO_DEVICE_FORMAT_S16_EXT ||
+		*format == FAUDIO_DEVICE_FORMAT_S24_EXT
+	);
+	LOG_API_EXIT(audio)
+}
+
+uint32_t FAudio_SetBufferPoolEXT(
+	FAudio *audio,
+	uint32_t capacity
+) {
+	LOG_API_ENTER(audio)
+
+	/* The pool is allocated along with the mastering voice */
 	if (audio->master != NULL)
 	{
-		/* estimate, should use real latency from platform */
-		pPerfData->CurrentLatencyInSamples = 2 * audio->updateSize;
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Buffer pool must be set before the mastering voice is created"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+	if (capacity > FAUDIO_MAX_BUFFER_POOL_EXT)
+	{
+		LOG_ERROR(
+			audio,
+			"Buffer pool of %u entries is over the limit of %u",
+			capacity,
+			FAUDIO_MAX_BUFFER_POOL_EXT
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
 	}
 
+	audio->bufferPoolSize = capacity;
 	LOG_API_EXIT(audio)
+	return 0;
 }
 
-void FAudio_SetDebugConfiguration(
+void FAudio_GetBufferPoolEXT(
 	FAudio *audio,
-	FAudioDebugConfiguration *pDebugConfiguration,
-	void* pReserved
+	uint32_t *capacity,
+	uint32_t *overflows
 ) {
-#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
-	char *env;
-
 	LOG_API_ENTER(audio)
-
-	FAudio_memcpy(
-		&audio->debug,
-		pDebugConfiguration,
-		sizeof(FAudioDebugConfiguration)
+	*capacity = audio->bufferPool.capacity;
+	*overflows = (uint32_t) FAudio_PlatformAtomicGet(
+		&audio->bufferPool.overflows
 	);
+	LOG_API_EXIT(audio)
+}
 
-	env = FAudio_getenv("FAUDIO_LOG_EVERYTHING");
-	if (env != NULL && *env == '1')
+uint32_t FAudio_SetDecodeAheadEXT(
+	FAudio *audio,
+	uint32_t blocks
+) {
+	LOG_API_ENTER(audio)
+
+	if (blocks == 0 || blocks > FAUDIO_MAX_DECODE_AHEAD_EXT)
 	{
-		audio->debug.TraceMask = (
-			FAUDIO_LOG_ERRORS |
-			FAUDIO_LOG_WARNINGS |
-			FAUDIO_LOG_INFO |
-			FAUDIO_LOG_DETAIL |
-			FAUDIO_LOG_API_CALLS |
-			FAUDIO_LOG_FUNC_CALLS |
-			FAUDIO_LOG_TIMING |
-			FAUDIO_LOG_LOCKS |
-			FAUDIO_LOG_MEMORY |
-			FAUDIO_LOG_STREAMING
-		);
-		audio->debug.LogThreadID = 1;
-		audio->debug.LogFunctionName = 1;
-		audio->debug.LogTiming = 1;
+		LOG_ERROR(
+			audio,
+			"Decode ahead of %u blocks is not in [1, %u]",
+			blocks,
+			FAUDIO_MAX_DECODE_AHEAD_EXT
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
 	}
 
-	#define CHECK_ENV(type) \
-		env = FAudio_getenv("FAUDIO_LOG_" #type); \
-		if (env != NULL) \
-		{ \
+	/* Existing voices keep the window they were created with */
+	audio->decodeAhead = blocks;
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+void FAudio_GetDecodeAheadEXT(
+	FAudio *audio,
+	uint32_t *blocks
+) {
+	LOG_API_ENTER(audio)
+	*blocks = audio->decodeAhead;
+	LOG_API_EXIT(audio)
+}
+
+uint32_t FAudio_SetBlockCacheEXT(
+	FAudio *audio,
+	uint32_t bytes
+) {
+	LOG_API_ENTER(audio)
+
+	FAudio_PlatformLockMutex(audio->blockCache.lock);
+	LOG_MUTEX_LOCK(audio, audio->blockCache.lock)
+	audio->blockCache.budget = bytes;
+	FAudio_INTERNAL_BlockCacheTrim(audio);
+	FAudio_PlatformUnlockMutex(audio->blockCache.lock);
+	LOG_MUTEX_UNLOCK(audio, audio->blockCache.lock)
+
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+void FAudio_GetBlockCacheEXT(
+	FAudio *audio,
+	uint32_t *bytes,
+	uint32_t *used,
+	uint32_t *hits,
+	uint32_t *misses
+) {
+	LOG_API_ENTER(audio)
+
+	FAudio_PlatformLockMutex(audio->blockCache.lock);
+	LOG_MUTEX_LOCK(audio, audio->blockCache.lock)
+	*bytes = audio->blockCache.budget;
+	*used = audio->blockCache.used;
+	*hits = audio->blockCache.hits;
+	*misses = audio->blockCache.misses;
+	FAudio_PlatformUnlockMutex(audio->blockCache.lock);
+	LOG_MUTEX_UNLOCK(audio, audio->blockCache.lock)
+
+	LOG_API_EXIT(audio)
+}
+
+uint32_t FAudio_WarmDecoderPoolEXT(
+	FAudio *audio,
+	const FAudioWaveFormatEx *pFormat,
+	uint32_t count
+) {
+	uint32_t result;
+	LOG_API_ENTER(audio)
+#ifdef HAVE_FFMPEG
+	result = FAudio_FFMPEG_warm(audio, pFormat, count);
+#else
+	LOG_ERROR(audio, "%s", "Decoder pool needs FFmpeg support")
+	result = FAUDIO_E_UNSUPPORTED_FORMAT;
+#endif /* HAVE_FFMPEG */
+	LOG_API_EXIT(audio)
+	return result;
+}
+
+void FAudio_FlushDecoderPoolEXT(FAudio *audio)
+{
+	LOG_API_ENTER(audio)
+#ifdef HAVE_FFMPEG
+	FAudio_FFMPEG_freepool(audio);
+#endif /* HAVE_FFMPEG */
+	LOG_API_EXIT(audio)
+}
+
+void FAudio_GetDecoderPoolEXT(
+	FAudio *audio,
+	uint32_t *idle,
+	uint32_t *hits,
+	uint32_t *misses
+) {
+	LOG_API_ENTER(audio)
+
+	FAudio_PlatformLockMutex(audio->decoderPool.lock);
+	LOG_MUTEX_LOCK(audio, audio->decoderPool.lock)
+	*idle = audio->decoderPool.idle;
+	*hits = audio->decoderPool.hits;
+	*misses = audio->decoderPool.misses;
+	FAudio_PlatformUnlockMutex(audio->decoderPool.lock);
+	LOG_MUTEX_UNLOCK(audio, audio->decoderPool.lock)
+
+	LOG_API_EXIT(audio)
+}
+
+uint32_t FAudio_SetThreadSchedulingEXT(
+	FAudio *audio,
+	uint32_t thread,
+	uint32_t flags,
+	uint64_t affinityMask
+) {
+	LOG_API_ENTER(audio)
+	if (thread > FAUDIO_THREAD_PREDECODE_EXT)
+	{
+		LOG_ERROR(audio, "Unknown thread %u", thread)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	/* Each thread picks this up the next time it wakes up */
+	FAudio_INTERNAL_SetThreadSchedule(
+		&audio->threadSchedules[thread],
+		flags,
+		affinityMask
+	);
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_GetThreadSchedulingEXT(
+	FAudio *audio,
+	uint32_t thread,
+	uint32_t *granted
+) {
+	LOG_API_ENTER(audio)
+	if (thread > FAUDIO_THREAD_PREDECODE_EXT)
+	{
+		LOG_ERROR(audio, "Unknown thread %u", thread)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	FAudio_PlatformLockMutex(audio->threadSchedules[thread].lock);
+	*granted = audio->threadSchedules[thread].granted;
+	FAudio_PlatformUnlockMutex(audio->threadSchedules[thread].lock);
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_RenderEXT(
+	FAudio *audio,
+	float *output,
+	uint32_t frames
+) {
+	uint32_t channels, chunk;
+
+	LOG_API_ENTER(audio)
+
+	if (!audio->offline || audio->master == NULL)
+	{
+		LOG_ERROR(
+			audio,
+			"%s",
+			"RenderEXT needs FAUDIO_OFFLINE_RENDER_EXT and a mastering voice"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+	channels = audio->master->master.inputChannels;
+
+	if (audio->offlineCache == NULL)
+	{
+		audio->offlineCache = (float*) FAudio_INTERNAL_AlignedMalloc(
+			audio,
+			sizeof(float) * audio->updateSize * channels,
+			FAUDIO_MEMORY_SCRATCH
+		);
+		audio->offlineCacheOffset = audio->updateSize;
+	}
+
+	while (frames > 0)
+	{
+		/* Whole periods go straight to the client... */
+		if (	audio->offlineCacheOffset == audio->updateSize &&
+			frames >= audio->updateSize	)
+		{
+			FAudio_zero(
+				output,
+				sizeof(float) * audio->updateSize * channels
+			);
+			if (audio->active)
+			{
+				FAudio_INTERNAL_UpdateEngine(audio, output);
+			}
+			output += audio->updateSize * channels;
+			frames -= audio->updateSize;
+			continue;
+		}
+
+		/* ... the rest goes through the cache */
+		if (audio->offlineCacheOffset == audio->updateSize)
+		{
+			FAudio_zero(
+				audio->offlineCache,
+				sizeof(float) * audio->updateSize * channels
+			);
+			if (audio->active)
+			{
+				FAudio_INTERNAL_UpdateEngine(
+					audio,
+					audio->offlineCache
+				);
+			}
+			audio->offlineCacheOffset = 0;
+		}
+		chunk = FAudio_min(
+			frames,
+			audio->updateSize - audio->offlineCacheOffset
+		);
+		FAudio_memcpy(
+			output,
+			audio->offlineCache + audio->offlineCacheOffset * channels,
+			sizeof(float) * chunk * channels
+		);
+		audio->offlineCacheOffset += chunk;
+		output += chunk * channels;
+		frames -= chunk;
+	}
+
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_StartEngine(FAudio *audio)
+{
+	LOG_API_ENTER(audio)
+	audio->active = 1;
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+void FAudio_StopEngine(FAudio *audio)
+{
+	LOG_API_ENTER(audio)
+	audio->active = 0;
+	LOG_API_EXIT(audio)
+}
+
+uint32_t FAudio_CommitOperationSet(FAudio *audio, uint32_t OperationSet)
+{
+	LOG_API_ENTER(audio)
+	FAudio_OPERATIONSET_Commit(audio, OperationSet);
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_CommitChanges(FAudio *audio)
+{
+	LOG_API_ENTER(audio)
+	FAudio_OPERATIONSET_Commit(audio, FAUDIO_COMMIT_ALL);
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+void FAudio_GetPerformanceData(
+	FAudio *audio,
+	FAudioPerformanceData *pPerfData
+) {
+	uint32_t i;
+	uint64_t now;
+	FAudioVoice *voice;
+
+	LOG_API_ENTER(audio)
+
+	FAudio_zero(pPerfData, sizeof(FAudioPerformanceData));
+
+	/* Cycles are counted between queries, like XAudio2 */
+	FAudio_PlatformLockMutex(audio->perfLock);
+	LOG_MUTEX_LOCK(audio, audio->perfLock)
+	now = FAudio_timecycles();
+	pPerfData->AudioCyclesSinceLastQuery = audio->perfAudioCycles;
+	pPerfData->TotalCyclesSinceLastQuery = now - audio->perfQueryCycles;
+	pPerfData->MinimumCyclesPerQuantum = audio->perfMinCycles;
+	pPerfData->MaximumCyclesPerQuantum = audio->perfMaxCycles;
+	audio->perfQueryCycles = now;
+	audio->perfAudioCycles = 0;
+	audio->perfMinCycles = 0;
+	audio->perfMaxCycles = 0;
+	FAudio_PlatformUnlockMutex(audio->perfLock);
+	LOG_MUTEX_UNLOCK(audio, audio->perfLock)
+
+	/* Every active voice that resamples has a resampler, and every send
+	 * of an active voice is a matrix mix
+	 */
+	FAudio_PlatformLockMutex(audio->sourceLock);
+	LOG_MUTEX_LOCK(audio, audio->sourceLock)
+	pPerfData->TotalSourceVoiceCount = audio->sources.count;
+	for (i = 0; i < audio->sources.count; i += 1)
+	{
+		voice = audio->sources.voices[i];
+		if (voice->src.active)
+		{
+			pPerfData->ActiveSourceVoiceCount += 1;
+			pPerfData->ActiveMatrixMixCount += voice->sends.SendCount;
+			if (voice->src.resampleStep != FIXED_ONE)
+			{
+				pPerfData->ActiveResamplerCount += 1;
+			}
+		}
+	}
+	FAudio_PlatformUnlockMutex(audio->sourceLock);
+	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
+
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+	pPerfData->ActiveSubmixVoiceCount = audio->submixes.count;
+	for (i = 0; i < audio->submixes.count; i += 1)
+	{
+		voice = audio->submixes.voices[i];
+		pPerfData->ActiveMatrixMixCount += voice->sends.SendCount;
+		if (voice->mix.resampleStep != FIXED_ONE)
+		{
+			pPerfData->ActiveResamplerCount += 1;
+		}
+	}
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+
+	/* The FAudio itself comes straight from the client's allocator */
+	pPerfData->MemoryUsageInBytes = (
+		sizeof(FAudio) +
+		(uint32_t) FAudio_PlatformAtomicGet(&audio->memoryUsage)
+	);
+
+	if (audio->master != NULL)
+	{
+		pPerfData->CurrentLatencyInSamples = audio->deviceLatency;
+		pPerfData->GlitchesSinceEngineStarted = (
+			audio->renderUnderruns +
+			audio->lateCallbacks
+		);
+	}
+
+	LOG_API_EXIT(audio)
+}
+
+void FAudio_SetDebugConfiguration(
+	FAudio *audio,
+	FAudioDebugConfiguration *pDebugConfiguration,
+	void* pReserved
+) {
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	char *env;
+
+	LOG_API_ENTER(audio)
+
+	FAudio_memcpy(
+		&audio->debug,
+		pDebugConfiguration,
+		sizeof(FAudioDebugConfiguration)
+	);
+
+	env = FAudio_getenv("FAUDIO_LOG_EVERYTHING");
+	if (env != NULL && *env == '1')
+	{
+		audio->debug.TraceMask = (
+			FAUDIO_LOG_ERRORS |
+			FAUDIO_LOG_WARNINGS |
+			FAUDIO_LOG_INFO |
+			FAUDIO_LOG_DETAIL |
+			FAUDIO_LOG_API_CALLS |
+			FAUDIO_LOG_FUNC_CALLS |
+			FAUDIO_LOG_TIMING |
+			FAUDIO_LOG_LOCKS |
+			FAUDIO_LOG_MEMORY |
+			FAUDIO_LOG_STREAMING
+		);
+		audio->debug.LogThreadID = 1;
+		audio->debug.LogFunctionName = 1;
+		audio->debug.LogTiming = 1;
+	}
+
+	#define CHECK_ENV(type) \
+		env = FAudio_getenv("FAUDIO_LOG_" #type); \
+		if (env != NULL) \
+		{ \
 			if (*env == '1') \
 			{ \
 				audio->debug.TraceMask |= FAUDIO_LOG_##type; \
@@ -794,7 +1486,387 @@ void FAudio_SetDebugConfiguration(
 	#undef CHECK_ENV
 
 	LOG_API_EXIT(audio)
-#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+}
+
+uint32_t FAudio_StartTraceEXT(
+	FAudio *audio,
+	uint32_t traceMask,
+	uint32_t eventsPerThread
+) {
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	uint32_t eventCount = 1;
+
+	LOG_API_ENTER(audio)
+
+	if (eventsPerThread == 0)
+	{
+		eventsPerThread = FAUDIO_DEFAULT_TRACE_EVENTS_EXT;
+	}
+	if (eventsPerThread > FAUDIO_MAX_TRACE_EVENTS)
+	{
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_ARG;
+	}
+	while (eventCount < eventsPerThread)
+	{
+		eventCount <<= 1;
+	}
+
+	/* Rings that already exist keep their size, and their old events
+	 * are left out of dumps from now on
+	 */
+	audio->trace.mask = 0;
+	audio->trace.eventCount = eventCount;
+	audio->trace.startCycles = FAudio_timecycles();
+	audio->trace.startTime = FAudio_timeus();
+	audio->trace.droppedEvents = 0;
+	audio->trace.mask = traceMask;
+
+	LOG_API_EXIT(audio)
+	return 0;
+#else
+	return FAUDIO_E_INVALID_CALL;
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+}
+
+void FAudio_StopTraceEXT(FAudio *audio)
+{
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	LOG_API_ENTER(audio)
+	audio->trace.mask = 0;
+	LOG_API_EXIT(audio)
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+}
+
+uint32_t FAudio_DumpTraceEXT(
+	FAudio *audio,
+	FAudioTraceWriteFuncEXT writeFunc,
+	void *user
+) {
+#ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
+	uint32_t result;
+
+	LOG_API_ENTER(audio)
+
+	if (writeFunc == NULL)
+	{
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_ARG;
+	}
+	if (audio->trace.eventCount == 0)
+	{
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+	result = FAudio_INTERNAL_DumpTrace(audio, writeFunc, user);
+
+	LOG_API_EXIT(audio)
+	return result;
+#else
+	return FAUDIO_E_INVALID_CALL;
+#endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
+}
+
+static FAudioMutex FAudio_INTERNAL_GetEngineLock(FAudio *audio, uint32_t lock)
+{
+	switch (lock)
+	{
+	case FAUDIO_LOCK_SOURCE_EXT:
+		return audio->sourceLock;
+	case FAUDIO_LOCK_SUBMIX_EXT:
+		return audio->submixLock;
+	case FAUDIO_LOCK_CALLBACK_EXT:
+		return audio->callbackLock;
+	case FAUDIO_LOCK_OPERATION_EXT:
+		return audio->operationLock;
+	case FAUDIO_LOCK_BLOCK_CACHE_EXT:
+		return audio->blockCache.lock;
+	case FAUDIO_LOCK_PREDECODE_EXT:
+		return audio->predecoder.lock;
+	case FAUDIO_LOCK_DECODER_POOL_EXT:
+		return audio->decoderPool.lock;
+	case FAUDIO_LOCK_PERFORMANCE_EXT:
+		return audio->perfLock;
+	default:
+		return NULL;
+	}
+}
+
+static FAudioMutex FAudio_INTERNAL_GetVoiceLock(
+	FAudioVoice *voice,
+	uint32_t lock
+) {
+	switch (lock)
+	{
+	case FAUDIO_LOCK_VOICE_SEND_EXT:
+		return voice->sendLock;
+	case FAUDIO_LOCK_VOICE_EFFECT_EXT:
+		return voice->effectLock;
+	case FAUDIO_LOCK_VOICE_FILTER_EXT:
+		return voice->filterLock;
+	case FAUDIO_LOCK_VOICE_VOLUME_EXT:
+		return voice->volumeLock;
+	case FAUDIO_LOCK_VOICE_BUFFER_EXT:
+		if (voice->type == FAUDIO_VOICE_SOURCE)
+		{
+			return voice->src.bufferLock;
+		}
+		return NULL;
+	default:
+		return NULL;
+	}
+}
+
+/* Keeps a destroyed voice's counters in the engine's totals */
+static void FAudio_INTERNAL_RetireVoiceLocks(FAudioVoice *voice)
+{
+#ifndef FAUDIO_DISABLE_LOCK_STATS
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(voice->audio->perfLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->audio->perfLock)
+	for (i = FAUDIO_LOCK_VOICE_SEND_EXT; i < FAUDIO_LOCK_COUNT_EXT; i += 1)
+	{
+		FAudio_PlatformGetMutexStats(
+			FAudio_INTERNAL_GetVoiceLock(voice, i),
+			&voice->audio->retiredLockStats[i]
+		);
+	}
+	FAudio_PlatformUnlockMutex(voice->audio->perfLock);
+	LOG_MUTEX_UNLOCK(voice->audio, voice->audio->perfLock)
+#endif /* FAUDIO_DISABLE_LOCK_STATS */
+}
+
+uint32_t FAudio_GetLockStatsEXT(
+	FAudio *audio,
+	uint32_t lock,
+	FAudioLockStatsEXT *pStats
+) {
+#ifndef FAUDIO_DISABLE_LOCK_STATS
+	uint32_t i;
+
+	LOG_API_ENTER(audio)
+	FAudio_zero(pStats, sizeof(FAudioLockStatsEXT));
+
+	if (lock >= FAUDIO_LOCK_COUNT_EXT)
+	{
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	if (lock < FAUDIO_LOCK_VOICE_SEND_EXT)
+	{
+		FAudio_PlatformGetMutexStats(
+			FAudio_INTERNAL_GetEngineLock(audio, lock),
+			pStats
+		);
+		LOG_API_EXIT(audio)
+		return 0;
+	}
+
+	/* Voice locks are the sum over every voice, destroyed ones included */
+	FAudio_PlatformLockMutex(audio->perfLock);
+	LOG_MUTEX_LOCK(audio, audio->perfLock)
+	FAudio_memcpy(
+		pStats,
+		&audio->retiredLockStats[lock],
+		sizeof(FAudioLockStatsEXT)
+	);
+	FAudio_PlatformUnlockMutex(audio->perfLock);
+	LOG_MUTEX_UNLOCK(audio, audio->perfLock)
+
+	FAudio_PlatformLockMutex(audio->sourceLock);
+	LOG_MUTEX_LOCK(audio, audio->sourceLock)
+	for (i = 0; i < audio->sources.count; i += 1)
+	{
+		FAudio_PlatformGetMutexStats(
+			FAudio_INTERNAL_GetVoiceLock(audio->sources.voices[i], lock),
+			pStats
+		);
+	}
+	FAudio_PlatformUnlockMutex(audio->sourceLock);
+	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
+
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+	for (i = 0; i < audio->submixes.count; i += 1)
+	{
+		FAudio_PlatformGetMutexStats(
+			FAudio_INTERNAL_GetVoiceLock(audio->submixes.voices[i], lock),
+			pStats
+		);
+	}
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+
+	if (audio->master != NULL)
+	{
+		FAudio_PlatformGetMutexStats(
+			FAudio_INTERNAL_GetVoiceLock(audio->master, lock),
+			pStats
+		);
+	}
+
+	LOG_API_EXIT(audio)
+	return 0;
+#else
+	LOG_API_ENTER(audio)
+	FAudio_zero(pStats, sizeof(FAudioLockStatsEXT));
+	LOG_API_EXIT(audio)
+	return FAUDIO_E_INVALID_CALL;
+#endif /* FAUDIO_DISABLE_LOCK_STATS */
+}
+
+uint32_t FAudio_SetSubBlockSizeEXT(
+	FAudio *audio,
+	uint32_t frames
+) {
+	LOG_API_ENTER(audio)
+
+	if (frames != 0 && (frames < FAUDIO_MIN_SUB_BLOCK_EXT || (frames % 4) != 0))
+	{
+		LOG_ERROR(
+			audio,
+			"Sub-block of %u frames is not 0 or a multiple of 4 from %u",
+			frames,
+			FAUDIO_MIN_SUB_BLOCK_EXT
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	/* The mixer picks this up on its next pass */
+	audio->subBlockFrames = frames;
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+void FAudio_GetSubBlockSizeEXT(
+	FAudio *audio,
+	uint32_t *frames
+) {
+	LOG_API_ENTER(audio)
+	*frames = audio->subBlockFrames;
+	LOG_API_EXIT(audio)
+}
+
+uint32_t FAudio_SetTaskPoolEXT(FAudio *audio, FAudioTaskPoolEXT *pool)
+{
+	LOG_API_ENTER(audio)
+
+	/* The mix workers are made in Initialize, the predecoder after that */
+	if (audio->mixWorkers != NULL)
+	{
+		LOG_ERROR(
+			audio,
+			"%s",
+			"Task pools must be set before FAudio_Initialize"
+		)
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	if (pool != NULL)
+	{
+		FAudioTaskPoolEXT_AddRef(pool);
+	}
+	if (audio->taskPool != NULL)
+	{
+		FAudioTaskPoolEXT_Release(audio->taskPool);
+	}
+	audio->taskPool = pool;
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_GetMemoryUsageEXT(
+	FAudio *audio,
+	FAudioMemoryUsageEXT *pUsage
+) {
+	LOG_API_ENTER(audio)
+	pUsage->ScratchBytes = (uint32_t) FAudio_PlatformAtomicGet(
+		&audio->memoryCategories[FAUDIO_MEMORY_SCRATCH]
+	);
+	pUsage->VoiceBytes = (uint32_t) FAudio_PlatformAtomicGet(
+		&audio->memoryCategories[FAUDIO_MEMORY_VOICES]
+	);
+	pUsage->EffectBytes = (uint32_t) FAudio_PlatformAtomicGet(
+		&audio->memoryCategories[FAUDIO_MEMORY_EFFECTS]
+	);
+	pUsage->DecodeBytes = (uint32_t) FAudio_PlatformAtomicGet(
+		&audio->memoryCategories[FAUDIO_MEMORY_DECODE]
+	);
+
+	/* Summed rather than read separately, so the parts add up */
+	pUsage->TotalBytes = (
+		sizeof(FAudio) +
+		pUsage->ScratchBytes +
+		pUsage->VoiceBytes +
+		pUsage->EffectBytes +
+		pUsage->DecodeBytes
+	);
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_TrimEXT(FAudio *audio)
+{
+	LOG_API_ENTER(audio)
+
+	/* The caches only ever grow, to the largest voice there has ever
+	 * been. The mixer works out the sizes again from the voices that are
+	 * still here at the start of its next pass, see
+	 * FAudio_INTERNAL_TrimCaches, so nothing is freed from under a mix.
+	 */
+	FAudio_PlatformAtomicCompareExchange(&audio->trimRequested, 0, 1);
+
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_SetGovernorEXT(
+	FAudio *audio,
+	const FAudioGovernorEXT *pGovernor
+) {
+	LOG_API_ENTER(audio)
+
+	/* Offline passes have no deadline to keep */
+	if (	audio->offline ||
+		(	pGovernor != NULL &&
+			!(pGovernor->LowerLoad < pGovernor->RaiseLoad)	)	)
+	{
+		LOG_API_EXIT(audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	/* The mix thread picks this up at the end of its next pass. Turning
+	 * the governor off brings the quality back all at once.
+	 */
+	FAudio_PlatformLockMutex(audio->perfLock);
+	LOG_MUTEX_LOCK(audio, audio->perfLock)
+	if (pGovernor != NULL)
+	{
+		audio->governor = *pGovernor;
+	}
+	audio->governorEnabled = (pGovernor != NULL);
+	FAudio_PlatformUnlockMutex(audio->perfLock);
+	LOG_MUTEX_UNLOCK(audio, audio->perfLock)
+
+	LOG_API_EXIT(audio)
+	return 0;
+}
+
+uint32_t FAudio_GetGovernorLevelEXT(FAudio *audio, uint32_t *pLevel)
+{
+	LOG_API_ENTER(audio)
+	FAudio_PlatformLockMutex(audio->perfLock);
+	LOG_MUTEX_LOCK(audio, audio->perfLock)
+	*pLevel = audio->governorLevel;
+	FAudio_PlatformUnlockMutex(audio->perfLock);
+	LOG_MUTEX_UNLOCK(audio, audio->perfLock)
+	LOG_API_EXIT(audio)
+	return 0;
 }
 
 /* FAudioVoice Interface */
@@ -838,6 +1910,7 @@ uint32_t FAudioVoice_SetOutputVoices(
 	uint32_t outChannels;
 	uint32_t outSampleRate;
 	uint32_t newResampleSamples;
+	uint32_t inFrames;
 	FAudioVoiceSends defaultSends;
 	FAudioSendDescriptor defaultSend;
 
@@ -847,35 +1920,38 @@ uint32_t FAudioVoice_SetOutputVoices(
 
 	FAudio_PlatformLockMutex(voice->sendLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
+	FAudio_INTERNAL_CountFilteredSends(voice, -1);
 
 	/* FIXME: This is lazy... */
 	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
-		voice->audio->pFree(voice->sendCoefficients[i]);
+		FAudio_INTERNAL_AlignedFree(voice->audio, voice->sendCoefficients[i]);
+		FAudio_INTERNAL_AlignedFree(voice->audio, voice->sendMatrix[i]);
 	}
 	if (voice->sendCoefficients != NULL)
 	{
-		voice->audio->pFree(voice->sendCoefficients);
+		FAudio_INTERNAL_Free(voice->audio, voice->sendCoefficients);
+		FAudio_INTERNAL_Free(voice->audio, voice->sendMatrix);
 	}
 	if (voice->sendMix != NULL)
 	{
-		voice->audio->pFree(voice->sendMix);
+		FAudio_INTERNAL_Free(voice->audio, voice->sendMix);
 	}
 	if (voice->sendFilter != NULL)
 	{
-		voice->audio->pFree(voice->sendFilter);
+		FAudio_INTERNAL_Free(voice->audio, voice->sendFilter);
 	}
 	if (voice->sendFilterState != NULL)
 	{
 		for (i = 0; i < voice->sends.SendCount; i += 1)
 		{
-			voice->audio->pFree(voice->sendFilterState[i]);
+			FAudio_INTERNAL_Free(voice->audio, voice->sendFilterState[i]);
 		}
-		voice->audio->pFree(voice->sendFilterState);
+		FAudio_INTERNAL_Free(voice->audio, voice->sendFilterState);
 	}
 	if (voice->sends.pSends != NULL)
 	{
-		voice->audio->pFree(voice->sends.pSends);
+		FAudio_INTERNAL_Free(voice->audio, voice->sends.pSends);
 	}
 
 	if (pSendList == NULL)
@@ -891,6 +1967,7 @@ uint32_t FAudioVoice_SetOutputVoices(
 	{
 		/* No sends? Nothing to do... */
 		voice->sendCoefficients = NULL;
+		voice->sendMatrix = NULL;
 		voice->sendMix = NULL;
 		voice->sendFilter = NULL;
 		voice->sendFilterState = NULL;
@@ -898,13 +1975,19 @@ uint32_t FAudioVoice_SetOutputVoices(
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 
+		if (voice->type == FAUDIO_VOICE_SUBMIX)
+		{
+			FAudio_INTERNAL_InvalidateSubmixGraph(voice->audio);
+		}
+
 		LOG_API_EXIT(voice->audio)
 		return 0;
 	}
 
 	/* Copy send list */
 	voice->sends.SendCount = pSendList->SendCount;
-	voice->sends.pSends = (FAudioSendDescriptor*) voice->audio->pMalloc(
+	voice->sends.pSends = (FAudioSendDescriptor*) FAudio_INTERNAL_Malloc(
+		voice->audio,
 		pSendList->SendCount * sizeof(FAudioSendDescriptor)
 	);
 	FAudio_memcpy(
@@ -914,18 +1997,26 @@ uint32_t FAudioVoice_SetOutputVoices(
 	);
 
 	/* Allocate/Reset default output matrix, mixer function, filters */
-	voice->sendCoefficients = (float**) voice->audio->pMalloc(
+	voice->sendCoefficients = (float**) FAudio_INTERNAL_Malloc(
+		voice->audio,
 		sizeof(float*) * pSendList->SendCount
 	);
-	voice->sendMix = (FAudioMixCallback*) voice->audio->pMalloc(
+	voice->sendMatrix = (float**) FAudio_INTERNAL_Malloc(
+		voice->audio,
+		sizeof(float*) * pSendList->SendCount
+	);
+	voice->sendMix = (FAudioMixCallback*) FAudio_INTERNAL_Malloc(
+		voice->audio,
 		sizeof(FAudioMixCallback) * pSendList->SendCount
 	);
 	if (voice->flags & FAUDIO_VOICE_USEFILTER)
 	{
-		voice->sendFilter = (FAudioFilterParameters*) voice->audio->pMalloc(
+		voice->sendFilter = (FAudioFilterParameters*) FAudio_INTERNAL_Malloc(
+			voice->audio,
 			sizeof(FAudioFilterParameters) * pSendList->SendCount
 		);
-		voice->sendFilterState = (FAudioFilterState**) voice->audio->pMalloc(
+		voice->sendFilterState = (FAudioFilterState**) FAudio_INTERNAL_Malloc(
+			voice->audio,
 			sizeof(FAudioFilterState*) * pSendList->SendCount
 		);
 	}
@@ -939,8 +2030,10 @@ uint32_t FAudioVoice_SetOutputVoices(
 		{
 			outChannels = pSendList->pSends[i].pOutputVoice->mix.inputChannels;
 		}
-		voice->sendCoefficients[i] = (float*) voice->audio->pMalloc(
-			sizeof(float) * voice->outputChannels * outChannels
+		voice->sendCoefficients[i] = (float*) FAudio_INTERNAL_AlignedMalloc(
+			voice->audio,
+			sizeof(float) * voice->outputChannels * outChannels,
+			FAUDIO_MEMORY_VOICES
 		);
 
 		FAudio_assert(voice->outputChannels > 0 && voice->outputChannels < 9);
@@ -950,48 +2043,82 @@ uint32_t FAudioVoice_SetOutputVoices(
 			FAUDIO_INTERNAL_MATRIX_DEFAULTS[voice->outputChannels - 1][outChannels - 1],
 			voice->outputChannels * outChannels * sizeof(float)
 		);
+		voice->sendMatrix[i] = (float*) FAudio_INTERNAL_AlignedMalloc(
+			voice->audio,
+			sizeof(float) *
+			voice->outputChannels *
+			MIX_MATRIX_STRIDE(outChannels),
+			FAUDIO_MEMORY_VOICES
+		);
 
 		if (voice->outputChannels == 1)
 		{
 			if (outChannels == 1)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_1out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_1out;
 			}
 			else if (outChannels == 2)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_2out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_2out;
 			}
 			else if (outChannels == 6)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_6out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_6out;
+			}
+			else if (outChannels == 8)
+			{
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_1in_8out;
 			}
 			else
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_Generic_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_Generic;
 			}
 		}
 		else if (voice->outputChannels == 2)
 		{
 			if (outChannels == 1)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_1out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_1out;
 			}
 			else if (outChannels == 2)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_2out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_2out;
+			}
+			else if (outChannels == 6)
+			{
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_6out;
+			}
+			else if (outChannels == 8)
+			{
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_8out;
+			}
+			else
+			{
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_Generic;
+			}
+		}
+		else if (voice->outputChannels == 6)
+		{
+			if (outChannels == 2)
+			{
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_6in_2out;
 			}
 			else if (outChannels == 6)
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_2in_6out_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_6in_6out;
 			}
 			else
 			{
-				voice->sendMix[i] = FAudio_INTERNAL_Mix_Generic_Scalar;
+				voice->sendMix[i] = FAudio_INTERNAL_Mix_Generic;
 			}
 		}
+		else if (voice->outputChannels == 8 && outChannels == 8)
+		{
+			voice->sendMix[i] = FAudio_INTERNAL_Mix_8in_8out;
+		}
 		else
 		{
-			voice->sendMix[i] = FAudio_INTERNAL_Mix_Generic_Scalar;
+			voice->sendMix[i] = FAudio_INTERNAL_Mix_Generic;
 		}
 
 		if (voice->flags & FAUDIO_VOICE_USEFILTER)
@@ -999,7 +2126,8 @@ uint32_t FAudioVoice_SetOutputVoices(
 			voice->sendFilter[i].Type = FAUDIO_DEFAULT_FILTER_TYPE;
 			voice->sendFilter[i].Frequency = FAUDIO_DEFAULT_FILTER_FREQUENCY;
 			voice->sendFilter[i].OneOverQ = FAUDIO_DEFAULT_FILTER_ONEOVERQ;
-			voice->sendFilterState[i] = (FAudioFilterState*) voice->audio->pMalloc(
+			voice->sendFilterState[i] = (FAudioFilterState*) FAudio_INTERNAL_Malloc(
+				voice->audio,
 				sizeof(FAudioFilterState) * outChannels
 			);
 			FAudio_zero(
@@ -1008,6 +2136,8 @@ uint32_t FAudioVoice_SetOutputVoices(
 			);
 		}
 	}
+	voice->sendMatrixUpdate = 1;
+	FAudio_INTERNAL_CountFilteredSends(voice, 1);
 
 	/* Allocate resample cache */
 	outSampleRate = voice->sends.pSends[0].pOutputVoice->type == FAUDIO_VOICE_MASTER ?
@@ -1018,6 +2148,8 @@ uint32_t FAudioVoice_SetOutputVoices(
 		(double) outSampleRate /
 		(double) voice->audio->master->master.inputSampleRate
 	);
+	FAudio_PlatformLockMutex(voice->audio->cacheLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->audio->cacheLock)
 	FAudio_INTERNAL_ResizeResampleCache(
 		voice->audio,
 		newResampleSamples * voice->outputChannels
@@ -1029,22 +2161,36 @@ uint32_t FAudioVoice_SetOutputVoices(
 	else
 	{
 		voice->mix.outputSamples = newResampleSamples;
+	}
+	FAudio_PlatformUnlockMutex(voice->audio->cacheLock);
+	LOG_MUTEX_UNLOCK(voice->audio, voice->audio->cacheLock)
+	if (voice->type == FAUDIO_VOICE_SUBMIX)
+	{
 
-		/* Init fixed-rate SRC if applicable */
-		if (voice->mix.resampler != NULL)
+		/* Fixed-rate SRC step, the exact ratio of frames per pass */
+		inFrames = voice->mix.inputSamples / voice->mix.inputChannels;
+		if (inFrames == newResampleSamples)
 		{
-			/* FIXME: This is lazy... */
-			FAudio_PlatformCloseFixedRateSRC(voice->mix.resampler);
+			voice->mix.resampleStep = FIXED_ONE;
+		}
+		else
+		{
+			voice->mix.resampleStep = (
+				((uint64_t) inFrames << FIXED_PRECISION) /
+				newResampleSamples
+			);
 		}
-		voice->mix.resampler = FAudio_PlatformInitFixedRateSRC(
-			voice->mix.inputChannels,
-			voice->mix.inputSampleRate,
-			outSampleRate
-		);
 	}
 
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+
+	/* Not under sendLock, the graph builder takes it after submixLock */
+	if (voice->type == FAUDIO_VOICE_SUBMIX)
+	{
+		FAudio_INTERNAL_InvalidateSubmixGraph(voice->audio);
+	}
+
 	LOG_API_EXIT(voice->audio)
 	return 0;
 }
@@ -1205,7 +2351,16 @@ uint32_t FAudioVoice_EnableEffect(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueEnableEffect(
+			voice,
+			EffectIndex,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	FAudio_PlatformLockMutex(voice->effectLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
@@ -1222,7 +2377,16 @@ uint32_t FAudioVoice_DisableEffect(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueDisableEffect(
+			voice,
+			EffectIndex,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	FAudio_PlatformLockMutex(voice->effectLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
@@ -1254,23 +2418,58 @@ uint32_t FAudioVoice_SetEffectParameters(
 	uint32_t ParametersByteSize,
 	uint32_t OperationSet
 ) {
+	FAPO *fapo;
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueSetEffectParameters(
+			voice,
+			EffectIndex,
+			pParameters,
+			ParametersByteSize,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
+
+	/* The chain can be swapped out by SetEffectChain, so hold effectLock
+	 * for as long as we're looking at it.
+	 */
+	FAudio_PlatformLockMutex(voice->effectLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
+
+	/* FAPOBase hands the parameters to Process through a lock-free triple
+	 * buffer, so those effects can take them right away instead of
+	 * waiting for the next pass. Anything else gets them from the mixer
+	 * thread, between calls to Process.
+	 */
+	fapo = voice->effects.desc[EffectIndex].pEffect;
+	if (fapo->SetParameters == (SetParametersFunc) FAPOBase_SetParameters)
+	{
+		fapo->SetParameters(fapo, pParameters, ParametersByteSize);
+		FAudio_PlatformUnlockMutex(voice->effectLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	if (voice->effects.parameters[EffectIndex] == NULL)
 	{
-		voice->effects.parameters[EffectIndex] = voice->audio->pMalloc(
-			ParametersByteSize
+		voice->effects.parameters[EffectIndex] = FAudio_INTERNAL_MallocCategory(
+			voice->audio,
+			ParametersByteSize,
+			FAUDIO_MEMORY_EFFECTS
 		);
 		voice->effects.parameterSizes[EffectIndex] = ParametersByteSize;
 	}
-	FAudio_PlatformLockMutex(voice->effectLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
 	if (voice->effects.parameterSizes[EffectIndex] < ParametersByteSize)
 	{
-		voice->effects.parameters[EffectIndex] = voice->audio->pRealloc(
+		voice->effects.parameters[EffectIndex] = FAudio_INTERNAL_ReallocCategory(
+			voice->audio,
 			voice->effects.parameters[EffectIndex],
-			ParametersByteSize
+			ParametersByteSize,
+			FAUDIO_MEMORY_EFFECTS
 		);
 		voice->effects.parameterSizes[EffectIndex] = ParametersByteSize;
 	}
@@ -1310,7 +2509,16 @@ uint32_t FAudioVoice_SetFilterParameters(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueSetFilterParameters(
+			voice,
+			pParameters,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	/* MSDN: "This method is usable only on source and submix voices and
 	 * has no effect on mastering voices."
@@ -1334,6 +2542,7 @@ uint32_t FAudioVoice_SetFilterParameters(
 		pParameters,
 		sizeof(FAudioFilterParameters)
 	);
+	voice->filterUpdate = 1;
 	FAudio_PlatformUnlockMutex(voice->filterLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->filterLock)
 
@@ -1366,7 +2575,17 @@ uint32_t FAudioVoice_SetOutputFilterParameters(
 ) {
 	uint32_t i;
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueSetOutputFilterParameters(
+			voice,
+			pDestinationVoice,
+			pParameters,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	if (!(voice->flags & FAUDIO_VOICE_USEFILTER))
 	{
@@ -1477,13 +2696,23 @@ uint32_t FAudioVoice_SetVolume(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueSetVolume(
+			voice,
+			Volume,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	voice->volume = FAudio_clamp(
 		Volume,
 		-FAUDIO_MAX_VOLUME_LEVEL,
 		FAUDIO_MAX_VOLUME_LEVEL
 	);
+	voice->sendMatrixUpdate = 1;
 	LOG_API_EXIT(voice->audio)
 	return 0;
 }
@@ -1505,8 +2734,6 @@ uint32_t FAudioVoice_SetChannelVolumes(
 ) {
 	LOG_API_ENTER(voice->audio)
 	FAudio_assert(voice->type != FAUDIO_VOICE_MASTER);
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
-
 	if (!pVolumes)
 	{
 		LOG_API_EXIT(voice->audio)
@@ -1519,6 +2746,18 @@ uint32_t FAudioVoice_SetChannelVolumes(
 		return FAUDIO_E_INVALID_CALL;
 	}
 
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueSetChannelVolumes(
+			voice,
+			Channels,
+			pVolumes,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
+
 	FAudio_PlatformLockMutex(voice->volumeLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
 	FAudio_memcpy(
@@ -1526,6 +2765,7 @@ uint32_t FAudioVoice_SetChannelVolumes(
 		pVolumes,
 		sizeof(float) * Channels
 	);
+	voice->channelVolumeUpdate = 1;
 	FAudio_PlatformUnlockMutex(voice->volumeLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
 	LOG_API_EXIT(voice->audio)
@@ -1560,7 +2800,19 @@ uint32_t FAudioVoice_SetOutputMatrix(
 ) {
 	uint32_t i;
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueSetOutputMatrix(
+			voice,
+			pDestinationVoice,
+			SourceChannels,
+			DestinationChannels,
+			pLevelMatrix,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	FAudio_PlatformLockMutex(voice->sendLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
@@ -1610,6 +2862,7 @@ uint32_t FAudioVoice_SetOutputMatrix(
 		pLevelMatrix,
 		sizeof(float) * SourceChannels * DestinationChannels
 	);
+	voice->sendMatrixUpdate = 1;
 
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
@@ -1682,95 +2935,182 @@ void FAudioVoice_GetOutputMatrix(
 	LOG_API_EXIT(voice->audio)
 }
 
+uint32_t FAudioVoice_GetPerformanceDataEXT(
+	FAudioVoice *voice,
+	FAudioVoicePerformanceDataEXT *pPerfData,
+	uint64_t *pEffectCycles,
+	uint32_t EffectCount
+) {
+#ifndef FAUDIO_DISABLE_VOICE_PROFILE
+	uint32_t i;
+#endif /* FAUDIO_DISABLE_VOICE_PROFILE */
+
+	LOG_API_ENTER(voice->audio)
+
+	FAudio_zero(pPerfData, sizeof(FAudioVoicePerformanceDataEXT));
+	if (pEffectCycles != NULL)
+	{
+		FAudio_zero(pEffectCycles, sizeof(uint64_t) * EffectCount);
+	}
+
+#ifdef FAUDIO_DISABLE_VOICE_PROFILE
+	LOG_ERROR(
+		voice->audio,
+		"%s",
+		"FAudio was built with FAUDIO_DISABLE_VOICE_PROFILE"
+	)
+	LOG_API_EXIT(voice->audio)
+	return FAUDIO_E_INVALID_CALL;
+#else
+	if (!(voice->flags & FAUDIO_VOICE_PROFILE_EXT))
+	{
+		LOG_ERROR(
+			voice->audio,
+			"%s",
+			"Voice was not created with FAUDIO_VOICE_PROFILE_EXT"
+		)
+		LOG_API_EXIT(voice->audio)
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	/* Read while the mixer may be adding to them, so these are only as
+	 * recent as the last pass that finished
+	 */
+	FAudio_memcpy(
+		pPerfData,
+		&voice->profile,
+		sizeof(FAudioVoicePerformanceDataEXT)
+	);
+	if (pEffectCycles != NULL)
+	{
+		FAudio_PlatformLockMutex(voice->effectLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
+		for (i = 0; i < FAudio_min(EffectCount, voice->effects.count); i += 1)
+		{
+			pEffectCycles[i] = voice->effects.cycles[i];
+		}
+		FAudio_PlatformUnlockMutex(voice->effectLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
+	}
+
+	LOG_API_EXIT(voice->audio)
+	return 0;
+#endif /* FAUDIO_DISABLE_VOICE_PROFILE */
+}
+
 void FAudioVoice_DestroyVoice(FAudioVoice *voice)
 {
 	uint32_t i;
 	LOG_API_ENTER(voice->audio)
 
+	FAudio_OPERATIONSET_ClearAllForVoice(voice);
+
 	/* TODO: Check for dependencies and fail if still in use */
 	if (voice->type == FAUDIO_VOICE_SOURCE)
 	{
 		FAudioBufferEntry *entry, *next;
 
-		LinkedList_RemoveEntry(
-			&voice->audio->sources,
-			voice,
-			voice->audio->sourceLock,
-			voice->audio->pFree
-		);
+		FAudio_PlatformLockMutex(voice->audio->sourceLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->audio->sourceLock)
+		FAudio_INTERNAL_VoiceTableRemove(&voice->audio->sources, voice);
+		FAudio_INTERNAL_RetireVoiceLocks(voice);
+		FAudio_PlatformUnlockMutex(voice->audio->sourceLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->audio->sourceLock)
+
+#ifdef HAVE_FFMPEG
+		/* Before the format goes, the predecoder may be reading it */
+		if (voice->src.ffmpeg)
+		{
+			FAudio_FFMPEG_free(voice);
+		}
+#endif /* HAVE_FFMPEG */
 
 		entry = voice->src.bufferList;
 		while (entry != NULL)
 		{
 			next = entry->next;
-			voice->audio->pFree(entry);
+			FAudio_INTERNAL_FreeBufferEntry(voice->audio, entry);
 			entry = next;
 		}
 
-		voice->audio->pFree(voice->src.format);
-		LOG_MUTEX_DESTROY(voice->audio, voice->src.bufferLock)
-		FAudio_PlatformDestroyMutex(voice->src.bufferLock);
-#ifdef HAVE_FFMPEG
-		if (voice->src.ffmpeg)
+		FAudio_INTERNAL_Free(voice->audio, voice->src.format);
+		if (voice->src.resampleHistory != NULL)
 		{
-			FAudio_FFMPEG_free(voice);
+			FAudio_INTERNAL_Free(voice->audio, voice->src.resampleHistory);
 		}
-#endif /* HAVE_FFMPEG */
+		if (voice->src.adpcmCache != NULL)
+		{
+			FAudio_INTERNAL_AlignedFree(voice->audio, voice->src.adpcmCache);
+		}
+		LOG_MUTEX_DESTROY(voice->audio, voice->src.bufferLock)
+		FAudio_PlatformDestroyMutex(voice->src.bufferLock);
 	}
 	else if (voice->type == FAUDIO_VOICE_SUBMIX)
 	{
-		/* Remove submix from list */
-		LinkedList_RemoveEntry(
-			&voice->audio->submixes,
-			voice,
-			voice->audio->submixLock,
-			voice->audio->pFree
-		);
+		/* Remove submix from list and graph in one go */
+		FAudio_PlatformLockMutex(voice->audio->submixLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->audio->submixLock)
+		FAudio_INTERNAL_VoiceTableRemove(&voice->audio->submixes, voice);
+		FAudio_INTERNAL_InvalidateSubmixGraph(voice->audio);
+		FAudio_INTERNAL_RetireVoiceLocks(voice);
+		FAudio_PlatformUnlockMutex(voice->audio->submixLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->audio->submixLock)
 
 		/* Delete submix data */
-		voice->audio->pFree(voice->mix.inputCache);
-		if (voice->mix.resampler != NULL)
-		{
-			FAudio_PlatformCloseFixedRateSRC(voice->mix.resampler);
-		}
+		FAudio_INTERNAL_AlignedFree(voice->audio, voice->mix.inputCache);
+		FAudio_INTERNAL_Free(voice->audio, voice->mix.resampleHistory);
 	}
 	else if (voice->type == FAUDIO_VOICE_MASTER)
 	{
 		FAudio_PlatformQuit(voice->audio);
+		FAudio_INTERNAL_RetireVoiceLocks(voice);
 		voice->audio->master = NULL;
+		if (voice->audio->deviceMix != NULL)
+		{
+			FAudio_INTERNAL_AlignedFree(voice->audio, voice->audio->deviceMix);
+			voice->audio->deviceMix = NULL;
+		}
+		if (voice->audio->offlineCache != NULL)
+		{
+			FAudio_INTERNAL_AlignedFree(voice->audio, voice->audio->offlineCache);
+			voice->audio->offlineCache = NULL;
+		}
 	}
 
 	if (voice->sendLock != NULL)
 	{
 		FAudio_PlatformLockMutex(voice->sendLock);
 		LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
+		FAudio_INTERNAL_CountFilteredSends(voice, -1);
 		for (i = 0; i < voice->sends.SendCount; i += 1)
 		{
-			voice->audio->pFree(voice->sendCoefficients[i]);
+			FAudio_INTERNAL_AlignedFree(voice->audio, voice->sendCoefficients[i]);
+			FAudio_INTERNAL_AlignedFree(voice->audio, voice->sendMatrix[i]);
 		}
 		if (voice->sendCoefficients != NULL)
 		{
-			voice->audio->pFree(voice->sendCoefficients);
+			FAudio_INTERNAL_Free(voice->audio, voice->sendCoefficients);
+			FAudio_INTERNAL_Free(voice->audio, voice->sendMatrix);
 		}
 		if (voice->sendMix != NULL)
 		{
-			voice->audio->pFree(voice->sendMix);
+			FAudio_INTERNAL_Free(voice->audio, voice->sendMix);
 		}
 		if (voice->sendFilter != NULL)
 		{
-			voice->audio->pFree(voice->sendFilter);
+			FAudio_INTERNAL_Free(voice->audio, voice->sendFilter);
 		}
 		if (voice->sendFilterState != NULL)
 		{
 			for (i = 0; i < voice->sends.SendCount; i += 1)
 			{
-				voice->audio->pFree(voice->sendFilterState[i]);
+				FAudio_INTERNAL_Free(voice->audio, voice->sendFilterState[i]);
 			}
-			voice->audio->pFree(voice->sendFilterState);
+			FAudio_INTERNAL_Free(voice->audio, voice->sendFilterState);
 		}
 		if (voice->sends.pSends != NULL)
 		{
-			voice->audio->pFree(voice->sends.pSends);
+			FAudio_INTERNAL_Free(voice->audio, voice->sends.pSends);
 		}
 		FAudio_PlatformUnlockMutex(voice->sendLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
@@ -1795,7 +3135,7 @@ void FAudioVoice_DestroyVoice(FAudioVoice *voice)
 		LOG_MUTEX_LOCK(voice->audio, voice->filterLock)
 		if (voice->filterState != NULL)
 		{
-			voice->audio->pFree(voice->filterState);
+			FAudio_INTERNAL_Free(voice->audio, voice->filterState);
 		}
 		FAudio_PlatformUnlockMutex(voice->filterLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->filterLock)
@@ -1809,7 +3149,7 @@ void FAudioVoice_DestroyVoice(FAudioVoice *voice)
 		LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
 		if (voice->channelVolume != NULL)
 		{
-			voice->audio->pFree(voice->channelVolume);
+			FAudio_INTERNAL_Free(voice->audio, voice->channelVolume);
 		}
 		FAudio_PlatformUnlockMutex(voice->volumeLock);
 		LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
@@ -1819,7 +3159,7 @@ void FAudioVoice_DestroyVoice(FAudioVoice *voice)
 
 	LOG_API_EXIT(voice->audio)
 	FAudio_Release(voice->audio);
-	voice->audio->pFree(voice);
+	FAudio_INTERNAL_Free(voice->audio, voice);
 }
 
 /* FAudioSourceVoice Interface */
@@ -1830,8 +3170,17 @@ uint32_t FAudioSourceVoice_Start(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueStart(
+			voice,
+			Flags,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	FAudio_assert(Flags == 0);
 	voice->src.active = 1;
@@ -1845,8 +3194,17 @@ uint32_t FAudioSourceVoice_Stop(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueStop(
+			voice,
+			Flags,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	if (Flags & FAUDIO_PLAY_TAILS)
 	{
@@ -1974,7 +3332,7 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 	}
 
 	/* Allocate, now that we have valid input */
-	entry = (FAudioBufferEntry*) voice->audio->pMalloc(sizeof(FAudioBufferEntry));
+	entry = FAudio_INTERNAL_AllocBufferEntry(voice->audio);
 	FAudio_memcpy(&entry->buffer, pBuffer, sizeof(FAudioBuffer));
 	entry->buffer.PlayBegin = playBegin;
 	entry->buffer.PlayLength = playLength;
@@ -1985,6 +3343,24 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 		FAudio_memcpy(&entry->bufferWMA, pBufferWMA, sizeof(FAudioBufferWMA));
 	}
 	entry->next = NULL;
+	entry->blockCacheSource = NULL;
+	entry->predecode = NULL;
+	if (voice->src.format->wFormatTag == FAUDIO_FORMAT_MSADPCM)
+	{
+		entry->blockCacheSource = FAudio_INTERNAL_BlockCacheAcquire(
+			voice->audio,
+			pBuffer->pAudioData,
+			voice->src.format->nBlockAlign,
+			voice->src.format->nChannels
+		);
+		if (voice->flags & FAUDIO_VOICE_PREDECODE_EXT)
+		{
+			entry->predecode = FAudio_INTERNAL_PredecodeBuffer(
+				voice,
+				&entry->buffer
+			);
+		}
+	}
 
 	if (	voice->audio->version <= 7 && (
 		entry->buffer.LoopCount > 0 &&
@@ -2017,12 +3393,20 @@ uint32_t FAudioSourceVoice_SubmitSourceBuffer(
 		 */
 		FAudio_assert(list != entry);
 	}
+	voice->src.bufferCount += 1;
+	FAudio_INTERNAL_PublishVoiceState(voice);
 	LOG_INFO(
 		voice->audio,
 		"%p: appended buffer %p",
 		voice,
 		&entry->buffer
 	);
+	LOG_STREAMING(
+		voice->audio,
+		"Buffer Submit",
+		&entry->buffer,
+		entry->buffer.AudioBytes
+	);
 	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 	LOG_API_EXIT(voice->audio)
@@ -2046,17 +3430,28 @@ uint32_t FAudioSourceVoice_FlushSourceBuffers(
 	{
 		entry = entry->next;
 		voice->src.bufferList->next = NULL;
+		voice->src.bufferCount = 1;
 	}
 	else
 	{
 		voice->src.curBufferOffset = 0;
 		voice->src.bufferList = NULL;
+		voice->src.bufferCount = 0;
 		voice->src.newBuffer = 0;
+		voice->src.adpcmCacheData = NULL;
+#ifdef HAVE_FFMPEG
+		if (voice->src.ffmpeg != NULL)
+		{
+			FAudio_FFMPEG_flush(voice);
+		}
+#endif /* HAVE_FFMPEG */
 	}
+	FAudio_INTERNAL_PublishVoiceState(voice);
 
 	/* Go through each buffer, send an event for each one before deleting */
 	while (entry != NULL)
 	{
+		FAudio_INTERNAL_CancelPredecode(voice->audio, entry);
 		if (voice->src.callback != NULL && voice->src.callback->OnBufferEnd != NULL)
 		{
 			voice->src.callback->OnBufferEnd(
@@ -2065,7 +3460,7 @@ uint32_t FAudioSourceVoice_FlushSourceBuffers(
 			);
 		}
 		next = entry->next;
-		voice->audio->pFree(entry);
+		FAudio_INTERNAL_FreeBufferEntry(voice->audio, entry);
 		entry = next;
 	}
 
@@ -2103,8 +3498,16 @@ uint32_t FAudioSourceVoice_ExitLoop(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueExitLoop(
+			voice,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	FAudio_PlatformLockMutex(voice->src.bufferLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
@@ -2125,33 +3528,27 @@ void FAudioSourceVoice_GetState(
 	FAudioVoiceState *pVoiceState,
 	uint32_t flags
 ) {
-	FAudioBufferEntry *entry;
+	int32_t sequence;
+	uint64_t samplesPlayed;
 
 	LOG_API_ENTER(voice->audio)
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
 
-	FAudio_PlatformLockMutex(voice->src.bufferLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->src.bufferLock)
-
-	if (!(flags & FAUDIO_VOICE_NOSAMPLESPLAYED))
+	/* Lock-free, so polling many voices never waits on the mixer. Retry
+	 * if the state was being published while we read it.
+	 */
+	do
 	{
-		pVoiceState->SamplesPlayed = voice->src.totalSamples;
-	}
+		sequence = FAudio_PlatformAtomicGet(&voice->src.stateSequence);
+		samplesPlayed = voice->src.stateSamplesPlayed;
+		pVoiceState->BuffersQueued = voice->src.stateBuffersQueued;
+		pVoiceState->pCurrentBufferContext = voice->src.stateContext;
+	} while (	(sequence & 1) ||
+			FAudio_PlatformAtomicAdd(&voice->src.stateSequence, 0) != sequence	);
 
-	pVoiceState->BuffersQueued = 0;
-	pVoiceState->pCurrentBufferContext = NULL;
-	if (voice->src.bufferList != NULL)
+	if (!(flags & FAUDIO_VOICE_NOSAMPLESPLAYED))
 	{
-		entry = voice->src.bufferList;
-		if (!voice->src.newBuffer)
-		{
-			pVoiceState->pCurrentBufferContext = entry->buffer.pContext;
-		}
-		do
-		{
-			pVoiceState->BuffersQueued += 1;
-			entry = entry->next;
-		} while (entry != NULL);
+		pVoiceState->SamplesPlayed = samplesPlayed;
 	}
 
 	LOG_INFO(
@@ -2161,8 +3558,6 @@ void FAudioSourceVoice_GetState(
 		pVoiceState->SamplesPlayed
 	);
 
-	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
 	LOG_API_EXIT(voice->audio)
 }
 
@@ -2172,8 +3567,17 @@ uint32_t FAudioSourceVoice_SetFrequencyRatio(
 	uint32_t OperationSet
 ) {
 	LOG_API_ENTER(voice->audio)
-	FAudio_assert(OperationSet == FAUDIO_COMMIT_NOW);
 	FAudio_assert(voice->type == FAUDIO_VOICE_SOURCE);
+	if (OperationSet != FAUDIO_COMMIT_NOW && voice->audio->active)
+	{
+		FAudio_OPERATIONSET_QueueSetFrequencyRatio(
+			voice,
+			Ratio,
+			OperationSet
+		);
+		LOG_API_EXIT(voice->audio)
+		return 0;
+	}
 
 	if (voice->flags & FAUDIO_VOICE_NOPITCH)
 	{
@@ -2235,11 +3639,15 @@ uint32_t FAudioSourceVoice_SetSourceSampleRate(
 		(double) NewSourceSampleRate /
 		(double) voice->audio->master->master.inputSampleRate
 	) + EXTRA_DECODE_PADDING * voice->src.format->nChannels;
+	FAudio_PlatformLockMutex(voice->audio->cacheLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->audio->cacheLock)
 	FAudio_INTERNAL_ResizeDecodeCache(
 		voice->audio,
 		newDecodeSamples * voice->src.format->nChannels
 	);
 	voice->src.decodeSamples = newDecodeSamples;
+	FAudio_PlatformUnlockMutex(voice->audio->cacheLock);
+	LOG_MUTEX_UNLOCK(voice->audio, voice->audio->cacheLock)
 
 	FAudio_PlatformLockMutex(voice->sendLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
@@ -2264,11 +3672,15 @@ uint32_t FAudioSourceVoice_SetSourceSampleRate(
 		(double) outSampleRate /
 		(double) voice->audio->master->master.inputSampleRate
 	);
+	FAudio_PlatformLockMutex(voice->audio->cacheLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->audio->cacheLock)
 	FAudio_INTERNAL_ResizeResampleCache(
 		voice->audio,
 		newResampleSamples * voice->src.format->nChannels
 	);
 	voice->src.resampleSamples = newResampleSamples;
+	FAudio_PlatformUnlockMutex(voice->audio->cacheLock);
+	LOG_MUTEX_UNLOCK(voice->audio, voice->audio->cacheLock)
 	LOG_API_EXIT(voice->audio)
 	return 0;
 }
@@ -0,0 +1,901 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2021 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express odr implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed odr altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+#include "FAudioFX.h"
+#include "FAudio_internal.h"
+
+/* Convolution Reverb FAPO Implementation */
+
+const FAudioGUID FAudioFX_CLSID_ConvolutionReverbEXT =
+{
+	0x5B2C8E41,
+	0x0D7A,
+	0x4F3E,
+	{
+		0x9A,
+		0x61,
+		0x3C,
+		0xE7,
+		0x24,
+		0x8B,
+		0xD0,
+		0x15
+	}
+};
+
+static FAPORegistrationProperties ConvolutionProperties =
+{
+	/* .clsid = */ {0},
+	/* .FriendlyName = */
+	{
+		'C', 'o', 'n', 'v', 'o', 'l', 'u', 't', 'i', 'o', 'n',
+		'R', 'e', 'v', 'e', 'r', 'b', '\0'
+	},
+	/*.CopyrightInfo = */
+	{
+		'C', 'o', 'p', 'y', 'r', 'i', 'g', 'h', 't', ' ', '(', 'c', ')',
+		'E', 't', 'h', 'a', 'n', ' ', 'L', 'e', 'e', '\0'
+	},
+	/*.MajorVersion = */ 0,
+	/*.MinorVersion = */ 0,
+	/*.Flags = */(
+		FAPO_FLAG_CHANNELS_MUST_MATCH |
+		FAPO_FLAG_FRAMERATE_MUST_MATCH |
+		FAPO_FLAG_BITSPERSAMPLE_MUST_MATCH |
+		FAPO_FLAG_BUFFERCOUNT_MUST_MATCH |
+		FAPO_FLAG_INPLACE_SUPPORTED |
+		FAPO_FLAG_INPLACE_REQUIRED
+	),
+	/*.MinInputBufferCount = */ 1,
+	/*.MaxInputBufferCount = */  1,
+	/*.MinOutputBufferCount = */ 1,
+	/*.MaxOutputBufferCount =*/ 1
+};
+
+/* The impulse response is cut into partitions of CONVOLUTION_BLOCK frames,
+ * which is also the effect's latency. Every block of input is transformed
+ * once, and each partition's spectrum is multiplied with the spectrum of the
+ * input block that far back, so a block costs two FFTs and one spectrum
+ * multiply per partition however long the response is.
+ *
+ * With FAUDIOFX_CONVOLUTION_NON_UNIFORM_EXT, only the first
+ * CONVOLUTION_LATE_BLOCK frames are done that way. The rest of the response,
+ * the late segment, is cut into partitions of CONVOLUTION_LATE_BLOCK frames,
+ * a quarter as many. The late segment's input is only transformed every
+ * CONVOLUTION_LATE_RATIO blocks, and its multiplies are spread over the
+ * blocks in between.
+ */
+#define CONVOLUTION_BLOCK 256
+#define CONVOLUTION_LATE_RATIO 4
+#define CONVOLUTION_LATE_BLOCK (CONVOLUTION_BLOCK * CONVOLUTION_LATE_RATIO)
+
+/* A real FFT of 2 * size samples, done as a complex FFT of size points */
+typedef struct ConvolutionTransform
+{
+	uint32_t size;
+	FAudioFFT fft;
+	uint32_t *reversed;	/* Where the FFT leaves each bin */
+	float *splitRe;		/* e^(-i * pi * k / size) */
+	float *splitIm;
+} ConvolutionTransform;
+
+typedef struct ConvolutionSegment
+{
+	ConvolutionTransform transform;
+	uint32_t partitions;
+
+	/* Per impulse response channel, partitions spectra of 2 * size */
+	float *filter;
+
+	/* Per channel, allocated when locked */
+	float *window;		/* The last two partitions of input */
+	float *spectra;		/* Their spectra, partitions deep */
+	float *acc;		/* The spectrum of the next output */
+	float *output;		/* The last output, handed out by block */
+	uint32_t current;
+} ConvolutionSegment;
+
+typedef struct FAudioFXConvolution
+{
+	FAPOBase base;
+
+	uint16_t channels;
+	uint16_t irChannels;
+	uint32_t irFrames;
+
+	ConvolutionSegment early;
+	ConvolutionSegment late;	/* partitions is 0 when uniform */
+	uint32_t lateStep;
+
+	/* Block FIFO, fill frames of it have been read since the last block */
+	uint32_t fill;
+	float *outBlock;		/* channels * CONVOLUTION_BLOCK */
+	float *scratch;			/* 2 * the largest size */
+	float *state;			/* Everything allocated when locked */
+
+	FAudioEffectTail tail;
+} FAudioFXConvolution;
+
+/* Transforms */
+
+static uint32_t ConvolutionTransform_Floats(uint32_t size)
+{
+	return FAUDIO_FFT_TWIDDLES(size) + (size * 2);
+}
+
+static void ConvolutionTransform_Init(
+	ConvolutionTransform *transform,
+	uint32_t size,
+	float *tables,
+	uint32_t *reversed
+) {
+	uint32_t k, m, i, r;
+
+	transform->size = size;
+	transform->reversed = reversed;
+	transform->splitRe = tables + FAUDIO_FFT_TWIDDLES(size);
+	transform->splitIm = transform->splitRe + size;
+	FAudio_INTERNAL_InitFFT(&transform->fft, tables, size);
+
+	for (k = 0; k < size; k += 1)
+	{
+		/* Base-4 digit reversal, an FFT of 4^n points has n digits */
+		for (i = k, r = 0, m = size; m > 1; m /= 4)
+		{
+			r = (r * 4) + (i & 3);
+			i >>= 2;
+		}
+		reversed[k] = r;
+		transform->splitRe[k] = (float) FAudio_cos(
+			-3.14159265358979323846 * k / size
+		);
+		transform->splitIm[k] = (float) FAudio_sin(
+			-3.14159265358979323846 * k / size
+		);
+	}
+}
+
+/* Spectrum of 2 * size real samples, in size bins with bin 0 holding the DC
+ * and Nyquist bins. The even and odd samples are transformed together as one
+ * complex signal, then pulled apart. The result is twice the real spectrum.
+ */
+static void ConvolutionTransform_Forward(
+	const ConvolutionTransform *transform,
+	const float *samples,
+	float *restrict re,
+	float *restrict im,
+	float *restrict scratch
+) {
+	const uint32_t size = transform->size;
+	float *zr = scratch;
+	float *zi = scratch + size;
+	uint32_t n, k, a, b;
+	float er, ei, odr, odi;
+
+	for (n = 0; n < size; n += 1)
+	{
+		zr[n] = samples[n * 2];
+		zi[n] = samples[(n * 2) + 1];
+	}
+	FAudio_INTERNAL_FFT(&transform->fft, zr, zi);
+
+	re[0] = 2.0f * (zr[0] + zi[0]);
+	im[0] = 2.0f * (zr[0] - zi[0]);
+	for (k = 1; k < size; k += 1)
+	{
+		a = transform->reversed[k];
+		b = transform->reversed[size - k];
+		er = zr[a] + zr[b];
+		ei = zi[a] - zi[b];
+		odr = zi[a] + zi[b];
+		odi = zr[b] - zr[a];
+		re[k] = er + (odr * transform->splitRe[k]) - (odi * transform->splitIm[k]);
+		im[k] = ei + (odr * transform->splitIm[k]) + (odi * transform->splitRe[k]);
+	}
+}
+
+/* The second half of the 2 * size samples of the spectrum's inverse, the
+ * part of an overlap-save window that is free of wraparound. It is also
+ * 8 * size times too loud, which the filter spectra make up for.
+ */
+static void ConvolutionTransform_Inverse(
+	const ConvolutionTransform *transform,
+	const float *restrict re,
+	const float *restrict im,
+	float *restrict samples,
+	float *restrict scratch
+) {
+	const uint32_t size = transform->size;
+	float *zr = scratch;
+	float *zi = scratch + size;
+	uint32_t n, k;
+	float er, ei, dr, di, odr, odi;
+
+	zr[0] = re[0] + im[0];
+	zi[0] = re[0] - im[0];
+	for (k = 1; k < size; k += 1)
+	{
+		er = re[k] + re[size - k];
+		ei = im[k] - im[size - k];
+		dr = re[k] - re[size - k];
+		di = im[k] + im[size - k];
+		odr = (dr * transform->splitRe[k]) + (di * transform->splitIm[k]);
+		odi = (di * transform->splitRe[k]) - (dr * transform->splitIm[k]);
+		zr[k] = er - odi;
+		zi[k] = ei + odr;
+	}
+
+	/* Swapping the arrays makes it an inverse FFT */
+	FAudio_INTERNAL_FFT(&transform->fft, zi, zr);
+
+	for (n = size / 2; n < size; n += 1)
+	{
+		k = transform->reversed[n];
+		samples[(n - (size / 2)) * 2] = zr[k];
+		samples[((n - (size / 2)) * 2) + 1] = zi[k];
+	}
+}
+
+/* Segments */
+
+static inline float* ConvolutionSegment_Spectrum(
+	const ConvolutionSegment *segment,
+	float *spectra,
+	uint32_t partition
+) {
+	return spectra + (partition * segment->transform.size * 2);
+}
+
+/* Adds one partition of the filter times the input that far back to acc */
+static inline void ConvolutionSegment_MAC(
+	const ConvolutionSegment *segment,
+	uint32_t channel,
+	uint32_t irChannel,
+	uint32_t partition
+) {
+	const uint32_t bins = segment->transform.size;
+	float *spectra = segment->spectra + (
+		channel * segment->partitions * bins * 2
+	);
+	float *acc = segment->acc + (channel * bins * 2);
+	const float *x = ConvolutionSegment_Spectrum(
+		segment,
+		spectra,
+		(segment->current + segment->partitions - partition) %
+			segment->partitions
+	);
+	const float *h = ConvolutionSegment_Spectrum(
+		segment,
+		segment->filter + (irChannel * segment->partitions * bins * 2),
+		partition
+	);
+	FAudio_INTERNAL_SpectrumMAC(
+		acc,
+		acc + bins,
+		x,
+		x + bins,
+		h,
+		h + bins,
+		bins
+	);
+}
+
+/* Transforms the window into the current slot, then shifts it by a partition */
+static void ConvolutionSegment_Push(
+	ConvolutionSegment *segment,
+	uint32_t channel,
+	float *scratch
+) {
+	const uint32_t size = segment->transform.size;
+	float *window = segment->window + (channel * size * 2);
+	float *x = ConvolutionSegment_Spectrum(
+		segment,
+		segment->spectra + (channel * segment->partitions * size * 2),
+		segment->current
+	);
+	ConvolutionTransform_Forward(
+		&segment->transform,
+		window,
+		x,
+		x + size,
+		scratch
+	);
+	FAudio_memmove(window, window + size, sizeof(float) * size);
+}
+
+/* Inverts acc into samples and clears it for the next output */
+static void ConvolutionSegment_Pop(
+	ConvolutionSegment *segment,
+	uint32_t channel,
+	float *samples,
+	float *scratch
+) {
+	const uint32_t size = segment->transform.size;
+	float *acc = segment->acc + (channel * size * 2);
+	ConvolutionTransform_Inverse(
+		&segment->transform,
+		acc,
+		acc + size,
+		samples,
+		scratch
+	);
+	FAudio_zero(acc, sizeof(float) * size * 2);
+}
+
+static uint32_t ConvolutionSegment_StateFloats(
+	const ConvolutionSegment *segment,
+	uint16_t channels
+) {
+	const uint32_t size = segment->transform.size;
+	if (segment->partitions == 0)
+	{
+		return 0;
+	}
+	return channels * size * (
+		2 +				/* window */
+		(segment->partitions * 2) +	/* spectra */
+		2 +				/* acc */
+		1				/* output */
+	);
+}
+
+static float* ConvolutionSegment_Carve(
+	ConvolutionSegment *segment,
+	uint16_t channels,
+	float *state
+) {
+	const uint32_t size = segment->transform.size;
+	if (segment->partitions == 0)
+	{
+		return state;
+	}
+	segment->window = state;
+	state += channels * size * 2;
+	segment->spectra = state;
+	state += channels * size * segment->partitions * 2;
+	segment->acc = state;
+	state += channels * size * 2;
+	segment->output = state;
+	state += channels * size;
+	segment->current = 0;
+	return state;
+}
+
+/* Block Processing */
+
+/* Runs one block, whose input is at the end of each channel's early window */
+static void FAudioFXConvolution_INTERNAL_Block(
+	FAudioFXConvolution *fapo,
+	float wet,
+	float dry
+) {
+	ConvolutionSegment *early = &fapo->early;
+	ConvolutionSegment *late = &fapo->late;
+	const uint32_t step = fapo->lateStep;
+	uint32_t c, ir, i, p, first, last, spread;
+	float *input, *out, *lateOut;
+
+	/* The late partitions, other than the newest, are spread evenly */
+	spread = (late->partitions + CONVOLUTION_LATE_RATIO - 2) / CONVOLUTION_LATE_RATIO;
+	first = 1 + (step * spread);
+	last = FAudio_min(first + spread, late->partitions);
+
+	for (c = 0; c < fapo->channels; c += 1)
+	{
+		ir = (fapo->irChannels == 1) ? 0 : c;
+		input = early->window + (c * CONVOLUTION_BLOCK * 2) + CONVOLUTION_BLOCK;
+		out = fapo->outBlock + (c * CONVOLUTION_BLOCK);
+
+		/* The late window fills up a block at a time */
+		if (late->partitions > 0)
+		{
+			FAudio_memcpy(
+				late->window +
+					(c * CONVOLUTION_LATE_BLOCK * 2) +
+					CONVOLUTION_LATE_BLOCK +
+					(step * CONVOLUTION_BLOCK),
+				input,
+				sizeof(float) * CONVOLUTION_BLOCK
+			);
+		}
+
+		/* Dry signal, before the window moves on */
+		for (i = 0; i < CONVOLUTION_BLOCK; i += 1)
+		{
+			out[i] = input[i] * dry;
+		}
+
+		ConvolutionSegment_Push(early, c, fapo->scratch);
+		for (p = 0; p < early->partitions; p += 1)
+		{
+			ConvolutionSegment_MAC(early, c, ir, p);
+		}
+		ConvolutionSegment_Pop(
+			early,
+			c,
+			early->output + (c * CONVOLUTION_BLOCK),
+			fapo->scratch
+		);
+		for (i = 0; i < CONVOLUTION_BLOCK; i += 1)
+		{
+			out[i] += early->output[(c * CONVOLUTION_BLOCK) + i] * wet;
+		}
+
+		if (late->partitions == 0)
+		{
+			continue;
+		}
+
+		/* This block's share of the late segment's last output... */
+		lateOut = late->output + (c * CONVOLUTION_LATE_BLOCK) + (step * CONVOLUTION_BLOCK);
+		for (i = 0; i < CONVOLUTION_BLOCK; i += 1)
+		{
+			out[i] += lateOut[i] * wet;
+		}
+
+		/* ... and of the work for the next one */
+		for (p = first; p < last; p += 1)
+		{
+			ConvolutionSegment_MAC(late, c, ir, p);
+		}
+
+		/* A whole late partition of input is in, finish the next output */
+		if (step == CONVOLUTION_LATE_RATIO - 1)
+		{
+			ConvolutionSegment_Push(late, c, fapo->scratch);
+			ConvolutionSegment_MAC(late, c, ir, 0);
+			ConvolutionSegment_Pop(
+				late,
+				c,
+				late->output + (c * CONVOLUTION_LATE_BLOCK),
+				fapo->scratch
+			);
+		}
+	}
+
+	early->current = (early->current + 1) % early->partitions;
+	if (late->partitions > 0)
+	{
+		fapo->lateStep = (step + 1) % CONVOLUTION_LATE_RATIO;
+		if (fapo->lateStep == 0)
+		{
+			late->current = (late->current + 1) % late->partitions;
+		}
+	}
+}
+
+static void FAudioFXConvolution_INTERNAL_Clear(FAudioFXConvolution *fapo)
+{
+	if (fapo->state != NULL)
+	{
+		FAudio_zero(fapo->state, sizeof(float) * (
+			ConvolutionSegment_StateFloats(&fapo->early, fapo->channels) +
+			ConvolutionSegment_StateFloats(&fapo->late, fapo->channels) +
+			(fapo->channels * CONVOLUTION_BLOCK)
+		));
+	}
+	fapo->early.current = 0;
+	fapo->late.current = 0;
+	fapo->lateStep = 0;
+	fapo->fill = 0;
+	fapo->tail.silentFrames = 0;
+	fapo->tail.idle = 1;
+}
+
+/* FAPO Functions */
+
+uint32_t FAudioFXConvolution_LockForProcess(
+	FAudioFXConvolution *fapo,
+	uint32_t InputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pInputLockedParameters,
+	uint32_t OutputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pOutputLockedParameters
+) {
+	uint16_t channels = pInputLockedParameters->pFormat->nChannels;
+	uint32_t earlyFloats, lateFloats;
+	float *state;
+
+	/* A response is either shared by every channel odr has one for each */
+	if (fapo->irChannels != 1 && fapo->irChannels != channels)
+	{
+		return FAPO_E_FORMAT_UNSUPPORTED;
+	}
+
+	if (fapo->state == NULL || channels != fapo->channels)
+	{
+		if (fapo->state != NULL)
+		{
+			fapo->base.pFree(fapo->state);
+		}
+		earlyFloats = ConvolutionSegment_StateFloats(&fapo->early, channels);
+		lateFloats = ConvolutionSegment_StateFloats(&fapo->late, channels);
+		state = (float*) fapo->base.pMalloc(sizeof(float) * (
+			earlyFloats +
+			lateFloats +
+			(channels * CONVOLUTION_BLOCK)
+		));
+		fapo->state = state;
+		state = ConvolutionSegment_Carve(&fapo->early, channels, state);
+		state = ConvolutionSegment_Carve(&fapo->late, channels, state);
+		fapo->outBlock = state;
+		fapo->channels = channels;
+	}
+	FAudioFXConvolution_INTERNAL_Clear(fapo);
+
+	return FAPOBase_LockForProcess(
+		&fapo->base,
+		InputLockedParameterCount,
+		pInputLockedParameters,
+		OutputLockedParameterCount,
+		pOutputLockedParameters
+	);
+}
+
+void FAudioFXConvolution_Process(
+	FAudioFXConvolution *fapo,
+	uint32_t InputProcessParameterCount,
+	const FAPOProcessBufferParameters* pInputProcessParameters,
+	uint32_t OutputProcessParameterCount,
+	FAPOProcessBufferParameters* pOutputProcessParameters,
+	int32_t IsEnabled
+) {
+	FAudioFXConvolutionParametersEXT *params;
+	float *samples = (float*) pInputProcessParameters->pBuffer;
+	uint32_t frames = pInputProcessParameters->ValidFrameCount;
+	uint32_t c, i, chunk, done;
+	float *window, *out;
+	float wet, dry, total = 0.0f;
+
+	params = (FAudioFXConvolutionParametersEXT*) FAPOBase_BeginProcess(&fapo->base);
+	pOutputProcessParameters->BufferFlags = pInputProcessParameters->BufferFlags;
+
+	/* Processing is in place, so a disabled reverb has nothing to do */
+	if (!IsEnabled)
+	{
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
+	/* The tail has died out, nothing to do until there is input again */
+	if (FAudio_INTERNAL_EffectTailIdle(
+		&fapo->tail,
+		pInputProcessParameters->BufferFlags,
+		frames
+	)) {
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+		pOutputProcessParameters->BufferFlags = FAPO_BUFFER_SILENT;
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
+	if (pInputProcessParameters->BufferFlags == FAPO_BUFFER_SILENT)
+	{
+		FAudio_zero(samples, sizeof(float) * frames * fapo->channels);
+	}
+
+	wet = FAudio_clamp(
+		params->WetDryMix,
+		FAUDIOFX_CONVOLUTION_MIN_WET_DRY_MIX,
+		FAUDIOFX_CONVOLUTION_MAX_WET_DRY_MIX
+	) / 100.0f;
+	dry = 1.0f - wet;
+
+	/* Input goes into the blocks as output comes out of the last ones */
+	for (done = 0; done < frames; done += chunk)
+	{
+		chunk = FAudio_min(frames - done, CONVOLUTION_BLOCK - fapo->fill);
+		for (c = 0; c < fapo->channels; c += 1)
+		{
+			window = fapo->early.window +
+				(c * CONVOLUTION_BLOCK * 2) +
+				CONVOLUTION_BLOCK +
+				fapo->fill;
+			out = fapo->outBlock + (c * CONVOLUTION_BLOCK) + fapo->fill;
+			for (i = 0; i < chunk; i += 1)
+			{
+				window[i] = samples[((done + i) * fapo->channels) + c];
+				samples[((done + i) * fapo->channels) + c] = out[i];
+				total += out[i] * out[i];
+			}
+		}
+		fapo->fill += chunk;
+		if (fapo->fill == CONVOLUTION_BLOCK)
+		{
+			FAudioFXConvolution_INTERNAL_Block(fapo, wet, dry);
+			fapo->fill = 0;
+		}
+	}
+
+	pOutputProcessParameters->BufferFlags = (total < FAUDIO_EFFECT_TAIL_SILENCE) ?
+		FAPO_BUFFER_SILENT :
+		FAPO_BUFFER_VALID;
+
+	/* Go idle with clean blocks, so waking up is like starting over */
+	if (FAudio_INTERNAL_EffectTailEnded(
+		&fapo->tail,
+		fapo->irFrames + CONVOLUTION_BLOCK + (
+			(fapo->late.partitions > 0) ? CONVOLUTION_LATE_BLOCK : 0
+		),
+		total
+	)) {
+		FAudioFXConvolution_INTERNAL_Clear(fapo);
+	}
+
+	FAPOBase_EndProcess(&fapo->base);
+}
+
+void FAudioFXConvolution_Reset(FAudioFXConvolution *fapo)
+{
+	FAPOBase_Reset(&fapo->base);
+	FAudioFXConvolution_INTERNAL_Clear(fapo);
+}
+
+void FAudioFXConvolution_Free(void* fapo)
+{
+	FAudioFXConvolution *convolution = (FAudioFXConvolution*) fapo;
+	if (convolution->state != NULL)
+	{
+		convolution->base.pFree(convolution->state);
+	}
+	convolution->base.pFree(convolution->early.filter);
+	convolution->base.pFree(convolution->base.m_pParameterBlocks);
+	convolution->base.pFree(fapo);
+}
+
+/* Filter Spectra */
+
+/* Each partition of the response is zero-padded to a whole window */
+static void FAudioFXConvolution_INTERNAL_Partition(
+	ConvolutionSegment *segment,
+	const float *pImpulseResponse,
+	uint32_t ImpulseFrameCount,
+	uint16_t ImpulseChannelCount,
+	uint32_t offset,
+	float *window,
+	float *scratch
+) {
+	const uint32_t size = segment->transform.size;
+	const float scale = 1.0f / (8.0f * size);
+	uint32_t c, p, i, frames;
+	float *h;
+
+	for (c = 0; c < ImpulseChannelCount; c += 1)
+	for (p = 0; p < segment->partitions; p += 1)
+	{
+		frames = FAudio_min(
+			size,
+			ImpulseFrameCount - (offset + (p * size))
+		);
+		FAudio_zero(window, sizeof(float) * size * 2);
+		for (i = 0; i < frames; i += 1)
+		{
+			window[i] = pImpulseResponse[
+				((offset + (p * size) + i) * ImpulseChannelCount) + c
+			] * scale;
+		}
+		h = ConvolutionSegment_Spectrum(
+			segment,
+			segment->filter + (c * segment->partitions * size * 2),
+			p
+		);
+		ConvolutionTransform_Forward(
+			&segment->transform,
+			window,
+			h,
+			h + size,
+			scratch
+		);
+	}
+}
+
+/* Public API */
+
+uint32_t FAudioCreateConvolutionReverbEXT(
+	FAPO** ppApo,
+	uint32_t Flags,
+	const float *pImpulseResponse,
+	uint32_t ImpulseFrameCount,
+	uint16_t ImpulseChannelCount
+) {
+	return FAudioCreateConvolutionReverbWithCustomAllocatorEXT(
+		ppApo,
+		Flags,
+		pImpulseResponse,
+		ImpulseFrameCount,
+		ImpulseChannelCount,
+		FAudio_malloc,
+		FAudio_free,
+		FAudio_realloc
+	);
+}
+
+uint32_t FAudioCreateConvolutionReverbWithCustomAllocatorEXT(
+	FAPO** ppApo,
+	uint32_t Flags,
+	const float *pImpulseResponse,
+	uint32_t ImpulseFrameCount,
+	uint16_t ImpulseChannelCount,
+	FAudioMallocFunc customMalloc,
+	FAudioFreeFunc customFree,
+	FAudioReallocFunc customRealloc
+) {
+	const FAudioFXConvolutionParametersEXT fxdefault =
+	{
+		FAUDIOFX_CONVOLUTION_DEFAULT_WET_DRY_MIX
+	};
+	FAudioFXConvolution *result;
+	uint8_t *params;
+	uint32_t earlyPartitions, latePartitions, earlyFloats, lateFloats;
+	uint32_t *reversed;
+	float *filter, *window;
+
+	if (	pImpulseResponse == NULL ||
+		ImpulseFrameCount == 0 ||
+		ImpulseChannelCount == 0	)
+	{
+		return FAUDIO_E_INVALID_CALL;
+	}
+
+	/* Only long responses are worth a late segment */
+	if (	(Flags & FAUDIOFX_CONVOLUTION_NON_UNIFORM_EXT) &&
+		ImpulseFrameCount > CONVOLUTION_LATE_BLOCK	)
+	{
+		earlyPartitions = CONVOLUTION_LATE_RATIO;
+
+		/* Everything past the early segment, rounded up */
+		latePartitions = (ImpulseFrameCount - 1) / CONVOLUTION_LATE_BLOCK;
+	}
+	else
+	{
+		earlyPartitions = (
+			ImpulseFrameCount + CONVOLUTION_BLOCK - 1
+		) / CONVOLUTION_BLOCK;
+		latePartitions = 0;
+	}
+	earlyFloats = ImpulseChannelCount * earlyPartitions * CONVOLUTION_BLOCK * 2;
+	lateFloats = ImpulseChannelCount * latePartitions * CONVOLUTION_LATE_BLOCK * 2;
+
+	/* Allocate... */
+	result = (FAudioFXConvolution*) customMalloc(sizeof(FAudioFXConvolution));
+	params = (uint8_t*) customMalloc(
+		sizeof(FAudioFXConvolutionParametersEXT) * 3
+	);
+	#define INITPARAMS(offset) \
+		FAudio_memcpy( \
+			params + sizeof(FAudioFXConvolutionParametersEXT) * offset, \
+			&fxdefault, \
+			sizeof(FAudioFXConvolutionParametersEXT) \
+		);
+	INITPARAMS(0)
+	INITPARAMS(1)
+	INITPARAMS(2)
+	#undef INITPARAMS
+
+	/* The filters, both transforms' tables and the scratch, in one block */
+	filter = (float*) customMalloc(
+		(sizeof(float) * (
+			earlyFloats +
+			lateFloats +
+			ConvolutionTransform_Floats(CONVOLUTION_BLOCK) +
+			ConvolutionTransform_Floats(CONVOLUTION_LATE_BLOCK) +
+			(CONVOLUTION_LATE_BLOCK * 4)
+		)) +
+		(sizeof(uint32_t) * (CONVOLUTION_BLOCK + CONVOLUTION_LATE_BLOCK))
+	);
+
+	/* Initialize... */
+	FAudio_memcpy(
+		&ConvolutionProperties.clsid,
+		&FAudioFX_CLSID_ConvolutionReverbEXT,
+		sizeof(FAudioGUID)
+	);
+	CreateFAPOBaseWithCustomAllocatorEXT(
+		&result->base,
+		&ConvolutionProperties,
+		params,
+		sizeof(FAudioFXConvolutionParametersEXT),
+		0,
+		customMalloc,
+		customFree,
+		customRealloc
+	);
+
+	result->channels = 0;
+	result->irChannels = ImpulseChannelCount;
+	result->irFrames = ImpulseFrameCount;
+	result->lateStep = 0;
+	result->fill = 0;
+	result->outBlock = NULL;
+	result->state = NULL;
+	result->tail.silentFrames = 0;
+	result->tail.idle = 1;
+
+	FAudio_zero(&result->early, sizeof(ConvolutionSegment));
+	FAudio_zero(&result->late, sizeof(ConvolutionSegment));
+	result->early.partitions = earlyPartitions;
+	result->early.filter = filter;
+	filter += earlyFloats;
+	result->late.partitions = latePartitions;
+	result->late.filter = filter;
+	filter += lateFloats;
+	reversed = (uint32_t*) (
+		filter +
+		ConvolutionTransform_Floats(CONVOLUTION_BLOCK) +
+		ConvolutionTransform_Floats(CONVOLUTION_LATE_BLOCK) +
+		(CONVOLUTION_LATE_BLOCK * 4)
+	);
+	ConvolutionTransform_Init(
+		&result->early.transform,
+		CONVOLUTION_BLOCK,
+		filter,
+		reversed
+	);
+	filter += ConvolutionTransform_Floats(CONVOLUTION_BLOCK);
+	ConvolutionTransform_Init(
+		&result->late.transform,
+		CONVOLUTION_LATE_BLOCK,
+		filter,
+		reversed + CONVOLUTION_BLOCK
+	);
+	filter += ConvolutionTransform_Floats(CONVOLUTION_LATE_BLOCK);
+	result->scratch = filter;
+
+	/* The window for the filter spectra is the scratch's second half */
+	window = result->scratch + (CONVOLUTION_LATE_BLOCK * 2);
+	FAudioFXConvolution_INTERNAL_Partition(
+		&result->early,
+		pImpulseResponse,
+		ImpulseFrameCount,
+		ImpulseChannelCount,
+		0,
+		window,
+		result->scratch
+	);
+	FAudioFXConvolution_INTERNAL_Partition(
+		&result->late,
+		pImpulseResponse,
+		ImpulseFrameCount,
+		ImpulseChannelCount,
+		CONVOLUTION_LATE_BLOCK,
+		window,
+		result->scratch
+	);
+
+	/* Function table... */
+	#define ASSIGN_VT(name) \
+		result->base.base.name = (name##Func) FAudioFXConvolution_##name;
+	ASSIGN_VT(LockForProcess);
+	ASSIGN_VT(Reset);
+	ASSIGN_VT(Process);
+	result->base.Destructor = FAudioFXConvolution_Free;
+	#undef ASSIGN_VT
+
+	/* Finally. */
+	*ppApo = &result->base.base;
+	return 0;
+}
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
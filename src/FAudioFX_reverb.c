@@ -31,7 +31,7 @@
 
 /* constants */
 #define PI 3.1415926536f
-#define DSP_DELAY_MAX_DELAY_MS 300
+#define DSP_ARENA_ALIGNMENT 64
 
 /* utility functions */
 static inline float FAudioFX_INTERNAL_DbGainToFactor(float gain)
@@ -44,28 +44,26 @@ static inline uint32_t FAudioFX_INTERNAL_MsToSamples(float msec, int32_t sampleR
 	return (uint32_t)((sampleRate * msec) / 1000.0f);
 }
 
-static inline float FAudioFX_INTERNAL_undenormalize(float sample_in)
+/* All of a reverb's delay lines are carved out of the one block it is
+ * allocated in, each starting on its own cache line.
+ */
+static inline uint32_t FAudioFX_INTERNAL_DelayCapacity(float max_delay_ms, int32_t sampleRate)
+{
+	/* one more than the longest delay, so that read_idx never laps write_idx */
+	return FAudioFX_INTERNAL_MsToSamples(max_delay_ms, sampleRate) + 1;
+}
+
+static inline size_t FAudioFX_INTERNAL_ArenaSize(size_t size)
+{
+	return (size + (DSP_ARENA_ALIGNMENT - 1)) & ~((size_t) DSP_ARENA_ALIGNMENT - 1);
+}
+
+static inline void *FAudioFX_INTERNAL_ArenaCarve(uint8_t **arena, size_t size)
 {
-	union
-	{
-		float f;
-		uint32_t i;
-	} sampleHack;
-	uint32_t exponent;
-	int32_t denormal_factor;
-
-	/* Set denormal (or subnormal) float values to zero.
-	 * (See: https://en.wikipedia.org/wiki/Denormal_number)
-	 * Based upon code available from:
-	 * http://www.musicdsp.org/archive.php?classid=5#191)
-	 */
-	sampleHack.f = sample_in;
-	exponent = sampleHack.i & 0x7F800000;
-
-	/* exponent > 0 is 0 if denormalized, otherwise 1 */
-	denormal_factor = exponent > 0;
-
-	return sample_in * denormal_factor;
+	void *result = *arena;
+	FAudio_assert(((size_t) result & (DSP_ARENA_ALIGNMENT - 1)) == 0);
+	*arena += FAudioFX_INTERNAL_ArenaSize(size);
+	return result;
 }
 
 /* component - delay */
@@ -83,61 +81,70 @@ static void DspDelay_Initialize(
 	DspDelay *filter,
 	int32_t sampleRate,
 	float delay_ms,
-	FAudioMallocFunc pMalloc
+	float max_delay_ms,
+	uint8_t **arena
 ) {
-	FAudio_assert(delay_ms >= 0 && delay_ms <= DSP_DELAY_MAX_DELAY_MS);
+	FAudio_assert(delay_ms >= 0 && delay_ms <= max_delay_ms);
 	FAudio_assert(filter != NULL);
 
 	filter->sampleRate = sampleRate;
-	filter->capacity = FAudioFX_INTERNAL_MsToSamples(DSP_DELAY_MAX_DELAY_MS, sampleRate);
+	filter->capacity = FAudioFX_INTERNAL_DelayCapacity(max_delay_ms, sampleRate);
 	filter->delay = FAudioFX_INTERNAL_MsToSamples(delay_ms, sampleRate);
 	filter->read_idx = 0;
 	filter->write_idx = filter->delay;
-	filter->buffer = (float*) pMalloc(filter->capacity * sizeof(float));
-	FAudio_zero(filter->buffer, filter->capacity * sizeof(float));
+	filter->buffer = (float*) FAudioFX_INTERNAL_ArenaCarve(
+		arena,
+		filter->capacity * sizeof(float)
+	);
 }
 
 static void DspDelay_Change(DspDelay *filter, float delay_ms)
 {
 	FAudio_assert(filter != NULL);
-	FAudio_assert(delay_ms >= 0 && delay_ms <= DSP_DELAY_MAX_DELAY_MS);
+	FAudio_assert(delay_ms >= 0);
 
 	/* length */
 	filter->delay = FAudioFX_INTERNAL_MsToSamples(delay_ms, filter->sampleRate);
+	FAudio_assert(filter->delay < filter->capacity);
 	filter->read_idx = (filter->write_idx - filter->delay + filter->capacity) % filter->capacity;
 }
 
-static inline float DspDelay_Read(DspDelay *filter)
-{
-	float delay_out;
-
-	FAudio_assert(filter != NULL);
-	FAudio_assert(filter->read_idx < filter->capacity);
-
-	delay_out = filter->buffer[filter->read_idx];
-	filter->read_idx = (filter->read_idx + 1) % filter->capacity;
-	return delay_out;
-}
-
-static inline void DspDelay_Write(DspDelay *filter, float sample)
-{
-	FAudio_assert(filter != NULL);
-	FAudio_assert(filter->write_idx < filter->capacity);
-
-	filter->buffer[filter->write_idx] = sample;
-	filter->write_idx = (filter->write_idx + 1) % filter->capacity;
-}
-
-static inline float DspDelay_Process(DspDelay *filter, float sample_in)
-{
-	float delay_out;
+/* Every stage processes a whole block at once, with its state kept in locals.
+ * The output may be the same buffer as the input.
+ */
+static inline void DspDelay_Process(
+	DspDelay *filter,
+	const float *samples_in,
+	float *samples_out,
+	size_t sample_count
+) {
+	float *buffer = filter->buffer;
+	uint32_t read_idx = filter->read_idx;
+	uint32_t write_idx = filter->write_idx;
+	float sample_in;
+	size_t s;
 
-	FAudio_assert(filter != NULL);
+	FAudio_assert(read_idx < filter->capacity);
+	FAudio_assert(write_idx < filter->capacity);
 
-	delay_out = DspDelay_Read(filter);
-	DspDelay_Write(filter, sample_in);
+	for (s = 0; s < sample_count; ++s)
+	{
+		/* write first, so that a delay of 0 is no delay at all */
+		sample_in = samples_in[s];
+		buffer[write_idx] = sample_in;
+		samples_out[s] = buffer[read_idx];
+		if (++read_idx == filter->capacity)
+		{
+			read_idx = 0;
+		}
+		if (++write_idx == filter->capacity)
+		{
+			write_idx = 0;
+		}
+	}
 
-	return delay_out;
+	filter->read_idx = read_idx;
+	filter->write_idx = write_idx;
 }
 
 static inline float DspDelay_Tap(DspDelay *filter, uint32_t delay)
@@ -155,78 +162,6 @@ static inline void DspDelay_Reset(DspDelay *filter)
 	FAudio_zero(filter->buffer, filter->capacity * sizeof(float));
 }
 
-static void DspDelay_Destroy(DspDelay *filter, FAudioFreeFunc pFree)
-{
-	FAudio_assert(filter != NULL);
-	pFree(filter->buffer);
-}
-
-/* component - comb filter */
-typedef struct DspComb
-{
-	DspDelay delay;
-	float feedback_gain;
-} DspComb;
-
-static inline float DspComb_FeedbackFromRT60(DspComb *filter, float rt60_ms)
-{
-	float exponent;
-
-	if (rt60_ms == 0)
-	{
-		return 0;
-	}
-
-	exponent = (-3.0f * filter->delay.delay * 1000.0f) / (filter->delay.sampleRate * rt60_ms);
-	return (float)FAudio_pow(10.0f, exponent);
-}
-
-static void DspComb_Initialize(
-	DspComb *filter,
-	int32_t sampleRate,
-	float delay_ms,
-	float rt60_ms,
-	FAudioMallocFunc pMalloc
-) {
-	FAudio_assert(filter != NULL);
-
-	DspDelay_Initialize(&filter->delay, sampleRate, delay_ms, pMalloc);
-	filter->feedback_gain = DspComb_FeedbackFromRT60(filter, rt60_ms);
-}
-
-static void DspComb_Change(DspComb *filter, float delay_ms, float rt60_ms)
-{
-	FAudio_assert(filter != NULL);
-
-	DspDelay_Change(&filter->delay, delay_ms);
-	filter->feedback_gain = DspComb_FeedbackFromRT60(filter, rt60_ms);
-}
-
-static inline float DspComb_Process(DspComb *filter, float sample_in)
-{
-	float delay_out, to_buf;
-
-	FAudio_assert(filter != NULL);
-
-	delay_out = DspDelay_Read(&filter->delay);
-
-	to_buf = FAudioFX_INTERNAL_undenormalize(sample_in + (filter->feedback_gain * delay_out));
-	DspDelay_Write(&filter->delay, to_buf);
-
-	return delay_out;
-}
-
-static inline void DspComb_Reset(DspComb *filter)
-{
-	DspDelay_Reset(&filter->delay);
-}
-
-static void DspComb_Destroy(DspComb *filter, FAudioFreeFunc pFree)
-{
-	FAudio_assert(filter != NULL);
-	DspDelay_Destroy(&filter->delay, pFree);
-}
-
 /* component - bi-quad filter */
 typedef enum DspBiQuadType
 {
@@ -325,21 +260,34 @@ static void DspBiQuad_Change(DspBiQuad *filter, float frequency, float q, float
 	}
 }
 
-static inline float DspBiQuad_Process(DspBiQuad *filter, float sample_in)
-{
-	/* Direct Form II Transposed:
-		- less delay registers than Direct Form I
-		- more numerically stable than Direct Form II */
-	float result = (filter->a0 * sample_in) + filter->delay[0];
-	filter->delay[0] = (filter->a1 * sample_in) - (filter->b1 * result) + filter->delay[1];
-	filter->delay[1] = (filter->a2 * sample_in) - (filter->b2 * result);
-
-	result = FAudioFX_INTERNAL_undenormalize(
-		(result * filter->c0) + 
-		(sample_in * filter->d0)
-	);
+static inline void DspBiQuad_Process(
+	DspBiQuad *filter,
+	const float *samples_in,
+	float *samples_out,
+	size_t sample_count
+) {
+	const float a0 = filter->a0, a1 = filter->a1, a2 = filter->a2;
+	const float b1 = filter->b1, b2 = filter->b2;
+	const float c0 = filter->c0, d0 = filter->d0;
+	float delay0 = filter->delay[0], delay1 = filter->delay[1];
+	float sample_in, result;
+	size_t s;
+
+	for (s = 0; s < sample_count; ++s)
+	{
+		/* Direct Form II Transposed:
+			- less delay registers than Direct Form I
+			- more numerically stable than Direct Form II */
+		sample_in = samples_in[s];
+		result = (a0 * sample_in) + delay0;
+		delay0 = (a1 * sample_in) - (b1 * result) + delay1;
+		delay1 = (a2 * sample_in) - (b2 * result);
+
+		samples_out[s] = (result * c0) + (sample_in * d0);
+	}
 
-	return  result;
+	filter->delay[0] = delay0;
+	filter->delay[1] = delay1;
 }
 
 static inline void DspBiQuad_Reset(DspBiQuad *filter)
@@ -348,91 +296,129 @@ static inline void DspBiQuad_Reset(DspBiQuad *filter)
 	FAudio_zero(&filter->delay, sizeof(filter->delay));
 }
 
-static void DspBiQuad_Destroy(DspBiQuad *filter)
-{
+/* component - bank of comb filters with integrated low shelving and high
+ * shelving filters, processed side by side by FAudio_INTERNAL_ProcessCombBank
+ */
+static inline float DspCombBank_FeedbackFromRT60(
+	uint32_t delay,
+	int32_t sampleRate,
+	float rt60_ms
+) {
+	float exponent;
+
+	if (rt60_ms == 0)
+	{
+		return 0;
+	}
+
+	exponent = (-3.0f * delay * 1000.0f) / (sampleRate * rt60_ms);
+	return (float)FAudio_pow(10.0f, exponent);
 }
 
-/* component - comb filter with integrated low shelving and high shelving filter */
-typedef struct DspCombShelving {
-	DspComb comb;
-	DspBiQuad low_shelving;
-	DspBiQuad high_shelving;
-} DspCombShelving;
+static void DspCombBank_SetShelving(
+	FAudioCombShelf *shelf,
+	int32_t sampleRate,
+	DspBiQuadType type,
+	float frequency,
+	float gain
+) {
+	DspBiQuad filter;
+	int32_t i;
+
+	DspBiQuad_Initialize(&filter, sampleRate, type, frequency, 0.0f, gain);
+	FAudio_assert(filter.a2 == 0.0f && filter.b2 == 0.0f);
+	for (i = 0; i < FAUDIO_COMB_BANK_SIZE; ++i)
+	{
+		shelf->a0[i] = filter.a0;
+		shelf->a1[i] = filter.a1;
+		shelf->b1[i] = filter.b1;
+		shelf->c0[i] = filter.c0;
+		shelf->d0[i] = filter.d0;
+	}
+}
 
-static void DspCombShelving_Initialize(
-	DspCombShelving *filter,
+static void DspCombBank_Change(
+	FAudioCombBank *filter,
 	int32_t sampleRate,
-	float delay_ms,
+	const float *delay_ms,
+	float rt60_ms
+) {
+	int32_t i;
+
+	FAudio_assert(filter != NULL);
+
+	for (i = 0; i < FAUDIO_COMB_BANK_SIZE; ++i)
+	{
+		FAudio_assert(delay_ms[i] >= 0);
+		filter->delay[i] = FAudioFX_INTERNAL_MsToSamples(delay_ms[i], sampleRate);
+		FAudio_assert(filter->delay[i] < filter->capacity);
+		filter->read_idx[i] = (
+			filter->write_idx - filter->delay[i] + filter->capacity
+		) % filter->capacity;
+		filter->feedback[i] = DspCombBank_FeedbackFromRT60(
+			filter->delay[i],
+			sampleRate,
+			rt60_ms
+		);
+	}
+}
+
+static void DspCombBank_Initialize(
+	FAudioCombBank *filter,
+	int32_t sampleRate,
+	const float *delay_ms,
 	float rt60_ms,
 	float low_frequency,
 	float low_gain,
 	float high_frequency,
 	float high_gain,
-	FAudioMallocFunc pMalloc
+	float max_delay_ms,
+	uint8_t **arena
 ) {
 	FAudio_assert(filter != NULL);
-	DspComb_Initialize(
-		&filter->comb,
-		sampleRate,
-		delay_ms,
-		rt60_ms,
-		pMalloc
+
+	FAudio_zero(filter, sizeof(FAudioCombBank));
+	filter->capacity = FAudioFX_INTERNAL_DelayCapacity(max_delay_ms, sampleRate);
+	filter->buffer = (float*) FAudioFX_INTERNAL_ArenaCarve(
+		arena,
+		filter->capacity * FAUDIO_COMB_BANK_SIZE * sizeof(float)
 	);
-	DspBiQuad_Initialize(
-		&filter->low_shelving, 
-		sampleRate, 
-		DSP_BIQUAD_LOWSHELVING, 
-		low_frequency, 
-		0.0f, 
+	DspCombBank_Change(filter, sampleRate, delay_ms, rt60_ms);
+	DspCombBank_SetShelving(
+		&filter->low_shelving,
+		sampleRate,
+		DSP_BIQUAD_LOWSHELVING,
+		low_frequency,
 		low_gain
 	);
-	DspBiQuad_Initialize(
-		&filter->high_shelving, 
-		sampleRate, 
-		DSP_BIQUAD_HIGHSHELVING, 
-		high_frequency, 
-		0.0f, 
+	DspCombBank_SetShelving(
+		&filter->high_shelving,
+		sampleRate,
+		DSP_BIQUAD_HIGHSHELVING,
+		high_frequency,
 		high_gain
 	);
 }
 
-static inline float DspCombShelving_Process(DspCombShelving *filter, float sample_in)
+static void DspCombBank_Reset(FAudioCombBank *filter)
 {
-	float delay_out, feedback, to_buf;
-
-	FAudio_assert(filter != NULL);
-
-	delay_out = DspDelay_Read(&filter->comb.delay);
-
-	/* apply shelving filters */
-	feedback = DspBiQuad_Process(&filter->high_shelving, delay_out);
-	feedback = DspBiQuad_Process(&filter->low_shelving, feedback);
-
-	/* apply comb filter */
-	to_buf = FAudioFX_INTERNAL_undenormalize(sample_in + (filter->comb.feedback_gain * feedback));
-	DspDelay_Write(&filter->comb.delay, to_buf);
-
-	return delay_out;
-}
-
-static void DspCombShelving_Reset(DspCombShelving *filter)
-{
-	FAudio_assert(filter != NULL);
-
-	DspComb_Reset(&filter->comb);
-	DspBiQuad_Reset(&filter->low_shelving);
-	DspBiQuad_Reset(&filter->high_shelving);
-}
+	int32_t i;
 
-static void DspCombShelving_Destroy(
-	DspCombShelving *filter,
-	FAudioFreeFunc pFree
-) {
 	FAudio_assert(filter != NULL);
 
-	DspComb_Destroy(&filter->comb, pFree);
-	DspBiQuad_Destroy(&filter->low_shelving);
-	DspBiQuad_Destroy(&filter->high_shelving);
+	filter->write_idx = 0;
+	for (i = 0; i < FAUDIO_COMB_BANK_SIZE; ++i)
+	{
+		filter->read_idx[i] = (
+			filter->capacity - filter->delay[i]
+		) % filter->capacity;
+	}
+	FAudio_zero(
+		filter->buffer,
+		filter->capacity * FAUDIO_COMB_BANK_SIZE * sizeof(float)
+	);
+	FAudio_zero(filter->low_shelving.delay, sizeof(filter->low_shelving.delay));
+	FAudio_zero(filter->high_shelving.delay, sizeof(filter->high_shelving.delay));
 }
 
 /* component: delaying all-pass filter */
@@ -447,11 +433,12 @@ static void DspAllPass_Initialize(
 	int32_t sampleRate,
 	float delay_ms,
 	float gain,
-	FAudioMallocFunc pMalloc
+	uint8_t **arena
 ) {
 	FAudio_assert(filter != NULL);
 
-	DspDelay_Initialize(&filter->delay, sampleRate, delay_ms, pMalloc);
+	/* all-pass delays never change, so they only need room for that */
+	DspDelay_Initialize(&filter->delay, sampleRate, delay_ms, delay_ms, arena);
 	filter->feedback_gain = gain;
 }
 
@@ -463,18 +450,43 @@ static void DspAllPass_Change(DspAllPass *filter, float delay_ms, float gain)
 	filter->feedback_gain = gain;
 }
 
-static inline float DspAllPass_Process(DspAllPass *filter, float sample_in)
-{
+static inline void DspAllPass_Process(
+	DspAllPass *filter,
+	const float *samples_in,
+	float *samples_out,
+	size_t sample_count
+) {
+	float *buffer = filter->delay.buffer;
+	uint32_t read_idx = filter->delay.read_idx;
+	uint32_t write_idx = filter->delay.write_idx;
+	const float feedback_gain = filter->feedback_gain;
 	float delay_out, to_buf;
+	size_t s;
 
-	FAudio_assert(filter != NULL);
+	FAudio_assert(read_idx < filter->delay.capacity);
+	FAudio_assert(write_idx < filter->delay.capacity);
+
+	for (s = 0; s < sample_count; ++s)
+	{
+		delay_out = buffer[read_idx];
+
+		to_buf = samples_in[s] + (feedback_gain * delay_out);
+		buffer[write_idx] = to_buf;
 
-	delay_out = DspDelay_Read(&filter->delay);
+		samples_out[s] = delay_out - (feedback_gain * to_buf);
 
-	to_buf = FAudioFX_INTERNAL_undenormalize(sample_in + (filter->feedback_gain * delay_out));
-	DspDelay_Write(&filter->delay, to_buf);
+		if (++read_idx == filter->delay.capacity)
+		{
+			read_idx = 0;
+		}
+		if (++write_idx == filter->delay.capacity)
+		{
+			write_idx = 0;
+		}
+	}
 
-	return FAudioFX_INTERNAL_undenormalize(delay_out - (filter->feedback_gain * to_buf));
+	filter->delay.read_idx = read_idx;
+	filter->delay.write_idx = write_idx;
 }
 
 static void DspAllPass_Reset(DspAllPass *filter)
@@ -483,12 +495,6 @@ static void DspAllPass_Reset(DspAllPass *filter)
 	DspDelay_Reset(&filter->delay);
 }
 
-static void DspAllPass_Destroy(DspAllPass *filter, FAudioFreeFunc pFree)
-{
-	FAudio_assert(filter != NULL);
-	DspDelay_Destroy(&filter->delay, pFree);
-}
-
 /*
 Reverb network - loosely based on the reverberator from
 "Designing Audio Effect Plug-Ins in C++" by Will Pirkle and
@@ -560,7 +566,7 @@ float RoomSize;					1 - 100 feet (NOT USED YET)
 
 */
 
-#define REVERB_COUNT_COMB 8
+#define REVERB_COUNT_COMB FAUDIO_COMB_BANK_SIZE
 #define REVERB_COUNT_APF_IN	1
 #define REVERB_COUNT_APF_OUT 4
 
@@ -601,29 +607,91 @@ static const float STEREO_SPREAD[4] =
 typedef struct DspReverbChannel
 {
 	DspDelay reverb_delay;
-	DspCombShelving	lpf_comb[REVERB_COUNT_COMB];
+	FAudioCombBank lpf_comb;
 	DspAllPass	apf_out[REVERB_COUNT_APF_OUT];
 	DspBiQuad room_high_shelf;
 	float early_gain;
 	float gain;
 } DspReverbChannel;
 
-typedef struct DspReverb
+struct DspReverb
 {
 	DspDelay early_delay;
 	DspAllPass apf_in[REVERB_COUNT_APF_IN];
 	
+	int32_t sampleRate;
 	int32_t in_channels;
 	int32_t out_channels;
 	int32_t reverb_channels;
-	DspReverbChannel channel[4];
+	DspReverbChannel *channel;
 
 	float early_gain;
 	float reverb_gain;
 	float room_gain;
 	float wet_ratio;
 	float dry_ratio;
-} DspReverb;
+};
+
+/* The comb delays of a channel, returns the longest */
+static float DspReverb_INTERNAL_CombDelays(int32_t c, float *delay_ms)
+{
+	float result = 0.0f;
+	int32_t i;
+
+	for (i = 0; i < REVERB_COUNT_COMB; ++i)
+	{
+		delay_ms[i] = COMB_DELAYS[i] + STEREO_SPREAD[c];
+		result = FAudio_max(result, delay_ms[i]);
+	}
+	return result;
+}
+
+/* A reverb is allocated as one block: the DspReverb, then its channels, then
+ * every delay line in the order they are processed. This is the size of what
+ * comes after the DspReverb, and must match what DspReverb_Create carves.
+ */
+static size_t DspReverb_INTERNAL_ArenaSize(
+	int32_t sampleRate,
+	int32_t reverb_channels
+) {
+	float comb_delays[REVERB_COUNT_COMB];
+	float comb_max;
+	size_t size;
+	int32_t i, c;
+
+	size = FAudioFX_INTERNAL_ArenaSize(reverb_channels * sizeof(DspReverbChannel));
+	size += FAudioFX_INTERNAL_ArenaSize(FAudioFX_INTERNAL_DelayCapacity(
+		FAUDIOFX_REVERB_MAX_REFLECTIONS_DELAY,
+		sampleRate
+	) * sizeof(float));
+	for (i = 0; i < REVERB_COUNT_APF_IN; ++i)
+	{
+		size += FAudioFX_INTERNAL_ArenaSize(FAudioFX_INTERNAL_DelayCapacity(
+			APF_IN_DELAYS[i],
+			sampleRate
+		) * sizeof(float));
+	}
+	for (c = 0; c < reverb_channels; ++c)
+	{
+		size += FAudioFX_INTERNAL_ArenaSize(FAudioFX_INTERNAL_DelayCapacity(
+			FAUDIOFX_REVERB_MAX_REVERB_DELAY + FAUDIOFX_REVERB_MAX_REAR_DELAY,
+			sampleRate
+		) * sizeof(float));
+		comb_max = DspReverb_INTERNAL_CombDelays(c, comb_delays);
+		size += FAudioFX_INTERNAL_ArenaSize(FAudioFX_INTERNAL_DelayCapacity(
+			comb_max,
+			sampleRate
+		) * FAUDIO_COMB_BANK_SIZE * sizeof(float));
+		for (i = 0; i < REVERB_COUNT_APF_OUT; ++i)
+		{
+			size += FAudioFX_INTERNAL_ArenaSize(FAudioFX_INTERNAL_DelayCapacity(
+				APF_OUT_DELAYS[i] + STEREO_SPREAD[c],
+				sampleRate
+			) * sizeof(float));
+		}
+	}
+	return size;
+}
 
 DspReverb *DspReverb_Create(
 	int32_t sampleRate,
@@ -632,14 +700,48 @@ DspReverb *DspReverb_Create(
 	FAudioMallocFunc pMalloc
 ) {
 	DspReverb *reverb;
-	int32_t i, c;
+	float comb_delays[REVERB_COUNT_COMB];
+	float comb_max;
+	int32_t i, c, reverb_channels;
+	uint8_t *arena, *arena_start;
+	size_t arena_size, size;
 
 	FAudio_assert(in_channels == 1 || in_channels == 2);
-	FAudio_assert(out_channels == 1 || out_channels == 2 || out_channels == 6);
+	FAudio_assert(
+		out_channels == 1 ||
+		out_channels == 2 ||
+		out_channels == 4 ||
+		out_channels == 6 ||
+		out_channels == 8
+	);
+
+	/* quad, 5.1 and 7.1 all run front and rear networks */
+	reverb_channels = (out_channels >= 4) ? 4 : out_channels;
+	arena_size = DspReverb_INTERNAL_ArenaSize(sampleRate, reverb_channels);
+	size = sizeof(DspReverb) + (DSP_ARENA_ALIGNMENT - 1) + arena_size;
+
+	reverb = (DspReverb*) pMalloc(size);
+	FAudio_zero(reverb, size);
+
+	/* the arena starts on the first cache line after the DspReverb */
+	arena_start = (uint8_t*) FAudioFX_INTERNAL_ArenaSize(
+		(size_t) (reverb + 1)
+	);
+	arena = arena_start;
+
+	reverb->reverb_channels = reverb_channels;
+	reverb->channel = (DspReverbChannel*) FAudioFX_INTERNAL_ArenaCarve(
+		&arena,
+		reverb_channels * sizeof(DspReverbChannel)
+	);
 
-	reverb = (DspReverb*) pMalloc(sizeof(DspReverb));
-	FAudio_zero(reverb, sizeof(DspReverb));
-	DspDelay_Initialize(&reverb->early_delay, sampleRate, 10, pMalloc);
+	DspDelay_Initialize(
+		&reverb->early_delay,
+		sampleRate,
+		10,
+		FAUDIOFX_REVERB_MAX_REFLECTIONS_DELAY,
+		&arena
+	);
 
 	for (i = 0; i < REVERB_COUNT_APF_IN; ++i)
 	{
@@ -648,35 +750,33 @@ DspReverb *DspReverb_Create(
 			sampleRate,
 			APF_IN_DELAYS[i],
 			0.5f,
-			pMalloc
+			&arena
 		);
 	}
 
-	reverb->reverb_channels = (out_channels == 6) ? 4 : out_channels;
-
 	for (c = 0; c < reverb->reverb_channels; ++c)
 	{
 		DspDelay_Initialize(
 			&reverb->channel[c].reverb_delay,
 			sampleRate,
 			10,
-			pMalloc
+			FAUDIOFX_REVERB_MAX_REVERB_DELAY + FAUDIOFX_REVERB_MAX_REAR_DELAY,
+			&arena
 		);
 
-		for (i = 0; i < REVERB_COUNT_COMB; ++i)
-		{
-			DspCombShelving_Initialize(
-				&reverb->channel[c].lpf_comb[i], 
-				sampleRate, 
-				COMB_DELAYS[i] + STEREO_SPREAD[c], 
-				500, 
-				500, 
-				-6, 
-				5000, 
-				-6,
-				pMalloc
-			);
-		}
+		comb_max = DspReverb_INTERNAL_CombDelays(c, comb_delays);
+		DspCombBank_Initialize(
+			&reverb->channel[c].lpf_comb,
+			sampleRate,
+			comb_delays,
+			500,
+			500,
+			-6,
+			5000,
+			-6,
+			comb_max,
+			&arena
+		);
 
 		for (i = 0; i < REVERB_COUNT_APF_OUT; ++i)
 		{
@@ -685,7 +785,7 @@ DspReverb *DspReverb_Create(
 				sampleRate, 
 				APF_OUT_DELAYS[i] + STEREO_SPREAD[c], 
 				0.5f,
-				pMalloc
+				&arena
 			);
 		}
 
@@ -704,9 +804,11 @@ DspReverb *DspReverb_Create(
 	reverb->reverb_gain = 1.0f;
 	reverb->dry_ratio = 0.0f;
 	reverb->wet_ratio = 1.0f;
+	reverb->sampleRate = sampleRate;
 	reverb->in_channels = in_channels;
 	reverb->out_channels = out_channels;
 
+	FAudio_assert((size_t) (arena - arena_start) == arena_size);
 	return reverb;
 }
 
@@ -714,6 +816,7 @@ void DspReverb_SetParameters(DspReverb *reverb, FAudioFXReverbParameters *params
 {
 	float early_diffusion, late_diffusion;
 	float channel_delay[4] = { 0.0f, 0.0f, params->RearDelay, params->RearDelay };
+	float comb_delays[REVERB_COUNT_COMB];
 	int32_t i, c;
 
 	/* pre delay */
@@ -732,28 +835,30 @@ void DspReverb_SetParameters(DspReverb *reverb, FAudioFXReverbParameters *params
 	{
 		DspDelay_Change(&reverb->channel[c].reverb_delay, (float) params->ReverbDelay + channel_delay[c]);
 
-		for (i = 0; i < REVERB_COUNT_COMB; ++i)
-		{
-			/* set decay time of comb filter */
-			DspComb_Change(
-				&reverb->channel[c].lpf_comb[i].comb, 
-				COMB_DELAYS[i] + STEREO_SPREAD[c], 
-				params->DecayTime * 1000.0f);
-
-			/* high/low shelving */
-			DspBiQuad_Change(
-				&reverb->channel[c].lpf_comb[i].low_shelving,
-				50.0f + params->LowEQCutoff * 50.0f,
-				0.0f,
-				params->LowEQGain - 8.0f
-			);
-			DspBiQuad_Change(
-				&reverb->channel[c].lpf_comb[i].high_shelving,
-				1000 + params->HighEQCutoff * 500.0f,
-				0.0f,
-				params->HighEQGain - 8.0f
-			);
-		}
+		/* set decay time of comb filters */
+		DspReverb_INTERNAL_CombDelays(c, comb_delays);
+		DspCombBank_Change(
+			&reverb->channel[c].lpf_comb,
+			reverb->sampleRate,
+			comb_delays,
+			params->DecayTime * 1000.0f
+		);
+
+		/* high/low shelving */
+		DspCombBank_SetShelving(
+			&reverb->channel[c].lpf_comb.low_shelving,
+			reverb->sampleRate,
+			DSP_BIQUAD_LOWSHELVING,
+			50.0f + params->LowEQCutoff * 50.0f,
+			params->LowEQGain - 8.0f
+		);
+		DspCombBank_SetShelving(
+			&reverb->channel[c].lpf_comb.high_shelving,
+			reverb->sampleRate,
+			DSP_BIQUAD_HIGHSHELVING,
+			1000 + params->HighEQCutoff * 500.0f,
+			params->HighEQGain - 8.0f
+		);
 	}
 
 	/* gain */
@@ -797,59 +902,99 @@ void DspReverb_SetParameters(DspReverb *reverb, FAudioFXReverbParameters *params
 	reverb->dry_ratio = 1.0f - reverb->wet_ratio;
 }
 
-static inline float DspReverb_INTERNAL_ProcessEarly(DspReverb *reverb, float sample_in)
-{
-	float delay_in, early;
+/* Frames processed by each stage before the next one runs */
+#define REVERB_BLOCK_SIZE 256
+
+static inline void DspReverb_INTERNAL_ProcessEarly(
+	DspReverb *reverb,
+	const float *samples_in,
+	float *samples_out,
+	size_t sample_count
+) {
 	int32_t i;
 
 	/* pre delay */
-	delay_in = DspDelay_Process(&reverb->early_delay, sample_in);
+	DspDelay_Process(&reverb->early_delay, samples_in, samples_out, sample_count);
 
 	/* early reflections */
-	early = delay_in;
-
 	for (i = 0; i < REVERB_COUNT_APF_IN; ++i)
 	{
-		early = DspAllPass_Process(&reverb->apf_in[i], early);
+		DspAllPass_Process(&reverb->apf_in[i], samples_out, samples_out, sample_count);
 	}
-
-	return early;
 }
 
-static inline float DspReverb_INTERNAL_ProcessChannel(DspReverb *reverb, DspReverbChannel *channel, float sample_in)
-{
-	float revdelay, comb_out, comb_gain;
-	float late, early_late, out;
+static inline void DspReverb_INTERNAL_ProcessChannel(
+	DspReverb *reverb,
+	DspReverbChannel *channel,
+	const float *samples_in,
+	float *samples_out,
+	size_t sample_count
+) {
+	float revdelay[REVERB_BLOCK_SIZE];
+	size_t s;
 	int32_t i;
 
-	revdelay = DspDelay_Process(&channel->reverb_delay, sample_in);
+	FAudio_assert(sample_count <= REVERB_BLOCK_SIZE);
 
-	comb_out = 0.0f;
-	comb_gain = 1.0f / REVERB_COUNT_COMB;
+	DspDelay_Process(&channel->reverb_delay, samples_in, revdelay, sample_count);
 
-	for (i = 0; i < REVERB_COUNT_COMB; ++i)
-	{
-		comb_out += comb_gain * DspCombShelving_Process(&channel->lpf_comb[i], revdelay);
-	}
+	/* all the combs at once, their mean goes straight to the output */
+	FAudio_INTERNAL_ProcessCombBank(
+		&channel->lpf_comb,
+		revdelay,
+		samples_out,
+		(uint32_t) sample_count
+	);
 
 	/* output diffusion */
-	late = comb_out;
 	for (i = 0; i < REVERB_COUNT_APF_OUT; ++i)
 	{
-		late = DspAllPass_Process(&channel->apf_out[i], late);
+		DspAllPass_Process(&channel->apf_out[i], samples_out, samples_out, sample_count);
 	}
 
 	/* combine early reflections and reverberation */
-	early_late = (channel->early_gain * sample_in) + (reverb->reverb_gain * late);
+	for (s = 0; s < sample_count; ++s)
+	{
+		samples_out[s] = (
+			(channel->early_gain * samples_in[s]) +
+			(reverb->reverb_gain * samples_out[s])
+		) * reverb->room_gain;
+	}
 
 	/* room filter */
-	out = early_late * reverb->room_gain;
-	out = DspBiQuad_Process(&channel->room_high_shelf, out);
+	DspBiQuad_Process(&channel->room_high_shelf, samples_out, samples_out, sample_count);
 
 	/* PositionMatrixLeft/Rigth */
-	out = out * channel->gain;
+	for (s = 0; s < sample_count; ++s)
+	{
+		samples_out[s] *= channel->gain;
+	}
+}
 
-	return out;
+/* Runs a block of mono input through the early reflections, then each of the
+ * reverb channels in turn.
+ */
+static inline void DspReverb_INTERNAL_ProcessBlock(
+	DspReverb *reverb,
+	const float *samples_in,
+	float late[4][REVERB_BLOCK_SIZE],
+	size_t sample_count
+) {
+	float early[REVERB_BLOCK_SIZE];
+	int32_t c;
+
+	DspReverb_INTERNAL_ProcessEarly(reverb, samples_in, early, sample_count);
+
+	for (c = 0; c < reverb->reverb_channels; ++c)
+	{
+		DspReverb_INTERNAL_ProcessChannel(
+			reverb,
+			&reverb->channel[c],
+			early,
+			late[c],
+			sample_count
+		);
+	}
 }
 
 #define OUTPUT_SAMPLE(x)	\
@@ -861,130 +1006,256 @@ static inline float DspReverb_INTERNAL_Process_1_to_1(DspReverb *reverb, const f
 {
 	float *out_ptr = samples_out;
 	const float *in_ptr = samples_in;
-	const float *in_end = samples_in + sample_count;
 	float squared_sum = 0;
+	float late[4][REVERB_BLOCK_SIZE];
+	size_t s, block;
 
-	while (in_ptr < in_end)
+	while (sample_count > 0)
 	{
-		float early, late, out;
+		block = FAudio_min(sample_count, REVERB_BLOCK_SIZE);
+
+		/* early reflections and reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, in_ptr, late, block);
+
+		/* wet/dry mix -> output */
+		for (s = 0; s < block; ++s)
+		{
+			OUTPUT_SAMPLE((late[0][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));
+		}
+
+		in_ptr += block;
+		sample_count -= block;
+	}
+
+	return squared_sum;
+}
 
-		/* input */
-		float in = *in_ptr++;
+static inline float DspReverb_INTERNAL_Process_1_to_5p1(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
+{
+	float *out_ptr = samples_out;
+	const float *in_ptr = samples_in;
+	float squared_sum = 0;
+	float late[4][REVERB_BLOCK_SIZE];
+	size_t s, block;
 
-		/* early reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+	while (sample_count > 0)
+	{
+		block = FAudio_min(sample_count, REVERB_BLOCK_SIZE);
 
-		/* reverberation */
-		late = DspReverb_INTERNAL_ProcessChannel(reverb, &reverb->channel[0], early);
+		/* early reflections and reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, in_ptr, late, block);
 
-		/* wet/dry mix */
-		out = (late * reverb->wet_ratio) + (in * reverb->dry_ratio);
+		/* wet/dry mix -> output */
+		for (s = 0; s < block; ++s)
+		{
+			OUTPUT_SAMPLE((late[0][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* front-left */
+			OUTPUT_SAMPLE((late[1][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* front-right */
+			OUTPUT_SAMPLE(0.0f);															/* center */
+			OUTPUT_SAMPLE(0.0f);															/* lfe */
+			OUTPUT_SAMPLE((late[2][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* rear-left */
+			OUTPUT_SAMPLE((late[3][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* rear-right */
+		}
 
-		/* output */
-		OUTPUT_SAMPLE(out);
+		in_ptr += block;
+		sample_count -= block;
 	}
 
 	return squared_sum;
 }
 
-static inline float DspReverb_INTERNAL_Process_1_to_5p1(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
+static inline float DspReverb_INTERNAL_Process_2_to_2(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
 {
 	float *out_ptr = samples_out;
 	const float *in_ptr = samples_in;
-	const float *in_end = samples_in + sample_count;
 	float squared_sum = 0;
-	int32_t c;
+	float in[REVERB_BLOCK_SIZE];
+	float late[4][REVERB_BLOCK_SIZE];
+	size_t s, block;
 
-	while (in_ptr < in_end)
+	sample_count /= 2;
+	while (sample_count > 0)
 	{
-		float early, late[4];
+		block = FAudio_min(sample_count, REVERB_BLOCK_SIZE);
 
-		/* input */
-		float in = *in_ptr++;
+		/* input - combine 2 channel in 1 */
+		for (s = 0; s < block; ++s)
+		{
+			in[s] = 0.5f * (in_ptr[0] + in_ptr[1]);
+			in_ptr += 2;
+		}
 
-		/* early reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+		/* early reflections and reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, in, late, block);
 
-		/* reverberation */
-		for (c = 0; c < 4; ++c)
+		/* wet/dry mix -> output */
+		for (s = 0; s < block; ++s)
 		{
-			late[c] = DspReverb_INTERNAL_ProcessChannel(reverb, &reverb->channel[c], early);
+			OUTPUT_SAMPLE((late[0][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));
+			OUTPUT_SAMPLE((late[1][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));
 		}
 
+		sample_count -= block;
+	}
+
+	return squared_sum;
+}
+
+static inline float DspReverb_INTERNAL_Process_2_to_5p1(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
+{
+	float *out_ptr = samples_out;
+	const float *in_ptr = samples_in;
+	float squared_sum = 0;
+	float in[REVERB_BLOCK_SIZE];
+	float late[4][REVERB_BLOCK_SIZE];
+	size_t s, block;
+
+	sample_count /= 2;
+	while (sample_count > 0)
+	{
+		block = FAudio_min(sample_count, REVERB_BLOCK_SIZE);
+
+		/* input - combine 2 channel in 1 */
+		for (s = 0; s < block; ++s)
+		{
+			in[s] = 0.5f * (in_ptr[0] + in_ptr[1]);
+			in_ptr += 2;
+		}
+
+		/* early reflections and reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, in, late, block);
+
 		/* wet/dry mix -> output */
-		OUTPUT_SAMPLE((late[0] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* front-left */
-		OUTPUT_SAMPLE((late[1] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* front-right */
-		OUTPUT_SAMPLE(0.0f);															/* center */
-		OUTPUT_SAMPLE(0.0f);															/* lfe */
-		OUTPUT_SAMPLE((late[2] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* rear-left */
-		OUTPUT_SAMPLE((late[3] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* rear-right */
+		for (s = 0; s < block; ++s)
+		{
+			OUTPUT_SAMPLE((late[0][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* front-left */
+			OUTPUT_SAMPLE((late[1][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* front-right */
+			OUTPUT_SAMPLE(0.0f);															/* center */
+			OUTPUT_SAMPLE(0.0f);															/* lfe */
+			OUTPUT_SAMPLE((late[2][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* rear-left */
+			OUTPUT_SAMPLE((late[3][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* rear-right */
+		}
+
+		sample_count -= block;
 	}
 
 	return squared_sum;
 }
 
-static inline float DspReverb_INTERNAL_Process_2_to_2(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
+static inline float DspReverb_INTERNAL_Process_2_to_4(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
 {
 	float *out_ptr = samples_out;
 	const float *in_ptr = samples_in;
-	const float *in_end = samples_in + sample_count;
 	float squared_sum = 0;
+	float in[REVERB_BLOCK_SIZE];
+	float late[4][REVERB_BLOCK_SIZE];
+	size_t s, block;
 
-	while (in_ptr < in_end)
+	sample_count /= 2;
+	while (sample_count > 0)
 	{
-		float early, late[2];
+		block = FAudio_min(sample_count, REVERB_BLOCK_SIZE);
 
 		/* input - combine 2 channel in 1 */
-		float in = *in_ptr++;
-		in = 0.5f * (in + *in_ptr++);
+		for (s = 0; s < block; ++s)
+		{
+			in[s] = 0.5f * (in_ptr[0] + in_ptr[1]);
+			in_ptr += 2;
+		}
+
+		/* early reflections and reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, in, late, block);
+
+		/* wet/dry mix -> output */
+		for (s = 0; s < block; ++s)
+		{
+			OUTPUT_SAMPLE((late[0][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* front-left */
+			OUTPUT_SAMPLE((late[1][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* front-right */
+			OUTPUT_SAMPLE((late[2][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* rear-left */
+			OUTPUT_SAMPLE((late[3][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* rear-right */
+		}
+
+		sample_count -= block;
+	}
+
+	return squared_sum;
+}
+
+/* 7.1 has no networks of its own for the sides, each side gets the mean of
+ * the front and rear reverberation next to it.
+ */
+static inline float DspReverb_INTERNAL_Process_1_to_7p1(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
+{
+	float *out_ptr = samples_out;
+	const float *in_ptr = samples_in;
+	float squared_sum = 0;
+	float late[4][REVERB_BLOCK_SIZE];
+	size_t s, block;
 
-		/* early reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+	while (sample_count > 0)
+	{
+		block = FAudio_min(sample_count, REVERB_BLOCK_SIZE);
 
-		/* reverberation */
-		late[0] = DspReverb_INTERNAL_ProcessChannel(reverb, &reverb->channel[0], early);
-		late[1] = DspReverb_INTERNAL_ProcessChannel(reverb, &reverb->channel[1], early);
+		/* early reflections and reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, in_ptr, late, block);
 
 		/* wet/dry mix -> output */
-		OUTPUT_SAMPLE((late[0] * reverb->wet_ratio) + (in * reverb->dry_ratio));
-		OUTPUT_SAMPLE((late[1] * reverb->wet_ratio) + (in * reverb->dry_ratio));
+		for (s = 0; s < block; ++s)
+		{
+			OUTPUT_SAMPLE((late[0][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* front-left */
+			OUTPUT_SAMPLE((late[1][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* front-right */
+			OUTPUT_SAMPLE(0.0f);															/* center */
+			OUTPUT_SAMPLE(0.0f);															/* lfe */
+			OUTPUT_SAMPLE((late[2][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* rear-left */
+			OUTPUT_SAMPLE((late[3][s] * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));		/* rear-right */
+			OUTPUT_SAMPLE((0.5f * (late[0][s] + late[2][s]) * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));	/* side-left */
+			OUTPUT_SAMPLE((0.5f * (late[1][s] + late[3][s]) * reverb->wet_ratio) + (in_ptr[s] * reverb->dry_ratio));	/* side-right */
+		}
+
+		in_ptr += block;
+		sample_count -= block;
 	}
 
 	return squared_sum;
 }
 
-static inline float DspReverb_INTERNAL_Process_2_to_5p1(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
+static inline float DspReverb_INTERNAL_Process_2_to_7p1(DspReverb *reverb, const float *samples_in, float *samples_out, size_t sample_count)
 {
 	float *out_ptr = samples_out;
 	const float *in_ptr = samples_in;
-	const float *in_end = samples_in + sample_count;
 	float squared_sum = 0;
-	int32_t c;
+	float in[REVERB_BLOCK_SIZE];
+	float late[4][REVERB_BLOCK_SIZE];
+	size_t s, block;
 
-	while (in_ptr < in_end)
+	sample_count /= 2;
+	while (sample_count > 0)
 	{
-		float early, late[4];
+		block = FAudio_min(sample_count, REVERB_BLOCK_SIZE);
 
 		/* input - combine 2 channel in 1 */
-		float in = *in_ptr++;
-		in = 0.5f * (in + *in_ptr++);
+		for (s = 0; s < block; ++s)
+		{
+			in[s] = 0.5f * (in_ptr[0] + in_ptr[1]);
+			in_ptr += 2;
+		}
 
-		/* early reflections */
-		early = DspReverb_INTERNAL_ProcessEarly(reverb, in);
+		/* early reflections and reverberation */
+		DspReverb_INTERNAL_ProcessBlock(reverb, in, late, block);
 
-		/* reverberation */
-		for (c = 0; c < 4; ++c)
+		/* wet/dry mix -> output */
+		for (s = 0; s < block; ++s)
 		{
-			late[c] = DspReverb_INTERNAL_ProcessChannel(reverb, &reverb->channel[c], early);
+			OUTPUT_SAMPLE((late[0][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* front-left */
+			OUTPUT_SAMPLE((late[1][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* front-right */
+			OUTPUT_SAMPLE(0.0f);															/* center */
+			OUTPUT_SAMPLE(0.0f);															/* lfe */
+			OUTPUT_SAMPLE((late[2][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* rear-left */
+			OUTPUT_SAMPLE((late[3][s] * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));		/* rear-right */
+			OUTPUT_SAMPLE((0.5f * (late[0][s] + late[2][s]) * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));	/* side-left */
+			OUTPUT_SAMPLE((0.5f * (late[1][s] + late[3][s]) * reverb->wet_ratio) + (in[s] * reverb->dry_ratio));	/* side-right */
 		}
 
-		/* wet/dry mix -> output */
-		OUTPUT_SAMPLE((late[0] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* front-left */
-		OUTPUT_SAMPLE((late[1] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* front-right */
-		OUTPUT_SAMPLE(0.0f);															/* center */
-		OUTPUT_SAMPLE(0.0f);															/* lfe */
-		OUTPUT_SAMPLE((late[2] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* rear-left */
-		OUTPUT_SAMPLE((late[3] * reverb->wet_ratio) + (in * reverb->dry_ratio));		/* rear-right */
+		sample_count -= block;
 	}
 
 	return squared_sum;
@@ -1009,6 +1280,17 @@ float DspReverb_Process(
 			return DspReverb_INTERNAL_Process_1_to_1(reverb, samples_in, samples_out, sample_count);
 		case 2:
 			return DspReverb_INTERNAL_Process_2_to_2(reverb, samples_in, samples_out, sample_count);
+		case 4:
+			return DspReverb_INTERNAL_Process_2_to_4(reverb, samples_in, samples_out, sample_count);
+		case 8:
+			if (reverb->in_channels == 1)
+			{
+				return DspReverb_INTERNAL_Process_1_to_7p1(reverb, samples_in, samples_out, sample_count);
+			}
+			else
+			{
+				return DspReverb_INTERNAL_Process_2_to_7p1(reverb, samples_in, samples_out, sample_count);
+			}
 		default:	/* 5.1 */
 			if (reverb->in_channels == 1)
 			{
@@ -1036,10 +1318,7 @@ void DspReverb_Reset(DspReverb *reverb)
 	{
 		DspDelay_Reset(&reverb->channel[c].reverb_delay);
 
-		for (i = 0; i < REVERB_COUNT_COMB; ++i)
-		{
-			DspCombShelving_Reset(&reverb->channel[c].lpf_comb[i]);
-		}
+		DspCombBank_Reset(&reverb->channel[c].lpf_comb);
 
 		DspBiQuad_Reset(&reverb->channel[c].room_high_shelf);
 
@@ -1052,38 +1331,7 @@ void DspReverb_Reset(DspReverb *reverb)
 
 void DspReverb_Destroy(DspReverb *reverb, FAudioFreeFunc pFree)
 {
-	int32_t i, c;
-
-	DspDelay_Destroy(&reverb->early_delay, pFree);
-
-	for (i = 0; i < REVERB_COUNT_APF_IN; ++i)
-	{
-		DspAllPass_Destroy(&reverb->apf_in[i], pFree);
-	}
-
-	for (c = 0; c < reverb->reverb_channels; ++c)
-	{
-		DspDelay_Destroy(&reverb->channel[c].reverb_delay, pFree);
-
-		for (i = 0; i < REVERB_COUNT_COMB; ++i)
-		{
-			DspCombShelving_Destroy(
-				&reverb->channel[c].lpf_comb[i],
-				pFree
-			);
-		}
-
-		DspBiQuad_Destroy(&reverb->channel[c].room_high_shelf);
-
-		for (i = 0; i < REVERB_COUNT_APF_OUT; ++i)
-		{
-			DspAllPass_Destroy(
-				&reverb->channel[c].apf_out[i],
-				pFree
-			);
-		}
-	}
-
+	/* the delay lines all live in the same block */
 	pFree(reverb);
 }
 
@@ -1142,6 +1390,7 @@ typedef struct FAudioFXReverb
 	uint16_t outBlockAlign;
 
 	DspReverb *reverb;
+	FAudioEffectTail tail;
 } FAudioFXReverb;
 
 static inline int8_t IsFloatFormat(const FAudioWaveFormatEx *format)
@@ -1203,7 +1452,14 @@ uint32_t FAudioFXReverb_IsInputFormatSupported(
 			SET_SUPPORTED_FIELD(nChannels, pOutputFormat->nChannels);
 		}
 	}
-	else if (pOutputFormat->nChannels == 6)
+	else if (pOutputFormat->nChannels == 4)
+	{
+		if (pRequestedInputFormat->nChannels != 2)
+		{
+			SET_SUPPORTED_FIELD(nChannels, 2);
+		}
+	}
+	else if (pOutputFormat->nChannels == 6 || pOutputFormat->nChannels == 8)
 	{
 		if (pRequestedInputFormat->nChannels != 1 && pRequestedInputFormat->nChannels != 2)
 		{
@@ -1252,7 +1508,9 @@ uint32_t FAudioFXReverb_IsOutputFormatSupported(
 	if (pInputFormat->nChannels == 1 || pInputFormat->nChannels == 2)
 	{
 		if (pRequestedOutputFormat->nChannels != pInputFormat->nChannels &&
-			pRequestedOutputFormat->nChannels != 6)
+			pRequestedOutputFormat->nChannels != 6 &&
+			pRequestedOutputFormat->nChannels != 8 &&
+			!(pInputFormat->nChannels == 2 && pRequestedOutputFormat->nChannels == 4))
 		{
 			SET_SUPPORTED_FIELD(nChannels, pInputFormat->nChannels);
 		}
@@ -1306,10 +1564,13 @@ uint32_t FAudioFXReverb_LockForProcess(
 
 	if (!((pInputLockedParameters->pFormat->nChannels == 1 &&
 			(pOutputLockedParameters->pFormat->nChannels == 1 ||
-			 pOutputLockedParameters->pFormat->nChannels == 6)) ||
+			 pOutputLockedParameters->pFormat->nChannels == 6 ||
+			 pOutputLockedParameters->pFormat->nChannels == 8)) ||
 		  (pInputLockedParameters->pFormat->nChannels == 2 &&
 			(pOutputLockedParameters->pFormat->nChannels == 2 ||
-			 pOutputLockedParameters->pFormat->nChannels == 6))))
+			 pOutputLockedParameters->pFormat->nChannels == 4 ||
+			 pOutputLockedParameters->pFormat->nChannels == 6 ||
+			 pOutputLockedParameters->pFormat->nChannels == 8))))
 	{
 		return FAPO_E_FORMAT_UNSUPPORTED;
 	}
@@ -1357,10 +1618,10 @@ static inline void FAudioFXReverb_CopyBuffer(FAudioFXReverb *fapo, const float *
 		return;
 	}
 
-	/* 1 -> 5.1 */
+	/* 1 -> 5.1/7.1, to the front speakers */
 	FAudio_zero(buffer_out, fapo->outBlockAlign * frames_in);
 
-	if (fapo->inChannels == 1 && fapo->outChannels == 6)
+	if (fapo->inChannels == 1 && fapo->outChannels > 2)
 	{
 		const float *in_end = buffer_in + frames_in;
 		const float *in_ptr = buffer_in;
@@ -1370,13 +1631,13 @@ static inline void FAudioFXReverb_CopyBuffer(FAudioFXReverb *fapo, const float *
 		{
 			*out_ptr++ = *in_ptr;
 			*out_ptr++ = *in_ptr++;
-			out_ptr += 4;
+			out_ptr += fapo->outChannels - 2;
 		}
 		return;
 	}
 
-	/* 2 -> 5.1 */
-	if (fapo->inChannels == 2 && fapo->outChannels == 6)
+	/* 2 -> quad/5.1/7.1, to the front speakers */
+	if (fapo->inChannels == 2 && fapo->outChannels > 2)
 	{
 		const float *in_end = buffer_in + (frames_in * 2);
 		const float *in_ptr = buffer_in;
@@ -1386,7 +1647,7 @@ static inline void FAudioFXReverb_CopyBuffer(FAudioFXReverb *fapo, const float *
 		{
 			*out_ptr++ = *in_ptr++;
 			*out_ptr++ = *in_ptr++;
-			out_ptr += 4;
+			out_ptr += fapo->outChannels - 2;
 		}
 		return;
 	}
@@ -1394,6 +1655,24 @@ static inline void FAudioFXReverb_CopyBuffer(FAudioFXReverb *fapo, const float *
 	FAudio_assert(0 && "Unsupported channel combination");
 }
 
+/* How long the network keeps ringing after its input stops */
+static inline uint32_t FAudioFXReverb_TailFrames(
+	FAudioFXReverb *fapo,
+	const FAudioFXReverbParameters *params
+) {
+	float frames = (
+		params->DecayTime +
+		(	params->ReflectionsDelay +
+			params->ReverbDelay +
+			params->RearDelay	) / 1000.0f
+	) * fapo->sampleRate;
+	if (frames >= 4294967040.0f)
+	{
+		return 0xFFFFFFFF;
+	}
+	return (uint32_t) frames;
+}
+
 void FAudioFXReverb_Process(
 	FAudioFXReverb *fapo,
 	uint32_t InputProcessParameterCount,
@@ -1424,6 +1703,29 @@ void FAudioFXReverb_Process(
 		return;
 	}
 	
+	params = (FAudioFXReverbParameters*) FAPOBase_BeginProcess(&fapo->base);
+
+	/* update parameters  */
+	if (update_params)
+	{
+		DspReverb_SetParameters(fapo->reverb, params);
+	}
+
+	/* the tail has died out, nothing to do until there is input again */
+	if (FAudio_INTERNAL_EffectTailIdle(
+		&fapo->tail,
+		pInputProcessParameters->BufferFlags,
+		pInputProcessParameters->ValidFrameCount
+	)) {
+		FAudio_zero(
+			pOutputProcessParameters->pBuffer,
+			pInputProcessParameters->ValidFrameCount * fapo->outBlockAlign
+		);
+		pOutputProcessParameters->BufferFlags = FAPO_BUFFER_SILENT;
+		FAPOBase_EndProcess(&fapo->base);
+		return;
+	}
+
 	/* XAudio2 passes a 'silent' buffer when no input buffer is available to play the effect tail */
 	if (pInputProcessParameters->BufferFlags == FAPO_BUFFER_SILENT)
 	{
@@ -1434,14 +1736,6 @@ void FAudioFXReverb_Process(
 		);
 	}
 
-	params = (FAudioFXReverbParameters*) FAPOBase_BeginProcess(&fapo->base);
-
-	/* update parameters  */
-	if (update_params)
-	{
-		DspReverb_SetParameters(fapo->reverb, params);
-	}
-
 	/* run reverb effect */
 	total = DspReverb_Process(
 		fapo->reverb,
@@ -1452,7 +1746,16 @@ void FAudioFXReverb_Process(
 	);
 
 	/* set BufferFlags to silent so PLAY_TAILS knows when to stop */
-	pOutputProcessParameters->BufferFlags = (total < 0.0000001f) ? FAPO_BUFFER_SILENT : FAPO_BUFFER_VALID;
+	pOutputProcessParameters->BufferFlags = (total < FAUDIO_EFFECT_TAIL_SILENCE) ? FAPO_BUFFER_SILENT : FAPO_BUFFER_VALID;
+
+	/* go idle with a clean network, so waking up is like starting over */
+	if (FAudio_INTERNAL_EffectTailEnded(
+		&fapo->tail,
+		FAudioFXReverb_TailFrames(fapo, params),
+		total
+	)) {
+		DspReverb_Reset(fapo->reverb);
+	}
 
 	FAPOBase_EndProcess(&fapo->base);
 }
@@ -1463,6 +1766,8 @@ void FAudioFXReverb_Reset(FAudioFXReverb *fapo)
 
 	/* reset the cached state of the reverb filter */
 	DspReverb_Reset(fapo->reverb);
+	fapo->tail.silentFrames = 0;
+	fapo->tail.idle = 1;
 }
 
 void FAudioFXReverb_Free(void* fapo)
@@ -1556,6 +1861,8 @@ uint32_t FAudioCreateReverbWithCustomAllocatorEXT(
 	result->outChannels = 0;
 	result->sampleRate = 0;
 	result->reverb = NULL;
+	result->tail.silentFrames = 0;
+	result->tail.idle = 1;
 
 	/* Function table... */
 	#define ASSIGN_VT(name) \
@@ -78,6 +78,10 @@ typedef struct FAudioFXVolumeMeter
 {
 	FAPOBase base;
 	uint16_t channels;
+
+	/* See FAudioSetVolumeMeterDecimationEXT */
+	uint32_t passes;
+	uint32_t skipped;
 } FAudioFXVolumeMeter;
 
 uint32_t FAudioFXVolumeMeter_LockForProcess(
@@ -149,31 +153,38 @@ void FAudioFXVolumeMeter_Process(
 	FAPOProcessBufferParameters* pOutputProcessParameters,
 	int32_t IsEnabled
 ) {
-	float peak;
-	float total;
-	float *buffer;
-	uint32_t i, j;
-	FAudioFXVolumeMeterLevels *levels = (FAudioFXVolumeMeterLevels*)
-		FAPOBase_BeginProcess(&fapo->base);
+	uint32_t i;
+	FAudioFXVolumeMeterLevels *levels;
+
+	/* Skipped passes leave the levels of the last metered one. They don't
+	 * touch the parameter blocks at all, so nothing gets published.
+	 */
+	if (fapo->skipped + 1 < fapo->passes || fapo->passes == 0)
+	{
+		fapo->skipped += 1;
+		return;
+	}
+	fapo->skipped = 0;
+
+	if (pInputProcessParameters->ValidFrameCount == 0)
+	{
+		return;
+	}
+
+	levels = (FAudioFXVolumeMeterLevels*) FAPOBase_BeginProcess(&fapo->base);
 
-	/* TODO: This could probably be SIMD-ified... */
+	/* Every channel in one pass, the sums go to the RMS array for now */
+	FAudio_INTERNAL_ChannelLevels(
+		(const float*) pInputProcessParameters->pBuffer,
+		levels->pPeakLevels,
+		levels->pRMSLevels,
+		pInputProcessParameters->ValidFrameCount,
+		fapo->channels
+	);
 	for (i = 0; i < fapo->channels; i += 1)
 	{
-		peak = 0.0f;
-		total = 0.0f;
-		buffer = ((float*) pInputProcessParameters->pBuffer) + i;
-		for (j = 0; j < pInputProcessParameters->ValidFrameCount; j += 1, buffer += fapo->channels)
-		{
-			const float sampleAbs = FAudio_fabsf(*buffer);
-			if (sampleAbs > peak)
-			{
-				peak = sampleAbs;
-			}
-			total += (*buffer) * (*buffer);
-		}
-		levels->pPeakLevels[i] = peak;
 		levels->pRMSLevels[i] = FAudio_sqrtf(
-			total / pInputProcessParameters->ValidFrameCount
+			levels->pRMSLevels[i] / pInputProcessParameters->ValidFrameCount
 		);
 	}
 
@@ -185,20 +196,20 @@ void FAudioFXVolumeMeter_GetParameters(
 	FAudioFXVolumeMeterLevels *pParameters,
 	uint32_t ParameterByteSize
 ) {
-	FAudioFXVolumeMeterLevels *levels = (FAudioFXVolumeMeterLevels*)
-		fapo->base.m_pCurrentParameters;
+	FAudioFXVolumeMeterLevels levels;
 	FAudio_assert(ParameterByteSize == sizeof(FAudioFXVolumeMeterLevels));
 	FAudio_assert(pParameters->ChannelCount == fapo->channels);
 
-	/* Copy what's current as of the last Process */
+	/* Take the latest levels, then copy the arrays that block points to */
+	FAPOBase_GetParameters(&fapo->base, &levels, sizeof(levels));
 	FAudio_memcpy(
 		pParameters->pPeakLevels,
-		levels->pPeakLevels,
+		levels.pPeakLevels,
 		fapo->channels * sizeof(float)
 	);
 	FAudio_memcpy(
 		pParameters->pRMSLevels,
-		levels->pRMSLevels,
+		levels.pRMSLevels,
 		fapo->channels * sizeof(float)
 	);
 }
@@ -240,6 +251,9 @@ uint32_t FAudioCreateVolumeMeterWithCustomAllocatorEXT(
 	FAudio_zero(params, sizeof(FAudioFXVolumeMeterLevels) * 3);
 
 	/* Initialize... */
+	result->channels = 0;
+	result->passes = 1;
+	result->skipped = 0;
 	FAudio_memcpy(
 		&VolumeMeterProperties.clsid,
 		&FAudioFX_CLSID_AudioVolumeMeter,
@@ -272,4 +286,26 @@ uint32_t FAudioCreateVolumeMeterWithCustomAllocatorEXT(
 	return 0;
 }
 
+uint32_t FAudioSetVolumeMeterDecimationEXT(FAPO* pApo, uint32_t Passes)
+{
+	FAudioFXVolumeMeter *fapo = (FAudioFXVolumeMeter*) pApo;
+	if (fapo->base.m_pRegistrationProperties != &VolumeMeterProperties)
+	{
+		return FAUDIO_E_INVALID_CALL;
+	}
+	fapo->passes = Passes;
+
+	/* Meter the next pass, so the levels don't wait out the old period */
+	fapo->skipped = Passes;
+	return 0;
+}
+
+/* Internal API */
+
+uint8_t FAudioFX_INTERNAL_IsVolumeMeter(FAPO *fapo)
+{
+	/* Not every FAPO is an FAPOBase, so don't look past the table */
+	return fapo->Process == (ProcessFunc) FAudioFXVolumeMeter_Process;
+}
+
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
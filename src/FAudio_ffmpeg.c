@@ -35,8 +35,16 @@ extern "C" {
 }
 #endif /* __cplusplus */
 
+typedef struct FAudioFFmpegFrame
+{
+	float *cache;
+	uint32_t capacity;
+	uint32_t samples;
+} FAudioFFmpegFrame;
+
 typedef struct FAudioFFmpeg
 {
+	FAudioFFmpegDecoder *decoder;
 	AVCodecContext *av_ctx;
 	AVFrame *av_frame;
 
@@ -52,26 +60,177 @@ typedef struct FAudioFFmpeg
 	uint32_t convertSamples;
 	uint32_t convertOffset;
 	float *convertCache;
+
+	/* The frames from the one holding LoopBegin to the end of its packet,
+	 * kept from the first time we seeked there, so every loop after that
+	 * restarts without searching and converting. loopPacketOffset is where
+	 * their packet starts, loopEncOffset is the packet after them.
+	 */
+	const FAudioBuffer *loopBuffer;
+	uint32_t loopStart;
+	uint32_t loopPacketOffset;
+	uint32_t loopEncOffset;
+	uint32_t loopCapacity;
+	uint32_t loopSamples;
+	float *loopCache;
+
+	/* FAUDIO_VOICE_PREDECODE_EXT voices only, the frames that follow
+	 * convertCache, decoded from aheadBuffer by the predecode thread.
+	 * aheadBuffer is a copy, nothing is read from it but the data and
+	 * the flags. The lock owns the decoder and aheadBuffer. The ring is written by
+	 * the thread and read by the mixer, aheadCount is what keeps them
+	 * apart, but only the mixer empties it and only with the lock held.
+	 */
+	FAudioSourceVoice *voice;
+	FAudioMutex lock;
+	FAudioBuffer aheadBuffer;
+	uint8_t aheadDone;
+	uint32_t aheadFrames;
+	uint32_t aheadRead;
+	uint32_t aheadWrite;
+	volatile int32_t aheadCount;
+	volatile int32_t aheadWanted;
+	FAudioFFmpegFrame ahead[FAUDIO_MAX_DECODE_AHEAD_EXT];
+	struct FAudioFFmpeg *next;
 } FAudioFFmpeg;
 
-void FAudio_FFMPEG_reset(FAudioSourceVoice *voice)
+static void FAudio_INTERNAL_DropAhead(FAudioFFmpeg *ffmpeg)
 {
+	/* Only called with the lock held, so the thread isn't writing */
+	ffmpeg->aheadRead = 0;
+	ffmpeg->aheadWrite = 0;
+	ffmpeg->aheadDone = 0;
+	FAudio_PlatformAtomicAdd(
+		&ffmpeg->aheadCount,
+		-FAudio_PlatformAtomicGet(&ffmpeg->aheadCount)
+	);
+}
+
+static void FAudio_INTERNAL_WantAhead(FAudio *audio, FAudioFFmpeg *ffmpeg)
+{
+	if (FAudio_PlatformAtomicCompareExchange(&ffmpeg->aheadWanted, 0, 1))
+	{
+		FAudio_INTERNAL_WakePredecoder(audio);
+	}
+}
+
+void FAudio_FFMPEG_reset(FAudioSourceVoice *voice, const FAudioBuffer *next)
+{
+	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+
 	LOG_FUNC_ENTER(voice->audio)
-	voice->src.ffmpeg->encOffset = 0;
-	voice->src.ffmpeg->decOffset = 0;
+	ffmpeg->loopBuffer = NULL;
+	if (ffmpeg->aheadFrames == 0)
+	{
+		ffmpeg->encOffset = 0;
+		ffmpeg->decOffset = 0;
+		LOG_FUNC_EXIT(voice->audio)
+		return;
+	}
+
+	/* The thread may still be reading the old buffer, wait for it */
+	FAudio_PlatformLockMutex(ffmpeg->lock);
+	LOG_MUTEX_LOCK(voice->audio, ffmpeg->lock)
+	ffmpeg->encOffset = 0;
+	ffmpeg->decOffset = 0;
+	FAudio_INTERNAL_DropAhead(ffmpeg);
+
+	/* Get started on the next buffer, unless it has to seek first */
+	if (next != NULL && next->PlayBegin == 0)
+	{
+		ffmpeg->aheadBuffer = *next;
+	}
+	else
+	{
+		FAudio_zero(&ffmpeg->aheadBuffer, sizeof(FAudioBuffer));
+	}
+	FAudio_PlatformUnlockMutex(ffmpeg->lock);
+	LOG_MUTEX_UNLOCK(voice->audio, ffmpeg->lock)
+
+	if (ffmpeg->aheadBuffer.pAudioData != NULL)
+	{
+		FAudio_INTERNAL_WantAhead(voice->audio, ffmpeg);
+	}
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
+void FAudio_FFMPEG_flush(FAudioSourceVoice *voice)
+{
+	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+
+	LOG_FUNC_ENTER(voice->audio)
+	ffmpeg->loopBuffer = NULL;
+	if (ffmpeg->aheadFrames > 0)
+	{
+		/* The buffers are going back to the client */
+		FAudio_PlatformLockMutex(ffmpeg->lock);
+		LOG_MUTEX_LOCK(voice->audio, ffmpeg->lock)
+		FAudio_INTERNAL_DropAhead(ffmpeg);
+		FAudio_zero(&ffmpeg->aheadBuffer, sizeof(FAudioBuffer));
+		FAudio_PlatformUnlockMutex(ffmpeg->lock);
+		LOG_MUTEX_UNLOCK(voice->audio, ffmpeg->lock)
+	}
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+/* Everything a decoder is opened with, so an idle one can be given to any
+ * voice with the same format
+ */
+typedef struct FAudioFFmpegKey
 {
+	uint32_t type;
+	uint32_t sampleRate;
+	uint32_t avgBytesPerSec;
+	uint16_t channels;
+	uint16_t blockAlign;
+	uint16_t bitsPerSample;
+	uint16_t extradataSize;
+	uint8_t extradata[22];
+} FAudioFFmpegKey;
+
+struct FAudioFFmpegDecoder
+{
+	FAudioFFmpegKey key;
+	AVCodecContext *av_ctx;
+	AVFrame *av_frame;
+	struct FAudioFFmpegDecoder *next;
+};
+
+static void FAudio_INTERNAL_DecoderKey(
+	const FAudioWaveFormatEx *format,
+	uint32_t type,
+	FAudioFFmpegKey *key
+) {
+	FAudio_zero(key, sizeof(FAudioFFmpegKey));
+	key->type = type;
+	key->sampleRate = format->nSamplesPerSec;
+	key->avgBytesPerSec = format->nAvgBytesPerSec;
+	key->channels = format->nChannels;
+	key->blockAlign = format->nBlockAlign;
+	key->bitsPerSample = format->wBitsPerSample;
+	if (type == FAUDIO_FORMAT_WMAUDIO3)
+	{
+		/* WMAv3 is the only one that reads the format's extra bytes */
+		key->extradataSize = FAudio_min(format->cbSize, sizeof(key->extradata));
+		FAudio_memcpy(
+			key->extradata,
+			&((FAudioWaveFormatExtensible*) format)->Samples,
+			key->extradataSize
+		);
+	}
+}
+
+static uint32_t FAudio_INTERNAL_OpenDecoder(
+	FAudio *audio,
+	const FAudioWaveFormatEx *format,
+	uint32_t type,
+	FAudioFFmpegDecoder **decoder
+) {
 	AVCodecContext *av_ctx;
 	AVFrame *av_frame;
 	AVCodec *codec = NULL;
 	const char *typestring = "Unknown";
 
-	LOG_FUNC_ENTER(pSourceVoice->audio)
-	pSourceVoice->src.decode = FAudio_INTERNAL_DecodeFFMPEG;
-
 	/* initialize ffmpeg state */
 	if (type == FAUDIO_FORMAT_WMAUDIO2)
 	{
@@ -91,12 +250,11 @@ uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
 	if (!codec)
 	{
 		LOG_ERROR(
-			pSourceVoice->audio,
+			audio,
 			"%s codec not supported!",
 			typestring
 		);
 		FAudio_assert(0 && "FFmpeg codec not supported!");
-		LOG_FUNC_EXIT(pSourceVoice->audio)
 		return FAUDIO_E_UNSUPPORTED_FORMAT;
 	}
 
@@ -104,41 +262,40 @@ uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
 	if (!av_ctx)
 	{
 		LOG_ERROR(
-			pSourceVoice->audio,
+			audio,
 			"%s",
 			"WMAv2 codec not supported!"
 		);
 		FAudio_assert(0 && "WMAv2 codec not supported!");
-		LOG_FUNC_EXIT(pSourceVoice->audio)
 		return FAUDIO_E_UNSUPPORTED_FORMAT;
 	}
 
-	av_ctx->bit_rate = pSourceVoice->src.format->nAvgBytesPerSec * 8;
-	av_ctx->channels = pSourceVoice->src.format->nChannels;
-	av_ctx->sample_rate = pSourceVoice->src.format->nSamplesPerSec;
-	av_ctx->block_align = pSourceVoice->src.format->nBlockAlign;
-	av_ctx->bits_per_coded_sample = pSourceVoice->src.format->wBitsPerSample;
+	av_ctx->bit_rate = format->nAvgBytesPerSec * 8;
+	av_ctx->channels = format->nChannels;
+	av_ctx->sample_rate = format->nSamplesPerSec;
+	av_ctx->block_align = format->nBlockAlign;
+	av_ctx->bits_per_coded_sample = format->wBitsPerSample;
 	av_ctx->request_sample_fmt = AV_SAMPLE_FMT_FLT;
 
-	/* pSourceVoice->src.format is actually pointing to a
+	/* format is actually pointing to a
 	 * WAVEFORMATEXTENSIBLE struct, not just a WAVEFORMATEX struct.
 	 * That means there's always at least 22 bytes following the struct, I
 	 * assume the WMA data is behind that.
 	 * Need to verify but haven't come across any samples data with cbSize > 22
 	 * -@JohanSmet!
 	 */
-	FAudio_assert(pSourceVoice->src.format->cbSize <= 22);
+	FAudio_assert(format->cbSize <= 22);
 	if (type == FAUDIO_FORMAT_WMAUDIO3)
 	{
-		av_ctx->extradata_size = pSourceVoice->src.format->cbSize;
+		av_ctx->extradata_size = format->cbSize;
 		av_ctx->extradata = (uint8_t *) av_malloc(
-			pSourceVoice->src.format->cbSize +
+			format->cbSize +
 			AV_INPUT_BUFFER_PADDING_SIZE
 		);
 		FAudio_memcpy(
 			av_ctx->extradata,
-			&((FAudioWaveFormatExtensible*) pSourceVoice->src.format)->Samples,
-			pSourceVoice->src.format->cbSize
+			&((FAudioWaveFormatExtensible*) format)->Samples,
+			format->cbSize
 		);
 	}
 	else if (type == FAUDIO_FORMAT_WMAUDIO2)
@@ -160,7 +317,7 @@ uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
 		av_ctx->extradata = (uint8_t *) av_malloc(AV_INPUT_BUFFER_PADDING_SIZE);
 		FAudio_zero(av_ctx->extradata, AV_INPUT_BUFFER_PADDING_SIZE);
 		av_ctx->extradata[1] = 1;
-		av_ctx->extradata[5] = pSourceVoice->src.format->nChannels == 2 ? 3 : 0;
+		av_ctx->extradata[5] = format->nChannels == 2 ? 3 : 0;
 		av_ctx->extradata[31] = 4;
 		av_ctx->extradata[33] = 1;
 	}
@@ -169,8 +326,7 @@ uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
 	{
 		av_free(av_ctx->extradata);
 		av_free(av_ctx);
-		LOG_ERROR(pSourceVoice->audio, "%s", "avcodec_open2 failed!")
-		LOG_FUNC_EXIT(pSourceVoice->audio)
+		LOG_ERROR(audio, "%s", "avcodec_open2 failed!")
 		return FAUDIO_E_UNSUPPORTED_FORMAT;
 	}
 
@@ -180,8 +336,7 @@ uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
 		avcodec_close(av_ctx);
 		av_free(av_ctx->extradata);
 		av_free(av_ctx);
-		LOG_ERROR(pSourceVoice->audio, "%s", "avcodec_open2 failed!")
-		LOG_FUNC_EXIT(pSourceVoice->audio)
+		LOG_ERROR(audio, "%s", "avcodec_open2 failed!")
 		return FAUDIO_E_UNSUPPORTED_FORMAT;
 	}
 
@@ -190,11 +345,127 @@ uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
 		FAudio_assert(0 && "Got non-float format!!!");
 	}
 
-	pSourceVoice->src.ffmpeg = (FAudioFFmpeg *) pSourceVoice->audio->pMalloc(sizeof(FAudioFFmpeg));
+	*decoder = (FAudioFFmpegDecoder*) FAudio_INTERNAL_MallocCategory(
+		audio,
+		sizeof(FAudioFFmpegDecoder),
+		FAUDIO_MEMORY_DECODE
+	);
+	FAudio_INTERNAL_DecoderKey(format, type, &(*decoder)->key);
+	(*decoder)->av_ctx = av_ctx;
+	(*decoder)->av_frame = av_frame;
+	(*decoder)->next = NULL;
+	return 0;
+}
+
+static void FAudio_INTERNAL_CloseDecoder(
+	FAudio *audio,
+	FAudioFFmpegDecoder *decoder
+) {
+	avcodec_close(decoder->av_ctx);
+	av_free(decoder->av_ctx->extradata);
+	av_free(decoder->av_ctx);
+	av_frame_free(&decoder->av_frame);
+	FAudio_INTERNAL_Free(audio, decoder);
+}
+
+/* Takes an idle decoder for the key out of the pool, NULL if there isn't one */
+static FAudioFFmpegDecoder* FAudio_INTERNAL_TakeDecoder(
+	FAudio *audio,
+	const FAudioFFmpegKey *key
+) {
+	FAudioDecoderPool *pool = &audio->decoderPool;
+	FAudioFFmpegDecoder **prev, *decoder;
+
+	FAudio_PlatformLockMutex(pool->lock);
+	LOG_MUTEX_LOCK(audio, pool->lock)
+	prev = &pool->head;
+	while (*prev != NULL && FAudio_memcmp(&(*prev)->key, key, sizeof(FAudioFFmpegKey)) != 0)
+	{
+		prev = &(*prev)->next;
+	}
+	decoder = *prev;
+	if (decoder != NULL)
+	{
+		*prev = decoder->next;
+		pool->idle -= 1;
+		pool->hits += 1;
+	}
+	else
+	{
+		pool->misses += 1;
+	}
+	FAudio_PlatformUnlockMutex(pool->lock);
+	LOG_MUTEX_UNLOCK(audio, pool->lock)
+	return decoder;
+}
+
+static void FAudio_INTERNAL_GiveDecoder(
+	FAudio *audio,
+	FAudioFFmpegDecoder *decoder
+) {
+	FAudioDecoderPool *pool = &audio->decoderPool;
+
+	FAudio_PlatformLockMutex(pool->lock);
+	LOG_MUTEX_LOCK(audio, pool->lock)
+	decoder->next = pool->head;
+	pool->head = decoder;
+	pool->idle += 1;
+	FAudio_PlatformUnlockMutex(pool->lock);
+	LOG_MUTEX_UNLOCK(audio, pool->lock)
+}
+
+uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
+{
+	FAudioFFmpegKey key;
+	FAudioFFmpegDecoder *decoder;
+	uint32_t result;
+
+	LOG_FUNC_ENTER(pSourceVoice->audio)
+	pSourceVoice->src.decode = FAudio_INTERNAL_DecodeFFMPEG;
+
+	/* Opening a decoder costs far more than flushing an idle one */
+	FAudio_INTERNAL_DecoderKey(pSourceVoice->src.format, type, &key);
+	decoder = FAudio_INTERNAL_TakeDecoder(pSourceVoice->audio, &key);
+	if (decoder == NULL)
+	{
+		result = FAudio_INTERNAL_OpenDecoder(
+			pSourceVoice->audio,
+			pSourceVoice->src.format,
+			type,
+			&decoder
+		);
+		if (result != 0)
+		{
+			LOG_FUNC_EXIT(pSourceVoice->audio)
+			return result;
+		}
+	}
+
+	pSourceVoice->src.ffmpeg = (FAudioFFmpeg *) FAudio_INTERNAL_MallocCategory(
+		pSourceVoice->audio,
+		sizeof(FAudioFFmpeg),
+		FAUDIO_MEMORY_DECODE
+	);
 	FAudio_zero(pSourceVoice->src.ffmpeg, sizeof(FAudioFFmpeg));
 
-	pSourceVoice->src.ffmpeg->av_ctx = av_ctx;
-	pSourceVoice->src.ffmpeg->av_frame = av_frame;
+	pSourceVoice->src.ffmpeg->decoder = decoder;
+	pSourceVoice->src.ffmpeg->av_ctx = decoder->av_ctx;
+	pSourceVoice->src.ffmpeg->av_frame = decoder->av_frame;
+	pSourceVoice->src.ffmpeg->voice = pSourceVoice;
+
+	if (pSourceVoice->flags & FAUDIO_VOICE_PREDECODE_EXT)
+	{
+		pSourceVoice->src.ffmpeg->aheadFrames = pSourceVoice->audio->decodeAhead;
+		pSourceVoice->src.ffmpeg->lock = FAudio_PlatformCreateMutex();
+		LOG_MUTEX_CREATE(pSourceVoice->audio, pSourceVoice->src.ffmpeg->lock)
+
+		FAudio_PlatformLockMutex(pSourceVoice->audio->predecoder.lock);
+		LOG_MUTEX_LOCK(pSourceVoice->audio, pSourceVoice->audio->predecoder.lock)
+		pSourceVoice->src.ffmpeg->next = pSourceVoice->audio->predecoder.ffmpegVoices;
+		pSourceVoice->audio->predecoder.ffmpegVoices = pSourceVoice->src.ffmpeg;
+		FAudio_PlatformUnlockMutex(pSourceVoice->audio->predecoder.lock);
+		LOG_MUTEX_UNLOCK(pSourceVoice->audio, pSourceVoice->audio->predecoder.lock)
+	}
 	LOG_FUNC_EXIT(pSourceVoice->audio)
 	return 0;
 }
@@ -202,46 +473,153 @@ uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type)
 void FAudio_FFMPEG_free(FAudioSourceVoice *voice)
 {
 	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+	FAudioFFmpeg **prev;
+	uint32_t i;
 
 	LOG_FUNC_ENTER(voice->audio)
 
-	avcodec_close(ffmpeg->av_ctx);
-	av_free(ffmpeg->av_ctx->extradata);
-	av_free(ffmpeg->av_ctx);
+	if (ffmpeg->aheadFrames > 0)
+	{
+		/* Once it's unlinked the thread can't be decoding for it */
+		FAudio_PlatformLockMutex(voice->audio->predecoder.lock);
+		LOG_MUTEX_LOCK(voice->audio, voice->audio->predecoder.lock)
+		prev = &voice->audio->predecoder.ffmpegVoices;
+		while (*prev != ffmpeg)
+		{
+			prev = &(*prev)->next;
+		}
+		*prev = ffmpeg->next;
+		FAudio_PlatformUnlockMutex(voice->audio->predecoder.lock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->audio->predecoder.lock)
+
+		for (i = 0; i < ffmpeg->aheadFrames; i += 1)
+		{
+			FAudio_INTERNAL_Free(voice->audio, ffmpeg->ahead[i].cache);
+		}
+		LOG_MUTEX_DESTROY(voice->audio, ffmpeg->lock)
+		FAudio_PlatformDestroyMutex(ffmpeg->lock);
+	}
+
+	/* Forget this voice's stream and leave it for the next one */
+	avcodec_flush_buffers(ffmpeg->av_ctx);
+	FAudio_INTERNAL_GiveDecoder(voice->audio, ffmpeg->decoder);
 
-	voice->audio->pFree(ffmpeg->convertCache);
-	voice->audio->pFree(ffmpeg->paddingBuffer);
-	voice->audio->pFree(ffmpeg);
+	FAudio_INTERNAL_Free(voice->audio, ffmpeg->convertCache);
+	FAudio_INTERNAL_Free(voice->audio, ffmpeg->loopCache);
+	FAudio_INTERNAL_Free(voice->audio, ffmpeg->paddingBuffer);
+	FAudio_INTERNAL_Free(voice->audio, ffmpeg);
 	voice->src.ffmpeg = NULL;
 
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-void FAudio_INTERNAL_ResizeConvertCache(FAudioVoice *voice, uint32_t samples)
+uint32_t FAudio_FFMPEG_warm(
+	FAudio *audio,
+	const FAudioWaveFormatEx *format,
+	uint32_t count
+) {
+	FAudioDecoderPool *pool = &audio->decoderPool;
+	FAudioFFmpegKey key;
+	FAudioFFmpegDecoder *decoder;
+	uint32_t type, idle, result;
+
+	LOG_FUNC_ENTER(audio)
+
+	if (format->wFormatTag == FAUDIO_FORMAT_EXTENSIBLE)
+	{
+		type = ((FAudioWaveFormatExtensible*) format)->SubFormat.Data1;
+	}
+	else
+	{
+		type = format->wFormatTag;
+	}
+	if (	type != FAUDIO_FORMAT_WMAUDIO2 &&
+		type != FAUDIO_FORMAT_WMAUDIO3 &&
+		type != FAUDIO_FORMAT_XMAUDIO2	)
+	{
+		LOG_ERROR(audio, "Format tag %X is not decoded by FFmpeg", type)
+		LOG_FUNC_EXIT(audio)
+		return FAUDIO_E_UNSUPPORTED_FORMAT;
+	}
+	FAudio_INTERNAL_DecoderKey(format, type, &key);
+
+	/* Count what's already there, then open the rest */
+	idle = 0;
+	FAudio_PlatformLockMutex(pool->lock);
+	LOG_MUTEX_LOCK(audio, pool->lock)
+	for (decoder = pool->head; decoder != NULL; decoder = decoder->next)
+	{
+		if (FAudio_memcmp(&decoder->key, &key, sizeof(FAudioFFmpegKey)) == 0)
+		{
+			idle += 1;
+		}
+	}
+	FAudio_PlatformUnlockMutex(pool->lock);
+	LOG_MUTEX_UNLOCK(audio, pool->lock)
+
+	for (; idle < count; idle += 1)
+	{
+		result = FAudio_INTERNAL_OpenDecoder(audio, format, type, &decoder);
+		if (result != 0)
+		{
+			LOG_FUNC_EXIT(audio)
+			return result;
+		}
+		FAudio_INTERNAL_GiveDecoder(audio, decoder);
+	}
+
+	LOG_FUNC_EXIT(audio)
+	return 0;
+}
+
+void FAudio_FFMPEG_freepool(FAudio *audio)
 {
-	LOG_FUNC_ENTER(voice->audio)
-	if (samples > voice->src.ffmpeg->convertCapacity)
+	FAudioDecoderPool *pool = &audio->decoderPool;
+	FAudioFFmpegDecoder *decoder;
+
+	LOG_FUNC_ENTER(audio)
+	FAudio_PlatformLockMutex(pool->lock);
+	LOG_MUTEX_LOCK(audio, pool->lock)
+	while (pool->head != NULL)
 	{
-		voice->src.ffmpeg->convertCapacity = samples;
-		voice->src.ffmpeg->convertCache = (float*) voice->audio->pRealloc(
-			voice->src.ffmpeg->convertCache,
-			sizeof(float) * voice->src.ffmpeg->convertCapacity
-		);
+		decoder = pool->head;
+		pool->head = decoder->next;
+		FAudio_INTERNAL_CloseDecoder(audio, decoder);
 	}
-	LOG_FUNC_EXIT(voice->audio)
+	pool->idle = 0;
+	FAudio_PlatformUnlockMutex(pool->lock);
+	LOG_MUTEX_UNLOCK(audio, pool->lock)
+	LOG_FUNC_EXIT(audio)
 }
 
-void FAudio_INTERNAL_FillConvertCache(FAudioVoice *voice, FAudioBuffer *buffer)
+/* Whether FFmpeg may read past the end of the buffer's data */
+static inline uint8_t FAudio_INTERNAL_IsPadded(const FAudioBuffer *buffer)
 {
-	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+#if AV_INPUT_BUFFER_PADDING_SIZE <= FAUDIO_BUFFER_PADDING_EXT
+	return (buffer->Flags & FAUDIO_BUFFER_PADDED_EXT) != 0;
+#else
+	/* This FFmpeg wants more than clients were asked for */
+	return 0;
+#endif
+}
+
+/* Receives the next frame into av_frame, sending packets as the decoder asks
+ * for them. Without send, only frames left over from the packets already sent
+ * are returned. Returns the frame's length, or 0 at the end.
+ */
+static uint32_t FAudio_INTERNAL_ReceiveFrame(
+	FAudioFFmpeg *ffmpeg,
+	const FAudioBuffer *buffer,
+	uint8_t send
+) {
+	FAudioSourceVoice *voice = ffmpeg->voice;
+	const uint8_t *data = buffer->pAudioData;
+	uint32_t bytes = buffer->AudioBytes;
 	AVPacket avpkt = {0};
 	int averr;
-	uint32_t total_samples;
-
-	LOG_FUNC_ENTER(voice->audio)
 
 	avpkt.size = voice->src.format->nBlockAlign;
-	avpkt.data = (unsigned char *) buffer->pAudioData + ffmpeg->encOffset;
+	avpkt.data = (unsigned char *) data + ffmpeg->encOffset;
 
 	for(;;)
 	{
@@ -251,29 +629,32 @@ void FAudio_INTERNAL_FillConvertCache(FAudioVoice *voice, FAudioBuffer *buffer)
 			/* ffmpeg needs more data to decode */
 			avpkt.pts = avpkt.dts = AV_NOPTS_VALUE;
 
-			if (ffmpeg->encOffset >= buffer->AudioBytes)
+			if (!send || ffmpeg->encOffset >= bytes)
 			{
 				/* no more data in this buffer */
 				break;
 			}
 
-			if (ffmpeg->encOffset + avpkt.size + AV_INPUT_BUFFER_PADDING_SIZE > buffer->AudioBytes)
+			if (	ffmpeg->encOffset + avpkt.size + AV_INPUT_BUFFER_PADDING_SIZE > bytes &&
+				!FAudio_INTERNAL_IsPadded(buffer)	)
 			{
 				/* Unfortunately, the FFmpeg API requires that a number of
 				 * extra bytes must be available past the end of the buffer.
 				 * The xaudio2 client probably hasn't done this, so we have to
 				 * perform a copy near the end of the buffer. */
-				size_t remain = buffer->AudioBytes - ffmpeg->encOffset;
+				size_t remain = bytes - ffmpeg->encOffset;
 
 				if (ffmpeg->paddingBytes < remain + AV_INPUT_BUFFER_PADDING_SIZE)
 				{
 					ffmpeg->paddingBytes = remain + AV_INPUT_BUFFER_PADDING_SIZE;
-					ffmpeg->paddingBuffer = (uint8_t *) voice->audio->pRealloc(
+					ffmpeg->paddingBuffer = (uint8_t *) FAudio_INTERNAL_ReallocCategory(
+						voice->audio,
 						ffmpeg->paddingBuffer,
-						ffmpeg->paddingBytes
+						ffmpeg->paddingBytes,
+						FAUDIO_MEMORY_DECODE
 					);
 				}
-				FAudio_memcpy(ffmpeg->paddingBuffer, buffer->pAudioData + ffmpeg->encOffset, remain);
+				FAudio_memcpy(ffmpeg->paddingBuffer, data + ffmpeg->encOffset, remain);
 				FAudio_zero(ffmpeg->paddingBuffer + remain, AV_INPUT_BUFFER_PADDING_SIZE);
 				avpkt.data = ffmpeg->paddingBuffer;
 			}
@@ -300,111 +681,463 @@ void FAudio_INTERNAL_FillConvertCache(FAudioVoice *voice, FAudioBuffer *buffer)
 				averr
 			)
 			FAudio_assert(0 && "avcodec_receive_frame failed" && averr);
-			LOG_FUNC_EXIT(voice->audio)
-			return;
+			return 0;
 		}
 		else
 		{
-			break;
+			return ffmpeg->av_frame->nb_samples;
 		}
 	}
+	return 0;
+}
 
-	/* copy decoded samples to internal buffer, reordering if necessary */
-	total_samples = ffmpeg->av_frame->nb_samples * ffmpeg->av_ctx->channels;
-
-	FAudio_INTERNAL_ResizeConvertCache(voice, total_samples);
-
+/* Writes the frame in av_frame to dst, interleaving it if necessary */
+static void FAudio_INTERNAL_StoreFrame(FAudioFFmpeg *ffmpeg, float *dst)
+{
 	if (av_sample_fmt_is_planar(ffmpeg->av_ctx->sample_fmt))
 	{
-		int32_t s, c;
-		uint8_t **src = ffmpeg->av_frame->data;
-		uint32_t *dst = (uint32_t *) ffmpeg->convertCache;
-
-		for(s = 0; s < ffmpeg->av_frame->nb_samples; ++s)
-			for(c = 0; c < ffmpeg->av_ctx->channels; ++c)
-				*dst++ = ((uint32_t*)(src[c]))[s];
+		FAudio_INTERNAL_InterleaveF32(
+			(const float *const *) ffmpeg->av_frame->data,
+			dst,
+			ffmpeg->av_frame->nb_samples,
+			ffmpeg->av_ctx->channels
+		);
 	}
 	else
 	{
 		FAudio_memcpy(
-			ffmpeg->convertCache,
+			dst,
 			ffmpeg->av_frame->data[0],
-			total_samples * sizeof(float)
+			ffmpeg->av_frame->nb_samples * ffmpeg->av_ctx->channels * sizeof(float)
 		);
 	}
+}
+
+/* Writes the frame in av_frame to *cache after the offset samples already
+ * there, growing it as needed
+ */
+static void FAudio_INTERNAL_CacheFrame(
+	FAudioFFmpeg *ffmpeg,
+	float **cache,
+	uint32_t *capacity,
+	uint32_t offset
+) {
+	uint32_t total_samples;
+
+	offset *= ffmpeg->av_ctx->channels;
+	total_samples = ffmpeg->av_frame->nb_samples * ffmpeg->av_ctx->channels;
+	if (offset + total_samples > *capacity)
+	{
+		*capacity = offset + total_samples;
+		*cache = (float*) FAudio_INTERNAL_ReallocCategory(
+			ffmpeg->voice->audio,
+			*cache,
+			sizeof(float) * *capacity,
+			FAUDIO_MEMORY_DECODE
+		);
+	}
+	FAudio_INTERNAL_StoreFrame(ffmpeg, *cache + offset);
+}
 
-	ffmpeg->convertSamples = ffmpeg->av_frame->nb_samples;
+/* Decodes the next frame into *cache after the offset samples already there.
+ * Without send, only frames left over from the packets already sent are
+ * returned. Returns the frame's length, or 0 at the end.
+ */
+static uint32_t FAudio_INTERNAL_DecodeFrame(
+	FAudioFFmpeg *ffmpeg,
+	const FAudioBuffer *buffer,
+	uint8_t send,
+	float **cache,
+	uint32_t *capacity,
+	uint32_t offset
+) {
+	uint32_t frames = FAudio_INTERNAL_ReceiveFrame(ffmpeg, buffer, send);
+	if (frames > 0)
+	{
+		FAudio_INTERNAL_CacheFrame(ffmpeg, cache, capacity, offset);
+	}
+	return frames;
+}
+
+/* Called by the predecode thread with the predecoder lock held. Decodes one
+ * frame for whichever voice that asked has the fewest ready, and returns 1 if
+ * any voice still wants more.
+ */
+uint8_t FAudio_FFMPEG_decodeahead(FAudio *audio)
+{
+	FAudioFFmpeg *ffmpeg, *best = NULL;
+	FAudioFFmpegFrame *frame;
+	int32_t count, bestCount = 0;
+	uint8_t more = 0;
+
+	for (ffmpeg = audio->predecoder.ffmpegVoices; ffmpeg != NULL; ffmpeg = ffmpeg->next)
+	{
+		if (!FAudio_PlatformAtomicGet(&ffmpeg->aheadWanted))
+		{
+			continue;
+		}
+		count = FAudio_PlatformAtomicGet(&ffmpeg->aheadCount);
+		if (best == NULL || count < bestCount)
+		{
+			more |= (best != NULL);
+			best = ffmpeg;
+			bestCount = count;
+		}
+		else
+		{
+			more = 1;
+		}
+	}
+	if (best == NULL)
+	{
+		return 0;
+	}
+
+	/* Cleared first, so a frame taken while we decode asks again */
+	FAudio_PlatformAtomicCompareExchange(&best->aheadWanted, 1, 0);
+
+	FAudio_PlatformLockMutex(best->lock);
+	LOG_MUTEX_LOCK(audio, best->lock)
+	count = FAudio_PlatformAtomicGet(&best->aheadCount);
+	if (	best->aheadBuffer.pAudioData != NULL &&
+		!best->aheadDone &&
+		count < (int32_t) best->aheadFrames	)
+	{
+		frame = &best->ahead[best->aheadWrite];
+		frame->samples = FAudio_INTERNAL_DecodeFrame(
+			best,
+			&best->aheadBuffer,
+			1,
+			&frame->cache,
+			&frame->capacity,
+			0
+		);
+		if (frame->samples == 0)
+		{
+			best->aheadDone = 1;
+		}
+		else
+		{
+			best->aheadWrite = (best->aheadWrite + 1) % best->aheadFrames;
+			FAudio_PlatformAtomicAdd(&best->aheadCount, 1);
+			if (count + 1 < (int32_t) best->aheadFrames)
+			{
+				FAudio_PlatformAtomicCompareExchange(&best->aheadWanted, 0, 1);
+				more = 1;
+			}
+		}
+	}
+	FAudio_PlatformUnlockMutex(best->lock);
+	LOG_MUTEX_UNLOCK(audio, best->lock)
+	return more;
+}
+
+/* Refills convertCache with the next frame for a decode-ahead voice. It's
+ * taken from the thread when it's ready and only decoded here when it isn't.
+ */
+static void FAudio_INTERNAL_FillConvertCache(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer
+) {
+	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+	FAudioFFmpegFrame *frame;
+	float *cache;
+	uint32_t capacity;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	if (FAudio_PlatformAtomicGet(&ffmpeg->aheadCount) == 0)
+	{
+		FAudio_PlatformLockMutex(ffmpeg->lock);
+		LOG_MUTEX_LOCK(voice->audio, ffmpeg->lock)
+
+		/* The thread may have finished it while we waited */
+		if (FAudio_PlatformAtomicGet(&ffmpeg->aheadCount) == 0)
+		{
+			ffmpeg->aheadBuffer = *buffer;
+			ffmpeg->convertSamples = FAudio_INTERNAL_DecodeFrame(
+				ffmpeg,
+				buffer,
+				1,
+				&ffmpeg->convertCache,
+				&ffmpeg->convertCapacity,
+				0
+			);
+			ffmpeg->convertOffset = 0;
+			ffmpeg->aheadDone = (ffmpeg->convertSamples == 0);
+			FAudio_PlatformUnlockMutex(ffmpeg->lock);
+			LOG_MUTEX_UNLOCK(voice->audio, ffmpeg->lock)
+			FAudio_INTERNAL_WantAhead(voice->audio, ffmpeg);
+			LOG_FUNC_EXIT(voice->audio)
+			return;
+		}
+		FAudio_PlatformUnlockMutex(ffmpeg->lock);
+		LOG_MUTEX_UNLOCK(voice->audio, ffmpeg->lock)
+	}
+
+	/* Swap the oldest ready frame in, the thread has our old one next */
+	frame = &ffmpeg->ahead[ffmpeg->aheadRead];
+	cache = frame->cache;
+	capacity = frame->capacity;
+	frame->cache = ffmpeg->convertCache;
+	frame->capacity = ffmpeg->convertCapacity;
+	ffmpeg->convertCache = cache;
+	ffmpeg->convertCapacity = capacity;
+	ffmpeg->convertSamples = frame->samples;
 	ffmpeg->convertOffset = 0;
+	ffmpeg->aheadRead = (ffmpeg->aheadRead + 1) % ffmpeg->aheadFrames;
+	FAudio_PlatformAtomicAdd(&ffmpeg->aheadCount, -1);
+	FAudio_INTERNAL_WantAhead(voice->audio, ffmpeg);
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-void FAudio_INTERNAL_DecodeFFMPEG(
+/* Decodes the next frame for a voice without decode-ahead. If all of it fits
+ * in what's left of decodeCache it's written there and 1 is returned, with
+ * convertCache left empty. Otherwise it's refilled as usual, and 0 returned.
+ */
+static uint8_t FAudio_INTERNAL_FillDirect(
 	FAudioVoice *voice,
 	FAudioBuffer *buffer,
 	float *decodeCache,
-	uint32_t samples
+	uint32_t samples,
+	uint32_t *done
+) {
+	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+	uint32_t frames;
+
+	ffmpeg->convertSamples = 0;
+	ffmpeg->convertOffset = 0;
+	frames = FAudio_INTERNAL_ReceiveFrame(ffmpeg, buffer, 1);
+	if (frames == 0)
+	{
+		return 0;
+	}
+
+	if (frames <= samples - *done)
+	{
+		FAudio_INTERNAL_StoreFrame(
+			ffmpeg,
+			decodeCache + (*done * voice->src.format->nChannels)
+		);
+		*done += frames;
+		return 1;
+	}
+
+	FAudio_INTERNAL_CacheFrame(
+		ffmpeg,
+		&ffmpeg->convertCache,
+		&ffmpeg->convertCapacity,
+		0
+	);
+	ffmpeg->convertSamples = frames;
+	return 0;
+}
+
+/* Points convertCache at the given sample of the buffer, from the packet
+ * that holds it or from the frames kept for LoopBegin.
+ */
+static void FAudio_INTERNAL_SeekConvertCache(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer,
+	uint32_t sample
 ) {
 	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+	FAudioBufferWMA *bufferWMA = &voice->src.bufferList->bufferWMA;
 	uint32_t decSampleSize = voice->src.format->nChannels * voice->src.format->wBitsPerSample / 8;
-	uint32_t outSampleSize = voice->src.format->nChannels * sizeof(float);
-	uint32_t done = 0, available, todo, cumulative;
-	uint32_t reseek = 0;
+	uint32_t byteOffset = sample * decSampleSize;
+	uint32_t low, high, mid, start, decoded;
 
 	LOG_FUNC_ENTER(voice->audio)
 
-	/* check if we need to reposition in the stream */
-	if (voice->src.curBufferOffset < ffmpeg->decOffset)
+	if (ffmpeg->aheadFrames > 0)
 	{
-		/* If curBufferOffset is behind, it's because we had to do some
-		 * padding, which should not affect the stream offset. To fix,
-		 * we simply rewind by a couple samples. Pretty safe if it doesn't
-		 * cross back into the previous decoded block.
-		 */
-		uint32_t delta = ffmpeg->decOffset - voice->src.curBufferOffset;
+		FAudio_PlatformLockMutex(ffmpeg->lock);
+		LOG_MUTEX_LOCK(voice->audio, ffmpeg->lock)
+		FAudio_INTERNAL_DropAhead(ffmpeg);
+		ffmpeg->aheadBuffer = *buffer;
+	}
 
-		if (ffmpeg->convertOffset >= delta)
+	/* Anything still in the decoder is from where we were */
+	avcodec_flush_buffers(ffmpeg->av_ctx);
+
+	if (	ffmpeg->loopBuffer == buffer &&
+		sample >= ffmpeg->loopStart &&
+		sample < ffmpeg->loopStart + ffmpeg->loopSamples	)
+	{
+		if (ffmpeg->loopSamples * voice->src.format->nChannels > ffmpeg->convertCapacity)
 		{
-			ffmpeg->convertOffset -= delta;
-			ffmpeg->decOffset = voice->src.curBufferOffset;
+			ffmpeg->convertCapacity = ffmpeg->loopSamples * voice->src.format->nChannels;
+			ffmpeg->convertCache = (float*) FAudio_INTERNAL_ReallocCategory(
+				voice->audio,
+				ffmpeg->convertCache,
+				sizeof(float) * ffmpeg->convertCapacity,
+				FAUDIO_MEMORY_DECODE
+			);
 		}
-		else
+
+		/* The codecs overlap each frame with the last, so the decoder
+		 * needs the loop packet again to carry on from the one after it.
+		 * What it gives back is already in the cache.
+		 */
+		ffmpeg->encOffset = ffmpeg->loopPacketOffset;
+		while (	ffmpeg->encOffset < ffmpeg->loopEncOffset &&
+			FAudio_INTERNAL_ReceiveFrame(ffmpeg, buffer, 1) > 0	)
+		{
+			/* Thrown away */
+		}
+		while (FAudio_INTERNAL_ReceiveFrame(ffmpeg, buffer, 0) > 0)
 		{
-			reseek = 1;
+			/* Thrown away */
 		}
+
+		FAudio_memcpy(
+			ffmpeg->convertCache,
+			ffmpeg->loopCache,
+			sizeof(float) * ffmpeg->loopSamples * voice->src.format->nChannels
+		);
+		ffmpeg->convertSamples = ffmpeg->loopSamples;
+		ffmpeg->convertOffset = sample - ffmpeg->loopStart;
 	}
-	else if (voice->src.curBufferOffset > ffmpeg->decOffset)
+	else if (bufferWMA->PacketCount == 0)
 	{
-		/* If we're starting in the middle, we have to seek to the
-		 * starting position. AFAIK this shouldn't happen mid-stream.
-		 */
-		reseek = 1;
+		/* Nothing to seek into */
+		ffmpeg->convertSamples = 0;
+		ffmpeg->convertOffset = 0;
 	}
-
-	if (reseek)
+	else
 	{
-		FAudioBufferWMA *bufferWMA = &voice->src.bufferList->bufferWMA;
-		uint32_t byteOffset = voice->src.curBufferOffset * decSampleSize;
-		uint32_t packetIdx = bufferWMA->PacketCount - 1;
+		/* The packet holding it is the first to decode past it */
+		low = 0;
+		high = bufferWMA->PacketCount - 1;
+		while (low < high)
+		{
+			mid = low + ((high - low) / 2);
+			if (bufferWMA->pDecodedPacketCumulativeBytes[mid] > byteOffset)
+			{
+				high = mid;
+			}
+			else
+			{
+				low = mid + 1;
+			}
+		}
+		start = (low == 0) ?
+			0 :
+			bufferWMA->pDecodedPacketCumulativeBytes[low - 1] / decSampleSize;
 
-		/* figure out in which encoded packet has this position */
-		while (packetIdx > 0 && bufferWMA->pDecodedPacketCumulativeBytes[packetIdx] > byteOffset)
+		/* Decode from the start of that packet up to the frame */
+		ffmpeg->encOffset = low * voice->src.format->nBlockAlign;
+		ffmpeg->convertSamples = FAudio_INTERNAL_DecodeFrame(
+			ffmpeg,
+			buffer,
+			1,
+			&ffmpeg->convertCache,
+			&ffmpeg->convertCapacity,
+			0
+		);
+		while (	ffmpeg->convertSamples > 0 &&
+			sample >= start + ffmpeg->convertSamples	)
 		{
-			packetIdx -= 1;
+			start += ffmpeg->convertSamples;
+			ffmpeg->convertSamples = FAudio_INTERNAL_DecodeFrame(
+				ffmpeg,
+				buffer,
+				1,
+				&ffmpeg->convertCache,
+				&ffmpeg->convertCapacity,
+				0
+			);
+		}
+		ffmpeg->convertOffset = (ffmpeg->convertSamples > 0) ?
+			sample - start :
+			0;
+
+		/* Loops come back here, so decode the rest of the packet too
+		 * and keep all of it for next time
+		 */
+		if (	buffer->LoopCount > 0 &&
+			sample == buffer->LoopBegin &&
+			ffmpeg->convertSamples > 0	)
+		{
+			do
+			{
+				decoded = FAudio_INTERNAL_DecodeFrame(
+					ffmpeg,
+					buffer,
+					0,
+					&ffmpeg->convertCache,
+					&ffmpeg->convertCapacity,
+					ffmpeg->convertSamples
+				);
+				ffmpeg->convertSamples += decoded;
+			} while (decoded > 0);
+
+			if (ffmpeg->convertSamples * voice->src.format->nChannels > ffmpeg->loopCapacity)
+			{
+				ffmpeg->loopCapacity = ffmpeg->convertSamples * voice->src.format->nChannels;
+				ffmpeg->loopCache = (float*) FAudio_INTERNAL_ReallocCategory(
+					voice->audio,
+					ffmpeg->loopCache,
+					sizeof(float) * ffmpeg->loopCapacity,
+					FAUDIO_MEMORY_DECODE
+				);
+			}
+			FAudio_memcpy(
+				ffmpeg->loopCache,
+				ffmpeg->convertCache,
+				sizeof(float) * ffmpeg->convertSamples * voice->src.format->nChannels
+			);
+			ffmpeg->loopBuffer = buffer;
+			ffmpeg->loopStart = start;
+			ffmpeg->loopPacketOffset = low * voice->src.format->nBlockAlign;
+			ffmpeg->loopSamples = ffmpeg->convertSamples;
+			ffmpeg->loopEncOffset = ffmpeg->encOffset;
 		}
+	}
+
+	if (ffmpeg->aheadFrames > 0)
+	{
+		ffmpeg->aheadDone = (ffmpeg->convertSamples == 0);
+		FAudio_PlatformUnlockMutex(ffmpeg->lock);
+		LOG_MUTEX_UNLOCK(voice->audio, ffmpeg->lock)
+		FAudio_INTERNAL_WantAhead(voice->audio, ffmpeg);
+	}
+	LOG_FUNC_EXIT(voice->audio)
+}
 
-		if (packetIdx == 0)
+void FAudio_INTERNAL_DecodeFFMPEG(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer,
+	float *decodeCache,
+	uint32_t samples
+) {
+	FAudioFFmpeg *ffmpeg = voice->src.ffmpeg;
+	uint32_t done = 0, available, todo, frameStart;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	/* check if we need to reposition in the stream */
+	if (voice->src.curBufferOffset != ffmpeg->decOffset)
+	{
+		/* Padding rewinds us by a couple samples, and short loops or
+		 * skips can land in the frame we already have. Otherwise we
+		 * have to seek to the starting position.
+		 */
+		frameStart = ffmpeg->decOffset - ffmpeg->convertOffset;
+		if (	ffmpeg->decOffset >= ffmpeg->convertOffset &&
+			voice->src.curBufferOffset >= frameStart &&
+			voice->src.curBufferOffset < frameStart + ffmpeg->convertSamples	)
 		{
-			cumulative = 0;
+			ffmpeg->convertOffset = voice->src.curBufferOffset - frameStart;
 		}
 		else
 		{
-			cumulative = bufferWMA->pDecodedPacketCumulativeBytes[packetIdx - 1];
+			FAudio_INTERNAL_SeekConvertCache(
+				voice,
+				buffer,
+				voice->src.curBufferOffset
+			);
 		}
-
-		/* seek to the wanted position in the stream */
-		ffmpeg->encOffset = packetIdx * voice->src.format->nBlockAlign;
-		FAudio_INTERNAL_FillConvertCache(voice, buffer);
-		ffmpeg->convertOffset = (byteOffset - cumulative) / outSampleSize;
 		ffmpeg->decOffset = voice->src.curBufferOffset;
 	}
 
@@ -413,7 +1146,15 @@ void FAudio_INTERNAL_DecodeFFMPEG(
 		/* check for available data in decoded cache, refill if necessary */
 		if (ffmpeg->convertOffset >= ffmpeg->convertSamples)
 		{
-			FAudio_INTERNAL_FillConvertCache(voice, buffer);
+			if (ffmpeg->aheadFrames > 0)
+			{
+				FAudio_INTERNAL_FillConvertCache(voice, buffer);
+			}
+			else if (FAudio_INTERNAL_FillDirect(voice, buffer, decodeCache, samples, &done))
+			{
+				/* The whole frame went straight to decodeCache */
+				continue;
+			}
 		}
 
 		available = ffmpeg->convertSamples - ffmpeg->convertOffset;
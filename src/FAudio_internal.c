@@ -160,6 +160,335 @@ void FAudio_INTERNAL_debug_fmt(
 		get_subformat_string(fmt)
 	);
 }
+
+/* Trace Rings */
+
+static FAudioTraceThread* FAudio_INTERNAL_GetTraceThread(FAudio *audio)
+{
+	FAudioTrace *trace = &audio->trace;
+	FAudioTraceThread *thread;
+	uint64_t threadID = FAudio_PlatformGetThreadID();
+	int32_t i, count;
+
+	count = FAudio_min(
+		FAudio_PlatformAtomicGet(&trace->threadCount),
+		FAUDIO_TRACE_MAX_THREADS
+	);
+	for (i = 0; i < count; i += 1)
+	{
+		thread = &trace->threads[i];
+		if (thread->ready && thread->threadID == threadID)
+		{
+			return thread;
+		}
+	}
+
+	/* First event from this thread, claim a ring. Only this thread can
+	 * claim one for itself, so there's no way to end up with two.
+	 */
+	if (count == FAUDIO_TRACE_MAX_THREADS)
+	{
+		return NULL;
+	}
+	i = FAudio_PlatformAtomicAdd(&trace->threadCount, 1);
+	if (i >= FAUDIO_TRACE_MAX_THREADS)
+	{
+		return NULL;
+	}
+	thread = &trace->threads[i];
+	thread->events = (FAudioTraceEvent*) audio->pMalloc(
+		sizeof(FAudioTraceEvent) * trace->eventCount
+	);
+	if (thread->events == NULL)
+	{
+		return NULL;
+	}
+	thread->threadID = threadID;
+	thread->eventMask = trace->eventCount - 1;
+	thread->head = 0;
+	FAudio_PlatformAtomicCompareExchange(&thread->ready, 0, 1);
+	return thread;
+}
+
+void FAudio_INTERNAL_trace(
+	FAudio *audio,
+	uint32_t category,
+	char phase,
+	const char *name,
+	const void *ptr,
+	uint64_t arg
+) {
+	FAudioTraceThread *thread = FAudio_INTERNAL_GetTraceThread(audio);
+	FAudioTraceEvent *event;
+
+	if (thread == NULL)
+	{
+		FAudio_PlatformAtomicAdd(&audio->trace.droppedEvents, 1);
+		return;
+	}
+
+	event = &thread->events[(uint32_t) thread->head & thread->eventMask];
+	event->time = FAudio_timecycles();
+	event->name = name;
+	event->ptr = ptr;
+	event->arg = arg;
+	event->category = category;
+	event->phase = phase;
+
+	/* Publishes the event to dumps, after it's been written */
+	FAudio_PlatformAtomicAdd(&thread->head, 1);
+}
+
+void FAudio_INTERNAL_FreeTrace(FAudio *audio)
+{
+	int32_t i, count;
+
+	audio->trace.mask = 0;
+	count = FAudio_min(audio->trace.threadCount, FAUDIO_TRACE_MAX_THREADS);
+	for (i = 0; i < count; i += 1)
+	{
+		if (audio->trace.threads[i].events != NULL)
+		{
+			audio->pFree(audio->trace.threads[i].events);
+		}
+	}
+	FAudio_zero(audio->trace.threads, sizeof(audio->trace.threads));
+	audio->trace.threadCount = 0;
+}
+
+/* Chrome's Trace Event Format, which Perfetto also reads */
+
+typedef struct FAudioTraceWriter
+{
+	FAudioTraceWriteFuncEXT writeFunc;
+	void *user;
+	uint8_t failed;
+	size_t used;
+	char buffer[4096];
+} FAudioTraceWriter;
+
+static void FAudio_INTERNAL_TraceFlush(FAudioTraceWriter *writer)
+{
+	if (	writer->used > 0 &&
+		!writer->failed &&
+		writer->writeFunc(
+			writer->user,
+			writer->buffer,
+			writer->used
+		) != writer->used	)
+	{
+		writer->failed = 1;
+	}
+	writer->used = 0;
+}
+
+static void FAudio_INTERNAL_TraceWrite(
+	FAudioTraceWriter *writer,
+	const char *fmt,
+	...
+) {
+	char line[256];
+	va_list va;
+	int len;
+
+	va_start(va, fmt);
+	len = FAudio_vsnprintf(line, sizeof(line), fmt, va);
+	va_end(va);
+	if (len < 0)
+	{
+		return;
+	}
+	len = FAudio_min(len, (int) sizeof(line) - 1);
+
+	if (writer->used + len > sizeof(writer->buffer))
+	{
+		FAudio_INTERNAL_TraceFlush(writer);
+	}
+	FAudio_memcpy(writer->buffer + writer->used, line, len);
+	writer->used += len;
+}
+
+/* Names are our own literals, but the log formats can have anything in them */
+static void FAudio_INTERNAL_TraceWriteName(
+	FAudioTraceWriter *writer,
+	const char *name
+) {
+	char escaped[128];
+	size_t len = 0;
+
+	while (*name != '\0' && len < sizeof(escaped) - 2)
+	{
+		if (*name == '"' || *name == '\\')
+		{
+			escaped[len++] = '\\';
+			escaped[len++] = *name;
+		}
+		else if ((uint8_t) *name >= 0x20)
+		{
+			escaped[len++] = *name;
+		}
+		name += 1;
+	}
+	escaped[len] = '\0';
+	FAudio_INTERNAL_TraceWrite(writer, "\"name\":\"%s\"", escaped);
+}
+
+static const char *get_trace_category_string(uint32_t category)
+{
+#define CATEGORY_STRING(flag, name) \
+	if (category == FAUDIO_LOG_##flag) \
+	{ \
+		return name; \
+	}
+	CATEGORY_STRING(ERRORS, "errors")
+	CATEGORY_STRING(WARNINGS, "warnings")
+	CATEGORY_STRING(INFO, "info")
+	CATEGORY_STRING(DETAIL, "detail")
+	CATEGORY_STRING(API_CALLS, "api")
+	CATEGORY_STRING(FUNC_CALLS, "func")
+	CATEGORY_STRING(TIMING, "timing")
+	CATEGORY_STRING(LOCKS, "locks")
+	CATEGORY_STRING(MEMORY, "memory")
+	CATEGORY_STRING(STREAMING, "streaming")
+#undef CATEGORY_STRING
+	return "unknown";
+}
+
+uint32_t FAudio_INTERNAL_DumpTrace(
+	FAudio *audio,
+	FAudioTraceWriteFuncEXT writeFunc,
+	void *user
+) {
+	FAudioTrace *trace = &audio->trace;
+	FAudioTraceThread *thread;
+	FAudioTraceEvent event;
+	FAudioTraceWriter *writer;
+	uint64_t nowCycles, nowTime;
+	double usPerCycle;
+	uint32_t head, size, j, result;
+	int32_t i, count;
+	uint8_t first = 1;
+
+	writer = (FAudioTraceWriter*) audio->pMalloc(sizeof(FAudioTraceWriter));
+	if (writer == NULL)
+	{
+		return FAUDIO_E_OUT_OF_MEMORY;
+	}
+	writer->writeFunc = writeFunc;
+	writer->user = user;
+	writer->failed = 0;
+	writer->used = 0;
+
+	/* The cycle counter's rate isn't known up front, so measure it
+	 * against the microsecond clock over the length of the trace
+	 */
+	nowCycles = FAudio_timecycles();
+	nowTime = FAudio_timeus();
+	if (nowCycles > trace->startCycles && nowTime > trace->startTime)
+	{
+		usPerCycle = (
+			(double) (nowTime - trace->startTime) /
+			(double) (nowCycles - trace->startCycles)
+		);
+	}
+	else
+	{
+		usPerCycle = 0.0;
+	}
+
+	FAudio_INTERNAL_TraceWrite(writer, "{\"traceEvents\":[");
+	count = FAudio_min(
+		FAudio_PlatformAtomicGet(&trace->threadCount),
+		FAUDIO_TRACE_MAX_THREADS
+	);
+	for (i = 0; i < count; i += 1)
+	{
+		thread = &trace->threads[i];
+		if (!FAudio_PlatformAtomicGet(&thread->ready))
+		{
+			continue;
+		}
+
+		FAudio_INTERNAL_TraceWrite(
+			writer,
+			"%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+			"\"args\":{\"name\":\"Thread 0x%" FAudio_PRIx64 "\"}}",
+			first ? "" : ",",
+			i,
+			thread->threadID
+		);
+		first = 0;
+
+		size = thread->eventMask + 1;
+		head = (uint32_t) FAudio_PlatformAtomicGet(&thread->head);
+		for (j = (head > size) ? (head - size) : 0; j != head; j += 1)
+		{
+			event = thread->events[j & thread->eventMask];
+
+			/* The thread may have lapped us while we copied it */
+			if ((uint32_t) FAudio_PlatformAtomicGet(&thread->head) - j >= size)
+			{
+				continue;
+			}
+			if (event.time < trace->startCycles)
+			{
+				continue;
+			}
+
+			FAudio_INTERNAL_TraceWrite(writer, ",\n{");
+			FAudio_INTERNAL_TraceWriteName(writer, event.name);
+			FAudio_INTERNAL_TraceWrite(
+				writer,
+				",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+				get_trace_category_string(event.category),
+				event.phase,
+				(double) (event.time - trace->startCycles) * usPerCycle,
+				i
+			);
+			if (event.phase == 'i')
+			{
+				FAudio_INTERNAL_TraceWrite(writer, ",\"s\":\"t\"");
+			}
+			if (event.phase == 'C')
+			{
+				FAudio_INTERNAL_TraceWrite(
+					writer,
+					",\"args\":{\"bytes\":%" FAudio_PRIu64 "}",
+					event.arg
+				);
+			}
+			else if (	event.category == FAUDIO_LOG_MEMORY ||
+					event.category == FAUDIO_LOG_STREAMING	)
+			{
+				FAudio_INTERNAL_TraceWrite(
+					writer,
+					",\"args\":{\"ptr\":\"0x%" FAudio_PRIx64 "\",\"value\":%" FAudio_PRIu64 "}",
+					(uint64_t) (size_t) event.ptr,
+					event.arg
+				);
+			}
+			else if (event.ptr != NULL)
+			{
+				FAudio_INTERNAL_TraceWrite(
+					writer,
+					",\"args\":{\"ptr\":\"0x%" FAudio_PRIx64 "\"}",
+					(uint64_t) (size_t) event.ptr
+				);
+			}
+			FAudio_INTERNAL_TraceWrite(writer, "}");
+		}
+	}
+	FAudio_INTERNAL_TraceWrite(
+		writer,
+		"\n],\"otherData\":{\"droppedEvents\":\"%d\"}}\n",
+		FAudio_PlatformAtomicGet(&trace->droppedEvents)
+	);
+	FAudio_INTERNAL_TraceFlush(writer);
+
+	result = writer->failed ? FAUDIO_E_INVALID_CALL : 0;
+	audio->pFree(writer);
+	return result;
+}
 #endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 
 void LinkedList_AddEntry(
@@ -237,61 +566,217 @@ void LinkedList_RemoveEntry(
 	FAudio_assert(0 && "LinkedList element not found!");
 }
 
-void FAudio_INTERNAL_InsertSubmixSorted(
-	LinkedList **start,
-	FAudioSubmixVoice *toAdd,
-	FAudioMutex lock,
-	FAudioMallocFunc pMalloc
+/* Engine Allocations */
+
+/* Each block keeps its size and category in front of it, for the free. 16
+ * bytes keeps the alignment the client's allocator gave us.
+ */
+#define ALLOCATION_HEADER 16
+#define ALLOCATION_SIZE(block) (*((size_t*) (block)))
+#define ALLOCATION_CATEGORY(block) (*((uint32_t*) ((block) + sizeof(size_t))))
+
+static inline void FAudio_INTERNAL_CountMemory(
+	FAudio *audio,
+	uint32_t category,
+	int32_t size
 ) {
-	LinkedList *newEntry, *latest;
-	newEntry = (LinkedList*) pMalloc(sizeof(LinkedList));
-	newEntry->entry = toAdd;
-	newEntry->next = NULL;
-	FAudio_PlatformLockMutex(lock);
-	if (*start == NULL)
+	FAudio_PlatformAtomicAdd(&audio->memoryUsage, size);
+	FAudio_PlatformAtomicAdd(&audio->memoryCategories[category], size);
+}
+
+void* FAudio_INTERNAL_Malloc(FAudio *audio, size_t size)
+{
+	return FAudio_INTERNAL_MallocCategory(audio, size, FAUDIO_MEMORY_VOICES);
+}
+
+void* FAudio_INTERNAL_MallocCategory(
+	FAudio *audio,
+	size_t size,
+	uint32_t category
+) {
+	uint8_t *block = (uint8_t*) audio->pMalloc(ALLOCATION_HEADER + size);
+	if (block == NULL)
 	{
-		*start = newEntry;
+		return NULL;
 	}
-	else
+	ALLOCATION_SIZE(block) = size;
+	ALLOCATION_CATEGORY(block) = category;
+	FAudio_INTERNAL_CountMemory(audio, category, (int32_t) size);
+	LOG_MEMORY(audio, "Malloc", block + ALLOCATION_HEADER, size)
+	return block + ALLOCATION_HEADER;
+}
+
+void FAudio_INTERNAL_Free(FAudio *audio, void *ptr)
+{
+	uint8_t *block;
+	if (ptr == NULL)
 	{
-		latest = *start;
+		return;
+	}
+	block = (uint8_t*) ptr - ALLOCATION_HEADER;
+	FAudio_INTERNAL_CountMemory(
+		audio,
+		ALLOCATION_CATEGORY(block),
+		-((int32_t) ALLOCATION_SIZE(block))
+	);
+	LOG_MEMORY(audio, "Free", ptr, ALLOCATION_SIZE(block))
+	audio->pFree(block);
+}
+
+void* FAudio_INTERNAL_Realloc(FAudio *audio, void *ptr, size_t size)
+{
+	if (ptr == NULL)
+	{
+		return FAudio_INTERNAL_Malloc(audio, size);
+	}
+	return FAudio_INTERNAL_ReallocCategory(
+		audio,
+		ptr,
+		size,
+		ALLOCATION_CATEGORY((uint8_t*) ptr - ALLOCATION_HEADER)
+	);
+}
+
+void* FAudio_INTERNAL_ReallocCategory(
+	FAudio *audio,
+	void *ptr,
+	size_t size,
+	uint32_t category
+) {
+	uint8_t *block;
+	size_t oldSize;
+	uint32_t oldCategory;
+	if (ptr == NULL)
+	{
+		return FAudio_INTERNAL_MallocCategory(audio, size, category);
+	}
+	block = (uint8_t*) ptr - ALLOCATION_HEADER;
+	oldSize = ALLOCATION_SIZE(block);
+	oldCategory = ALLOCATION_CATEGORY(block);
+	block = (uint8_t*) audio->pRealloc(block, ALLOCATION_HEADER + size);
+	if (block == NULL)
+	{
+		return NULL;
+	}
+	ALLOCATION_SIZE(block) = size;
+	ALLOCATION_CATEGORY(block) = category;
+	FAudio_INTERNAL_CountMemory(audio, oldCategory, -((int32_t) oldSize));
+	FAudio_INTERNAL_CountMemory(audio, category, (int32_t) size);
+	LOG_MEMORY(audio, "Realloc", block + ALLOCATION_HEADER, size)
+	return block + ALLOCATION_HEADER;
+}
+
+/* Aligned blocks keep the category, the start of the real allocation and the
+ * size right in front of the pointer we hand out. With the client's aligned
+ * allocator that costs one whole alignment unit, without it the block is
+ * over-allocated and the pointer is rounded up within it.
+ */
+#define ALIGNED_HEADER (3 * sizeof(size_t))
 
-		/* Special case if the new stage is lower than everyone else */
-		if (toAdd->mix.processingStage < ((FAudioSubmixVoice*) latest->entry)->mix.processingStage)
+void* FAudio_INTERNAL_AlignedMalloc(
+	FAudio *audio,
+	size_t size,
+	uint32_t category
+) {
+	uint8_t *block, *result;
+	if (audio->pAlignedMalloc != NULL)
+	{
+		block = (uint8_t*) audio->pAlignedMalloc(
+			FAUDIO_BUFFER_ALIGNMENT_EXT + size,
+			FAUDIO_BUFFER_ALIGNMENT_EXT
+		);
+		if (block == NULL)
 		{
-			newEntry->next = latest;
-			*start = newEntry;
+			return NULL;
 		}
-		else
+		result = block + FAUDIO_BUFFER_ALIGNMENT_EXT;
+	}
+	else
+	{
+		block = (uint8_t*) audio->pMalloc(
+			ALIGNED_HEADER + FAUDIO_BUFFER_ALIGNMENT_EXT - 1 + size
+		);
+		if (block == NULL)
 		{
-			/* If we got here, we know that the new stage is
-			 * _at least_ as high as the first submix in the list.
-			 *
-			 * Each loop iteration checks to see if the new stage
-			 * is smaller than `latest->next`, meaning it fits
-			 * between `latest` and `latest->next`.
-			 */
-			while (latest->next != NULL)
-			{
-				if (toAdd->mix.processingStage < ((FAudioSubmixVoice *) latest->next->entry)->mix.processingStage)
-				{
-					newEntry->next = latest->next;
-					latest->next = newEntry;
-					break;
-				}
-				latest = latest->next;
-			}
-			/* If newEntry didn't get a `next` value, that means
-			 * it didn't fall in between any stages and `latest`
-			 * is the last entry in the list. Add it to the end!
-			 */
-			if (newEntry->next == NULL)
-			{
-				latest->next = newEntry;
-			}
+			return NULL;
 		}
+		result = (uint8_t*) (
+			((size_t) block + ALIGNED_HEADER + FAUDIO_BUFFER_ALIGNMENT_EXT - 1) &
+			~((size_t) FAUDIO_BUFFER_ALIGNMENT_EXT - 1)
+		);
 	}
-	FAudio_PlatformUnlockMutex(lock);
+	((size_t*) result)[-3] = category;
+	((void**) result)[-2] = block;
+	((size_t*) result)[-1] = size;
+	FAudio_INTERNAL_CountMemory(audio, category, (int32_t) size);
+	LOG_MEMORY(audio, "AlignedMalloc", result, size)
+	return result;
+}
+
+void FAudio_INTERNAL_AlignedFree(FAudio *audio, void *ptr)
+{
+	void *block;
+	size_t size;
+	if (ptr == NULL)
+	{
+		return;
+	}
+	block = ((void**) ptr)[-2];
+	size = ((size_t*) ptr)[-1];
+	FAudio_INTERNAL_CountMemory(
+		audio,
+		(uint32_t) ((size_t*) ptr)[-3],
+		-((int32_t) size)
+	);
+	LOG_MEMORY(audio, "AlignedFree", ptr, size)
+	if (audio->pAlignedFree != NULL)
+	{
+		audio->pAlignedFree(block);
+	}
+	else
+	{
+		audio->pFree(block);
+	}
+}
+
+#undef ALIGNED_HEADER
+
+void FAudio_INTERNAL_VoiceTableAdd(
+	FAudio *audio,
+	FAudioVoiceTable *table,
+	FAudioVoice *voice
+) {
+	if (table->count == table->capacity)
+	{
+		table->capacity = FAudio_max(16, table->capacity * 2);
+		table->voices = (FAudioVoice**) FAudio_INTERNAL_Realloc(
+			audio,
+			table->voices,
+			sizeof(FAudioVoice*) * table->capacity
+		);
+	}
+	voice->tableSlot = table->count;
+	table->voices[table->count] = voice;
+	table->count += 1;
+}
+
+void FAudio_INTERNAL_VoiceTableRemove(
+	FAudioVoiceTable *table,
+	FAudioVoice *voice
+) {
+	FAudio_assert(	voice->tableSlot < table->count &&
+			table->voices[voice->tableSlot] == voice	);
+	table->count -= 1;
+	table->voices[voice->tableSlot] = table->voices[table->count];
+	table->voices[voice->tableSlot]->tableSlot = voice->tableSlot;
+}
+
+void FAudio_INTERNAL_VoiceTableFree(FAudio *audio, FAudioVoiceTable *table)
+{
+	FAudio_INTERNAL_Free(audio, table->voices);
+	table->voices = NULL;
+	table->count = 0;
+	table->capacity = 0;
 }
 
 static uint32_t FAudio_INTERNAL_GetBytesRequested(
@@ -358,8 +843,12 @@ static uint32_t FAudio_INTERNAL_GetBytesRequested(
 	return result;
 }
 
+/* If decodeCache is NULL the buffers are only advanced, nothing is decoded.
+ * Callbacks are still fired exactly as they would be for a real decode.
+ */
 static void FAudio_INTERNAL_DecodeBuffers(
 	FAudioSourceVoice *voice,
+	float *decodeCache,
 	uint64_t *toDecode
 ) {
 	uint32_t end, endRead, decoding, decoded = 0;
@@ -379,6 +868,12 @@ static void FAudio_INTERNAL_DecodeBuffers(
 		if (voice->src.newBuffer)
 		{
 			voice->src.newBuffer = 0;
+			LOG_STREAMING(
+				voice->audio,
+				"Buffer Start",
+				buffer,
+				buffer->AudioBytes
+			);
 			if (	voice->src.callback != NULL &&
 				voice->src.callback->OnBufferStart != NULL	)
 			{
@@ -399,14 +894,17 @@ static void FAudio_INTERNAL_DecodeBuffers(
 		);
 
 		/* Decode... */
-		voice->src.decode(
-			voice,
-			buffer,
-			voice->audio->decodeCache + (
-				decoded * voice->src.format->nChannels
-			),
-			endRead
-		);
+		if (decodeCache != NULL)
+		{
+			voice->src.decode(
+				voice,
+				buffer,
+				decodeCache + (
+					decoded * voice->src.format->nChannels
+				),
+				endRead
+			);
+		}
 
 		LOG_INFO(
 			voice->audio,
@@ -417,6 +915,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 			voice->src.curBufferOffset,
 			voice->src.curBufferOffset + endRead
 		);
+		LOG_STREAMING(voice->audio, "Decode", buffer, endRead);
 
 		decoded += endRead;
 		voice->src.curBufferOffset += endRead;
@@ -446,7 +945,12 @@ static void FAudio_INTERNAL_DecodeBuffers(
 #ifdef HAVE_FFMPEG
 				if (voice->src.ffmpeg != NULL)
 				{
-					FAudio_FFMPEG_reset(voice);
+					FAudio_FFMPEG_reset(
+						voice,
+						(voice->src.bufferList->next != NULL) ?
+							&voice->src.bufferList->next->buffer :
+							NULL
+					);
 				}
 #endif /* HAVE_FFMPEG */
 				/* For EOS we can stop storing fraction offsets */
@@ -462,10 +966,22 @@ static void FAudio_INTERNAL_DecodeBuffers(
 					voice,
 					buffer
 				);
+				LOG_STREAMING(
+					voice->audio,
+					"Buffer End",
+					buffer,
+					buffer->AudioBytes
+				);
 
-				/* Change active buffer, delete finished buffer */
+				/* Change active buffer, delete finished buffer.
+				 * The data may be reused once the client hears
+				 * about it, so forget any blocks decoded from it.
+				 */
+				voice->src.adpcmCacheData = NULL;
 				toDelete = voice->src.bufferList;
+				FAudio_INTERNAL_CancelPredecode(voice->audio, toDelete);
 				voice->src.bufferList = voice->src.bufferList->next;
+				voice->src.bufferCount -= 1;
 				if (voice->src.bufferList != NULL)
 				{
 					buffer = &voice->src.bufferList->buffer;
@@ -476,19 +992,23 @@ static void FAudio_INTERNAL_DecodeBuffers(
 					buffer = NULL;
 
 					/* FIXME: I keep going past the buffer so fuck it */
-					FAudio_zero(
-						voice->audio->decodeCache + (
-							decoded *
-							voice->src.format->nChannels
-						),
-						sizeof(float) * (
-							(*toDecode - decoded) *
-							voice->src.format->nChannels
-						)
-					);
+					if (decodeCache != NULL)
+					{
+						FAudio_zero(
+							decodeCache + (
+								decoded *
+								voice->src.format->nChannels
+							),
+							sizeof(float) * (
+								(*toDecode - decoded) *
+								voice->src.format->nChannels
+							)
+						);
+					}
 				}
 
-				/* Callbacks */
+				/* Callbacks, which may well ask for the state */
+				FAudio_INTERNAL_PublishVoiceState(voice);
 				if (voice->src.callback != NULL)
 				{
 					if (voice->src.callback->OnBufferEnd != NULL)
@@ -522,13 +1042,17 @@ static void FAudio_INTERNAL_DecodeBuffers(
 					}
 				}
 
-				voice->audio->pFree(toDelete);
+				FAudio_INTERNAL_FreeBufferEntry(voice->audio, toDelete);
 			}
 		}
 	}
 
 	/* ... FIXME: I keep going past the buffer so fuck it */
-	if (buffer)
+	if (decodeCache == NULL)
+	{
+		/* Skipped, no padding needed */
+	}
+	else if (buffer)
 	{
 		end = (buffer->LoopCount > 0) ?
 			(buffer->LoopBegin + buffer->LoopLength) :
@@ -541,7 +1065,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 		voice->src.decode(
 			voice,
 			buffer,
-			voice->audio->decodeCache + (
+			decodeCache + (
 				decoded * voice->src.format->nChannels
 			),
 			endRead
@@ -551,7 +1075,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 		if (endRead < EXTRA_DECODE_PADDING)
 		{
 			FAudio_zero(
-				voice->audio->decodeCache + (
+				decodeCache + (
 					decoded * voice->src.format->nChannels
 				),
 				sizeof(float) * (
@@ -564,7 +1088,7 @@ static void FAudio_INTERNAL_DecodeBuffers(
 	else
 	{
 		FAudio_zero(
-			voice->audio->decodeCache + (
+			decodeCache + (
 				decoded * voice->src.format->nChannels
 			),
 			sizeof(float) * (
@@ -575,72 +1099,228 @@ static void FAudio_INTERNAL_DecodeBuffers(
 	}
 
 	*toDecode = decoded;
+	FAudio_INTERNAL_PublishVoiceState(voice);
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-static inline void FAudio_INTERNAL_FilterVoice(
-	FAudio *audio,
-	const FAudioFilterParameters *filter,
-	FAudioFilterState *filterState,
-	float *samples,
-	uint32_t numSamples,
-	uint16_t numChannels
-) {
-	uint32_t j, ci;
-
-	LOG_FUNC_ENTER(audio)
+/* Seqlock writer, must be called with bufferLock held so there's only ever
+ * one. The atomics are full barriers, so the fields can't leak out of the
+ * odd sequence window.
+ */
+void FAudio_INTERNAL_PublishVoiceState(FAudioSourceVoice *voice)
+{
+	FAudio_PlatformAtomicAdd(&voice->src.stateSequence, 1);
+	voice->src.stateSamplesPlayed = voice->src.totalSamples;
+	voice->src.stateBuffersQueued = voice->src.bufferCount;
+	voice->src.stateContext = (
+		voice->src.bufferList != NULL &&
+		!voice->src.newBuffer
+	) ? voice->src.bufferList->buffer.pContext : NULL;
+	FAudio_PlatformAtomicAdd(&voice->src.stateSequence, 1);
+}
 
-	/* Apply a digital state-variable filter to the voice.
-	 * The difference equations of the filter are:
-	 *
-	 * Yl(n) = F Yb(n - 1) + Yl(n - 1)
-	 * Yh(n) = x(n) - Yl(n) - OneOverQ Yb(n - 1)
-	 * Yb(n) = F Yh(n) + Yb(n - 1)
-	 * Yn(n) = Yl(n) + Yh(n)
-	 *
-	 * Please note that FAudioFilterParameters.Frequency is defined as:
-	 *
-	 * (2 * sin(pi * (desired filter cutoff frequency) / sampleRate))
-	 *
-	 * - @JohanSmet
-	 */
+/* Must be called with sendLock held */
+static void FAudio_INTERNAL_UpdateSendMatrices(FAudioVoice *voice)
+{
+	uint32_t i, ci, co, oChan, stride;
+	float baseVolume, volume;
+	FAudioVoice *out;
+	float *matrix;
+	const float *coefficients;
 
-	for (j = 0; j < numSamples; j += 1)
-	for (ci = 0; ci < numChannels; ci += 1)
+	/* Submix volume is applied to the input, not the sends */
+	baseVolume = (voice->type == FAUDIO_VOICE_SOURCE) ?
+		voice->volume :
+		1.0f;
+	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
-		filterState[ci][FAudioLowPassFilter] = filterState[ci][FAudioLowPassFilter] + (filter->Frequency * filterState[ci][FAudioBandPassFilter]);
-		filterState[ci][FAudioHighPassFilter] = samples[j * numChannels + ci] - filterState[ci][FAudioLowPassFilter] - (filter->OneOverQ * filterState[ci][FAudioBandPassFilter]);
-		filterState[ci][FAudioBandPassFilter] = (filter->Frequency * filterState[ci][FAudioHighPassFilter]) + filterState[ci][FAudioBandPassFilter];
-		filterState[ci][FAudioNotchFilter] = filterState[ci][FAudioHighPassFilter] + filterState[ci][FAudioLowPassFilter];
-		samples[j * numChannels + ci] = filterState[ci][filter->Type];
-	}
-
-	LOG_FUNC_EXIT(audio)
-}
-
-static inline float *FAudio_INTERNAL_ProcessEffectChain(
+		out = voice->sends.pSends[i].pOutputVoice;
+		oChan = (out->type == FAUDIO_VOICE_MASTER) ?
+			out->master.inputChannels :
+			out->mix.inputChannels;
+		stride = MIX_MATRIX_STRIDE(oChan);
+		matrix = voice->sendMatrix[i];
+		coefficients = voice->sendCoefficients[i];
+		for (ci = 0; ci < voice->outputChannels; ci += 1)
+		{
+			volume = voice->mixChannelVolume[ci] * baseVolume;
+			for (co = 0; co < oChan; co += 1)
+			{
+				matrix[ci * stride + co] = (
+					coefficients[co * voice->outputChannels + ci] *
+					volume
+				);
+			}
+			for (; co < stride; co += 1)
+			{
+				matrix[ci * stride + co] = 0.0f;
+			}
+		}
+	}
+}
+
+/* Must be called with sendLock held */
+static inline void FAudio_INTERNAL_UpdateMixParameters(FAudioVoice *voice)
+{
+	/* The flags are read without locking. If we miss a write we will
+	 * just pick it up on the next pass.
+	 */
+	if (voice->filterUpdate)
+	{
+		FAudio_PlatformLockMutex(voice->filterLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->filterLock)
+		voice->mixFilter = voice->filter;
+		voice->filterUpdate = 0;
+		FAudio_PlatformUnlockMutex(voice->filterLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->filterLock)
+	}
+	if (voice->channelVolumeUpdate)
+	{
+		FAudio_PlatformLockMutex(voice->volumeLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
+		FAudio_memcpy(
+			voice->mixChannelVolume,
+			voice->channelVolume,
+			sizeof(float) * voice->outputChannels
+		);
+		voice->channelVolumeUpdate = 0;
+		FAudio_PlatformUnlockMutex(voice->volumeLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
+		voice->sendMatrixUpdate = 1;
+	}
+	if (voice->sendMatrixUpdate)
+	{
+		/* Clear first, so a SetVolume during the rebuild isn't lost */
+		voice->sendMatrixUpdate = 0;
+		FAudio_INTERNAL_UpdateSendMatrices(voice);
+	}
+}
+
+/* Must be called with sendLock held */
+static uint8_t FAudio_INTERNAL_IsVoiceAudible(FAudioVoice *voice)
+{
+	uint32_t i, j, oChan;
+	FAudioVoice *out;
+
+	/* Effects keep their own state and may have tails, never skip them */
+	if (voice->effects.count > 0)
+	{
+		return 1;
+	}
+	if (voice->volume == 0.0f)
+	{
+		return 0;
+	}
+	for (i = 0; i < voice->sends.SendCount; i += 1)
+	{
+		out = voice->sends.pSends[i].pOutputVoice;
+
+		/* Submix/master volume is applied before their effects */
+		if (out->volume == 0.0f)
+		{
+			continue;
+		}
+		oChan = (out->type == FAUDIO_VOICE_MASTER) ?
+			out->master.inputChannels :
+			out->mix.inputChannels;
+		for (j = 0; j < voice->outputChannels * MIX_MATRIX_STRIDE(oChan); j += 1)
+		{
+			if (voice->sendMatrix[i][j] != 0.0f)
+			{
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/* Must be called with sendLock held. For GovernorEXT, a voice is quiet when
+ * no send coefficient, with the volume of the voice it goes to, reaches
+ * quietVolume. The source volume is already in the send matrix.
+ */
+static uint8_t FAudio_INTERNAL_IsVoiceQuiet(
 	FAudioVoice *voice,
-	float *buffer,
-	uint32_t *samples
+	float quietVolume
+) {
+	uint32_t i, j, oChan;
+	FAudioVoice *out;
+
+	for (i = 0; i < voice->sends.SendCount; i += 1)
+	{
+		out = voice->sends.pSends[i].pOutputVoice;
+		oChan = (out->type == FAUDIO_VOICE_MASTER) ?
+			out->master.inputChannels :
+			out->mix.inputChannels;
+		for (j = 0; j < voice->outputChannels * MIX_MATRIX_STRIDE(oChan); j += 1)
+		{
+			if (FAudio_fabsf(voice->sendMatrix[i][j] * out->volume) >= quietVolume)
+			{
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/* Must be called with sendLock held */
+static void FAudio_INTERNAL_ResetFilterState(
+	FAudioVoice *voice,
+	uint32_t inputChannels
 ) {
 	uint32_t i;
+	FAudioVoice *out;
+
+	if (!(voice->flags & FAUDIO_VOICE_USEFILTER))
+	{
+		return;
+	}
+	FAudio_zero(
+		voice->filterState,
+		sizeof(FAudioFilterState) * inputChannels
+	);
+	for (i = 0; i < voice->sends.SendCount; i += 1)
+	{
+		out = voice->sends.pSends[i].pOutputVoice;
+		FAudio_zero(
+			voice->sendFilterState[i],
+			sizeof(FAudioFilterState) * (
+				(out->type == FAUDIO_VOICE_MASTER) ?
+					out->master.inputChannels :
+					out->mix.inputChannels
+			)
+		);
+	}
+}
+
+/* If *silent is set the input is known to be zero and is passed to the chain
+ * as FAPO_BUFFER_SILENT without checking it. On return *silent is set only if
+ * the input was silent and the chain reported its output as silent too.
+ */
+static inline float *FAudio_INTERNAL_ProcessEffectChain(
+	FAudioVoice *voice,
+	float *buffer,
+	uint32_t channels,
+	uint32_t *samples,
+	uint8_t *silent
+) {
+	uint32_t i, next;
 	FAPO *fapo;
 	FAPOProcessBufferParameters srcParams, dstParams;
+	const uint8_t meterSkip = (
+		voice->audio->governorLevel >= FAUDIO_GOVERNOR_METER_EXT &&
+		(voice->audio->governorPass % voice->audio->governorMeterDecimation) != 0
+	);
+	PROFILE_STAMP
 
 	LOG_FUNC_ENTER(voice->audio)
 
 	/* Set up the buffer to be written into */
 	srcParams.pBuffer = buffer;
-	srcParams.BufferFlags = FAPO_BUFFER_SILENT;
+	srcParams.BufferFlags = (
+		*silent ||
+		FAudio_INTERNAL_IsSilent(buffer, *samples * channels)
+	) ? FAPO_BUFFER_SILENT : FAPO_BUFFER_VALID;
 	srcParams.ValidFrameCount = *samples;
-	for (i = 0; i < srcParams.ValidFrameCount; i += 1)
-	{
-		if (buffer[i] != 0.0f) /* Arbitrary! */
-		{
-			srcParams.BufferFlags = FAPO_BUFFER_VALID;
-			break;
-		}
-	}
 
 	/* Initialize output parameters to something sane */
 	dstParams.pBuffer = srcParams.pBuffer;
@@ -648,29 +1328,20 @@ static inline float *FAudio_INTERNAL_ProcessEffectChain(
 	dstParams.ValidFrameCount = srcParams.ValidFrameCount;
 
 	/* Update parameters, process! */
+	next = 0;
+	PROFILE_START(voice)
 	for (i = 0; i < voice->effects.count; i += 1)
 	{
 		fapo = voice->effects.desc[i].pEffect;
 
+		/* Effects write every frame they output, so there's no need
+		 * to clear the buffer first. Silent output may be left as it
+		 * was though, and is cleared after the fact.
+		 */
 		if (!voice->effects.inPlaceProcessing[i])
 		{
-			if (dstParams.pBuffer == buffer)
-			{
-				FAudio_INTERNAL_ResizeEffectChainCache(
-					voice->audio,
-					voice->effects.desc[i].OutputChannels * voice->audio->updateSize
-				);
-				dstParams.pBuffer = voice->audio->effectChainCache;
-			}
-			else
-			{
-				dstParams.pBuffer = buffer;
-			}
-
-			FAudio_zero(
-				dstParams.pBuffer,
-				voice->effects.desc[i].OutputChannels * voice->audio->updateSize * sizeof(float)
-			);
+			dstParams.pBuffer = voice->effects.buffers[next];
+			next ^= 1;
 		}
 
 		if (voice->effects.parameterUpdates[i])
@@ -683,6 +1354,17 @@ static inline float *FAudio_INTERNAL_ProcessEffectChain(
 			voice->effects.parameterUpdates[i] = 0;
 		}
 
+		/* Meters work in place and leave the buffer alone, so a
+		 * governed pass can skip them outright
+		 */
+		if (	meterSkip &&
+			voice->effects.inPlaceProcessing[i] &&
+			FAudioFX_INTERNAL_IsVolumeMeter(fapo)	)
+		{
+			FAudio_memcpy(&srcParams, &dstParams, sizeof(dstParams));
+			continue;
+		}
+
 		fapo->Process(
 			fapo,
 			1,
@@ -691,18 +1373,239 @@ static inline float *FAudio_INTERNAL_ProcessEffectChain(
 			&dstParams,
 			voice->effects.desc[i].InitialState
 		);
+		PROFILE_LAP(voice, voice->effects.cycles[i])
+
+		if (	!voice->effects.inPlaceProcessing[i] &&
+			dstParams.BufferFlags == FAPO_BUFFER_SILENT	)
+		{
+			FAudio_zero(
+				dstParams.pBuffer,
+				voice->effects.desc[i].OutputChannels * dstParams.ValidFrameCount * sizeof(float)
+			);
+		}
 
 		FAudio_memcpy(&srcParams, &dstParams, sizeof(dstParams));
 	}
 
 	*samples = dstParams.ValidFrameCount;
+	*silent = *silent && (dstParams.BufferFlags == FAPO_BUFFER_SILENT);
 
 	LOG_FUNC_EXIT(voice->audio)
 	return (float*) dstParams.pBuffer;
 }
 
-static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
-{
+static inline float *FAudio_INTERNAL_GetSendStream(
+	FAudioMixWorker *worker,
+	FAudioVoice *out,
+	uint32_t *oChan
+) {
+	if (out->type == FAUDIO_VOICE_MASTER)
+	{
+		*oChan = out->master.inputChannels;
+		if (worker->index == 0)
+		{
+			return out->master.output;
+		}
+		worker->masterDirty = 1;
+		return worker->masterOutput;
+	}
+	*oChan = out->mix.inputChannels;
+	if (worker->index == 0)
+	{
+		out->mix.inputActive = 1;
+		return out->mix.inputCache;
+	}
+	if (	out->mix.mixSlot >= worker->audio->mixSubmixCount ||
+		worker->audio->mixSubmixes[out->mix.mixSlot] != out	)
+	{
+		/* Topology changed mid-pass, this gets picked up next pass */
+		return NULL;
+	}
+	worker->submixDirty[out->mix.mixSlot] = 1;
+	return worker->submixOutput[out->mix.mixSlot];
+}
+
+/* Sends into a folded submix go to its parent instead, with the bus gain
+ * applied to the send's matrix in scratch, which holds a full 8x8 matrix.
+ */
+static inline const float *FAudio_INTERNAL_ResolveSend(
+	FAudioVoice *voice,
+	uint32_t send,
+	FAudioVoice **out,
+	float *scratch
+) {
+	uint32_t i, count;
+	FAudioVoice *bus = voice->sends.pSends[send].pOutputVoice;
+
+	*out = bus;
+	if (bus->type != FAUDIO_VOICE_SUBMIX || bus->mix.foldTarget == NULL)
+	{
+		return voice->sendMatrix[send];
+	}
+	count = voice->outputChannels * MIX_MATRIX_STRIDE(bus->mix.inputChannels);
+	for (i = 0; i < count; i += 1)
+	{
+		scratch[i] = voice->sendMatrix[send][i] * bus->mix.foldGain;
+	}
+	*out = bus->mix.foldTarget;
+	return scratch;
+}
+
+/* Passes longer than the sub-block size go through the filter and sends in
+ * sub-blocks, see SubBlockMixEXT. Effects want whole passes, so voices with an
+ * effect chain don't.
+ */
+static inline uint8_t FAudio_INTERNAL_UseSubBlocks(
+	FAudioSourceVoice *voice,
+	uint32_t subBlockFrames,
+	uint64_t frames
+) {
+	return (	subBlockFrames > 0 &&
+			frames > subBlockFrames &&
+			voice->effects.count == 0	);
+}
+
+/* For resamples put off until the sends: resamples frames output frames,
+ * starting offset frames into a pass that began at resample offset start.
+ */
+static inline void FAudio_INTERNAL_ResampleDeferred(
+	FAudioSourceVoice *voice,
+	float *decodeCache,
+	float *output,
+	uint64_t start,
+	uint32_t offset,
+	uint32_t frames
+) {
+	const uint32_t channels = voice->src.format->nChannels;
+	uint64_t cur = (
+		(start & FIXED_FRACTION_MASK) +
+		offset * voice->src.resampleStep
+	);
+	float *input = decodeCache + (cur >> FIXED_PRECISION) * channels;
+
+	/* The sinc history always holds the frames before input, since the
+	 * previous block saved the ones before where it stopped.
+	 */
+	if (voice->src.resampleHistory != NULL)
+	{
+		FAudio_INTERNAL_ResampleSinc(
+			voice->src.resampleHistory,
+			input,
+			output,
+			&cur,
+			voice->src.resampleStep,
+			frames,
+			(uint8_t) channels
+		);
+	}
+	else
+	{
+		voice->src.resample(
+			input,
+			output,
+			&cur,
+			voice->src.resampleStep,
+			frames,
+			(uint8_t) channels
+		);
+	}
+}
+
+/* Must be called with sendLock held. mixCache is NULL if the pass still has
+ * to be resampled from the decode cache, which is then done a sub-block at a
+ * time along with the rest, so each one stays in cache on its way through.
+ */
+static void FAudio_INTERNAL_MixSourceSubBlocks(
+	FAudioSourceVoice *voice,
+	FAudioMixWorker *worker,
+	float *mixCache,
+	uint64_t resampleStart,
+	uint32_t mixed,
+	uint32_t subBlockFrames,
+	uint8_t filterSends
+) {
+	uint32_t block, count, i, oChan;
+	float *input, *stream;
+	FAudioVoice *out;
+	const float *matrix;
+	float foldMatrix[8 * 8];
+	const uint32_t channels = voice->src.format->nChannels;
+	PROFILE_STAMP
+
+	PROFILE_START(voice)
+	for (block = 0; block < mixed; block += count)
+	{
+		count = FAudio_min(subBlockFrames, mixed - block);
+
+		if (mixCache == NULL)
+		{
+			input = worker->resampleCache;
+			FAudio_INTERNAL_ResampleDeferred(
+				voice,
+				worker->decodeCache,
+				input,
+				resampleStart,
+				block,
+				count
+			);
+			PROFILE_LAP(voice, voice->profile.ResampleCycles)
+		}
+		else
+		{
+			input = mixCache + block * channels;
+		}
+
+		if (voice->flags & FAUDIO_VOICE_USEFILTER)
+		{
+			FAudio_INTERNAL_FilterVoice(
+				&voice->mixFilter,
+				voice->filterState,
+				input,
+				count,
+				channels
+			);
+			PROFILE_LAP(voice, voice->profile.FilterCycles)
+		}
+
+		for (i = 0; i < voice->sends.SendCount; i += 1)
+		{
+			matrix = FAudio_INTERNAL_ResolveSend(voice, i, &out, foldMatrix);
+			stream = FAudio_INTERNAL_GetSendStream(worker, out, &oChan);
+			if (stream == NULL)
+			{
+				continue;
+			}
+			stream += block * oChan;
+
+			voice->sendMix[i](
+				count,
+				voice->outputChannels,
+				oChan,
+				input,
+				stream,
+				matrix
+			);
+			PROFILE_LAP(voice, voice->profile.SendCycles)
+
+			if (filterSends)
+			{
+				FAudio_INTERNAL_FilterVoice(
+					&voice->sendFilter[i],
+					voice->sendFilterState[i],
+					stream,
+					count,
+					oChan
+				);
+				PROFILE_LAP(voice, voice->profile.FilterCycles)
+			}
+		}
+	}
+}
+
+static void FAudio_INTERNAL_MixSource(
+	FAudioSourceVoice *voice,
+	FAudioMixWorker *worker
+) {
 	/* Iterators */
 	uint32_t i;
 	/* Decode/Resample variables */
@@ -713,22 +1616,77 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	uint32_t mixed;
 	uint32_t oChan;
 	FAudioVoice *out;
+	const float *matrix;
+	float foldMatrix[8 * 8];
 	uint32_t outputRate;
 	double stepd;
 	float *effectOut;
+	uint8_t audible, silent;
+	/* GovernorEXT variables */
+	uint8_t quiet, nearest, filterSends;
+	/* Deferred resample variables */
+	uint64_t resampleStart;
+	uint8_t fused, deferred;
+	uint32_t subBlockFrames;
+	float *mixCache;
+	/* Zero-copy decode variables */
+	float *decoded;
+	FAudioBuffer *buffer;
+	uint32_t end;
+	PROFILE_STAMP
 
 	LOG_FUNC_ENTER(voice->audio)
+	PROFILE_START(voice)
+
+	FAudio_PlatformLockMutex(voice->sendLock);
+	LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
+
+	/* Inaudible voices still move through their buffers, but skip the
+	 * decode/resample/mix work. Their filters restart from silence.
+	 */
+	FAudio_INTERNAL_UpdateMixParameters(voice);
+	audible = FAudio_INTERNAL_IsVoiceAudible(voice);
+	if (!audible && !voice->culled)
+	{
+		FAudio_INTERNAL_ResetFilterState(
+			voice,
+			voice->src.format->nChannels
+		);
+		if (voice->src.resampleHistory != NULL)
+		{
+			FAudio_zero(
+				voice->src.resampleHistory,
+				sizeof(float) *
+				SINC_HISTORY_FRAMES *
+				voice->src.format->nChannels
+			);
+		}
+	}
+	voice->culled = !audible;
+
+	/* Under load, quiet voices give up some quality first. Sinc voices
+	 * keep their resampler, as their history would go stale.
+	 */
+	quiet = (
+		audible &&
+		voice->audio->governorLevel >= FAUDIO_GOVERNOR_RESAMPLE_EXT &&
+		FAudio_INTERNAL_IsVoiceQuiet(
+			voice,
+			voice->audio->governorQuietVolume
+		)
+	);
+	nearest = quiet && voice->src.resampleHistory == NULL;
+	filterSends = (
+		(voice->flags & FAUDIO_VOICE_USEFILTER) &&
+		!(quiet && voice->audio->governorLevel >= FAUDIO_GOVERNOR_SEND_FILTER_EXT)
+	);
 
 	/* Calculate the resample stepping value */
 	if (voice->src.resampleFreq != voice->src.freqRatio * voice->src.format->nSamplesPerSec)
 	{
-		FAudio_PlatformLockMutex(voice->sendLock);
-		LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
 		out = (voice->sends.SendCount == 0) ?
 			voice->audio->master : /* Barf */
 			voice->sends.pSends->pOutputVoice;
-		FAudio_PlatformUnlockMutex(voice->sendLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 		outputRate = (out->type == FAUDIO_VOICE_MASTER) ?
 			out->master.inputSampleRate :
 			out->mix.inputSampleRate;
@@ -741,14 +1699,27 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 		voice->src.resampleFreq = voice->src.freqRatio * voice->src.format->nSamplesPerSec;
 	}
 
+	FAudio_PlatformUnlockMutex(voice->sendLock);
+	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+
+	fused = 0;
+	deferred = 0;
+	resampleStart = 0;
+	mixCache = worker->resampleCache;
 	if (voice->src.active == 2)
 	{
 		/* We're just playing tails, skip all buffer stuff */
+		if (!audible)
+		{
+			LOG_FUNC_EXIT(voice->audio)
+			return;
+		}
 		mixed = voice->src.resampleSamples;
 		FAudio_zero(
-			voice->audio->resampleCache,
+			worker->resampleCache,
 			mixed * voice->src.format->nChannels * sizeof(float)
 		);
+		silent = 1;
 		goto sendwork;
 	}
 
@@ -789,7 +1760,42 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	}
 
 	/* Decode... */
-	FAudio_INTERNAL_DecodeBuffers(voice, &toDecode);
+#ifdef HAVE_FFMPEG
+	/* FFmpeg decoding is stateful, it can't be skipped */
+	if (voice->src.ffmpeg != NULL)
+	{
+		audible = 1;
+	}
+#endif /* HAVE_FFMPEG */
+	decoded = worker->decodeCache;
+	if (	audible &&
+		voice->src.decode == FAudio_INTERNAL_DecodePCM32F &&
+		voice->src.resampleStep != FIXED_ONE	)
+	{
+		/* Float PCM is already what the resampler wants. If this pass
+		 * and its padding all come from one stretch of the buffer, read
+		 * the client data in place instead of copying it. The resampler
+		 * runs before bufferLock is released, so nothing reads it after
+		 * the buffer could be returned. 1:1 voices keep the copy, since
+		 * they mix and filter the decoded samples after the unlock.
+		 */
+		buffer = &voice->src.bufferList->buffer;
+		end = (buffer->LoopCount > 0) ?
+			(buffer->LoopBegin + buffer->LoopLength) :
+			buffer->PlayBegin + buffer->PlayLength;
+		if (voice->src.curBufferOffset + toDecode + EXTRA_DECODE_PADDING <= end)
+		{
+			decoded = ((float*) buffer->pAudioData) + (
+				voice->src.curBufferOffset *
+				voice->src.format->nChannels
+			);
+		}
+	}
+	FAudio_INTERNAL_DecodeBuffers(
+		voice,
+		(audible && decoded == worker->decodeCache) ? decoded : NULL,
+		&toDecode
+	);
 
 	/* Okay, we're done messing with client data */
 	if (	voice->src.callback != NULL &&
@@ -799,6 +1805,7 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 			voice->src.callback
 		);
 	}
+	PROFILE_LAP(voice, voice->profile.DecodeCycles)
 
 	/* Nothing to resample? */
 	if (toDecode == 0)
@@ -823,31 +1830,88 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	toResample = FAudio_min(toResample, voice->src.resampleSamples);
 
 	/* Resample... */
-	if (voice->src.resampleStep == FIXED_ONE)
+	if (!audible)
 	{
-		/* Actually, just copy directly... */
-		FAudio_memcpy(
-			voice->audio->resampleCache,
-			voice->audio->decodeCache,
-			(size_t) toResample * voice->src.format->nChannels * sizeof(float)
-		);
+		/* ... or don't, nobody is going to hear it anyway */
+		voice->src.resampleOffset += toResample * voice->src.resampleStep;
 	}
-	else
+	else if (	voice->src.resampleHistory == NULL &&
+			voice->src.resampleStep != FIXED_ONE &&
+			voice->src.format->nChannels == 1 &&
+			decoded == worker->decodeCache &&
+			!nearest &&
+			!(voice->flags & (
+				FAUDIO_VOICE_USEFILTER |
+				FAUDIO_VOICE_RESAMPLE_NEAREST_EXT
+			))	)
 	{
-		voice->src.resample(
-			voice->audio->decodeCache,
-			voice->audio->resampleCache,
+		/* ... later, straight into the send if we still can */
+		fused = 1;
+		resampleStart = voice->src.resampleOffset;
+		voice->src.resampleOffset += toResample * voice->src.resampleStep;
+	}
+	else if (	decoded == worker->decodeCache &&
+			!nearest &&
+			(	voice->src.resampleHistory != NULL ||
+				voice->src.resampleStep != FIXED_ONE	) &&
+			FAudio_INTERNAL_UseSubBlocks(
+				voice,
+				voice->audio->subBlockFrames,
+				toResample
+			)	)
+	{
+		/* ... later, a sub-block at a time along with the sends */
+		deferred = 1;
+		resampleStart = voice->src.resampleOffset;
+		voice->src.resampleOffset += toResample * voice->src.resampleStep;
+	}
+	else if (voice->src.resampleHistory != NULL)
+	{
+		/* ... always, even at 1:1, or the sinc delay would jump ... */
+		FAudio_INTERNAL_ResampleSinc(
+			voice->src.resampleHistory,
+			decoded,
+			worker->resampleCache,
 			&voice->src.resampleOffset,
 			voice->src.resampleStep,
 			toResample,
 			(uint8_t) voice->src.format->nChannels
 		);
 	}
-
-	/* Update buffer offsets */
-	if (voice->src.bufferList != NULL)
+	else if (voice->src.resampleStep == FIXED_ONE)
 	{
-		/* Increment fixed offset by resample size, int to fixed... */
+		/* Actually, just mix the decoded samples directly... */
+		mixCache = worker->decodeCache;
+	}
+	else if (nearest)
+	{
+		/* ... cheaply, since it's too quiet to tell ... */
+		FAudio_INTERNAL_ResampleNearest(
+			decoded,
+			worker->resampleCache,
+			&voice->src.resampleOffset,
+			voice->src.resampleStep,
+			toResample,
+			(uint8_t) voice->src.format->nChannels
+		);
+	}
+	else
+	{
+		voice->src.resample(
+			decoded,
+			worker->resampleCache,
+			&voice->src.resampleOffset,
+			voice->src.resampleStep,
+			toResample,
+			(uint8_t) voice->src.format->nChannels
+		);
+	}
+	PROFILE_LAP(voice, voice->profile.ResampleCycles)
+
+	/* Update buffer offsets */
+	if (voice->src.bufferList != NULL)
+	{
+		/* Increment fixed offset by resample size, int to fixed... */
 		voice->src.curBufferOffsetDec += toResample * voice->src.resampleStep;
 		/* ... chop off any ints we got from the above increment */
 		voice->src.curBufferOffsetDec &= FIXED_FRACTION_MASK;
@@ -865,14 +1929,45 @@ static void FAudio_INTERNAL_MixSource(FAudioSourceVoice *voice)
 	{
 		voice->src.curBufferOffsetDec = 0;
 		voice->src.curBufferOffset = 0;
+
+		/* Ran dry, whatever is queued next starts from silence */
+		if (voice->src.resampleHistory != NULL)
+		{
+			/* ... once this pass is done with the history */
+			if (deferred)
+			{
+				FAudio_INTERNAL_ResampleDeferred(
+					voice,
+					worker->decodeCache,
+					worker->resampleCache,
+					resampleStart,
+					0,
+					(uint32_t) toResample
+				);
+				deferred = 0;
+			}
+			FAudio_zero(
+				voice->src.resampleHistory,
+				sizeof(float) *
+				SINC_HISTORY_FRAMES *
+				voice->src.format->nChannels
+			);
+		}
 	}
 
 	/* Done with buffers, finally. */
 	FAudio_PlatformUnlockMutex(voice->src.bufferLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->src.bufferLock)
+	if (!audible)
+	{
+		LOG_FUNC_EXIT(voice->audio)
+		return;
+	}
 	mixed = (uint32_t) toResample;
+	silent = 0;
 
 sendwork:
+	PROFILE_FRAMES(voice, mixed)
 	FAudio_PlatformLockMutex(voice->sendLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
 
@@ -885,341 +1980,1723 @@ sendwork:
 		return;
 	}
 
+	/* A lone send with no effects can take the decoded samples directly,
+	 * resampling and mixing them in one pass. Otherwise, resample below.
+	 */
+	if (fused)
+	{
+		if (voice->effects.count == 0 && voice->sends.SendCount == 1)
+		{
+			matrix = FAudio_INTERNAL_ResolveSend(voice, 0, &out, foldMatrix);
+			stream = FAudio_INTERNAL_GetSendStream(worker, out, &oChan);
+			if (stream != NULL)
+			{
+				FAudio_INTERNAL_ResampleMixMono(
+					worker->decodeCache,
+					resampleStart,
+					voice->src.resampleStep,
+					mixed,
+					oChan,
+					stream,
+					matrix
+				);
+			}
+			PROFILE_LAP(voice, voice->profile.SendCycles)
+			FAudio_PlatformUnlockMutex(voice->sendLock);
+			LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+			LOG_FUNC_EXIT(voice->audio)
+			return;
+		}
+		deferred = 1;
+	}
+
+	/* Long passes with no effects do the rest in sub-blocks... */
+	subBlockFrames = voice->audio->subBlockFrames;
+	if (!silent && FAudio_INTERNAL_UseSubBlocks(voice, subBlockFrames, mixed))
+	{
+		FAudio_INTERNAL_MixSourceSubBlocks(
+			voice,
+			worker,
+			deferred ? NULL : mixCache,
+			resampleStart,
+			mixed,
+			subBlockFrames,
+			filterSends
+		);
+		FAudio_PlatformUnlockMutex(voice->sendLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+		LOG_FUNC_EXIT(voice->audio)
+		return;
+	}
+
+	/* ... everything else catches up on the resample now */
+	if (deferred)
+	{
+		FAudio_INTERNAL_ResampleDeferred(
+			voice,
+			worker->decodeCache,
+			worker->resampleCache,
+			resampleStart,
+			0,
+			mixed
+		);
+		PROFILE_LAP(voice, voice->profile.ResampleCycles)
+	}
+
 	/* Filters */
 	if (voice->flags & FAUDIO_VOICE_USEFILTER)
 	{
-		FAudio_PlatformLockMutex(voice->filterLock);
-		LOG_MUTEX_LOCK(voice->audio, voice->filterLock)
 		FAudio_INTERNAL_FilterVoice(
-			voice->audio,
-			&voice->filter,
+			&voice->mixFilter,
 			voice->filterState,
-			voice->audio->resampleCache,
+			mixCache,
 			mixed,
 			voice->src.format->nChannels
 		);
-		FAudio_PlatformUnlockMutex(voice->filterLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->filterLock)
+		PROFILE_LAP(voice, voice->profile.FilterCycles)
 	}
 
 	/* Process effect chain */
-	effectOut = voice->audio->resampleCache;
-	FAudio_PlatformLockMutex(voice->effectLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
+	effectOut = mixCache;
 	if (voice->effects.count > 0)
 	{
-		effectOut = FAudio_INTERNAL_ProcessEffectChain(
-			voice,
-			voice->audio->resampleCache,
-			&mixed
-		);
+		/* Checked again under the lock, SetEffectChain may race us */
+		FAudio_PlatformLockMutex(voice->effectLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
+		if (voice->effects.count > 0)
+		{
+			effectOut = FAudio_INTERNAL_ProcessEffectChain(
+				voice,
+				mixCache,
+				voice->src.format->nChannels,
+				&mixed,
+				&silent
+			);
+		}
+		FAudio_PlatformUnlockMutex(voice->effectLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
+		PROFILE_LAP(voice, voice->profile.EffectCycles)
+	}
+
+	/* Tails have finished ringing out, nothing left to send */
+	if (silent)
+	{
+		FAudio_PlatformUnlockMutex(voice->sendLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
+		LOG_FUNC_EXIT(voice->audio)
+		return;
 	}
-	FAudio_PlatformUnlockMutex(voice->effectLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
 
 	/* Send float cache to sends */
-	FAudio_PlatformLockMutex(voice->volumeLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
 	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
-		out = voice->sends.pSends[i].pOutputVoice;
-		if (out->type == FAUDIO_VOICE_MASTER)
-		{
-			stream = out->master.output;
-			oChan = out->master.inputChannels;
-		}
-		else
+		matrix = FAudio_INTERNAL_ResolveSend(voice, i, &out, foldMatrix);
+		stream = FAudio_INTERNAL_GetSendStream(worker, out, &oChan);
+		if (stream == NULL)
 		{
-			stream = out->mix.inputCache;
-			oChan = out->mix.inputChannels;
+			continue;
 		}
 
 		voice->sendMix[i](
 			mixed,
 			voice->outputChannels,
 			oChan,
-			voice->volume,
 			effectOut,
 			stream,
-			voice->channelVolume,
-			voice->sendCoefficients[i]
+			matrix
 		);
+		PROFILE_LAP(voice, voice->profile.SendCycles)
 
-		if (voice->flags & FAUDIO_VOICE_USEFILTER)
+		if (filterSends)
 		{
 			FAudio_INTERNAL_FilterVoice(
-				voice->audio,
 				&voice->sendFilter[i],
 				voice->sendFilterState[i],
 				stream,
 				mixed,
 				oChan
 			);
+			PROFILE_LAP(voice, voice->profile.FilterCycles)
 		}
 	}
-	FAudio_PlatformUnlockMutex(voice->volumeLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
 
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-static void FAudio_INTERNAL_MixSubmix(FAudioSubmixVoice *voice)
-{
+/* Passes of silent input before a submix's resampler is assumed flushed */
+#define FAUDIO_SUBMIX_SILENT_PASSES 2
+
+static void FAudio_INTERNAL_MixSubmix(
+	FAudioSubmixVoice *voice,
+	FAudioMixWorker *worker
+) {
 	uint32_t i;
 	float *stream;
 	uint32_t oChan;
 	FAudioVoice *out;
+	const float *matrix;
+	float foldMatrix[8 * 8];
 	uint32_t resampled;
 	float *effectOut;
+	uint8_t audible, silent;
+	PROFILE_STAMP
+
+	/* Folded into the parent, our inputs have already mixed into it */
+	if (voice->mix.foldTarget != NULL)
+	{
+		return;
+	}
 
 	LOG_FUNC_ENTER(voice->audio)
+	PROFILE_START(voice)
 	FAudio_PlatformLockMutex(voice->sendLock);
 	LOG_MUTEX_LOCK(voice->audio, voice->sendLock)
 
+	/* Count how long our input has been silent. Once the resampler has
+	 * had time to flush, the whole pass is known to be zero.
+	 */
+	if (voice->mix.inputActive)
+	{
+		voice->mix.inputActive = 0;
+		voice->mix.silentPasses = 0;
+	}
+	else if (voice->mix.silentPasses < FAUDIO_SUBMIX_SILENT_PASSES)
+	{
+		voice->mix.silentPasses += 1;
+	}
+	silent = (voice->mix.silentPasses == FAUDIO_SUBMIX_SILENT_PASSES);
+
 	/* Nothing to do? */
 	if (voice->sends.SendCount == 0)
 	{
 		goto end;
 	}
 
-	/* Resample (if necessary) */
-	resampled = FAudio_PlatformResample(
-		voice->mix.resampler,
-		voice->mix.inputCache,
-		voice->mix.inputSamples,
-		voice->audio->resampleCache,
-		voice->mix.outputSamples * voice->mix.inputChannels
-	);
+	FAudio_INTERNAL_UpdateMixParameters(voice);
+	audible = FAudio_INTERNAL_IsVoiceAudible(voice);
+	if (silent || !audible)
+	{
+		if (!voice->culled)
+		{
+			FAudio_INTERNAL_ResetFilterState(
+				voice,
+				voice->mix.inputChannels
+			);
+			FAudio_zero(
+				voice->mix.resampleHistory,
+				sizeof(float) * voice->mix.inputChannels
+			);
+		}
+		voice->culled = 1;
+		if (voice->effects.count == 0)
+		{
+			/* Nothing to hear and nothing to ring out, skip it */
+			goto end;
+		}
+	}
+	else
+	{
+		voice->culled = 0;
+	}
 
-	/* Submix overall volume is applied _before_ effects/filters, blech! */
-	if (voice->volume != 1.0f)
+	/* Resample (if necessary) */
+	if (silent)
 	{
-		FAudio_INTERNAL_Amplify(
-			voice->audio->resampleCache,
-			resampled,
-			voice->volume
+		/* The resampler has nothing left, feed the chain silence */
+		resampled = voice->mix.outputSamples * voice->mix.inputChannels;
+		FAudio_zero(
+			worker->resampleCache,
+			sizeof(float) * resampled
+		);
+	}
+	else if (voice->mix.resampleStep == FIXED_ONE)
+	{
+		resampled = voice->mix.outputSamples * voice->mix.inputChannels;
+		FAudio_memcpy(
+			worker->resampleCache,
+			voice->mix.inputCache,
+			sizeof(float) * resampled
+		);
+	}
+	else
+	{
+		FAudio_INTERNAL_ResampleFixed(
+			voice->mix.resampleHistory,
+			voice->mix.inputCache,
+			voice->mix.inputSamples / voice->mix.inputChannels,
+			worker->resampleCache,
+			voice->mix.outputSamples,
+			voice->mix.resampleStep,
+			voice->mix.inputChannels
 		);
+		resampled = voice->mix.outputSamples * voice->mix.inputChannels;
 	}
+
+	/* Submix overall volume is applied _before_ effects/filters, blech!
+	 * The sends mix without clamping, so this is also where the input gets
+	 * clamped, even when the volume is 1.0f.
+	 */
+	FAudio_INTERNAL_Amplify(
+		worker->resampleCache,
+		resampled,
+		voice->volume
+	);
 	resampled /= voice->mix.inputChannels;
+	PROFILE_LAP(voice, voice->profile.ResampleCycles)
+	PROFILE_FRAMES(voice, resampled)
 
 	/* Filters */
 	if (voice->flags & FAUDIO_VOICE_USEFILTER)
 	{
-		FAudio_PlatformLockMutex(voice->filterLock);
-		LOG_MUTEX_LOCK(voice->audio, voice->filterLock)
 		FAudio_INTERNAL_FilterVoice(
-			voice->audio,
-			&voice->filter,
+			&voice->mixFilter,
 			voice->filterState,
-			voice->audio->resampleCache,
+			worker->resampleCache,
 			resampled,
 			voice->mix.inputChannels
 		);
-		FAudio_PlatformUnlockMutex(voice->filterLock);
-		LOG_MUTEX_UNLOCK(voice->audio, voice->filterLock)
+		PROFILE_LAP(voice, voice->profile.FilterCycles)
 	}
 
 	/* Process effect chain */
-	effectOut = voice->audio->resampleCache;
-	FAudio_PlatformLockMutex(voice->effectLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
+	effectOut = worker->resampleCache;
 	if (voice->effects.count > 0)
 	{
-		effectOut = FAudio_INTERNAL_ProcessEffectChain(
-			voice,
-			voice->audio->resampleCache,
-			&resampled
-		);
+		/* Checked again under the lock, SetEffectChain may race us */
+		FAudio_PlatformLockMutex(voice->effectLock);
+		LOG_MUTEX_LOCK(voice->audio, voice->effectLock)
+		if (voice->effects.count > 0)
+		{
+			effectOut = FAudio_INTERNAL_ProcessEffectChain(
+				voice,
+				worker->resampleCache,
+				voice->mix.inputChannels,
+				&resampled,
+				&silent
+			);
+		}
+		FAudio_PlatformUnlockMutex(voice->effectLock);
+		LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
+		PROFILE_LAP(voice, voice->profile.EffectCycles)
+	}
+
+	/* Silent in, silent out, nothing to send */
+	if (silent)
+	{
+		goto end;
 	}
-	FAudio_PlatformUnlockMutex(voice->effectLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->effectLock)
 
 	/* Send float cache to sends */
-	FAudio_PlatformLockMutex(voice->volumeLock);
-	LOG_MUTEX_LOCK(voice->audio, voice->volumeLock)
 	for (i = 0; i < voice->sends.SendCount; i += 1)
 	{
-		out = voice->sends.pSends[i].pOutputVoice;
-		if (out->type == FAUDIO_VOICE_MASTER)
-		{
-			stream = out->master.output;
-			oChan = out->master.inputChannels;
-		}
-		else
+		matrix = FAudio_INTERNAL_ResolveSend(voice, i, &out, foldMatrix);
+		stream = FAudio_INTERNAL_GetSendStream(worker, out, &oChan);
+		if (stream == NULL)
 		{
-			stream = out->mix.inputCache;
-			oChan = out->mix.inputChannels;
+			continue;
 		}
 
 		voice->sendMix[i](
 			resampled,
 			voice->outputChannels,
 			oChan,
-			1.0f,
 			effectOut,
 			stream,
-			voice->channelVolume,
-			voice->sendCoefficients[i]
+			matrix
 		);
+		PROFILE_LAP(voice, voice->profile.SendCycles)
 
 		if (voice->flags & FAUDIO_VOICE_USEFILTER)
 		{
 			FAudio_INTERNAL_FilterVoice(
-				voice->audio,
 				&voice->sendFilter[i],
 				voice->sendFilterState[i],
 				stream,
 				resampled,
 				oChan
 			);
+			PROFILE_LAP(voice, voice->profile.FilterCycles)
 		}
 	}
-	FAudio_PlatformUnlockMutex(voice->volumeLock);
-	LOG_MUTEX_UNLOCK(voice->audio, voice->volumeLock)
 
 	/* Zero this at the end, for the next update */
 end:
 	FAudio_PlatformUnlockMutex(voice->sendLock);
 	LOG_MUTEX_UNLOCK(voice->audio, voice->sendLock)
-	FAudio_zero(
-		voice->mix.inputCache,
-		sizeof(float) * voice->mix.inputSamples
-	);
+	if (voice->mix.silentPasses == 0)
+	{
+		FAudio_zero(
+			voice->mix.inputCache,
+			sizeof(float) * voice->mix.inputSamples
+		);
+	}
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *output)
+/* The sizes only ever go up, as voices and effects that need more come in.
+ * This runs on the worker's own thread before it touches any voice, so no
+ * cache can change size while something is mixing with it. The old contents
+ * are scratch and don't need to be kept.
+ */
+static void FAudio_INTERNAL_GrowWorkerArena(FAudioMixWorker *worker)
 {
-	uint32_t totalSamples;
-	LinkedList *list;
-	FAudioSourceVoice *source;
-	FAudioEngineCallback *callback;
+	FAudio *audio = worker->audio;
 
-	LOG_FUNC_ENTER(audio)
-	if (!audio->active)
+	if (	audio->decodeSamples <= worker->decodeSamples &&
+		audio->resampleSamples <= worker->resampleSamples	)
 	{
-		LOG_FUNC_EXIT(audio)
 		return;
 	}
 
-	/* ProcessingPassStart callbacks */
-	FAudio_PlatformLockMutex(audio->callbackLock);
-	LOG_MUTEX_LOCK(audio, audio->callbackLock)
-	list = audio->callbacks;
-	while (list != NULL)
+	worker->decodeSamples = FAudio_max(
+		worker->decodeSamples,
+		audio->decodeSamples
+	);
+	worker->resampleSamples = FAudio_max(
+		worker->resampleSamples,
+		audio->resampleSamples
+	);
+	FAudio_INTERNAL_AlignedFree(audio, worker->arena);
+	worker->arena = FAudio_INTERNAL_AlignedMalloc(
+		audio,
+		sizeof(float) * (
+			FAUDIO_ALIGNED_FLOATS(worker->decodeSamples) +
+			FAUDIO_ALIGNED_FLOATS(worker->resampleSamples)
+		),
+		FAUDIO_MEMORY_SCRATCH
+	);
+	worker->decodeCache = (float*) worker->arena;
+	worker->resampleCache = (
+		worker->decodeCache +
+		FAUDIO_ALIGNED_FLOATS(worker->decodeSamples)
+	);
+}
+
+/* FAudio_TrimEXT has brought the engine's cache sizes back down to what the
+ * voices need now. Drop everything this worker grew past that, the next
+ * PrepareMixWorker allocates it again at the new size.
+ */
+static void FAudio_INTERNAL_TrimMixWorker(FAudioMixWorker *worker)
+{
+	FAudio *audio = worker->audio;
+	uint32_t i;
+
+	FAudio_INTERNAL_AlignedFree(audio, worker->arena);
+	worker->arena = NULL;
+	worker->decodeSamples = 0;
+	worker->resampleSamples = 0;
+	worker->decodeCache = NULL;
+	worker->resampleCache = NULL;
+
+	for (i = 0; i < worker->submixSlots; i += 1)
 	{
-		callback = (FAudioEngineCallback*) list->entry;
-		if (callback->OnProcessingPassStart != NULL)
-		{
-			callback->OnProcessingPassStart(
-				callback
-			);
-		}
-		list = list->next;
+		FAudio_INTERNAL_AlignedFree(audio, worker->submixOutput[i]);
+		worker->submixSamples[i] = 0;
+		worker->submixOutput[i] = NULL;
+		worker->submixDirty[i] = 0;
 	}
-	FAudio_PlatformUnlockMutex(audio->callbackLock);
-	LOG_MUTEX_UNLOCK(audio, audio->callbackLock)
+}
 
-	/* Writes to master will directly write to output */
-	audio->master->master.output = output;
+static void FAudio_INTERNAL_PrepareMixWorker(FAudioMixWorker *worker)
+{
+	FAudio *audio = worker->audio;
+	uint32_t i, samples;
+	int32_t trims;
 
-	/* Mix sources */
-	FAudio_PlatformLockMutex(audio->sourceLock);
-	LOG_MUTEX_LOCK(audio, audio->sourceLock)
-	list = audio->sources;
-	while (list != NULL)
+	/* Workers are prepared on the audio thread, which does the trimming */
+	trims = audio->scratchTrims;
+	if (trims != worker->scratchTrims)
 	{
-		source = (FAudioSourceVoice*) list->entry;
-		if (source->src.active)
-		{
-			FAudio_INTERNAL_MixSource(source);
-		}
-		list = list->next;
+		FAudio_INTERNAL_TrimMixWorker(worker);
+		worker->scratchTrims = trims;
 	}
-	FAudio_PlatformUnlockMutex(audio->sourceLock);
-	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
 
-	/* Mix submixes, ordered by processing stage */
-	FAudio_PlatformLockMutex(audio->submixLock);
-	LOG_MUTEX_LOCK(audio, audio->submixLock)
-	list = audio->submixes;
-	while (list != NULL)
+	FAudio_INTERNAL_GrowWorkerArena(worker);
+
+	if (worker->index == 0)
 	{
-		FAudio_INTERNAL_MixSubmix((FAudioSubmixVoice*) list->entry);
-		list = list->next;
+		return;
 	}
-	FAudio_PlatformUnlockMutex(audio->submixLock);
-	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
 
-	/* Apply master volume */
-	if (audio->master->volume != 1.0f)
+	/* Partial mix buffers start zeroed and are re-zeroed after summing */
+	samples = audio->updateSize * audio->master->master.inputChannels;
+	if (samples > worker->masterSamples)
 	{
-		FAudio_INTERNAL_Amplify(
-			output,
-			audio->updateSize * audio->master->master.inputChannels,
-			audio->master->volume
+		FAudio_INTERNAL_AlignedFree(audio, worker->masterOutput);
+		worker->masterSamples = samples;
+		worker->masterOutput = (float*) FAudio_INTERNAL_AlignedMalloc(
+			audio,
+			sizeof(float) * samples,
+			FAUDIO_MEMORY_SCRATCH
 		);
+		FAudio_zero(worker->masterOutput, sizeof(float) * samples);
 	}
-
-	/* Process master effect chain */
-	FAudio_PlatformLockMutex(audio->master->effectLock);
-	LOG_MUTEX_LOCK(audio, audio->master->effectLock)
-	if (audio->master->effects.count > 0)
+	if (audio->mixSubmixCount > worker->submixSlots)
 	{
-		totalSamples = audio->updateSize;
-		float *effectOut = FAudio_INTERNAL_ProcessEffectChain(
-			audio->master,
-			output,
-			&totalSamples
+		worker->submixSamples = (uint32_t*) FAudio_INTERNAL_ReallocCategory(
+			audio,
+			worker->submixSamples,
+			sizeof(uint32_t) * audio->mixSubmixCount,
+			FAUDIO_MEMORY_SCRATCH
 		);
-
-		if (effectOut != output)
-		{
-			FAudio_memcpy(
-				output,
-				effectOut,
-				totalSamples * audio->master->outputChannels * sizeof(float)
-			);
-		}
-		if (totalSamples < audio->updateSize)
+		worker->submixOutput = (float**) FAudio_INTERNAL_ReallocCategory(
+			audio,
+			worker->submixOutput,
+			sizeof(float*) * audio->mixSubmixCount,
+			FAUDIO_MEMORY_SCRATCH
+		);
+		worker->submixDirty = (uint8_t*) FAudio_INTERNAL_ReallocCategory(
+			audio,
+			worker->submixDirty,
+			sizeof(uint8_t) * audio->mixSubmixCount,
+			FAUDIO_MEMORY_SCRATCH
+		);
+		for (i = worker->submixSlots; i < audio->mixSubmixCount; i += 1)
 		{
-			FAudio_zero(
-				output + (totalSamples * audio->master->outputChannels),
-				(audio->updateSize - totalSamples) * sizeof(float)
-			);
+			worker->submixSamples[i] = 0;
+			worker->submixOutput[i] = NULL;
+			worker->submixDirty[i] = 0;
 		}
+		worker->submixSlots = audio->mixSubmixCount;
 	}
-	FAudio_PlatformUnlockMutex(audio->master->effectLock);
-	LOG_MUTEX_UNLOCK(audio, audio->master->effectLock)
-
-	/* OnProcessingPassEnd callbacks */
-	FAudio_PlatformLockMutex(audio->callbackLock);
-	LOG_MUTEX_LOCK(audio, audio->callbackLock)
-	list = audio->callbacks;
-	while (list != NULL)
+	for (i = 0; i < audio->mixSubmixCount; i += 1)
 	{
-		callback = (FAudioEngineCallback*) list->entry;
-		if (callback->OnProcessingPassEnd != NULL)
+		samples = audio->mixSubmixes[i]->mix.inputSamples;
+		if (samples > worker->submixSamples[i])
 		{
-			callback->OnProcessingPassEnd(
-				callback
+			FAudio_INTERNAL_AlignedFree(audio, worker->submixOutput[i]);
+			worker->submixSamples[i] = samples;
+			worker->submixOutput[i] = (float*) FAudio_INTERNAL_AlignedMalloc(
+				audio,
+				sizeof(float) * samples,
+				FAUDIO_MEMORY_SCRATCH
 			);
+			FAudio_zero(worker->submixOutput[i], sizeof(float) * samples);
 		}
-		list = list->next;
 	}
-	FAudio_PlatformUnlockMutex(audio->callbackLock);
-	LOG_MUTEX_UNLOCK(audio, audio->callbackLock)
-	LOG_FUNC_EXIT(audio)
 }
 
-void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output)
+static void FAudio_INTERNAL_MixSourcesJob(FAudioMixWorker *worker)
 {
-	LOG_FUNC_ENTER(audio)
-	if (audio->pClientEngineProc)
-	{
-		audio->pClientEngineProc(
+	FAudio *audio = worker->audio;
+	uint32_t i;
+
+	LOG_TIMING_BEGIN(audio, "Mix Sources Job", worker)
+
+	/* Interleaved so that neighbouring (similar) voices get spread out */
+	for (	i = worker->index;
+		i < audio->mixSourceCount;
+		i += audio->mixWorkerCount	)
+	{
+		FAudio_INTERNAL_MixSource(audio->mixSources[i], worker);
+	}
+
+	LOG_TIMING_END(audio, "Mix Sources Job", worker)
+}
+
+static void FAudio_INTERNAL_MixSubmixesJob(FAudioMixWorker *worker)
+{
+	FAudio *audio = worker->audio;
+	uint32_t i;
+
+	LOG_TIMING_BEGIN(audio, "Mix Submixes Job", worker)
+
+	for (	i = audio->mixJobBegin + worker->index;
+		i < audio->mixJobEnd;
+		i += audio->mixWorkerCount	)
+	{
+		FAudio_INTERNAL_MixSubmix(audio->mixSubmixes[i], worker);
+	}
+
+	LOG_TIMING_END(audio, "Mix Submixes Job", worker)
+}
+
+/* Thread Scheduling */
+
+void FAudio_INTERNAL_InitThreadSchedule(FAudioThreadSchedule *schedule)
+{
+	FAudio_zero(schedule, sizeof(FAudioThreadSchedule));
+	schedule->lock = FAudio_PlatformCreateMutex();
+}
+
+void FAudio_INTERNAL_FreeThreadSchedule(FAudioThreadSchedule *schedule)
+{
+	FAudio_PlatformDestroyMutex(schedule->lock);
+	schedule->lock = NULL;
+}
+
+void FAudio_INTERNAL_SetThreadSchedule(
+	FAudioThreadSchedule *schedule,
+	uint32_t flags,
+	uint64_t affinityMask
+) {
+	FAudio_PlatformLockMutex(schedule->lock);
+	schedule->flags = flags;
+	schedule->affinityMask = affinityMask;
+
+	/* Each thread clears what it couldn't get once it applies these */
+	schedule->granted = flags & FAUDIO_THREAD_REALTIME_EXT;
+	if (affinityMask != 0)
+	{
+		schedule->granted |= FAUDIO_THREAD_AFFINITY_EXT;
+	}
+	FAudio_PlatformAtomicAdd(&schedule->serial, 1);
+	FAudio_PlatformUnlockMutex(schedule->lock);
+}
+
+void FAudio_INTERNAL_ApplyThreadSchedule(
+	FAudioThreadSchedule *schedule,
+	FAudioThreadScheduler *scheduler,
+	FAudioThreadPriority priority
+) {
+	int32_t serial;
+	uint32_t flags, got;
+	uint64_t affinityMask;
+
+	/* Called every time the thread wakes up, so this has to be cheap */
+	if (FAudio_PlatformAtomicGet(&schedule->serial) == scheduler->serial)
+	{
+		return;
+	}
+
+	FAudio_PlatformLockMutex(schedule->lock);
+	serial = schedule->serial;
+	flags = schedule->flags;
+	affinityMask = schedule->affinityMask;
+	FAudio_PlatformUnlockMutex(schedule->lock);
+
+	got = FAudio_PlatformThreadScheduling(
+		scheduler,
+		priority,
+		flags,
+		affinityMask
+	);
+	scheduler->serial = serial;
+
+	FAudio_PlatformLockMutex(schedule->lock);
+	if (schedule->serial == serial)
+	{
+		schedule->granted &= got;
+	}
+	FAudio_PlatformUnlockMutex(schedule->lock);
+}
+
+static int32_t FAUDIOCALL FAudio_INTERNAL_MixWorkerThread(void *data)
+{
+	FAudioMixWorker *worker = (FAudioMixWorker*) data;
+	FAudioThreadScheduler scheduler;
+
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+	FAudio_zero(&scheduler, sizeof(scheduler));
+	if (!worker->audio->keepDenormals)
+	{
+		/* Our thread, so this is never restored */
+		FAudio_INTERNAL_FlushDenormals();
+	}
+	FAudio_PlatformSetMixThread(1);
+	while (1)
+	{
+		FAudio_PlatformWaitSemaphore(worker->start);
+		if (worker->audio->mixWorkersQuit)
+		{
+			break;
+		}
+		FAudio_INTERNAL_ApplyThreadSchedule(
+			&worker->audio->threadSchedules[FAUDIO_THREAD_MIX_WORKER_EXT],
+			&scheduler,
+			FAUDIO_THREAD_PRIORITY_HIGH
+		);
+		worker->audio->mixJob(worker);
+		FAudio_PlatformPostSemaphore(worker->audio->mixWorkersDone);
+	}
+	return 0;
+}
+
+static inline void FAudio_INTERNAL_AccumulatePartial(
+	float *restrict dst,
+	float *restrict src,
+	uint32_t len
+) {
+	uint32_t i;
+	for (i = 0; i < len; i += 1)
+	{
+		dst[i] += src[i];
+	}
+	FAudio_zero(src, sizeof(float) * len);
+}
+
+static void FAUDIOCALL FAudio_INTERNAL_MixWorkerTask(void *data)
+{
+	FAudioMixWorker *worker = (FAudioMixWorker*) data;
+	FAudio *audio = worker->audio;
+	uint64_t fpState = 0;
+
+	/* The audio thread may have taken this share back already */
+	if (FAudio_PlatformAtomicCompareExchange(&worker->claimed, 0, 1))
+	{
+		/* Not our thread, so put it back the way we found it */
+		if (!audio->keepDenormals)
+		{
+			fpState = FAudio_INTERNAL_FlushDenormals();
+		}
+		FAudio_PlatformSetMixThread(1);
+		audio->mixJob(worker);
+		FAudio_PlatformSetMixThread(0);
+		if (!audio->keepDenormals)
+		{
+			FAudio_INTERNAL_RestoreDenormals(fpState);
+		}
+		FAudio_PlatformPostSemaphore(audio->mixWorkersDone);
+	}
+
+	/* Last, DestroyMixWorkers waits for this */
+	FAudio_PlatformAtomicAdd(&audio->mixTasksPending, -1);
+}
+
+/* RunMixJob, with the workers' shares submitted to the task pool. Whatever
+ * the pool hasn't started by the time the audio thread is done with its own
+ * share, the audio thread claims back and mixes itself. The pass then never
+ * waits behind other engines' tasks, nor for a pool thread that is blocked
+ * on one of this engine's locks, which we may be holding.
+ */
+static void FAudio_INTERNAL_RunMixTasks(FAudio *audio, FAudioMixJob job)
+{
+	uint32_t i, waits;
+	const uint32_t deadline = (uint32_t) (
+		(uint64_t) audio->updateSize * 1000000 /
+		audio->master->master.inputSampleRate
+	);
+
+	/* Every share from the last pass was claimed by someone. Left over
+	 * tasks that lost may still be around, they can only take this pass's
+	 * shares once they're ready.
+	 */
+	for (i = 1; i < audio->mixWorkerCount; i += 1)
+	{
+		FAudio_PlatformAtomicCompareExchange(
+			&audio->mixWorkers[i].claimed,
+			1,
+			0
+		);
+	}
+	FAudio_PlatformAtomicAdd(
+		&audio->mixTasksPending,
+		(int32_t) audio->mixWorkerCount - 1
+	);
+	for (i = 1; i < audio->mixWorkerCount; i += 1)
+	{
+		FAudio_INTERNAL_SubmitTask(
+			audio->taskPool,
+			FAudio_INTERNAL_MixWorkerTask,
+			&audio->mixWorkers[i],
+			0,
+			deadline
+		);
+	}
+
+	job(&audio->mixWorkers[0]);
+	waits = audio->mixWorkerCount - 1;
+	for (i = 1; i < audio->mixWorkerCount; i += 1)
+	{
+		if (FAudio_PlatformAtomicCompareExchange(
+			&audio->mixWorkers[i].claimed,
+			0,
+			1
+		)) {
+			job(&audio->mixWorkers[i]);
+			waits -= 1;
+		}
+	}
+	for (; waits > 0; waits -= 1)
+	{
+		FAudio_PlatformWaitSemaphore(audio->mixWorkersDone);
+	}
+}
+
+/* Runs the job on every mix thread, then sums the partial mixes into the real
+ * destinations. Must be called with submixLock held.
+ */
+static void FAudio_INTERNAL_RunMixJob(FAudio *audio, FAudioMixJob job)
+{
+	uint32_t i, j;
+	FAudioMixWorker *worker;
+
+	audio->mixJob = job;
+	for (i = 1; i < audio->mixWorkerCount; i += 1)
+	{
+		FAudio_INTERNAL_PrepareMixWorker(&audio->mixWorkers[i]);
+	}
+
+	if (audio->taskPool != NULL)
+	{
+		FAudio_INTERNAL_RunMixTasks(audio, job);
+	}
+	else
+	{
+		/* Go! The audio thread takes the first share itself */
+		for (i = 1; i < audio->mixWorkerCount; i += 1)
+		{
+			FAudio_PlatformPostSemaphore(audio->mixWorkers[i].start);
+		}
+		job(&audio->mixWorkers[0]);
+		for (i = 1; i < audio->mixWorkerCount; i += 1)
+		{
+			FAudio_PlatformWaitSemaphore(audio->mixWorkersDone);
+		}
+	}
+
+	for (i = 1; i < audio->mixWorkerCount; i += 1)
+	{
+		worker = &audio->mixWorkers[i];
+		if (worker->masterDirty)
+		{
+			FAudio_INTERNAL_AccumulatePartial(
+				audio->master->master.output,
+				worker->masterOutput,
+				audio->updateSize * audio->master->master.inputChannels
+			);
+			worker->masterDirty = 0;
+		}
+		for (j = 0; j < audio->mixSubmixCount; j += 1)
+		{
+			if (worker->submixDirty[j])
+			{
+				FAudio_INTERNAL_AccumulatePartial(
+					audio->mixSubmixes[j]->mix.inputCache,
+					worker->submixOutput[j],
+					audio->mixSubmixes[j]->mix.inputSamples
+				);
+				audio->mixSubmixes[j]->mix.inputActive = 1;
+				worker->submixDirty[j] = 0;
+			}
+		}
+	}
+}
+
+void FAudio_INTERNAL_InvalidateSubmixGraph(FAudio *audio)
+{
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+	audio->submixGraphDirty = 1;
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+}
+
+/* Splits the submixes into levels, where no submix in a level sends to any
+ * other submix in the same level. The submix list is sorted by processing
+ * stage, which is usually a valid order already, but we relax the levels
+ * until they settle just in case the application got creative with its
+ * stages. Must be called with submixLock held.
+ */
+static void FAudio_INTERNAL_BuildSubmixGraph(FAudio *audio)
+{
+	uint32_t i, j, level, pass, changed;
+	FAudioSubmixVoice *submix, *out;
+
+	LOG_FUNC_ENTER(audio)
+
+	/* Gather the submixes, in processing stage order */
+	if (audio->submixes.count > audio->mixSubmixCapacity)
+	{
+		audio->mixSubmixCapacity = audio->submixes.capacity;
+		audio->mixSubmixes = (FAudioSubmixVoice**) FAudio_INTERNAL_ReallocCategory(
+			audio,
+			audio->mixSubmixes,
+			sizeof(FAudioSubmixVoice*) * audio->mixSubmixCapacity,
+			FAUDIO_MEMORY_SCRATCH
+		);
+		audio->mixSubmixLevel = (uint32_t*) FAudio_INTERNAL_ReallocCategory(
+			audio,
+			audio->mixSubmixLevel,
+			sizeof(uint32_t) * audio->mixSubmixCapacity,
+			FAUDIO_MEMORY_SCRATCH
+		);
+		audio->mixSubmixLevelStart = (uint32_t*) FAudio_INTERNAL_ReallocCategory(
+			audio,
+			audio->mixSubmixLevelStart,
+			sizeof(uint32_t) * (audio->mixSubmixCapacity + 1),
+			FAUDIO_MEMORY_SCRATCH
+		);
+	}
+	audio->mixSubmixCount = audio->submixes.count;
+	for (i = 0; i < audio->mixSubmixCount; i += 1)
+	{
+		/* Stable insertion sort, the table itself is unordered */
+		submix = audio->submixes.voices[i];
+		for (	j = i;
+			j > 0 && audio->mixSubmixes[j - 1]->mix.processingStage > submix->mix.processingStage;
+			j -= 1	)
+		{
+			audio->mixSubmixes[j] = audio->mixSubmixes[j - 1];
+			audio->mixSubmixes[j]->mix.mixSlot = j;
+		}
+		submix->mix.mixSlot = j;
+		submix->mix.foldTarget = NULL;
+		audio->mixSubmixes[j] = submix;
+		audio->mixSubmixLevel[i] = 0;
+	}
+
+	/* A destination is always at least one level after its inputs */
+	changed = 1;
+	for (pass = 0; changed && pass <= audio->mixSubmixCount; pass += 1)
+	{
+		changed = 0;
+		for (i = 0; i < audio->mixSubmixCount; i += 1)
+		{
+			submix = audio->mixSubmixes[i];
+			FAudio_PlatformLockMutex(submix->sendLock);
+			LOG_MUTEX_LOCK(audio, submix->sendLock)
+			for (j = 0; j < submix->sends.SendCount; j += 1)
+			{
+				out = submix->sends.pSends[j].pOutputVoice;
+				if (	out->type == FAUDIO_VOICE_SUBMIX &&
+					out->mix.mixSlot < audio->mixSubmixCount &&
+					audio->mixSubmixes[out->mix.mixSlot] == out &&
+					audio->mixSubmixLevel[out->mix.mixSlot] <= audio->mixSubmixLevel[i]	)
+				{
+					audio->mixSubmixLevel[out->mix.mixSlot] = audio->mixSubmixLevel[i] + 1;
+					changed = 1;
+				}
+			}
+			FAudio_PlatformUnlockMutex(submix->sendLock);
+			LOG_MUTEX_UNLOCK(audio, submix->sendLock)
+		}
+	}
+	if (changed)
+	{
+		/* There's a cycle in the graph, just run everything serially */
+		LOG_WARNING(audio, "%s", "Submix graph has a cycle, mixing serially")
+		for (i = 0; i < audio->mixSubmixCount; i += 1)
+		{
+			audio->mixSubmixLevel[i] = i;
+		}
+	}
+
+	/* Stable insertion sort by level, then assign the final slots */
+	for (i = 1; i < audio->mixSubmixCount; i += 1)
+	{
+		submix = audio->mixSubmixes[i];
+		level = audio->mixSubmixLevel[i];
+		for (j = i; j > 0 && audio->mixSubmixLevel[j - 1] > level; j -= 1)
+		{
+			audio->mixSubmixes[j] = audio->mixSubmixes[j - 1];
+			audio->mixSubmixLevel[j] = audio->mixSubmixLevel[j - 1];
+		}
+		audio->mixSubmixes[j] = submix;
+		audio->mixSubmixLevel[j] = level;
+	}
+	audio->mixSubmixLevelCount = 0;
+	for (i = 0; i < audio->mixSubmixCount; i += 1)
+	{
+		audio->mixSubmixes[i]->mix.mixSlot = i;
+		if (i == 0 || audio->mixSubmixLevel[i] != audio->mixSubmixLevel[i - 1])
+		{
+			audio->mixSubmixLevelStart[audio->mixSubmixLevelCount] = i;
+			audio->mixSubmixLevelCount += 1;
+		}
+	}
+	if (audio->mixSubmixLevelStart != NULL)
+	{
+		audio->mixSubmixLevelStart[audio->mixSubmixLevelCount] = audio->mixSubmixCount;
+	}
+
+	audio->submixGraphDirty = 0;
+	LOG_INFO(
+		audio,
+		"Rebuilt submix graph, %u submixes in %u levels",
+		audio->mixSubmixCount,
+		audio->mixSubmixLevelCount
+	)
+	LOG_FUNC_EXIT(audio)
+}
+
+/* Grouping buses, submixes that only apply a volume on the way to a single
+ * parent of the same rate and layout, are folded into that parent for the
+ * pass. Their inputs send straight to the parent with the bus gain on their
+ * matrix, and the bus skips its own pass, saving a read and write of its
+ * whole buffer. Effects, filters, resampling or a real matrix need the bus's
+ * own buffer, and so do inputs with send filters, which filter the stream
+ * they mixed into. Parents come after their inputs in the graph, so walking
+ * it backwards resolves chains of folded buses into the first real one.
+ *
+ * The graph builder unfolds everything, so a rebuild between the source and
+ * submix stages can't leave a stale parent behind. Must be called with
+ * submixLock held, before the sources mix.
+ */
+static void FAudio_INTERNAL_FoldSubmixes(FAudio *audio)
+{
+	uint32_t i, ci, co, oChan, stride;
+	float gain;
+	uint8_t identity;
+	FAudioSubmixVoice *submix;
+	FAudioVoice *out;
+	const float *matrix;
+
+	for (i = 0; i < audio->mixSubmixCount; i += 1)
+	{
+		audio->mixSubmixes[i]->mix.foldTarget = NULL;
+	}
+	for (i = audio->mixSubmixCount; i > 0; i -= 1)
+	{
+		submix = audio->mixSubmixes[i - 1];
+		if (	submix->effects.count > 0 ||
+			(submix->flags & FAUDIO_VOICE_USEFILTER) ||
+			submix->mix.resampleStep != FIXED_ONE ||
+			FAudio_PlatformAtomicGet(&submix->mix.filteredInputs) > 0	)
+		{
+			continue;
+		}
+
+		FAudio_PlatformLockMutex(submix->sendLock);
+		LOG_MUTEX_LOCK(audio, submix->sendLock)
+		if (submix->sends.SendCount != 1)
+		{
+			goto next;
+		}
+		FAudio_INTERNAL_UpdateMixParameters(submix);
+		out = submix->sends.pSends[0].pOutputVoice;
+		oChan = (out->type == FAUDIO_VOICE_MASTER) ?
+			out->master.inputChannels :
+			out->mix.inputChannels;
+		if (	oChan != submix->mix.inputChannels ||
+			oChan != submix->outputChannels	)
+		{
+			goto next;
+		}
+
+		/* Identity matrix times one volume for every channel */
+		stride = MIX_MATRIX_STRIDE(oChan);
+		matrix = submix->sendMatrix[0];
+		gain = matrix[0];
+		identity = 1;
+		for (ci = 0; identity && ci < oChan; ci += 1)
+		{
+			for (co = 0; co < oChan; co += 1)
+			{
+				if (matrix[ci * stride + co] != ((ci == co) ? gain : 0.0f))
+				{
+					identity = 0;
+					break;
+				}
+			}
+		}
+		if (!identity)
+		{
+			goto next;
+		}
+		gain *= submix->volume;
+
+		/* Our parent may be folded already, then we go where it goes */
+		if (out->type == FAUDIO_VOICE_SUBMIX && out->mix.foldTarget != NULL)
+		{
+			gain *= out->mix.foldGain;
+			out = out->mix.foldTarget;
+		}
+		if (out != submix)
+		{
+			submix->mix.foldTarget = out;
+			submix->mix.foldGain = gain;
+		}
+next:
+		FAudio_PlatformUnlockMutex(submix->sendLock);
+		LOG_MUTEX_UNLOCK(audio, submix->sendLock)
+	}
+}
+
+void FAudio_INTERNAL_CountFilteredSends(FAudioVoice *voice, int32_t delta)
+{
+	uint32_t i;
+	FAudioVoice *out;
+
+	if (!(voice->flags & FAUDIO_VOICE_USEFILTER))
+	{
+		return;
+	}
+	for (i = 0; i < voice->sends.SendCount; i += 1)
+	{
+		out = voice->sends.pSends[i].pOutputVoice;
+		if (out->type == FAUDIO_VOICE_SUBMIX)
+		{
+			FAudio_PlatformAtomicAdd(&out->mix.filteredInputs, delta);
+		}
+	}
+}
+
+static void FAudio_INTERNAL_MixSourcesParallel(FAudio *audio)
+{
+	uint32_t i;
+	FAudioSourceVoice *source;
+
+	/* Snapshot the active sources, so the threads get even shares */
+	if (audio->sources.count > audio->mixSourceCapacity)
+	{
+		audio->mixSourceCapacity = audio->sources.capacity;
+		audio->mixSources = (FAudioSourceVoice**) FAudio_INTERNAL_ReallocCategory(
+			audio,
+			audio->mixSources,
+			sizeof(FAudioSourceVoice*) * audio->mixSourceCapacity,
+			FAUDIO_MEMORY_SCRATCH
+		);
+	}
+	audio->mixSourceCount = 0;
+	for (i = audio->sources.count; i > 0; i -= 1)
+	{
+		source = audio->sources.voices[i - 1];
+		if (source->src.active)
+		{
+			audio->mixSources[audio->mixSourceCount] = source;
+			audio->mixSourceCount += 1;
+		}
+	}
+
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+	if (audio->submixGraphDirty)
+	{
+		FAudio_INTERNAL_BuildSubmixGraph(audio);
+	}
+	FAudio_INTERNAL_FoldSubmixes(audio);
+	FAudio_INTERNAL_RunMixJob(audio, FAudio_INTERNAL_MixSourcesJob);
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+}
+
+/* Must be called with submixLock held */
+static void FAudio_INTERNAL_MixSubmixesParallel(FAudio *audio)
+{
+	uint32_t i;
+
+	if (audio->submixGraphDirty)
+	{
+		FAudio_INTERNAL_BuildSubmixGraph(audio);
+	}
+	for (i = 0; i < audio->mixSubmixLevelCount; i += 1)
+	{
+		audio->mixJobBegin = audio->mixSubmixLevelStart[i];
+		audio->mixJobEnd = audio->mixSubmixLevelStart[i + 1];
+		if (audio->mixJobEnd - audio->mixJobBegin == 1)
+		{
+			/* Not worth waking anyone up for */
+			FAudio_INTERNAL_MixSubmix(
+				audio->mixSubmixes[audio->mixJobBegin],
+				&audio->mixWorkers[0]
+			);
+		}
+		else
+		{
+			FAudio_INTERNAL_RunMixJob(
+				audio,
+				FAudio_INTERNAL_MixSubmixesJob
+			);
+		}
+	}
+}
+
+void FAudio_INTERNAL_CreateMixWorkers(FAudio *audio, uint32_t count)
+{
+	uint32_t i;
+	FAudioMixWorker *worker;
+
+	LOG_FUNC_ENTER(audio)
+
+	count = FAudio_clamp(count, 1, FAUDIO_MAX_MIX_WORKERS);
+	audio->mixWorkerCount = count;
+	audio->mixWorkers = (FAudioMixWorker*) FAudio_INTERNAL_MallocCategory(
+		audio,
+		sizeof(FAudioMixWorker) * count,
+		FAUDIO_MEMORY_SCRATCH
+	);
+	FAudio_zero(audio->mixWorkers, sizeof(FAudioMixWorker) * count);
+	audio->mixWorkersQuit = 0;
+	audio->submixGraphDirty = 1;
+	if (count > 1)
+	{
+		audio->mixWorkersDone = FAudio_PlatformCreateSemaphore(0);
+	}
+
+	for (i = 0; i < count; i += 1)
+	{
+		worker = &audio->mixWorkers[i];
+		worker->audio = audio;
+		worker->index = i;
+		worker->claimed = 1;
+		worker->scratchTrims = audio->scratchTrims;
+		if (i > 0 && audio->taskPool == NULL)
+		{
+			worker->start = FAudio_PlatformCreateSemaphore(0);
+			worker->thread = FAudio_PlatformCreateThread(
+				FAudio_INTERNAL_MixWorkerThread,
+				"FAudio Mix Worker",
+				worker
+			);
+			FAudio_assert(worker->thread != NULL);
+		}
+	}
+
+	if (audio->taskPool != NULL)
+	{
+		LOG_INFO(audio, "Mixing in %u share(s) on a task pool", count)
+	}
+	else
+	{
+		LOG_INFO(audio, "Mixing with %u thread(s)", count)
+	}
+	LOG_FUNC_EXIT(audio)
+}
+
+void FAudio_INTERNAL_DestroyMixWorkers(FAudio *audio)
+{
+	uint32_t i, j;
+	FAudioMixWorker *worker;
+
+	LOG_FUNC_ENTER(audio)
+	if (audio->mixWorkers == NULL)
+	{
+		LOG_FUNC_EXIT(audio)
+		return;
+	}
+
+	if (audio->taskPool != NULL)
+	{
+		/* Tasks that lost their share may not have come back yet */
+		while (FAudio_PlatformAtomicGet(&audio->mixTasksPending) > 0)
+		{
+			for (i = 1; i < audio->mixWorkerCount; i += 1)
+			{
+				FAudio_PlatformAtomicAdd(
+					&audio->mixTasksPending,
+					-((int32_t) FAudio_INTERNAL_CancelTasks(
+						audio->taskPool,
+						FAudio_INTERNAL_MixWorkerTask,
+						&audio->mixWorkers[i]
+					))
+				);
+			}
+			if (FAudio_PlatformAtomicGet(&audio->mixTasksPending) > 0)
+			{
+				FAudio_sleep(1);
+			}
+		}
+	}
+	audio->mixWorkersQuit = 1;
+	for (i = 1; i < audio->mixWorkerCount; i += 1)
+	{
+		if (audio->mixWorkers[i].start != NULL)
+		{
+			FAudio_PlatformPostSemaphore(audio->mixWorkers[i].start);
+		}
+	}
+	for (i = 0; i < audio->mixWorkerCount; i += 1)
+	{
+		worker = &audio->mixWorkers[i];
+		if (worker->thread != NULL)
+		{
+			FAudio_PlatformWaitThread(worker->thread, NULL);
+			FAudio_PlatformDestroySemaphore(worker->start);
+		}
+		FAudio_INTERNAL_AlignedFree(audio, worker->arena);
+		FAudio_INTERNAL_AlignedFree(audio, worker->masterOutput);
+		for (j = 0; j < worker->submixSlots; j += 1)
+		{
+			FAudio_INTERNAL_AlignedFree(audio, worker->submixOutput[j]);
+		}
+		FAudio_INTERNAL_Free(audio, worker->submixSamples);
+		FAudio_INTERNAL_Free(audio, worker->submixOutput);
+		FAudio_INTERNAL_Free(audio, worker->submixDirty);
+	}
+	if (audio->mixWorkerCount > 1)
+	{
+		FAudio_PlatformDestroySemaphore(audio->mixWorkersDone);
+	}
+	FAudio_INTERNAL_Free(audio, audio->mixWorkers);
+	FAudio_INTERNAL_Free(audio, audio->mixSources);
+	FAudio_INTERNAL_Free(audio, audio->mixSubmixes);
+	FAudio_INTERNAL_Free(audio, audio->mixSubmixLevel);
+	FAudio_INTERNAL_Free(audio, audio->mixSubmixLevelStart);
+	audio->mixWorkers = NULL;
+	audio->mixSources = NULL;
+	audio->mixSubmixes = NULL;
+	audio->mixSubmixLevel = NULL;
+	audio->mixSubmixLevelStart = NULL;
+	audio->mixWorkerCount = 0;
+	LOG_FUNC_EXIT(audio)
+}
+
+/* Device Output */
+
+uint32_t FAudio_INTERNAL_SetDeviceFormat(FAudio *audio, uint32_t format)
+{
+	/* Any nonzero seed will do, each generator just needs its own */
+	audio->ditherState[0] = 0x9E3779B9;
+	audio->ditherState[1] = 0x7F4A7C15;
+	audio->ditherState[2] = 0xF39CC060;
+	audio->ditherState[3] = 0x5CEDC834;
+
+	audio->deviceFormat = format;
+	if (format == FAUDIO_DEVICE_FORMAT_F32_EXT)
+	{
+		return sizeof(float);
+	}
+
+	audio->deviceMix = (float*) FAudio_INTERNAL_AlignedMalloc(
+		audio,
+		sizeof(float) *
+		audio->updateSize *
+		audio->master->master.inputChannels,
+		FAUDIO_MEMORY_SCRATCH
+	);
+	if (format == FAUDIO_DEVICE_FORMAT_S16_EXT)
+	{
+		return sizeof(int16_t);
+	}
+	if (format == FAUDIO_DEVICE_FORMAT_S24_EXT)
+	{
+		return 3;
+	}
+	FAudio_assert(format == FAUDIO_DEVICE_FORMAT_S32_EXT);
+	return sizeof(int32_t);
+}
+
+static void FAudio_INTERNAL_ConvertDeviceOutput(FAudio *audio, void *output)
+{
+	const uint32_t totalSamples = (
+		audio->updateSize *
+		audio->master->master.inputChannels
+	);
+	uint32_t *dither = audio->deviceDither ? audio->ditherState : NULL;
+
+	if (audio->deviceFormat == FAUDIO_DEVICE_FORMAT_S16_EXT)
+	{
+		FAudio_INTERNAL_Convert_F32_To_S16(
+			audio->deviceMix,
+			(int16_t*) output,
+			totalSamples,
+			dither
+		);
+	}
+	else if (audio->deviceFormat == FAUDIO_DEVICE_FORMAT_S24_EXT)
+	{
+		FAudio_INTERNAL_Convert_F32_To_S24(
+			audio->deviceMix,
+			(uint8_t*) output,
+			totalSamples,
+			dither
+		);
+	}
+	else
+	{
+		/* Far below the float mix's own precision, so never dithered */
+		FAudio_INTERNAL_Convert_F32_To_S32(
+			audio->deviceMix,
+			(int32_t*) output,
+			totalSamples
+		);
+	}
+}
+
+/* Must be called with sourceLock held. Carries out FAudio_TrimEXT: the cache
+ * sizes are worked out again from the voices there are now, and each worker
+ * frees what it grew past that when it's next prepared.
+ */
+static void FAudio_INTERNAL_TrimCaches(FAudio *audio)
+{
+	FAudioVoice *voice;
+	uint32_t i, channels;
+	uint32_t decodeSamples = 1, resampleSamples = 1;
+
+	if (!FAudio_PlatformAtomicGet(&audio->trimRequested))
+	{
+		return;
+	}
+
+	/* Voices can't be added or resized while we look, and the sizes of
+	 * ones still being created aren't in the tables yet, so wait for those
+	 */
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+	FAudio_PlatformLockMutex(audio->cacheLock);
+	LOG_MUTEX_LOCK(audio, audio->cacheLock)
+	if (audio->cacheReservations > 0)
+	{
+		goto end;
+	}
+	FAudio_PlatformAtomicCompareExchange(&audio->trimRequested, 1, 0);
+
+	/* Same sizes as FAudio_INTERNAL_ResizeDecodeCache/ResampleCache got */
+	for (i = 0; i < audio->sources.count; i += 1)
+	{
+		voice = audio->sources.voices[i];
+		channels = FAudio_max(
+			voice->src.format->nChannels,
+			voice->outputChannels
+		);
+		decodeSamples = FAudio_max(
+			decodeSamples,
+			voice->src.decodeSamples * voice->src.format->nChannels
+		);
+		resampleSamples = FAudio_max(
+			resampleSamples,
+			voice->src.resampleSamples * channels
+		);
+	}
+	for (i = 0; i < audio->submixes.count; i += 1)
+	{
+		voice = audio->submixes.voices[i];
+		channels = FAudio_max(
+			voice->mix.inputChannels,
+			voice->outputChannels
+		);
+		resampleSamples = FAudio_max(
+			resampleSamples,
+			voice->mix.outputSamples * channels
+		);
+	}
+	audio->decodeSamples = decodeSamples;
+	audio->resampleSamples = resampleSamples;
+	audio->scratchTrims += 1;
+
+end:
+	FAudio_PlatformUnlockMutex(audio->cacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->cacheLock)
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+}
+
+/* Passes between GovernorEXT levels going up, so one slow pass can't take it
+ * all the way, and how much of each new pass goes into the smoothed load
+ */
+#define FAUDIO_GOVERNOR_RAISE_PASSES 4
+#define FAUDIO_GOVERNOR_SMOOTHING 0.125f
+
+/* Must be called with perfLock held, at the end of a pass */
+static void FAudio_INTERNAL_UpdateGovernor(FAudio *audio, uint64_t passTime)
+{
+	float load;
+	uint64_t now;
+
+	if (!audio->governorEnabled)
+	{
+		audio->governorLevel = FAUDIO_GOVERNOR_NONE_EXT;
+		audio->governorLoad = 0.0f;
+		audio->governorCalmSince = 0;
+		return;
+	}
+	audio->governorPass += 1;
+	audio->governorQuietVolume = audio->governor.QuietVolume;
+	audio->governorMeterDecimation = FAudio_max(
+		audio->governor.MeterDecimation,
+		1
+	);
+
+	/* A slow pass counts in full right away, a quick one only eases the
+	 * load down, so that a spike is acted on before it turns into a click
+	 */
+	load = (float) (
+		(double) passTime *
+		audio->master->master.inputSampleRate /
+		(audio->updateSize * 1000000.0)
+	);
+	if (load > audio->governorLoad)
+	{
+		audio->governorLoad = load;
+	}
+	else
+	{
+		audio->governorLoad += (
+			(load - audio->governorLoad) *
+			FAUDIO_GOVERNOR_SMOOTHING
+		);
+	}
+
+	if (audio->governorRaiseWait > 0)
+	{
+		audio->governorRaiseWait -= 1;
+	}
+	if (audio->governorLoad > audio->governor.RaiseLoad)
+	{
+		audio->governorCalmSince = 0;
+		if (	audio->governorLevel < FAUDIO_GOVERNOR_VIRTUALIZE_EXT &&
+			audio->governorRaiseWait == 0	)
+		{
+			audio->governorLevel += 1;
+			audio->governorRaiseWait = FAUDIO_GOVERNOR_RAISE_PASSES;
+			LOG_INFO(
+				audio,
+				"Governor up to level %u, load %f",
+				audio->governorLevel,
+				audio->governorLoad
+			);
+		}
+	}
+	else if (	audio->governorLoad < audio->governor.LowerLoad &&
+			audio->governorLevel > FAUDIO_GOVERNOR_NONE_EXT	)
+	{
+		/* Quality comes back a level at a time, each after a hold */
+		now = FAudio_timeus();
+		if (audio->governorCalmSince == 0)
+		{
+			audio->governorCalmSince = now;
+		}
+		else if (now - audio->governorCalmSince >= audio->governor.HoldMilliseconds * 1000ull)
+		{
+			audio->governorLevel -= 1;
+			audio->governorCalmSince = now;
+			LOG_INFO(
+				audio,
+				"Governor down to level %u, load %f",
+				audio->governorLevel,
+				audio->governorLoad
+			);
+		}
+	}
+	else
+	{
+		audio->governorCalmSince = 0;
+	}
+}
+
+static void FAUDIOCALL FAudio_INTERNAL_GenerateOutput(FAudio *audio, float *output)
+{
+	uint32_t i, totalSamples;
+	LinkedList *list;
+	FAudioSourceVoice *source;
+	FAudioEngineCallback *callback;
+	FAudioMixWorker *mainWorker;
+	float *mix;
+	uint64_t passStart, passCycles, passStartUs;
+	PROFILE_STAMP
+
+	LOG_FUNC_ENTER(audio)
+	if (!audio->active)
+	{
+		LOG_FUNC_EXIT(audio)
+		return;
+	}
+	passStart = FAudio_timecycles();
+	passStartUs = FAudio_timeus();
+	LOG_TIMING_BEGIN(audio, "Mix Pass", output)
+
+	/* ProcessingPassStart callbacks */
+	FAudio_PlatformLockMutex(audio->callbackLock);
+	LOG_MUTEX_LOCK(audio, audio->callbackLock)
+	list = audio->callbacks;
+	while (list != NULL)
+	{
+		callback = (FAudioEngineCallback*) list->entry;
+		if (callback->OnProcessingPassStart != NULL)
+		{
+			callback->OnProcessingPassStart(
+				callback
+			);
+		}
+		list = list->next;
+	}
+	FAudio_PlatformUnlockMutex(audio->callbackLock);
+	LOG_MUTEX_UNLOCK(audio, audio->callbackLock)
+
+	/* Apply any committed OperationSets before mixing */
+	FAudio_OPERATIONSET_Execute(audio);
+
+	/* Writes to master will directly write to output, unless the device
+	 * needs the mix converted at the end
+	 */
+	mix = (audio->deviceMix != NULL) ? audio->deviceMix : output;
+	if (audio->deviceMix != NULL)
+	{
+		FAudio_zero(
+			mix,
+			sizeof(float) *
+			audio->updateSize *
+			audio->master->master.inputChannels
+		);
+	}
+	audio->master->master.output = mix;
+	mainWorker = &audio->mixWorkers[0];
+
+	/* Mix sources. The caches are sized once no voice can come in. */
+	LOG_TIMING_BEGIN(audio, "Mix Sources", NULL)
+	FAudio_PlatformLockMutex(audio->sourceLock);
+	LOG_MUTEX_LOCK(audio, audio->sourceLock)
+	FAudio_INTERNAL_TrimCaches(audio);
+	FAudio_INTERNAL_PrepareMixWorker(mainWorker);
+	if (audio->mixWorkerCount > 1)
+	{
+		FAudio_INTERNAL_MixSourcesParallel(audio);
+	}
+	else
+	{
+		/* The submixes stay put while the sources mix into them */
+		FAudio_PlatformLockMutex(audio->submixLock);
+		LOG_MUTEX_LOCK(audio, audio->submixLock)
+		if (audio->submixGraphDirty)
+		{
+			FAudio_INTERNAL_BuildSubmixGraph(audio);
+		}
+		FAudio_INTERNAL_FoldSubmixes(audio);
+
+		/* Newest first, like XAudio2 */
+		for (i = audio->sources.count; i > 0; i -= 1)
+		{
+			source = audio->sources.voices[i - 1];
+			if (source->src.active)
+			{
+				FAudio_INTERNAL_MixSource(source, mainWorker);
+			}
+		}
+		FAudio_PlatformUnlockMutex(audio->submixLock);
+		LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+	}
+	FAudio_PlatformUnlockMutex(audio->sourceLock);
+	LOG_MUTEX_UNLOCK(audio, audio->sourceLock)
+	LOG_TIMING_END(audio, "Mix Sources", NULL)
+
+	/* Mix submixes, ordered by processing stage */
+	LOG_TIMING_BEGIN(audio, "Mix Submixes", NULL)
+	FAudio_PlatformLockMutex(audio->submixLock);
+	LOG_MUTEX_LOCK(audio, audio->submixLock)
+
+	/* A submix added since the sources were mixed may need more */
+	FAudio_INTERNAL_PrepareMixWorker(mainWorker);
+	if (audio->mixWorkerCount > 1)
+	{
+		FAudio_INTERNAL_MixSubmixesParallel(audio);
+	}
+	else
+	{
+		if (audio->submixGraphDirty)
+		{
+			FAudio_INTERNAL_BuildSubmixGraph(audio);
+		}
+		for (i = 0; i < audio->mixSubmixCount; i += 1)
+		{
+			FAudio_INTERNAL_MixSubmix(
+				audio->mixSubmixes[i],
+				mainWorker
+			);
+		}
+	}
+	FAudio_PlatformUnlockMutex(audio->submixLock);
+	LOG_MUTEX_UNLOCK(audio, audio->submixLock)
+	LOG_TIMING_END(audio, "Mix Submixes", NULL)
+
+	/* Apply master volume, also clamping everything mixed into the output.
+	 * For profiling, this and the device conversion are the master's send.
+	 */
+	LOG_TIMING_BEGIN(audio, "Mix Master", audio->master)
+	PROFILE_START(audio->master)
+	PROFILE_FRAMES(audio->master, audio->updateSize)
+	FAudio_INTERNAL_Amplify(
+		mix,
+		audio->updateSize * audio->master->master.inputChannels,
+		audio->master->volume
+	);
+	PROFILE_LAP(audio->master, audio->master->profile.SendCycles)
+
+	/* Process master effect chain */
+	FAudio_PlatformLockMutex(audio->master->effectLock);
+	LOG_MUTEX_LOCK(audio, audio->master->effectLock)
+	if (audio->master->effects.count > 0)
+	{
+		totalSamples = audio->updateSize;
+		uint8_t silent = 0;
+		float *effectOut = FAudio_INTERNAL_ProcessEffectChain(
+			audio->master,
+			mix,
+			audio->master->master.inputChannels,
+			&totalSamples,
+			&silent
+		);
+
+		if (effectOut != mix)
+		{
+			FAudio_memcpy(
+				mix,
+				effectOut,
+				totalSamples * audio->master->outputChannels * sizeof(float)
+			);
+		}
+		if (totalSamples < audio->updateSize)
+		{
+			FAudio_zero(
+				mix + (totalSamples * audio->master->outputChannels),
+				(audio->updateSize - totalSamples) * audio->master->outputChannels * sizeof(float)
+			);
+		}
+	}
+	FAudio_PlatformUnlockMutex(audio->master->effectLock);
+	LOG_MUTEX_UNLOCK(audio, audio->master->effectLock)
+	if (audio->master->effects.count > 0)
+	{
+		PROFILE_LAP(audio->master, audio->master->profile.EffectCycles)
+	}
+
+	/* Integer devices get the finished mix converted to their format,
+	 * clamped and dithered in the same pass
+	 */
+	if (audio->deviceMix != NULL)
+	{
+		FAudio_INTERNAL_ConvertDeviceOutput(audio, output);
+		PROFILE_LAP(audio->master, audio->master->profile.SendCycles)
+	}
+	LOG_TIMING_END(audio, "Mix Master", audio->master)
+
+	/* OnProcessingPassEnd callbacks */
+	FAudio_PlatformLockMutex(audio->callbackLock);
+	LOG_MUTEX_LOCK(audio, audio->callbackLock)
+	list = audio->callbacks;
+	while (list != NULL)
+	{
+		callback = (FAudioEngineCallback*) list->entry;
+		if (callback->OnProcessingPassEnd != NULL)
+		{
+			callback->OnProcessingPassEnd(
+				callback
+			);
+		}
+		list = list->next;
+	}
+	FAudio_PlatformUnlockMutex(audio->callbackLock);
+	LOG_MUTEX_UNLOCK(audio, audio->callbackLock)
+
+	/* Callbacks included, they hold up the device just the same */
+	passCycles = FAudio_timecycles() - passStart;
+	FAudio_PlatformLockMutex(audio->perfLock);
+	LOG_MUTEX_LOCK(audio, audio->perfLock)
+	FAudio_INTERNAL_UpdateGovernor(audio, FAudio_timeus() - passStartUs);
+	audio->perfAudioCycles += passCycles;
+	passCycles = FAudio_min(passCycles, 0xFFFFFFFF);
+	if (audio->perfMinCycles == 0 || passCycles < audio->perfMinCycles)
+	{
+		audio->perfMinCycles = (uint32_t) passCycles;
+	}
+	if (passCycles > audio->perfMaxCycles)
+	{
+		audio->perfMaxCycles = (uint32_t) passCycles;
+	}
+	FAudio_PlatformUnlockMutex(audio->perfLock);
+	LOG_MUTEX_UNLOCK(audio, audio->perfLock)
+	LOG_TIMING_END(audio, "Mix Pass", output)
+	LOG_FUNC_EXIT(audio)
+}
+
+void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output)
+{
+	uint64_t fpState = 0;
+
+	LOG_FUNC_ENTER(audio)
+
+	/* This may be the platform's thread or the client's, so only for now */
+	if (!audio->keepDenormals)
+	{
+		fpState = FAudio_INTERNAL_FlushDenormals();
+	}
+	FAudio_PlatformSetMixThread(1);
+
+	if (audio->pClientEngineProc)
+	{
+		audio->pClientEngineProc(
 			&FAudio_INTERNAL_GenerateOutput,
 			audio,
 			output,
@@ -1230,56 +3707,474 @@ void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output)
 	{
 		FAudio_INTERNAL_GenerateOutput(audio, output);
 	}
+
+	FAudio_PlatformSetMixThread(0);
+	if (!audio->keepDenormals)
+	{
+		FAudio_INTERNAL_RestoreDenormals(fpState);
+	}
 	LOG_FUNC_EXIT(audio)
 }
 
 void FAudio_INTERNAL_ResizeDecodeCache(FAudio *audio, uint32_t samples)
 {
+	/* Each mix worker grows its own cache at the start of the next pass */
 	LOG_FUNC_ENTER(audio)
 	if (samples > audio->decodeSamples)
 	{
 		audio->decodeSamples = samples;
-		audio->decodeCache = (float*) audio->pRealloc(
-			audio->decodeCache,
-			sizeof(float) * audio->decodeSamples
-		);
 	}
 	LOG_FUNC_EXIT(audio)
 }
 
 void FAudio_INTERNAL_ResizeResampleCache(FAudio *audio, uint32_t samples)
 {
+	/* Each mix worker grows its own cache at the start of the next pass */
 	LOG_FUNC_ENTER(audio)
 	if (samples > audio->resampleSamples)
 	{
 		audio->resampleSamples = samples;
-		audio->resampleCache = (float*) audio->pRealloc(
-			audio->resampleCache,
-			sizeof(float) * audio->resampleSamples
+	}
+	LOG_FUNC_EXIT(audio)
+}
+
+void FAudio_INTERNAL_ReserveCaches(FAudio *audio)
+{
+	FAudio_PlatformLockMutex(audio->cacheLock);
+	LOG_MUTEX_LOCK(audio, audio->cacheLock)
+	audio->cacheReservations += 1;
+	FAudio_PlatformUnlockMutex(audio->cacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->cacheLock)
+}
+
+void FAudio_INTERNAL_UnreserveCaches(FAudio *audio)
+{
+	FAudio_PlatformLockMutex(audio->cacheLock);
+	LOG_MUTEX_LOCK(audio, audio->cacheLock)
+	audio->cacheReservations -= 1;
+	FAudio_PlatformUnlockMutex(audio->cacheLock);
+	LOG_MUTEX_UNLOCK(audio, audio->cacheLock)
+}
+
+#define BUFFER_POOL_INDEX(head) ((head) & 0xFFFF)
+#define BUFFER_POOL_HEAD(head, index) \
+	((int32_t) ((((uint32_t) (head) + 0x10000) & 0xFFFF0000) | (index)))
+
+void FAudio_INTERNAL_ResizeBufferPool(FAudio *audio)
+{
+	uint32_t i;
+
+	LOG_FUNC_ENTER(audio)
+
+	/* Only with no source voices, nothing can hold an entry then */
+	if (	audio->bufferPool.capacity == audio->bufferPoolSize ||
+		audio->sources.count > 0	)
+	{
+		LOG_FUNC_EXIT(audio)
+		return;
+	}
+
+	FAudio_INTERNAL_FreeBufferPool(audio);
+	audio->bufferPool.capacity = audio->bufferPoolSize;
+	if (audio->bufferPool.capacity > 0)
+	{
+		audio->bufferPool.entries = (FAudioBufferEntry*) FAudio_INTERNAL_Malloc(
+			audio,
+			sizeof(FAudioBufferEntry) * audio->bufferPool.capacity
 		);
+		for (i = 0; i < audio->bufferPool.capacity; i += 1)
+		{
+			audio->bufferPool.entries[i].poolNext = i; /* i - 1, plus one */
+		}
+		audio->bufferPool.head = audio->bufferPool.capacity;
 	}
 	LOG_FUNC_EXIT(audio)
 }
 
-void FAudio_INTERNAL_ResizeEffectChainCache(FAudio *audio, uint32_t samples)
+void FAudio_INTERNAL_FreeBufferPool(FAudio *audio)
 {
 	LOG_FUNC_ENTER(audio)
-	if (samples > audio->effectChainSamples)
+	if (audio->bufferPool.entries != NULL)
+	{
+		FAudio_INTERNAL_Free(audio, audio->bufferPool.entries);
+	}
+	audio->bufferPool.entries = NULL;
+	audio->bufferPool.capacity = 0;
+	audio->bufferPool.head = 0;
+	LOG_FUNC_EXIT(audio)
+}
+
+FAudioBufferEntry* FAudio_INTERNAL_AllocBufferEntry(FAudio *audio)
+{
+	int32_t head;
+	FAudioBufferEntry *entry;
+
+	do
+	{
+		head = FAudio_PlatformAtomicGet(&audio->bufferPool.head);
+		if (BUFFER_POOL_INDEX(head) == 0)
+		{
+			FAudio_PlatformAtomicAdd(&audio->bufferPool.overflows, 1);
+			return (FAudioBufferEntry*) FAudio_INTERNAL_Malloc(
+				audio,
+				sizeof(FAudioBufferEntry)
+			);
+		}
+
+		/* If this entry was taken in the meantime poolNext may be
+		 * stale, but then the tag has changed and the exchange fails.
+		 */
+		entry = &audio->bufferPool.entries[BUFFER_POOL_INDEX(head) - 1];
+	} while (!FAudio_PlatformAtomicCompareExchange(
+		&audio->bufferPool.head,
+		head,
+		BUFFER_POOL_HEAD(head, entry->poolNext)
+	));
+	return entry;
+}
+
+void FAudio_INTERNAL_FreeBufferEntry(FAudio *audio, FAudioBufferEntry *entry)
+{
+	int32_t head;
+	uint32_t index;
+
+	if (entry->blockCacheSource != NULL)
+	{
+		FAudio_INTERNAL_BlockCacheRelease(audio, entry->blockCacheSource);
+		entry->blockCacheSource = NULL;
+	}
+	FAudio_INTERNAL_CancelPredecode(audio, entry);
+
+	if (	entry < audio->bufferPool.entries ||
+		entry >= audio->bufferPool.entries + audio->bufferPool.capacity	)
+	{
+		FAudio_INTERNAL_Free(audio, entry);
+		return;
+	}
+
+	index = (uint32_t) (entry - audio->bufferPool.entries) + 1;
+	do
+	{
+		head = FAudio_PlatformAtomicGet(&audio->bufferPool.head);
+		entry->poolNext = BUFFER_POOL_INDEX(head);
+	} while (!FAudio_PlatformAtomicCompareExchange(
+		&audio->bufferPool.head,
+		head,
+		BUFFER_POOL_HEAD(head, index)
+	));
+}
+
+#undef BUFFER_POOL_INDEX
+#undef BUFFER_POOL_HEAD
+
+/* Shared Block Cache */
+
+#define BLOCK_CACHE_BUCKET(source, block) ( \
+	(((uint32_t) ((size_t) (source) >> 4)) ^ ((block) * 2654435761u)) & \
+	(FAUDIO_BLOCK_CACHE_BUCKETS - 1) \
+)
+#define BLOCK_CACHE_SOURCE_BUCKET(data) ( \
+	(((uint32_t) ((size_t) (data) >> 4) * 2654435761u) >> 16) & \
+	(FAUDIO_BLOCK_CACHE_SOURCE_BUCKETS - 1) \
+)
+#define BLOCK_CACHE_SAMPLES(entry) ((float*) ((entry) + 1))
+
+static void FAudio_INTERNAL_BlockCacheEvict(
+	FAudio *audio,
+	FAudioBlockCacheEntry *entry
+) {
+	FAudioBlockCache *cache = &audio->blockCache;
+	FAudioBlockCacheEntry **bucket;
+
+	if (entry->lruPrev != NULL)
+	{
+		entry->lruPrev->lruNext = entry->lruNext;
+	}
+	else
+	{
+		cache->lruHead = entry->lruNext;
+	}
+	if (entry->lruNext != NULL)
+	{
+		entry->lruNext->lruPrev = entry->lruPrev;
+	}
+	else
+	{
+		cache->lruTail = entry->lruPrev;
+	}
+
+	if (entry->sourcePrev != NULL)
+	{
+		entry->sourcePrev->sourceNext = entry->sourceNext;
+	}
+	else
+	{
+		entry->source->entries = entry->sourceNext;
+	}
+	if (entry->sourceNext != NULL)
+	{
+		entry->sourceNext->sourcePrev = entry->sourcePrev;
+	}
+
+	bucket = &cache->buckets[BLOCK_CACHE_BUCKET(entry->source, entry->block)];
+	while (*bucket != entry)
+	{
+		bucket = &(*bucket)->hashNext;
+	}
+	*bucket = entry->hashNext;
+
+	cache->used -= sizeof(float) * entry->samples;
+	FAudio_INTERNAL_Free(audio, entry);
+}
+
+FAudioBlockCacheSource* FAudio_INTERNAL_BlockCacheAcquire(
+	FAudio *audio,
+	const uint8_t *data,
+	uint16_t align,
+	uint16_t channels
+) {
+	FAudioBlockCache *cache = &audio->blockCache;
+	FAudioBlockCacheSource *source;
+	uint32_t bucket;
+
+	/* Unlocked, but a stale budget only means one buffer goes uncached */
+	if (cache->budget == 0)
+	{
+		return NULL;
+	}
+
+	FAudio_PlatformLockMutex(cache->lock);
+	LOG_MUTEX_LOCK(audio, cache->lock)
+
+	bucket = BLOCK_CACHE_SOURCE_BUCKET(data);
+	for (source = cache->sources[bucket]; source != NULL; source = source->next)
+	{
+		if (	source->data == data &&
+			source->align == align &&
+			source->channels == channels	)
+		{
+			break;
+		}
+	}
+	if (source == NULL)
 	{
-		audio->effectChainSamples = samples;
-		audio->effectChainCache = (float*) audio->pRealloc(
-			audio->effectChainCache,
-			sizeof(float) * audio->effectChainSamples
+		source = (FAudioBlockCacheSource*) FAudio_INTERNAL_MallocCategory(
+			audio,
+			sizeof(FAudioBlockCacheSource),
+			FAUDIO_MEMORY_DECODE
 		);
+		source->data = data;
+		source->align = align;
+		source->channels = channels;
+		source->refs = 0;
+		source->entries = NULL;
+		source->next = cache->sources[bucket];
+		cache->sources[bucket] = source;
+	}
+	source->refs += 1;
+
+	FAudio_PlatformUnlockMutex(cache->lock);
+	LOG_MUTEX_UNLOCK(audio, cache->lock)
+	return source;
+}
+
+void FAudio_INTERNAL_BlockCacheRelease(
+	FAudio *audio,
+	FAudioBlockCacheSource *source
+) {
+	FAudioBlockCache *cache = &audio->blockCache;
+	FAudioBlockCacheSource **prev;
+
+	FAudio_PlatformLockMutex(cache->lock);
+	LOG_MUTEX_LOCK(audio, cache->lock)
+
+	source->refs -= 1;
+	if (source->refs == 0)
+	{
+		while (source->entries != NULL)
+		{
+			FAudio_INTERNAL_BlockCacheEvict(audio, source->entries);
+		}
+		prev = &cache->sources[BLOCK_CACHE_SOURCE_BUCKET(source->data)];
+		while (*prev != source)
+		{
+			prev = &(*prev)->next;
+		}
+		*prev = source->next;
+		FAudio_INTERNAL_Free(audio, source);
+	}
+
+	FAudio_PlatformUnlockMutex(cache->lock);
+	LOG_MUTEX_UNLOCK(audio, cache->lock)
+}
+
+/* Copies a block into out and returns 1 if the cache has it */
+static uint8_t FAudio_INTERNAL_BlockCacheRead(
+	FAudio *audio,
+	FAudioBlockCacheSource *source,
+	uint32_t block,
+	float *out,
+	uint32_t samples
+) {
+	FAudioBlockCache *cache = &audio->blockCache;
+	FAudioBlockCacheEntry *entry;
+
+	FAudio_PlatformLockMutex(cache->lock);
+	LOG_MUTEX_LOCK(audio, cache->lock)
+
+	entry = cache->buckets[BLOCK_CACHE_BUCKET(source, block)];
+	while (entry != NULL && (entry->source != source || entry->block != block))
+	{
+		entry = entry->hashNext;
+	}
+	if (entry == NULL)
+	{
+		cache->misses += 1;
+		FAudio_PlatformUnlockMutex(cache->lock);
+		LOG_MUTEX_UNLOCK(audio, cache->lock)
+		LOG_STREAMING(audio, "Block Cache Miss", source, block)
+		return 0;
+	}
+	FAudio_assert(entry->samples == samples);
+	FAudio_memcpy(out, BLOCK_CACHE_SAMPLES(entry), sizeof(float) * samples);
+	cache->hits += 1;
+
+	/* Move to the front */
+	if (entry->lruPrev != NULL)
+	{
+		entry->lruPrev->lruNext = entry->lruNext;
+		if (entry->lruNext != NULL)
+		{
+			entry->lruNext->lruPrev = entry->lruPrev;
+		}
+		else
+		{
+			cache->lruTail = entry->lruPrev;
+		}
+		entry->lruPrev = NULL;
+		entry->lruNext = cache->lruHead;
+		cache->lruHead->lruPrev = entry;
+		cache->lruHead = entry;
+	}
+
+	FAudio_PlatformUnlockMutex(cache->lock);
+	LOG_MUTEX_UNLOCK(audio, cache->lock)
+	return 1;
+}
+
+static void FAudio_INTERNAL_BlockCacheWrite(
+	FAudio *audio,
+	FAudioBlockCacheSource *source,
+	uint32_t block,
+	const float *in,
+	uint32_t samples
+) {
+	FAudioBlockCache *cache = &audio->blockCache;
+	FAudioBlockCacheEntry *entry;
+	uint32_t bucket = BLOCK_CACHE_BUCKET(source, block);
+	uint32_t bytes = sizeof(float) * samples;
+
+	FAudio_PlatformLockMutex(cache->lock);
+	LOG_MUTEX_LOCK(audio, cache->lock)
+
+	if (bytes > cache->budget)
+	{
+		FAudio_PlatformUnlockMutex(cache->lock);
+		LOG_MUTEX_UNLOCK(audio, cache->lock)
+		return;
+	}
+
+	/* Another voice may have decoded it while we did */
+	for (entry = cache->buckets[bucket]; entry != NULL; entry = entry->hashNext)
+	{
+		if (entry->source == source && entry->block == block)
+		{
+			FAudio_PlatformUnlockMutex(cache->lock);
+			LOG_MUTEX_UNLOCK(audio, cache->lock)
+			return;
+		}
+	}
+
+	while (cache->used + bytes > cache->budget)
+	{
+		FAudio_INTERNAL_BlockCacheEvict(audio, cache->lruTail);
+	}
+
+	entry = (FAudioBlockCacheEntry*) FAudio_INTERNAL_MallocCategory(
+		audio,
+		sizeof(FAudioBlockCacheEntry) + bytes,
+		FAUDIO_MEMORY_DECODE
+	);
+	entry->source = source;
+	entry->block = block;
+	entry->samples = samples;
+	entry->hashNext = cache->buckets[bucket];
+	cache->buckets[bucket] = entry;
+	entry->lruPrev = NULL;
+	entry->lruNext = cache->lruHead;
+	if (cache->lruHead != NULL)
+	{
+		cache->lruHead->lruPrev = entry;
+	}
+	else
+	{
+		cache->lruTail = entry;
+	}
+	cache->lruHead = entry;
+	entry->sourcePrev = NULL;
+	entry->sourceNext = source->entries;
+	if (source->entries != NULL)
+	{
+		source->entries->sourcePrev = entry;
+	}
+	source->entries = entry;
+	FAudio_memcpy(BLOCK_CACHE_SAMPLES(entry), in, bytes);
+	cache->used += bytes;
+
+	FAudio_PlatformUnlockMutex(cache->lock);
+	LOG_MUTEX_UNLOCK(audio, cache->lock)
+}
+
+/* Call with the lock held, after the budget has changed */
+void FAudio_INTERNAL_BlockCacheTrim(FAudio *audio)
+{
+	while (audio->blockCache.used > audio->blockCache.budget)
+	{
+		FAudio_INTERNAL_BlockCacheEvict(audio, audio->blockCache.lruTail);
+	}
+}
+
+void FAudio_INTERNAL_FreeBlockCache(FAudio *audio)
+{
+	FAudioBlockCacheSource *source, *next;
+	uint32_t i;
+
+	LOG_FUNC_ENTER(audio)
+	while (audio->blockCache.lruTail != NULL)
+	{
+		FAudio_INTERNAL_BlockCacheEvict(audio, audio->blockCache.lruTail);
+	}
+	for (i = 0; i < FAUDIO_BLOCK_CACHE_SOURCE_BUCKETS; i += 1)
+	{
+		for (source = audio->blockCache.sources[i]; source != NULL; source = next)
+		{
+			next = source->next;
+			FAudio_INTERNAL_Free(audio, source);
+		}
+		audio->blockCache.sources[i] = NULL;
 	}
 	LOG_FUNC_EXIT(audio)
 }
 
+#undef BLOCK_CACHE_BUCKET
+#undef BLOCK_CACHE_SOURCE_BUCKET
+#undef BLOCK_CACHE_SAMPLES
+
 void FAudio_INTERNAL_AllocEffectChain(
 	FAudioVoice *voice,
 	const FAudioEffectChain *pEffectChain
 ) {
-	uint32_t i;
+	uint32_t i, channels, samples;
 
 	LOG_FUNC_ENTER(voice->audio)
 	voice->effects.count = pEffectChain->EffectCount;
@@ -1289,13 +4184,28 @@ void FAudio_INTERNAL_AllocEffectChain(
 		return;
 	}
 
+	channels = 0;
 	for (i = 0; i < pEffectChain->EffectCount; i += 1)
 	{
 		pEffectChain->pEffectDescriptors[i].pEffect->AddRef(pEffectChain->pEffectDescriptors[i].pEffect);
+		channels = FAudio_max(
+			channels,
+			pEffectChain->pEffectDescriptors[i].OutputChannels
+		);
 	}
 
-	voice->effects.desc = (FAudioEffectDescriptor*) voice->audio->pMalloc(
-		voice->effects.count * sizeof(FAudioEffectDescriptor)
+	samples = FAUDIO_ALIGNED_FLOATS(channels * voice->audio->updateSize);
+	voice->effects.buffers[0] = (float*) FAudio_INTERNAL_AlignedMalloc(
+		voice->audio,
+		sizeof(float) * samples * 2,
+		FAUDIO_MEMORY_EFFECTS
+	);
+	voice->effects.buffers[1] = voice->effects.buffers[0] + samples;
+
+	voice->effects.desc = (FAudioEffectDescriptor*) FAudio_INTERNAL_MallocCategory(
+		voice->audio,
+		voice->effects.count * sizeof(FAudioEffectDescriptor),
+		FAUDIO_MEMORY_EFFECTS
 	);
 	FAudio_memcpy(
 		voice->effects.desc,
@@ -1303,8 +4213,10 @@ void FAudio_INTERNAL_AllocEffectChain(
 		voice->effects.count * sizeof(FAudioEffectDescriptor)
 	);
 	#define ALLOC_EFFECT_PROPERTY(prop, type) \
-		voice->effects.prop = (type*) voice->audio->pMalloc( \
-			voice->effects.count * sizeof(type) \
+		voice->effects.prop = (type*) FAudio_INTERNAL_MallocCategory( \
+			voice->audio, \
+			voice->effects.count * sizeof(type), \
+			FAUDIO_MEMORY_EFFECTS \
 		); \
 		FAudio_zero( \
 			voice->effects.prop, \
@@ -1314,6 +4226,9 @@ void FAudio_INTERNAL_AllocEffectChain(
 	ALLOC_EFFECT_PROPERTY(parameterSizes, uint32_t)
 	ALLOC_EFFECT_PROPERTY(parameterUpdates, uint8_t)
 	ALLOC_EFFECT_PROPERTY(inPlaceProcessing, uint8_t)
+#ifndef FAUDIO_DISABLE_VOICE_PROFILE
+	ALLOC_EFFECT_PROPERTY(cycles, uint64_t)
+#endif /* FAUDIO_DISABLE_VOICE_PROFILE */
 	#undef ALLOC_EFFECT_PROPERTY
 	LOG_FUNC_EXIT(voice->audio)
 }
@@ -1335,14 +4250,58 @@ void FAudio_INTERNAL_FreeEffectChain(FAudioVoice *voice)
 		voice->effects.desc[i].pEffect->Release(voice->effects.desc[i].pEffect);
 	}
 
-	voice->audio->pFree(voice->effects.desc);
-	voice->audio->pFree(voice->effects.parameters);
-	voice->audio->pFree(voice->effects.parameterSizes);
-	voice->audio->pFree(voice->effects.parameterUpdates);
-	voice->audio->pFree(voice->effects.inPlaceProcessing);
+	FAudio_INTERNAL_Free(voice->audio, voice->effects.desc);
+	FAudio_INTERNAL_Free(voice->audio, voice->effects.parameters);
+	FAudio_INTERNAL_Free(voice->audio, voice->effects.parameterSizes);
+	FAudio_INTERNAL_Free(voice->audio, voice->effects.parameterUpdates);
+	FAudio_INTERNAL_Free(voice->audio, voice->effects.inPlaceProcessing);
+#ifndef FAUDIO_DISABLE_VOICE_PROFILE
+	FAudio_INTERNAL_Free(voice->audio, voice->effects.cycles);
+#endif /* FAUDIO_DISABLE_VOICE_PROFILE */
+	FAudio_INTERNAL_AlignedFree(voice->audio, voice->effects.buffers[0]);
 	LOG_FUNC_EXIT(voice->audio)
 }
 
+/* Effect Tails */
+
+uint8_t FAudio_INTERNAL_EffectTailIdle(
+	FAudioEffectTail *tail,
+	FAPOBufferFlags inputFlags,
+	uint32_t frames
+) {
+	if (inputFlags != FAPO_BUFFER_SILENT)
+	{
+		tail->silentFrames = 0;
+		tail->idle = 0;
+		return 0;
+	}
+	if (tail->idle)
+	{
+		return 1;
+	}
+
+	/* Saturate, a tail can't be this long anyway */
+	if (tail->silentFrames < 0xFFFFFFFF - frames)
+	{
+		tail->silentFrames += frames;
+	}
+	return 0;
+}
+
+uint8_t FAudio_INTERNAL_EffectTailEnded(
+	FAudioEffectTail *tail,
+	uint32_t tailFrames,
+	float energy
+) {
+	if (	tail->silentFrames > tailFrames &&
+		energy < FAUDIO_EFFECT_TAIL_SILENCE	)
+	{
+		tail->idle = 1;
+		return 1;
+	}
+	return 0;
+}
+
 const float FAUDIO_INTERNAL_MATRIX_DEFAULTS[8][8][64] =
 {
 	#include "matrix_defaults.inl"
@@ -1394,10 +4353,20 @@ void FAudio_INTERNAL_DecodePCM24(
 	const uint8_t *buf;
 	LOG_FUNC_ENTER(voice->audio)
 
-	/* FIXME: Uh... is this something that can be SIMD-ified? */
 	buf = buffer->pAudioData + (
 		voice->src.curBufferOffset * voice->src.format->nBlockAlign
 	);
+	if (voice->src.format->nBlockAlign == voice->src.format->nChannels * 3)
+	{
+		/* Tightly packed, so the whole block can be converted at once */
+		FAudio_INTERNAL_Convert_S24_To_F32(
+			buf,
+			decodeCache,
+			samples * voice->src.format->nChannels
+		);
+		LOG_FUNC_EXIT(voice->audio)
+		return;
+	}
 	for (i = 0; i < samples; i += 1, buf += voice->src.format->nBlockAlign)
 	for (j = 0; j < voice->src.format->nChannels; j += 1)
 	{
@@ -1430,61 +4399,54 @@ void FAudio_INTERNAL_DecodePCM32F(
 
 /* MSADPCM Decoding */
 
-static inline int16_t FAudio_INTERNAL_ParseNibble(
-	uint8_t nibble,
-	uint8_t predictor,
-	int16_t *delta,
-	int16_t *sample1,
-	int16_t *sample2
-) {
-	static const int32_t AdaptionTable[16] =
-	{
-		230, 230, 230, 230, 307, 409, 512, 614,
-		768, 614, 512, 409, 307, 230, 230, 230
-	};
-	static const int32_t AdaptCoeff_1[7] =
-	{
-		256, 512, 0, 192, 240, 460, 392
-	};
-	static const int32_t AdaptCoeff_2[7] =
-	{
-		0, -256, 0, 64, 0, -208, -232
-	};
+#define DIVBY32768 0.000030517578125f
 
-	int8_t signedNibble;
-	int32_t sampleInt;
-	int16_t sample;
+static const int32_t AdaptionTable[16] =
+{
+	230, 230, 230, 230, 307, 409, 512, 614,
+	768, 614, 512, 409, 307, 230, 230, 230
+};
+static const int32_t AdaptCoeff_1[7] =
+{
+	256, 512, 0, 192, 240, 460, 392
+};
+static const int32_t AdaptCoeff_2[7] =
+{
+	0, -256, 0, 64, 0, -208, -232
+};
 
-	signedNibble = (int8_t) nibble;
-	if (signedNibble & 0x08)
-	{
-		signedNibble -= 0x10;
-	}
+/* The nibble is already sign-extended by FAudio_INTERNAL_UnpackNibbles */
+static inline float FAudio_INTERNAL_ParseNibble(
+	int8_t nibble,
+	int32_t coeff1,
+	int32_t coeff2,
+	int32_t *delta,
+	int32_t *sample1,
+	int32_t *sample2
+) {
+	int32_t sample;
 
-	sampleInt = (
-		(*sample1 * AdaptCoeff_1[predictor]) +
-		(*sample2 * AdaptCoeff_2[predictor])
-	) / 256;
-	sampleInt += signedNibble * (*delta);
-	sample = FAudio_clamp(sampleInt, -32768, 32767);
+	sample = ((*sample1 * coeff1) + (*sample2 * coeff2)) / 256;
+	sample += nibble * (*delta);
+	sample = FAudio_clamp(sample, -32768, 32767);
 
 	*sample2 = *sample1;
 	*sample1 = sample;
-	*delta = (int16_t) (AdaptionTable[nibble] * (int32_t) (*delta) / 256);
+	*delta = (int16_t) (AdaptionTable[nibble & 0x0F] * (*delta) / 256);
 	if (*delta < 16)
 	{
 		*delta = 16;
 	}
-	return sample;
+	return sample * DIVBY32768;
 }
 
 #define READ(item, type) \
-	item = *((type*) *buf); \
-	*buf += sizeof(type);
+	item = *((type*) buf); \
+	buf += sizeof(type);
 
-static inline void FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
-	uint8_t **buf,
-	int16_t *blockCache,
+static void FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
+	const uint8_t *buf,
+	float *restrict out,
 	uint32_t align
 ) {
 	uint32_t i;
@@ -1494,6 +4456,9 @@ static inline void FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
 	int16_t delta;
 	int16_t sample1;
 	int16_t sample2;
+	int32_t coeff1, coeff2;
+	int32_t d, s1, s2;
+	int8_t nibbles[1024]; /* Max block size */
 
 	/* Preamble */
 	READ(predictor, uint8_t)
@@ -1501,32 +4466,35 @@ static inline void FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
 	READ(sample1, int16_t)
 	READ(sample2, int16_t)
 	align -= 7;
+	FAudio_assert(align * 2 <= sizeof(nibbles));
+
+	predictor = FAudio_min(predictor, 6);
+	coeff1 = AdaptCoeff_1[predictor];
+	coeff2 = AdaptCoeff_2[predictor];
+	d = delta;
+	s1 = sample1;
+	s2 = sample2;
 
 	/* Samples */
-	*blockCache++ = sample2;
-	*blockCache++ = sample1;
-	for (i = 0; i < align; i += 1, *buf += 1)
+	*out++ = sample2 * DIVBY32768;
+	*out++ = sample1 * DIVBY32768;
+	FAudio_INTERNAL_UnpackNibbles(buf, nibbles, align);
+	for (i = 0; i < align * 2; i += 1)
 	{
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) >> 4,
-			predictor,
-			&delta,
-			&sample1,
-			&sample2
-		);
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) & 0x0F,
-			predictor,
-			&delta,
-			&sample1,
-			&sample2
+		*out++ = FAudio_INTERNAL_ParseNibble(
+			nibbles[i],
+			coeff1,
+			coeff2,
+			&d,
+			&s1,
+			&s2
 		);
 	}
 }
 
-static inline void FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
-	uint8_t **buf,
-	int16_t *blockCache,
+static void FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
+	const uint8_t *buf,
+	float *restrict out,
 	uint32_t align
 ) {
 	uint32_t i;
@@ -1540,6 +4508,9 @@ static inline void FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
 	int16_t r_sample1;
 	int16_t l_sample2;
 	int16_t r_sample2;
+	int32_t l_coeff1, l_coeff2, r_coeff1, r_coeff2;
+	int32_t l_d, l_s1, l_s2, r_d, r_s1, r_s2;
+	int8_t nibbles[2048]; /* Max block size */
 
 	/* Preamble */
 	READ(l_predictor, uint8_t)
@@ -1551,133 +4522,619 @@ static inline void FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
 	READ(l_sample2, int16_t)
 	READ(r_sample2, int16_t)
 	align -= 14;
-
-	/* Samples */
-	*blockCache++ = l_sample2;
-	*blockCache++ = r_sample2;
-	*blockCache++ = l_sample1;
-	*blockCache++ = r_sample1;
-	for (i = 0; i < align; i += 1, *buf += 1)
+	FAudio_assert(align * 2 <= sizeof(nibbles));
+
+	l_predictor = FAudio_min(l_predictor, 6);
+	r_predictor = FAudio_min(r_predictor, 6);
+	l_coeff1 = AdaptCoeff_1[l_predictor];
+	l_coeff2 = AdaptCoeff_2[l_predictor];
+	r_coeff1 = AdaptCoeff_1[r_predictor];
+	r_coeff2 = AdaptCoeff_2[r_predictor];
+	l_d = l_delta;
+	l_s1 = l_sample1;
+	l_s2 = l_sample2;
+	r_d = r_delta;
+	r_s1 = r_sample1;
+	r_s2 = r_sample2;
+
+	/* Samples, the nibbles alternate between left and right */
+	*out++ = l_sample2 * DIVBY32768;
+	*out++ = r_sample2 * DIVBY32768;
+	*out++ = l_sample1 * DIVBY32768;
+	*out++ = r_sample1 * DIVBY32768;
+	FAudio_INTERNAL_UnpackNibbles(buf, nibbles, align);
+	for (i = 0; i < align * 2; i += 2)
 	{
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) >> 4,
-			l_predictor,
-			&l_delta,
-			&l_sample1,
-			&l_sample2
+		*out++ = FAudio_INTERNAL_ParseNibble(
+			nibbles[i],
+			l_coeff1,
+			l_coeff2,
+			&l_d,
+			&l_s1,
+			&l_s2
 		);
-		*blockCache++ = FAudio_INTERNAL_ParseNibble(
-			*(*buf) & 0x0F,
-			r_predictor,
-			&r_delta,
-			&r_sample1,
-			&r_sample2
+		*out++ = FAudio_INTERNAL_ParseNibble(
+			nibbles[i + 1],
+			r_coeff1,
+			r_coeff2,
+			&r_d,
+			&r_s1,
+			&r_s2
 		);
 	}
 }
 
+/* The block decoders only ever produce int16 samples / 32768, so scaling back
+ * up gives the exact samples again.
+ */
+void FAudio_INTERNAL_TranscodeMSADPCM(
+	const uint8_t *data,
+	uint32_t blocks,
+	uint16_t nBlockAlign,
+	uint16_t channels,
+	int16_t *out
+) {
+	uint32_t i, j, samples;
+	float decoded[2052]; /* Max stereo block, see the nibbles above */
+
+	samples = ((nBlockAlign / channels) - 6) * 2 * channels;
+	FAudio_assert(channels == 1 || channels == 2);
+	FAudio_assert(samples <= sizeof(decoded) / sizeof(float));
+	for (i = 0; i < blocks; i += 1)
+	{
+		if (channels == 2)
+		{
+			FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
+				data,
+				decoded,
+				nBlockAlign
+			);
+		}
+		else
+		{
+			FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
+				data,
+				decoded,
+				nBlockAlign
+			);
+		}
+		for (j = 0; j < samples; j += 1)
+		{
+			out[j] = (int16_t) (decoded[j] * 32768.0f);
+		}
+		data += nBlockAlign;
+		out += samples;
+	}
+}
+
 #undef READ
+#undef DIVBY32768
 
-void FAudio_INTERNAL_DecodeMonoMSADPCM(
+/* Blocks the window is missing come from the shared cache when it has them,
+ * see BlockCacheEXT, and go into it when they had to be decoded.
+ */
+static inline void FAudio_INTERNAL_DecodeCachedBlock(
+	FAudioVoice *voice,
+	const uint8_t *data,
+	uint32_t block,
+	float *out,
+	uint32_t samples,
+	void (*decodeBlock)(const uint8_t*, float*, uint32_t)
+) {
+	FAudioBlockCacheSource *source = voice->src.bufferList->blockCacheSource;
+
+	if (	source != NULL &&
+		FAudio_INTERNAL_BlockCacheRead(
+			voice->audio,
+			source,
+			block,
+			out,
+			samples
+		)	)
+	{
+		return;
+	}
+	decodeBlock(
+		data + (block * voice->src.format->nBlockAlign),
+		out,
+		voice->src.format->nBlockAlign
+	);
+	if (source != NULL)
+	{
+		FAudio_INTERNAL_BlockCacheWrite(
+			voice->audio,
+			source,
+			block,
+			out,
+			samples
+		);
+	}
+}
+
+/* Decoded blocks are kept in a small per-voice window, see DecodeAheadEXT.
+ * A pass that starts in the middle of a block, and the padding decoded past
+ * the end of every pass, read the window instead of decoding that block
+ * again. The window is topped up to decodeAhead blocks past the one being
+ * read, so after the first block each new block costs one block decode.
+ */
+static inline void FAudio_INTERNAL_DecodeMSADPCM(
 	FAudioVoice *voice,
 	FAudioBuffer *buffer,
 	float *decodeCache,
-	uint32_t samples
+	uint32_t samples,
+	void (*decodeBlock)(const uint8_t*, float*, uint32_t)
 ) {
 	/* Loop variables */
-	uint32_t copy, done = 0;
+	uint32_t copy, done = 0, end;
 
 	/* Read pointers */
-	uint8_t *buf;
-	int32_t midOffset;
-
-	/* PCM block cache */
-	int16_t blockCache[1012]; /* Max block size */
-
-	/* Block size */
-	uint32_t bsize = (voice->src.format->nBlockAlign - 6) * 2;
+	const uint8_t *data = buffer->pAudioData;
+	uint32_t block;
+	uint32_t midOffset;
+
+	/* Align, block size, block window */
+	const uint32_t channels = voice->src.format->nChannels;
+	const uint32_t align = voice->src.format->nBlockAlign;
+	const uint32_t bsize = ((align / channels) - 6) * 2;
+	const uint32_t blocks = buffer->AudioBytes / align;
+	const uint32_t ahead = voice->src.adpcmCacheBlocks;
+	const uint32_t slotSize = bsize * channels;
+	FAudioPredecodeJob *job;
 
 	LOG_FUNC_ENTER(voice->audio)
 
+	/* Predecoded buffers are plain float PCM once they are ready */
+	job = voice->src.bufferList->predecode;
+	if (	job != NULL &&
+		FAudio_PlatformAtomicGet(&job->state) == FAUDIO_PREDECODE_READY	)
+	{
+		FAudio_memcpy(
+			decodeCache,
+			job->pcm + (voice->src.curBufferOffset * channels),
+			sizeof(float) * samples * channels
+		);
+		LOG_FUNC_EXIT(voice->audio)
+		return;
+	}
+
 	/* Where are we starting? */
-	buf = (uint8_t*) buffer->pAudioData + (
-		(voice->src.curBufferOffset / bsize) *
-		voice->src.format->nBlockAlign
-	);
+	block = voice->src.curBufferOffset / bsize;
 
 	/* Are we starting in the middle? */
-	midOffset = (voice->src.curBufferOffset % bsize);
+	midOffset = voice->src.curBufferOffset % bsize;
 
-	/* Read in each block directly to the decode cache */
 	while (done < samples)
 	{
+		FAudio_assert(block < blocks);
 		copy = FAudio_min(samples - done, bsize - midOffset);
-		FAudio_INTERNAL_DecodeMonoMSADPCMBlock(
-			&buf,
-			blockCache,
-			voice->src.format->nBlockAlign
-		);
-		FAudio_INTERNAL_Convert_S16_To_F32(
-			blockCache + midOffset,
-			decodeCache,
-			copy
-		);
-		decodeCache += copy;
+
+		/* Whole block with no window to keep it in, write it directly */
+		if (	ahead == 1 &&
+			copy == bsize &&
+			(	voice->src.adpcmCacheData != data ||
+				voice->src.adpcmCacheBlock != block	)	)
+		{
+			FAudio_INTERNAL_DecodeCachedBlock(
+				voice,
+				data,
+				block,
+				decodeCache,
+				slotSize,
+				decodeBlock
+			);
+		}
+		else
+		{
+			/* Restart the window if we jumped away from it */
+			if (	voice->src.adpcmCacheData != data ||
+				block < voice->src.adpcmCacheBlock ||
+				block > voice->src.adpcmCacheBlock + voice->src.adpcmCacheCount	)
+			{
+				voice->src.adpcmCacheData = data;
+				voice->src.adpcmCacheBlock = block;
+				voice->src.adpcmCacheCount = 0;
+			}
+
+			/* Top up, dropping blocks we have already gone past */
+			end = FAudio_min(block + ahead, blocks);
+			while (voice->src.adpcmCacheBlock + voice->src.adpcmCacheCount < end)
+			{
+				if (voice->src.adpcmCacheCount == ahead)
+				{
+					voice->src.adpcmCacheBlock += 1;
+					voice->src.adpcmCacheCount -= 1;
+				}
+				FAudio_INTERNAL_DecodeCachedBlock(
+					voice,
+					data,
+					voice->src.adpcmCacheBlock + voice->src.adpcmCacheCount,
+					voice->src.adpcmCache + (
+						((voice->src.adpcmCacheBlock + voice->src.adpcmCacheCount) % ahead) *
+						slotSize
+					),
+					slotSize,
+					decodeBlock
+				);
+				voice->src.adpcmCacheCount += 1;
+			}
+
+			FAudio_memcpy(
+				decodeCache,
+				voice->src.adpcmCache + (
+					((block % ahead) * slotSize) +
+					(midOffset * channels)
+				),
+				sizeof(float) * copy * channels
+			);
+		}
+		decodeCache += copy * channels;
 		done += copy;
+		block += 1;
 		midOffset = 0;
 	}
 	LOG_FUNC_EXIT(voice->audio)
 }
 
-void FAudio_INTERNAL_DecodeStereoMSADPCM(
-	FAudioVoice *voice,
-	FAudioBuffer *buffer,
-	float *decodeCache,
-	uint32_t samples
-) {
-	/* Loop variables */
-	uint32_t copy, done = 0;
-
-	/* Read pointers */
-	uint8_t *buf;
-	int32_t midOffset;
+/* Predecoding */
 
-	/* PCM block cache */
-	int16_t blockCache[2024]; /* Max block size */
+/* Decodes one chunk of a job, returns 0 if there's more to do right away or
+ * FAUDIO_POOL_LOOP_IDLE to wait for the next wake
+ */
+static uint32_t FAudio_INTERNAL_PredecodeStep(void *data)
+{
+	FAudio *audio = (FAudio*) data;
+	FAudioPredecoder *predecoder = &audio->predecoder;
+	FAudioPredecodeJob *job;
+	uint32_t end;
+	uint8_t more = 0;
+
+	FAudio_PlatformLockMutex(predecoder->lock);
+	LOG_MUTEX_LOCK(audio, predecoder->lock)
+	if (predecoder->quit)
+	{
+		FAudio_PlatformUnlockMutex(predecoder->lock);
+		LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+		return FAUDIO_POOL_LOOP_IDLE;
+	}
 
-	/* Align, block size */
-	uint32_t bsize = ((voice->src.format->nBlockAlign / 2) - 6) * 2;
+#ifdef HAVE_FFMPEG
+	/* FFmpeg voices only stay a few frames ahead, so they can't
+	 * wait for whole buffers. They get a frame before each chunk.
+	 */
+	more = FAudio_FFMPEG_decodeahead(audio);
+#endif /* HAVE_FFMPEG */
 
-	LOG_FUNC_ENTER(voice->audio)
+	/* Cancelled jobs leave the queue without waking us */
+	job = predecoder->current;
+	if (job == NULL)
+	{
+		job = predecoder->head;
+		if (job == NULL)
+		{
+			FAudio_PlatformUnlockMutex(predecoder->lock);
+			LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+			return more ? 0 : FAUDIO_POOL_LOOP_IDLE;
+		}
+		predecoder->head = job->next;
+		if (predecoder->head == NULL)
+		{
+			predecoder->tail = NULL;
+		}
+		job->state = FAUDIO_PREDECODE_RUNNING;
+		predecoder->current = job;
+		LOG_TIMING_BEGIN(audio, "Predecode", job->data)
+	}
 
-	/* Where are we starting? */
-	buf = (uint8_t*) buffer->pAudioData + (
-		(voice->src.curBufferOffset / bsize) *
-		voice->src.format->nBlockAlign
-	);
+	/* Let go of the lock between chunks, so cancelling and
+	 * submitting never wait for more than a few blocks
+	 */
+	if (!job->cancelled)
+	{
+		end = FAudio_min(
+			job->decoded + FAUDIO_PREDECODE_CHUNK,
+			job->blocks
+		);
+		for (; job->decoded < end; job->decoded += 1)
+		{
+			job->decodeBlock(
+				job->data + (job->decoded * job->align),
+				job->pcm + (job->decoded * job->blockSamples),
+				job->align
+			);
+		}
+	}
 
-	/* Are we starting in the middle? */
-	midOffset = (voice->src.curBufferOffset % bsize);
+	if (job->cancelled || job->decoded == job->blocks)
+	{
+		LOG_TIMING_END(audio, "Predecode", job->data)
+		if (job->cancelled)
+		{
+			FAudio_INTERNAL_AlignedFree(audio, job->pcm);
+			FAudio_INTERNAL_Free(audio, job);
+		}
+		else
+		{
+			FAudio_PlatformAtomicCompareExchange(
+				&job->state,
+				FAUDIO_PREDECODE_RUNNING,
+				FAUDIO_PREDECODE_READY
+			);
+		}
+		predecoder->current = NULL;
+		more |= (predecoder->head != NULL);
+	}
+	else
+	{
+		more = 1;
+	}
+	FAudio_PlatformUnlockMutex(predecoder->lock);
+	LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+	return more ? 0 : FAUDIO_POOL_LOOP_IDLE;
+}
 
-	/* Read in each block directly to the decode cache */
-	while (done < samples)
+static int32_t FAUDIOCALL FAudio_INTERNAL_PredecodeThread(void *data)
+{
+	FAudio *audio = (FAudio*) data;
+	FAudioPredecoder *predecoder = &audio->predecoder;
+	FAudioThreadScheduler scheduler;
+	uint32_t wait;
+	uint8_t quit;
+
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_LOW);
+	FAudio_zero(&scheduler, sizeof(scheduler));
+	while (1)
 	{
-		copy = FAudio_min(samples - done, bsize - midOffset);
-		FAudio_INTERNAL_DecodeStereoMSADPCMBlock(
-			&buf,
-			blockCache,
-			voice->src.format->nBlockAlign
+		FAudio_PlatformWaitSemaphore(predecoder->wake);
+		FAudio_INTERNAL_ApplyThreadSchedule(
+			&audio->threadSchedules[FAUDIO_THREAD_PREDECODE_EXT],
+			&scheduler,
+			FAUDIO_THREAD_PRIORITY_LOW
 		);
-		FAudio_INTERNAL_Convert_S16_To_F32(
-			blockCache + (midOffset * 2),
-			decodeCache,
-			copy * 2
+		do
+		{
+			wait = FAudio_INTERNAL_PredecodeStep(audio);
+		} while (wait == 0);
+
+		FAudio_PlatformLockMutex(predecoder->lock);
+		LOG_MUTEX_LOCK(audio, predecoder->lock)
+		quit = predecoder->quit;
+		FAudio_PlatformUnlockMutex(predecoder->lock);
+		LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+		if (quit)
+		{
+			break;
+		}
+	}
+	return 0;
+}
+
+void FAudio_INTERNAL_WakePredecoder(FAudio *audio)
+{
+	if (audio->predecoder.loop.pool != NULL)
+	{
+		FAudio_INTERNAL_WakePoolLoop(&audio->predecoder.loop);
+	}
+	else
+	{
+		FAudio_PlatformPostSemaphore(audio->predecoder.wake);
+	}
+}
+
+void FAudio_INTERNAL_StartPredecoder(FAudio *audio)
+{
+	FAudioPredecoder *predecoder = &audio->predecoder;
+
+	LOG_FUNC_ENTER(audio)
+	FAudio_PlatformLockMutex(predecoder->lock);
+	LOG_MUTEX_LOCK(audio, predecoder->lock)
+	if (audio->taskPool != NULL)
+	{
+		if (predecoder->loop.pool == NULL)
+		{
+			FAudio_INTERNAL_StartPoolLoop(
+				&predecoder->loop,
+				audio->taskPool,
+				FAudio_INTERNAL_PredecodeStep,
+				audio,
+				FAUDIO_PREDECODE_DEADLINE_US
+			);
+		}
+	}
+	else if (predecoder->thread == NULL)
+	{
+		predecoder->wake = FAudio_PlatformCreateSemaphore(0);
+		predecoder->thread = FAudio_PlatformCreateThread(
+			FAudio_INTERNAL_PredecodeThread,
+			"FAudio Predecoder",
+			audio
 		);
-		decodeCache += copy * 2;
-		done += copy;
-		midOffset = 0;
+		FAudio_assert(predecoder->thread != NULL);
 	}
-	LOG_FUNC_EXIT(voice->audio)
+	FAudio_PlatformUnlockMutex(predecoder->lock);
+	LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+	LOG_FUNC_EXIT(audio)
+}
+
+void FAudio_INTERNAL_StopPredecoder(FAudio *audio)
+{
+	FAudioPredecoder *predecoder = &audio->predecoder;
+
+	LOG_FUNC_ENTER(audio)
+	if (predecoder->thread == NULL && predecoder->loop.pool == NULL)
+	{
+		LOG_FUNC_EXIT(audio)
+		return;
+	}
+
+	FAudio_PlatformLockMutex(predecoder->lock);
+	LOG_MUTEX_LOCK(audio, predecoder->lock)
+	predecoder->quit = 1;
+	FAudio_PlatformUnlockMutex(predecoder->lock);
+	LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+	if (predecoder->loop.pool != NULL)
+	{
+		FAudio_INTERNAL_StopPoolLoop(&predecoder->loop);
+	}
+	else
+	{
+		FAudio_PlatformPostSemaphore(predecoder->wake);
+		FAudio_PlatformWaitThread(predecoder->thread, NULL);
+		FAudio_PlatformDestroySemaphore(predecoder->wake);
+	}
+
+	/* A job cancelled mid-decode is ours, and the step stops before it
+	 * gets to freeing it. Anything else still queued belongs to a voice
+	 * that was never destroyed.
+	 */
+	if (predecoder->current != NULL && predecoder->current->cancelled)
+	{
+		FAudio_INTERNAL_Free(audio, predecoder->current->pcm);
+		FAudio_INTERNAL_Free(audio, predecoder->current);
+	}
+	predecoder->head = NULL;
+	predecoder->tail = NULL;
+	predecoder->current = NULL;
+#ifdef HAVE_FFMPEG
+	predecoder->ffmpegVoices = NULL;
+#endif /* HAVE_FFMPEG */
+	predecoder->thread = NULL;
+	predecoder->quit = 0;
+	LOG_FUNC_EXIT(audio)
+}
+
+FAudioPredecodeJob* FAudio_INTERNAL_PredecodeBuffer(
+	FAudioSourceVoice *voice,
+	const FAudioBuffer *buffer
+) {
+	FAudio *audio = voice->audio;
+	FAudioPredecoder *predecoder = &audio->predecoder;
+	FAudioPredecodeJob *job;
+	const uint32_t channels = voice->src.format->nChannels;
+	const uint32_t align = voice->src.format->nBlockAlign;
+
+	LOG_FUNC_ENTER(audio)
+
+	job = (FAudioPredecodeJob*) FAudio_INTERNAL_MallocCategory(
+		audio,
+		sizeof(FAudioPredecodeJob),
+		FAUDIO_MEMORY_DECODE
+	);
+	job->data = buffer->pAudioData;
+	job->align = align;
+	job->blocks = buffer->AudioBytes / align;
+	job->decoded = 0;
+	job->blockSamples = ((align / channels) - 6) * 2 * channels;
+	job->decodeBlock = (channels == 2) ?
+		FAudio_INTERNAL_DecodeStereoMSADPCMBlock :
+		FAudio_INTERNAL_DecodeMonoMSADPCMBlock;
+	job->pcm = (float*) FAudio_INTERNAL_AlignedMalloc(
+		audio,
+		sizeof(float) * job->blocks * job->blockSamples,
+		FAUDIO_MEMORY_DECODE
+	);
+	job->state = FAUDIO_PREDECODE_PENDING;
+	job->cancelled = 0;
+	job->next = NULL;
+
+	FAudio_PlatformLockMutex(predecoder->lock);
+	LOG_MUTEX_LOCK(audio, predecoder->lock)
+	if (predecoder->tail != NULL)
+	{
+		predecoder->tail->next = job;
+	}
+	else
+	{
+		predecoder->head = job;
+	}
+	predecoder->tail = job;
+	FAudio_PlatformUnlockMutex(predecoder->lock);
+	LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+	LOG_STREAMING(audio, "Predecode Queued", buffer, buffer->AudioBytes)
+	FAudio_INTERNAL_WakePredecoder(audio);
+
+	LOG_FUNC_EXIT(audio)
+	return job;
+}
+
+/* Must be called before the client hears about the buffer ending */
+void FAudio_INTERNAL_CancelPredecode(FAudio *audio, FAudioBufferEntry *entry)
+{
+	FAudioPredecoder *predecoder = &audio->predecoder;
+	FAudioPredecodeJob *job = entry->predecode;
+	FAudioPredecodeJob *prev;
+
+	if (job == NULL)
+	{
+		return;
+	}
+	entry->predecode = NULL;
+
+	FAudio_PlatformLockMutex(predecoder->lock);
+	LOG_MUTEX_LOCK(audio, predecoder->lock)
+	if (job->state == FAUDIO_PREDECODE_RUNNING)
+	{
+		/* The thread frees it once it sees this */
+		job->cancelled = 1;
+		FAudio_PlatformUnlockMutex(predecoder->lock);
+		LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+		return;
+	}
+	if (job->state == FAUDIO_PREDECODE_PENDING)
+	{
+		if (predecoder->head == job)
+		{
+			prev = NULL;
+			predecoder->head = job->next;
+		}
+		else
+		{
+			prev = predecoder->head;
+			while (prev->next != job)
+			{
+				prev = prev->next;
+			}
+			prev->next = job->next;
+		}
+		if (predecoder->tail == job)
+		{
+			predecoder->tail = prev;
+		}
+	}
+	FAudio_PlatformUnlockMutex(predecoder->lock);
+	LOG_MUTEX_UNLOCK(audio, predecoder->lock)
+
+	FAudio_INTERNAL_AlignedFree(audio, job->pcm);
+	FAudio_INTERNAL_Free(audio, job);
+}
+
+void FAudio_INTERNAL_DecodeMonoMSADPCM(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer,
+	float *decodeCache,
+	uint32_t samples
+) {
+	FAudio_INTERNAL_DecodeMSADPCM(
+		voice,
+		buffer,
+		decodeCache,
+		samples,
+		FAudio_INTERNAL_DecodeMonoMSADPCMBlock
+	);
+}
+
+void FAudio_INTERNAL_DecodeStereoMSADPCM(
+	FAudioVoice *voice,
+	FAudioBuffer *buffer,
+	float *decodeCache,
+	uint32_t samples
+) {
+	FAudio_INTERNAL_DecodeMSADPCM(
+		voice,
+		buffer,
+		decodeCache,
+		samples,
+		FAudio_INTERNAL_DecodeStereoMSADPCMBlock
+	);
 }
 
 /* Fallback WMA decoder, get ready for spam! */
@@ -177,6 +177,7 @@
 
 typedef void* FAudioThread;
 typedef void* FAudioMutex;
+typedef void* FAudioSemaphore;
 typedef int32_t (FAUDIOCALL * FAudioThreadFunc)(void* data);
 typedef enum FAudioThreadPriority
 {
@@ -185,6 +186,81 @@ typedef enum FAudioThreadPriority
 	FAUDIO_THREAD_PRIORITY_HIGH,
 } FAudioThreadPriority;
 
+/* Scheduling for one kind of thread, see FAudio_SetThreadSchedulingEXT.
+ * Threads poll serial when they wake up and take the lock to read the new
+ * settings, then clear the bits that didn't take from granted.
+ */
+typedef struct FAudioThreadSchedule
+{
+	FAudioMutex lock;
+	volatile int32_t serial;
+	uint32_t flags;
+	uint64_t affinityMask;
+	uint32_t granted;
+} FAudioThreadSchedule;
+
+/* What one thread has applied, kept by the thread itself */
+typedef struct FAudioThreadScheduler
+{
+	int32_t serial;
+	uint32_t flags;
+	uint64_t affinityMask;
+	void *token;	/* Platform state for undoing flags */
+} FAudioThreadScheduler;
+
+/* Task pools, see FAudioCreateTaskPoolEXT. Built-in pools keep their tasks in
+ * two lists under lock: ready, sorted by deadline, and delayed, sorted by
+ * start time, which the threads move over to ready once they're due.
+ */
+typedef struct FAudioPoolTask FAudioPoolTask;
+struct FAudioPoolTask
+{
+	FAudioTaskFuncEXT func;
+	void *data;
+	uint64_t start;	/* FAudio_timeus */
+	uint64_t deadline;
+	FAudioPoolTask *next;
+};
+
+struct FAudioTaskPoolEXT
+{
+	volatile int32_t refcount;
+	uint32_t threadCount;
+	FAudioSubmitTaskFuncEXT submit;
+	void *user;
+
+	/* Built-in pools only, threads is NULL for custom ones */
+	FAudioThread *threads;
+	FAudioMutex lock;
+	FAudioSemaphore wake;
+	FAudioPoolTask *ready;
+	FAudioPoolTask *delayed;
+	FAudioPoolTask *freeTasks;
+	uint8_t quit;
+};
+
+/* A thread's loop, run on a task pool one step at a time instead. Only one
+ * step runs at once, and waking the loop while a step runs gets it another
+ * one right after. pending counts the tasks submitted for the loop that
+ * haven't returned yet, some of which may find there's nothing to do.
+ */
+#define FAUDIO_POOL_LOOP_IDLE 0xFFFFFFFF
+
+/* Returns the ms until the next step, 0 for right away or
+ * FAUDIO_POOL_LOOP_IDLE to wait for a wake
+ */
+typedef uint32_t (*FAudioPoolLoopStep)(void *data);
+
+typedef struct FAudioPoolLoop
+{
+	FAudioTaskPoolEXT *pool;
+	FAudioPoolLoopStep step;
+	void *data;
+	uint32_t deadlineUs;
+	volatile int32_t state;
+	volatile int32_t pending;
+} FAudioPoolLoop;
+
 /* Linked Lists */
 
 typedef struct LinkedList LinkedList;
@@ -212,6 +288,52 @@ void LinkedList_RemoveEntry(
 	FAudioFreeFunc pFree
 );
 
+/* Engine Allocations
+ * These wrap the FAudio's pMalloc/pFree/pRealloc to keep its memoryUsage up
+ * to date. Memory from one must only go back to the others, never to the
+ * allocator callbacks directly. Every block is counted in one of the
+ * categories of FAudio_GetMemoryUsageEXT, plain Malloc counts as a voice's.
+ * Realloc keeps the block's category, ReallocCategory moves it.
+ */
+
+typedef enum FAudioMemoryCategory
+{
+	FAUDIO_MEMORY_SCRATCH,	/* Mix caches and other per-pass buffers */
+	FAUDIO_MEMORY_VOICES,	/* Voices, sends, buffer entries, the rest */
+	FAUDIO_MEMORY_EFFECTS,	/* Effect chains and their parameters */
+	FAUDIO_MEMORY_DECODE,	/* Decode-ahead, predecode, block cache, FFmpeg */
+	FAUDIO_MEMORY_CATEGORY_COUNT
+} FAudioMemoryCategory;
+
+void* FAudio_INTERNAL_Malloc(FAudio *audio, size_t size);
+void* FAudio_INTERNAL_MallocCategory(
+	FAudio *audio,
+	size_t size,
+	uint32_t category
+);
+void FAudio_INTERNAL_Free(FAudio *audio, void *ptr);
+void* FAudio_INTERNAL_Realloc(FAudio *audio, void *ptr, size_t size);
+void* FAudio_INTERNAL_ReallocCategory(
+	FAudio *audio,
+	void *ptr,
+	size_t size,
+	uint32_t category
+);
+
+/* Mix buffers start on a FAUDIO_BUFFER_ALIGNMENT_EXT boundary, from the
+ * client's aligned allocator if it gave us one and by over-allocating from
+ * pMalloc otherwise. They must go back to AlignedFree, not Free.
+ */
+void* FAudio_INTERNAL_AlignedMalloc(
+	FAudio *audio,
+	size_t size,
+	uint32_t category
+);
+void FAudio_INTERNAL_AlignedFree(FAudio *audio, void *ptr);
+#define FAUDIO_ALIGNED_FLOATS(samples) \
+	(((samples) + (FAUDIO_BUFFER_ALIGNMENT_EXT / sizeof(float)) - 1) & \
+	~(FAUDIO_BUFFER_ALIGNMENT_EXT / sizeof(float) - 1))
+
 /* Internal FAudio Types */
 
 typedef enum FAudioVoiceType
@@ -221,14 +343,165 @@ typedef enum FAudioVoiceType
 	FAUDIO_VOICE_MASTER
 } FAudioVoiceType;
 
+/* Dense voice registry, for the sources and submixes the mixer walks every
+ * pass. The voices are packed at the front of one array, so a pass reads
+ * memory in order instead of chasing list nodes, and each voice knows its own
+ * slot so that removing it just moves the last voice into the hole. Adding and
+ * removing are both O(1), but removing changes the order. Sources are mixed
+ * from the back, newest first like XAudio2, and submixes are put in stage
+ * order by the submix graph. The caller holds the lock for the table.
+ */
+typedef struct FAudioVoiceTable
+{
+	FAudioVoice **voices;
+	uint32_t count;
+	uint32_t capacity;
+} FAudioVoiceTable;
+void FAudio_INTERNAL_VoiceTableAdd(
+	FAudio *audio,
+	FAudioVoiceTable *table,
+	FAudioVoice *voice
+);
+void FAudio_INTERNAL_VoiceTableRemove(
+	FAudioVoiceTable *table,
+	FAudioVoice *voice
+);
+void FAudio_INTERNAL_VoiceTableFree(FAudio *audio, FAudioVoiceTable *table);
+
 typedef struct FAudioBufferEntry FAudioBufferEntry;
 struct FAudioBufferEntry
 {
 	FAudioBuffer buffer;
 	FAudioBufferWMA bufferWMA;
 	FAudioBufferEntry *next;
+	int32_t poolNext;	/* While free, see FAudioBufferPool */
+	struct FAudioBlockCacheSource *blockCacheSource;
+	struct FAudioPredecodeJob *predecode;
 };
 
+/* Preallocated buffer entries, see BufferPoolEXT.
+ * The free entries form a stack that any thread can push and pop without
+ * a lock. The head holds the index of the top entry plus one (0 is empty) in
+ * the low 16 bits and a tag in the high 16 bits, which changes on every
+ * update so that a pop can't succeed after the same entry was popped and
+ * pushed back in the meantime. Entries taken when the pool is empty come from
+ * pMalloc and go back to pFree, like they always did.
+ */
+#define FAUDIO_DEFAULT_BUFFER_POOL 128
+typedef struct FAudioBufferPool
+{
+	FAudioBufferEntry *entries;
+	uint32_t capacity;
+	volatile int32_t head;
+	volatile int32_t overflows;
+} FAudioBufferPool;
+
+#define FAUDIO_DEFAULT_DECODE_AHEAD 1
+
+/* Decoded MS-ADPCM blocks shared by every voice, see BlockCacheEXT.
+ * A source is one pAudioData played in one format. Each buffer entry that
+ * may use the cache holds a reference to its source from submit until the
+ * entry is freed, and the source's blocks go away with its last reference,
+ * so the data may be reused as soon as no voice is playing it, as before.
+ * Everything is owned by the lock, entries are in LRU order, most recent
+ * first, and evicted from the tail to stay within the budget.
+ */
+#define FAUDIO_BLOCK_CACHE_BUCKETS 1024
+#define FAUDIO_BLOCK_CACHE_SOURCE_BUCKETS 64
+typedef struct FAudioBlockCacheEntry FAudioBlockCacheEntry;
+typedef struct FAudioBlockCacheSource FAudioBlockCacheSource;
+struct FAudioBlockCacheSource
+{
+	const uint8_t *data;
+	uint16_t align;
+	uint16_t channels;
+	uint32_t refs;
+	FAudioBlockCacheEntry *entries;
+	FAudioBlockCacheSource *next;
+};
+struct FAudioBlockCacheEntry
+{
+	FAudioBlockCacheSource *source;
+	uint32_t block;
+	uint32_t samples;
+	FAudioBlockCacheEntry *hashNext;
+	FAudioBlockCacheEntry *lruPrev;
+	FAudioBlockCacheEntry *lruNext;
+	FAudioBlockCacheEntry *sourcePrev;
+	FAudioBlockCacheEntry *sourceNext;
+	/* Followed by the decoded samples */
+};
+typedef struct FAudioBlockCache
+{
+	FAudioMutex lock;
+	uint32_t budget;	/* Bytes, 0 turns the cache off */
+	uint32_t used;
+	uint32_t hits;
+	uint32_t misses;
+	FAudioBlockCacheEntry *lruHead;
+	FAudioBlockCacheEntry *lruTail;
+	FAudioBlockCacheEntry *buckets[FAUDIO_BLOCK_CACHE_BUCKETS];
+	FAudioBlockCacheSource *sources[FAUDIO_BLOCK_CACHE_SOURCE_BUCKETS];
+} FAudioBlockCache;
+
+/* Buffers of FAUDIO_VOICE_PREDECODE_EXT voices, decoded to float PCM on the
+ * predecode thread once they are submitted, see PredecodeEXT.
+ * The lock owns the queue and the jobs, except that the mixer checks for
+ * READY without it. The thread only reads the client's data with the lock
+ * held, a chunk of blocks at a time, so a job that was cancelled under the
+ * lock never touches the data again and the buffer can be returned.
+ */
+#define FAUDIO_PREDECODE_PENDING 0
+#define FAUDIO_PREDECODE_RUNNING 1
+#define FAUDIO_PREDECODE_READY 2
+#define FAUDIO_PREDECODE_CHUNK 8
+#define FAUDIO_PREDECODE_DEADLINE_US 50000	/* On a task pool */
+typedef struct FAudioPredecodeJob FAudioPredecodeJob;
+struct FAudioPredecodeJob
+{
+	const uint8_t *data;
+	uint32_t align;
+	uint32_t blocks;
+	uint32_t decoded;
+	uint32_t blockSamples;	/* All channels */
+	void (*decodeBlock)(const uint8_t*, float*, uint32_t);
+	float *pcm;
+	volatile int32_t state;
+	uint8_t cancelled;
+	FAudioPredecodeJob *next;
+};
+typedef struct FAudioPredecoder
+{
+	FAudioMutex lock;
+	FAudioSemaphore wake;
+	FAudioThread thread;
+	FAudioPoolLoop loop;	/* Instead of the thread on a task pool */
+	uint8_t quit;
+	FAudioPredecodeJob *head;
+	FAudioPredecodeJob *tail;
+	FAudioPredecodeJob *current;	/* Taken off head, partly decoded */
+#ifdef HAVE_FFMPEG
+	/* FFmpeg voices with the flag, which the thread keeps a few frames
+	 * ahead of their mixer, a frame at a time. A voice is only touched
+	 * by the thread with the lock held, so unlinking it is enough.
+	 */
+	struct FAudioFFmpeg *ffmpegVoices;
+#endif /* HAVE_FFMPEG */
+} FAudioPredecoder;
+
+/* Opened FFmpeg decoders that no voice is using, for the next source voice
+ * with the same format. Filled by DestroyVoice and FAudio_WarmDecoderPoolEXT.
+ */
+typedef struct FAudioFFmpegDecoder FAudioFFmpegDecoder;
+typedef struct FAudioDecoderPool
+{
+	FAudioMutex lock;
+	FAudioFFmpegDecoder *head;
+	uint32_t idle;
+	uint32_t hits;
+	uint32_t misses;
+} FAudioDecoderPool;
+
 typedef void (FAUDIOCALL * FAudioDecodeCallback)(
 	FAudioVoice *voice,
 	FAudioBuffer *buffer,	/* Buffer to decode */
@@ -245,21 +518,278 @@ typedef void (FAUDIOCALL * FAudioResampleCallback)(
 	uint8_t channels
 );
 
+typedef void (FAUDIOCALL * FAudioSincResampleCallback)(
+	float *restrict history,
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+);
+
 typedef void (FAUDIOCALL * FAudioMixCallback)(
 	uint32_t toMix,
 	uint32_t srcChans,
 	uint32_t dstChans,
-	float baseVolume,
 	float *restrict srcData,
 	float *restrict dstData,
-	float *restrict channelVolume,
-	float *restrict coefficients
+	const float *restrict matrix
+);
+
+typedef void (FAUDIOCALL * FAudioResampleMixCallback)(
+	float *restrict dCache,
+	uint64_t resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint32_t dstChans,
+	float *restrict dstData,
+	const float *restrict matrix
+);
+
+/* Effective send matrices are stored per input channel, with each row padded
+ * to a whole number of 4-float vectors.
+ */
+#define MIX_MATRIX_STRIDE(dstChans) (((dstChans) + 3) & ~3)
+
+typedef void (FAUDIOCALL * FAudioFixedResampleCallback)(
+	float *restrict history,
+	const float *restrict input,
+	uint32_t inFrames,
+	float *restrict output,
+	uint32_t outFrames,
+	uint64_t resampleStep,
+	uint32_t channels
 );
 
-typedef void* FAudioPlatformFixedRateSRC;
+/* The parallel comb filters of FAudioFX's reverb, run side by side, a lane per
+ * comb. Each comb's feedback goes through a first-order high shelf, then a low
+ * shelf. The delay lines are interleaved in one buffer, a row per frame and a
+ * column per comb, so all the combs write a frame at once.
+ */
+#define FAUDIO_COMB_BANK_SIZE 8
+
+typedef struct FAudioCombShelf
+{
+	float a0[FAUDIO_COMB_BANK_SIZE];
+	float a1[FAUDIO_COMB_BANK_SIZE];
+	float b1[FAUDIO_COMB_BANK_SIZE];
+	float c0[FAUDIO_COMB_BANK_SIZE];
+	float d0[FAUDIO_COMB_BANK_SIZE];
+	float delay[FAUDIO_COMB_BANK_SIZE];
+} FAudioCombShelf;
+
+typedef struct FAudioCombBank
+{
+	float *buffer;		/* capacity rows of FAUDIO_COMB_BANK_SIZE */
+	uint32_t capacity;
+	uint32_t write_idx;
+	uint32_t read_idx[FAUDIO_COMB_BANK_SIZE];
+	uint32_t delay[FAUDIO_COMB_BANK_SIZE];
+	float feedback[FAUDIO_COMB_BANK_SIZE];
+	FAudioCombShelf high_shelving;
+	FAudioCombShelf low_shelving;
+} FAudioCombBank;
+
+/* Every input sample goes into all of the combs, the output is their mean */
+typedef void (FAUDIOCALL * FAudioCombBankCallback)(
+	FAudioCombBank *bank,
+	const float *restrict input,
+	float *restrict output,
+	uint32_t len
+);
+
+/* The 4-band EQ of FAPOFX, as a cascade of biquads in transposed direct form
+ * II with the same coefficient names as FAudioFX's DspBiQuad. Every channel
+ * goes through the same bands, so the channels run side by side, a lane per
+ * channel. The two delay elements of each band are rows of stride floats, one
+ * per channel, band after band; stride is the channel count rounded up to a
+ * multiple of 4, so a group of 4 lanes never runs off the end of a row. The
+ * padding has to start out as zero, and then stays that way.
+ */
+#define FAUDIO_EQ_BANDS 4
+
+typedef struct FAudioBiquadCascade
+{
+	float a0[FAUDIO_EQ_BANDS];
+	float a1[FAUDIO_EQ_BANDS];
+	float a2[FAUDIO_EQ_BANDS];
+	float b1[FAUDIO_EQ_BANDS];
+	float b2[FAUDIO_EQ_BANDS];
+	float *delay;		/* FAUDIO_EQ_BANDS * 2 rows of stride */
+	uint32_t stride;
+} FAudioBiquadCascade;
+
+#define FAUDIO_EQ_STRIDE(channels) (((channels) + 3) & ~3)
+
+/* Filters interleaved samples in place */
+typedef void (FAUDIOCALL * FAudioBiquadCascadeCallback)(
+	FAudioBiquadCascade *eq,
+	float *samples,
+	uint32_t frames,
+	uint32_t channels
+);
+
+/* The FFT of FAudioFX's convolution reverb: a complex FFT of size points, in
+ * place on separate real and imaginary arrays. size is a power of 4, at least
+ * 16, so every stage is radix-4. The output isn't scaled and is left in base-4
+ * digit-reversed order, bin k at the index with k's digits reversed. Swapping
+ * the arrays runs the inverse transform, scaled by size. twiddles
+ * holds FAUDIO_FFT_TWIDDLES(size) floats, filled in by FAudio_INTERNAL_InitFFT.
+ */
+#define FAUDIO_FFT_TWIDDLES(size) (2 * (size))
+
+typedef struct FAudioFFT
+{
+	uint32_t size;
+	float *twiddles;
+} FAudioFFT;
+
+typedef void (FAUDIOCALL * FAudioFFTCallback)(
+	const FAudioFFT *fft,
+	float *restrict re,
+	float *restrict im
+);
+
+/* Adds the product of two spectra of a real signal to acc, bins being a
+ * multiple of 4. Bin 0 holds the DC bin in its real part and the Nyquist bin
+ * in its imaginary part, and the two are multiplied separately.
+ */
+typedef void (FAUDIOCALL * FAudioSpectrumMACCallback)(
+	float *restrict accRe,
+	float *restrict accIm,
+	const float *restrict xRe,
+	const float *restrict xIm,
+	const float *restrict hRe,
+	const float *restrict hIm,
+	uint32_t bins
+);
+
+/* The vector math of F3DAudioCalculateBatchEXT, done on up to
+ * F3DAUDIO_BATCH_LANES emitters at a time, each array holding one value of
+ * every emitter. The quotients by the distance are those F3DAudioCalculate
+ * takes the cones' and the emitter angle's arccosines of, and the velocities
+ * are 0 at a distance of 0, as they are there. plane is where the emitter is
+ * in the listener's horizontal plane, front then right, and radius is its
+ * length.
+ */
+#define F3DAUDIO_BATCH_LANES 64
+
+typedef struct F3DAudioListenerFrame
+{
+	float front[3];
+	float right[3];
+	float top[3];
+	float position[3];
+	float velocity[3];
+} F3DAudioListenerFrame;
+
+typedef struct F3DAudioEmitterLanes
+{
+	/* In */
+	float position[3][F3DAUDIO_BATCH_LANES];
+	float velocity[3][F3DAUDIO_BATCH_LANES];
+	float front[3][F3DAUDIO_BATCH_LANES];
+	float curveDistanceScaler[F3DAUDIO_BATCH_LANES];
+
+	/* Out */
+	float toListener[3][F3DAUDIO_BATCH_LANES];
+	float distance[F3DAUDIO_BATCH_LANES];
+	float normalizedDistance[F3DAUDIO_BATCH_LANES];
+	float listenerFront[F3DAUDIO_BATCH_LANES];
+	float emitterFront[F3DAUDIO_BATCH_LANES];
+	float listenerVelocity[F3DAUDIO_BATCH_LANES];
+	float emitterVelocity[F3DAUDIO_BATCH_LANES];
+	float plane[2][F3DAUDIO_BATCH_LANES];
+	float radius[F3DAUDIO_BATCH_LANES];
+} F3DAudioEmitterLanes;
+
+/* count is a multiple of 4 */
+typedef void (FAUDIOCALL * F3DAudioEmitterLanesCallback)(
+	const F3DAudioListenerFrame *listener,
+	F3DAudioEmitterLanes *lanes,
+	uint32_t count
+);
 
 typedef float FAudioFilterState[4];
 
+typedef struct FAudio_OPERATIONSET_Operation FAudio_OPERATIONSET_Operation;
+
+/* Trace rings, see TraceEXT.
+ * Every thread that logs gets its own ring, claimed the first time it logs
+ * and only ever written by that thread, so recording an event takes no locks.
+ * The ring overwrites its oldest events; dumps skip whatever was overwritten
+ * while they were reading it.
+ */
+#define FAUDIO_TRACE_MAX_THREADS 64
+#define FAUDIO_MAX_TRACE_EVENTS 0x01000000
+
+typedef struct FAudioTraceEvent
+{
+	uint64_t time;		/* FAudio_timecycles */
+	const char *name;	/* Always a string literal */
+	const void *ptr;
+	uint64_t arg;
+	uint32_t category;	/* FAUDIO_LOG_* */
+	char phase;		/* Chrome trace event type */
+} FAudioTraceEvent;
+
+typedef struct FAudioTraceThread
+{
+	uint64_t threadID;
+	FAudioTraceEvent *events;
+	uint32_t eventMask;	/* Ring size - 1, the size is a power of two */
+	volatile int32_t head;	/* Events ever written */
+	volatile int32_t ready;	/* Set once the fields above are */
+} FAudioTraceThread;
+
+typedef struct FAudioTrace
+{
+	volatile uint32_t mask;
+	uint32_t eventCount;	/* For rings claimed from now on */
+	uint64_t startCycles;	/* Older events are from an earlier trace */
+	uint64_t startTime;	/* FAudio_timeus at startCycles */
+	volatile int32_t threadCount;
+	volatile int32_t droppedEvents;
+	FAudioTraceThread threads[FAUDIO_TRACE_MAX_THREADS];
+} FAudioTrace;
+
+/* Parallel mixing worker, see ParallelMixEXT.
+ * Worker 0 is the thread that called GenerateOutput; its sends write directly
+ * into the destination voices. Every other worker mixes into its own partial
+ * buffers, which get summed into the real destinations after the pass.
+ */
+typedef struct FAudioMixWorker
+{
+	FAudio *audio;
+	uint32_t index;
+	FAudioThread thread;
+	FAudioSemaphore start;
+	volatile int32_t claimed;	/* Task pools, by the pool or the audio thread */
+	int32_t scratchTrims;	/* The last trim this worker applied */
+
+	/* Temp storage for processing, interleaved PCM32F.
+	 * Both caches are carved out of one arena, each 64-byte aligned,
+	 * which is only ever regrown by the worker itself before a pass.
+	 */
+	void *arena;
+	uint32_t decodeSamples;
+	uint32_t resampleSamples;
+	float *decodeCache;
+	float *resampleCache;
+
+	/* Partial mixes, unused by worker 0 */
+	uint32_t masterSamples;
+	float *masterOutput;
+	uint8_t masterDirty;
+	uint32_t submixSlots;
+	uint32_t *submixSamples;
+	float **submixOutput;
+	uint8_t *submixDirty;
+} FAudioMixWorker;
+
+typedef void (*FAudioMixJob)(FAudioMixWorker *worker);
+
 /* Public FAudio Types */
 
 struct FAudio
@@ -268,28 +798,127 @@ struct FAudio
 	uint8_t active;
 	uint32_t refcount;
 	uint32_t updateSize;
+	uint32_t devicePeriod;	/* Requested, 0 for the platform default */
+	uint32_t deviceLatency;	/* Reported by the platform, in frames */
+	uint32_t renderAhead;	/* Periods, 0 to mix in the device callback */
+	volatile uint32_t renderUnderruns;
+	uint32_t deviceFormatRequest;	/* FAUDIO_DEVICE_FORMAT_*_EXT */
+	uint32_t deviceFormat;	/* What the platform opened, F32 if offline */
+	uint8_t deviceDither;	/* TPDF dither for 16-bit and 24-bit devices */
+	uint32_t ditherState[4];
+	float *deviceMix;	/* Mixed into for integer devices, then converted */
+	uint32_t bufferPoolSize;	/* Requested, allocated with the master */
+	uint32_t decodeAhead;	/* MSADPCM blocks, for new source voices */
+	uint32_t subBlockFrames;	/* 0 to mix source voices a pass at a time */
+	uint8_t keepDenormals;	/* Leave the mix threads' FTZ/DAZ alone */
+	FAudioBlockCache blockCache;
+	FAudioPredecoder predecoder;
+	FAudioDecoderPool decoderPool;
+	FAudioBufferPool bufferPool;
+	FAudioThreadSchedule threadSchedules[3];	/* FAUDIO_THREAD_*_EXT */
+	FAudioThreadScheduler mixScheduler;	/* Only used by the device thread */
+
+	/* Offline render, FAudio_RenderEXT pulls periods with no device.
+	 * offlineCache holds the rest of a period that was only partly read.
+	 */
+	uint8_t offline;
+	float *offlineCache;
+	uint32_t offlineCacheOffset;
 	FAudioMasteringVoice *master;
-	LinkedList *sources;
-	LinkedList *submixes;
+	FAudioVoiceTable sources;
+	FAudioVoiceTable submixes;
 	LinkedList *callbacks;
 	FAudioMutex sourceLock;
 	FAudioMutex submixLock;
 	FAudioMutex callbackLock;
+	FAudioMutex operationLock;
 	FAudioWaveFormatExtensible *mixFormat;
 
-	/* Temp storage for processing, interleaved PCM32F */
+	/* OperationSets, queued until committed, then run by the mixer */
+	FAudio_OPERATIONSET_Operation *queuedOperations;
+	FAudio_OPERATIONSET_Operation *committedOperations;
+
+	/* Temp storage sizes, the caches themselves are per-worker. cacheLock
+	 * guards them along with the voice sizes they're worked out from, see
+	 * FAudio_INTERNAL_TrimCaches.
+	 */
 	#define EXTRA_DECODE_PADDING 2
+	#define SINC_HISTORY_FRAMES 7
 	uint32_t decodeSamples;
 	uint32_t resampleSamples;
-	uint32_t effectChainSamples;
-	float *decodeCache;
-	float *resampleCache;
-	float *effectChainCache;
+	FAudioMutex cacheLock;
+	uint32_t cacheReservations;	/* Voices sized but not in a table yet */
+
+	/* Mixer threads, mixWorkers[0] is the audio thread itself */
+	#define FAUDIO_MAX_MIX_WORKERS 32
+	uint32_t mixWorkerCount;
+	FAudioMixWorker *mixWorkers;
+	FAudioSemaphore mixWorkersDone;
+	volatile uint8_t mixWorkersQuit;
+
+	/* With a task pool there are no worker threads, each pass submits a
+	 * task for every worker instead
+	 */
+	FAudioTaskPoolEXT *taskPool;
+	volatile int32_t mixTasksPending;
+
+	FAudioMixJob mixJob;
+	uint32_t mixJobBegin;
+	uint32_t mixJobEnd;
+
+	/* Per-pass snapshot of the active sources for the workers */
+	uint32_t mixSourceCount;
+	uint32_t mixSourceCapacity;
+	FAudioSourceVoice **mixSources;
+
+	/* Submix graph, sorted by level, rebuilt when the topology changes */
+	uint8_t submixGraphDirty;
+	uint32_t mixSubmixCount;
+	uint32_t mixSubmixCapacity;
+	FAudioSubmixVoice **mixSubmixes;
+	uint32_t *mixSubmixLevel;
+	uint32_t mixSubmixLevelCount;
+	uint32_t *mixSubmixLevelStart;
 
 	/* Allocator callbacks */
 	FAudioMallocFunc pMalloc;
 	FAudioFreeFunc pFree;
 	FAudioReallocFunc pRealloc;
+	FAudioAlignedMallocFunc pAlignedMalloc;	/* Optional, both or neither */
+	FAudioAlignedFreeFunc pAlignedFree;
+	volatile int32_t memoryUsage;	/* Bytes from FAudio_INTERNAL_Malloc */
+	volatile int32_t memoryCategories[FAUDIO_MEMORY_CATEGORY_COUNT];
+	volatile int32_t trimRequested;	/* Set by FAudio_TrimEXT */
+	int32_t scratchTrims;	/* Bumped by the mixer when it trims */
+
+	/* FAudio_GetPerformanceData, in FAudio_timecycles units. The mix
+	 * thread adds each pass, the query takes the totals and resets them.
+	 */
+	FAudioMutex perfLock;
+	uint64_t perfQueryCycles;
+	uint64_t perfAudioCycles;
+	uint32_t perfMinCycles;
+	uint32_t perfMaxCycles;
+	volatile uint32_t lateCallbacks;	/* Counted by the platform */
+
+	/* GovernorEXT, see FAudio_INTERNAL_UpdateGovernor. The settings are
+	 * guarded by perfLock. The rest is only written by the mix thread
+	 * between passes, so the workers read it as is.
+	 */
+	FAudioGovernorEXT governor;
+	uint8_t governorEnabled;
+	uint32_t governorLevel;
+	float governorQuietVolume;
+	uint32_t governorMeterDecimation;
+	float governorLoad;	/* Pass time over the period, smoothed */
+	uint32_t governorPass;
+	uint32_t governorRaiseWait;	/* Passes until the next level up */
+	uint64_t governorCalmSince;	/* FAudio_timeus, 0 if not calm */
+
+#ifndef FAUDIO_DISABLE_LOCK_STATS
+	/* LockStatsEXT from destroyed voices, guarded by perfLock */
+	FAudioLockStatsEXT retiredLockStats[FAUDIO_LOCK_COUNT_EXT];
+#endif /* FAUDIO_DISABLE_LOCK_STATS */
 
 	/* EngineProcedureEXT */
 	void *clientEngineUser;
@@ -298,6 +927,7 @@ struct FAudio
 #ifndef FAUDIO_DISABLE_DEBUGCONFIGURATION
 	/* Debug Information */
 	FAudioDebugConfiguration debug;
+	FAudioTrace trace;
 #endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 
 	/* Platform opaque pointer */
@@ -309,9 +939,11 @@ struct FAudioVoice
 	FAudio *audio;
 	uint32_t flags;
 	FAudioVoiceType type;
+	uint32_t tableSlot;	/* In audio->sources or audio->submixes */
 
 	FAudioVoiceSends sends;
 	float **sendCoefficients;
+	float **sendMatrix;
 	FAudioMixCallback *sendMix;
 	FAudioFilterParameters *sendFilter;
 	FAudioFilterState **sendFilterState;
@@ -323,6 +955,16 @@ struct FAudioVoice
 		uint32_t *parameterSizes;
 		uint8_t *parameterUpdates;
 		uint8_t *inPlaceProcessing;
+#ifndef FAUDIO_DISABLE_VOICE_PROFILE
+		uint64_t *cycles;	/* Per effect, see FAUDIO_VOICE_PROFILE_EXT */
+#endif /* FAUDIO_DISABLE_VOICE_PROFILE */
+
+		/* Effects that don't process in place write to these in
+		 * turn. Each fits updateSize frames of the widest effect
+		 * output, and they are made along with the chain so that
+		 * nothing is allocated while mixing.
+		 */
+		float *buffers[2];
 	} effects;
 	FAudioFilterParameters filter;
 	FAudioFilterState *filterState;
@@ -335,6 +977,32 @@ struct FAudioVoice
 	uint32_t outputChannels;
 	FAudioMutex volumeLock;
 
+	/* Mixer-side copies of filter/channelVolume. The setters flag an
+	 * update under the matching lock, and the mixer only takes that lock
+	 * when the flag is set, so most passes never touch either mutex.
+	 * mixChannelVolume shares its allocation with channelVolume.
+	 */
+	FAudioFilterParameters mixFilter;
+	float *mixChannelVolume;
+	uint8_t filterUpdate;
+	uint8_t channelVolumeUpdate;
+
+	/* sendMatrix is what the mixers actually use: the output matrix with
+	 * the voice and channel volumes already applied. It is rebuilt by the
+	 * mixer, under sendLock, only after one of those inputs has changed.
+	 */
+	uint8_t sendMatrixUpdate;
+
+	/* Set while the mixer is skipping this voice because nothing it sends
+	 * can be heard. Filter state is reset when the voice goes quiet.
+	 */
+	uint8_t culled;
+
+#ifndef FAUDIO_DISABLE_VOICE_PROFILE
+	/* FAUDIO_VOICE_PROFILE_EXT totals, only written by the mix thread */
+	FAudioVoicePerformanceDataEXT profile;
+#endif /* FAUDIO_DISABLE_VOICE_PROFILE */
+
 	union
 	{
 		struct
@@ -362,13 +1030,38 @@ struct FAudioVoice
 			FAudioResampleCallback resample;
 			FAudioVoiceCallback *callback;
 
+			/* Windowed-sinc voices only, the SINC_HISTORY_FRAMES
+			 * frames before the next pass's first decoded frame.
+			 */
+			float *resampleHistory;
+
+			/* MSADPCM voices only, a window of adpcmCacheBlocks
+			 * decoded blocks starting at adpcmCacheBlock of
+			 * adpcmCacheData. See DecodeAheadEXT.
+			 */
+			float *adpcmCache;
+			const uint8_t *adpcmCacheData;
+			uint32_t adpcmCacheBlock;
+			uint32_t adpcmCacheCount;
+			uint32_t adpcmCacheBlocks;
+
 			/* Dynamic */
 			uint8_t active;
 			float freqRatio;
 			uint8_t newBuffer;
 			uint64_t totalSamples;
 			FAudioBufferEntry *bufferList;
+			uint32_t bufferCount;
 			FAudioMutex bufferLock;
+
+			/* What GetState reports, republished under bufferLock
+			 * whenever it changes so that GetState needs no lock.
+			 * The sequence is odd while an update is being written.
+			 */
+			volatile int32_t stateSequence;
+			volatile uint64_t stateSamplesPlayed;
+			volatile uint32_t stateBuffersQueued;
+			void *volatile stateContext;
 		} src;
 		struct
 		{
@@ -376,12 +1069,35 @@ struct FAudioVoice
 			uint32_t inputSamples;
 			uint32_t outputSamples;
 			float *inputCache;
-			FAudioPlatformFixedRateSRC resampler;
+
+			/* Fixed-rate resampler, inputSamples to outputSamples per
+			 * pass. resampleHistory is the last input frame of the
+			 * previous pass. A step of FIXED_ONE means no resampling.
+			 */
+			uint64_t resampleStep;
+			float *resampleHistory;
 
 			/* Read-only */
 			uint32_t inputChannels;
 			uint32_t inputSampleRate;
 			uint32_t processingStage;
+
+			/* Partial mix slot, assigned by the submix graph */
+			uint32_t mixSlot;
+
+			/* Silence tracking, inputActive is set by any send that
+			 * mixes into inputCache during the pass.
+			 */
+			uint8_t inputActive;
+			uint8_t silentPasses;
+
+			/* Set while the submix is folded into foldTarget, see
+			 * FAudio_INTERNAL_FoldSubmixes. filteredInputs counts the
+			 * sends into this submix from voices with send filters.
+			 */
+			FAudioVoice *foldTarget;
+			float foldGain;
+			volatile int32_t filteredInputs;
 		} mix;
 		struct
 		{
@@ -396,16 +1112,83 @@ struct FAudioVoice
 };
 
 /* Internal Functions */
-void FAudio_INTERNAL_InsertSubmixSorted(
-	LinkedList **start,
-	FAudioSubmixVoice *toAdd,
-	FAudioMutex lock,
-	FAudioMallocFunc pMalloc
-);
 void FAudio_INTERNAL_UpdateEngine(FAudio *audio, float *output);
+/* For the platform, once updateSize is known and before the device starts.
+ * Integer formats make UpdateEngine write that format instead of float.
+ * Returns the size of a sample, in bytes.
+ */
+uint32_t FAudio_INTERNAL_SetDeviceFormat(FAudio *audio, uint32_t format);
+void FAudio_INTERNAL_CreateMixWorkers(FAudio *audio, uint32_t count);
+void FAudio_INTERNAL_DestroyMixWorkers(FAudio *audio);
+void FAudio_INTERNAL_InvalidateSubmixGraph(FAudio *audio);
+void FAudio_INTERNAL_CountFilteredSends(FAudioVoice *voice, int32_t delta);
+/* The Resize functions must be called with cacheLock held, along with the
+ * update of the voice size they're for. Voices that aren't in a table yet
+ * are covered by a reservation, from before they're first sized until they
+ * are added, so that FAudio_TrimEXT doesn't shrink the caches under them.
+ */
 void FAudio_INTERNAL_ResizeDecodeCache(FAudio *audio, uint32_t size);
 void FAudio_INTERNAL_ResizeResampleCache(FAudio *audio, uint32_t size);
-void FAudio_INTERNAL_ResizeEffectChainCache(FAudio *audio, uint32_t samples);
+void FAudio_INTERNAL_ReserveCaches(FAudio *audio);
+void FAudio_INTERNAL_UnreserveCaches(FAudio *audio);
+void FAudio_INTERNAL_ResizeBufferPool(FAudio *audio);
+void FAudio_INTERNAL_FreeBufferPool(FAudio *audio);
+FAudioBufferEntry* FAudio_INTERNAL_AllocBufferEntry(FAudio *audio);
+void FAudio_INTERNAL_FreeBufferEntry(FAudio *audio, FAudioBufferEntry *entry);
+void FAudio_INTERNAL_PublishVoiceState(FAudioSourceVoice *voice);
+FAudioBlockCacheSource* FAudio_INTERNAL_BlockCacheAcquire(
+	FAudio *audio,
+	const uint8_t *data,
+	uint16_t align,
+	uint16_t channels
+);
+void FAudio_INTERNAL_BlockCacheRelease(
+	FAudio *audio,
+	FAudioBlockCacheSource *source
+);
+void FAudio_INTERNAL_BlockCacheTrim(FAudio *audio);
+void FAudio_INTERNAL_FreeBlockCache(FAudio *audio);
+void FAudio_INTERNAL_StartPredecoder(FAudio *audio);
+void FAudio_INTERNAL_StopPredecoder(FAudio *audio);
+FAudioPredecodeJob* FAudio_INTERNAL_PredecodeBuffer(
+	FAudioSourceVoice *voice,
+	const FAudioBuffer *buffer
+);
+void FAudio_INTERNAL_CancelPredecode(FAudio *audio, FAudioBufferEntry *entry);
+void FAudio_INTERNAL_WakePredecoder(FAudio *audio);
+void FAudio_INTERNAL_InitThreadSchedule(FAudioThreadSchedule *schedule);
+void FAudio_INTERNAL_FreeThreadSchedule(FAudioThreadSchedule *schedule);
+void FAudio_INTERNAL_SetThreadSchedule(
+	FAudioThreadSchedule *schedule,
+	uint32_t flags,
+	uint64_t affinityMask
+);
+void FAudio_INTERNAL_ApplyThreadSchedule(
+	FAudioThreadSchedule *schedule,
+	FAudioThreadScheduler *scheduler,
+	FAudioThreadPriority priority
+);
+void FAudio_INTERNAL_SubmitTask(
+	FAudioTaskPoolEXT *pool,
+	FAudioTaskFuncEXT func,
+	void *data,
+	uint32_t delayUs,
+	uint32_t deadlineUs
+);
+uint32_t FAudio_INTERNAL_CancelTasks(
+	FAudioTaskPoolEXT *pool,
+	FAudioTaskFuncEXT func,
+	void *data
+);
+void FAudio_INTERNAL_StartPoolLoop(
+	FAudioPoolLoop *loop,
+	FAudioTaskPoolEXT *pool,
+	FAudioPoolLoopStep step,
+	void *data,
+	uint32_t deadlineUs
+);
+void FAudio_INTERNAL_WakePoolLoop(FAudioPoolLoop *loop);
+void FAudio_INTERNAL_StopPoolLoop(FAudioPoolLoop *loop);
 void FAudio_INTERNAL_AllocEffectChain(
 	FAudioVoice *voice,
 	const FAudioEffectChain *pEffectChain
@@ -413,6 +1196,81 @@ void FAudio_INTERNAL_AllocEffectChain(
 void FAudio_INTERNAL_FreeEffectChain(FAudioVoice *voice);
 extern const float FAUDIO_INTERNAL_MATRIX_DEFAULTS[8][8][64];
 
+/* OperationSet Functions */
+
+void FAudio_OPERATIONSET_Commit(FAudio *audio, uint32_t OperationSet);
+void FAudio_OPERATIONSET_Execute(FAudio *audio);
+
+void FAudio_OPERATIONSET_ClearAll(FAudio *audio);
+void FAudio_OPERATIONSET_ClearAllForVoice(FAudioVoice *voice);
+
+void FAudio_OPERATIONSET_QueueEnableEffect(
+	FAudioVoice *voice,
+	uint32_t EffectIndex,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueDisableEffect(
+	FAudioVoice *voice,
+	uint32_t EffectIndex,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueSetEffectParameters(
+	FAudioVoice *voice,
+	uint32_t EffectIndex,
+	const void *pParameters,
+	uint32_t ParametersByteSize,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueSetFilterParameters(
+	FAudioVoice *voice,
+	const FAudioFilterParameters *pParameters,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueSetOutputFilterParameters(
+	FAudioVoice *voice,
+	FAudioVoice *pDestinationVoice,
+	const FAudioFilterParameters *pParameters,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueSetVolume(
+	FAudioVoice *voice,
+	float Volume,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueSetChannelVolumes(
+	FAudioVoice *voice,
+	uint32_t Channels,
+	const float *pVolumes,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueSetOutputMatrix(
+	FAudioVoice *voice,
+	FAudioVoice *pDestinationVoice,
+	uint32_t SourceChannels,
+	uint32_t DestinationChannels,
+	const float *pLevelMatrix,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueStart(
+	FAudioSourceVoice *voice,
+	uint32_t Flags,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueStop(
+	FAudioSourceVoice *voice,
+	uint32_t Flags,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueExitLoop(
+	FAudioSourceVoice *voice,
+	uint32_t OperationSet
+);
+void FAudio_OPERATIONSET_QueueSetFrequencyRatio(
+	FAudioSourceVoice *voice,
+	float Ratio,
+	uint32_t OperationSet
+);
+
 /* Debug */
 
 #ifdef FAUDIO_DISABLE_DEBUGCONFIGURATION
@@ -425,13 +1283,14 @@ extern const float FAUDIO_INTERNAL_MATRIX_DEFAULTS[8][8][64];
 #define LOG_API_EXIT(engine)
 #define LOG_FUNC_ENTER(engine)
 #define LOG_FUNC_EXIT(engine)
-/* TODO: LOG_TIMING */
+#define LOG_TIMING_BEGIN(engine, name, ptr)
+#define LOG_TIMING_END(engine, name, ptr)
 #define LOG_MUTEX_CREATE(engine, mutex)
 #define LOG_MUTEX_DESTROY(engine, mutex)
 #define LOG_MUTEX_LOCK(engine, mutex)
 #define LOG_MUTEX_UNLOCK(engine, mutex)
-/* TODO: LOG_MEMORY */
-/* TODO: LOG_STREAMING */
+#define LOG_MEMORY(engine, name, ptr, size)
+#define LOG_STREAMING(engine, name, ptr, size)
 
 #define LOG_FORMAT(engine, waveFormat)
 
@@ -465,6 +1324,22 @@ void FAudio_INTERNAL_debug_fmt(
 	const FAudioWaveFormatEx *fmt
 );
 
+/* Records an event in the calling thread's TraceEXT ring */
+void FAudio_INTERNAL_trace(
+	FAudio *audio,
+	uint32_t category,
+	char phase,
+	const char *name,
+	const void *ptr,
+	uint64_t arg
+);
+void FAudio_INTERNAL_FreeTrace(FAudio *audio);
+uint32_t FAudio_INTERNAL_DumpTrace(
+	FAudio *audio,
+	FAudioTraceWriteFuncEXT writeFunc,
+	void *user
+);
+
 #define PRINT_DEBUG(engine, cond, type, fmt, ...) \
 	if (engine->debug.TraceMask & FAUDIO_LOG_##cond) \
 	{ \
@@ -478,21 +1353,41 @@ void FAudio_INTERNAL_debug_fmt(
 		); \
 	}
 
-#define LOG_ERROR(engine, fmt, ...) PRINT_DEBUG(engine, ERRORS, "ERROR", fmt, __VA_ARGS__)
-#define LOG_WARNING(engine, fmt, ...) PRINT_DEBUG(engine, WARNINGS, "WARNING", fmt, __VA_ARGS__)
-#define LOG_INFO(engine, fmt, ...) PRINT_DEBUG(engine, INFO, "INFO", fmt, __VA_ARGS__)
-#define LOG_DETAIL(engine, fmt, ...) PRINT_DEBUG(engine, DETAIL, "DETAIL", fmt, __VA_ARGS__)
-#define LOG_API_ENTER(engine) PRINT_DEBUG(engine, API_CALLS, "API Enter", "%s", __func__)
-#define LOG_API_EXIT(engine) PRINT_DEBUG(engine, API_CALLS, "API Exit", "%s", __func__)
-#define LOG_FUNC_ENTER(engine) PRINT_DEBUG(engine, FUNC_CALLS, "FUNC Enter", "%s", __func__)
-#define LOG_FUNC_EXIT(engine) PRINT_DEBUG(engine, FUNC_CALLS, "FUNC Exit", "%s", __func__)
-/* TODO: LOG_TIMING */
-#define LOG_MUTEX_CREATE(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Create", "%p", mutex)
-#define LOG_MUTEX_DESTROY(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Destroy", "%p", mutex)
-#define LOG_MUTEX_LOCK(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Lock", "%p", mutex)
-#define LOG_MUTEX_UNLOCK(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Unlock", "%p", mutex)
-/* TODO: LOG_MEMORY */
-/* TODO: LOG_STREAMING */
+/* Trace events only keep the name, never the formatted arguments, so the name
+ * must be a string literal.
+ */
+#define TRACE_DEBUG(engine, cond, phase, name, ptr, arg) \
+	if (engine->trace.mask & FAUDIO_LOG_##cond) \
+	{ \
+		FAudio_INTERNAL_trace( \
+			engine, \
+			FAUDIO_LOG_##cond, \
+			phase, \
+			name, \
+			ptr, \
+			arg \
+		); \
+	}
+
+#define LOG_ERROR(engine, fmt, ...) PRINT_DEBUG(engine, ERRORS, "ERROR", fmt, __VA_ARGS__) TRACE_DEBUG(engine, ERRORS, 'i', fmt, NULL, 0)
+#define LOG_WARNING(engine, fmt, ...) PRINT_DEBUG(engine, WARNINGS, "WARNING", fmt, __VA_ARGS__) TRACE_DEBUG(engine, WARNINGS, 'i', fmt, NULL, 0)
+#define LOG_INFO(engine, fmt, ...) PRINT_DEBUG(engine, INFO, "INFO", fmt, __VA_ARGS__) TRACE_DEBUG(engine, INFO, 'i', fmt, NULL, 0)
+#define LOG_DETAIL(engine, fmt, ...) PRINT_DEBUG(engine, DETAIL, "DETAIL", fmt, __VA_ARGS__) TRACE_DEBUG(engine, DETAIL, 'i', fmt, NULL, 0)
+#define LOG_API_ENTER(engine) PRINT_DEBUG(engine, API_CALLS, "API Enter", "%s", __func__) TRACE_DEBUG(engine, API_CALLS, 'B', __func__, NULL, 0)
+#define LOG_API_EXIT(engine) PRINT_DEBUG(engine, API_CALLS, "API Exit", "%s", __func__) TRACE_DEBUG(engine, API_CALLS, 'E', __func__, NULL, 0)
+#define LOG_FUNC_ENTER(engine) PRINT_DEBUG(engine, FUNC_CALLS, "FUNC Enter", "%s", __func__) TRACE_DEBUG(engine, FUNC_CALLS, 'B', __func__, NULL, 0)
+#define LOG_FUNC_EXIT(engine) PRINT_DEBUG(engine, FUNC_CALLS, "FUNC Exit", "%s", __func__) TRACE_DEBUG(engine, FUNC_CALLS, 'E', __func__, NULL, 0)
+#define LOG_TIMING_BEGIN(engine, name, ptr) PRINT_DEBUG(engine, TIMING, "Timing Begin", "%s %p", name, ptr) TRACE_DEBUG(engine, TIMING, 'B', name, ptr, 0)
+#define LOG_TIMING_END(engine, name, ptr) PRINT_DEBUG(engine, TIMING, "Timing End", "%s %p", name, ptr) TRACE_DEBUG(engine, TIMING, 'E', name, ptr, 0)
+#define LOG_MUTEX_CREATE(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Create", "%p", mutex) TRACE_DEBUG(engine, LOCKS, 'i', "Mutex Create", mutex, 0)
+#define LOG_MUTEX_DESTROY(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Destroy", "%p", mutex) TRACE_DEBUG(engine, LOCKS, 'i', "Mutex Destroy", mutex, 0)
+#define LOG_MUTEX_LOCK(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Lock", "%p", mutex) TRACE_DEBUG(engine, LOCKS, 'i', "Mutex Lock", mutex, 0)
+#define LOG_MUTEX_UNLOCK(engine, mutex) PRINT_DEBUG(engine, LOCKS, "Mutex Unlock", "%p", mutex) TRACE_DEBUG(engine, LOCKS, 'i', "Mutex Unlock", mutex, 0)
+#define LOG_MEMORY(engine, name, ptr, size) \
+	PRINT_DEBUG(engine, MEMORY, "Memory", "%s %p, %u bytes", name, ptr, (uint32_t) (size)) \
+	TRACE_DEBUG(engine, MEMORY, 'i', name, ptr, size) \
+	TRACE_DEBUG(engine, MEMORY, 'C', "Memory Usage", NULL, FAudio_PlatformAtomicGet(&engine->memoryUsage))
+#define LOG_STREAMING(engine, name, ptr, size) PRINT_DEBUG(engine, STREAMING, "Streaming", "%s %p, %u", name, ptr, (uint32_t) (size)) TRACE_DEBUG(engine, STREAMING, 'i', name, ptr, size)
 
 #define LOG_FORMAT(engine, waveFormat) \
 	if (engine->debug.TraceMask & FAUDIO_LOG_INFO) \
@@ -504,10 +1399,108 @@ void FAudio_INTERNAL_debug_fmt(
 			__func__, \
 			waveFormat \
 		); \
-	}
+	} \
+	TRACE_DEBUG(engine, INFO, 'i', "Format", waveFormat, waveFormat->wFormatTag)
 
 #endif /* FAUDIO_DISABLE_DEBUGCONFIGURATION */
 
+/* Voice Profiling
+ * PROFILE_START reads the clock for a voice with FAUDIO_VOICE_PROFILE_EXT,
+ * each PROFILE_LAP adds the time since the last start or lap to a counter.
+ * Both need PROFILE_STAMP with the function's declarations.
+ */
+
+#ifdef FAUDIO_DISABLE_VOICE_PROFILE
+
+#define PROFILE_STAMP
+#define PROFILE_START(voice)
+#define PROFILE_LAP(voice, counter)
+#define PROFILE_FRAMES(voice, frames)
+
+#else
+
+#define PROFILE_STAMP uint64_t profileStamp = 0;
+#define PROFILE_START(voice) \
+	if ((voice)->flags & FAUDIO_VOICE_PROFILE_EXT) \
+	{ \
+		profileStamp = FAudio_timecycles(); \
+	}
+#define PROFILE_LAP(voice, counter) \
+	if ((voice)->flags & FAUDIO_VOICE_PROFILE_EXT) \
+	{ \
+		uint64_t profileNow = FAudio_timecycles(); \
+		counter += profileNow - profileStamp; \
+		profileStamp = profileNow; \
+	}
+#define PROFILE_FRAMES(voice, frames) \
+	if ((voice)->flags & FAUDIO_VOICE_PROFILE_EXT) \
+	{ \
+		(voice)->profile.FramesProcessed += frames; \
+	}
+
+#endif /* FAUDIO_DISABLE_VOICE_PROFILE */
+
+/* Effect Tails */
+
+/* Effects that keep ringing after their input stops, like reverb and echo,
+ * use this to go idle once they have died out. The effect is idle while its
+ * state is all zero: it outputs silence without processing anything until a
+ * buffer that isn't FAPO_BUFFER_SILENT comes in. Effects start out idle.
+ */
+#define FAUDIO_EFFECT_TAIL_SILENCE 0.0000001f
+
+typedef struct FAudioEffectTail
+{
+	uint32_t silentFrames;	/* Silent input since the last sound */
+	uint8_t idle;
+} FAudioEffectTail;
+
+/* Returns 1 if the effect can skip this buffer */
+uint8_t FAudio_INTERNAL_EffectTailIdle(
+	FAudioEffectTail *tail,
+	FAPOBufferFlags inputFlags,
+	uint32_t frames
+);
+
+/* Call with the sum of squares of every processed buffer. Returns 1 once the
+ * input has been silent for longer than tailFrames and the output has fallen
+ * below FAUDIO_EFFECT_TAIL_SILENCE; the effect should clear its state then.
+ */
+uint8_t FAudio_INTERNAL_EffectTailEnded(
+	FAudioEffectTail *tail,
+	uint32_t tailFrames,
+	float energy
+);
+
+/* For GovernorEXT, which skips passes of FAudioCreateVolumeMeter's effects */
+uint8_t FAudioFX_INTERNAL_IsVolumeMeter(FAPO *fapo);
+
+/* FAudioFX Reverb Network, also run by FAPOFX's FXReverb */
+
+typedef struct DspReverb DspReverb;
+struct FAudioFXReverbParameters;
+
+DspReverb *DspReverb_Create(
+	int32_t sampleRate,
+	int32_t in_channels,
+	int32_t out_channels,
+	FAudioMallocFunc pMalloc
+);
+void DspReverb_SetParameters(
+	DspReverb *reverb,
+	struct FAudioFXReverbParameters *params
+);
+/* sample_count is in samples of the input, returns the output's energy */
+float DspReverb_Process(
+	DspReverb *reverb,
+	const float *samples_in,
+	float *samples_out,
+	size_t sample_count,
+	int32_t num_channels
+);
+void DspReverb_Reset(DspReverb *reverb);
+void DspReverb_Destroy(DspReverb *reverb, FAudioFreeFunc pFree);
+
 /* FAPOFX Creators */
 
 #define CREATE_FAPOFX_FUNC(effect) \
@@ -542,10 +1535,48 @@ extern void (*FAudio_INTERNAL_Convert_S16_To_F32)(
 	float *restrict dst,
 	uint32_t len
 );
+extern void (*FAudio_INTERNAL_Convert_S24_To_F32)(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+);
+extern void (*FAudio_INTERNAL_UnpackNibbles)(
+	const uint8_t *restrict src,
+	int8_t *restrict dst,
+	uint32_t len
+);
+extern void (*FAudio_INTERNAL_InterleaveF32)(
+	const float *const *src,
+	float *restrict dst,
+	uint32_t frames,
+	uint32_t channels
+);
+/* dither is the state of 4 TPDF generators, or NULL for no dither */
+extern void (*FAudio_INTERNAL_Convert_F32_To_S16)(
+	const float *restrict src,
+	int16_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+);
+extern void (*FAudio_INTERNAL_Convert_F32_To_S24)(
+	const float *restrict src,
+	uint8_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+);
+extern void (*FAudio_INTERNAL_Convert_F32_To_S32)(
+	const float *restrict src,
+	int32_t *restrict dst,
+	uint32_t len
+);
 
 extern FAudioResampleCallback FAudio_INTERNAL_ResampleMono;
 extern FAudioResampleCallback FAudio_INTERNAL_ResampleStereo;
-extern void FAudio_INTERNAL_ResampleGeneric(
+extern FAudioResampleMixCallback FAudio_INTERNAL_ResampleMixMono;
+extern FAudioFixedResampleCallback FAudio_INTERNAL_ResampleFixed;
+extern FAudioResampleCallback FAudio_INTERNAL_ResampleGeneric;
+extern FAudioSincResampleCallback FAudio_INTERNAL_ResampleSinc;
+extern void FAudio_INTERNAL_ResampleNearest(
 	float *restrict dCache,
 	float *restrict resampleCache,
 	uint64_t *resampleOffset,
@@ -560,27 +1591,77 @@ extern void (*FAudio_INTERNAL_Amplify)(
 	float volume
 );
 
+extern uint8_t (*FAudio_INTERNAL_IsSilent)(
+	const float *samples,
+	uint32_t totalSamples
+);
+
+extern void (*FAudio_INTERNAL_FramePeaks)(
+	const float *restrict samples,
+	float *restrict peaks,
+	uint32_t frames,
+	uint32_t channels
+);
+
+extern void (*FAudio_INTERNAL_ChannelLevels)(
+	const float *restrict samples,
+	float *restrict peaks,
+	float *restrict sums,
+	uint32_t frames,
+	uint32_t channels
+);
+
+extern void (*FAudio_INTERNAL_FilterVoice)(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t numChannels
+);
+
+extern FAudioCombBankCallback FAudio_INTERNAL_ProcessCombBank;
+extern FAudioBiquadCascadeCallback FAudio_INTERNAL_ProcessBiquadCascade;
+extern FAudioFFTCallback FAudio_INTERNAL_FFT;
+extern FAudioSpectrumMACCallback FAudio_INTERNAL_SpectrumMAC;
+extern F3DAudioEmitterLanesCallback FAudio_INTERNAL_EmitterLanes;
+
+void FAudio_INTERNAL_InitFFT(FAudioFFT *fft, float *twiddles, uint32_t size);
+
 #define MIX_FUNC(type) \
 	extern void FAudio_INTERNAL_Mix_##type##_Scalar( \
 		uint32_t toMix, \
 		uint32_t srcChans, \
 		uint32_t dstChans, \
-		float baseVolume, \
 		float *restrict srcData, \
 		float *restrict dstData, \
-		float *restrict channelVolume, \
-		float *restrict coefficients \
-	);
+		const float *restrict matrix \
+	); \
+	extern FAudioMixCallback FAudio_INTERNAL_Mix_##type;
 MIX_FUNC(Generic)
 MIX_FUNC(1in_1out)
 MIX_FUNC(1in_2out)
 MIX_FUNC(1in_6out)
+MIX_FUNC(1in_8out)
 MIX_FUNC(2in_1out)
 MIX_FUNC(2in_2out)
 MIX_FUNC(2in_6out)
+MIX_FUNC(2in_8out)
+MIX_FUNC(6in_2out)
+MIX_FUNC(6in_6out)
+MIX_FUNC(8in_8out)
 #undef MIX_FUNC
 
-void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON);
+void FAudio_INTERNAL_InitSIMDFunctions(
+	uint8_t hasSSE2,
+	uint8_t hasAVX2,
+	uint8_t hasNEON
+);
+
+/* Sets flush-to-zero/denormals-are-zero on the calling thread, returning the
+ * previous state to be given back to RestoreDenormals.
+ */
+uint64_t FAudio_INTERNAL_FlushDenormals(void);
+void FAudio_INTERNAL_RestoreDenormals(uint64_t state);
 
 /* Decoders */
 
@@ -603,14 +1684,64 @@ DECODE_FUNC(FFMPEG)
 #endif /* HAVE_FFMPEG */
 #undef DECODE_FUNC
 
+/* Whole MS-ADPCM blocks straight to PCM16, for FACT's TranscodeEXT. Every
+ * block is (nBlockAlign / channels - 6) * 2 frames, all of which are written.
+ */
+void FAudio_INTERNAL_TranscodeMSADPCM(
+	const uint8_t *data,
+	uint32_t blocks,
+	uint16_t nBlockAlign,
+	uint16_t channels,
+	int16_t *out
+);
+
 /* FFmpeg */
 
 #ifdef HAVE_FFMPEG
 uint32_t FAudio_FFMPEG_init(FAudioSourceVoice *pSourceVoice, uint32_t type);
 void FAudio_FFMPEG_free(FAudioSourceVoice *voice);
-void FAudio_FFMPEG_reset(FAudioSourceVoice *voice);
+void FAudio_FFMPEG_reset(FAudioSourceVoice *voice, const FAudioBuffer *next);
+void FAudio_FFMPEG_flush(FAudioSourceVoice *voice);
+uint8_t FAudio_FFMPEG_decodeahead(FAudio *audio);
+uint32_t FAudio_FFMPEG_warm(
+	FAudio *audio,
+	const FAudioWaveFormatEx *format,
+	uint32_t count
+);
+void FAudio_FFMPEG_freepool(FAudio *audio);
 #endif /* HAVE_FFMPEG */
 
+/* ALSA */
+
+#ifdef HAVE_ALSA
+/* Opens a native device for FAudio_PlatformInit, mixing on its own thread
+ * once started. channels, sampleRate and period are what the engine wants,
+ * with a period of 0 picking a low latency default, and are updated to what
+ * the device took. Returns NULL if the device couldn't be opened.
+ */
+void* FAudio_ALSA_Open(
+	FAudio *audio,
+	uint32_t deviceIndex,
+	uint32_t *channels,
+	uint32_t *sampleRate,
+	uint32_t *period,
+	uint32_t *format,
+	uint32_t *latency
+);
+void FAudio_ALSA_Start(void *device);
+void FAudio_ALSA_Close(void *device);
+uint32_t FAudio_ALSA_GetDeviceCount(void);
+/* Index 0 is the default device. Writes the ALSA device name, or the
+ * description if asked for one, and returns 0 for an unknown index.
+ */
+uint8_t FAudio_ALSA_GetDeviceName(
+	uint32_t index,
+	uint8_t description,
+	char *name,
+	size_t len
+);
+#endif /* HAVE_ALSA */
+
 /* Platform Functions */
 
 void FAudio_PlatformAddRef(void);
@@ -624,20 +1755,6 @@ void FAudio_PlatformGetDeviceDetails(
 	FAudioDeviceDetails *details
 );
 
-FAudioPlatformFixedRateSRC FAudio_PlatformInitFixedRateSRC(
-	uint32_t channels,
-	uint32_t inputRate,
-	uint32_t outputRate
-);
-void FAudio_PlatformCloseFixedRateSRC(FAudioPlatformFixedRateSRC resampler);
-uint32_t FAudio_PlatformResample(
-	FAudioPlatformFixedRateSRC resampler,
-	float *input,
-	uint32_t inLen,
-	float *output,
-	uint32_t outLen
-);
-
 /* Threading */
 
 FAudioThread FAudio_PlatformCreateThread(
@@ -647,16 +1764,69 @@ FAudioThread FAudio_PlatformCreateThread(
 );
 void FAudio_PlatformWaitThread(FAudioThread thread, int32_t *retval);
 void FAudio_PlatformThreadPriority(FAudioThreadPriority priority);
+/* Applies FAUDIO_THREAD_*_EXT flags and a CPU mask to the calling thread,
+ * undoing what scheduler says was applied before. priority is what the
+ * thread goes back to without FAUDIO_THREAD_REALTIME_EXT. Returns the flags
+ * that took effect.
+ */
+uint32_t FAudio_PlatformThreadScheduling(
+	FAudioThreadScheduler *scheduler,
+	FAudioThreadPriority priority,
+	uint32_t flags,
+	uint64_t affinityMask
+);
 uint64_t FAudio_PlatformGetThreadID();
 FAudioMutex FAudio_PlatformCreateMutex(void);
 void FAudio_PlatformDestroyMutex(FAudioMutex mutex);
 void FAudio_PlatformLockMutex(FAudioMutex mutex);
 void FAudio_PlatformUnlockMutex(FAudioMutex mutex);
+/* Adds the mutex's LockStatsEXT counters to stats, keeping the larger
+ * MaxWaitCycles. Waits made while the thread is marked as mixing also count
+ * as mixer waits. Both do nothing with FAUDIO_DISABLE_LOCK_STATS.
+ */
+void FAudio_PlatformGetMutexStats(FAudioMutex mutex, FAudioLockStatsEXT *stats);
+void FAudio_PlatformSetMixThread(uint8_t mixing);
+FAudioSemaphore FAudio_PlatformCreateSemaphore(uint32_t initialValue);
+void FAudio_PlatformDestroySemaphore(FAudioSemaphore semaphore);
+void FAudio_PlatformWaitSemaphore(FAudioSemaphore semaphore);
+/* Returns 1 if the semaphore was posted, 0 if the timeout passed first */
+uint8_t FAudio_PlatformWaitSemaphoreTimeout(
+	FAudioSemaphore semaphore,
+	uint32_t timeoutMS
+);
+void FAudio_PlatformPostSemaphore(FAudioSemaphore semaphore);
+uint32_t FAudio_PlatformGetProcessorCount(void);
 void FAudio_sleep(uint32_t ms);
 
+/* Atomics */
+
+int32_t FAudio_PlatformAtomicGet(volatile int32_t *value);
+int32_t FAudio_PlatformAtomicAdd(volatile int32_t *value, int32_t add);
+uint8_t FAudio_PlatformAtomicCompareExchange(
+	volatile int32_t *value,
+	int32_t oldValue,
+	int32_t newValue
+);
+
 /* Time */
 
 uint32_t FAudio_timems(void);
+uint64_t FAudio_timecycles(void);
+uint64_t FAudio_timeus(void);
+
+/* I/O */
+
+/* Asks the OS to start reading in part of a FAudio_mmapopen mapping */
+void FAudio_PlatformWillNeed(const void *ptr, size_t len);
+
+/* Files written by FAudio itself, like FAUDIO_TRACE_FILE */
+void* FAudio_PlatformOpenWriteFile(const char *path);
+size_t FAUDIOCALL FAudio_PlatformWriteFile(
+	void *file,
+	const void *data,
+	size_t size
+);
+void FAudio_PlatformCloseWriteFile(void *file);
 
 /* Resampling */
 
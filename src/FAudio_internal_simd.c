@@ -26,7 +26,7 @@
 
 #include "FAudio_internal.h"
 
-/* SECTION 0: SSE/NEON Detection */
+/* SECTION 0: SSE/AVX/NEON Detection */
 
 /* The SSE/NEON detection comes from MojoAL:
  * https://hg.icculus.org/icculus/mojoAL/file/default/mojoal.c
@@ -65,6 +65,32 @@
 #define HAVE_SSE2_INTRINSICS 1
 #endif
 
+/* tests/simd.c builds this file into itself and compares every SIMD kernel
+ * against its scalar version, so it needs those on every platform.
+ */
+#ifdef FAUDIO_SIMD_TESTS
+#undef NEED_SCALAR_CONVERTER_FALLBACKS
+#define NEED_SCALAR_CONVERTER_FALLBACKS 1
+#endif
+
+/* AVX2 is never assumed, so those functions are built for it on their own
+ * and only picked at runtime. This needs a compiler that can target single
+ * functions, which MSVC does implicitly.
+ */
+#if HAVE_SSE2_INTRINSICS && !defined(FAUDIO_DISABLE_AVX2)
+#if defined(__clang__) || (defined(__GNUC__) && (__GNUC__ >= 5))
+#define HAVE_AVX2_INTRINSICS 1
+#define FAUDIO_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER) && (_MSC_VER >= 1800)
+#define HAVE_AVX2_INTRINSICS 1
+#define FAUDIO_TARGET_AVX2
+#endif
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+#include <immintrin.h>
+#endif
+
 /* SECTION 1: Type Converters */
 
 /* The SSE/NEON converters are based on SDL_audiotypecvt:
@@ -201,6 +227,65 @@ void FAudio_INTERNAL_Convert_S16_To_F32_SSE2(
 }
 #endif /* HAVE_SSE2_INTRINSICS */
 
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Convert_U8_To_F32_AVX2(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i = 0;
+	const __m256 divby128 = _mm256_set1_ps(DIVBY128);
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	/* src and dst never overlap here, unlike SDL's in-place converters,
+	 * so there's no need to walk backwards or align anything.
+	 */
+	for (; (i + 8) <= len; i += 8)
+	{
+		const __m256i ints = _mm256_cvtepu8_epi32(
+			_mm_loadl_epi64((const __m128i*) (src + i))
+		);
+		_mm256_storeu_ps(
+			dst + i,
+			_mm256_sub_ps(
+				_mm256_mul_ps(_mm256_cvtepi32_ps(ints), divby128),
+				one
+			)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = (src[i] * DIVBY128) - 1.0f;
+	}
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Convert_S16_To_F32_AVX2(
+	const int16_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i = 0;
+	const __m256 divby32768 = _mm256_set1_ps(DIVBY32768);
+
+	for (; (i + 8) <= len; i += 8)
+	{
+		const __m256i ints = _mm256_cvtepi16_epi32(
+			_mm_loadu_si128((const __m128i*) (src + i))
+		);
+		_mm256_storeu_ps(
+			dst + i,
+			_mm256_mul_ps(_mm256_cvtepi32_ps(ints), divby32768)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = src[i] * DIVBY32768;
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
 #if HAVE_NEON_INTRINSICS
 void FAudio_INTERNAL_Convert_U8_To_F32_NEON(
 	const uint8_t *restrict src,
@@ -289,545 +374,4459 @@ void FAudio_INTERNAL_Convert_S16_To_F32_NEON(
 }
 #endif /* HAVE_NEON_INTRINSICS */
 
-/* SECTION 2: Linear Resamplers */
+/* Packed little-endian 24-bit samples. Each one is moved to the top of an
+ * int32 and shifted back down to sign-extend it. The scale stays a divide, so
+ * every version matches the original scalar decoder exactly (well, except
+ * for ARMv7 NEON, which has no vector divide).
+ */
+#define DIVBY8388607 8388607.0f
+#define S24_TO_F32(src) ( \
+	((int32_t) ( \
+		((uint32_t) (src)[2] << 24) | \
+		((uint32_t) (src)[1] << 16) | \
+		((uint32_t) (src)[0] << 8) \
+	) >> 8) / DIVBY8388607 \
+)
 
-void FAudio_INTERNAL_ResampleGeneric(
-	float *restrict dCache,
-	float *restrict resampleCache,
-	uint64_t *resampleOffset,
-	uint64_t resampleStep,
-	uint64_t toResample,
-	uint8_t channels
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_Convert_S24_To_F32_Scalar(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
 ) {
-	uint32_t i, j;
-	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
-	for (i = 0; i < toResample; i += 1)
+	uint32_t i;
+	for (i = 0; i < len; i += 1, src += 3)
 	{
-		for (j = 0; j < channels; j += 1)
-		{
-			/* lerp, then convert to float value */
-			*resampleCache++ = (float) (
-				dCache[j] +
-				(dCache[j + channels] - dCache[j]) *
-				FIXED_TO_DOUBLE(cur)
-			);
-		}
-
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur += resampleStep;
-
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur >> FIXED_PRECISION) * channels;
-
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur &= FIXED_FRACTION_MASK;
+		*dst++ = S24_TO_F32(src);
 	}
 }
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-#if NEED_SCALAR_CONVERTER_FALLBACKS
-void FAudio_INTERNAL_ResampleMono_Scalar(
-	float *restrict dCache,
-	float *restrict resampleCache,
-	uint64_t *resampleOffset,
-	uint64_t resampleStep,
-	uint64_t toResample,
-	uint8_t UNUSED
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_Convert_S24_To_F32_SSE2(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
 ) {
 	uint32_t i;
-	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
-	for (i = 0; i < toResample; i += 1)
+	__m128i bytes, lo, hi;
+	const __m128 scale = _mm_set1_ps(DIVBY8388607);
+
+	/* Four samples are 12 bytes, but each load takes 16 */
+	for (i = 0; i + 6 <= len; i += 4, src += 12, dst += 4)
 	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[1] - dCache[0]) *
-			FIXED_TO_DOUBLE(cur)
+		/* Line the samples up at byte 0, 3, 6 and 9 of each lane */
+		bytes = _mm_loadu_si128((const __m128i*) src);
+		lo = _mm_unpacklo_epi32(bytes, _mm_srli_si128(bytes, 3));
+		hi = _mm_unpacklo_epi32(
+			_mm_srli_si128(bytes, 6),
+			_mm_srli_si128(bytes, 9)
 		);
+		bytes = _mm_unpacklo_epi64(lo, hi);
+		bytes = _mm_srai_epi32(_mm_slli_epi32(bytes, 8), 8);
+		_mm_storeu_ps(dst, _mm_div_ps(_mm_cvtepi32_ps(bytes), scale));
+	}
+	for (; i < len; i += 1, src += 3)
+	{
+		*dst++ = S24_TO_F32(src);
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
 
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur += resampleStep;
-
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur >> FIXED_PRECISION);
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Convert_S24_To_F32_AVX2(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	__m256i bytes;
+	const __m256 scale = _mm256_set1_ps(DIVBY8388607);
+	/* Bytes 0-11 go to the low lane and 12-23 to the high lane... */
+	const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+	/* ... then each sample goes to the top 3 bytes of its int32 */
+	const __m256i shuffle = _mm256_setr_epi8(
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+		-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11
+	);
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur &= FIXED_FRACTION_MASK;
+	/* Eight samples are 24 bytes, but each load takes 32 */
+	for (i = 0; i + 11 <= len; i += 8, src += 24, dst += 8)
+	{
+		bytes = _mm256_loadu_si256((const __m256i*) src);
+		bytes = _mm256_permutevar8x32_epi32(bytes, lanes);
+		bytes = _mm256_srai_epi32(_mm256_shuffle_epi8(bytes, shuffle), 8);
+		_mm256_storeu_ps(
+			dst,
+			_mm256_div_ps(_mm256_cvtepi32_ps(bytes), scale)
+		);
+	}
+	for (; i < len; i += 1, src += 3)
+	{
+		*dst++ = S24_TO_F32(src);
 	}
 }
+#endif /* HAVE_AVX2_INTRINSICS */
 
-void FAudio_INTERNAL_ResampleStereo_Scalar(
-	float *restrict dCache,
-	float *restrict resampleCache,
-	uint64_t *resampleOffset,
-	uint64_t resampleStep,
-	uint64_t toResample,
-	uint8_t UNUSED
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_Convert_S24_To_F32_NEON(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
 ) {
-	uint32_t i;
-	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
-	for (i = 0; i < toResample; i += 1)
+	uint32_t i, j;
+	uint8x8x3_t bytes;
+	uint16x8_t low;
+	uint8x8x2_t high;
+	int16x8_t top;
+	int32x4_t samples[2];
+#if defined(__aarch64__) || defined(_M_ARM64)
+	const float32x4_t scale = vdupq_n_f32(DIVBY8388607);
+#else
+	const float32x4_t scale = vdupq_n_f32(1.0f / DIVBY8388607);
+#endif
+
+	for (i = 0; i + 8 <= len; i += 8, src += 24, dst += 8)
 	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[2] - dCache[0]) *
-			FIXED_TO_DOUBLE(cur)
+		/* vld3 splits the low, middle and high bytes of 8 samples */
+		bytes = vld3_u8(src);
+		low = vmovl_u8(bytes.val[0]);
+		high = vzip_u8(bytes.val[1], bytes.val[2]);
+		top = vreinterpretq_s16_u8(vcombine_u8(high.val[0], high.val[1]));
+		samples[0] = vorrq_s32(
+			vshlq_n_s32(vmovl_s16(vget_low_s16(top)), 8),
+			vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(low)))
 		);
-		*resampleCache++ = (float) (
-			dCache[1] +
-			(dCache[3] - dCache[1]) *
-			FIXED_TO_DOUBLE(cur)
+		samples[1] = vorrq_s32(
+			vshlq_n_s32(vmovl_s16(vget_high_s16(top)), 8),
+			vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(low)))
 		);
+		for (j = 0; j < 2; j += 1)
+		{
+#if defined(__aarch64__) || defined(_M_ARM64)
+			vst1q_f32(
+				dst + (j * 4),
+				vdivq_f32(vcvtq_f32_s32(samples[j]), scale)
+			);
+#else
+			vst1q_f32(
+				dst + (j * 4),
+				vmulq_f32(vcvtq_f32_s32(samples[j]), scale)
+			);
+#endif
+		}
+	}
+	for (; i < len; i += 1, src += 3)
+	{
+		*dst++ = S24_TO_F32(src);
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
 
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur += resampleStep;
+#undef S24_TO_F32
+#undef DIVBY8388607
 
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur >> FIXED_PRECISION) * 2;
+/* MSADPCM nibbles, high nibble first, sign-extended to int8. The predictor
+ * that consumes them is serial, so unpacking is the only part that goes wide.
+ */
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur &= FIXED_FRACTION_MASK;
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_UnpackNibbles_Scalar(
+	const uint8_t *restrict src,
+	int8_t *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	for (i = 0; i < len; i += 1, src += 1)
+	{
+		*dst++ = (int8_t) (((*src >> 4) ^ 0x08) - 0x08);
+		*dst++ = (int8_t) (((*src & 0x0F) ^ 0x08) - 0x08);
 	}
 }
 #endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-/* The SSE2 versions of the resamplers come from @8thMage! */
-
 #if HAVE_SSE2_INTRINSICS
-void FAudio_INTERNAL_ResampleMono_SSE2(
-	float *restrict dCache,
-	float *restrict resampleCache,
-	uint64_t *resampleOffset,
-	uint64_t resampleStep,
-	uint64_t toResample,
-	uint8_t UNUSED
+void FAudio_INTERNAL_UnpackNibbles_SSE2(
+	const uint8_t *restrict src,
+	int8_t *restrict dst,
+	uint32_t len
 ) {
-	uint32_t i, header, tail;
-	uint64_t cur_scalar_1, cur_scalar_2, cur_scalar_3;
-	float *dCache_1, *dCache_2, *dCache_3;
-	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
-	__m128 one_over_fixed_one, half, current_next_0_1, current_next_2_3,
-		current, next, sub, cur_fixed, mul, res;
-	__m128i cur_frac, adder_frac, adder_frac_loop;
-
-	/* This is the header, the Dest needs to be aligned to 16B */
-	header = (16 - ((size_t) resampleCache) % 16) / 4;
-	if (header == 4)
+	uint32_t i;
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	const __m128i sign = _mm_set1_epi8(0x08);
+	for (i = 0; i + 16 <= len; i += 16, src += 16, dst += 32)
 	{
-		header = 0;
+		const __m128i bytes = _mm_loadu_si128((const __m128i*) src);
+		/* There is no 8-bit shift, but the mask drops what crosses over */
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+		__m128i lo = _mm_and_si128(bytes, mask);
+		hi = _mm_sub_epi8(_mm_xor_si128(hi, sign), sign);
+		lo = _mm_sub_epi8(_mm_xor_si128(lo, sign), sign);
+		_mm_storeu_si128((__m128i*) dst, _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*) (dst + 16), _mm_unpackhi_epi8(hi, lo));
 	}
-	for (i = 0; i < header; i += 1)
+	for (; i < len; i += 1, src += 1)
 	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[1] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
-		);
+		*dst++ = (int8_t) (((*src >> 4) ^ 0x08) - 0x08);
+		*dst++ = (int8_t) (((*src & 0x0F) ^ 0x08) - 0x08);
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
 
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_UnpackNibbles_NEON(
+	const uint8_t *restrict src,
+	int8_t *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	int8x16x2_t nibbles;
+	for (i = 0; i + 16 <= len; i += 16, src += 16, dst += 32)
+	{
+		const int8x16_t bytes = vreinterpretq_s8_u8(vld1q_u8(src));
+		/* Arithmetic shifts sign-extend each nibble, vst2 interleaves */
+		nibbles.val[0] = vshrq_n_s8(bytes, 4);
+		nibbles.val[1] = vshrq_n_s8(vshlq_n_s8(bytes, 4), 4);
+		vst2q_s8(dst, nibbles);
+	}
+	for (; i < len; i += 1, src += 1)
+	{
+		*dst++ = (int8_t) (((*src >> 4) ^ 0x08) - 0x08);
+		*dst++ = (int8_t) (((*src & 0x0F) ^ 0x08) - 0x08);
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
 
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur_scalar >> FIXED_PRECISION);
+/* Planar float to interleaved, for decoders like FFmpeg's that return one
+ * plane per channel. Mono, stereo and quad go wide, anything else is left to
+ * the per-frame loop, which also finishes the ones that do.
+ */
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_InterleaveF32_Scalar(
+	const float *const *src,
+	float *restrict dst,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	for (i = 0; i < frames; i += 1)
+	{
+		for (c = 0; c < channels; c += 1)
+		{
+			*dst++ = src[c][i];
+		}
 	}
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-	toResample -= header;
-
-	/* initialising the varius cur
-	 * cur_frac is the fractional part of cur with 4 samples. as the
-	 * fractional part is 32 bit unsigned value, it can be just added
-	 * and the modulu operation for keeping the fractional part will be implicit.
-	 * the 0.5 is for converting signed values to float (no unsigned convert),
-	 * the 0.5 is added later.
-	 */
-	cur_frac = _mm_set1_epi32(
-		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
-	);
-	adder_frac = _mm_setr_epi32(
-		0,
-		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
-		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK),
-		(uint32_t) ((resampleStep * 3) & FIXED_FRACTION_MASK)
-	);
-	cur_frac = _mm_add_epi32(cur_frac, adder_frac);
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_InterleaveF32_SSE2(
+	const float *const *src,
+	float *restrict dst,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i = 0, c;
+	if (channels == 1)
+	{
+		for (; i + 4 <= frames; i += 4, dst += 4)
+		{
+			_mm_storeu_ps(dst, _mm_loadu_ps(src[0] + i));
+		}
+	}
+	else if (channels == 2)
+	{
+		for (; i + 4 <= frames; i += 4, dst += 8)
+		{
+			const __m128 left = _mm_loadu_ps(src[0] + i);
+			const __m128 right = _mm_loadu_ps(src[1] + i);
+			_mm_storeu_ps(dst, _mm_unpacklo_ps(left, right));
+			_mm_storeu_ps(dst + 4, _mm_unpackhi_ps(left, right));
+		}
+	}
+	else if (channels == 4)
+	{
+		for (; i + 4 <= frames; i += 4, dst += 16)
+		{
+			__m128 c0 = _mm_loadu_ps(src[0] + i);
+			__m128 c1 = _mm_loadu_ps(src[1] + i);
+			__m128 c2 = _mm_loadu_ps(src[2] + i);
+			__m128 c3 = _mm_loadu_ps(src[3] + i);
+			_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+			_mm_storeu_ps(dst, c0);
+			_mm_storeu_ps(dst + 4, c1);
+			_mm_storeu_ps(dst + 8, c2);
+			_mm_storeu_ps(dst + 12, c3);
+		}
+	}
+	for (; i < frames; i += 1)
+	{
+		for (c = 0; c < channels; c += 1)
+		{
+			*dst++ = src[c][i];
+		}
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
 
-	/* The various cur_scalar is for the different samples
-	 * (1, 2, 3 compared to original cur_scalar = 0)
-	 */
-	cur_scalar_1 = cur_scalar + resampleStep;
-	cur_scalar_2 = cur_scalar + resampleStep * 2;
-	cur_scalar_3 = cur_scalar + resampleStep * 3;
-	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION);
-	dCache_2 = dCache + (cur_scalar_2 >> FIXED_PRECISION);
-	dCache_3 = dCache + (cur_scalar_3 >> FIXED_PRECISION);
-	cur_scalar &= FIXED_FRACTION_MASK;
-	cur_scalar_1 &= FIXED_FRACTION_MASK;
-	cur_scalar_2 &= FIXED_FRACTION_MASK;
-	cur_scalar_3 &= FIXED_FRACTION_MASK;
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_InterleaveF32_NEON(
+	const float *const *src,
+	float *restrict dst,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i = 0, c;
+	float32x4x2_t pair;
+	float32x4x4_t quad;
+	if (channels == 1)
+	{
+		for (; i + 4 <= frames; i += 4, dst += 4)
+		{
+			vst1q_f32(dst, vld1q_f32(src[0] + i));
+		}
+	}
+	else if (channels == 2)
+	{
+		for (; i + 4 <= frames; i += 4, dst += 8)
+		{
+			pair.val[0] = vld1q_f32(src[0] + i);
+			pair.val[1] = vld1q_f32(src[1] + i);
+			vst2q_f32(dst, pair);
+		}
+	}
+	else if (channels == 4)
+	{
+		for (; i + 4 <= frames; i += 4, dst += 16)
+		{
+			quad.val[0] = vld1q_f32(src[0] + i);
+			quad.val[1] = vld1q_f32(src[1] + i);
+			quad.val[2] = vld1q_f32(src[2] + i);
+			quad.val[3] = vld1q_f32(src[3] + i);
+			vst4q_f32(dst, quad);
+		}
+	}
+	for (; i < frames; i += 1)
+	{
+		for (c = 0; c < channels; c += 1)
+		{
+			*dst++ = src[c][i];
+		}
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
 
-	/* Constants */
-	one_over_fixed_one = _mm_set1_ps(1.0f / FIXED_ONE);
-	half = _mm_set1_ps(0.5f);
-	adder_frac_loop = _mm_set1_epi32(
-		(uint32_t) ((resampleStep * 4) & FIXED_FRACTION_MASK)
-	);
+/* Float to integer converters, for devices that don't take float. These are
+ * the last pass over the mix, so each one scales, dithers, clamps to the
+ * format's range and rounds (to nearest, half away from zero) in one go.
+ *
+ * The dither is TPDF, at most one LSB either way, made from the difference of
+ * the two halves of a xorshift32 value. dither points to four generators, or
+ * is NULL for no dither, and sample i always uses generator i % 4 so that
+ * every version makes the same noise.
+ */
 
-	tail = toResample % 4;
-	for (i = 0; i < toResample - tail; i += 4, resampleCache += 4)
-	{
-		/* This does not compile for me for some reason but should be used:
-		 * current_next_0_1 = _mm_undefined_ps();
-		 * current_next_2_3 = _mm_undefined_ps();
-		 */
+#define F32_TO_S16_SCALE 32767.0f
+#define F32_TO_S24_SCALE 8388607.0f
+#define F32_TO_S32_SCALE 2147483648.0f
+#define S32_MAX_FLOAT 2147483520.0f /* Largest float below 2^31 */
 
-		/* current next holds 2 pairs of the sample and the sample + 1
-		 * after that need to seperate them.
-		 */
+static inline float FAudio_INTERNAL_DitherNoise(uint32_t *state)
+{
+	uint32_t x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*state = x;
+	return (
+		(float) ((int32_t) (x & 0xFFFF) - (int32_t) (x >> 16)) *
+		(1.0f / 65536.0f)
+	);
+}
 
-		current_next_0_1 = _mm_loadl_pi(current_next_0_1, (__m64*) dCache);
-		current_next_0_1 = _mm_loadh_pi(current_next_0_1, (__m64*) dCache_1);
-		current_next_2_3 = _mm_loadl_pi(current_next_2_3, (__m64*) dCache_2);
-		current_next_2_3 = _mm_loadh_pi(current_next_2_3, (__m64*) dCache_3);
+static inline int32_t FAudio_INTERNAL_QuantizeSample(
+	float sample,
+	float scale,
+	float noise,
+	float minValue,
+	float maxValue
+) {
+	float v = (sample * scale) + noise;
 
-		/* Unpack them to have seperate current and next in 2 vectors. */
-		current = _mm_shuffle_ps(current_next_0_1, current_next_2_3, 0x88); /* 0b1000 */
-		next = _mm_shuffle_ps(current_next_0_1, current_next_2_3, 0xdd); /* 0b1101 */
+	/* Written out so NaN ends up at minValue, like _mm_max_ps */
+	v = (v > minValue) ? v : minValue;
+	v = (v < maxValue) ? v : maxValue;
+	return (int32_t) (v + ((v < 0.0f) ? -0.5f : 0.5f));
+}
 
-		sub = _mm_sub_ps(next, current);
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_Convert_F32_To_S16_Scalar(
+	const float *restrict src,
+	int16_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+) {
+	uint32_t i;
+	for (i = 0; i < len; i += 1)
+	{
+		dst[i] = (int16_t) FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S16_SCALE,
+			(dither != NULL) ?
+				FAudio_INTERNAL_DitherNoise(&dither[i & 3]) :
+				0.0f,
+			-32768.0f,
+			32767.0f
+		);
+	}
+}
 
-		/* Convert the fractional part to float and then mul to get the fractions out.
-		 * then add back the 0.5 we subtracted before.
-		 */
-		cur_fixed = _mm_add_ps(
-			_mm_mul_ps(
-				_mm_cvtepi32_ps(cur_frac),
-				one_over_fixed_one
-			),
-			half
+void FAudio_INTERNAL_Convert_F32_To_S24_Scalar(
+	const float *restrict src,
+	uint8_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+) {
+	uint32_t i;
+	int32_t sample;
+	for (i = 0; i < len; i += 1, dst += 3)
+	{
+		sample = FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S24_SCALE,
+			(dither != NULL) ?
+				FAudio_INTERNAL_DitherNoise(&dither[i & 3]) :
+				0.0f,
+			-8388608.0f,
+			8388607.0f
 		);
-		mul = _mm_mul_ps(sub, cur_fixed);
-		res = _mm_add_ps(current, mul);
+		dst[0] = (uint8_t) sample;
+		dst[1] = (uint8_t) (sample >> 8);
+		dst[2] = (uint8_t) (sample >> 16);
+	}
+}
 
-		/* Store back */
-		_mm_store_ps(resampleCache, res);
+void FAudio_INTERNAL_Convert_F32_To_S32_Scalar(
+	const float *restrict src,
+	int32_t *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	for (i = 0; i < len; i += 1)
+	{
+		dst[i] = FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S32_SCALE,
+			0.0f,
+			-F32_TO_S32_SCALE,
+			S32_MAX_FLOAT
+		);
+	}
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-		/* Update dCaches for next iteration */
-		cur_scalar += resampleStep * 4;
-		cur_scalar_1 += resampleStep * 4;
-		cur_scalar_2 += resampleStep * 4;
-		cur_scalar_3 += resampleStep * 4;
-		dCache = dCache + (cur_scalar >> FIXED_PRECISION);
-		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION);
-		dCache_2 = dCache_2 + (cur_scalar_2 >> FIXED_PRECISION);
-		dCache_3 = dCache_3 + (cur_scalar_3 >> FIXED_PRECISION);
-		cur_scalar &= FIXED_FRACTION_MASK;
-		cur_scalar_1 &= FIXED_FRACTION_MASK;
-		cur_scalar_2 &= FIXED_FRACTION_MASK;
-		cur_scalar_3 &= FIXED_FRACTION_MASK;
+#if HAVE_SSE2_INTRINSICS
+static inline __m128 FAudio_INTERNAL_DitherNoise_SSE2(__m128i *state)
+{
+	__m128i x = *state;
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+	x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+	x = _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+	*state = x;
+	return _mm_mul_ps(
+		_mm_cvtepi32_ps(_mm_sub_epi32(
+			_mm_and_si128(x, _mm_set1_epi32(0xFFFF)),
+			_mm_srli_epi32(x, 16)
+		)),
+		_mm_set1_ps(1.0f / 65536.0f)
+	);
+}
 
-		cur_frac = _mm_add_epi32(cur_frac, adder_frac_loop);
-	}
-	*resampleOffset += resampleStep * (toResample - tail);
+static inline __m128i FAudio_INTERNAL_QuantizeSamples_SSE2(
+	__m128 samples,
+	__m128 scale,
+	__m128 noise,
+	__m128 minValue,
+	__m128 maxValue
+) {
+	__m128 v = _mm_add_ps(_mm_mul_ps(samples, scale), noise);
+	v = _mm_min_ps(_mm_max_ps(v, minValue), maxValue);
+	return _mm_cvttps_epi32(_mm_add_ps(
+		v,
+		_mm_or_ps(
+			_mm_and_ps(v, _mm_set1_ps(-0.0f)),
+			_mm_set1_ps(0.5f)
+		)
+	));
+}
 
-	/* This is the tail. */
-	for (i = 0; i < tail; i += 1)
+void FAudio_INTERNAL_Convert_F32_To_S16_SSE2(
+	const float *restrict src,
+	int16_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+) {
+	uint32_t i;
+	const __m128 scale = _mm_set1_ps(F32_TO_S16_SCALE);
+	const __m128 minValue = _mm_set1_ps(-32768.0f);
+	const __m128 maxValue = _mm_set1_ps(32767.0f);
+	__m128i state, lo, hi;
+	__m128 noiseLo, noiseHi;
+
+	state = (dither != NULL) ?
+		_mm_loadu_si128((const __m128i*) dither) :
+		_mm_setzero_si128();
+	noiseLo = _mm_setzero_ps();
+	noiseHi = _mm_setzero_ps();
+	for (i = 0; (i + 8) <= len; i += 8)
 	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[1] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
+		if (dither != NULL)
+		{
+			noiseLo = FAudio_INTERNAL_DitherNoise_SSE2(&state);
+			noiseHi = FAudio_INTERNAL_DitherNoise_SSE2(&state);
+		}
+		lo = FAudio_INTERNAL_QuantizeSamples_SSE2(
+			_mm_loadu_ps(src + i),
+			scale,
+			noiseLo,
+			minValue,
+			maxValue
 		);
-		
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
-
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur_scalar >> FIXED_PRECISION);
+		hi = FAudio_INTERNAL_QuantizeSamples_SSE2(
+			_mm_loadu_ps(src + i + 4),
+			scale,
+			noiseHi,
+			minValue,
+			maxValue
+		);
+		_mm_storeu_si128((__m128i*) (dst + i), _mm_packs_epi32(lo, hi));
+	}
+	if (dither != NULL)
+	{
+		_mm_storeu_si128((__m128i*) dither, state);
+	}
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
+	for (; i < len; i += 1)
+	{
+		dst[i] = (int16_t) FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S16_SCALE,
+			(dither != NULL) ?
+				FAudio_INTERNAL_DitherNoise(&dither[i & 3]) :
+				0.0f,
+			-32768.0f,
+			32767.0f
+		);
 	}
 }
 
-void FAudio_INTERNAL_ResampleStereo_SSE2(
-	float *restrict dCache,
-	float *restrict resampleCache,
-	uint64_t *resampleOffset,
-	uint64_t resampleStep,
-	uint64_t toResample,
-	uint8_t UNUSED
+void FAudio_INTERNAL_Convert_F32_To_S24_SSE2(
+	const float *restrict src,
+	uint8_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
 ) {
-	uint32_t i, header, tail;
-	uint64_t cur_scalar, cur_scalar_1;
-	float *dCache_1;
-	__m128 one_over_fixed_one, half, current_next_1, current_next_2,
-		current, next, sub, cur_fixed, mul, res;
-	__m128i cur_frac, adder_frac, adder_frac_loop;
+	uint32_t i, j;
+	const __m128 scale = _mm_set1_ps(F32_TO_S24_SCALE);
+	const __m128 minValue = _mm_set1_ps(-8388608.0f);
+	const __m128 maxValue = _mm_set1_ps(8388607.0f);
+	__m128i state;
+	__m128 noise;
+	int32_t samples[4];
+
+	state = (dither != NULL) ?
+		_mm_loadu_si128((const __m128i*) dither) :
+		_mm_setzero_si128();
+	noise = _mm_setzero_ps();
+	for (i = 0; (i + 4) <= len; i += 4)
+	{
+		if (dither != NULL)
+		{
+			noise = FAudio_INTERNAL_DitherNoise_SSE2(&state);
+		}
+		_mm_storeu_si128(
+			(__m128i*) samples,
+			FAudio_INTERNAL_QuantizeSamples_SSE2(
+				_mm_loadu_ps(src + i),
+				scale,
+				noise,
+				minValue,
+				maxValue
+			)
+		);
 
-	/* This is the header, the Dest needs to be aligned to 16B */
-	header = (16 - ((size_t) resampleCache) % 16) / 8;
-	if (header == 2)
+		/* No 24-bit stores, so the packing is left to the compiler */
+		for (j = 0; j < 4; j += 1, dst += 3)
+		{
+			dst[0] = (uint8_t) samples[j];
+			dst[1] = (uint8_t) (samples[j] >> 8);
+			dst[2] = (uint8_t) (samples[j] >> 16);
+		}
+	}
+	if (dither != NULL)
 	{
-		header = 0;
+		_mm_storeu_si128((__m128i*) dither, state);
 	}
-	cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
-	for (i = 0; i < header; i += 2)
+
+	for (; i < len; i += 1, dst += 3)
 	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[2] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
-		);
-		*resampleCache++ = (float) (
-			dCache[1] +
-			(dCache[3] - dCache[1]) *
-			FIXED_TO_FLOAT(cur_scalar)
+		samples[0] = FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S24_SCALE,
+			(dither != NULL) ?
+				FAudio_INTERNAL_DitherNoise(&dither[i & 3]) :
+				0.0f,
+			-8388608.0f,
+			8388607.0f
 		);
+		dst[0] = (uint8_t) samples[0];
+		dst[1] = (uint8_t) (samples[0] >> 8);
+		dst[2] = (uint8_t) (samples[0] >> 16);
+	}
+}
 
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
-
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+void FAudio_INTERNAL_Convert_F32_To_S32_SSE2(
+	const float *restrict src,
+	int32_t *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const __m128 scale = _mm_set1_ps(F32_TO_S32_SCALE);
+	const __m128 minValue = _mm_set1_ps(-F32_TO_S32_SCALE);
+	const __m128 maxValue = _mm_set1_ps(S32_MAX_FLOAT);
+	const __m128 zero = _mm_setzero_ps();
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
+	for (i = 0; (i + 4) <= len; i += 4)
+	{
+		_mm_storeu_si128(
+			(__m128i*) (dst + i),
+			FAudio_INTERNAL_QuantizeSamples_SSE2(
+				_mm_loadu_ps(src + i),
+				scale,
+				zero,
+				minValue,
+				maxValue
+			)
+		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S32_SCALE,
+			0.0f,
+			-F32_TO_S32_SCALE,
+			S32_MAX_FLOAT
+		);
 	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
 
-	toResample -= header;
+#if HAVE_NEON_INTRINSICS
+static inline float32x4_t FAudio_INTERNAL_DitherNoise_NEON(uint32x4_t *state)
+{
+	uint32x4_t x = *state;
+	x = veorq_u32(x, vshlq_n_u32(x, 13));
+	x = veorq_u32(x, vshrq_n_u32(x, 17));
+	x = veorq_u32(x, vshlq_n_u32(x, 5));
+	*state = x;
+	return vmulq_f32(
+		vcvtq_f32_s32(vsubq_s32(
+			vreinterpretq_s32_u32(vandq_u32(x, vdupq_n_u32(0xFFFF))),
+			vreinterpretq_s32_u32(vshrq_n_u32(x, 16))
+		)),
+		vdupq_n_f32(1.0f / 65536.0f)
+	);
+}
 
-	/* initialising the varius cur.
-	 * cur_frac holds the fractional part of cur.
-	 * to avoid duplication please see the mono part for a thorough
-	 * explanation.
-	 */
-	cur_frac = _mm_set1_epi32(
-		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
-	);
-	adder_frac = _mm_setr_epi32(
-		0,
-		0,
-		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
-		(uint32_t) (resampleStep & FIXED_FRACTION_MASK)
-	);
-	cur_frac = _mm_add_epi32(cur_frac, adder_frac);
-
-	/* dCache_1 is the pointer for dcache in the next resample pos. */
-	cur_scalar_1 = cur_scalar + resampleStep;
-	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION) * 2;
-	cur_scalar_1 &= FIXED_FRACTION_MASK;
+static inline int32x4_t FAudio_INTERNAL_QuantizeSamples_NEON(
+	float32x4_t samples,
+	float32x4_t scale,
+	float32x4_t noise,
+	float32x4_t minValue,
+	float32x4_t maxValue
+) {
+	float32x4_t v = vaddq_f32(vmulq_f32(samples, scale), noise);
+	v = vminq_f32(vmaxq_f32(v, minValue), maxValue);
+	return vcvtq_s32_f32(vaddq_f32(
+		v,
+		vbslq_f32(vdupq_n_u32(0x80000000), v, vdupq_n_f32(0.5f))
+	));
+}
 
-	one_over_fixed_one = _mm_set1_ps(1.0f / FIXED_ONE);
-	half = _mm_set1_ps(0.5f);
-	adder_frac_loop = _mm_set1_epi32(
-		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK)
-	);
+void FAudio_INTERNAL_Convert_F32_To_S16_NEON(
+	const float *restrict src,
+	int16_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+) {
+	uint32_t i;
+	const float32x4_t scale = vdupq_n_f32(F32_TO_S16_SCALE);
+	const float32x4_t minValue = vdupq_n_f32(-32768.0f);
+	const float32x4_t maxValue = vdupq_n_f32(32767.0f);
+	uint32x4_t state;
+	int32x4_t lo, hi;
+	float32x4_t noiseLo, noiseHi;
+
+	state = (dither != NULL) ? vld1q_u32(dither) : vdupq_n_u32(0);
+	noiseLo = vdupq_n_f32(0.0f);
+	noiseHi = vdupq_n_f32(0.0f);
+	for (i = 0; (i + 8) <= len; i += 8)
+	{
+		if (dither != NULL)
+		{
+			noiseLo = FAudio_INTERNAL_DitherNoise_NEON(&state);
+			noiseHi = FAudio_INTERNAL_DitherNoise_NEON(&state);
+		}
+		lo = FAudio_INTERNAL_QuantizeSamples_NEON(
+			vld1q_f32(src + i),
+			scale,
+			noiseLo,
+			minValue,
+			maxValue
+		);
+		hi = FAudio_INTERNAL_QuantizeSamples_NEON(
+			vld1q_f32(src + i + 4),
+			scale,
+			noiseHi,
+			minValue,
+			maxValue
+		);
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+	}
+	if (dither != NULL)
+	{
+		vst1q_u32(dither, state);
+	}
 
-	tail = toResample % 2;
-	for (i = 0; i < toResample - tail; i += 2, resampleCache += 4)
+	for (; i < len; i += 1)
 	{
-		/* Current_next_1 and current_next_2 each holds 4 src
-		 * sample points for getting 4 dest resample point at the end.
-		 * current_next_1 holds:
-		 * (current_ch_1, current_ch_2, next_ch_1, next_ch_2)
-		 * for the first resample position, while current_next_2 holds
-		 * the same for the 2nd resample position
-		 */
-		current_next_1 = _mm_loadu_ps(dCache); /* A1B1A2B2 */
-		current_next_2 = _mm_loadu_ps(dCache_1); /* A3B3A4B4 */
+		dst[i] = (int16_t) FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S16_SCALE,
+			(dither != NULL) ?
+				FAudio_INTERNAL_DitherNoise(&dither[i & 3]) :
+				0.0f,
+			-32768.0f,
+			32767.0f
+		);
+	}
+}
 
-		/* Unpack them to get the current and the next in seperate vectors. */
-		current = _mm_castpd_ps(
-			_mm_unpacklo_pd(
-				_mm_castps_pd(current_next_1),
-				_mm_castps_pd(current_next_2)
+void FAudio_INTERNAL_Convert_F32_To_S24_NEON(
+	const float *restrict src,
+	uint8_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+) {
+	uint32_t i, j;
+	const float32x4_t scale = vdupq_n_f32(F32_TO_S24_SCALE);
+	const float32x4_t minValue = vdupq_n_f32(-8388608.0f);
+	const float32x4_t maxValue = vdupq_n_f32(8388607.0f);
+	uint32x4_t state;
+	float32x4_t noise;
+	int32_t samples[4];
+
+	state = (dither != NULL) ? vld1q_u32(dither) : vdupq_n_u32(0);
+	noise = vdupq_n_f32(0.0f);
+	for (i = 0; (i + 4) <= len; i += 4)
+	{
+		if (dither != NULL)
+		{
+			noise = FAudio_INTERNAL_DitherNoise_NEON(&state);
+		}
+		vst1q_s32(
+			samples,
+			FAudio_INTERNAL_QuantizeSamples_NEON(
+				vld1q_f32(src + i),
+				scale,
+				noise,
+				minValue,
+				maxValue
 			)
 		);
-		next = _mm_castpd_ps(
-			_mm_unpackhi_pd(
-				_mm_castps_pd(current_next_1),
-				_mm_castps_pd(current_next_2)
+
+		/* No 24-bit stores, so the packing is left to the compiler */
+		for (j = 0; j < 4; j += 1, dst += 3)
+		{
+			dst[0] = (uint8_t) samples[j];
+			dst[1] = (uint8_t) (samples[j] >> 8);
+			dst[2] = (uint8_t) (samples[j] >> 16);
+		}
+	}
+	if (dither != NULL)
+	{
+		vst1q_u32(dither, state);
+	}
+
+	for (; i < len; i += 1, dst += 3)
+	{
+		samples[0] = FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S24_SCALE,
+			(dither != NULL) ?
+				FAudio_INTERNAL_DitherNoise(&dither[i & 3]) :
+				0.0f,
+			-8388608.0f,
+			8388607.0f
+		);
+		dst[0] = (uint8_t) samples[0];
+		dst[1] = (uint8_t) (samples[0] >> 8);
+		dst[2] = (uint8_t) (samples[0] >> 16);
+	}
+}
+
+void FAudio_INTERNAL_Convert_F32_To_S32_NEON(
+	const float *restrict src,
+	int32_t *restrict dst,
+	uint32_t len
+) {
+	uint32_t i;
+	const float32x4_t scale = vdupq_n_f32(F32_TO_S32_SCALE);
+	const float32x4_t minValue = vdupq_n_f32(-F32_TO_S32_SCALE);
+	const float32x4_t maxValue = vdupq_n_f32(S32_MAX_FLOAT);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+
+	for (i = 0; (i + 4) <= len; i += 4)
+	{
+		vst1q_s32(
+			dst + i,
+			FAudio_INTERNAL_QuantizeSamples_NEON(
+				vld1q_f32(src + i),
+				scale,
+				zero,
+				minValue,
+				maxValue
 			)
 		);
+	}
+	for (; i < len; i += 1)
+	{
+		dst[i] = FAudio_INTERNAL_QuantizeSample(
+			src[i],
+			F32_TO_S32_SCALE,
+			0.0f,
+			-F32_TO_S32_SCALE,
+			S32_MAX_FLOAT
+		);
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
 
-		sub = _mm_sub_ps(next, current);
+#undef F32_TO_S16_SCALE
+#undef F32_TO_S24_SCALE
+#undef F32_TO_S32_SCALE
+#undef S32_MAX_FLOAT
 
-		/* Adding the 0.5 back.
-		 * See mono explanation for more elaborate explanation.
+/* SECTION 2: Resamplers */
+
+void FAudio_INTERNAL_ResampleGeneric_Scalar(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+) {
+	uint32_t i, j;
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < toResample; i += 1)
+	{
+		for (j = 0; j < channels; j += 1)
+		{
+			/* lerp, then convert to float value */
+			*resampleCache++ = (float) (
+				dCache[j] +
+				(dCache[j + channels] - dCache[j]) *
+				FIXED_TO_DOUBLE(cur)
+			);
+		}
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
 		 */
-		cur_fixed = _mm_add_ps(
-			_mm_mul_ps(
-				_mm_cvtepi32_ps(cur_frac),
-				one_over_fixed_one
-			),
-			half
+		dCache += (cur >> FIXED_PRECISION) * channels;
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur &= FIXED_FRACTION_MASK;
+	}
+}
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_ResampleMono_Scalar(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i;
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < toResample; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[1] - dCache[0]) *
+			FIXED_TO_DOUBLE(cur)
 		);
-		mul = _mm_mul_ps(sub, cur_fixed);
-		res = _mm_add_ps(current, mul);
 
-		/* Store the results */
-		_mm_store_ps(resampleCache, res);
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur += resampleStep;
 
-		/* Update dCaches for next iteration */
-		cur_scalar += resampleStep * 2;
-		cur_scalar_1 += resampleStep * 2;
-		dCache = dCache + (cur_scalar >> FIXED_PRECISION) * 2;
-		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION) * 2;
-		cur_scalar &= FIXED_FRACTION_MASK;
-		cur_scalar_1 &= FIXED_FRACTION_MASK;
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur >> FIXED_PRECISION);
 
-		cur_frac = _mm_add_epi32(cur_frac, adder_frac_loop);
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur &= FIXED_FRACTION_MASK;
 	}
-	*resampleOffset += resampleStep * (toResample - tail);
+}
 
-	/* This is the tail. */
-	for (i = 0; i < tail; i += 1)
+void FAudio_INTERNAL_ResampleStereo_Scalar(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i;
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < toResample; i += 1)
 	{
 		/* lerp, then convert to float value */
 		*resampleCache++ = (float) (
 			dCache[0] +
 			(dCache[2] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
+			FIXED_TO_DOUBLE(cur)
 		);
 		*resampleCache++ = (float) (
 			dCache[1] +
 			(dCache[3] - dCache[1]) *
-			FIXED_TO_FLOAT(cur_scalar)
+			FIXED_TO_DOUBLE(cur)
 		);
 
 		/* Increment fraction offset by the stepping value */
 		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
+		cur += resampleStep;
 
 		/* Only increment the sample offset by integer values.
 		 * Sometimes this will be 0 until cur accumulates
 		 * enough steps, especially for "slow" rates.
 		 */
-		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+		dCache += (cur >> FIXED_PRECISION) * 2;
 
 		/* Now that any integer has been added, drop it.
 		 * The offset pointer will preserve the total.
 		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
+		cur &= FIXED_FRACTION_MASK;
 	}
 }
-#endif /* HAVE_SSE2_INTRINSICS */
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-#if HAVE_NEON_INTRINSICS
-void FAudio_INTERNAL_ResampleMono_NEON(
+/* The SSE2 versions of the resamplers come from @8thMage! */
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_ResampleMono_SSE2(
 	float *restrict dCache,
 	float *restrict resampleCache,
 	uint64_t *resampleOffset,
 	uint64_t resampleStep,
 	uint64_t toResample,
-	uint8_t UNUSED
+	uint8_t UNUSED
+) {
+	uint32_t i, header, tail;
+	uint64_t cur_scalar_1, cur_scalar_2, cur_scalar_3;
+	float *dCache_1, *dCache_2, *dCache_3;
+	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	__m128 one_over_fixed_one, half, current_next_0_1, current_next_2_3,
+		current, next, sub, cur_fixed, mul, res;
+	__m128i cur_frac, adder_frac, adder_frac_loop;
+
+	/* This is the header, the Dest needs to be aligned to 16B */
+	header = (16 - ((size_t) resampleCache) % 16) / 4;
+	if (header == 4)
+	{
+		header = 0;
+	}
+	for (i = 0; i < header; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[1] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION);
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+
+	toResample -= header;
+
+	/* initialising the varius cur
+	 * cur_frac is the fractional part of cur with 4 samples. as the
+	 * fractional part is 32 bit unsigned value, it can be just added
+	 * and the modulu operation for keeping the fractional part will be implicit.
+	 * the 0.5 is for converting signed values to float (no unsigned convert),
+	 * the 0.5 is added later.
+	 */
+	cur_frac = _mm_set1_epi32(
+		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+	);
+	adder_frac = _mm_setr_epi32(
+		0,
+		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
+		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK),
+		(uint32_t) ((resampleStep * 3) & FIXED_FRACTION_MASK)
+	);
+	cur_frac = _mm_add_epi32(cur_frac, adder_frac);
+
+	/* The various cur_scalar is for the different samples
+	 * (1, 2, 3 compared to original cur_scalar = 0)
+	 */
+	cur_scalar_1 = cur_scalar + resampleStep;
+	cur_scalar_2 = cur_scalar + resampleStep * 2;
+	cur_scalar_3 = cur_scalar + resampleStep * 3;
+	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION);
+	dCache_2 = dCache + (cur_scalar_2 >> FIXED_PRECISION);
+	dCache_3 = dCache + (cur_scalar_3 >> FIXED_PRECISION);
+	cur_scalar &= FIXED_FRACTION_MASK;
+	cur_scalar_1 &= FIXED_FRACTION_MASK;
+	cur_scalar_2 &= FIXED_FRACTION_MASK;
+	cur_scalar_3 &= FIXED_FRACTION_MASK;
+
+	/* Constants */
+	one_over_fixed_one = _mm_set1_ps(1.0f / FIXED_ONE);
+	half = _mm_set1_ps(0.5f);
+	adder_frac_loop = _mm_set1_epi32(
+		(uint32_t) ((resampleStep * 4) & FIXED_FRACTION_MASK)
+	);
+
+	tail = toResample % 4;
+	for (i = 0; i < toResample - tail; i += 4, resampleCache += 4)
+	{
+		/* This does not compile for me for some reason but should be used:
+		 * current_next_0_1 = _mm_undefined_ps();
+		 * current_next_2_3 = _mm_undefined_ps();
+		 */
+
+		/* current next holds 2 pairs of the sample and the sample + 1
+		 * after that need to seperate them.
+		 */
+
+		current_next_0_1 = _mm_loadl_pi(current_next_0_1, (__m64*) dCache);
+		current_next_0_1 = _mm_loadh_pi(current_next_0_1, (__m64*) dCache_1);
+		current_next_2_3 = _mm_loadl_pi(current_next_2_3, (__m64*) dCache_2);
+		current_next_2_3 = _mm_loadh_pi(current_next_2_3, (__m64*) dCache_3);
+
+		/* Unpack them to have seperate current and next in 2 vectors. */
+		current = _mm_shuffle_ps(current_next_0_1, current_next_2_3, 0x88); /* 0b1000 */
+		next = _mm_shuffle_ps(current_next_0_1, current_next_2_3, 0xdd); /* 0b1101 */
+
+		sub = _mm_sub_ps(next, current);
+
+		/* Convert the fractional part to float and then mul to get the fractions out.
+		 * then add back the 0.5 we subtracted before.
+		 */
+		cur_fixed = _mm_add_ps(
+			_mm_mul_ps(
+				_mm_cvtepi32_ps(cur_frac),
+				one_over_fixed_one
+			),
+			half
+		);
+		mul = _mm_mul_ps(sub, cur_fixed);
+		res = _mm_add_ps(current, mul);
+
+		/* Store back */
+		_mm_store_ps(resampleCache, res);
+
+		/* Update dCaches for next iteration */
+		cur_scalar += resampleStep * 4;
+		cur_scalar_1 += resampleStep * 4;
+		cur_scalar_2 += resampleStep * 4;
+		cur_scalar_3 += resampleStep * 4;
+		dCache = dCache + (cur_scalar >> FIXED_PRECISION);
+		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION);
+		dCache_2 = dCache_2 + (cur_scalar_2 >> FIXED_PRECISION);
+		dCache_3 = dCache_3 + (cur_scalar_3 >> FIXED_PRECISION);
+		cur_scalar &= FIXED_FRACTION_MASK;
+		cur_scalar_1 &= FIXED_FRACTION_MASK;
+		cur_scalar_2 &= FIXED_FRACTION_MASK;
+		cur_scalar_3 &= FIXED_FRACTION_MASK;
+
+		cur_frac = _mm_add_epi32(cur_frac, adder_frac_loop);
+	}
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[1] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+		
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION);
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+
+void FAudio_INTERNAL_ResampleStereo_SSE2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, header, tail;
+	uint64_t cur_scalar, cur_scalar_1;
+	float *dCache_1;
+	__m128 one_over_fixed_one, half, current_next_1, current_next_2,
+		current, next, sub, cur_fixed, mul, res;
+	__m128i cur_frac, adder_frac, adder_frac_loop;
+
+	/* This is the header, the Dest needs to be aligned to 16B */
+	header = (16 - ((size_t) resampleCache) % 16) / 8;
+	if (header == 2)
+	{
+		header = 0;
+	}
+	cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < header; i += 2)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[2] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+		*resampleCache++ = (float) (
+			dCache[1] +
+			(dCache[3] - dCache[1]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+
+	toResample -= header;
+
+	/* initialising the varius cur.
+	 * cur_frac holds the fractional part of cur.
+	 * to avoid duplication please see the mono part for a thorough
+	 * explanation.
+	 */
+	cur_frac = _mm_set1_epi32(
+		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+	);
+	adder_frac = _mm_setr_epi32(
+		0,
+		0,
+		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
+		(uint32_t) (resampleStep & FIXED_FRACTION_MASK)
+	);
+	cur_frac = _mm_add_epi32(cur_frac, adder_frac);
+
+	/* dCache_1 is the pointer for dcache in the next resample pos. */
+	cur_scalar_1 = cur_scalar + resampleStep;
+	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION) * 2;
+	cur_scalar_1 &= FIXED_FRACTION_MASK;
+
+	one_over_fixed_one = _mm_set1_ps(1.0f / FIXED_ONE);
+	half = _mm_set1_ps(0.5f);
+	adder_frac_loop = _mm_set1_epi32(
+		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK)
+	);
+
+	tail = toResample % 2;
+	for (i = 0; i < toResample - tail; i += 2, resampleCache += 4)
+	{
+		/* Current_next_1 and current_next_2 each holds 4 src
+		 * sample points for getting 4 dest resample point at the end.
+		 * current_next_1 holds:
+		 * (current_ch_1, current_ch_2, next_ch_1, next_ch_2)
+		 * for the first resample position, while current_next_2 holds
+		 * the same for the 2nd resample position
+		 */
+		current_next_1 = _mm_loadu_ps(dCache); /* A1B1A2B2 */
+		current_next_2 = _mm_loadu_ps(dCache_1); /* A3B3A4B4 */
+
+		/* Unpack them to get the current and the next in seperate vectors. */
+		current = _mm_castpd_ps(
+			_mm_unpacklo_pd(
+				_mm_castps_pd(current_next_1),
+				_mm_castps_pd(current_next_2)
+			)
+		);
+		next = _mm_castpd_ps(
+			_mm_unpackhi_pd(
+				_mm_castps_pd(current_next_1),
+				_mm_castps_pd(current_next_2)
+			)
+		);
+
+		sub = _mm_sub_ps(next, current);
+
+		/* Adding the 0.5 back.
+		 * See mono explanation for more elaborate explanation.
+		 */
+		cur_fixed = _mm_add_ps(
+			_mm_mul_ps(
+				_mm_cvtepi32_ps(cur_frac),
+				one_over_fixed_one
+			),
+			half
+		);
+		mul = _mm_mul_ps(sub, cur_fixed);
+		res = _mm_add_ps(current, mul);
+
+		/* Store the results */
+		_mm_store_ps(resampleCache, res);
+
+		/* Update dCaches for next iteration */
+		cur_scalar += resampleStep * 2;
+		cur_scalar_1 += resampleStep * 2;
+		dCache = dCache + (cur_scalar >> FIXED_PRECISION) * 2;
+		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION) * 2;
+		cur_scalar &= FIXED_FRACTION_MASK;
+		cur_scalar_1 &= FIXED_FRACTION_MASK;
+
+		cur_frac = _mm_add_epi32(cur_frac, adder_frac_loop);
+	}
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[2] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+		*resampleCache++ = (float) (
+			dCache[1] +
+			(dCache[3] - dCache[1]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+
+/* The AVX2 resamplers keep a per-lane index into dCache and a per-lane
+ * fraction, then gather current/next for all 8 lanes at once. As in the SSE2
+ * version the fraction is stored minus 0.5, so it converts as a signed int.
+ * That bias also makes signed compares order the fractions as unsigned, which
+ * is how a wrapped fraction is carried into the index.
+ */
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_ResampleMono_AVX2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, tail;
+	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	uint64_t lane_offset;
+	int32_t lane_index[8], lane_frac[8];
+	__m256 one_over_fixed_one, half, current, next, cur_fixed, res;
+	__m256i cur_index, cur_frac, next_frac, carry, adder_index, adder_frac;
+
+	for (i = 0; i < 8; i += 1)
+	{
+		lane_offset = cur_scalar + resampleStep * i;
+		lane_index[i] = (int32_t) (lane_offset >> FIXED_PRECISION);
+		lane_frac[i] = (int32_t) (uint32_t) (
+			(lane_offset & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+		);
+	}
+	cur_index = _mm256_loadu_si256((const __m256i*) lane_index);
+	cur_frac = _mm256_loadu_si256((const __m256i*) lane_frac);
+	adder_index = _mm256_set1_epi32(
+		(int32_t) ((resampleStep * 8) >> FIXED_PRECISION)
+	);
+	adder_frac = _mm256_set1_epi32(
+		(int32_t) (uint32_t) ((resampleStep * 8) & FIXED_FRACTION_MASK)
+	);
+
+	/* Constants */
+	one_over_fixed_one = _mm256_set1_ps(1.0f / FIXED_ONE);
+	half = _mm256_set1_ps(0.5f);
+
+	tail = toResample % 8;
+	for (i = 0; i < toResample - tail; i += 8, resampleCache += 8)
+	{
+		current = _mm256_i32gather_ps(dCache, cur_index, 4);
+		next = _mm256_i32gather_ps(dCache + 1, cur_index, 4);
+
+		cur_fixed = _mm256_add_ps(
+			_mm256_mul_ps(
+				_mm256_cvtepi32_ps(cur_frac),
+				one_over_fixed_one
+			),
+			half
+		);
+		res = _mm256_add_ps(
+			current,
+			_mm256_mul_ps(_mm256_sub_ps(next, current), cur_fixed)
+		);
+		_mm256_storeu_ps(resampleCache, res);
+
+		/* carry is -1 wherever the fraction wrapped */
+		next_frac = _mm256_add_epi32(cur_frac, adder_frac);
+		carry = _mm256_cmpgt_epi32(cur_frac, next_frac);
+		cur_index = _mm256_sub_epi32(
+			_mm256_add_epi32(cur_index, adder_index),
+			carry
+		);
+		cur_frac = next_frac;
+	}
+
+	/* Catch the scalar state up with the vector loop */
+	lane_offset = cur_scalar + resampleStep * (toResample - tail);
+	dCache += lane_offset >> FIXED_PRECISION;
+	cur_scalar = lane_offset & FIXED_FRACTION_MASK;
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[1] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+		dCache += (cur_scalar >> FIXED_PRECISION);
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_ResampleStereo_AVX2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, tail;
+	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	uint64_t lane_offset;
+	int32_t lane_index[8], lane_frac[8];
+	__m256 one_over_fixed_one, half, current, next, cur_fixed, res;
+	__m256i cur_index, cur_frac, next_frac, carry, adder_index, adder_frac;
+
+	/* Lanes are L/R pairs for 4 frames, both channels of a frame share a
+	 * fraction and their indices are in floats, not frames.
+	 */
+	for (i = 0; i < 8; i += 1)
+	{
+		lane_offset = cur_scalar + resampleStep * (i >> 1);
+		lane_index[i] = (int32_t) (
+			((lane_offset >> FIXED_PRECISION) * 2) + (i & 1)
+		);
+		lane_frac[i] = (int32_t) (uint32_t) (
+			(lane_offset & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+		);
+	}
+	cur_index = _mm256_loadu_si256((const __m256i*) lane_index);
+	cur_frac = _mm256_loadu_si256((const __m256i*) lane_frac);
+	adder_index = _mm256_set1_epi32(
+		(int32_t) (((resampleStep * 4) >> FIXED_PRECISION) * 2)
+	);
+	adder_frac = _mm256_set1_epi32(
+		(int32_t) (uint32_t) ((resampleStep * 4) & FIXED_FRACTION_MASK)
+	);
+
+	/* Constants */
+	one_over_fixed_one = _mm256_set1_ps(1.0f / FIXED_ONE);
+	half = _mm256_set1_ps(0.5f);
+
+	tail = toResample % 4;
+	for (i = 0; i < toResample - tail; i += 4, resampleCache += 8)
+	{
+		current = _mm256_i32gather_ps(dCache, cur_index, 4);
+		next = _mm256_i32gather_ps(dCache + 2, cur_index, 4);
+
+		cur_fixed = _mm256_add_ps(
+			_mm256_mul_ps(
+				_mm256_cvtepi32_ps(cur_frac),
+				one_over_fixed_one
+			),
+			half
+		);
+		res = _mm256_add_ps(
+			current,
+			_mm256_mul_ps(_mm256_sub_ps(next, current), cur_fixed)
+		);
+		_mm256_storeu_ps(resampleCache, res);
+
+		/* carry is -1 wherever the fraction wrapped, one frame is 2 */
+		next_frac = _mm256_add_epi32(cur_frac, adder_frac);
+		carry = _mm256_cmpgt_epi32(cur_frac, next_frac);
+		cur_index = _mm256_sub_epi32(
+			_mm256_sub_epi32(
+				_mm256_add_epi32(cur_index, adder_index),
+				carry
+			),
+			carry
+		);
+		cur_frac = next_frac;
+	}
+
+	/* Catch the scalar state up with the vector loop */
+	lane_offset = cur_scalar + resampleStep * (toResample - tail);
+	dCache += (lane_offset >> FIXED_PRECISION) * 2;
+	cur_scalar = lane_offset & FIXED_FRACTION_MASK;
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[2] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+		*resampleCache++ = (float) (
+			dCache[1] +
+			(dCache[3] - dCache[1]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_ResampleMono_NEON(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t UNUSED
+) {
+	uint32_t i, header, tail;
+	uint64_t cur_scalar_1, cur_scalar_2, cur_scalar_3;
+	float *dCache_1, *dCache_2, *dCache_3;
+	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	float32x4_t one_over_fixed_one, half, current_next_0_1, current_next_2_3,
+		current, next, sub, cur_fixed, mul, res;
+	int32x4_t cur_frac, adder_frac, adder_frac_loop;
+
+	/* This is the header, the Dest needs to be aligned to 16B */
+	header = (16 - ((size_t) resampleCache) % 16) / 4;
+	if (header == 4)
+	{
+		header = 0;
+	}
+	for (i = 0; i < header; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[1] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION);
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+
+	toResample -= header;
+
+	/* initialising the varius cur
+	 * cur_frac is the fractional part of cur with 4 samples. as the
+	 * fractional part is 32 bit unsigned value, it can be just added
+	 * and the modulu operation for keeping the fractional part will be implicit.
+	 * the 0.5 is for converting signed values to float (no unsigned convert),
+	 * the 0.5 is added later.
+	 */
+	cur_frac = vdupq_n_s32(
+		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+	);
+	int32_t __attribute__((aligned(16))) data[4] =
+	{
+		0,
+		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
+		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK),
+		(uint32_t) ((resampleStep * 3) & FIXED_FRACTION_MASK)
+	};
+	adder_frac = vld1q_s32(data);
+	cur_frac = vaddq_s32(cur_frac, adder_frac);
+
+	/* The various cur_scalar is for the different samples
+	 * (1, 2, 3 compared to original cur_scalar = 0)
+	 */
+	cur_scalar_1 = cur_scalar + resampleStep;
+	cur_scalar_2 = cur_scalar + resampleStep * 2;
+	cur_scalar_3 = cur_scalar + resampleStep * 3;
+	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION);
+	dCache_2 = dCache + (cur_scalar_2 >> FIXED_PRECISION);
+	dCache_3 = dCache + (cur_scalar_3 >> FIXED_PRECISION);
+	cur_scalar &= FIXED_FRACTION_MASK;
+	cur_scalar_1 &= FIXED_FRACTION_MASK;
+	cur_scalar_2 &= FIXED_FRACTION_MASK;
+	cur_scalar_3 &= FIXED_FRACTION_MASK;
+
+	/* Constants */
+	one_over_fixed_one = vdupq_n_f32(1.0f / FIXED_ONE);
+	half = vdupq_n_f32(0.5f);
+	adder_frac_loop = vdupq_n_s32(
+		(uint32_t) ((resampleStep * 4) & FIXED_FRACTION_MASK)
+	);
+
+	tail = toResample % 4;
+	for (i = 0; i < toResample - tail; i += 4, resampleCache += 4)
+	{
+		/* current next holds 2 pairs of the sample and the sample + 1
+		 * after that need to separate them.
+		 */
+		current_next_0_1 = vcombine_f32(
+			vld1_f32(dCache),
+			vld1_f32(dCache_1)
+		);
+		current_next_2_3 = vcombine_f32(
+			vld1_f32(dCache_2),
+			vld1_f32(dCache_3)
+		);
+
+		/* Unpack them to have seperate current and next in 2 vectors. */
+		current = vuzp1q_f32(current_next_0_1, current_next_2_3);
+		next = vuzp2q_f32(current_next_0_1, current_next_2_3);
+
+		sub = vsubq_f32(next, current);
+
+		/* Convert the fractional part to float and then mul to get the fractions out.
+		 * then add back the 0.5 we subtracted before.
+		 */
+		cur_fixed = vaddq_f32(
+			vmulq_f32(
+				vcvtq_f32_s32(cur_frac),
+				one_over_fixed_one
+			),
+			half
+		);
+		mul = vmulq_f32(sub, cur_fixed);
+		res = vaddq_f32(current, mul);
+
+		/* Store back */
+		vst1q_f32(resampleCache, res);
+
+		/* Update dCaches for next iteration */
+		cur_scalar += resampleStep * 4;
+		cur_scalar_1 += resampleStep * 4;
+		cur_scalar_2 += resampleStep * 4;
+		cur_scalar_3 += resampleStep * 4;
+		dCache = dCache + (cur_scalar >> FIXED_PRECISION);
+		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION);
+		dCache_2 = dCache_2 + (cur_scalar_2 >> FIXED_PRECISION);
+		dCache_3 = dCache_3 + (cur_scalar_3 >> FIXED_PRECISION);
+		cur_scalar &= FIXED_FRACTION_MASK;
+		cur_scalar_1 &= FIXED_FRACTION_MASK;
+		cur_scalar_2 &= FIXED_FRACTION_MASK;
+		cur_scalar_3 &= FIXED_FRACTION_MASK;
+
+		cur_frac = vaddq_s32(cur_frac, adder_frac_loop);
+	}
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[1] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION);
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+
+void FAudio_INTERNAL_ResampleStereo_NEON(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+) {
+	uint32_t i, header, tail;
+	uint64_t cur_scalar, cur_scalar_1;
+	float *dCache_1;
+	float32x4_t one_over_fixed_one, half, current, next, sub, cur_fixed, mul, res;
+	int32x4_t cur_frac, adder_frac, adder_frac_loop;
+
+	/* This is the header, the Dest needs to be aligned to 16B */
+	header = (16 - ((size_t) resampleCache) % 16) / 8;
+	if (header == 2)
+	{
+		header = 0;
+	}
+	cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < header; i += 2)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[2] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+		*resampleCache++ = (float) (
+			dCache[1] +
+			(dCache[3] - dCache[1]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+
+	toResample -= header;
+
+	/* initialising the varius cur.
+	 * cur_frac holds the fractional part of cur.
+	 * to avoid duplication please see the mono part for a thorough
+	 * explanation.
+	 */
+	cur_frac = vdupq_n_s32(
+		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
+	);
+	int32_t __attribute__((aligned(16))) data[4] =
+	{
+		0,
+		0,
+		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
+		(uint32_t) (resampleStep & FIXED_FRACTION_MASK)
+	};
+	adder_frac = vld1q_s32(data);
+	cur_frac = vaddq_s32(cur_frac, adder_frac);
+
+	/* dCache_1 is the pointer for dcache in the next resample pos. */
+	cur_scalar_1 = cur_scalar + resampleStep;
+	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION) * 2;
+	cur_scalar_1 &= FIXED_FRACTION_MASK;
+
+	one_over_fixed_one = vdupq_n_f32(1.0f / FIXED_ONE);
+	half = vdupq_n_f32(0.5f);
+	adder_frac_loop = vdupq_n_s32(
+		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK)
+	);
+
+	tail = toResample % 2;
+	for (i = 0; i < toResample - tail; i += 2, resampleCache += 4)
+	{
+		/* Current_next_1 and current_next_2 each holds 4 src
+		 * sample points for getting 4 dest resample point at the end.
+		 * current_next_1 holds:
+		 * (current_ch_1, current_ch_2, next_ch_1, next_ch_2)
+		 * for the first resample position, while current_next_2 holds
+		 * the same for the 2nd resample position
+		 */
+		current = vcombine_f32(
+			vld1_f32(dCache), /* A1B1 */
+			vld1_f32(dCache_1) /* A3B3 */
+		);
+		next = vcombine_f32(
+			vld1_f32(dCache + 2), /* A2B2 */
+			vld1_f32(dCache_1 + 2) /* A4B4 */
+		);
+
+		sub = vsubq_f32(next, current);
+
+		/* Adding the 0.5 back.
+		 * See mono explanation for more elaborate explanation.
+		 */
+		cur_fixed = vaddq_f32(
+			vmulq_f32(
+				vcvtq_f32_s32(cur_frac),
+				one_over_fixed_one
+			),
+			half
+		);
+		mul = vmulq_f32(sub, cur_fixed);
+		res = vaddq_f32(current, mul);
+
+		/* Store the results */
+		vst1q_f32(resampleCache, res);
+
+		/* Update dCaches for next iteration */
+		cur_scalar += resampleStep * 2;
+		cur_scalar_1 += resampleStep * 2;
+		dCache = dCache + (cur_scalar >> FIXED_PRECISION) * 2;
+		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION) * 2;
+		cur_scalar &= FIXED_FRACTION_MASK;
+		cur_scalar_1 &= FIXED_FRACTION_MASK;
+
+		cur_frac = vaddq_s32(cur_frac, adder_frac_loop);
+	}
+	*resampleOffset += resampleStep * (toResample - tail);
+
+	/* This is the tail. */
+	for (i = 0; i < tail; i += 1)
+	{
+		/* lerp, then convert to float value */
+		*resampleCache++ = (float) (
+			dCache[0] +
+			(dCache[2] - dCache[0]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+		*resampleCache++ = (float) (
+			dCache[1] +
+			(dCache[3] - dCache[1]) *
+			FIXED_TO_FLOAT(cur_scalar)
+		);
+
+		/* Increment fraction offset by the stepping value */
+		*resampleOffset += resampleStep;
+		cur_scalar += resampleStep;
+
+		/* Only increment the sample offset by integer values.
+		 * Sometimes this will be 0 until cur accumulates
+		 * enough steps, especially for "slow" rates.
+		 */
+		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+
+		/* Now that any integer has been added, drop it.
+		 * The offset pointer will preserve the total.
+		 */
+		cur_scalar &= FIXED_FRACTION_MASK;
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* Fixed-ratio resamplers for submixes. Each pass turns exactly inFrames of
+ * input into exactly outFrames of output, interpolating frame i from input
+ * position i * inFrames / outFrames, one frame behind. The frame before the
+ * input is the last frame of the previous pass, kept in history, so the
+ * interpolation carries across passes without any queueing.
+ */
+
+#define FIXED_FRACTION_TO_FLOAT(fxd) \
+	((float) ((fxd) & FIXED_FRACTION_MASK) * (1.0f / FIXED_ONE))
+
+static inline void FAudio_INTERNAL_ResampleFixedFrames(
+	const float *restrict history,
+	const float *restrict input,
+	float *restrict output,
+	uint32_t first,
+	uint32_t last,
+	uint64_t resampleStep,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	uint64_t pos;
+	const float *cur, *next;
+	float frac;
+	for (i = first; i < last; i += 1)
+	{
+		pos = i * resampleStep;
+		next = input + (pos >> FIXED_PRECISION) * channels;
+		cur = (pos >> FIXED_PRECISION) ? (next - channels) : history;
+		frac = FIXED_FRACTION_TO_FLOAT(pos);
+		for (c = 0; c < channels; c += 1)
+		{
+			output[i * channels + c] = cur[c] + (next[c] - cur[c]) * frac;
+		}
+	}
+}
+
+/* How many leading output frames interpolate from the history frame */
+static inline uint32_t FAudio_INTERNAL_ResampleFixedHistoryFrames(
+	uint32_t outFrames,
+	uint64_t resampleStep
+) {
+	return (uint32_t) FAudio_min(
+		(FIXED_ONE + resampleStep - 1) / resampleStep,
+		outFrames
+	);
+}
+
+void FAudio_INTERNAL_ResampleFixed_Scalar(
+	float *restrict history,
+	const float *restrict input,
+	uint32_t inFrames,
+	float *restrict output,
+	uint32_t outFrames,
+	uint64_t resampleStep,
+	uint32_t channels
+) {
+	FAudio_INTERNAL_ResampleFixedFrames(
+		history,
+		input,
+		output,
+		0,
+		outFrames,
+		resampleStep,
+		channels
+	);
+	FAudio_memcpy(
+		history,
+		input + (inFrames - 1) * channels,
+		sizeof(float) * channels
+	);
+}
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_ResampleFixed_SSE2(
+	float *restrict history,
+	const float *restrict input,
+	uint32_t inFrames,
+	float *restrict output,
+	uint32_t outFrames,
+	uint64_t resampleStep,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	uint64_t pos0, pos1, pos2, pos3;
+	const float *cur;
+	__m128 a, b, current, next, frac;
+
+	i = FAudio_INTERNAL_ResampleFixedHistoryFrames(outFrames, resampleStep);
+	FAudio_INTERNAL_ResampleFixedFrames(
+		history,
+		input,
+		output,
+		0,
+		i,
+		resampleStep,
+		channels
+	);
+
+	/* Past the history frame, every current/next pair is in the input */
+	#define FRAME(pos, chans) (input + ((pos) >> FIXED_PRECISION) * (chans) - (chans))
+	if (channels == 1)
+	{
+		/* 4 frames at a time, gathered as current/next pairs */
+		for (; (i + 4) <= outFrames; i += 4)
+		{
+			pos0 = i * resampleStep;
+			pos1 = pos0 + resampleStep;
+			pos2 = pos1 + resampleStep;
+			pos3 = pos2 + resampleStep;
+			a = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*) FRAME(pos0, 1));
+			a = _mm_loadh_pi(a, (const __m64*) FRAME(pos1, 1));
+			b = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*) FRAME(pos2, 1));
+			b = _mm_loadh_pi(b, (const __m64*) FRAME(pos3, 1));
+			current = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+			next = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+			frac = _mm_setr_ps(
+				FIXED_FRACTION_TO_FLOAT(pos0),
+				FIXED_FRACTION_TO_FLOAT(pos1),
+				FIXED_FRACTION_TO_FLOAT(pos2),
+				FIXED_FRACTION_TO_FLOAT(pos3)
+			);
+			_mm_storeu_ps(output + i, _mm_add_ps(
+				current,
+				_mm_mul_ps(_mm_sub_ps(next, current), frac)
+			));
+		}
+	}
+	else if (channels == 2)
+	{
+		/* 2 frames at a time, each load is a current L/R + next L/R */
+		for (; (i + 2) <= outFrames; i += 2)
+		{
+			pos0 = i * resampleStep;
+			pos1 = pos0 + resampleStep;
+			a = _mm_loadu_ps(FRAME(pos0, 2));
+			b = _mm_loadu_ps(FRAME(pos1, 2));
+			current = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 1, 0));
+			next = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 2, 3, 2));
+			frac = _mm_setr_ps(
+				FIXED_FRACTION_TO_FLOAT(pos0),
+				FIXED_FRACTION_TO_FLOAT(pos0),
+				FIXED_FRACTION_TO_FLOAT(pos1),
+				FIXED_FRACTION_TO_FLOAT(pos1)
+			);
+			_mm_storeu_ps(output + i * 2, _mm_add_ps(
+				current,
+				_mm_mul_ps(_mm_sub_ps(next, current), frac)
+			));
+		}
+	}
+	else
+	{
+		/* One frame at a time, vectorized across the channels */
+		for (; i < outFrames; i += 1)
+		{
+			pos0 = i * resampleStep;
+			cur = FRAME(pos0, channels);
+			frac = _mm_set1_ps(FIXED_FRACTION_TO_FLOAT(pos0));
+			for (c = 0; (c + 4) <= channels; c += 4)
+			{
+				current = _mm_loadu_ps(cur + c);
+				next = _mm_loadu_ps(cur + channels + c);
+				_mm_storeu_ps(output + i * channels + c, _mm_add_ps(
+					current,
+					_mm_mul_ps(_mm_sub_ps(next, current), frac)
+				));
+			}
+			for (; c < channels; c += 1)
+			{
+				output[i * channels + c] = cur[c] + (
+					(cur[channels + c] - cur[c]) *
+					FIXED_FRACTION_TO_FLOAT(pos0)
+				);
+			}
+		}
+	}
+	#undef FRAME
+
+	FAudio_INTERNAL_ResampleFixedFrames(
+		history,
+		input,
+		output,
+		i,
+		outFrames,
+		resampleStep,
+		channels
+	);
+	FAudio_memcpy(
+		history,
+		input + (inFrames - 1) * channels,
+		sizeof(float) * channels
+	);
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_ResampleFixed_NEON(
+	float *restrict history,
+	const float *restrict input,
+	uint32_t inFrames,
+	float *restrict output,
+	uint32_t outFrames,
+	uint64_t resampleStep,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	uint64_t pos0, pos1, pos2, pos3;
+	const float *cur;
+	float32x4_t a, b, current, next, frac;
+	float fracs[4];
+
+	i = FAudio_INTERNAL_ResampleFixedHistoryFrames(outFrames, resampleStep);
+	FAudio_INTERNAL_ResampleFixedFrames(
+		history,
+		input,
+		output,
+		0,
+		i,
+		resampleStep,
+		channels
+	);
+
+	/* Past the history frame, every current/next pair is in the input */
+	#define FRAME(pos, chans) (input + ((pos) >> FIXED_PRECISION) * (chans) - (chans))
+	if (channels == 1)
+	{
+		for (; (i + 4) <= outFrames; i += 4)
+		{
+			pos0 = i * resampleStep;
+			pos1 = pos0 + resampleStep;
+			pos2 = pos1 + resampleStep;
+			pos3 = pos2 + resampleStep;
+			a = vcombine_f32(vld1_f32(FRAME(pos0, 1)), vld1_f32(FRAME(pos1, 1)));
+			b = vcombine_f32(vld1_f32(FRAME(pos2, 1)), vld1_f32(FRAME(pos3, 1)));
+			current = vuzp1q_f32(a, b);
+			next = vuzp2q_f32(a, b);
+			fracs[0] = FIXED_FRACTION_TO_FLOAT(pos0);
+			fracs[1] = FIXED_FRACTION_TO_FLOAT(pos1);
+			fracs[2] = FIXED_FRACTION_TO_FLOAT(pos2);
+			fracs[3] = FIXED_FRACTION_TO_FLOAT(pos3);
+			frac = vld1q_f32(fracs);
+			vst1q_f32(output + i, vaddq_f32(
+				current,
+				vmulq_f32(vsubq_f32(next, current), frac)
+			));
+		}
+	}
+	else if (channels == 2)
+	{
+		for (; (i + 2) <= outFrames; i += 2)
+		{
+			pos0 = i * resampleStep;
+			pos1 = pos0 + resampleStep;
+			a = vld1q_f32(FRAME(pos0, 2));
+			b = vld1q_f32(FRAME(pos1, 2));
+			current = vcombine_f32(vget_low_f32(a), vget_low_f32(b));
+			next = vcombine_f32(vget_high_f32(a), vget_high_f32(b));
+			frac = vcombine_f32(
+				vdup_n_f32(FIXED_FRACTION_TO_FLOAT(pos0)),
+				vdup_n_f32(FIXED_FRACTION_TO_FLOAT(pos1))
+			);
+			vst1q_f32(output + i * 2, vaddq_f32(
+				current,
+				vmulq_f32(vsubq_f32(next, current), frac)
+			));
+		}
+	}
+	else
+	{
+		for (; i < outFrames; i += 1)
+		{
+			pos0 = i * resampleStep;
+			cur = FRAME(pos0, channels);
+			frac = vdupq_n_f32(FIXED_FRACTION_TO_FLOAT(pos0));
+			for (c = 0; (c + 4) <= channels; c += 4)
+			{
+				current = vld1q_f32(cur + c);
+				next = vld1q_f32(cur + channels + c);
+				vst1q_f32(output + i * channels + c, vaddq_f32(
+					current,
+					vmulq_f32(vsubq_f32(next, current), frac)
+				));
+			}
+			for (; c < channels; c += 1)
+			{
+				output[i * channels + c] = cur[c] + (
+					(cur[channels + c] - cur[c]) *
+					FIXED_FRACTION_TO_FLOAT(pos0)
+				);
+			}
+		}
+	}
+	#undef FRAME
+
+	FAudio_INTERNAL_ResampleFixedFrames(
+		history,
+		input,
+		output,
+		i,
+		outFrames,
+		resampleStep,
+		channels
+	);
+	FAudio_memcpy(
+		history,
+		input + (inFrames - 1) * channels,
+		sizeof(float) * channels
+	);
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* Nearest-neighbour resampler, FAUDIO_VOICE_RESAMPLE_NEAREST_EXT. This is
+ * just a copy of whichever frame is closer, meant for voices that are too
+ * quiet or too far away for anyone to hear the aliasing.
+ */
+
+void FAudio_INTERNAL_ResampleNearest(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+) {
+	uint32_t i, j;
+	const float *frame;
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < toResample; i += 1)
+	{
+		frame = dCache + ((cur + (FIXED_ONE / 2)) >> FIXED_PRECISION) * channels;
+		for (j = 0; j < channels; j += 1)
+		{
+			*resampleCache++ = frame[j];
+		}
+
+		*resampleOffset += resampleStep;
+		cur += resampleStep;
+		dCache += (cur >> FIXED_PRECISION) * channels;
+		cur &= FIXED_FRACTION_MASK;
+	}
+}
+
+/* Linear resamplers for 3+ channels. The scalar version is above, these
+ * vectorize across the channels of each frame instead of across frames.
+ */
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_ResampleGeneric_SSE2(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+) {
+	uint32_t i, j;
+	float fracf;
+	__m128 frac, current, next;
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < toResample; i += 1)
+	{
+		fracf = FIXED_FRACTION_TO_FLOAT(cur);
+		frac = _mm_set1_ps(fracf);
+		for (j = 0; j + 4 <= channels; j += 4)
+		{
+			current = _mm_loadu_ps(dCache + j);
+			next = _mm_loadu_ps(dCache + j + channels);
+			_mm_storeu_ps(
+				resampleCache + j,
+				_mm_add_ps(
+					current,
+					_mm_mul_ps(_mm_sub_ps(next, current), frac)
+				)
+			);
+		}
+		if (j + 2 <= channels)
+		{
+			current = _mm_loadl_pi(
+				_mm_setzero_ps(),
+				(const __m64*) (dCache + j)
+			);
+			next = _mm_loadl_pi(
+				_mm_setzero_ps(),
+				(const __m64*) (dCache + j + channels)
+			);
+			_mm_storel_pi(
+				(__m64*) (resampleCache + j),
+				_mm_add_ps(
+					current,
+					_mm_mul_ps(_mm_sub_ps(next, current), frac)
+				)
+			);
+			j += 2;
+		}
+		for (; j < channels; j += 1)
+		{
+			resampleCache[j] = (
+				dCache[j] +
+				(dCache[j + channels] - dCache[j]) * fracf
+			);
+		}
+		resampleCache += channels;
+
+		*resampleOffset += resampleStep;
+		cur += resampleStep;
+		dCache += (cur >> FIXED_PRECISION) * channels;
+		cur &= FIXED_FRACTION_MASK;
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_ResampleGeneric_NEON(
+	float *restrict dCache,
+	float *restrict resampleCache,
+	uint64_t *resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint8_t channels
+) {
+	uint32_t i, j;
+	float fracf;
+	float32x4_t current, next;
+	float32x2_t current2, next2;
+	uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < toResample; i += 1)
+	{
+		fracf = FIXED_FRACTION_TO_FLOAT(cur);
+		for (j = 0; j + 4 <= channels; j += 4)
+		{
+			current = vld1q_f32(dCache + j);
+			next = vld1q_f32(dCache + j + channels);
+			vst1q_f32(
+				resampleCache + j,
+				vaddq_f32(
+					current,
+					vmulq_n_f32(vsubq_f32(next, current), fracf)
+				)
+			);
+		}
+		if (j + 2 <= channels)
+		{
+			current2 = vld1_f32(dCache + j);
+			next2 = vld1_f32(dCache + j + channels);
+			vst1_f32(
+				resampleCache + j,
+				vadd_f32(
+					current2,
+					vmul_n_f32(vsub_f32(next2, current2), fracf)
+				)
+			);
+			j += 2;
+		}
+		for (; j < channels; j += 1)
+		{
+			resampleCache[j] = (
+				dCache[j] +
+				(dCache[j + channels] - dCache[j]) * fracf
+			);
+		}
+		resampleCache += channels;
+
+		*resampleOffset += resampleStep;
+		cur += resampleStep;
+		dCache += (cur >> FIXED_PRECISION) * channels;
+		cur &= FIXED_FRACTION_MASK;
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* Windowed-sinc resamplers, FAUDIO_VOICE_RESAMPLE_SINC_EXT.
+ *
+ * Each output frame is an 8-tap Blackman-windowed sinc, with the taps for
+ * the nearest of SINC_PHASES fractional positions read from a table built
+ * once at startup. Only frames that are already decoded are used: the taps
+ * for position p cover frames floor(p) - 7 through floor(p), so the output
+ * runs 4 frames behind the linear resampler and needs no extra look-ahead.
+ * The 7 frames before the first decoded frame come from the voice's history,
+ * which is refilled at the end of every pass.
+ *
+ * The cutoff is fixed, so downsampling aliases the same way linear does, just
+ * with a much flatter passband and far smaller images when upsampling.
+ */
+
+/* The SSE2/NEON frame functions below assume this is 8 */
+#define SINC_TAPS (SINC_HISTORY_FRAMES + 1)
+#define SINC_PHASE_BITS 8
+#define SINC_PHASES (1 << SINC_PHASE_BITS)
+#define SINC_CUTOFF 0.9
+#define SINC_PI 3.14159265358979323846
+#define SINC_PHASE(fxd) \
+	(((fxd) + (1 << (FIXED_PRECISION - SINC_PHASE_BITS - 1))) >> \
+	(FIXED_PRECISION - SINC_PHASE_BITS))
+
+/* One extra row for a fraction that rounds up to a whole frame */
+static float FAudio_INTERNAL_SincTable[SINC_PHASES + 1][SINC_TAPS];
+
+static void FAudio_INTERNAL_InitSincTable(void)
+{
+	uint32_t phase, j;
+	double x, w, sum;
+	double taps[SINC_TAPS];
+	for (phase = 0; phase <= SINC_PHASES; phase += 1)
+	{
+		sum = 0.0;
+		for (j = 0; j < SINC_TAPS; j += 1)
+		{
+			/* Tap 3 is the frame at floor(p) - 4 */
+			x = ((double) phase / SINC_PHASES) + 3.0 - j;
+			w = (
+				0.42 +
+				0.5 * FAudio_cos(SINC_PI * x / 4.0) +
+				0.08 * FAudio_cos(2.0 * SINC_PI * x / 4.0)
+			);
+			if (x == 0.0)
+			{
+				taps[j] = SINC_CUTOFF;
+			}
+			else
+			{
+				taps[j] = FAudio_sin(SINC_PI * SINC_CUTOFF * x) / (SINC_PI * x);
+			}
+			taps[j] *= w;
+			sum += taps[j];
+		}
+
+		/* Normalize so DC passes through at every phase */
+		for (j = 0; j < SINC_TAPS; j += 1)
+		{
+			FAudio_INTERNAL_SincTable[phase][j] = (float) (taps[j] / sum);
+		}
+	}
+}
+
+/* The SINC_TAPS frames ending at dCache frame n, staged from the history
+ * when they start before the decode cache.
+ */
+static inline const float* FAudio_INTERNAL_SincFrames(
+	const float *restrict history,
+	const float *restrict dCache,
+	uint64_t n,
+	uint32_t channels,
+	float *restrict window
+) {
+	const uint32_t fromHistory = SINC_HISTORY_FRAMES - (uint32_t) n;
+	if (n >= SINC_HISTORY_FRAMES)
+	{
+		return dCache + (n - SINC_HISTORY_FRAMES) * channels;
+	}
+	FAudio_memcpy(
+		window,
+		history + n * channels,
+		sizeof(float) * fromHistory * channels
+	);
+	FAudio_memcpy(
+		window + fromHistory * channels,
+		dCache,
+		sizeof(float) * (n + 1) * channels
+	);
+	return window;
+}
+
+/* Keep the SINC_HISTORY_FRAMES frames before dCache frame n for next pass */
+static inline void FAudio_INTERNAL_SincSaveHistory(
+	float *restrict history,
+	const float *restrict dCache,
+	uint64_t n,
+	uint32_t channels
+) {
+	const uint32_t fromHistory = SINC_HISTORY_FRAMES - (uint32_t) n;
+	if (n >= SINC_HISTORY_FRAMES)
+	{
+		FAudio_memcpy(
+			history,
+			dCache + (n - SINC_HISTORY_FRAMES) * channels,
+			sizeof(float) * SINC_HISTORY_FRAMES * channels
+		);
+		return;
+	}
+	FAudio_memmove(
+		history,
+		history + n * channels,
+		sizeof(float) * fromHistory * channels
+	);
+	FAudio_memcpy(
+		history + fromHistory * channels,
+		dCache,
+		sizeof(float) * n * channels
+	);
+}
+
+#define SINC_RESAMPLE_FUNC(isa) \
+	void FAudio_INTERNAL_ResampleSinc_##isa( \
+		float *restrict history, \
+		float *restrict dCache, \
+		float *restrict resampleCache, \
+		uint64_t *resampleOffset, \
+		uint64_t resampleStep, \
+		uint64_t toResample, \
+		uint8_t channels \
+	) { \
+		uint32_t i; \
+		uint64_t n = 0; \
+		const float *frames; \
+		float window[SINC_TAPS * FAUDIO_MAX_AUDIO_CHANNELS]; \
+		uint64_t cur = *resampleOffset & FIXED_FRACTION_MASK; \
+		for (i = 0; i < toResample; i += 1) \
+		{ \
+			frames = FAudio_INTERNAL_SincFrames( \
+				history, \
+				dCache, \
+				n, \
+				channels, \
+				window \
+			); \
+			FAudio_INTERNAL_SincFrame_##isa( \
+				frames, \
+				FAudio_INTERNAL_SincTable[SINC_PHASE(cur)], \
+				resampleCache, \
+				channels \
+			); \
+			resampleCache += channels; \
+			*resampleOffset += resampleStep; \
+			cur += resampleStep; \
+			n += cur >> FIXED_PRECISION; \
+			cur &= FIXED_FRACTION_MASK; \
+		} \
+		FAudio_INTERNAL_SincSaveHistory(history, dCache, n, channels); \
+	}
+
+static inline void FAudio_INTERNAL_SincChannels(
+	const float *restrict frames,
+	const float *restrict taps,
+	float *restrict output,
+	uint32_t first,
+	uint32_t channels
+) {
+	uint32_t c, j;
+	float sum;
+	for (c = first; c < channels; c += 1)
+	{
+		sum = frames[c] * taps[0];
+		for (j = 1; j < SINC_TAPS; j += 1)
+		{
+			sum += frames[j * channels + c] * taps[j];
+		}
+		output[c] = sum;
+	}
+}
+
+static inline void FAudio_INTERNAL_SincFrame_Scalar(
+	const float *restrict frames,
+	const float *restrict taps,
+	float *restrict output,
+	uint32_t channels
+) {
+	FAudio_INTERNAL_SincChannels(frames, taps, output, 0, channels);
+}
+SINC_RESAMPLE_FUNC(Scalar)
+
+#if HAVE_SSE2_INTRINSICS
+static inline void FAudio_INTERNAL_SincFrame_SSE2(
+	const float *restrict frames,
+	const float *restrict taps,
+	float *restrict output,
+	uint32_t channels
+) {
+	uint32_t c, j;
+	__m128 t0, t1, sum;
+	t0 = _mm_loadu_ps(taps);
+	t1 = _mm_loadu_ps(taps + 4);
+	if (channels == 1)
+	{
+		sum = _mm_add_ps(
+			_mm_mul_ps(_mm_loadu_ps(frames), t0),
+			_mm_mul_ps(_mm_loadu_ps(frames + 4), t1)
+		);
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+		_mm_store_ss(output, sum);
+	}
+	else if (channels == 2)
+	{
+		/* Interleaved LRLR, so each tap is used twice in a row */
+		sum = _mm_mul_ps(_mm_loadu_ps(frames), _mm_unpacklo_ps(t0, t0));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(frames + 4), _mm_unpackhi_ps(t0, t0)));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(frames + 8), _mm_unpacklo_ps(t1, t1)));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(frames + 12), _mm_unpackhi_ps(t1, t1)));
+		sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+		_mm_storel_pi((__m64*) output, sum);
+	}
+	else
+	{
+		for (c = 0; c + 4 <= channels; c += 4)
+		{
+			sum = _mm_mul_ps(_mm_loadu_ps(frames + c), _mm_set1_ps(taps[0]));
+			for (j = 1; j < SINC_TAPS; j += 1)
+			{
+				sum = _mm_add_ps(sum, _mm_mul_ps(
+					_mm_loadu_ps(frames + j * channels + c),
+					_mm_set1_ps(taps[j])
+				));
+			}
+			_mm_storeu_ps(output + c, sum);
+		}
+		FAudio_INTERNAL_SincChannels(frames, taps, output, c, channels);
+	}
+}
+SINC_RESAMPLE_FUNC(SSE2)
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+static inline void FAudio_INTERNAL_SincFrame_NEON(
+	const float *restrict frames,
+	const float *restrict taps,
+	float *restrict output,
+	uint32_t channels
+) {
+	uint32_t c, j;
+	float32x4_t t0, t1, sum;
+	float32x4x2_t z;
+	float32x2_t half;
+	t0 = vld1q_f32(taps);
+	t1 = vld1q_f32(taps + 4);
+	if (channels == 1)
+	{
+		sum = vmulq_f32(vld1q_f32(frames), t0);
+		sum = vmlaq_f32(sum, vld1q_f32(frames + 4), t1);
+		half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+		half = vpadd_f32(half, half);
+		vst1_lane_f32(output, half, 0);
+	}
+	else if (channels == 2)
+	{
+		/* Interleaved LRLR, so each tap is used twice in a row */
+		z = vzipq_f32(t0, t0);
+		sum = vmulq_f32(vld1q_f32(frames), z.val[0]);
+		sum = vmlaq_f32(sum, vld1q_f32(frames + 4), z.val[1]);
+		z = vzipq_f32(t1, t1);
+		sum = vmlaq_f32(sum, vld1q_f32(frames + 8), z.val[0]);
+		sum = vmlaq_f32(sum, vld1q_f32(frames + 12), z.val[1]);
+		vst1_f32(output, vadd_f32(vget_low_f32(sum), vget_high_f32(sum)));
+	}
+	else
+	{
+		for (c = 0; c + 4 <= channels; c += 4)
+		{
+			sum = vmulq_n_f32(vld1q_f32(frames + c), taps[0]);
+			for (j = 1; j < SINC_TAPS; j += 1)
+			{
+				sum = vmlaq_n_f32(
+					sum,
+					vld1q_f32(frames + j * channels + c),
+					taps[j]
+				);
+			}
+			vst1q_f32(output + c, sum);
+		}
+		FAudio_INTERNAL_SincChannels(frames, taps, output, c, channels);
+	}
+}
+SINC_RESAMPLE_FUNC(NEON)
+#endif /* HAVE_NEON_INTRINSICS */
+
+#undef SINC_RESAMPLE_FUNC
+
+/* SECTION 3: Amplifiers */
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_Amplify_Scalar(
+	float* output,
+	uint32_t totalSamples,
+	float volume
+) {
+	uint32_t i;
+	for (i = 0; i < totalSamples; i += 1)
+	{
+		output[i] *= volume;
+		output[i] = FAudio_clamp(
+			output[i],
+			-FAUDIO_MAX_VOLUME_LEVEL,
+			FAUDIO_MAX_VOLUME_LEVEL
+		);
+	}
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
+
+/* The SSE2 version of the amplifier comes from @8thMage! */
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_Amplify_SSE2(
+	float* output,
+	uint32_t totalSamples,
+	float volume
+) {
+	uint32_t i;
+	uint32_t header = (16 - (((size_t) output) % 16)) / 4;
+	uint32_t tail = (totalSamples - header) % 4;
+	__m128 volumeVec, minVolumeVec, maxVolumeVec, outVec;
+	if (header == 4)
+	{
+		header = 0;
+	}
+	if (tail == 4)
+	{
+		tail = 0;
+	}
+
+	for (i = 0; i < header; i += 1)
+	{
+		output[i] *= volume;
+		output[i] = FAudio_clamp(
+			output[i],
+			-FAUDIO_MAX_VOLUME_LEVEL,
+			FAUDIO_MAX_VOLUME_LEVEL
+		);
+	}
+
+	volumeVec = _mm_set1_ps(volume);
+	minVolumeVec = _mm_set1_ps(-FAUDIO_MAX_VOLUME_LEVEL);
+	maxVolumeVec = _mm_set1_ps(FAUDIO_MAX_VOLUME_LEVEL);
+	for (i = header; i < totalSamples - tail; i += 4)
+	{
+		outVec = _mm_load_ps(output + i);
+		outVec = _mm_mul_ps(outVec, volumeVec);
+		outVec = _mm_max_ps(outVec, minVolumeVec);
+		outVec = _mm_min_ps(outVec, maxVolumeVec);
+		_mm_store_ps(output + i, outVec);
+	}
+
+	for (i = totalSamples - tail; i < totalSamples; i += 1)
+	{
+		output[i] *= volume;
+		output[i] = FAudio_clamp(
+			output[i],
+			-FAUDIO_MAX_VOLUME_LEVEL,
+			FAUDIO_MAX_VOLUME_LEVEL
+		);
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Amplify_AVX2(
+	float* output,
+	uint32_t totalSamples,
+	float volume
+) {
+	uint32_t i;
+	__m256 volumeVec, minVolumeVec, maxVolumeVec, outVec;
+
+	volumeVec = _mm256_set1_ps(volume);
+	minVolumeVec = _mm256_set1_ps(-FAUDIO_MAX_VOLUME_LEVEL);
+	maxVolumeVec = _mm256_set1_ps(FAUDIO_MAX_VOLUME_LEVEL);
+	for (i = 0; (i + 8) <= totalSamples; i += 8)
+	{
+		outVec = _mm256_loadu_ps(output + i);
+		outVec = _mm256_mul_ps(outVec, volumeVec);
+		outVec = _mm256_max_ps(outVec, minVolumeVec);
+		outVec = _mm256_min_ps(outVec, maxVolumeVec);
+		_mm256_storeu_ps(output + i, outVec);
+	}
+
+	for (; i < totalSamples; i += 1)
+	{
+		output[i] *= volume;
+		output[i] = FAudio_clamp(
+			output[i],
+			-FAUDIO_MAX_VOLUME_LEVEL,
+			FAUDIO_MAX_VOLUME_LEVEL
+		);
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_Amplify_NEON(
+	float* output,
+	uint32_t totalSamples,
+	float volume
+) {
+	uint32_t i;
+	uint32_t header = (16 - (((size_t) output) % 16)) / 4;
+	uint32_t tail = (totalSamples - header) % 4;
+	float32x4_t volumeVec, minVolumeVec, maxVolumeVec, outVec;
+	if (header == 4)
+	{
+		header = 0;
+	}
+	if (tail == 4)
+	{
+		tail = 0;
+	}
+
+	for (i = 0; i < header; i += 1)
+	{
+		output[i] *= volume;
+		output[i] = FAudio_clamp(
+			output[i],
+			-FAUDIO_MAX_VOLUME_LEVEL,
+			FAUDIO_MAX_VOLUME_LEVEL
+		);
+	}
+
+	volumeVec = vdupq_n_f32(volume);
+	minVolumeVec = vdupq_n_f32(-FAUDIO_MAX_VOLUME_LEVEL);
+	maxVolumeVec = vdupq_n_f32(FAUDIO_MAX_VOLUME_LEVEL);
+	for (i = header; i < totalSamples - tail; i += 4)
+	{
+		outVec = vld1q_f32(output + i);
+		outVec = vmulq_f32(outVec, volumeVec);
+		outVec = vmaxq_f32(outVec, minVolumeVec);
+		outVec = vminq_f32(outVec, maxVolumeVec);
+		vst1q_f32(output + i, outVec);
+	}
+
+	for (i = totalSamples - tail; i < totalSamples; i += 1)
+	{
+		output[i] *= volume;
+		output[i] = FAudio_clamp(
+			output[i],
+			-FAUDIO_MAX_VOLUME_LEVEL,
+			FAUDIO_MAX_VOLUME_LEVEL
+		);
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* Returns 1 if every sample is 0.0f. -0.0f counts as silence, NaN doesn't.
+ * Nonsilent buffers usually fail within a few samples, so the vector
+ * versions check as they go rather than at the end.
+ */
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+uint8_t FAudio_INTERNAL_IsSilent_Scalar(
+	const float *samples,
+	uint32_t totalSamples
+) {
+	uint32_t i;
+	for (i = 0; i < totalSamples; i += 1)
+	{
+		if (samples[i] != 0.0f)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
+
+#if HAVE_SSE2_INTRINSICS
+uint8_t FAudio_INTERNAL_IsSilent_SSE2(
+	const float *samples,
+	uint32_t totalSamples
+) {
+	uint32_t i;
+	const __m128 zero = _mm_setzero_ps();
+	__m128 nonzero;
+
+	for (i = 0; (i + 16) <= totalSamples; i += 16)
+	{
+		nonzero = _mm_or_ps(
+			_mm_or_ps(
+				_mm_cmpneq_ps(_mm_loadu_ps(samples + i), zero),
+				_mm_cmpneq_ps(_mm_loadu_ps(samples + i + 4), zero)
+			),
+			_mm_or_ps(
+				_mm_cmpneq_ps(_mm_loadu_ps(samples + i + 8), zero),
+				_mm_cmpneq_ps(_mm_loadu_ps(samples + i + 12), zero)
+			)
+		);
+		if (_mm_movemask_ps(nonzero) != 0)
+		{
+			return 0;
+		}
+	}
+	for (; (i + 4) <= totalSamples; i += 4)
+	{
+		nonzero = _mm_cmpneq_ps(_mm_loadu_ps(samples + i), zero);
+		if (_mm_movemask_ps(nonzero) != 0)
+		{
+			return 0;
+		}
+	}
+	for (; i < totalSamples; i += 1)
+	{
+		if (samples[i] != 0.0f)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+uint8_t FAudio_INTERNAL_IsSilent_AVX2(
+	const float *samples,
+	uint32_t totalSamples
+) {
+	uint32_t i;
+	const __m256 zero = _mm256_setzero_ps();
+	__m256 nonzero;
+
+	for (i = 0; (i + 32) <= totalSamples; i += 32)
+	{
+		nonzero = _mm256_or_ps(
+			_mm256_or_ps(
+				_mm256_cmp_ps(_mm256_loadu_ps(samples + i), zero, _CMP_NEQ_UQ),
+				_mm256_cmp_ps(_mm256_loadu_ps(samples + i + 8), zero, _CMP_NEQ_UQ)
+			),
+			_mm256_or_ps(
+				_mm256_cmp_ps(_mm256_loadu_ps(samples + i + 16), zero, _CMP_NEQ_UQ),
+				_mm256_cmp_ps(_mm256_loadu_ps(samples + i + 24), zero, _CMP_NEQ_UQ)
+			)
+		);
+		if (_mm256_movemask_ps(nonzero) != 0)
+		{
+			return 0;
+		}
+	}
+	for (; (i + 8) <= totalSamples; i += 8)
+	{
+		nonzero = _mm256_cmp_ps(_mm256_loadu_ps(samples + i), zero, _CMP_NEQ_UQ);
+		if (_mm256_movemask_ps(nonzero) != 0)
+		{
+			return 0;
+		}
+	}
+	for (; i < totalSamples; i += 1)
+	{
+		if (samples[i] != 0.0f)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+uint8_t FAudio_INTERNAL_IsSilent_NEON(
+	const float *samples,
+	uint32_t totalSamples
+) {
+	uint32_t i;
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	uint32x4_t equal;
+	uint32x2_t half;
+
+	for (i = 0; (i + 16) <= totalSamples; i += 16)
+	{
+		equal = vandq_u32(
+			vandq_u32(
+				vceqq_f32(vld1q_f32(samples + i), zero),
+				vceqq_f32(vld1q_f32(samples + i + 4), zero)
+			),
+			vandq_u32(
+				vceqq_f32(vld1q_f32(samples + i + 8), zero),
+				vceqq_f32(vld1q_f32(samples + i + 12), zero)
+			)
+		);
+		half = vand_u32(vget_low_u32(equal), vget_high_u32(equal));
+		if ((vget_lane_u32(half, 0) & vget_lane_u32(half, 1)) != 0xFFFFFFFF)
+		{
+			return 0;
+		}
+	}
+	for (; i < totalSamples; i += 1)
+	{
+		if (samples[i] != 0.0f)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* Writes the largest absolute sample of every frame. Every version picks the
+ * same sample, so they all match exactly, as long as there are no NaNs.
+ */
+
+static inline float FAudio_INTERNAL_Peak(float peak, float sample)
+{
+	sample = FAudio_fabsf(sample);
+	return (sample > peak) ? sample : peak;
+}
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_FramePeaks_Scalar(
+	const float *restrict samples,
+	float *restrict peaks,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	float peak;
+	for (i = 0; i < frames; i += 1, samples += channels)
+	{
+		peak = 0.0f;
+		for (c = 0; c < channels; c += 1)
+		{
+			peak = FAudio_INTERNAL_Peak(peak, samples[c]);
+		}
+		peaks[i] = peak;
+	}
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_FramePeaks_SSE2(
+	const float *restrict samples,
+	float *restrict peaks,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	float peak;
+	__m128 a, b, acc;
+	const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+	i = 0;
+	if (channels == 1)
+	{
+		for (; (i + 4) <= frames; i += 4)
+		{
+			_mm_storeu_ps(
+				peaks + i,
+				_mm_and_ps(_mm_loadu_ps(samples + i), mask)
+			);
+		}
+	}
+	else if (channels == 2)
+	{
+		/* Deinterleave 4 frames, then pick the larger channel */
+		for (; (i + 4) <= frames; i += 4)
+		{
+			a = _mm_and_ps(_mm_loadu_ps(samples + (i * 2)), mask);
+			b = _mm_and_ps(_mm_loadu_ps(samples + (i * 2) + 4), mask);
+			_mm_storeu_ps(
+				peaks + i,
+				_mm_max_ps(
+					_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)),
+					_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))
+				)
+			);
+		}
+	}
+	else
+	{
+		/* 4 channels at a time, then across the vector */
+		for (; i < frames; i += 1)
+		{
+			acc = _mm_setzero_ps();
+			for (c = 0; (c + 4) <= channels; c += 4)
+			{
+				acc = _mm_max_ps(
+					_mm_and_ps(
+						_mm_loadu_ps(samples + (i * channels) + c),
+						mask
+					),
+					acc
+				);
+			}
+			acc = _mm_max_ps(acc, _mm_movehl_ps(acc, acc));
+			acc = _mm_max_ps(
+				acc,
+				_mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1))
+			);
+			peak = _mm_cvtss_f32(acc);
+			for (; c < channels; c += 1)
+			{
+				peak = FAudio_INTERNAL_Peak(
+					peak,
+					samples[(i * channels) + c]
+				);
+			}
+			peaks[i] = peak;
+		}
+	}
+
+	for (; i < frames; i += 1)
+	{
+		peak = 0.0f;
+		for (c = 0; c < channels; c += 1)
+		{
+			peak = FAudio_INTERNAL_Peak(peak, samples[(i * channels) + c]);
+		}
+		peaks[i] = peak;
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_FramePeaks_NEON(
+	const float *restrict samples,
+	float *restrict peaks,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	float peak;
+	float32x4_t acc;
+	float32x4x2_t split;
+	float32x2_t half;
+
+	i = 0;
+	if (channels == 1)
+	{
+		for (; (i + 4) <= frames; i += 4)
+		{
+			vst1q_f32(peaks + i, vabsq_f32(vld1q_f32(samples + i)));
+		}
+	}
+	else if (channels == 2)
+	{
+		/* Deinterleave 4 frames, then pick the larger channel */
+		for (; (i + 4) <= frames; i += 4)
+		{
+			split = vuzpq_f32(
+				vabsq_f32(vld1q_f32(samples + (i * 2))),
+				vabsq_f32(vld1q_f32(samples + (i * 2) + 4))
+			);
+			vst1q_f32(peaks + i, vmaxq_f32(split.val[1], split.val[0]));
+		}
+	}
+	else
+	{
+		/* 4 channels at a time, then across the vector */
+		for (; i < frames; i += 1)
+		{
+			acc = vdupq_n_f32(0.0f);
+			for (c = 0; (c + 4) <= channels; c += 4)
+			{
+				acc = vmaxq_f32(
+					vabsq_f32(vld1q_f32(samples + (i * channels) + c)),
+					acc
+				);
+			}
+			half = vpmax_f32(vget_low_f32(acc), vget_high_f32(acc));
+			half = vpmax_f32(half, half);
+			peak = vget_lane_f32(half, 0);
+			for (; c < channels; c += 1)
+			{
+				peak = FAudio_INTERNAL_Peak(
+					peak,
+					samples[(i * channels) + c]
+				);
+			}
+			peaks[i] = peak;
+		}
+	}
+
+	for (; i < frames; i += 1)
+	{
+		peak = 0.0f;
+		for (c = 0; c < channels; c += 1)
+		{
+			peak = FAudio_INTERNAL_Peak(peak, samples[(i * channels) + c]);
+		}
+		peaks[i] = peak;
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* Writes the largest absolute sample and the sum of squares of every channel,
+ * reading the interleaved samples once. The SIMD versions sum each channel in
+ * a different order, so their sums are only close to the scalar one.
+ *
+ * A vector of 4 samples doesn't line up with the frames unless the channel
+ * count divides 4, so the vector versions walk the buffer in periods of
+ * lcm(channels, 4) samples, keeping one accumulator per vector of the period.
+ * Each lane of an accumulator then always holds the same channel.
+ */
+
+#define CHANNEL_LEVELS_MAX_VECTORS 8
+
+static inline uint32_t FAudio_INTERNAL_LevelsVectors(uint32_t channels)
+{
+	if ((channels % 4) == 0)
+	{
+		return channels / 4;
+	}
+	if ((channels % 2) == 0)
+	{
+		return channels / 2;
+	}
+	return channels;
+}
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_ChannelLevels_Scalar(
+	const float *restrict samples,
+	float *restrict peaks,
+	float *restrict sums,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, c;
+	for (c = 0; c < channels; c += 1)
+	{
+		peaks[c] = 0.0f;
+		sums[c] = 0.0f;
+	}
+	for (i = 0; i < frames; i += 1, samples += channels)
+	{
+		for (c = 0; c < channels; c += 1)
+		{
+			peaks[c] = FAudio_INTERNAL_Peak(peaks[c], samples[c]);
+			sums[c] += samples[c] * samples[c];
+		}
+	}
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_ChannelLevels_SSE2(
+	const float *restrict samples,
+	float *restrict peaks,
+	float *restrict sums,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, v, c, vectors, period, total;
+	__m128 peak[CHANNEL_LEVELS_MAX_VECTORS];
+	__m128 sum[CHANNEL_LEVELS_MAX_VECTORS];
+	float peakLanes[CHANNEL_LEVELS_MAX_VECTORS * 4];
+	float sumLanes[CHANNEL_LEVELS_MAX_VECTORS * 4];
+	__m128 x;
+	const __m128 mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+	for (c = 0; c < channels; c += 1)
+	{
+		peaks[c] = 0.0f;
+		sums[c] = 0.0f;
+	}
+
+	i = 0;
+	total = frames * channels;
+	vectors = FAudio_INTERNAL_LevelsVectors(channels);
+	period = vectors * 4;
+	if (vectors == 1)
+	{
+		/* Mono, stereo and quad fit in one accumulator */
+		peak[0] = _mm_setzero_ps();
+		sum[0] = _mm_setzero_ps();
+		for (; (i + 4) <= total; i += 4)
+		{
+			x = _mm_loadu_ps(samples + i);
+			peak[0] = _mm_max_ps(peak[0], _mm_and_ps(x, mask));
+			sum[0] = _mm_add_ps(sum[0], _mm_mul_ps(x, x));
+		}
+	}
+	else if (vectors <= CHANNEL_LEVELS_MAX_VECTORS)
+	{
+		for (v = 0; v < vectors; v += 1)
+		{
+			peak[v] = _mm_setzero_ps();
+			sum[v] = _mm_setzero_ps();
+		}
+		for (; (i + period) <= total; i += period)
+		{
+			for (v = 0; v < vectors; v += 1)
+			{
+				x = _mm_loadu_ps(samples + i + (v * 4));
+				peak[v] = _mm_max_ps(peak[v], _mm_and_ps(x, mask));
+				sum[v] = _mm_add_ps(sum[v], _mm_mul_ps(x, x));
+			}
+		}
+	}
+	else
+	{
+		/* Too many accumulators, the whole buffer is the remainder */
+		vectors = 0;
+	}
+
+	/* Lane j of the period belongs to channel j % channels */
+	for (v = 0; v < vectors; v += 1)
+	{
+		_mm_storeu_ps(peakLanes + (v * 4), peak[v]);
+		_mm_storeu_ps(sumLanes + (v * 4), sum[v]);
+	}
+	for (v = 0; v < vectors * 4; v += 1)
+	{
+		c = v % channels;
+		peaks[c] = FAudio_INTERNAL_Peak(peaks[c], peakLanes[v]);
+		sums[c] += sumLanes[v];
+	}
+
+	/* i is always on a frame boundary */
+	for (c = 0; i < total; i += 1)
+	{
+		peaks[c] = FAudio_INTERNAL_Peak(peaks[c], samples[i]);
+		sums[c] += samples[i] * samples[i];
+		c += 1;
+		if (c == channels)
+		{
+			c = 0;
+		}
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_ChannelLevels_NEON(
+	const float *restrict samples,
+	float *restrict peaks,
+	float *restrict sums,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, v, c, vectors, period, total;
+	float32x4_t peak[CHANNEL_LEVELS_MAX_VECTORS];
+	float32x4_t sum[CHANNEL_LEVELS_MAX_VECTORS];
+	float peakLanes[CHANNEL_LEVELS_MAX_VECTORS * 4];
+	float sumLanes[CHANNEL_LEVELS_MAX_VECTORS * 4];
+	float32x4_t x;
+
+	for (c = 0; c < channels; c += 1)
+	{
+		peaks[c] = 0.0f;
+		sums[c] = 0.0f;
+	}
+
+	i = 0;
+	total = frames * channels;
+	vectors = FAudio_INTERNAL_LevelsVectors(channels);
+	period = vectors * 4;
+	if (vectors == 1)
+	{
+		/* Mono, stereo and quad fit in one accumulator */
+		peak[0] = vdupq_n_f32(0.0f);
+		sum[0] = vdupq_n_f32(0.0f);
+		for (; (i + 4) <= total; i += 4)
+		{
+			x = vld1q_f32(samples + i);
+			peak[0] = vmaxq_f32(peak[0], vabsq_f32(x));
+			sum[0] = vmlaq_f32(sum[0], x, x);
+		}
+	}
+	else if (vectors <= CHANNEL_LEVELS_MAX_VECTORS)
+	{
+		for (v = 0; v < vectors; v += 1)
+		{
+			peak[v] = vdupq_n_f32(0.0f);
+			sum[v] = vdupq_n_f32(0.0f);
+		}
+		for (; (i + period) <= total; i += period)
+		{
+			for (v = 0; v < vectors; v += 1)
+			{
+				x = vld1q_f32(samples + i + (v * 4));
+				peak[v] = vmaxq_f32(peak[v], vabsq_f32(x));
+				sum[v] = vmlaq_f32(sum[v], x, x);
+			}
+		}
+	}
+	else
+	{
+		/* Too many accumulators, the whole buffer is the remainder */
+		vectors = 0;
+	}
+
+	/* Lane j of the period belongs to channel j % channels */
+	for (v = 0; v < vectors; v += 1)
+	{
+		vst1q_f32(peakLanes + (v * 4), peak[v]);
+		vst1q_f32(sumLanes + (v * 4), sum[v]);
+	}
+	for (v = 0; v < vectors * 4; v += 1)
+	{
+		c = v % channels;
+		peaks[c] = FAudio_INTERNAL_Peak(peaks[c], peakLanes[v]);
+		sums[c] += sumLanes[v];
+	}
+
+	/* i is always on a frame boundary */
+	for (c = 0; i < total; i += 1)
+	{
+		peaks[c] = FAudio_INTERNAL_Peak(peaks[c], samples[i]);
+		sums[c] += samples[i] * samples[i];
+		c += 1;
+		if (c == channels)
+		{
+			c = 0;
+		}
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+#undef CHANNEL_LEVELS_MAX_VECTORS
+
+/* SECTION 4: State-Variable Filters */
+
+/* Apply a digital state-variable filter to the voice.
+ * The difference equations of the filter are:
+ *
+ * Yl(n) = F Yb(n - 1) + Yl(n - 1)
+ * Yh(n) = x(n) - Yl(n) - OneOverQ Yb(n - 1)
+ * Yb(n) = F Yh(n) + Yb(n - 1)
+ * Yn(n) = Yl(n) + Yh(n)
+ *
+ * Please note that FAudioFilterParameters.Frequency is defined as:
+ *
+ * (2 * sin(pi * (desired filter cutoff frequency) / sampleRate))
+ *
+ * - @JohanSmet
+ *
+ * The SIMD versions run each channel in its own lane, in groups of 4 or 2.
+ * The recurrence is serial in time, so mono (and any odd channel left over)
+ * still goes through the scalar loop. All versions do the same float ops in
+ * the same order, so their output matches the scalar filter exactly.
+ */
+
+static inline void FAudio_INTERNAL_FilterChannels(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t numChannels,
+	uint16_t firstChannel
+) {
+	uint32_t j, ci;
+	for (j = 0; j < numSamples; j += 1)
+	for (ci = firstChannel; ci < numChannels; ci += 1)
+	{
+		filterState[ci][FAudioLowPassFilter] = filterState[ci][FAudioLowPassFilter] + (filter->Frequency * filterState[ci][FAudioBandPassFilter]);
+		filterState[ci][FAudioHighPassFilter] = samples[j * numChannels + ci] - filterState[ci][FAudioLowPassFilter] - (filter->OneOverQ * filterState[ci][FAudioBandPassFilter]);
+		filterState[ci][FAudioBandPassFilter] = (filter->Frequency * filterState[ci][FAudioHighPassFilter]) + filterState[ci][FAudioBandPassFilter];
+		filterState[ci][FAudioNotchFilter] = filterState[ci][FAudioHighPassFilter] + filterState[ci][FAudioLowPassFilter];
+		samples[j * numChannels + ci] = filterState[ci][filter->Type];
+	}
+}
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_FilterVoice_Scalar(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t numChannels
+) {
+	FAudio_INTERNAL_FilterChannels(
+		filter,
+		filterState,
+		samples,
+		numSamples,
+		numChannels,
+		0
+	);
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
+
+#if HAVE_SSE2_INTRINSICS
+static inline void FAudio_INTERNAL_FilterLanes_SSE2(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t stride,
+	uint8_t lanes
+) {
+	uint32_t j, ci;
+	float lp[4], bp[4], hp[4], notch[4];
+	__m128 lpVec, bpVec, hpVec, notchVec, inVec, outVec;
+	__m128 freqVec, oneOverQVec, lpMask, bpMask, hpMask, notchMask;
+
+	for (ci = 0; ci < 4; ci += 1)
+	{
+		if (ci < lanes)
+		{
+			lp[ci] = filterState[ci][FAudioLowPassFilter];
+			bp[ci] = filterState[ci][FAudioBandPassFilter];
+			hp[ci] = filterState[ci][FAudioHighPassFilter];
+			notch[ci] = filterState[ci][FAudioNotchFilter];
+		}
+		else
+		{
+			lp[ci] = bp[ci] = hp[ci] = notch[ci] = 0.0f;
+		}
+	}
+	lpVec = _mm_loadu_ps(lp);
+	bpVec = _mm_loadu_ps(bp);
+	hpVec = _mm_loadu_ps(hp);
+	notchVec = _mm_loadu_ps(notch);
+
+	freqVec = _mm_set1_ps(filter->Frequency);
+	oneOverQVec = _mm_set1_ps(filter->OneOverQ);
+	#define TYPE_MASK(type) _mm_castsi128_ps(_mm_set1_epi32( \
+		(filter->Type == type) ? -1 : 0 \
+	))
+	lpMask = TYPE_MASK(FAudioLowPassFilter);
+	bpMask = TYPE_MASK(FAudioBandPassFilter);
+	hpMask = TYPE_MASK(FAudioHighPassFilter);
+	notchMask = TYPE_MASK(FAudioNotchFilter);
+	#undef TYPE_MASK
+
+	for (j = 0; j < numSamples; j += 1, samples += stride)
+	{
+		inVec = (lanes == 4) ?
+			_mm_loadu_ps(samples) :
+			_mm_loadl_pi(_mm_setzero_ps(), (const __m64*) samples);
+
+		lpVec = _mm_add_ps(lpVec, _mm_mul_ps(freqVec, bpVec));
+		hpVec = _mm_sub_ps(
+			_mm_sub_ps(inVec, lpVec),
+			_mm_mul_ps(oneOverQVec, bpVec)
+		);
+		bpVec = _mm_add_ps(_mm_mul_ps(freqVec, hpVec), bpVec);
+		notchVec = _mm_add_ps(hpVec, lpVec);
+
+		outVec = _mm_or_ps(
+			_mm_or_ps(
+				_mm_and_ps(lpVec, lpMask),
+				_mm_and_ps(bpVec, bpMask)
+			),
+			_mm_or_ps(
+				_mm_and_ps(hpVec, hpMask),
+				_mm_and_ps(notchVec, notchMask)
+			)
+		);
+		if (lanes == 4)
+		{
+			_mm_storeu_ps(samples, outVec);
+		}
+		else
+		{
+			_mm_storel_pi((__m64*) samples, outVec);
+		}
+	}
+
+	_mm_storeu_ps(lp, lpVec);
+	_mm_storeu_ps(bp, bpVec);
+	_mm_storeu_ps(hp, hpVec);
+	_mm_storeu_ps(notch, notchVec);
+	for (ci = 0; ci < lanes; ci += 1)
+	{
+		filterState[ci][FAudioLowPassFilter] = lp[ci];
+		filterState[ci][FAudioBandPassFilter] = bp[ci];
+		filterState[ci][FAudioHighPassFilter] = hp[ci];
+		filterState[ci][FAudioNotchFilter] = notch[ci];
+	}
+}
+
+void FAudio_INTERNAL_FilterVoice_SSE2(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t numChannels
+) {
+	uint16_t ci = 0;
+
+	/* The common layouts get constant strides, the rest are split into
+	 * as many 4- and 2-lane groups as fit, then finished off in scalar.
+	 */
+	switch (numChannels)
+	{
+	case 1:
+		FAudio_INTERNAL_FilterChannels(filter, filterState, samples, numSamples, 1, 0);
+		break;
+	case 2:
+		FAudio_INTERNAL_FilterLanes_SSE2(filter, filterState, samples, numSamples, 2, 2);
+		break;
+	case 6:
+		FAudio_INTERNAL_FilterLanes_SSE2(filter, filterState, samples, numSamples, 6, 4);
+		FAudio_INTERNAL_FilterLanes_SSE2(filter, filterState + 4, samples + 4, numSamples, 6, 2);
+		break;
+	case 8:
+		FAudio_INTERNAL_FilterLanes_SSE2(filter, filterState, samples, numSamples, 8, 4);
+		FAudio_INTERNAL_FilterLanes_SSE2(filter, filterState + 4, samples + 4, numSamples, 8, 4);
+		break;
+	default:
+		for (; (ci + 4) <= numChannels; ci += 4)
+		{
+			FAudio_INTERNAL_FilterLanes_SSE2(filter, filterState + ci, samples + ci, numSamples, numChannels, 4);
+		}
+		if ((ci + 2) <= numChannels)
+		{
+			FAudio_INTERNAL_FilterLanes_SSE2(filter, filterState + ci, samples + ci, numSamples, numChannels, 2);
+			ci += 2;
+		}
+		if (ci < numChannels)
+		{
+			FAudio_INTERNAL_FilterChannels(filter, filterState, samples, numSamples, numChannels, ci);
+		}
+		break;
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+/* 7.1 fits in a single 8-lane group, everything else is left to SSE2 */
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_FilterVoice_AVX2(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t numChannels
+) {
+	uint32_t j, ci;
+	float lp[8], bp[8], hp[8], notch[8];
+	__m256 lpVec, bpVec, hpVec, notchVec, inVec, outVec;
+	__m256 freqVec, oneOverQVec, lpMask, bpMask, hpMask, notchMask;
+
+	if (numChannels != 8)
+	{
+		FAudio_INTERNAL_FilterVoice_SSE2(
+			filter,
+			filterState,
+			samples,
+			numSamples,
+			numChannels
+		);
+		return;
+	}
+
+	for (ci = 0; ci < 8; ci += 1)
+	{
+		lp[ci] = filterState[ci][FAudioLowPassFilter];
+		bp[ci] = filterState[ci][FAudioBandPassFilter];
+		hp[ci] = filterState[ci][FAudioHighPassFilter];
+		notch[ci] = filterState[ci][FAudioNotchFilter];
+	}
+	lpVec = _mm256_loadu_ps(lp);
+	bpVec = _mm256_loadu_ps(bp);
+	hpVec = _mm256_loadu_ps(hp);
+	notchVec = _mm256_loadu_ps(notch);
+
+	freqVec = _mm256_set1_ps(filter->Frequency);
+	oneOverQVec = _mm256_set1_ps(filter->OneOverQ);
+	#define TYPE_MASK(type) _mm256_castsi256_ps(_mm256_set1_epi32( \
+		(filter->Type == type) ? -1 : 0 \
+	))
+	lpMask = TYPE_MASK(FAudioLowPassFilter);
+	bpMask = TYPE_MASK(FAudioBandPassFilter);
+	hpMask = TYPE_MASK(FAudioHighPassFilter);
+	notchMask = TYPE_MASK(FAudioNotchFilter);
+	#undef TYPE_MASK
+
+	for (j = 0; j < numSamples; j += 1, samples += 8)
+	{
+		inVec = _mm256_loadu_ps(samples);
+
+		lpVec = _mm256_add_ps(lpVec, _mm256_mul_ps(freqVec, bpVec));
+		hpVec = _mm256_sub_ps(
+			_mm256_sub_ps(inVec, lpVec),
+			_mm256_mul_ps(oneOverQVec, bpVec)
+		);
+		bpVec = _mm256_add_ps(_mm256_mul_ps(freqVec, hpVec), bpVec);
+		notchVec = _mm256_add_ps(hpVec, lpVec);
+
+		outVec = _mm256_or_ps(
+			_mm256_or_ps(
+				_mm256_and_ps(lpVec, lpMask),
+				_mm256_and_ps(bpVec, bpMask)
+			),
+			_mm256_or_ps(
+				_mm256_and_ps(hpVec, hpMask),
+				_mm256_and_ps(notchVec, notchMask)
+			)
+		);
+		_mm256_storeu_ps(samples, outVec);
+	}
+
+	_mm256_storeu_ps(lp, lpVec);
+	_mm256_storeu_ps(bp, bpVec);
+	_mm256_storeu_ps(hp, hpVec);
+	_mm256_storeu_ps(notch, notchVec);
+	for (ci = 0; ci < 8; ci += 1)
+	{
+		filterState[ci][FAudioLowPassFilter] = lp[ci];
+		filterState[ci][FAudioBandPassFilter] = bp[ci];
+		filterState[ci][FAudioHighPassFilter] = hp[ci];
+		filterState[ci][FAudioNotchFilter] = notch[ci];
+	}
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+static inline void FAudio_INTERNAL_FilterLanes_NEON(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t stride,
+	uint8_t lanes
+) {
+	uint32_t j, ci;
+	float lp[4], bp[4], hp[4], notch[4];
+	float32x4_t lpVec, bpVec, hpVec, notchVec, inVec, outVec;
+	float32x4_t freqVec, oneOverQVec;
+	uint32x4_t lpMask, bpMask, hpMask;
+
+	for (ci = 0; ci < 4; ci += 1)
+	{
+		if (ci < lanes)
+		{
+			lp[ci] = filterState[ci][FAudioLowPassFilter];
+			bp[ci] = filterState[ci][FAudioBandPassFilter];
+			hp[ci] = filterState[ci][FAudioHighPassFilter];
+			notch[ci] = filterState[ci][FAudioNotchFilter];
+		}
+		else
+		{
+			lp[ci] = bp[ci] = hp[ci] = notch[ci] = 0.0f;
+		}
+	}
+	lpVec = vld1q_f32(lp);
+	bpVec = vld1q_f32(bp);
+	hpVec = vld1q_f32(hp);
+	notchVec = vld1q_f32(notch);
+
+	freqVec = vdupq_n_f32(filter->Frequency);
+	oneOverQVec = vdupq_n_f32(filter->OneOverQ);
+	lpMask = vdupq_n_u32((filter->Type == FAudioLowPassFilter) ? 0xFFFFFFFF : 0);
+	bpMask = vdupq_n_u32((filter->Type == FAudioBandPassFilter) ? 0xFFFFFFFF : 0);
+	hpMask = vdupq_n_u32((filter->Type == FAudioHighPassFilter) ? 0xFFFFFFFF : 0);
+
+	for (j = 0; j < numSamples; j += 1, samples += stride)
+	{
+		inVec = (lanes == 4) ?
+			vld1q_f32(samples) :
+			vcombine_f32(vld1_f32(samples), vdup_n_f32(0.0f));
+
+		/* No vmlaq here, it may fuse and break scalar equivalence */
+		lpVec = vaddq_f32(lpVec, vmulq_f32(freqVec, bpVec));
+		hpVec = vsubq_f32(
+			vsubq_f32(inVec, lpVec),
+			vmulq_f32(oneOverQVec, bpVec)
+		);
+		bpVec = vaddq_f32(vmulq_f32(freqVec, hpVec), bpVec);
+		notchVec = vaddq_f32(hpVec, lpVec);
+
+		outVec = vbslq_f32(
+			lpMask,
+			lpVec,
+			vbslq_f32(
+				bpMask,
+				bpVec,
+				vbslq_f32(hpMask, hpVec, notchVec)
+			)
+		);
+		if (lanes == 4)
+		{
+			vst1q_f32(samples, outVec);
+		}
+		else
+		{
+			vst1_f32(samples, vget_low_f32(outVec));
+		}
+	}
+
+	vst1q_f32(lp, lpVec);
+	vst1q_f32(bp, bpVec);
+	vst1q_f32(hp, hpVec);
+	vst1q_f32(notch, notchVec);
+	for (ci = 0; ci < lanes; ci += 1)
+	{
+		filterState[ci][FAudioLowPassFilter] = lp[ci];
+		filterState[ci][FAudioBandPassFilter] = bp[ci];
+		filterState[ci][FAudioHighPassFilter] = hp[ci];
+		filterState[ci][FAudioNotchFilter] = notch[ci];
+	}
+}
+
+void FAudio_INTERNAL_FilterVoice_NEON(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t numChannels
+) {
+	uint16_t ci = 0;
+
+	/* Same layout split as the SSE2 version */
+	switch (numChannels)
+	{
+	case 1:
+		FAudio_INTERNAL_FilterChannels(filter, filterState, samples, numSamples, 1, 0);
+		break;
+	case 2:
+		FAudio_INTERNAL_FilterLanes_NEON(filter, filterState, samples, numSamples, 2, 2);
+		break;
+	case 6:
+		FAudio_INTERNAL_FilterLanes_NEON(filter, filterState, samples, numSamples, 6, 4);
+		FAudio_INTERNAL_FilterLanes_NEON(filter, filterState + 4, samples + 4, numSamples, 6, 2);
+		break;
+	case 8:
+		FAudio_INTERNAL_FilterLanes_NEON(filter, filterState, samples, numSamples, 8, 4);
+		FAudio_INTERNAL_FilterLanes_NEON(filter, filterState + 4, samples + 4, numSamples, 8, 4);
+		break;
+	default:
+		for (; (ci + 4) <= numChannels; ci += 4)
+		{
+			FAudio_INTERNAL_FilterLanes_NEON(filter, filterState + ci, samples + ci, numSamples, numChannels, 4);
+		}
+		if ((ci + 2) <= numChannels)
+		{
+			FAudio_INTERNAL_FilterLanes_NEON(filter, filterState + ci, samples + ci, numSamples, numChannels, 2);
+			ci += 2;
+		}
+		if (ci < numChannels)
+		{
+			FAudio_INTERNAL_FilterChannels(filter, filterState, samples, numSamples, numChannels, ci);
+		}
+		break;
+	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* SECTION 5: Mixer Functions */
+
+/* Every mixer takes the send's effective matrix, which already has the base
+ * volume and channel volumes folded into the output matrix. It is laid out
+ * per input channel, matrix[ci * MIX_MATRIX_STRIDE(dstChans) + co], so a run
+ * of outputs can be loaded as a vector. The padding at the end of each row is
+ * zero.
+ *
+ * All the mixers add the inputs into each output in channel order, the same
+ * way the scalar loop below does, so every tier is bit-exact with the scalar
+ * mixers.
+ */
+
+static inline void FAudio_INTERNAL_MixFrames_Scalar(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i, co, ci;
+	const uint32_t stride = MIX_MATRIX_STRIDE(dstChans);
+	for (i = 0; i < toMix; i += 1, src += srcChans, dst += dstChans)
+	for (co = 0; co < dstChans; co += 1)
+	{
+		for (ci = 0; ci < srcChans; ci += 1)
+		{
+			dst[co] += src[ci] * matrix[ci * stride + co];
+		}
+	}
+}
+
+void FAudio_INTERNAL_Mix_Generic_Scalar(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	FAudio_INTERNAL_MixFrames_Scalar(
+		toMix,
+		srcChans,
+		dstChans,
+		src,
+		dst,
+		matrix
+	);
+}
+
+void FAudio_INTERNAL_Mix_1in_1out_Scalar(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const float weight = matrix[0];
+	for (i = 0; i < toMix; i += 1)
+	{
+		dst[i] += src[i] * weight;
+	}
+}
+
+/* The remaining layouts share the generic loop, but with constant channel
+ * counts so the compiler can unroll it.
+ */
+
+#define MIX_FRAMES_TARGET_Scalar
+#define MIX_FRAMES_TARGET_SSE2
+#define MIX_FRAMES_TARGET_NEON
+#define MIX_FRAMES_TARGET_AVX2 FAUDIO_TARGET_AVX2
+#define MIX_FRAMES_FUNC(isa, in, out) \
+	MIX_FRAMES_TARGET_##isa \
+	void FAudio_INTERNAL_Mix_##in##in_##out##out_##isa( \
+		uint32_t toMix, \
+		uint32_t UNUSED1, \
+		uint32_t UNUSED2, \
+		float *restrict src, \
+		float *restrict dst, \
+		const float *restrict matrix \
+	) { \
+		FAudio_INTERNAL_MixFrames_##isa( \
+			toMix, \
+			in, \
+			out, \
+			src, \
+			dst, \
+			matrix \
+		); \
+	}
+MIX_FRAMES_FUNC(Scalar, 1, 2)
+MIX_FRAMES_FUNC(Scalar, 1, 6)
+MIX_FRAMES_FUNC(Scalar, 1, 8)
+MIX_FRAMES_FUNC(Scalar, 2, 1)
+MIX_FRAMES_FUNC(Scalar, 2, 2)
+MIX_FRAMES_FUNC(Scalar, 2, 6)
+MIX_FRAMES_FUNC(Scalar, 2, 8)
+MIX_FRAMES_FUNC(Scalar, 6, 2)
+MIX_FRAMES_FUNC(Scalar, 6, 6)
+MIX_FRAMES_FUNC(Scalar, 8, 8)
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_Mix_1in_1out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const __m128 weight = _mm_set1_ps(matrix[0]);
+	for (i = 0; (i + 4) <= toMix; i += 4)
+	{
+		_mm_storeu_ps(dst + i, _mm_add_ps(
+			_mm_loadu_ps(dst + i),
+			_mm_mul_ps(_mm_loadu_ps(src + i), weight)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_1out_Scalar(
+		toMix - i,
+		1,
+		1,
+		src + i,
+		dst + i,
+		matrix
+	);
+}
+
+void FAudio_INTERNAL_Mix_1in_2out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const __m128 weights = _mm_setr_ps(
+		matrix[0],
+		matrix[1],
+		matrix[0],
+		matrix[1]
+	);
+	__m128 samples;
+
+	/* 4 frames at a time, each sample duplicated into a L/R pair */
+	for (i = 0; (i + 4) <= toMix; i += 4, src += 4, dst += 8)
+	{
+		samples = _mm_loadu_ps(src);
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_loadu_ps(dst),
+			_mm_mul_ps(_mm_unpacklo_ps(samples, samples), weights)
+		));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_loadu_ps(dst + 4),
+			_mm_mul_ps(_mm_unpackhi_ps(samples, samples), weights)
+		));
+	}
+	FAudio_INTERNAL_MixFrames_Scalar(toMix - i, 1, 2, src, dst, matrix);
+}
+
+void FAudio_INTERNAL_Mix_2in_1out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const __m128 weightL = _mm_set1_ps(matrix[0]);
+	const __m128 weightR = _mm_set1_ps(matrix[MIX_MATRIX_STRIDE(1)]);
+	__m128 a, b, acc;
+
+	/* 4 frames at a time, deinterleaved into L and R */
+	for (i = 0; (i + 4) <= toMix; i += 4, src += 8, dst += 4)
+	{
+		a = _mm_loadu_ps(src);
+		b = _mm_loadu_ps(src + 4);
+		acc = _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(
+			_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)),
+			weightL
+		));
+		acc = _mm_add_ps(acc, _mm_mul_ps(
+			_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)),
+			weightR
+		));
+		_mm_storeu_ps(dst, acc);
+	}
+	FAudio_INTERNAL_MixFrames_Scalar(toMix - i, 2, 1, src, dst, matrix);
+}
+
+void FAudio_INTERNAL_Mix_2in_2out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const __m128 weightsL = _mm_setr_ps(
+		matrix[0],
+		matrix[1],
+		matrix[0],
+		matrix[1]
+	);
+	const __m128 weightsR = _mm_setr_ps(
+		matrix[MIX_MATRIX_STRIDE(2)],
+		matrix[MIX_MATRIX_STRIDE(2) + 1],
+		matrix[MIX_MATRIX_STRIDE(2)],
+		matrix[MIX_MATRIX_STRIDE(2) + 1]
+	);
+	__m128 samples, acc;
+
+	/* 2 frames at a time, L and R each broadcast to both outputs */
+	for (i = 0; (i + 2) <= toMix; i += 2, src += 4, dst += 4)
+	{
+		samples = _mm_loadu_ps(src);
+		acc = _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(
+			_mm_shuffle_ps(samples, samples, _MM_SHUFFLE(2, 2, 0, 0)),
+			weightsL
+		));
+		acc = _mm_add_ps(acc, _mm_mul_ps(
+			_mm_shuffle_ps(samples, samples, _MM_SHUFFLE(3, 3, 1, 1)),
+			weightsR
+		));
+		_mm_storeu_ps(dst, acc);
+	}
+	FAudio_INTERNAL_MixFrames_Scalar(toMix - i, 2, 2, src, dst, matrix);
+}
+
+void FAudio_INTERNAL_Mix_6in_2out_SSE2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i, ci;
+	__m128 w[6], v0, v1, v2, acc;
+
+	for (ci = 0; ci < 6; ci += 1)
+	{
+		w[ci] = _mm_loadl_pi(
+			_mm_setzero_ps(),
+			(const __m64*) (matrix + ci * MIX_MATRIX_STRIDE(2))
+		);
+		w[ci] = _mm_movelh_ps(w[ci], w[ci]);
+	}
+
+	/* 2 frames at a time: 12 inputs in 3 vectors, 4 outputs in 1 */
+	for (i = 0; (i + 2) <= toMix; i += 2, src += 12, dst += 4)
+	{
+		v0 = _mm_loadu_ps(src);
+		v1 = _mm_loadu_ps(src + 4);
+		v2 = _mm_loadu_ps(src + 8);
+		acc = _mm_loadu_ps(dst);
+		#define MIX_CHANNEL(a, b, shuf, ci) \
+			acc = _mm_add_ps(acc, _mm_mul_ps( \
+				_mm_shuffle_ps(a, b, shuf), \
+				w[ci] \
+			));
+		MIX_CHANNEL(v0, v1, _MM_SHUFFLE(2, 2, 0, 0), 0)
+		MIX_CHANNEL(v0, v1, _MM_SHUFFLE(3, 3, 1, 1), 1)
+		MIX_CHANNEL(v0, v2, _MM_SHUFFLE(0, 0, 2, 2), 2)
+		MIX_CHANNEL(v0, v2, _MM_SHUFFLE(1, 1, 3, 3), 3)
+		MIX_CHANNEL(v1, v2, _MM_SHUFFLE(2, 2, 0, 0), 4)
+		MIX_CHANNEL(v1, v2, _MM_SHUFFLE(3, 3, 1, 1), 5)
+		#undef MIX_CHANNEL
+		_mm_storeu_ps(dst, acc);
+	}
+	FAudio_INTERNAL_MixFrames_Scalar(toMix - i, 6, 2, src, dst, matrix);
+}
+
+static inline void FAudio_INTERNAL_MixFrames_SSE2(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i, co, ci;
+	const uint32_t stride = MIX_MATRIX_STRIDE(dstChans);
+	__m128 acc;
+
+	/* One frame at a time, each input broadcast against a run of outputs */
+	for (i = 0; i < toMix; i += 1, src += srcChans, dst += dstChans)
+	{
+		for (co = 0; (co + 4) <= dstChans; co += 4)
+		{
+			acc = _mm_loadu_ps(dst + co);
+			for (ci = 0; ci < srcChans; ci += 1)
+			{
+				acc = _mm_add_ps(acc, _mm_mul_ps(
+					_mm_set1_ps(src[ci]),
+					_mm_loadu_ps(matrix + ci * stride + co)
+				));
+			}
+			_mm_storeu_ps(dst + co, acc);
+		}
+		if ((co + 2) <= dstChans)
+		{
+			acc = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*) (dst + co));
+			for (ci = 0; ci < srcChans; ci += 1)
+			{
+				acc = _mm_add_ps(acc, _mm_mul_ps(
+					_mm_set1_ps(src[ci]),
+					_mm_loadu_ps(matrix + ci * stride + co)
+				));
+			}
+			_mm_storel_pi((__m64*) (dst + co), acc);
+			co += 2;
+		}
+		if (co < dstChans)
+		{
+			acc = _mm_load_ss(dst + co);
+			for (ci = 0; ci < srcChans; ci += 1)
+			{
+				acc = _mm_add_ss(acc, _mm_mul_ss(
+					_mm_load_ss(src + ci),
+					_mm_load_ss(matrix + ci * stride + co)
+				));
+			}
+			_mm_store_ss(dst + co, acc);
+		}
+	}
+}
+
+void FAudio_INTERNAL_Mix_Generic_SSE2(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	FAudio_INTERNAL_MixFrames_SSE2(
+		toMix,
+		srcChans,
+		dstChans,
+		src,
+		dst,
+		matrix
+	);
+}
+
+MIX_FRAMES_FUNC(SSE2, 1, 6)
+MIX_FRAMES_FUNC(SSE2, 1, 8)
+MIX_FRAMES_FUNC(SSE2, 2, 6)
+MIX_FRAMES_FUNC(SSE2, 2, 8)
+MIX_FRAMES_FUNC(SSE2, 6, 6)
+MIX_FRAMES_FUNC(SSE2, 8, 8)
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+/* Only the layouts that fill 8 lanes get AVX2 versions, the AVX2 tier uses
+ * the SSE2 mixers for everything else.
+ */
+
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_Mix_1in_1out_AVX2(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const __m256 weight = _mm256_set1_ps(matrix[0]);
+	for (i = 0; (i + 8) <= toMix; i += 8)
+	{
+		_mm256_storeu_ps(dst + i, _mm256_add_ps(
+			_mm256_loadu_ps(dst + i),
+			_mm256_mul_ps(_mm256_loadu_ps(src + i), weight)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_1out_Scalar(
+		toMix - i,
+		1,
+		1,
+		src + i,
+		dst + i,
+		matrix
+	);
+}
+
+FAUDIO_TARGET_AVX2
+static inline void FAudio_INTERNAL_MixFrames_AVX2(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i, ci;
+	__m256 acc;
+
+	FAudio_assert(dstChans == 8);
+	for (i = 0; i < toMix; i += 1, src += srcChans, dst += 8)
+	{
+		acc = _mm256_loadu_ps(dst);
+		for (ci = 0; ci < srcChans; ci += 1)
+		{
+			acc = _mm256_add_ps(acc, _mm256_mul_ps(
+				_mm256_set1_ps(src[ci]),
+				_mm256_loadu_ps(matrix + ci * 8)
+			));
+		}
+		_mm256_storeu_ps(dst, acc);
+	}
+}
+
+MIX_FRAMES_FUNC(AVX2, 1, 8)
+MIX_FRAMES_FUNC(AVX2, 2, 8)
+MIX_FRAMES_FUNC(AVX2, 8, 8)
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+/* No vmlaq in the mixers either, so results match the SSE2 path */
+
+void FAudio_INTERNAL_Mix_1in_1out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const float32x4_t weight = vdupq_n_f32(matrix[0]);
+	for (i = 0; (i + 4) <= toMix; i += 4)
+	{
+		vst1q_f32(dst + i, vaddq_f32(
+			vld1q_f32(dst + i),
+			vmulq_f32(vld1q_f32(src + i), weight)
+		));
+	}
+	FAudio_INTERNAL_Mix_1in_1out_Scalar(
+		toMix - i,
+		1,
+		1,
+		src + i,
+		dst + i,
+		matrix
+	);
+}
+
+void FAudio_INTERNAL_Mix_1in_2out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const float32x2_t weightsPair = vld1_f32(matrix);
+	const float32x4_t weights = vcombine_f32(weightsPair, weightsPair);
+	float32x4x2_t samples;
+
+	for (i = 0; (i + 4) <= toMix; i += 4, src += 4, dst += 8)
+	{
+		samples.val[0] = vld1q_f32(src);
+		samples = vzipq_f32(samples.val[0], samples.val[0]);
+		vst1q_f32(dst, vaddq_f32(
+			vld1q_f32(dst),
+			vmulq_f32(samples.val[0], weights)
+		));
+		vst1q_f32(dst + 4, vaddq_f32(
+			vld1q_f32(dst + 4),
+			vmulq_f32(samples.val[1], weights)
+		));
+	}
+	FAudio_INTERNAL_MixFrames_Scalar(toMix - i, 1, 2, src, dst, matrix);
+}
+
+void FAudio_INTERNAL_Mix_2in_1out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const float32x4_t weightL = vdupq_n_f32(matrix[0]);
+	const float32x4_t weightR = vdupq_n_f32(matrix[MIX_MATRIX_STRIDE(1)]);
+	float32x4x2_t samples;
+	float32x4_t acc;
+
+	for (i = 0; (i + 4) <= toMix; i += 4, src += 8, dst += 4)
+	{
+		samples = vld2q_f32(src);
+		acc = vaddq_f32(vld1q_f32(dst), vmulq_f32(samples.val[0], weightL));
+		acc = vaddq_f32(acc, vmulq_f32(samples.val[1], weightR));
+		vst1q_f32(dst, acc);
+	}
+	FAudio_INTERNAL_MixFrames_Scalar(toMix - i, 2, 1, src, dst, matrix);
+}
+
+void FAudio_INTERNAL_Mix_2in_2out_NEON(
+	uint32_t toMix,
+	uint32_t UNUSED1,
+	uint32_t UNUSED2,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i;
+	const float32x2_t pairL = vld1_f32(matrix);
+	const float32x2_t pairR = vld1_f32(matrix + MIX_MATRIX_STRIDE(2));
+	const float32x4_t weightsL = vcombine_f32(pairL, pairL);
+	const float32x4_t weightsR = vcombine_f32(pairR, pairR);
+	float32x4_t samples, acc;
+	float32x4x2_t split;
+
+	for (i = 0; (i + 2) <= toMix; i += 2, src += 4, dst += 4)
+	{
+		samples = vld1q_f32(src);
+		split = vtrnq_f32(samples, samples);
+		acc = vaddq_f32(vld1q_f32(dst), vmulq_f32(split.val[0], weightsL));
+		acc = vaddq_f32(acc, vmulq_f32(split.val[1], weightsR));
+		vst1q_f32(dst, acc);
+	}
+	FAudio_INTERNAL_MixFrames_Scalar(toMix - i, 2, 2, src, dst, matrix);
+}
+
+static inline void FAudio_INTERNAL_MixFrames_NEON(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i, co, ci;
+	const uint32_t stride = MIX_MATRIX_STRIDE(dstChans);
+	float32x4_t acc;
+	float32x2_t acc2;
+
+	for (i = 0; i < toMix; i += 1, src += srcChans, dst += dstChans)
+	{
+		for (co = 0; (co + 4) <= dstChans; co += 4)
+		{
+			acc = vld1q_f32(dst + co);
+			for (ci = 0; ci < srcChans; ci += 1)
+			{
+				acc = vaddq_f32(acc, vmulq_f32(
+					vdupq_n_f32(src[ci]),
+					vld1q_f32(matrix + ci * stride + co)
+				));
+			}
+			vst1q_f32(dst + co, acc);
+		}
+		if ((co + 2) <= dstChans)
+		{
+			acc2 = vld1_f32(dst + co);
+			for (ci = 0; ci < srcChans; ci += 1)
+			{
+				acc2 = vadd_f32(acc2, vmul_f32(
+					vdup_n_f32(src[ci]),
+					vld1_f32(matrix + ci * stride + co)
+				));
+			}
+			vst1_f32(dst + co, acc2);
+			co += 2;
+		}
+		if (co < dstChans)
+		{
+			for (ci = 0; ci < srcChans; ci += 1)
+			{
+				dst[co] += src[ci] * matrix[ci * stride + co];
+			}
+		}
+	}
+}
+
+void FAudio_INTERNAL_Mix_Generic_NEON(
+	uint32_t toMix,
+	uint32_t srcChans,
+	uint32_t dstChans,
+	float *restrict src,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	FAudio_INTERNAL_MixFrames_NEON(
+		toMix,
+		srcChans,
+		dstChans,
+		src,
+		dst,
+		matrix
+	);
+}
+
+MIX_FRAMES_FUNC(NEON, 1, 6)
+MIX_FRAMES_FUNC(NEON, 1, 8)
+MIX_FRAMES_FUNC(NEON, 2, 6)
+MIX_FRAMES_FUNC(NEON, 2, 8)
+MIX_FRAMES_FUNC(NEON, 6, 2)
+MIX_FRAMES_FUNC(NEON, 6, 6)
+MIX_FRAMES_FUNC(NEON, 8, 8)
+#endif /* HAVE_NEON_INTRINSICS */
+
+#undef MIX_FRAMES_FUNC
+
+/* Mono sources with no effect chain or filter can be resampled straight into
+ * their send, skipping the resample cache entirely. The interpolation matches
+ * the mono resamplers, the accumulation matches the mixers above.
+ */
+
+void FAudio_INTERNAL_ResampleMixMono_Scalar(
+	float *restrict dCache,
+	uint64_t resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint32_t dstChans,
+	float *restrict dst,
+	const float *restrict matrix
 ) {
-	uint32_t i, header, tail;
-	uint64_t cur_scalar_1, cur_scalar_2, cur_scalar_3;
-	float *dCache_1, *dCache_2, *dCache_3;
-	uint64_t cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
-	float32x4_t one_over_fixed_one, half, current_next_0_1, current_next_2_3,
-		current, next, sub, cur_fixed, mul, res;
-	int32x4_t cur_frac, adder_frac, adder_frac_loop;
-
-	/* This is the header, the Dest needs to be aligned to 16B */
-	header = (16 - ((size_t) resampleCache) % 16) / 4;
-	if (header == 4)
-	{
-		header = 0;
-	}
-	for (i = 0; i < header; i += 1)
+	uint32_t i, co;
+	float sample;
+	uint64_t cur = resampleOffset & FIXED_FRACTION_MASK;
+	for (i = 0; i < toResample; i += 1, dst += dstChans)
 	{
 		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
+		sample = (float) (
 			dCache[0] +
 			(dCache[1] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
+			FIXED_TO_DOUBLE(cur)
 		);
 
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
-
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur_scalar >> FIXED_PRECISION);
+		/* ... then straight into the output */
+		for (co = 0; co < dstChans; co += 1)
+		{
+			dst[co] += sample * matrix[co];
+		}
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
+		/* Same stepping as the resamplers */
+		cur += resampleStep;
+		dCache += (cur >> FIXED_PRECISION);
+		cur &= FIXED_FRACTION_MASK;
 	}
+}
 
-	toResample -= header;
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_ResampleMixMono_SSE2(
+	float *restrict dCache,
+	uint64_t resampleOffset,
+	uint64_t resampleStep,
+	uint64_t toResample,
+	uint32_t dstChans,
+	float *restrict dst,
+	const float *restrict matrix
+) {
+	uint32_t i, tail;
+	uint64_t cur_scalar_1, cur_scalar_2, cur_scalar_3;
+	float *dCache_1, *dCache_2, *dCache_3;
+	uint64_t cur_scalar = resampleOffset & FIXED_FRACTION_MASK;
+	__m128 one_over_fixed_one, half, current_next_0_1, current_next_2_3,
+		current, next, sub, cur_fixed, mul, res, weights;
+	__m128i cur_frac, adder_frac, adder_frac_loop;
+	float frames[4];
 
-	/* initialising the varius cur
-	 * cur_frac is the fractional part of cur with 4 samples. as the
-	 * fractional part is 32 bit unsigned value, it can be just added
-	 * and the modulu operation for keeping the fractional part will be implicit.
-	 * the 0.5 is for converting signed values to float (no unsigned convert),
-	 * the 0.5 is added later.
-	 */
-	cur_frac = vdupq_n_s32(
+	/* See FAudio_INTERNAL_ResampleMono_SSE2 for how the offsets work */
+	cur_frac = _mm_set1_epi32(
 		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
 	);
-	int32_t __attribute__((aligned(16))) data[4] =
-	{
+	adder_frac = _mm_setr_epi32(
 		0,
 		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
 		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK),
 		(uint32_t) ((resampleStep * 3) & FIXED_FRACTION_MASK)
-	};
-	adder_frac = vld1q_s32(data);
-	cur_frac = vaddq_s32(cur_frac, adder_frac);
+	);
+	cur_frac = _mm_add_epi32(cur_frac, adder_frac);
 
-	/* The various cur_scalar is for the different samples
-	 * (1, 2, 3 compared to original cur_scalar = 0)
-	 */
 	cur_scalar_1 = cur_scalar + resampleStep;
 	cur_scalar_2 = cur_scalar + resampleStep * 2;
 	cur_scalar_3 = cur_scalar + resampleStep * 3;
@@ -840,48 +4839,69 @@ void FAudio_INTERNAL_ResampleMono_NEON(
 	cur_scalar_3 &= FIXED_FRACTION_MASK;
 
 	/* Constants */
-	one_over_fixed_one = vdupq_n_f32(1.0f / FIXED_ONE);
-	half = vdupq_n_f32(0.5f);
-	adder_frac_loop = vdupq_n_s32(
+	one_over_fixed_one = _mm_set1_ps(1.0f / FIXED_ONE);
+	half = _mm_set1_ps(0.5f);
+	adder_frac_loop = _mm_set1_epi32(
 		(uint32_t) ((resampleStep * 4) & FIXED_FRACTION_MASK)
 	);
+	weights = (dstChans == 1) ?
+		_mm_set1_ps(matrix[0]) :
+		_mm_setr_ps(matrix[0], matrix[1], matrix[0], matrix[1]);
 
 	tail = toResample % 4;
-	for (i = 0; i < toResample - tail; i += 4, resampleCache += 4)
+	for (i = 0; i < toResample - tail; i += 4)
 	{
-		/* current next holds 2 pairs of the sample and the sample + 1
-		 * after that need to separate them.
-		 */
-		current_next_0_1 = vcombine_f32(
-			vld1_f32(dCache),
-			vld1_f32(dCache_1)
-		);
-		current_next_2_3 = vcombine_f32(
-			vld1_f32(dCache_2),
-			vld1_f32(dCache_3)
-		);
-
-		/* Unpack them to have seperate current and next in 2 vectors. */
-		current = vuzp1q_f32(current_next_0_1, current_next_2_3);
-		next = vuzp2q_f32(current_next_0_1, current_next_2_3);
-
-		sub = vsubq_f32(next, current);
-
-		/* Convert the fractional part to float and then mul to get the fractions out.
-		 * then add back the 0.5 we subtracted before.
-		 */
-		cur_fixed = vaddq_f32(
-			vmulq_f32(
-				vcvtq_f32_s32(cur_frac),
+		current_next_0_1 = _mm_loadl_pi(_mm_setzero_ps(), (__m64*) dCache);
+		current_next_0_1 = _mm_loadh_pi(current_next_0_1, (__m64*) dCache_1);
+		current_next_2_3 = _mm_loadl_pi(_mm_setzero_ps(), (__m64*) dCache_2);
+		current_next_2_3 = _mm_loadh_pi(current_next_2_3, (__m64*) dCache_3);
+		current = _mm_shuffle_ps(current_next_0_1, current_next_2_3, 0x88);
+		next = _mm_shuffle_ps(current_next_0_1, current_next_2_3, 0xdd);
+		sub = _mm_sub_ps(next, current);
+		cur_fixed = _mm_add_ps(
+			_mm_mul_ps(
+				_mm_cvtepi32_ps(cur_frac),
 				one_over_fixed_one
 			),
 			half
 		);
-		mul = vmulq_f32(sub, cur_fixed);
-		res = vaddq_f32(current, mul);
+		mul = _mm_mul_ps(sub, cur_fixed);
+		res = _mm_add_ps(current, mul);
 
-		/* Store back */
-		vst1q_f32(resampleCache, res);
+		/* 4 resampled frames, mixed while they're still in a register */
+		if (dstChans == 1)
+		{
+			_mm_storeu_ps(dst, _mm_add_ps(
+				_mm_loadu_ps(dst),
+				_mm_mul_ps(res, weights)
+			));
+			dst += 4;
+		}
+		else if (dstChans == 2)
+		{
+			_mm_storeu_ps(dst, _mm_add_ps(
+				_mm_loadu_ps(dst),
+				_mm_mul_ps(_mm_unpacklo_ps(res, res), weights)
+			));
+			_mm_storeu_ps(dst + 4, _mm_add_ps(
+				_mm_loadu_ps(dst + 4),
+				_mm_mul_ps(_mm_unpackhi_ps(res, res), weights)
+			));
+			dst += 8;
+		}
+		else
+		{
+			_mm_storeu_ps(frames, res);
+			FAudio_INTERNAL_MixFrames_SSE2(
+				4,
+				1,
+				dstChans,
+				frames,
+				dst,
+				matrix
+			);
+			dst += dstChans * 4;
+		}
 
 		/* Update dCaches for next iteration */
 		cur_scalar += resampleStep * 4;
@@ -897,143 +4917,90 @@ void FAudio_INTERNAL_ResampleMono_NEON(
 		cur_scalar_2 &= FIXED_FRACTION_MASK;
 		cur_scalar_3 &= FIXED_FRACTION_MASK;
 
-		cur_frac = vaddq_s32(cur_frac, adder_frac_loop);
+		cur_frac = _mm_add_epi32(cur_frac, adder_frac_loop);
 	}
-	*resampleOffset += resampleStep * (toResample - tail);
-
-	/* This is the tail. */
-	for (i = 0; i < tail; i += 1)
-	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[1] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
-		);
-
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
-
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur_scalar >> FIXED_PRECISION);
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
-	}
+	FAudio_INTERNAL_ResampleMixMono_Scalar(
+		dCache,
+		cur_scalar,
+		resampleStep,
+		tail,
+		dstChans,
+		dst,
+		matrix
+	);
 }
+#endif /* HAVE_SSE2_INTRINSICS */
 
-void FAudio_INTERNAL_ResampleStereo_NEON(
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_ResampleMixMono_NEON(
 	float *restrict dCache,
-	float *restrict resampleCache,
-	uint64_t *resampleOffset,
+	uint64_t resampleOffset,
 	uint64_t resampleStep,
 	uint64_t toResample,
-	uint8_t channels
+	uint32_t dstChans,
+	float *restrict dst,
+	const float *restrict matrix
 ) {
-	uint32_t i, header, tail;
-	uint64_t cur_scalar, cur_scalar_1;
-	float *dCache_1;
-	float32x4_t one_over_fixed_one, half, current, next, sub, cur_fixed, mul, res;
+	uint32_t i, tail;
+	uint64_t cur_scalar_1, cur_scalar_2, cur_scalar_3;
+	float *dCache_1, *dCache_2, *dCache_3;
+	uint64_t cur_scalar = resampleOffset & FIXED_FRACTION_MASK;
+	float32x4_t one_over_fixed_one, half, current_next_0_1, current_next_2_3,
+		current, next, sub, cur_fixed, mul, res, weights;
+	float32x4x2_t pairs;
 	int32x4_t cur_frac, adder_frac, adder_frac_loop;
+	float frames[4];
 
-	/* This is the header, the Dest needs to be aligned to 16B */
-	header = (16 - ((size_t) resampleCache) % 16) / 8;
-	if (header == 2)
-	{
-		header = 0;
-	}
-	cur_scalar = *resampleOffset & FIXED_FRACTION_MASK;
-	for (i = 0; i < header; i += 2)
-	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[2] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
-		);
-		*resampleCache++ = (float) (
-			dCache[1] +
-			(dCache[3] - dCache[1]) *
-			FIXED_TO_FLOAT(cur_scalar)
-		);
-
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
-
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
-
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
-	}
-
-	toResample -= header;
-
-	/* initialising the varius cur.
-	 * cur_frac holds the fractional part of cur.
-	 * to avoid duplication please see the mono part for a thorough
-	 * explanation.
-	 */
+	/* See FAudio_INTERNAL_ResampleMono_NEON for how the offsets work */
 	cur_frac = vdupq_n_s32(
 		(uint32_t) (cur_scalar & FIXED_FRACTION_MASK) - DOUBLE_TO_FIXED(0.5)
 	);
 	int32_t __attribute__((aligned(16))) data[4] =
 	{
-		0,
 		0,
 		(uint32_t) (resampleStep & FIXED_FRACTION_MASK),
-		(uint32_t) (resampleStep & FIXED_FRACTION_MASK)
+		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK),
+		(uint32_t) ((resampleStep * 3) & FIXED_FRACTION_MASK)
 	};
 	adder_frac = vld1q_s32(data);
 	cur_frac = vaddq_s32(cur_frac, adder_frac);
 
-	/* dCache_1 is the pointer for dcache in the next resample pos. */
 	cur_scalar_1 = cur_scalar + resampleStep;
-	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION) * 2;
+	cur_scalar_2 = cur_scalar + resampleStep * 2;
+	cur_scalar_3 = cur_scalar + resampleStep * 3;
+	dCache_1 = dCache + (cur_scalar_1 >> FIXED_PRECISION);
+	dCache_2 = dCache + (cur_scalar_2 >> FIXED_PRECISION);
+	dCache_3 = dCache + (cur_scalar_3 >> FIXED_PRECISION);
+	cur_scalar &= FIXED_FRACTION_MASK;
 	cur_scalar_1 &= FIXED_FRACTION_MASK;
+	cur_scalar_2 &= FIXED_FRACTION_MASK;
+	cur_scalar_3 &= FIXED_FRACTION_MASK;
 
+	/* Constants */
 	one_over_fixed_one = vdupq_n_f32(1.0f / FIXED_ONE);
 	half = vdupq_n_f32(0.5f);
 	adder_frac_loop = vdupq_n_s32(
-		(uint32_t) ((resampleStep * 2) & FIXED_FRACTION_MASK)
+		(uint32_t) ((resampleStep * 4) & FIXED_FRACTION_MASK)
 	);
+	weights = (dstChans == 1) ?
+		vdupq_n_f32(matrix[0]) :
+		vcombine_f32(vld1_f32(matrix), vld1_f32(matrix));
 
-	tail = toResample % 2;
-	for (i = 0; i < toResample - tail; i += 2, resampleCache += 4)
+	tail = toResample % 4;
+	for (i = 0; i < toResample - tail; i += 4)
 	{
-		/* Current_next_1 and current_next_2 each holds 4 src
-		 * sample points for getting 4 dest resample point at the end.
-		 * current_next_1 holds:
-		 * (current_ch_1, current_ch_2, next_ch_1, next_ch_2)
-		 * for the first resample position, while current_next_2 holds
-		 * the same for the 2nd resample position
-		 */
-		current = vcombine_f32(
-			vld1_f32(dCache), /* A1B1 */
-			vld1_f32(dCache_1) /* A3B3 */
+		current_next_0_1 = vcombine_f32(
+			vld1_f32(dCache),
+			vld1_f32(dCache_1)
 		);
-		next = vcombine_f32(
-			vld1_f32(dCache + 2), /* A2B2 */
-			vld1_f32(dCache_1 + 2) /* A4B4 */
+		current_next_2_3 = vcombine_f32(
+			vld1_f32(dCache_2),
+			vld1_f32(dCache_3)
 		);
-
+		current = vuzp1q_f32(current_next_0_1, current_next_2_3);
+		next = vuzp2q_f32(current_next_0_1, current_next_2_3);
 		sub = vsubq_f32(next, current);
-
-		/* Adding the 0.5 back.
-		 * See mono explanation for more elaborate explanation.
-		 */
 		cur_fixed = vaddq_f32(
 			vmulq_f32(
 				vcvtq_f32_s32(cur_frac),
@@ -1044,489 +5011,1330 @@ void FAudio_INTERNAL_ResampleStereo_NEON(
 		mul = vmulq_f32(sub, cur_fixed);
 		res = vaddq_f32(current, mul);
 
-		/* Store the results */
-		vst1q_f32(resampleCache, res);
+		/* 4 resampled frames, mixed while they're still in a register */
+		if (dstChans == 1)
+		{
+			vst1q_f32(dst, vaddq_f32(
+				vld1q_f32(dst),
+				vmulq_f32(res, weights)
+			));
+			dst += 4;
+		}
+		else if (dstChans == 2)
+		{
+			pairs = vzipq_f32(res, res);
+			vst1q_f32(dst, vaddq_f32(
+				vld1q_f32(dst),
+				vmulq_f32(pairs.val[0], weights)
+			));
+			vst1q_f32(dst + 4, vaddq_f32(
+				vld1q_f32(dst + 4),
+				vmulq_f32(pairs.val[1], weights)
+			));
+			dst += 8;
+		}
+		else
+		{
+			vst1q_f32(frames, res);
+			FAudio_INTERNAL_MixFrames_NEON(
+				4,
+				1,
+				dstChans,
+				frames,
+				dst,
+				matrix
+			);
+			dst += dstChans * 4;
+		}
 
 		/* Update dCaches for next iteration */
-		cur_scalar += resampleStep * 2;
-		cur_scalar_1 += resampleStep * 2;
-		dCache = dCache + (cur_scalar >> FIXED_PRECISION) * 2;
-		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION) * 2;
+		cur_scalar += resampleStep * 4;
+		cur_scalar_1 += resampleStep * 4;
+		cur_scalar_2 += resampleStep * 4;
+		cur_scalar_3 += resampleStep * 4;
+		dCache = dCache + (cur_scalar >> FIXED_PRECISION);
+		dCache_1 = dCache_1 + (cur_scalar_1 >> FIXED_PRECISION);
+		dCache_2 = dCache_2 + (cur_scalar_2 >> FIXED_PRECISION);
+		dCache_3 = dCache_3 + (cur_scalar_3 >> FIXED_PRECISION);
 		cur_scalar &= FIXED_FRACTION_MASK;
 		cur_scalar_1 &= FIXED_FRACTION_MASK;
+		cur_scalar_2 &= FIXED_FRACTION_MASK;
+		cur_scalar_3 &= FIXED_FRACTION_MASK;
 
 		cur_frac = vaddq_s32(cur_frac, adder_frac_loop);
 	}
-	*resampleOffset += resampleStep * (toResample - tail);
 
-	/* This is the tail. */
-	for (i = 0; i < tail; i += 1)
+	FAudio_INTERNAL_ResampleMixMono_Scalar(
+		dCache,
+		cur_scalar,
+		resampleStep,
+		tail,
+		dstChans,
+		dst,
+		matrix
+	);
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* SECTION 6: Effect Filters */
+
+/* Every comb reads its delay line at its own offset, so the reads are done one
+ * at a time, and summed into the mean in comb order while we're at it. The
+ * shelving filters and the feedback then run in lanes, doing the same float
+ * ops in the same order as the scalar version, so all versions match exactly.
+ * The shelves are first order: a2 and b2 are always 0, so the second delay
+ * element is too.
+ */
+
+#define COMB_BANK_GAIN (1.0f / FAUDIO_COMB_BANK_SIZE)
+
+static inline float FAudio_INTERNAL_ReadCombBank(
+	const FAudioCombBank *bank,
+	uint32_t *restrict read,
+	float *restrict delayed
+) {
+	uint32_t k;
+	float sum = 0.0f;
+	for (k = 0; k < FAUDIO_COMB_BANK_SIZE; k += 1)
 	{
-		/* lerp, then convert to float value */
-		*resampleCache++ = (float) (
-			dCache[0] +
-			(dCache[2] - dCache[0]) *
-			FIXED_TO_FLOAT(cur_scalar)
+		delayed[k] = bank->buffer[(read[k] * FAUDIO_COMB_BANK_SIZE) + k];
+		sum += COMB_BANK_GAIN * delayed[k];
+		read[k] += 1;
+		if (read[k] == bank->capacity)
+		{
+			read[k] = 0;
+		}
+	}
+	return sum;
+}
+
+static inline float *FAudio_INTERNAL_NextCombBankRow(FAudioCombBank *bank)
+{
+	float *row = bank->buffer + (bank->write_idx * FAUDIO_COMB_BANK_SIZE);
+	bank->write_idx += 1;
+	if (bank->write_idx == bank->capacity)
+	{
+		bank->write_idx = 0;
+	}
+	return row;
+}
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_ProcessCombBank_Scalar(
+	FAudioCombBank *bank,
+	const float *restrict input,
+	float *restrict output,
+	uint32_t len
+) {
+	uint32_t i, k;
+	uint32_t read[FAUDIO_COMB_BANK_SIZE];
+	float delayed[FAUDIO_COMB_BANK_SIZE];
+	float x, y, *row;
+	FAudioCombShelf *high = &bank->high_shelving;
+	FAudioCombShelf *low = &bank->low_shelving;
+
+	FAudio_memcpy(read, bank->read_idx, sizeof(read));
+	for (i = 0; i < len; i += 1)
+	{
+		output[i] = FAudio_INTERNAL_ReadCombBank(bank, read, delayed);
+		row = FAudio_INTERNAL_NextCombBankRow(bank);
+		for (k = 0; k < FAUDIO_COMB_BANK_SIZE; k += 1)
+		{
+			x = delayed[k];
+			y = (high->a0[k] * x) + high->delay[k];
+			high->delay[k] = (high->a1[k] * x) - (high->b1[k] * y);
+			x = (y * high->c0[k]) + (x * high->d0[k]);
+			y = (low->a0[k] * x) + low->delay[k];
+			low->delay[k] = (low->a1[k] * x) - (low->b1[k] * y);
+			x = (y * low->c0[k]) + (x * low->d0[k]);
+			row[k] = input[i] + (bank->feedback[k] * x);
+		}
+	}
+	FAudio_memcpy(bank->read_idx, read, sizeof(read));
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
+
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_ProcessCombBank_SSE2(
+	FAudioCombBank *bank,
+	const float *restrict input,
+	float *restrict output,
+	uint32_t len
+) {
+	uint32_t i, h;
+	uint32_t read[FAUDIO_COMB_BANK_SIZE];
+	float delayed[FAUDIO_COMB_BANK_SIZE];
+	float *row;
+	__m128 in, x[2], y[2];
+	__m128 ha0[2], ha1[2], hb1[2], hc0[2], hd0[2], hz[2];
+	__m128 la0[2], la1[2], lb1[2], lc0[2], ld0[2], lz[2];
+	__m128 feedback[2];
+	FAudioCombShelf *high = &bank->high_shelving;
+	FAudioCombShelf *low = &bank->low_shelving;
+
+	/* Two halves of 4 combs, everything stays in registers for the block */
+	for (h = 0; h < 2; h += 1)
+	{
+		ha0[h] = _mm_loadu_ps(high->a0 + (h * 4));
+		ha1[h] = _mm_loadu_ps(high->a1 + (h * 4));
+		hb1[h] = _mm_loadu_ps(high->b1 + (h * 4));
+		hc0[h] = _mm_loadu_ps(high->c0 + (h * 4));
+		hd0[h] = _mm_loadu_ps(high->d0 + (h * 4));
+		hz[h] = _mm_loadu_ps(high->delay + (h * 4));
+		la0[h] = _mm_loadu_ps(low->a0 + (h * 4));
+		la1[h] = _mm_loadu_ps(low->a1 + (h * 4));
+		lb1[h] = _mm_loadu_ps(low->b1 + (h * 4));
+		lc0[h] = _mm_loadu_ps(low->c0 + (h * 4));
+		ld0[h] = _mm_loadu_ps(low->d0 + (h * 4));
+		lz[h] = _mm_loadu_ps(low->delay + (h * 4));
+		feedback[h] = _mm_loadu_ps(bank->feedback + (h * 4));
+	}
+
+	FAudio_memcpy(read, bank->read_idx, sizeof(read));
+	for (i = 0; i < len; i += 1)
+	{
+		output[i] = FAudio_INTERNAL_ReadCombBank(bank, read, delayed);
+		row = FAudio_INTERNAL_NextCombBankRow(bank);
+		in = _mm_set1_ps(input[i]);
+		x[0] = _mm_setr_ps(delayed[0], delayed[1], delayed[2], delayed[3]);
+		x[1] = _mm_setr_ps(delayed[4], delayed[5], delayed[6], delayed[7]);
+		for (h = 0; h < 2; h += 1)
+		{
+			y[h] = _mm_add_ps(_mm_mul_ps(ha0[h], x[h]), hz[h]);
+			hz[h] = _mm_sub_ps(
+				_mm_mul_ps(ha1[h], x[h]),
+				_mm_mul_ps(hb1[h], y[h])
+			);
+			x[h] = _mm_add_ps(
+				_mm_mul_ps(y[h], hc0[h]),
+				_mm_mul_ps(x[h], hd0[h])
+			);
+			y[h] = _mm_add_ps(_mm_mul_ps(la0[h], x[h]), lz[h]);
+			lz[h] = _mm_sub_ps(
+				_mm_mul_ps(la1[h], x[h]),
+				_mm_mul_ps(lb1[h], y[h])
+			);
+			x[h] = _mm_add_ps(
+				_mm_mul_ps(y[h], lc0[h]),
+				_mm_mul_ps(x[h], ld0[h])
+			);
+			_mm_storeu_ps(
+				row + (h * 4),
+				_mm_add_ps(in, _mm_mul_ps(feedback[h], x[h]))
+			);
+		}
+	}
+	FAudio_memcpy(bank->read_idx, read, sizeof(read));
+
+	for (h = 0; h < 2; h += 1)
+	{
+		_mm_storeu_ps(high->delay + (h * 4), hz[h]);
+		_mm_storeu_ps(low->delay + (h * 4), lz[h]);
+	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+FAUDIO_TARGET_AVX2
+void FAudio_INTERNAL_ProcessCombBank_AVX2(
+	FAudioCombBank *bank,
+	const float *restrict input,
+	float *restrict output,
+	uint32_t len
+) {
+	uint32_t i;
+	uint32_t read[FAUDIO_COMB_BANK_SIZE];
+	float delayed[FAUDIO_COMB_BANK_SIZE];
+	float *row;
+	__m256 x, y;
+	FAudioCombShelf *high = &bank->high_shelving;
+	FAudioCombShelf *low = &bank->low_shelving;
+
+	/* All 8 combs in one vector, everything stays in registers */
+	const __m256 ha0 = _mm256_loadu_ps(high->a0);
+	const __m256 ha1 = _mm256_loadu_ps(high->a1);
+	const __m256 hb1 = _mm256_loadu_ps(high->b1);
+	const __m256 hc0 = _mm256_loadu_ps(high->c0);
+	const __m256 hd0 = _mm256_loadu_ps(high->d0);
+	const __m256 la0 = _mm256_loadu_ps(low->a0);
+	const __m256 la1 = _mm256_loadu_ps(low->a1);
+	const __m256 lb1 = _mm256_loadu_ps(low->b1);
+	const __m256 lc0 = _mm256_loadu_ps(low->c0);
+	const __m256 ld0 = _mm256_loadu_ps(low->d0);
+	const __m256 feedback = _mm256_loadu_ps(bank->feedback);
+	__m256 hz = _mm256_loadu_ps(high->delay);
+	__m256 lz = _mm256_loadu_ps(low->delay);
+
+	FAudio_memcpy(read, bank->read_idx, sizeof(read));
+	for (i = 0; i < len; i += 1)
+	{
+		output[i] = FAudio_INTERNAL_ReadCombBank(bank, read, delayed);
+		row = FAudio_INTERNAL_NextCombBankRow(bank);
+		x = _mm256_setr_ps(
+			delayed[0], delayed[1], delayed[2], delayed[3],
+			delayed[4], delayed[5], delayed[6], delayed[7]
 		);
-		*resampleCache++ = (float) (
-			dCache[1] +
-			(dCache[3] - dCache[1]) *
-			FIXED_TO_FLOAT(cur_scalar)
+		y = _mm256_add_ps(_mm256_mul_ps(ha0, x), hz);
+		hz = _mm256_sub_ps(_mm256_mul_ps(ha1, x), _mm256_mul_ps(hb1, y));
+		x = _mm256_add_ps(_mm256_mul_ps(y, hc0), _mm256_mul_ps(x, hd0));
+		y = _mm256_add_ps(_mm256_mul_ps(la0, x), lz);
+		lz = _mm256_sub_ps(_mm256_mul_ps(la1, x), _mm256_mul_ps(lb1, y));
+		x = _mm256_add_ps(_mm256_mul_ps(y, lc0), _mm256_mul_ps(x, ld0));
+		_mm256_storeu_ps(
+			row,
+			_mm256_add_ps(
+				_mm256_set1_ps(input[i]),
+				_mm256_mul_ps(feedback, x)
+			)
 		);
+	}
+	FAudio_memcpy(bank->read_idx, read, sizeof(read));
 
-		/* Increment fraction offset by the stepping value */
-		*resampleOffset += resampleStep;
-		cur_scalar += resampleStep;
+	_mm256_storeu_ps(high->delay, hz);
+	_mm256_storeu_ps(low->delay, lz);
+}
+#endif /* HAVE_AVX2_INTRINSICS */
 
-		/* Only increment the sample offset by integer values.
-		 * Sometimes this will be 0 until cur accumulates
-		 * enough steps, especially for "slow" rates.
-		 */
-		dCache += (cur_scalar >> FIXED_PRECISION) * 2;
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_ProcessCombBank_NEON(
+	FAudioCombBank *bank,
+	const float *restrict input,
+	float *restrict output,
+	uint32_t len
+) {
+	uint32_t i, h;
+	uint32_t read[FAUDIO_COMB_BANK_SIZE];
+	float delayed[FAUDIO_COMB_BANK_SIZE];
+	float *row;
+	float32x4_t in, x, y;
+	float32x4_t ha0[2], ha1[2], hb1[2], hc0[2], hd0[2], hz[2];
+	float32x4_t la0[2], la1[2], lb1[2], lc0[2], ld0[2], lz[2];
+	float32x4_t feedback[2];
+	FAudioCombShelf *high = &bank->high_shelving;
+	FAudioCombShelf *low = &bank->low_shelving;
+
+	/* Two halves of 4 combs, everything stays in registers for the block */
+	for (h = 0; h < 2; h += 1)
+	{
+		ha0[h] = vld1q_f32(high->a0 + (h * 4));
+		ha1[h] = vld1q_f32(high->a1 + (h * 4));
+		hb1[h] = vld1q_f32(high->b1 + (h * 4));
+		hc0[h] = vld1q_f32(high->c0 + (h * 4));
+		hd0[h] = vld1q_f32(high->d0 + (h * 4));
+		hz[h] = vld1q_f32(high->delay + (h * 4));
+		la0[h] = vld1q_f32(low->a0 + (h * 4));
+		la1[h] = vld1q_f32(low->a1 + (h * 4));
+		lb1[h] = vld1q_f32(low->b1 + (h * 4));
+		lc0[h] = vld1q_f32(low->c0 + (h * 4));
+		ld0[h] = vld1q_f32(low->d0 + (h * 4));
+		lz[h] = vld1q_f32(low->delay + (h * 4));
+		feedback[h] = vld1q_f32(bank->feedback + (h * 4));
+	}
 
-		/* Now that any integer has been added, drop it.
-		 * The offset pointer will preserve the total.
-		 */
-		cur_scalar &= FIXED_FRACTION_MASK;
+	FAudio_memcpy(read, bank->read_idx, sizeof(read));
+	for (i = 0; i < len; i += 1)
+	{
+		output[i] = FAudio_INTERNAL_ReadCombBank(bank, read, delayed);
+		row = FAudio_INTERNAL_NextCombBankRow(bank);
+		in = vdupq_n_f32(input[i]);
+		for (h = 0; h < 2; h += 1)
+		{
+			/* No fused multiply-adds, the scalar version has none */
+			x = vld1q_f32(delayed + (h * 4));
+			y = vaddq_f32(vmulq_f32(ha0[h], x), hz[h]);
+			hz[h] = vsubq_f32(vmulq_f32(ha1[h], x), vmulq_f32(hb1[h], y));
+			x = vaddq_f32(vmulq_f32(y, hc0[h]), vmulq_f32(x, hd0[h]));
+			y = vaddq_f32(vmulq_f32(la0[h], x), lz[h]);
+			lz[h] = vsubq_f32(vmulq_f32(la1[h], x), vmulq_f32(lb1[h], y));
+			x = vaddq_f32(vmulq_f32(y, lc0[h]), vmulq_f32(x, ld0[h]));
+			vst1q_f32(
+				row + (h * 4),
+				vaddq_f32(in, vmulq_f32(feedback[h], x))
+			);
+		}
+	}
+	FAudio_memcpy(bank->read_idx, read, sizeof(read));
+
+	for (h = 0; h < 2; h += 1)
+	{
+		vst1q_f32(high->delay + (h * 4), hz[h]);
+		vst1q_f32(low->delay + (h * 4), lz[h]);
 	}
 }
 #endif /* HAVE_NEON_INTRINSICS */
 
-/* SECTION 3: Amplifiers */
+#undef COMB_BANK_GAIN
+
+/* Biquad cascades. Every band runs on a group of up to 4 channels at once,
+ * doing the same float ops in the same order as the scalar version, so all
+ * versions match exactly. The channels of a frame are loaded straight from
+ * the interleaved samples; the last group loads only the channels it has.
+ */
 
 #if NEED_SCALAR_CONVERTER_FALLBACKS
-void FAudio_INTERNAL_Amplify_Scalar(
-	float* output,
-	uint32_t totalSamples,
-	float volume
+void FAudio_INTERNAL_ProcessBiquadCascade_Scalar(
+	FAudioBiquadCascade *eq,
+	float *samples,
+	uint32_t frames,
+	uint32_t channels
 ) {
-	uint32_t i;
-	for (i = 0; i < totalSamples; i += 1)
+	uint32_t i, c, k;
+	float x, y;
+	float *z1[FAUDIO_EQ_BANDS], *z2[FAUDIO_EQ_BANDS];
+
+	for (c = 0; c < channels; c += 1)
 	{
-		output[i] *= volume;
-		output[i] = FAudio_clamp(
-			output[i],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+		for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+		{
+			z1[k] = eq->delay + (k * 2 * eq->stride) + c;
+			z2[k] = z1[k] + eq->stride;
+		}
+		for (i = 0; i < frames; i += 1)
+		{
+			x = samples[(i * channels) + c];
+			for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+			{
+				y = (eq->a0[k] * x) + *z1[k];
+				*z1[k] = (eq->a1[k] * x) - (eq->b1[k] * y) + *z2[k];
+				*z2[k] = (eq->a2[k] * x) - (eq->b2[k] * y);
+				x = y;
+			}
+			samples[(i * channels) + c] = x;
+		}
 	}
 }
 #endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-/* The SSE2 version of the amplifier comes from @8thMage! */
-
 #if HAVE_SSE2_INTRINSICS
-void FAudio_INTERNAL_Amplify_SSE2(
-	float* output,
-	uint32_t totalSamples,
-	float volume
+static inline __m128 FAudio_INTERNAL_LoadLanes_SSE2(
+	const float *src,
+	uint32_t lanes
 ) {
-	uint32_t i;
-	uint32_t header = (16 - (((size_t) output) % 16)) / 4;
-	uint32_t tail = (totalSamples - header) % 4;
-	__m128 volumeVec, minVolumeVec, maxVolumeVec, outVec;
-	if (header == 4)
+	switch (lanes)
 	{
-		header = 0;
+	case 1:
+		return _mm_load_ss(src);
+	case 2:
+		return _mm_loadl_pi(_mm_setzero_ps(), (const __m64*) src);
+	case 3:
+		return _mm_movelh_ps(
+			_mm_loadl_pi(_mm_setzero_ps(), (const __m64*) src),
+			_mm_load_ss(src + 2)
+		);
+	default:
+		return _mm_loadu_ps(src);
 	}
-	if (tail == 4)
+}
+
+static inline void FAudio_INTERNAL_StoreLanes_SSE2(
+	float *dst,
+	__m128 v,
+	uint32_t lanes
+) {
+	switch (lanes)
 	{
-		tail = 0;
+	case 1:
+		_mm_store_ss(dst, v);
+		break;
+	case 2:
+		_mm_storel_pi((__m64*) dst, v);
+		break;
+	case 3:
+		_mm_storel_pi((__m64*) dst, v);
+		_mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+		break;
+	default:
+		_mm_storeu_ps(dst, v);
+		break;
 	}
+}
 
-	for (i = 0; i < header; i += 1)
+void FAudio_INTERNAL_ProcessBiquadCascade_SSE2(
+	FAudioBiquadCascade *eq,
+	float *samples,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, c, k, lanes;
+	float *frame;
+	__m128 x, y;
+	__m128 a0[FAUDIO_EQ_BANDS], a1[FAUDIO_EQ_BANDS], a2[FAUDIO_EQ_BANDS];
+	__m128 b1[FAUDIO_EQ_BANDS], b2[FAUDIO_EQ_BANDS];
+	__m128 z1[FAUDIO_EQ_BANDS], z2[FAUDIO_EQ_BANDS];
+
+	for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
 	{
-		output[i] *= volume;
-		output[i] = FAudio_clamp(
-			output[i],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+		a0[k] = _mm_set1_ps(eq->a0[k]);
+		a1[k] = _mm_set1_ps(eq->a1[k]);
+		a2[k] = _mm_set1_ps(eq->a2[k]);
+		b1[k] = _mm_set1_ps(eq->b1[k]);
+		b2[k] = _mm_set1_ps(eq->b2[k]);
 	}
 
-	volumeVec = _mm_set1_ps(volume);
-	minVolumeVec = _mm_set1_ps(-FAUDIO_MAX_VOLUME_LEVEL);
-	maxVolumeVec = _mm_set1_ps(FAUDIO_MAX_VOLUME_LEVEL);
-	for (i = header; i < totalSamples - tail; i += 4)
+	for (c = 0; c < channels; c += 4)
 	{
-		outVec = _mm_load_ps(output + i);
-		outVec = _mm_mul_ps(outVec, volumeVec);
-		outVec = _mm_max_ps(outVec, minVolumeVec);
-		outVec = _mm_min_ps(outVec, maxVolumeVec);
-		_mm_store_ps(output + i, outVec);
+		lanes = FAudio_min(channels - c, 4);
+		for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+		{
+			z1[k] = _mm_loadu_ps(eq->delay + (k * 2 * eq->stride) + c);
+			z2[k] = _mm_loadu_ps(eq->delay + (((k * 2) + 1) * eq->stride) + c);
+		}
+		frame = samples + c;
+		for (i = 0; i < frames; i += 1, frame += channels)
+		{
+			x = FAudio_INTERNAL_LoadLanes_SSE2(frame, lanes);
+			for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+			{
+				y = _mm_add_ps(_mm_mul_ps(a0[k], x), z1[k]);
+				z1[k] = _mm_add_ps(
+					_mm_sub_ps(
+						_mm_mul_ps(a1[k], x),
+						_mm_mul_ps(b1[k], y)
+					),
+					z2[k]
+				);
+				z2[k] = _mm_sub_ps(
+					_mm_mul_ps(a2[k], x),
+					_mm_mul_ps(b2[k], y)
+				);
+				x = y;
+			}
+			FAudio_INTERNAL_StoreLanes_SSE2(frame, x, lanes);
+		}
+		for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+		{
+			_mm_storeu_ps(eq->delay + (k * 2 * eq->stride) + c, z1[k]);
+			_mm_storeu_ps(eq->delay + (((k * 2) + 1) * eq->stride) + c, z2[k]);
+		}
 	}
+}
+#endif /* HAVE_SSE2_INTRINSICS */
 
-	for (i = totalSamples - tail; i < totalSamples; i += 1)
+#if HAVE_NEON_INTRINSICS
+static inline float32x4_t FAudio_INTERNAL_LoadLanes_NEON(
+	const float *src,
+	uint32_t lanes
+) {
+	switch (lanes)
 	{
-		output[i] *= volume;
-		output[i] = FAudio_clamp(
-			output[i],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
+	case 1:
+		return vsetq_lane_f32(src[0], vdupq_n_f32(0.0f), 0);
+	case 2:
+		return vcombine_f32(vld1_f32(src), vdup_n_f32(0.0f));
+	case 3:
+		return vcombine_f32(
+			vld1_f32(src),
+			vset_lane_f32(src[2], vdup_n_f32(0.0f), 0)
 		);
+	default:
+		return vld1q_f32(src);
 	}
 }
-#endif /* HAVE_SSE2_INTRINSICS */
 
-#if HAVE_NEON_INTRINSICS
-void FAudio_INTERNAL_Amplify_NEON(
-	float* output,
-	uint32_t totalSamples,
-	float volume
+static inline void FAudio_INTERNAL_StoreLanes_NEON(
+	float *dst,
+	float32x4_t v,
+	uint32_t lanes
 ) {
-	uint32_t i;
-	uint32_t header = (16 - (((size_t) output) % 16)) / 4;
-	uint32_t tail = (totalSamples - header) % 4;
-	float32x4_t volumeVec, minVolumeVec, maxVolumeVec, outVec;
-	if (header == 4)
+	switch (lanes)
 	{
-		header = 0;
+	case 1:
+		vst1q_lane_f32(dst, v, 0);
+		break;
+	case 2:
+		vst1_f32(dst, vget_low_f32(v));
+		break;
+	case 3:
+		vst1_f32(dst, vget_low_f32(v));
+		vst1q_lane_f32(dst + 2, v, 2);
+		break;
+	default:
+		vst1q_f32(dst, v);
+		break;
 	}
-	if (tail == 4)
+}
+
+void FAudio_INTERNAL_ProcessBiquadCascade_NEON(
+	FAudioBiquadCascade *eq,
+	float *samples,
+	uint32_t frames,
+	uint32_t channels
+) {
+	uint32_t i, c, k, lanes;
+	float *frame;
+	float32x4_t x, y;
+	float32x4_t a0[FAUDIO_EQ_BANDS], a1[FAUDIO_EQ_BANDS], a2[FAUDIO_EQ_BANDS];
+	float32x4_t b1[FAUDIO_EQ_BANDS], b2[FAUDIO_EQ_BANDS];
+	float32x4_t z1[FAUDIO_EQ_BANDS], z2[FAUDIO_EQ_BANDS];
+
+	for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
 	{
-		tail = 0;
+		a0[k] = vdupq_n_f32(eq->a0[k]);
+		a1[k] = vdupq_n_f32(eq->a1[k]);
+		a2[k] = vdupq_n_f32(eq->a2[k]);
+		b1[k] = vdupq_n_f32(eq->b1[k]);
+		b2[k] = vdupq_n_f32(eq->b2[k]);
 	}
 
-	for (i = 0; i < header; i += 1)
+	for (c = 0; c < channels; c += 4)
 	{
-		output[i] *= volume;
-		output[i] = FAudio_clamp(
-			output[i],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+		lanes = FAudio_min(channels - c, 4);
+		for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+		{
+			z1[k] = vld1q_f32(eq->delay + (k * 2 * eq->stride) + c);
+			z2[k] = vld1q_f32(eq->delay + (((k * 2) + 1) * eq->stride) + c);
+		}
+		frame = samples + c;
+		for (i = 0; i < frames; i += 1, frame += channels)
+		{
+			/* No fused multiply-adds, the scalar version has none */
+			x = FAudio_INTERNAL_LoadLanes_NEON(frame, lanes);
+			for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+			{
+				y = vaddq_f32(vmulq_f32(a0[k], x), z1[k]);
+				z1[k] = vaddq_f32(
+					vsubq_f32(vmulq_f32(a1[k], x), vmulq_f32(b1[k], y)),
+					z2[k]
+				);
+				z2[k] = vsubq_f32(vmulq_f32(a2[k], x), vmulq_f32(b2[k], y));
+				x = y;
+			}
+			FAudio_INTERNAL_StoreLanes_NEON(frame, x, lanes);
+		}
+		for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+		{
+			vst1q_f32(eq->delay + (k * 2 * eq->stride) + c, z1[k]);
+			vst1q_f32(eq->delay + (((k * 2) + 1) * eq->stride) + c, z2[k]);
+		}
 	}
+}
+#endif /* HAVE_NEON_INTRINSICS */
 
-	volumeVec = vdupq_n_f32(volume);
-	minVolumeVec = vdupq_n_f32(-FAUDIO_MAX_VOLUME_LEVEL);
-	maxVolumeVec = vdupq_n_f32(FAUDIO_MAX_VOLUME_LEVEL);
-	for (i = header; i < totalSamples - tail; i += 4)
+/* Radix-4 FFTs. Each stage splits every block of 4s points into 4 blocks of s.
+ * Point j of the block goes through a 4-point DFT with the points s, 2s and 3s
+ * after it. Output q of that DFT, times the twiddle W^(qj), goes to the qth
+ * quarter of the block. The last stage, where s is 1, has no twiddles. The
+ * vector versions do the same float ops in the same order, either on 4 values
+ * of j at a time or, in the last stage, on 4 blocks at a time.
+ */
+
+#define FFT_PI 3.14159265358979323846
+
+void FAudio_INTERNAL_InitFFT(FAudioFFT *fft, float *twiddles, uint32_t size)
+{
+	uint32_t s, q, j;
+	double angle;
+
+	FAudio_assert(size >= 16);
+	fft->size = size;
+	fft->twiddles = twiddles;
+
+	/* Each stage has W^j, W^2j and W^3j, each as s real then s imaginary */
+	for (s = size / 4; s > 1; s /= 4)
 	{
-		outVec = vld1q_f32(output + i);
-		outVec = vmulq_f32(outVec, volumeVec);
-		outVec = vmaxq_f32(outVec, minVolumeVec);
-		outVec = vminq_f32(outVec, maxVolumeVec);
-		vst1q_f32(output + i, outVec);
+		for (q = 1; q < 4; q += 1)
+		{
+			for (j = 0; j < s; j += 1)
+			{
+				angle = -2.0 * FFT_PI * q * j / (4.0 * s);
+				twiddles[j] = (float) FAudio_cos(angle);
+				twiddles[s + j] = (float) FAudio_sin(angle);
+			}
+			twiddles += 2 * s;
+		}
 	}
+	FAudio_assert(twiddles <= fft->twiddles + FAUDIO_FFT_TWIDDLES(size));
+}
 
-	for (i = totalSamples - tail; i < totalSamples; i += 1)
+#undef FFT_PI
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_FFT_Scalar(
+	const FAudioFFT *fft,
+	float *restrict re,
+	float *restrict im
+) {
+	const float *w = fft->twiddles;
+	uint32_t n = fft->size;
+	uint32_t s, g, j, a, b, c, d;
+	float t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i, yr, yi;
+
+	#define BUTTERFLY \
+		t0r = re[a] + re[c]; \
+		t0i = im[a] + im[c]; \
+		t1r = re[a] - re[c]; \
+		t1i = im[a] - im[c]; \
+		t2r = re[b] + re[d]; \
+		t2i = im[b] + im[d]; \
+		t3r = re[b] - re[d]; \
+		t3i = im[b] - im[d]; \
+		re[a] = t0r + t2r; \
+		im[a] = t0i + t2i;
+	#define TWIDDLE(dst, q) \
+		re[dst] = (yr * w[(q - 1) * 2 * s + j]) - (yi * w[((q - 1) * 2 + 1) * s + j]); \
+		im[dst] = (yr * w[((q - 1) * 2 + 1) * s + j]) + (yi * w[(q - 1) * 2 * s + j]);
+
+	for (s = n / 4; s > 1; w += 6 * s, s /= 4)
 	{
-		output[i] *= volume;
-		output[i] = FAudio_clamp(
-			output[i],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+		for (g = 0; g < n; g += 4 * s)
+		{
+			for (j = 0; j < s; j += 1)
+			{
+				a = g + j;
+				b = a + s;
+				c = b + s;
+				d = c + s;
+				BUTTERFLY
+				yr = t1r + t3i;
+				yi = t1i - t3r;
+				TWIDDLE(b, 1)
+				yr = t0r - t2r;
+				yi = t0i - t2i;
+				TWIDDLE(c, 2)
+				yr = t1r - t3i;
+				yi = t1i + t3r;
+				TWIDDLE(d, 3)
+			}
+		}
+	}
+
+	for (a = 0; a < n; a += 4)
+	{
+		b = a + 1;
+		c = a + 2;
+		d = a + 3;
+		BUTTERFLY
+		re[b] = t1r + t3i;
+		im[b] = t1i - t3r;
+		re[c] = t0r - t2r;
+		im[c] = t0i - t2i;
+		re[d] = t1r - t3i;
+		im[d] = t1i + t3r;
 	}
+
+	#undef BUTTERFLY
+	#undef TWIDDLE
 }
-#endif /* HAVE_NEON_INTRINSICS */
 
-/* SECTION 4: Mixer Functions */
+void FAudio_INTERNAL_SpectrumMAC_Scalar(
+	float *restrict accRe,
+	float *restrict accIm,
+	const float *restrict xRe,
+	const float *restrict xIm,
+	const float *restrict hRe,
+	const float *restrict hIm,
+	uint32_t bins
+) {
+	uint32_t i;
+	float dc = accRe[0] + (xRe[0] * hRe[0]);
+	float nyquist = accIm[0] + (xIm[0] * hIm[0]);
+	for (i = 0; i < bins; i += 1)
+	{
+		accRe[i] += (xRe[i] * hRe[i]) - (xIm[i] * hIm[i]);
+		accIm[i] += (xRe[i] * hIm[i]) + (xIm[i] * hRe[i]);
+	}
+	accRe[0] = dc;
+	accIm[0] = nyquist;
+}
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-void FAudio_INTERNAL_Mix_Generic_Scalar(
-	uint32_t toMix,
-	uint32_t srcChans,
-	uint32_t dstChans,
-	float baseVolume,
-	float *restrict src,
-	float *restrict dst,
-	float *restrict channelVolume,
-	float *restrict coefficients
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_FFT_SSE2(
+	const FAudioFFT *fft,
+	float *restrict re,
+	float *restrict im
 ) {
-	uint32_t i, co, ci;
-	for (i = 0; i < toMix; i += 1, src += srcChans, dst += dstChans)
-	for (co = 0; co < dstChans; co += 1)
+	const float *w = fft->twiddles;
+	uint32_t n = fft->size;
+	uint32_t s, g, j;
+	__m128 ar, ai, br, bi, cr, ci, dr, di;
+	__m128 t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i, yr, yi, wr, wi;
+
+	#define BUTTERFLY \
+		t0r = _mm_add_ps(ar, cr); \
+		t0i = _mm_add_ps(ai, ci); \
+		t1r = _mm_sub_ps(ar, cr); \
+		t1i = _mm_sub_ps(ai, ci); \
+		t2r = _mm_add_ps(br, dr); \
+		t2i = _mm_add_ps(bi, di); \
+		t3r = _mm_sub_ps(br, dr); \
+		t3i = _mm_sub_ps(bi, di); \
+		ar = _mm_add_ps(t0r, t2r); \
+		ai = _mm_add_ps(t0i, t2i);
+	#define TWIDDLE(dstr, dsti, q) \
+		wr = _mm_loadu_ps(w + ((q - 1) * 2 * s) + j); \
+		wi = _mm_loadu_ps(w + (((q - 1) * 2 + 1) * s) + j); \
+		dstr = _mm_sub_ps(_mm_mul_ps(yr, wr), _mm_mul_ps(yi, wi)); \
+		dsti = _mm_add_ps(_mm_mul_ps(yr, wi), _mm_mul_ps(yi, wr));
+
+	for (s = n / 4; s > 1; w += 6 * s, s /= 4)
 	{
-		for (ci = 0; ci < srcChans; ci += 1)
+		for (g = 0; g < n; g += 4 * s)
 		{
-			dst[co] += (
-				src[ci] *
-				channelVolume[ci] *
-				baseVolume *
-				coefficients[co * srcChans + ci]
-			);
+			for (j = 0; j < s; j += 4)
+			{
+				ar = _mm_loadu_ps(re + g + j);
+				ai = _mm_loadu_ps(im + g + j);
+				br = _mm_loadu_ps(re + g + s + j);
+				bi = _mm_loadu_ps(im + g + s + j);
+				cr = _mm_loadu_ps(re + g + (2 * s) + j);
+				ci = _mm_loadu_ps(im + g + (2 * s) + j);
+				dr = _mm_loadu_ps(re + g + (3 * s) + j);
+				di = _mm_loadu_ps(im + g + (3 * s) + j);
+				BUTTERFLY
+				yr = _mm_add_ps(t1r, t3i);
+				yi = _mm_sub_ps(t1i, t3r);
+				TWIDDLE(br, bi, 1)
+				yr = _mm_sub_ps(t0r, t2r);
+				yi = _mm_sub_ps(t0i, t2i);
+				TWIDDLE(cr, ci, 2)
+				yr = _mm_sub_ps(t1r, t3i);
+				yi = _mm_add_ps(t1i, t3r);
+				TWIDDLE(dr, di, 3)
+				_mm_storeu_ps(re + g + j, ar);
+				_mm_storeu_ps(im + g + j, ai);
+				_mm_storeu_ps(re + g + s + j, br);
+				_mm_storeu_ps(im + g + s + j, bi);
+				_mm_storeu_ps(re + g + (2 * s) + j, cr);
+				_mm_storeu_ps(im + g + (2 * s) + j, ci);
+				_mm_storeu_ps(re + g + (3 * s) + j, dr);
+				_mm_storeu_ps(im + g + (3 * s) + j, di);
+			}
 		}
-		dst[co] = FAudio_clamp(
-			dst[co],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
 	}
+
+	/* 4 blocks of 4 points, transposed so each vector holds one point */
+	for (g = 0; g < n; g += 16)
+	{
+		ar = _mm_loadu_ps(re + g);
+		br = _mm_loadu_ps(re + g + 4);
+		cr = _mm_loadu_ps(re + g + 8);
+		dr = _mm_loadu_ps(re + g + 12);
+		ai = _mm_loadu_ps(im + g);
+		bi = _mm_loadu_ps(im + g + 4);
+		ci = _mm_loadu_ps(im + g + 8);
+		di = _mm_loadu_ps(im + g + 12);
+		_MM_TRANSPOSE4_PS(ar, br, cr, dr);
+		_MM_TRANSPOSE4_PS(ai, bi, ci, di);
+		BUTTERFLY
+		br = _mm_add_ps(t1r, t3i);
+		bi = _mm_sub_ps(t1i, t3r);
+		cr = _mm_sub_ps(t0r, t2r);
+		ci = _mm_sub_ps(t0i, t2i);
+		dr = _mm_sub_ps(t1r, t3i);
+		di = _mm_add_ps(t1i, t3r);
+		_MM_TRANSPOSE4_PS(ar, br, cr, dr);
+		_MM_TRANSPOSE4_PS(ai, bi, ci, di);
+		_mm_storeu_ps(re + g, ar);
+		_mm_storeu_ps(re + g + 4, br);
+		_mm_storeu_ps(re + g + 8, cr);
+		_mm_storeu_ps(re + g + 12, dr);
+		_mm_storeu_ps(im + g, ai);
+		_mm_storeu_ps(im + g + 4, bi);
+		_mm_storeu_ps(im + g + 8, ci);
+		_mm_storeu_ps(im + g + 12, di);
+	}
+
+	#undef BUTTERFLY
+	#undef TWIDDLE
 }
 
-void FAudio_INTERNAL_Mix_1in_1out_Scalar(
-	uint32_t toMix,
-	uint32_t UNUSED1,
-	uint32_t UNUSED2,
-	float baseVolume,
-	float *restrict src,
-	float *restrict dst,
-	float *restrict channelVolume,
-	float *restrict coefficients
+void FAudio_INTERNAL_SpectrumMAC_SSE2(
+	float *restrict accRe,
+	float *restrict accIm,
+	const float *restrict xRe,
+	const float *restrict xIm,
+	const float *restrict hRe,
+	const float *restrict hIm,
+	uint32_t bins
 ) {
 	uint32_t i;
-	float totalVolume = baseVolume * channelVolume[0] * coefficients[0];
-	for (i = 0; i < toMix; i += 1, src += 1, dst += 1)
+	__m128 xr, xi, hr, hi;
+	float dc = accRe[0] + (xRe[0] * hRe[0]);
+	float nyquist = accIm[0] + (xIm[0] * hIm[0]);
+	for (i = 0; i < bins; i += 4)
 	{
-		/* Base source data, combined with the coefficients... */
-		dst[0] += src[0] * totalVolume;
-
-		/* ... then clamped. */
-		dst[0] = FAudio_clamp(
-			dst[0],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+		xr = _mm_loadu_ps(xRe + i);
+		xi = _mm_loadu_ps(xIm + i);
+		hr = _mm_loadu_ps(hRe + i);
+		hi = _mm_loadu_ps(hIm + i);
+		_mm_storeu_ps(accRe + i, _mm_add_ps(
+			_mm_loadu_ps(accRe + i),
+			_mm_sub_ps(_mm_mul_ps(xr, hr), _mm_mul_ps(xi, hi))
+		));
+		_mm_storeu_ps(accIm + i, _mm_add_ps(
+			_mm_loadu_ps(accIm + i),
+			_mm_add_ps(_mm_mul_ps(xr, hi), _mm_mul_ps(xi, hr))
+		));
 	}
+	accRe[0] = dc;
+	accIm[0] = nyquist;
 }
+#endif /* HAVE_SSE2_INTRINSICS */
 
-void FAudio_INTERNAL_Mix_1in_2out_Scalar(
-	uint32_t toMix,
-	uint32_t UNUSED1,
-	uint32_t UNUSED2,
-	float baseVolume,
-	float *restrict src,
-	float *restrict dst,
-	float *restrict channelVolume,
-	float *restrict coefficients
+#if HAVE_NEON_INTRINSICS
+void FAudio_INTERNAL_FFT_NEON(
+	const FAudioFFT *fft,
+	float *restrict re,
+	float *restrict im
 ) {
-	uint32_t i;
-	float totalVolume = baseVolume * channelVolume[0];
-	for (i = 0; i < toMix; i += 1, src += 1, dst += 2)
+	const float *w = fft->twiddles;
+	uint32_t n = fft->size;
+	uint32_t s, g, j;
+	float32x4_t ar, ai, br, bi, cr, ci, dr, di;
+	float32x4_t t0r, t0i, t1r, t1i, t2r, t2i, t3r, t3i, yr, yi, wr, wi;
+	float32x4x4_t pr, pi;
+
+	#define BUTTERFLY \
+		t0r = vaddq_f32(ar, cr); \
+		t0i = vaddq_f32(ai, ci); \
+		t1r = vsubq_f32(ar, cr); \
+		t1i = vsubq_f32(ai, ci); \
+		t2r = vaddq_f32(br, dr); \
+		t2i = vaddq_f32(bi, di); \
+		t3r = vsubq_f32(br, dr); \
+		t3i = vsubq_f32(bi, di); \
+		ar = vaddq_f32(t0r, t2r); \
+		ai = vaddq_f32(t0i, t2i);
+	#define TWIDDLE(dstr, dsti, q) \
+		wr = vld1q_f32(w + ((q - 1) * 2 * s) + j); \
+		wi = vld1q_f32(w + (((q - 1) * 2 + 1) * s) + j); \
+		dstr = vsubq_f32(vmulq_f32(yr, wr), vmulq_f32(yi, wi)); \
+		dsti = vaddq_f32(vmulq_f32(yr, wi), vmulq_f32(yi, wr));
+
+	for (s = n / 4; s > 1; w += 6 * s, s /= 4)
 	{
-		/* Base source data... */
-		const float sample = src[0] * totalVolume;
-
-		/* ... combined with the coefficients... */
-		dst[0] += sample * coefficients[0];
-		dst[1] += sample * coefficients[1];
+		for (g = 0; g < n; g += 4 * s)
+		{
+			for (j = 0; j < s; j += 4)
+			{
+				ar = vld1q_f32(re + g + j);
+				ai = vld1q_f32(im + g + j);
+				br = vld1q_f32(re + g + s + j);
+				bi = vld1q_f32(im + g + s + j);
+				cr = vld1q_f32(re + g + (2 * s) + j);
+				ci = vld1q_f32(im + g + (2 * s) + j);
+				dr = vld1q_f32(re + g + (3 * s) + j);
+				di = vld1q_f32(im + g + (3 * s) + j);
+				BUTTERFLY
+				yr = vaddq_f32(t1r, t3i);
+				yi = vsubq_f32(t1i, t3r);
+				TWIDDLE(br, bi, 1)
+				yr = vsubq_f32(t0r, t2r);
+				yi = vsubq_f32(t0i, t2i);
+				TWIDDLE(cr, ci, 2)
+				yr = vsubq_f32(t1r, t3i);
+				yi = vaddq_f32(t1i, t3r);
+				TWIDDLE(dr, di, 3)
+				vst1q_f32(re + g + j, ar);
+				vst1q_f32(im + g + j, ai);
+				vst1q_f32(re + g + s + j, br);
+				vst1q_f32(im + g + s + j, bi);
+				vst1q_f32(re + g + (2 * s) + j, cr);
+				vst1q_f32(im + g + (2 * s) + j, ci);
+				vst1q_f32(re + g + (3 * s) + j, dr);
+				vst1q_f32(im + g + (3 * s) + j, di);
+			}
+		}
+	}
 
-		/* ... then clamped. */
-		dst[0] = FAudio_clamp(
-			dst[0],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[1] = FAudio_clamp(
-			dst[1],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+	/* 4 blocks of 4 points, deinterleaved so each vector holds one point */
+	for (g = 0; g < n; g += 16)
+	{
+		pr = vld4q_f32(re + g);
+		pi = vld4q_f32(im + g);
+		ar = pr.val[0];
+		br = pr.val[1];
+		cr = pr.val[2];
+		dr = pr.val[3];
+		ai = pi.val[0];
+		bi = pi.val[1];
+		ci = pi.val[2];
+		di = pi.val[3];
+		BUTTERFLY
+		pr.val[0] = ar;
+		pr.val[1] = vaddq_f32(t1r, t3i);
+		pr.val[2] = vsubq_f32(t0r, t2r);
+		pr.val[3] = vsubq_f32(t1r, t3i);
+		pi.val[0] = ai;
+		pi.val[1] = vsubq_f32(t1i, t3r);
+		pi.val[2] = vsubq_f32(t0i, t2i);
+		pi.val[3] = vaddq_f32(t1i, t3r);
+		vst4q_f32(re + g, pr);
+		vst4q_f32(im + g, pi);
 	}
+
+	#undef BUTTERFLY
+	#undef TWIDDLE
 }
 
-void FAudio_INTERNAL_Mix_1in_6out_Scalar(
-	uint32_t toMix,
-	uint32_t UNUSED1,
-	uint32_t UNUSED2,
-	float baseVolume,
-	float *restrict src,
-	float *restrict dst,
-	float *restrict channelVolume,
-	float *restrict coefficients
+void FAudio_INTERNAL_SpectrumMAC_NEON(
+	float *restrict accRe,
+	float *restrict accIm,
+	const float *restrict xRe,
+	const float *restrict xIm,
+	const float *restrict hRe,
+	const float *restrict hIm,
+	uint32_t bins
 ) {
 	uint32_t i;
-	float totalVolume = baseVolume * channelVolume[0];
-	for (i = 0; i < toMix; i += 1, src += 1, dst += 6)
-	{
-		/* Base source data... */
-		const float sample = src[0] * totalVolume;
-
-		/* ... combined with the coefficients... */
-		dst[0] += sample * coefficients[0];
-		dst[1] += sample * coefficients[1];
-		dst[2] += sample * coefficients[2];
-		dst[3] += sample * coefficients[3];
-		dst[4] += sample * coefficients[4];
-		dst[5] += sample * coefficients[5];
-
-		/* ... then clamped. */
-		dst[0] = FAudio_clamp(
-			dst[0],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[1] = FAudio_clamp(
-			dst[1],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[2] = FAudio_clamp(
-			dst[2],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[3] = FAudio_clamp(
-			dst[3],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[4] = FAudio_clamp(
-			dst[4],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[5] = FAudio_clamp(
-			dst[5],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+	float32x4_t xr, xi, hr, hi;
+	float dc = accRe[0] + (xRe[0] * hRe[0]);
+	float nyquist = accIm[0] + (xIm[0] * hIm[0]);
+	for (i = 0; i < bins; i += 4)
+	{
+		xr = vld1q_f32(xRe + i);
+		xi = vld1q_f32(xIm + i);
+		hr = vld1q_f32(hRe + i);
+		hi = vld1q_f32(hIm + i);
+		vst1q_f32(accRe + i, vaddq_f32(
+			vld1q_f32(accRe + i),
+			vsubq_f32(vmulq_f32(xr, hr), vmulq_f32(xi, hi))
+		));
+		vst1q_f32(accIm + i, vaddq_f32(
+			vld1q_f32(accIm + i),
+			vaddq_f32(vmulq_f32(xr, hi), vmulq_f32(xi, hr))
+		));
 	}
+	accRe[0] = dc;
+	accIm[0] = nyquist;
 }
+#endif /* HAVE_NEON_INTRINSICS */
 
-void FAudio_INTERNAL_Mix_2in_1out_Scalar(
-	uint32_t toMix,
-	uint32_t UNUSED1,
-	uint32_t UNUSED2,
-	float baseVolume,
-	float *restrict src,
-	float *restrict dst,
-	float *restrict channelVolume,
-	float *restrict coefficients
+/* F3DAudio's emitters, 4 at a time. Every value is computed with the same
+ * float ops, in the same order, as F3DAudioCalculate does for one emitter.
+ */
+
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+void FAudio_INTERNAL_EmitterLanes_Scalar(
+	const F3DAudioListenerFrame *listener,
+	F3DAudioEmitterLanes *lanes,
+	uint32_t count
 ) {
 	uint32_t i;
-	float totalVolumeL = baseVolume * channelVolume[0] * coefficients[0];
-	float totalVolumeR = baseVolume * channelVolume[1] * coefficients[1];
-	for (i = 0; i < toMix; i += 1, src += 2, dst += 1)
+	float ex, ey, ez, px, py, pz, distance, elevation;
+
+	for (i = 0; i < count; i += 1)
 	{
-		/* Base source data, combined with the coefficients... */
-		dst[0] += (
-			(src[0] * totalVolumeL) +
-			(src[1] * totalVolumeR)
-		);
+		ex = listener->position[0] - lanes->position[0][i];
+		ey = listener->position[1] - lanes->position[1][i];
+		ez = listener->position[2] - lanes->position[2][i];
+		distance = FAudio_sqrtf((ex * ex) + (ey * ey) + (ez * ez));
+		lanes->toListener[0][i] = ex;
+		lanes->toListener[1][i] = ey;
+		lanes->toListener[2][i] = ez;
+		lanes->distance[i] = distance;
+		lanes->normalizedDistance[i] = distance / lanes->curveDistanceScaler[i];
+		lanes->listenerFront[i] = (
+			(listener->front[0] * ex) +
+			(listener->front[1] * ey) +
+			(listener->front[2] * ez)
+		) / distance;
+		lanes->emitterFront[i] = (
+			(lanes->front[0][i] * ex) +
+			(lanes->front[1][i] * ey) +
+			(lanes->front[2][i] * ez)
+		) / distance;
+		if (distance != 0.0f)
+		{
+			lanes->listenerVelocity[i] = (
+				(ex * listener->velocity[0]) +
+				(ey * listener->velocity[1]) +
+				(ez * listener->velocity[2])
+			) / distance;
+			lanes->emitterVelocity[i] = (
+				(ex * lanes->velocity[0][i]) +
+				(ey * lanes->velocity[1][i]) +
+				(ez * lanes->velocity[2][i])
+			) / distance;
+		}
+		else
+		{
+			lanes->listenerVelocity[i] = 0.0f;
+			lanes->emitterVelocity[i] = 0.0f;
+		}
 
-		/* ... then clamped. */
-		dst[0] = FAudio_clamp(
-			dst[0],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
+		/* The listener to the emitter, minus its elevation */
+		px = ex * -1.0f;
+		py = ey * -1.0f;
+		pz = ez * -1.0f;
+		elevation = (
+			(listener->top[0] * px) +
+			(listener->top[1] * py) +
+			(listener->top[2] * pz)
+		);
+		px = px - (listener->top[0] * elevation);
+		py = py - (listener->top[1] * elevation);
+		pz = pz - (listener->top[2] * elevation);
+		lanes->radius[i] = FAudio_sqrtf((px * px) + (py * py) + (pz * pz));
+		lanes->plane[0][i] = (
+			(listener->front[0] * px) +
+			(listener->front[1] * py) +
+			(listener->front[2] * pz)
+		);
+		lanes->plane[1][i] = (
+			(listener->right[0] * px) +
+			(listener->right[1] * py) +
+			(listener->right[2] * pz)
 		);
 	}
 }
+#endif /* NEED_SCALAR_CONVERTER_FALLBACKS */
 
-void FAudio_INTERNAL_Mix_2in_2out_Scalar(
-	uint32_t toMix,
-	uint32_t UNUSED1,
-	uint32_t UNUSED2,
-	float baseVolume,
-	float *restrict src,
-	float *restrict dst,
-	float *restrict channelVolume,
-	float *restrict coefficients
+#if HAVE_SSE2_INTRINSICS
+void FAudio_INTERNAL_EmitterLanes_SSE2(
+	const F3DAudioListenerFrame *listener,
+	F3DAudioEmitterLanes *lanes,
+	uint32_t count
 ) {
-	uint32_t i;
-	float totalVolumeL = baseVolume * channelVolume[0];
-	float totalVolumeR = baseVolume * channelVolume[1];
-	for (i = 0; i < toMix; i += 1, src += 2, dst += 2)
+	uint32_t i, j;
+	__m128 l[5][3];
+	__m128 e[3], p[3], distance, elevation, nonzero;
+	const __m128 negative = _mm_set1_ps(-1.0f);
+
+	#define DOT(u, v) _mm_add_ps( \
+		_mm_add_ps(_mm_mul_ps(u[0], v[0]), _mm_mul_ps(u[1], v[1])), \
+		_mm_mul_ps(u[2], v[2]) \
+	)
+	#define LOAD(array) { \
+		_mm_loadu_ps(array[0] + i), \
+		_mm_loadu_ps(array[1] + i), \
+		_mm_loadu_ps(array[2] + i) \
+	}
+
+	for (j = 0; j < 3; j += 1)
 	{
-		/* Base source data... */
-		const float left = src[0] * totalVolumeL;
-		const float right = src[1] * totalVolumeR;
+		l[0][j] = _mm_set1_ps(listener->front[j]);
+		l[1][j] = _mm_set1_ps(listener->right[j]);
+		l[2][j] = _mm_set1_ps(listener->top[j]);
+		l[3][j] = _mm_set1_ps(listener->position[j]);
+		l[4][j] = _mm_set1_ps(listener->velocity[j]);
+	}
 
-		/* ... combined with the coefficients... */
-		dst[0] += (
-			(left * coefficients[0]) +
-			(right * coefficients[1])
-		);
-		dst[1] += (
-			(left * coefficients[2]) +
-			(right * coefficients[3])
-		);
+	for (i = 0; i < count; i += 4)
+	{
+		const __m128 front[3] = LOAD(lanes->front);
+		const __m128 velocity[3] = LOAD(lanes->velocity);
 
-		/* ... then clamped. */
-		dst[0] = FAudio_clamp(
-			dst[0],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[1] = FAudio_clamp(
-			dst[1],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+		for (j = 0; j < 3; j += 1)
+		{
+			e[j] = _mm_sub_ps(l[3][j], _mm_loadu_ps(lanes->position[j] + i));
+			_mm_storeu_ps(lanes->toListener[j] + i, e[j]);
+		}
+		distance = _mm_sqrt_ps(DOT(e, e));
+		nonzero = _mm_cmpneq_ps(distance, _mm_setzero_ps());
+		_mm_storeu_ps(lanes->distance + i, distance);
+		_mm_storeu_ps(lanes->normalizedDistance + i, _mm_div_ps(
+			distance,
+			_mm_loadu_ps(lanes->curveDistanceScaler + i)
+		));
+		_mm_storeu_ps(lanes->listenerFront + i, _mm_div_ps(DOT(l[0], e), distance));
+		_mm_storeu_ps(lanes->emitterFront + i, _mm_div_ps(DOT(front, e), distance));
+		_mm_storeu_ps(lanes->listenerVelocity + i, _mm_and_ps(
+			nonzero,
+			_mm_div_ps(DOT(e, l[4]), distance)
+		));
+		_mm_storeu_ps(lanes->emitterVelocity + i, _mm_and_ps(
+			nonzero,
+			_mm_div_ps(DOT(e, velocity), distance)
+		));
+
+		/* The listener to the emitter, minus its elevation */
+		for (j = 0; j < 3; j += 1)
+		{
+			p[j] = _mm_mul_ps(e[j], negative);
+		}
+		elevation = DOT(l[2], p);
+		for (j = 0; j < 3; j += 1)
+		{
+			p[j] = _mm_sub_ps(p[j], _mm_mul_ps(l[2][j], elevation));
+		}
+		_mm_storeu_ps(lanes->radius + i, _mm_sqrt_ps(DOT(p, p)));
+		_mm_storeu_ps(lanes->plane[0] + i, DOT(l[0], p));
+		_mm_storeu_ps(lanes->plane[1] + i, DOT(l[1], p));
 	}
+
+	#undef DOT
+	#undef LOAD
 }
+#endif /* HAVE_SSE2_INTRINSICS */
 
-void FAudio_INTERNAL_Mix_2in_6out_Scalar(
-	uint32_t toMix,
-	uint32_t UNUSED1,
-	uint32_t UNUSED2,
-	float baseVolume,
-	float *restrict src,
-	float *restrict dst,
-	float *restrict channelVolume,
-	float *restrict coefficients
+#if HAVE_NEON_INTRINSICS
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define LANES_SQRT(v) vsqrtq_f32(v)
+#define LANES_DIV(a, b) vdivq_f32(a, b)
+#else
+/* ARMv7 has neither, and the estimates aren't exact, so do it per lane */
+static inline float32x4_t FAudio_INTERNAL_LanesSqrt(float32x4_t v)
+{
+	float f[4];
+	vst1q_f32(f, v);
+	f[0] = FAudio_sqrtf(f[0]);
+	f[1] = FAudio_sqrtf(f[1]);
+	f[2] = FAudio_sqrtf(f[2]);
+	f[3] = FAudio_sqrtf(f[3]);
+	return vld1q_f32(f);
+}
+static inline float32x4_t FAudio_INTERNAL_LanesDiv(float32x4_t a, float32x4_t b)
+{
+	float fa[4], fb[4];
+	vst1q_f32(fa, a);
+	vst1q_f32(fb, b);
+	fa[0] /= fb[0];
+	fa[1] /= fb[1];
+	fa[2] /= fb[2];
+	fa[3] /= fb[3];
+	return vld1q_f32(fa);
+}
+#define LANES_SQRT(v) FAudio_INTERNAL_LanesSqrt(v)
+#define LANES_DIV(a, b) FAudio_INTERNAL_LanesDiv(a, b)
+#endif
+
+void FAudio_INTERNAL_EmitterLanes_NEON(
+	const F3DAudioListenerFrame *listener,
+	F3DAudioEmitterLanes *lanes,
+	uint32_t count
 ) {
-	uint32_t i;
-	float totalVolumeL = baseVolume * channelVolume[0];
-	float totalVolumeR = baseVolume * channelVolume[1];
-	for (i = 0; i < toMix; i += 1, src += 2, dst += 6)
+	uint32_t i, j;
+	float32x4_t l[5][3];
+	float32x4_t e[3], p[3], distance, elevation;
+	uint32x4_t nonzero;
+	const float32x4_t negative = vdupq_n_f32(-1.0f);
+
+	#define DOT(u, v) vaddq_f32( \
+		vaddq_f32(vmulq_f32(u[0], v[0]), vmulq_f32(u[1], v[1])), \
+		vmulq_f32(u[2], v[2]) \
+	)
+	#define LOAD(array) { \
+		vld1q_f32(array[0] + i), \
+		vld1q_f32(array[1] + i), \
+		vld1q_f32(array[2] + i) \
+	}
+	#define ZERO_AT_ORIGIN(v) vreinterpretq_f32_u32(vandq_u32( \
+		nonzero, \
+		vreinterpretq_u32_f32(v) \
+	))
+
+	for (j = 0; j < 3; j += 1)
 	{
-		/* Base source data... */
-		const float left = src[0] * totalVolumeL;
-		const float right = src[1] * totalVolumeR;
+		l[0][j] = vdupq_n_f32(listener->front[j]);
+		l[1][j] = vdupq_n_f32(listener->right[j]);
+		l[2][j] = vdupq_n_f32(listener->top[j]);
+		l[3][j] = vdupq_n_f32(listener->position[j]);
+		l[4][j] = vdupq_n_f32(listener->velocity[j]);
+	}
 
-		/* ... combined with the coefficients... */
-		dst[0] += (
-			(left * coefficients[0]) +
-			(right * coefficients[1])
-		);
-		dst[1] += (
-			(left * coefficients[2]) +
-			(right * coefficients[3])
-		);
-		dst[2] += (
-			(left * coefficients[4]) +
-			(right * coefficients[5])
-		);
-		dst[3] += (
-			(left * coefficients[6]) +
-			(right * coefficients[7])
-		);
-		dst[4] += (
-			(left * coefficients[8]) +
-			(right * coefficients[9])
-		);
-		dst[5] += (
-			(left * coefficients[10]) +
-			(right * coefficients[11])
-		);
+	for (i = 0; i < count; i += 4)
+	{
+		const float32x4_t front[3] = LOAD(lanes->front);
+		const float32x4_t velocity[3] = LOAD(lanes->velocity);
 
-		/* ... then clamped. */
-		dst[0] = FAudio_clamp(
-			dst[0],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[1] = FAudio_clamp(
-			dst[1],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[2] = FAudio_clamp(
-			dst[2],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[3] = FAudio_clamp(
-			dst[3],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[4] = FAudio_clamp(
-			dst[4],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
-		dst[5] = FAudio_clamp(
-			dst[5],
-			-FAUDIO_MAX_VOLUME_LEVEL,
-			FAUDIO_MAX_VOLUME_LEVEL
-		);
+		for (j = 0; j < 3; j += 1)
+		{
+			e[j] = vsubq_f32(l[3][j], vld1q_f32(lanes->position[j] + i));
+			vst1q_f32(lanes->toListener[j] + i, e[j]);
+		}
+		distance = LANES_SQRT(DOT(e, e));
+		nonzero = vmvnq_u32(vceqq_f32(distance, vdupq_n_f32(0.0f)));
+		vst1q_f32(lanes->distance + i, distance);
+		vst1q_f32(lanes->normalizedDistance + i, LANES_DIV(
+			distance,
+			vld1q_f32(lanes->curveDistanceScaler + i)
+		));
+		vst1q_f32(lanes->listenerFront + i, LANES_DIV(DOT(l[0], e), distance));
+		vst1q_f32(lanes->emitterFront + i, LANES_DIV(DOT(front, e), distance));
+		vst1q_f32(lanes->listenerVelocity + i, ZERO_AT_ORIGIN(
+			LANES_DIV(DOT(e, l[4]), distance)
+		));
+		vst1q_f32(lanes->emitterVelocity + i, ZERO_AT_ORIGIN(
+			LANES_DIV(DOT(e, velocity), distance)
+		));
+
+		/* The listener to the emitter, minus its elevation */
+		for (j = 0; j < 3; j += 1)
+		{
+			p[j] = vmulq_f32(e[j], negative);
+		}
+		elevation = DOT(l[2], p);
+		for (j = 0; j < 3; j += 1)
+		{
+			p[j] = vsubq_f32(p[j], vmulq_f32(l[2][j], elevation));
+		}
+		vst1q_f32(lanes->radius + i, LANES_SQRT(DOT(p, p)));
+		vst1q_f32(lanes->plane[0] + i, DOT(l[0], p));
+		vst1q_f32(lanes->plane[1] + i, DOT(l[1], p));
 	}
+
+	#undef DOT
+	#undef LOAD
+	#undef ZERO_AT_ORIGIN
+}
+
+#undef LANES_SQRT
+#undef LANES_DIV
+#endif /* HAVE_NEON_INTRINSICS */
+
+/* SECTION 7: Floating-Point Environment */
+
+/* Decaying filters and reverb tails end up in denormals, which the FPU handles
+ * many times slower than normal floats. Flushing them to zero, both as inputs
+ * and results, costs nothing audible: they are all below -750 dB.
+ */
+
+#if HAVE_SSE2_INTRINSICS
+#define MXCSR_DAZ 0x0040
+#define MXCSR_FTZ 0x8000
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define FPCR_FZ (1 << 24)
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#define FPCR_FZ (1 << 24)
+#elif defined(__arm__) && (defined(__GNUC__) || defined(__clang__))
+#define FPSCR_FZ (1 << 24)
+#endif
+
+uint64_t FAudio_INTERNAL_FlushDenormals(void)
+{
+#if HAVE_SSE2_INTRINSICS
+	const uint32_t csr = _mm_getcsr();
+	_mm_setcsr(csr | MXCSR_DAZ | MXCSR_FTZ);
+	return csr;
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+	uint64_t fpcr;
+	__asm__ __volatile__ ("mrs %0, fpcr" : "=r" (fpcr));
+	__asm__ __volatile__ ("msr fpcr, %0" : : "r" (fpcr | FPCR_FZ));
+	return fpcr;
+#elif defined(_M_ARM64)
+	const uint64_t fpcr = _ReadStatusReg(ARM64_FPCR);
+	_WriteStatusReg(ARM64_FPCR, fpcr | FPCR_FZ);
+	return fpcr;
+#elif defined(__arm__) && (defined(__GNUC__) || defined(__clang__))
+	/* NEON always flushes, this covers the VFP scalar code */
+	uint32_t fpscr;
+	__asm__ __volatile__ ("vmrs %0, fpscr" : "=r" (fpscr));
+	__asm__ __volatile__ ("vmsr fpscr, %0" : : "r" (fpscr | FPSCR_FZ));
+	return fpscr;
+#else
+	return 0; /* Nothing we know how to set, everything runs as before */
+#endif
+}
+
+void FAudio_INTERNAL_RestoreDenormals(uint64_t state)
+{
+#if HAVE_SSE2_INTRINSICS
+	_mm_setcsr((uint32_t) state);
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+	__asm__ __volatile__ ("msr fpcr, %0" : : "r" (state));
+#elif defined(_M_ARM64)
+	_WriteStatusReg(ARM64_FPCR, (__int64) state);
+#elif defined(__arm__) && (defined(__GNUC__) || defined(__clang__))
+	__asm__ __volatile__ ("vmsr fpscr, %0" : : "r" ((uint32_t) state));
+#else
+	(void) state;
+#endif
 }
 
-/* SECTION 5: InitSIMDFunctions. Assigns based on SSE2/NEON support. */
+/* SECTION 8: InitSIMDFunctions. Assigns based on SSE2/NEON support. */
 
 void (*FAudio_INTERNAL_Convert_U8_To_F32)(
 	const uint8_t *restrict src,
@@ -1538,26 +6346,253 @@ void (*FAudio_INTERNAL_Convert_S16_To_F32)(
 	float *restrict dst,
 	uint32_t len
 );
+void (*FAudio_INTERNAL_Convert_S24_To_F32)(
+	const uint8_t *restrict src,
+	float *restrict dst,
+	uint32_t len
+);
+void (*FAudio_INTERNAL_UnpackNibbles)(
+	const uint8_t *restrict src,
+	int8_t *restrict dst,
+	uint32_t len
+);
+void (*FAudio_INTERNAL_InterleaveF32)(
+	const float *const *src,
+	float *restrict dst,
+	uint32_t frames,
+	uint32_t channels
+);
+void (*FAudio_INTERNAL_Convert_F32_To_S16)(
+	const float *restrict src,
+	int16_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+);
+void (*FAudio_INTERNAL_Convert_F32_To_S24)(
+	const float *restrict src,
+	uint8_t *restrict dst,
+	uint32_t len,
+	uint32_t *restrict dither
+);
+void (*FAudio_INTERNAL_Convert_F32_To_S32)(
+	const float *restrict src,
+	int32_t *restrict dst,
+	uint32_t len
+);
 
 FAudioResampleCallback FAudio_INTERNAL_ResampleMono;
 FAudioResampleCallback FAudio_INTERNAL_ResampleStereo;
+FAudioResampleCallback FAudio_INTERNAL_ResampleGeneric;
+FAudioSincResampleCallback FAudio_INTERNAL_ResampleSinc;
+FAudioFixedResampleCallback FAudio_INTERNAL_ResampleFixed;
 
 void (*FAudio_INTERNAL_Amplify)(
 	float *output,
 	uint32_t totalSamples,
 	float volume
 );
+uint8_t (*FAudio_INTERNAL_IsSilent)(
+	const float *samples,
+	uint32_t totalSamples
+);
 
-void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
-{
+void (*FAudio_INTERNAL_FilterVoice)(
+	const FAudioFilterParameters *filter,
+	FAudioFilterState *filterState,
+	float *samples,
+	uint32_t numSamples,
+	uint16_t numChannels
+);
+/* FAudioFX's reverbs, FAPOFX's EQ and limiter and F3DAudio can be used
+ * without an engine, which is what calls InitSIMDFunctions, so their kernels
+ * start out as the baseline versions.
+ */
+FAudioCombBankCallback FAudio_INTERNAL_ProcessCombBank =
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+	FAudio_INTERNAL_ProcessCombBank_Scalar;
+#elif HAVE_SSE2_INTRINSICS
+	FAudio_INTERNAL_ProcessCombBank_SSE2;
+#else
+	FAudio_INTERNAL_ProcessCombBank_NEON;
+#endif
+FAudioBiquadCascadeCallback FAudio_INTERNAL_ProcessBiquadCascade =
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+	FAudio_INTERNAL_ProcessBiquadCascade_Scalar;
+#elif HAVE_SSE2_INTRINSICS
+	FAudio_INTERNAL_ProcessBiquadCascade_SSE2;
+#else
+	FAudio_INTERNAL_ProcessBiquadCascade_NEON;
+#endif
+FAudioFFTCallback FAudio_INTERNAL_FFT =
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+	FAudio_INTERNAL_FFT_Scalar;
+#elif HAVE_SSE2_INTRINSICS
+	FAudio_INTERNAL_FFT_SSE2;
+#else
+	FAudio_INTERNAL_FFT_NEON;
+#endif
+FAudioSpectrumMACCallback FAudio_INTERNAL_SpectrumMAC =
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+	FAudio_INTERNAL_SpectrumMAC_Scalar;
+#elif HAVE_SSE2_INTRINSICS
+	FAudio_INTERNAL_SpectrumMAC_SSE2;
+#else
+	FAudio_INTERNAL_SpectrumMAC_NEON;
+#endif
+F3DAudioEmitterLanesCallback FAudio_INTERNAL_EmitterLanes =
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+	FAudio_INTERNAL_EmitterLanes_Scalar;
+#elif HAVE_SSE2_INTRINSICS
+	FAudio_INTERNAL_EmitterLanes_SSE2;
+#else
+	FAudio_INTERNAL_EmitterLanes_NEON;
+#endif
+void (*FAudio_INTERNAL_FramePeaks)(
+	const float *restrict samples,
+	float *restrict peaks,
+	uint32_t frames,
+	uint32_t channels
+) =
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+	FAudio_INTERNAL_FramePeaks_Scalar;
+#elif HAVE_SSE2_INTRINSICS
+	FAudio_INTERNAL_FramePeaks_SSE2;
+#else
+	FAudio_INTERNAL_FramePeaks_NEON;
+#endif
+void (*FAudio_INTERNAL_ChannelLevels)(
+	const float *restrict samples,
+	float *restrict peaks,
+	float *restrict sums,
+	uint32_t frames,
+	uint32_t channels
+) =
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+	FAudio_INTERNAL_ChannelLevels_Scalar;
+#elif HAVE_SSE2_INTRINSICS
+	FAudio_INTERNAL_ChannelLevels_SSE2;
+#else
+	FAudio_INTERNAL_ChannelLevels_NEON;
+#endif
+
+FAudioMixCallback FAudio_INTERNAL_Mix_Generic;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_1out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_2out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_6out;
+FAudioMixCallback FAudio_INTERNAL_Mix_1in_8out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_1out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_2out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_6out;
+FAudioMixCallback FAudio_INTERNAL_Mix_2in_8out;
+FAudioMixCallback FAudio_INTERNAL_Mix_6in_2out;
+FAudioMixCallback FAudio_INTERNAL_Mix_6in_6out;
+FAudioMixCallback FAudio_INTERNAL_Mix_8in_8out;
+FAudioResampleMixCallback FAudio_INTERNAL_ResampleMixMono;
+
+#define ASSIGN_MIX_FUNCS(isa) \
+	FAudio_INTERNAL_Mix_Generic = FAudio_INTERNAL_Mix_Generic_##isa; \
+	FAudio_INTERNAL_Mix_1in_1out = FAudio_INTERNAL_Mix_1in_1out_##isa; \
+	FAudio_INTERNAL_Mix_1in_2out = FAudio_INTERNAL_Mix_1in_2out_##isa; \
+	FAudio_INTERNAL_Mix_1in_6out = FAudio_INTERNAL_Mix_1in_6out_##isa; \
+	FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_##isa; \
+	FAudio_INTERNAL_Mix_2in_1out = FAudio_INTERNAL_Mix_2in_1out_##isa; \
+	FAudio_INTERNAL_Mix_2in_2out = FAudio_INTERNAL_Mix_2in_2out_##isa; \
+	FAudio_INTERNAL_Mix_2in_6out = FAudio_INTERNAL_Mix_2in_6out_##isa; \
+	FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_##isa; \
+	FAudio_INTERNAL_Mix_6in_2out = FAudio_INTERNAL_Mix_6in_2out_##isa; \
+	FAudio_INTERNAL_Mix_6in_6out = FAudio_INTERNAL_Mix_6in_6out_##isa; \
+	FAudio_INTERNAL_Mix_8in_8out = FAudio_INTERNAL_Mix_8in_8out_##isa;
+
+void FAudio_INTERNAL_InitSIMDFunctions(
+	uint8_t hasSSE2,
+	uint8_t hasAVX2,
+	uint8_t hasNEON
+) {
+	/* FAUDIO_FORCE_SIMD caps the tier for A/B testing. "sse2" and "neon"
+	 * turn off AVX2, "scalar" turns off everything where scalar fallback
+	 * functions are built at all. It can never pick a tier the CPU lacks.
+	 */
+	const char *force = FAudio_getenv("FAUDIO_FORCE_SIMD");
+	if (force != NULL)
+	{
+		if (FAudio_strcmp(force, "avx2") != 0)
+		{
+			hasAVX2 = 0;
+		}
+#if NEED_SCALAR_CONVERTER_FALLBACKS
+		if (FAudio_strcmp(force, "scalar") == 0)
+		{
+			hasSSE2 = 0;
+			hasNEON = 0;
+		}
+#endif
+	}
+
+	FAudio_INTERNAL_InitSincTable();
+
+#if HAVE_AVX2_INTRINSICS
+	if (hasAVX2 && hasSSE2)
+	{
+		FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_AVX2;
+		FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_AVX2;
+		FAudio_INTERNAL_Convert_S24_To_F32 = FAudio_INTERNAL_Convert_S24_To_F32_AVX2;
+		FAudio_INTERNAL_UnpackNibbles = FAudio_INTERNAL_UnpackNibbles_SSE2;
+		FAudio_INTERNAL_InterleaveF32 = FAudio_INTERNAL_InterleaveF32_SSE2;
+		FAudio_INTERNAL_Convert_F32_To_S16 = FAudio_INTERNAL_Convert_F32_To_S16_SSE2;
+		FAudio_INTERNAL_Convert_F32_To_S24 = FAudio_INTERNAL_Convert_F32_To_S24_SSE2;
+		FAudio_INTERNAL_Convert_F32_To_S32 = FAudio_INTERNAL_Convert_F32_To_S32_SSE2;
+		FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_AVX2;
+		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_AVX2;
+		FAudio_INTERNAL_ResampleGeneric = FAudio_INTERNAL_ResampleGeneric_SSE2;
+		FAudio_INTERNAL_ResampleSinc = FAudio_INTERNAL_ResampleSinc_SSE2;
+		FAudio_INTERNAL_ResampleFixed = FAudio_INTERNAL_ResampleFixed_SSE2;
+		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_AVX2;
+		FAudio_INTERNAL_IsSilent = FAudio_INTERNAL_IsSilent_AVX2;
+		FAudio_INTERNAL_FramePeaks = FAudio_INTERNAL_FramePeaks_SSE2;
+		FAudio_INTERNAL_ChannelLevels = FAudio_INTERNAL_ChannelLevels_SSE2;
+		FAudio_INTERNAL_FilterVoice = FAudio_INTERNAL_FilterVoice_AVX2;
+		FAudio_INTERNAL_ProcessCombBank = FAudio_INTERNAL_ProcessCombBank_AVX2;
+		FAudio_INTERNAL_ProcessBiquadCascade = FAudio_INTERNAL_ProcessBiquadCascade_SSE2;
+		FAudio_INTERNAL_FFT = FAudio_INTERNAL_FFT_SSE2;
+		FAudio_INTERNAL_SpectrumMAC = FAudio_INTERNAL_SpectrumMAC_SSE2;
+		FAudio_INTERNAL_EmitterLanes = FAudio_INTERNAL_EmitterLanes_SSE2;
+		FAudio_INTERNAL_ResampleMixMono = FAudio_INTERNAL_ResampleMixMono_SSE2;
+		ASSIGN_MIX_FUNCS(SSE2)
+		FAudio_INTERNAL_Mix_1in_1out = FAudio_INTERNAL_Mix_1in_1out_AVX2;
+		FAudio_INTERNAL_Mix_1in_8out = FAudio_INTERNAL_Mix_1in_8out_AVX2;
+		FAudio_INTERNAL_Mix_2in_8out = FAudio_INTERNAL_Mix_2in_8out_AVX2;
+		FAudio_INTERNAL_Mix_8in_8out = FAudio_INTERNAL_Mix_8in_8out_AVX2;
+		return;
+	}
+#endif
 #if HAVE_SSE2_INTRINSICS
 	if (hasSSE2)
 	{
 		FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_SSE2;
 		FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_SSE2;
+		FAudio_INTERNAL_Convert_S24_To_F32 = FAudio_INTERNAL_Convert_S24_To_F32_SSE2;
+		FAudio_INTERNAL_UnpackNibbles = FAudio_INTERNAL_UnpackNibbles_SSE2;
+		FAudio_INTERNAL_InterleaveF32 = FAudio_INTERNAL_InterleaveF32_SSE2;
+		FAudio_INTERNAL_Convert_F32_To_S16 = FAudio_INTERNAL_Convert_F32_To_S16_SSE2;
+		FAudio_INTERNAL_Convert_F32_To_S24 = FAudio_INTERNAL_Convert_F32_To_S24_SSE2;
+		FAudio_INTERNAL_Convert_F32_To_S32 = FAudio_INTERNAL_Convert_F32_To_S32_SSE2;
 		FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_SSE2;
 		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_SSE2;
+		FAudio_INTERNAL_ResampleGeneric = FAudio_INTERNAL_ResampleGeneric_SSE2;
+		FAudio_INTERNAL_ResampleSinc = FAudio_INTERNAL_ResampleSinc_SSE2;
+		FAudio_INTERNAL_ResampleFixed = FAudio_INTERNAL_ResampleFixed_SSE2;
 		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_SSE2;
+		FAudio_INTERNAL_IsSilent = FAudio_INTERNAL_IsSilent_SSE2;
+		FAudio_INTERNAL_FramePeaks = FAudio_INTERNAL_FramePeaks_SSE2;
+		FAudio_INTERNAL_ChannelLevels = FAudio_INTERNAL_ChannelLevels_SSE2;
+		FAudio_INTERNAL_FilterVoice = FAudio_INTERNAL_FilterVoice_SSE2;
+		FAudio_INTERNAL_ProcessCombBank = FAudio_INTERNAL_ProcessCombBank_SSE2;
+		FAudio_INTERNAL_ProcessBiquadCascade = FAudio_INTERNAL_ProcessBiquadCascade_SSE2;
+		FAudio_INTERNAL_FFT = FAudio_INTERNAL_FFT_SSE2;
+		FAudio_INTERNAL_SpectrumMAC = FAudio_INTERNAL_SpectrumMAC_SSE2;
+		FAudio_INTERNAL_EmitterLanes = FAudio_INTERNAL_EmitterLanes_SSE2;
+		FAudio_INTERNAL_ResampleMixMono = FAudio_INTERNAL_ResampleMixMono_SSE2;
+		ASSIGN_MIX_FUNCS(SSE2)
 		return;
 	}
 #endif
@@ -1566,21 +6601,63 @@ void FAudio_INTERNAL_InitSIMDFunctions(uint8_t hasSSE2, uint8_t hasNEON)
 	{
 		FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_NEON;
 		FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_NEON;
+		FAudio_INTERNAL_Convert_S24_To_F32 = FAudio_INTERNAL_Convert_S24_To_F32_NEON;
+		FAudio_INTERNAL_UnpackNibbles = FAudio_INTERNAL_UnpackNibbles_NEON;
+		FAudio_INTERNAL_InterleaveF32 = FAudio_INTERNAL_InterleaveF32_NEON;
+		FAudio_INTERNAL_Convert_F32_To_S16 = FAudio_INTERNAL_Convert_F32_To_S16_NEON;
+		FAudio_INTERNAL_Convert_F32_To_S24 = FAudio_INTERNAL_Convert_F32_To_S24_NEON;
+		FAudio_INTERNAL_Convert_F32_To_S32 = FAudio_INTERNAL_Convert_F32_To_S32_NEON;
 		FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_NEON;
 		FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_NEON;
+		FAudio_INTERNAL_ResampleGeneric = FAudio_INTERNAL_ResampleGeneric_NEON;
+		FAudio_INTERNAL_ResampleSinc = FAudio_INTERNAL_ResampleSinc_NEON;
+		FAudio_INTERNAL_ResampleFixed = FAudio_INTERNAL_ResampleFixed_NEON;
 		FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_NEON;
+		FAudio_INTERNAL_IsSilent = FAudio_INTERNAL_IsSilent_NEON;
+		FAudio_INTERNAL_FramePeaks = FAudio_INTERNAL_FramePeaks_NEON;
+		FAudio_INTERNAL_ChannelLevels = FAudio_INTERNAL_ChannelLevels_NEON;
+		FAudio_INTERNAL_FilterVoice = FAudio_INTERNAL_FilterVoice_NEON;
+		FAudio_INTERNAL_ProcessCombBank = FAudio_INTERNAL_ProcessCombBank_NEON;
+		FAudio_INTERNAL_ProcessBiquadCascade = FAudio_INTERNAL_ProcessBiquadCascade_NEON;
+		FAudio_INTERNAL_FFT = FAudio_INTERNAL_FFT_NEON;
+		FAudio_INTERNAL_SpectrumMAC = FAudio_INTERNAL_SpectrumMAC_NEON;
+		FAudio_INTERNAL_EmitterLanes = FAudio_INTERNAL_EmitterLanes_NEON;
+		FAudio_INTERNAL_ResampleMixMono = FAudio_INTERNAL_ResampleMixMono_NEON;
+		ASSIGN_MIX_FUNCS(NEON)
 		return;
 	}
 #endif
 #if NEED_SCALAR_CONVERTER_FALLBACKS
 	FAudio_INTERNAL_Convert_U8_To_F32 = FAudio_INTERNAL_Convert_U8_To_F32_Scalar;
 	FAudio_INTERNAL_Convert_S16_To_F32 = FAudio_INTERNAL_Convert_S16_To_F32_Scalar;
+	FAudio_INTERNAL_Convert_S24_To_F32 = FAudio_INTERNAL_Convert_S24_To_F32_Scalar;
+	FAudio_INTERNAL_UnpackNibbles = FAudio_INTERNAL_UnpackNibbles_Scalar;
+	FAudio_INTERNAL_InterleaveF32 = FAudio_INTERNAL_InterleaveF32_Scalar;
+	FAudio_INTERNAL_Convert_F32_To_S16 = FAudio_INTERNAL_Convert_F32_To_S16_Scalar;
+	FAudio_INTERNAL_Convert_F32_To_S24 = FAudio_INTERNAL_Convert_F32_To_S24_Scalar;
+	FAudio_INTERNAL_Convert_F32_To_S32 = FAudio_INTERNAL_Convert_F32_To_S32_Scalar;
 	FAudio_INTERNAL_ResampleMono = FAudio_INTERNAL_ResampleMono_Scalar;
 	FAudio_INTERNAL_ResampleStereo = FAudio_INTERNAL_ResampleStereo_Scalar;
+	FAudio_INTERNAL_ResampleGeneric = FAudio_INTERNAL_ResampleGeneric_Scalar;
+	FAudio_INTERNAL_ResampleSinc = FAudio_INTERNAL_ResampleSinc_Scalar;
+	FAudio_INTERNAL_ResampleFixed = FAudio_INTERNAL_ResampleFixed_Scalar;
 	FAudio_INTERNAL_Amplify = FAudio_INTERNAL_Amplify_Scalar;
+	FAudio_INTERNAL_IsSilent = FAudio_INTERNAL_IsSilent_Scalar;
+	FAudio_INTERNAL_FramePeaks = FAudio_INTERNAL_FramePeaks_Scalar;
+	FAudio_INTERNAL_ChannelLevels = FAudio_INTERNAL_ChannelLevels_Scalar;
+	FAudio_INTERNAL_FilterVoice = FAudio_INTERNAL_FilterVoice_Scalar;
+	FAudio_INTERNAL_ProcessCombBank = FAudio_INTERNAL_ProcessCombBank_Scalar;
+	FAudio_INTERNAL_ProcessBiquadCascade = FAudio_INTERNAL_ProcessBiquadCascade_Scalar;
+	FAudio_INTERNAL_FFT = FAudio_INTERNAL_FFT_Scalar;
+	FAudio_INTERNAL_SpectrumMAC = FAudio_INTERNAL_SpectrumMAC_Scalar;
+	FAudio_INTERNAL_EmitterLanes = FAudio_INTERNAL_EmitterLanes_Scalar;
+	FAudio_INTERNAL_ResampleMixMono = FAudio_INTERNAL_ResampleMixMono_Scalar;
+	ASSIGN_MIX_FUNCS(Scalar)
 #else
 	FAudio_assert(0 && "Need converter functions!");
 #endif
 }
 
+#undef ASSIGN_MIX_FUNCS
+
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -0,0 +1,662 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2018 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+#include "FAudio_internal.h"
+
+/* Internal OperationSet Types */
+
+typedef enum FAudio_OPERATIONSET_Type
+{
+	FAUDIOOP_ENABLEEFFECT,
+	FAUDIOOP_DISABLEEFFECT,
+	FAUDIOOP_SETEFFECTPARAMETERS,
+	FAUDIOOP_SETFILTERPARAMETERS,
+	FAUDIOOP_SETOUTPUTFILTERPARAMETERS,
+	FAUDIOOP_SETVOLUME,
+	FAUDIOOP_SETCHANNELVOLUMES,
+	FAUDIOOP_SETOUTPUTMATRIX,
+	FAUDIOOP_START,
+	FAUDIOOP_STOP,
+	FAUDIOOP_EXITLOOP,
+	FAUDIOOP_SETFREQUENCYRATIO
+} FAudio_OPERATIONSET_Type;
+
+struct FAudio_OPERATIONSET_Operation
+{
+	FAudio_OPERATIONSET_Type Type;
+	uint32_t OperationSet;
+	FAudioVoice *Voice;
+
+	union
+	{
+		struct
+		{
+			uint32_t EffectIndex;
+		} EnableEffect;
+		struct
+		{
+			uint32_t EffectIndex;
+		} DisableEffect;
+		struct
+		{
+			uint32_t EffectIndex;
+			void *pParameters;
+			uint32_t ParametersByteSize;
+		} SetEffectParameters;
+		struct
+		{
+			FAudioFilterParameters Parameters;
+		} SetFilterParameters;
+		struct
+		{
+			FAudioVoice *pDestinationVoice;
+			FAudioFilterParameters Parameters;
+		} SetOutputFilterParameters;
+		struct
+		{
+			float Volume;
+		} SetVolume;
+		struct
+		{
+			uint32_t Channels;
+			float *pVolumes;
+		} SetChannelVolumes;
+		struct
+		{
+			FAudioVoice *pDestinationVoice;
+			uint32_t SourceChannels;
+			uint32_t DestinationChannels;
+			float *pLevelMatrix;
+		} SetOutputMatrix;
+		struct
+		{
+			uint32_t Flags;
+		} Start;
+		struct
+		{
+			uint32_t Flags;
+		} Stop;
+		/* No special data for ExitLoop */
+		struct
+		{
+			float Ratio;
+		} SetFrequencyRatio;
+	} Data;
+
+	FAudio_OPERATIONSET_Operation *next;
+};
+
+/* Used by both Commit and Clear routines */
+
+static inline void DeleteOperation(
+	FAudio_OPERATIONSET_Operation *op,
+	FAudio *audio
+) {
+	if (op->Type == FAUDIOOP_SETEFFECTPARAMETERS)
+	{
+		FAudio_INTERNAL_Free(audio, op->Data.SetEffectParameters.pParameters);
+	}
+	else if (op->Type == FAUDIOOP_SETCHANNELVOLUMES)
+	{
+		FAudio_INTERNAL_Free(audio, op->Data.SetChannelVolumes.pVolumes);
+	}
+	else if (op->Type == FAUDIOOP_SETOUTPUTMATRIX)
+	{
+		FAudio_INTERNAL_Free(audio, op->Data.SetOutputMatrix.pLevelMatrix);
+	}
+	FAudio_INTERNAL_Free(audio, op);
+}
+
+static inline void ExecuteOperation(FAudio_OPERATIONSET_Operation *op)
+{
+	switch (op->Type)
+	{
+	case FAUDIOOP_ENABLEEFFECT:
+		FAudioVoice_EnableEffect(
+			op->Voice,
+			op->Data.EnableEffect.EffectIndex,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_DISABLEEFFECT:
+		FAudioVoice_DisableEffect(
+			op->Voice,
+			op->Data.DisableEffect.EffectIndex,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_SETEFFECTPARAMETERS:
+		FAudioVoice_SetEffectParameters(
+			op->Voice,
+			op->Data.SetEffectParameters.EffectIndex,
+			op->Data.SetEffectParameters.pParameters,
+			op->Data.SetEffectParameters.ParametersByteSize,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_SETFILTERPARAMETERS:
+		FAudioVoice_SetFilterParameters(
+			op->Voice,
+			&op->Data.SetFilterParameters.Parameters,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_SETOUTPUTFILTERPARAMETERS:
+		FAudioVoice_SetOutputFilterParameters(
+			op->Voice,
+			op->Data.SetOutputFilterParameters.pDestinationVoice,
+			&op->Data.SetOutputFilterParameters.Parameters,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_SETVOLUME:
+		FAudioVoice_SetVolume(
+			op->Voice,
+			op->Data.SetVolume.Volume,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_SETCHANNELVOLUMES:
+		FAudioVoice_SetChannelVolumes(
+			op->Voice,
+			op->Data.SetChannelVolumes.Channels,
+			op->Data.SetChannelVolumes.pVolumes,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_SETOUTPUTMATRIX:
+		FAudioVoice_SetOutputMatrix(
+			op->Voice,
+			op->Data.SetOutputMatrix.pDestinationVoice,
+			op->Data.SetOutputMatrix.SourceChannels,
+			op->Data.SetOutputMatrix.DestinationChannels,
+			op->Data.SetOutputMatrix.pLevelMatrix,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_START:
+		FAudioSourceVoice_Start(
+			op->Voice,
+			op->Data.Start.Flags,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_STOP:
+		FAudioSourceVoice_Stop(
+			op->Voice,
+			op->Data.Stop.Flags,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_EXITLOOP:
+		FAudioSourceVoice_ExitLoop(
+			op->Voice,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	case FAUDIOOP_SETFREQUENCYRATIO:
+		FAudioSourceVoice_SetFrequencyRatio(
+			op->Voice,
+			op->Data.SetFrequencyRatio.Ratio,
+			FAUDIO_COMMIT_NOW
+		);
+		break;
+	default:
+		FAudio_assert(0 && "Unrecognized operation type!");
+		break;
+	}
+}
+
+/* Queue/Commit/Execute */
+
+static inline FAudio_OPERATIONSET_Operation* QueueOperation(
+	FAudioVoice *voice,
+	FAudio_OPERATIONSET_Type type,
+	uint32_t operationSet
+) {
+	FAudio_OPERATIONSET_Operation *op = (FAudio_OPERATIONSET_Operation*) FAudio_INTERNAL_Malloc(
+		voice->audio,
+		sizeof(FAudio_OPERATIONSET_Operation)
+	);
+	op->Type = type;
+	op->OperationSet = operationSet;
+	op->Voice = voice;
+	op->next = NULL;
+	return op;
+}
+
+static inline void AppendOperation(FAudio_OPERATIONSET_Operation *op)
+{
+	FAudio *audio = op->Voice->audio;
+	FAudio_OPERATIONSET_Operation *latest;
+
+	FAudio_PlatformLockMutex(audio->operationLock);
+	LOG_MUTEX_LOCK(audio, audio->operationLock)
+	if (audio->queuedOperations == NULL)
+	{
+		audio->queuedOperations = op;
+	}
+	else
+	{
+		latest = audio->queuedOperations;
+		while (latest->next != NULL)
+		{
+			latest = latest->next;
+		}
+		latest->next = op;
+	}
+	FAudio_PlatformUnlockMutex(audio->operationLock);
+	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
+}
+
+void FAudio_OPERATIONSET_Commit(FAudio *audio, uint32_t OperationSet)
+{
+	FAudio_OPERATIONSET_Operation *op, *prev, *next, *tail;
+
+	LOG_FUNC_ENTER(audio)
+	FAudio_PlatformLockMutex(audio->operationLock);
+	LOG_MUTEX_LOCK(audio, audio->operationLock)
+
+	/* Find the end of whatever the mixer hasn't picked up yet */
+	tail = audio->committedOperations;
+	while (tail != NULL && tail->next != NULL)
+	{
+		tail = tail->next;
+	}
+
+	/* Move the matching operations over, keeping the call order */
+	prev = NULL;
+	op = audio->queuedOperations;
+	while (op != NULL)
+	{
+		next = op->next;
+		if (	OperationSet == FAUDIO_COMMIT_ALL ||
+			op->OperationSet == OperationSet	)
+		{
+			if (prev == NULL)
+			{
+				audio->queuedOperations = next;
+			}
+			else
+			{
+				prev->next = next;
+			}
+			op->next = NULL;
+			if (tail == NULL)
+			{
+				audio->committedOperations = op;
+			}
+			else
+			{
+				tail->next = op;
+			}
+			tail = op;
+		}
+		else
+		{
+			prev = op;
+		}
+		op = next;
+	}
+
+	FAudio_PlatformUnlockMutex(audio->operationLock);
+	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
+	LOG_FUNC_EXIT(audio)
+}
+
+void FAudio_OPERATIONSET_Execute(FAudio *audio)
+{
+	FAudio_OPERATIONSET_Operation *op, *next;
+
+	/* Peek without locking, most passes have nothing to commit. If we
+	 * race with a Commit we'll just catch it on the next pass.
+	 */
+	if (audio->committedOperations == NULL)
+	{
+		return;
+	}
+
+	LOG_FUNC_ENTER(audio)
+
+	/* The lock is held while executing so that a voice can't be
+	 * destroyed out from under a committed operation.
+	 */
+	FAudio_PlatformLockMutex(audio->operationLock);
+	LOG_MUTEX_LOCK(audio, audio->operationLock)
+	op = audio->committedOperations;
+	audio->committedOperations = NULL;
+	while (op != NULL)
+	{
+		next = op->next;
+		ExecuteOperation(op);
+		DeleteOperation(op, audio);
+		op = next;
+	}
+	FAudio_PlatformUnlockMutex(audio->operationLock);
+	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
+
+	LOG_FUNC_EXIT(audio)
+}
+
+/* OperationSet Clear Functions */
+
+static inline void ClearList(
+	FAudio_OPERATIONSET_Operation **list,
+	FAudioVoice *voice,
+	FAudio *audio
+) {
+	FAudio_OPERATIONSET_Operation *op, *prev, *next;
+
+	prev = NULL;
+	op = *list;
+	while (op != NULL)
+	{
+		next = op->next;
+		if (voice == NULL || op->Voice == voice)
+		{
+			if (prev == NULL)
+			{
+				*list = next;
+			}
+			else
+			{
+				prev->next = next;
+			}
+			DeleteOperation(op, audio);
+		}
+		else
+		{
+			prev = op;
+		}
+		op = next;
+	}
+}
+
+void FAudio_OPERATIONSET_ClearAll(FAudio *audio)
+{
+	LOG_FUNC_ENTER(audio)
+	FAudio_PlatformLockMutex(audio->operationLock);
+	LOG_MUTEX_LOCK(audio, audio->operationLock)
+	ClearList(&audio->queuedOperations, NULL, audio);
+	ClearList(&audio->committedOperations, NULL, audio);
+	FAudio_PlatformUnlockMutex(audio->operationLock);
+	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
+	LOG_FUNC_EXIT(audio)
+}
+
+void FAudio_OPERATIONSET_ClearAllForVoice(FAudioVoice *voice)
+{
+	FAudio *audio = voice->audio;
+
+	LOG_FUNC_ENTER(audio)
+	FAudio_PlatformLockMutex(audio->operationLock);
+	LOG_MUTEX_LOCK(audio, audio->operationLock)
+	ClearList(&audio->queuedOperations, voice, audio);
+	ClearList(&audio->committedOperations, voice, audio);
+	FAudio_PlatformUnlockMutex(audio->operationLock);
+	LOG_MUTEX_UNLOCK(audio, audio->operationLock)
+	LOG_FUNC_EXIT(audio)
+}
+
+/* OperationSet Queue Functions */
+
+void FAudio_OPERATIONSET_QueueEnableEffect(
+	FAudioVoice *voice,
+	uint32_t EffectIndex,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_ENABLEEFFECT, OperationSet);
+	op->Data.EnableEffect.EffectIndex = EffectIndex;
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueDisableEffect(
+	FAudioVoice *voice,
+	uint32_t EffectIndex,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_DISABLEEFFECT, OperationSet);
+	op->Data.DisableEffect.EffectIndex = EffectIndex;
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueSetEffectParameters(
+	FAudioVoice *voice,
+	uint32_t EffectIndex,
+	const void *pParameters,
+	uint32_t ParametersByteSize,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_SETEFFECTPARAMETERS, OperationSet);
+	op->Data.SetEffectParameters.EffectIndex = EffectIndex;
+	op->Data.SetEffectParameters.pParameters = FAudio_INTERNAL_Malloc(
+		voice->audio,
+		ParametersByteSize
+	);
+	FAudio_memcpy(
+		op->Data.SetEffectParameters.pParameters,
+		pParameters,
+		ParametersByteSize
+	);
+	op->Data.SetEffectParameters.ParametersByteSize = ParametersByteSize;
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueSetFilterParameters(
+	FAudioVoice *voice,
+	const FAudioFilterParameters *pParameters,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_SETFILTERPARAMETERS, OperationSet);
+	FAudio_memcpy(
+		&op->Data.SetFilterParameters.Parameters,
+		pParameters,
+		sizeof(FAudioFilterParameters)
+	);
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueSetOutputFilterParameters(
+	FAudioVoice *voice,
+	FAudioVoice *pDestinationVoice,
+	const FAudioFilterParameters *pParameters,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_SETOUTPUTFILTERPARAMETERS, OperationSet);
+	op->Data.SetOutputFilterParameters.pDestinationVoice = pDestinationVoice;
+	FAudio_memcpy(
+		&op->Data.SetOutputFilterParameters.Parameters,
+		pParameters,
+		sizeof(FAudioFilterParameters)
+	);
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueSetVolume(
+	FAudioVoice *voice,
+	float Volume,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_SETVOLUME, OperationSet);
+	op->Data.SetVolume.Volume = Volume;
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueSetChannelVolumes(
+	FAudioVoice *voice,
+	uint32_t Channels,
+	const float *pVolumes,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_SETCHANNELVOLUMES, OperationSet);
+	op->Data.SetChannelVolumes.Channels = Channels;
+	op->Data.SetChannelVolumes.pVolumes = (float*) FAudio_INTERNAL_Malloc(
+		voice->audio,
+		sizeof(float) * Channels
+	);
+	FAudio_memcpy(
+		op->Data.SetChannelVolumes.pVolumes,
+		pVolumes,
+		sizeof(float) * Channels
+	);
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueSetOutputMatrix(
+	FAudioVoice *voice,
+	FAudioVoice *pDestinationVoice,
+	uint32_t SourceChannels,
+	uint32_t DestinationChannels,
+	const float *pLevelMatrix,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_SETOUTPUTMATRIX, OperationSet);
+	op->Data.SetOutputMatrix.pDestinationVoice = pDestinationVoice;
+	op->Data.SetOutputMatrix.SourceChannels = SourceChannels;
+	op->Data.SetOutputMatrix.DestinationChannels = DestinationChannels;
+	op->Data.SetOutputMatrix.pLevelMatrix = (float*) FAudio_INTERNAL_Malloc(
+		voice->audio,
+		sizeof(float) * SourceChannels * DestinationChannels
+	);
+	FAudio_memcpy(
+		op->Data.SetOutputMatrix.pLevelMatrix,
+		pLevelMatrix,
+		sizeof(float) * SourceChannels * DestinationChannels
+	);
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueStart(
+	FAudioSourceVoice *voice,
+	uint32_t Flags,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_START, OperationSet);
+	op->Data.Start.Flags = Flags;
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueStop(
+	FAudioSourceVoice *voice,
+	uint32_t Flags,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_STOP, OperationSet);
+	op->Data.Stop.Flags = Flags;
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueExitLoop(
+	FAudioSourceVoice *voice,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_EXITLOOP, OperationSet);
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+void FAudio_OPERATIONSET_QueueSetFrequencyRatio(
+	FAudioSourceVoice *voice,
+	float Ratio,
+	uint32_t OperationSet
+) {
+	FAudio_OPERATIONSET_Operation *op;
+
+	LOG_FUNC_ENTER(voice->audio)
+
+	op = QueueOperation(voice, FAUDIOOP_SETFREQUENCYRATIO, OperationSet);
+	op->Data.SetFrequencyRatio.Ratio = Ratio;
+	AppendOperation(op);
+
+	LOG_FUNC_EXIT(voice->audio)
+}
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -0,0 +1,516 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2018 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+#ifdef HAVE_ALSA
+
+#include "FAudio_internal.h"
+
+#include <alsa/asoundlib.h>
+
+/* A native Linux device, opened by FAudio_platform_sdl2.c in place of an SDL
+ * audio device. The mix thread waits for the device to free a period, then
+ * mixes straight into the device's mmap buffer, so there is no buffering or
+ * conversion between the engine and the hardware besides ALSA's own. On
+ * PipeWire and PulseAudio systems the default device goes through their ALSA
+ * plugins, which provide the same mmap interface.
+ *
+ * Everything besides the device itself (threads, mutexes, I/O) still comes
+ * from SDL.
+ */
+
+/* Default latency when FAudio_SetDevicePeriodEXT wasn't called, split into
+ * two periods
+ */
+#define ALSA_DEFAULT_LATENCY_MS 5
+
+/* The formats FAudio_INTERNAL_SetDeviceFormat converts to, best first */
+static const struct
+{
+	uint32_t format;
+	snd_pcm_format_t alsa;
+	uint32_t bytes;
+} alsaFormats[] =
+{
+	{ FAUDIO_DEVICE_FORMAT_F32_EXT, SND_PCM_FORMAT_FLOAT_LE, 4 },
+	{ FAUDIO_DEVICE_FORMAT_S32_EXT, SND_PCM_FORMAT_S32_LE, 4 },
+	{ FAUDIO_DEVICE_FORMAT_S24_EXT, SND_PCM_FORMAT_S24_3LE, 3 },
+	{ FAUDIO_DEVICE_FORMAT_S16_EXT, SND_PCM_FORMAT_S16_LE, 2 }
+};
+
+typedef struct FAudioALSADevice
+{
+	FAudio *audio;
+	snd_pcm_t *pcm;
+	uint32_t channels;
+	uint32_t frameBytes;
+	snd_pcm_uframes_t period;
+	snd_pcm_uframes_t buffer;
+	int timeout;
+
+	/* Used when a period wraps around the end of the mmap buffer */
+	uint8_t *staging;
+
+	volatile int32_t quit;
+	FAudioThread thread;
+} FAudioALSADevice;
+
+/* Device Enumeration */
+
+/* Calls func for each playback device ALSA knows about, stopping when it
+ * returns 1. Returns the number of devices visited.
+ */
+static uint32_t FAudio_INTERNAL_ALSAEnumerate(
+	uint8_t (*func)(uint32_t index, const char *name, const char *desc, void *data),
+	void *data
+) {
+	void **hints, **hint;
+	char *name, *desc, *ioid;
+	uint32_t count = 0;
+	uint8_t stop = 0;
+
+	if (snd_device_name_hint(-1, "pcm", &hints) < 0)
+	{
+		return 0;
+	}
+	for (hint = hints; *hint != NULL && !stop; hint += 1)
+	{
+		name = snd_device_name_get_hint(*hint, "NAME");
+		desc = snd_device_name_get_hint(*hint, "DESC");
+		ioid = snd_device_name_get_hint(*hint, "IOID");
+
+		/* No IOID means the device does both */
+		if (	name != NULL &&
+			FAudio_strcmp(name, "null") != 0 &&
+			FAudio_strcmp(name, "default") != 0 &&
+			(ioid == NULL || FAudio_strcmp(ioid, "Output") == 0)	)
+		{
+			if (func != NULL)
+			{
+				stop = func(count, name, desc, data);
+			}
+			count += 1;
+		}
+
+		/* ALSA allocates these with the C runtime, not SDL */
+		free(name);
+		free(desc);
+		free(ioid);
+	}
+	snd_device_name_free_hint(hints);
+	return count;
+}
+
+typedef struct FAudioALSAFind
+{
+	uint32_t index;
+	char *dst;
+	size_t len;
+	uint8_t useDesc;
+} FAudioALSAFind;
+
+static uint8_t FAudio_INTERNAL_ALSAFind(
+	uint32_t index,
+	const char *name,
+	const char *desc,
+	void *data
+) {
+	FAudioALSAFind *find = (FAudioALSAFind*) data;
+	char *c;
+
+	if (index != find->index)
+	{
+		return 0;
+	}
+	if (find->useDesc && desc != NULL)
+	{
+		/* Descriptions are "Card, Device\nWhat it is", keep one line */
+		FAudio_strlcpy(find->dst, desc, find->len);
+		for (c = find->dst; *c != '\0'; c += 1)
+		{
+			if (*c == '\n')
+			{
+				*c = ' ';
+			}
+		}
+	}
+	else
+	{
+		FAudio_strlcpy(find->dst, name, find->len);
+	}
+	return 1;
+}
+
+uint32_t FAudio_ALSA_GetDeviceCount()
+{
+	return FAudio_INTERNAL_ALSAEnumerate(NULL, NULL) + 1;
+}
+
+uint8_t FAudio_ALSA_GetDeviceName(
+	uint32_t index,
+	uint8_t description,
+	char *name,
+	size_t len
+) {
+	FAudioALSAFind find;
+
+	if (index == 0)
+	{
+		FAudio_strlcpy(
+			name,
+			description ? "Default Device" : "default",
+			len
+		);
+		return 1;
+	}
+
+	find.index = index - 1;
+	find.dst = name;
+	find.len = len;
+	find.useDesc = description;
+	return FAudio_INTERNAL_ALSAEnumerate(
+		FAudio_INTERNAL_ALSAFind,
+		&find
+	) > find.index;
+}
+
+/* Mixer Thread */
+
+static void FAudio_INTERNAL_ALSAMix(FAudioALSADevice *device, void *output)
+{
+	FAudio_zero(output, device->frameBytes * device->period);
+	if (device->audio->active)
+	{
+		FAudio_INTERNAL_UpdateEngine(device->audio, (float*) output);
+	}
+}
+
+/* Writes one period into the mmap buffer. Returns 0 on success, or a
+ * negative error code for snd_pcm_recover.
+ */
+static int FAudio_INTERNAL_ALSAWritePeriod(FAudioALSADevice *device)
+{
+	const snd_pcm_channel_area_t *areas;
+	snd_pcm_uframes_t offset, frames, done;
+	snd_pcm_sframes_t committed;
+	uint8_t *dst;
+	int err;
+
+	/* Usually this is one mapping, but a period whose offset isn't
+	 * aligned to a period can wrap around the end of the buffer.
+	 */
+	frames = device->period;
+	err = snd_pcm_mmap_begin(device->pcm, &areas, &offset, &frames);
+	if (err < 0)
+	{
+		return err;
+	}
+	dst = (
+		(uint8_t*) areas[0].addr +
+		((areas[0].first + offset * areas[0].step) / 8)
+	);
+	if (frames == device->period)
+	{
+		FAudio_INTERNAL_ALSAMix(device, dst);
+		committed = snd_pcm_mmap_commit(device->pcm, offset, frames);
+		return (committed < 0) ? (int) committed : 0;
+	}
+
+	FAudio_INTERNAL_ALSAMix(device, device->staging);
+	done = 0;
+	while (1)
+	{
+		FAudio_memcpy(
+			dst,
+			device->staging + done * device->frameBytes,
+			device->frameBytes * frames
+		);
+		committed = snd_pcm_mmap_commit(device->pcm, offset, frames);
+		if (committed < 0)
+		{
+			return (int) committed;
+		}
+		done += frames;
+		if (done == device->period)
+		{
+			return 0;
+		}
+
+		frames = device->period - done;
+		err = snd_pcm_mmap_begin(device->pcm, &areas, &offset, &frames);
+		if (err < 0)
+		{
+			return err;
+		}
+		dst = (
+			(uint8_t*) areas[0].addr +
+			((areas[0].first + offset * areas[0].step) / 8)
+		);
+	}
+}
+
+static int32_t FAUDIOCALL FAudio_INTERNAL_ALSAThread(void *data)
+{
+	FAudioALSADevice *device = (FAudioALSADevice*) data;
+	FAudio *audio = device->audio;
+	snd_pcm_sframes_t avail;
+	int err;
+
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+	while (!FAudio_PlatformAtomicGet(&device->quit))
+	{
+		avail = snd_pcm_avail_update(device->pcm);
+		if (avail >= 0 && (snd_pcm_uframes_t) avail < device->period)
+		{
+			/* Also starts the device once the first periods are in */
+			if (snd_pcm_state(device->pcm) == SND_PCM_STATE_PREPARED)
+			{
+				snd_pcm_start(device->pcm);
+			}
+			err = snd_pcm_wait(device->pcm, device->timeout);
+			if (err >= 0)
+			{
+				continue;
+			}
+		}
+		else if (avail >= 0)
+		{
+			FAudio_INTERNAL_ApplyThreadSchedule(
+				&audio->threadSchedules[FAUDIO_THREAD_MIX_EXT],
+				&audio->mixScheduler,
+				FAUDIO_THREAD_PRIORITY_HIGH
+			);
+			err = FAudio_INTERNAL_ALSAWritePeriod(device);
+			if (err == 0)
+			{
+				continue;
+			}
+		}
+		else
+		{
+			err = (int) avail;
+		}
+
+		/* Underrun or suspend. The buffer is refilled from scratch, the
+		 * device starts again once it's full.
+		 */
+		if (err == -EPIPE)
+		{
+			audio->renderUnderruns += 1;
+		}
+		err = snd_pcm_recover(device->pcm, err, 1);
+		if (err < 0)
+		{
+			LOG_ERROR(
+				audio,
+				"ALSA device lost: %s",
+				snd_strerror(err)
+			)
+			break;
+		}
+	}
+	return 0;
+}
+
+/* Platform Functions */
+
+void* FAudio_ALSA_Open(
+	FAudio *audio,
+	uint32_t deviceIndex,
+	uint32_t *channels,
+	uint32_t *sampleRate,
+	uint32_t *period,
+	uint32_t *format,
+	uint32_t *latency
+) {
+	FAudioALSADevice *device;
+	snd_pcm_hw_params_t *hw;
+	snd_pcm_sw_params_t *sw;
+	snd_pcm_uframes_t buffer;
+	unsigned int rate, chans;
+	char name[256];
+	uint32_t i;
+	int err;
+
+	if (!FAudio_ALSA_GetDeviceName(deviceIndex, 0, name, sizeof(name)))
+	{
+		return NULL;
+	}
+
+	device = (FAudioALSADevice*) FAudio_INTERNAL_Malloc(audio, sizeof(FAudioALSADevice));
+	FAudio_zero(device, sizeof(FAudioALSADevice));
+	device->audio = audio;
+
+	err = snd_pcm_open(&device->pcm, name, SND_PCM_STREAM_PLAYBACK, 0);
+	if (err < 0)
+	{
+		LOG_WARNING(
+			audio,
+			"Could not open ALSA device %s: %s",
+			name,
+			snd_strerror(err)
+		)
+		FAudio_INTERNAL_Free(audio, device);
+		return NULL;
+	}
+
+	/* The engine's format, without SDL's conversion in the way. The
+	 * device must take interleaved mmap access, which the plug layer
+	 * behind "default" always provides. Unless the client asked for a
+	 * format, take the first one the device supports, float first so
+	 * the mix needs no conversion.
+	 */
+	snd_pcm_hw_params_alloca(&hw);
+	snd_pcm_hw_params_any(device->pcm, hw);
+	rate = *sampleRate;
+	chans = *channels;
+	if ((err = snd_pcm_hw_params_set_access(device->pcm, hw, SND_PCM_ACCESS_MMAP_INTERLEAVED)) < 0)
+	{
+		goto fail;
+	}
+	err = -EINVAL;
+	for (i = 0; i < sizeof(alsaFormats) / sizeof(alsaFormats[0]); i += 1)
+	{
+		if (	*format != FAUDIO_DEVICE_FORMAT_DEFAULT_EXT &&
+			*format != alsaFormats[i].format	)
+		{
+			continue;
+		}
+		err = snd_pcm_hw_params_set_format(device->pcm, hw, alsaFormats[i].alsa);
+		if (err >= 0)
+		{
+			break;
+		}
+	}
+	if (err < 0)
+	{
+		goto fail;
+	}
+	if (	(err = snd_pcm_hw_params_set_channels_near(device->pcm, hw, &chans)) < 0 ||
+		(err = snd_pcm_hw_params_set_rate_near(device->pcm, hw, &rate, NULL)) < 0	)
+	{
+		goto fail;
+	}
+	device->period = (*period == 0) ?
+		(rate * ALSA_DEFAULT_LATENCY_MS / 2000) :
+		*period;
+	if ((err = snd_pcm_hw_params_set_period_size_near(device->pcm, hw, &device->period, NULL)) < 0)
+	{
+		goto fail;
+	}
+
+	/* Two periods, one playing while the other is mixed, plus any the
+	 * client asked for with FAudio_SetRenderAheadEXT.
+	 */
+	buffer = device->period * (2 + audio->renderAhead);
+	if (	(err = snd_pcm_hw_params_set_buffer_size_near(device->pcm, hw, &buffer)) < 0 ||
+		(err = snd_pcm_hw_params(device->pcm, hw)) < 0	)
+	{
+		goto fail;
+	}
+	snd_pcm_hw_params_get_period_size(hw, &device->period, NULL);
+	snd_pcm_hw_params_get_buffer_size(hw, &device->buffer);
+	if (device->buffer < 2 * device->period)
+	{
+		err = -EINVAL;
+		goto fail;
+	}
+
+	/* Wake up for every period, the thread starts the device itself */
+	snd_pcm_sw_params_alloca(&sw);
+	snd_pcm_sw_params_current(device->pcm, sw);
+	if (	(err = snd_pcm_sw_params_set_avail_min(device->pcm, sw, device->period)) < 0 ||
+		(err = snd_pcm_sw_params_set_start_threshold(device->pcm, sw, device->buffer)) < 0 ||
+		(err = snd_pcm_sw_params(device->pcm, sw)) < 0	)
+	{
+		goto fail;
+	}
+
+	device->channels = chans;
+	device->frameBytes = alsaFormats[i].bytes * chans;
+	device->staging = (uint8_t*) FAudio_INTERNAL_Malloc(
+		audio,
+		device->frameBytes * device->period
+	);
+
+	/* Long enough to never time out while the device is running */
+	device->timeout = (int) FAudio_max(
+		10,
+		4 * device->period * 1000 / rate
+	);
+
+	*channels = chans;
+	*sampleRate = rate;
+	*period = (uint32_t) device->period;
+	*format = alsaFormats[i].format;
+	*latency = (uint32_t) device->buffer;
+	return device;
+
+fail:
+	LOG_WARNING(
+		audio,
+		"Could not configure ALSA device %s: %s",
+		name,
+		snd_strerror(err)
+	)
+	snd_pcm_close(device->pcm);
+	FAudio_INTERNAL_Free(audio, device);
+	return NULL;
+}
+
+void FAudio_ALSA_Start(void *device)
+{
+	FAudioALSADevice *alsa = (FAudioALSADevice*) device;
+	alsa->thread = FAudio_PlatformCreateThread(
+		FAudio_INTERNAL_ALSAThread,
+		"FAudio ALSA",
+		alsa
+	);
+	FAudio_assert(alsa->thread != NULL);
+}
+
+void FAudio_ALSA_Close(void *device)
+{
+	FAudioALSADevice *alsa = (FAudioALSADevice*) device;
+	int32_t retval;
+
+	if (alsa->thread != NULL)
+	{
+		FAudio_PlatformAtomicAdd(&alsa->quit, 1);
+		FAudio_PlatformWaitThread(alsa->thread, &retval);
+	}
+	snd_pcm_drop(alsa->pcm);
+	snd_pcm_close(alsa->pcm);
+	FAudio_INTERNAL_Free(alsa->audio, alsa->staging);
+	FAudio_INTERNAL_Free(alsa->audio, alsa);
+}
+
+#else
+
+extern int this_tu_is_empty;
+
+#endif /* HAVE_ALSA */
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
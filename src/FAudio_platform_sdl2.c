@@ -24,10 +24,27 @@
  *
  */
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity, SCHED_RESET_ON_FORK */
+#endif
+
 #include "FAudio_internal.h"
 
 #include <SDL.h>
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
 /* Internal Types */
 
 typedef struct FAudioPlatformDevice
@@ -35,8 +52,39 @@ typedef struct FAudioPlatformDevice
 	uint32_t bufferSize;
 	SDL_AudioDeviceID device;
 	FAudioWaveFormatExtensible format;
+
+	/* Mixing in the callback, a gap of more than two periods between
+	 * callbacks counts as a glitch. In SDL_GetPerformanceCounter units.
+	 */
+	Uint64 lastCallback;
+	Uint64 lateCallback;
+
+	/* Render-ahead ring, see FAudio_SetRenderAheadEXT.
+	 * The render thread is the only writer and the device callback is the
+	 * only reader. ringFilled is the only state they share, ringSpace
+	 * wakes the render thread whenever the callback frees a period.
+	 */
+	FAudio *audio;
+	uint8_t *ring;
+	uint32_t periodBytes;
+	uint32_t ringCount;
+	uint32_t ringRead;
+	SDL_atomic_t ringFilled;
+	SDL_sem *ringSpace;
+	SDL_atomic_t renderQuit;
+	FAudioThread renderThread;
+
+#ifdef HAVE_ALSA
+	/* Native device, used instead of SDL's when it could be opened */
+	void *alsa;
+#endif /* HAVE_ALSA */
 } FAudioPlatformDevice;
 
+#ifndef FAUDIO_DISABLE_LOCK_STATS
+/* Set on threads while they mix, see FAudio_PlatformSetMixThread */
+static SDL_TLSID mixThreadTLS = 0;
+#endif /* FAUDIO_DISABLE_LOCK_STATS */
+
 /* WaveFormatExtensible Helpers */
 
 static inline uint32_t GetMask(uint16_t channels)
@@ -79,8 +127,22 @@ static inline void WriteWaveFormatExtensible(
 
 void FAudio_INTERNAL_MixCallback(void *userdata, Uint8 *stream, int len)
 {
-	FAudio *audio = (FAudio*) userdata;
+	FAudioPlatformDevice *device = (FAudioPlatformDevice*) userdata;
+	FAudio *audio = device->audio;
+	Uint64 now = SDL_GetPerformanceCounter();
 
+	if (	device->lastCallback != 0 &&
+		now - device->lastCallback > device->lateCallback	)
+	{
+		audio->lateCallbacks += 1;
+	}
+	device->lastCallback = now;
+
+	FAudio_INTERNAL_ApplyThreadSchedule(
+		&audio->threadSchedules[FAUDIO_THREAD_MIX_EXT],
+		&audio->mixScheduler,
+		FAUDIO_THREAD_PRIORITY_HIGH
+	);
 	FAudio_zero(stream, len);
 	if (audio->active)
 	{
@@ -91,6 +153,119 @@ void FAudio_INTERNAL_MixCallback(void *userdata, Uint8 *stream, int len)
 	}
 }
 
+/* Render-ahead Thread */
+
+static int32_t FAUDIOCALL FAudio_INTERNAL_RenderThread(void *data)
+{
+	FAudioPlatformDevice *device = (FAudioPlatformDevice*) data;
+	uint32_t ringWrite = 0;
+	float *output;
+	FAudioThreadScheduler scheduler;
+
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+	FAudio_zero(&scheduler, sizeof(scheduler));
+	while (1)
+	{
+		SDL_SemWait(device->ringSpace);
+		if (SDL_AtomicGet(&device->renderQuit))
+		{
+			break;
+		}
+		FAudio_INTERNAL_ApplyThreadSchedule(
+			&device->audio->threadSchedules[FAUDIO_THREAD_MIX_EXT],
+			&scheduler,
+			FAUDIO_THREAD_PRIORITY_HIGH
+		);
+
+		output = (float*) (device->ring + ringWrite * device->periodBytes);
+		FAudio_zero(output, device->periodBytes);
+		if (device->audio->active)
+		{
+			FAudio_INTERNAL_UpdateEngine(device->audio, output);
+		}
+		ringWrite = (ringWrite + 1) % device->ringCount;
+		SDL_AtomicAdd(&device->ringFilled, 1);
+	}
+	return 0;
+}
+
+void FAudio_INTERNAL_RingCallback(void *userdata, Uint8 *stream, int len)
+{
+	FAudioPlatformDevice *device = (FAudioPlatformDevice*) userdata;
+
+	/* Render thread fell behind, all we can do is play silence */
+	if (SDL_AtomicGet(&device->ringFilled) == 0)
+	{
+		FAudio_zero(stream, len);
+		device->audio->renderUnderruns += 1;
+		return;
+	}
+
+	FAudio_memcpy(
+		stream,
+		device->ring + device->ringRead * device->periodBytes,
+		FAudio_min((uint32_t) len, device->periodBytes)
+	);
+	device->ringRead = (device->ringRead + 1) % device->ringCount;
+	SDL_AtomicAdd(&device->ringFilled, -1);
+	SDL_SemPost(device->ringSpace);
+}
+
+/* Native Device */
+
+#ifdef HAVE_ALSA
+static uint8_t FAudio_INTERNAL_UseALSA()
+{
+	/* ALSA unless the app or user asked for SDL's device instead */
+	const char *driver = SDL_getenv("FAUDIO_DRIVER");
+	return driver == NULL || SDL_strcmp(driver, "alsa") == 0;
+}
+
+static uint8_t FAudio_INTERNAL_OpenALSA(
+	FAudio *audio,
+	FAudioPlatformDevice *device,
+	uint32_t deviceIndex
+) {
+	uint32_t channels = audio->master->master.inputChannels;
+	uint32_t rate = audio->master->master.inputSampleRate;
+	uint32_t period = audio->devicePeriod;
+	uint32_t format = audio->deviceFormatRequest;
+	uint32_t latency;
+
+	device->alsa = FAudio_ALSA_Open(
+		audio,
+		deviceIndex,
+		&channels,
+		&rate,
+		&period,
+		&format,
+		&latency
+	);
+	if (device->alsa == NULL)
+	{
+		return 0;
+	}
+
+	/* The engine mixes straight into the device buffer, so the ALSA
+	 * buffer is all the latency there is, render-ahead periods included.
+	 */
+	WriteWaveFormatExtensible(&device->format, channels, rate);
+	device->bufferSize = period;
+	audio->updateSize = period;
+	audio->deviceLatency = latency;
+	audio->mixFormat = &device->format;
+	audio->master->master.inputChannels = channels;
+	audio->master->master.inputSampleRate = rate;
+	audio->renderUnderruns = 0;
+	audio->lateCallbacks = 0;
+	audio->platform = device;
+	FAudio_INTERNAL_SetDeviceFormat(audio, format);
+
+	FAudio_ALSA_Start(device->alsa);
+	return 1;
+}
+#endif /* HAVE_ALSA */
+
 /* Platform Functions */
 
 void FAudio_PlatformAddRef()
@@ -102,8 +277,15 @@ void FAudio_PlatformAddRef()
 	}
 	FAudio_INTERNAL_InitSIMDFunctions(
 		SDL_HasSSE2(),
+		SDL_HasAVX2(),
 		SDL_HasNEON()
 	);
+#ifndef FAUDIO_DISABLE_LOCK_STATS
+	if (mixThreadTLS == 0)
+	{
+		mixThreadTLS = SDL_TLSCreate();
+	}
+#endif /* FAUDIO_DISABLE_LOCK_STATS */
 }
 
 void FAudio_PlatformRelease()
@@ -112,41 +294,150 @@ void FAudio_PlatformRelease()
 	SDL_QuitSubSystem(SDL_INIT_AUDIO);
 }
 
+static uint32_t FAudio_INTERNAL_GetDeviceFormat(SDL_AudioFormat format)
+{
+	if (format == AUDIO_F32SYS)
+	{
+		return FAUDIO_DEVICE_FORMAT_F32_EXT;
+	}
+	if (format == AUDIO_S16SYS)
+	{
+		return FAUDIO_DEVICE_FORMAT_S16_EXT;
+	}
+	if (format == AUDIO_S32SYS)
+	{
+		return FAUDIO_DEVICE_FORMAT_S32_EXT;
+	}
+	return FAUDIO_DEVICE_FORMAT_DEFAULT_EXT; /* Not one we convert to */
+}
+
 void FAudio_PlatformInit(FAudio *audio, uint32_t deviceIndex)
 {
 	FAudioPlatformDevice *device;
 	SDL_AudioSpec want, have;
+	const char *deviceName;
+	int allowedChanges;
+	uint32_t format;
 
 	/* Allocate a new device container*/
-	device = (FAudioPlatformDevice*) audio->pMalloc(
+	device = (FAudioPlatformDevice*) FAudio_INTERNAL_Malloc(
+		audio,
 		sizeof(FAudioPlatformDevice)
 	);
+	FAudio_zero(device, sizeof(FAudioPlatformDevice));
+	device->audio = audio;
 
-	/* Build the device format */
+	/* Offline render has no device, the client pulls each period */
+	if (audio->offline)
+	{
+		WriteWaveFormatExtensible(
+			&device->format,
+			audio->master->master.inputChannels,
+			audio->master->master.inputSampleRate
+		);
+		device->bufferSize = (audio->devicePeriod == 0) ?
+			1024 :
+			audio->devicePeriod;
+		audio->updateSize = device->bufferSize;
+		audio->deviceLatency = 0;
+		audio->mixFormat = &device->format;
+		FAudio_INTERNAL_SetDeviceFormat(audio, FAUDIO_DEVICE_FORMAT_F32_EXT);
+		audio->platform = device;
+		return;
+	}
+
+	/* A new device has a new thread, which has to schedule itself again */
+	FAudio_zero(&audio->mixScheduler, sizeof(FAudioThreadScheduler));
+
+#ifdef HAVE_ALSA
+	if (FAudio_INTERNAL_UseALSA())
+	{
+		if (FAudio_INTERNAL_OpenALSA(audio, device, deviceIndex))
+		{
+			return;
+		}
+
+		/* ALSA's device indices aren't SDL's, the default will have to do */
+		SDL_Log("ALSA device failed, falling back to SDL\n");
+		deviceIndex = 0;
+	}
+#endif /* HAVE_ALSA */
+
+	/* Build the device format. By default, devices that can't take float
+	 * get their own format, which GenerateOutput converts to. SDL2 has no
+	 * 24-bit format, so that gets 32-bit instead.
+	 */
 	want.freq = audio->master->master.inputSampleRate;
-	want.format = AUDIO_F32;
+	if (audio->deviceFormatRequest == FAUDIO_DEVICE_FORMAT_S16_EXT)
+	{
+		want.format = AUDIO_S16SYS;
+	}
+	else if (	audio->deviceFormatRequest == FAUDIO_DEVICE_FORMAT_S24_EXT ||
+			audio->deviceFormatRequest == FAUDIO_DEVICE_FORMAT_S32_EXT	)
+	{
+		want.format = AUDIO_S32SYS;
+	}
+	else
+	{
+		want.format = AUDIO_F32SYS;
+	}
 	want.channels = audio->master->master.inputChannels;
 	want.silence = 0;
-	want.samples = 1024;
-	want.callback = FAudio_INTERNAL_MixCallback;
-	want.userdata = audio;
+	want.samples = (audio->devicePeriod == 0) ?
+		1024 :
+		(Uint16) FAudio_min(audio->devicePeriod, 32768);
+	if (audio->renderAhead > 0)
+	{
+		want.callback = FAudio_INTERNAL_RingCallback;
+		want.userdata = device;
+	}
+	else
+	{
+		want.callback = FAudio_INTERNAL_MixCallback;
+		want.userdata = device;
+	}
 
 	/* Open the device, finally. */
-	device->device = SDL_OpenAudioDevice(
-		deviceIndex > 0 ? SDL_GetAudioDeviceName(deviceIndex - 1, 0) : NULL,
-		0,
-		&want,
-		&have,
+	deviceName = (deviceIndex > 0) ?
+		SDL_GetAudioDeviceName(deviceIndex - 1, 0) :
+		NULL;
 #if SDL_VERSION_ATLEAST(2, 0, 9)
-		SDL_AUDIO_ALLOW_SAMPLES_CHANGE
+	allowedChanges = SDL_AUDIO_ALLOW_SAMPLES_CHANGE;
 #else
 #warning Please update to SDL 2.0.9 ASAP!
-		0
+	allowedChanges = 0;
 #endif
+	device->device = SDL_OpenAudioDevice(
+		deviceName,
+		0,
+		&want,
+		&have,
+		allowedChanges | (
+			(audio->deviceFormatRequest == FAUDIO_DEVICE_FORMAT_DEFAULT_EXT) ?
+				SDL_AUDIO_ALLOW_FORMAT_CHANGE :
+				0
+		)
 	);
+	format = (device->device != 0) ?
+		FAudio_INTERNAL_GetDeviceFormat(have.format) :
+		FAUDIO_DEVICE_FORMAT_F32_EXT;
+	if (format == FAUDIO_DEVICE_FORMAT_DEFAULT_EXT)
+	{
+		/* The device wants something like U8, let SDL convert to it */
+		SDL_CloseAudioDevice(device->device);
+		want.format = AUDIO_F32SYS;
+		device->device = SDL_OpenAudioDevice(
+			deviceName,
+			0,
+			&want,
+			&have,
+			allowedChanges
+		);
+		format = FAUDIO_DEVICE_FORMAT_F32_EXT;
+	}
 	if (device->device == 0)
 	{
-		audio->pFree(device);
+		FAudio_INTERNAL_Free(audio, device);
 		SDL_Log("OpenAudioDevice failed: %s\n", SDL_GetError());
 		FAudio_assert(0 && "Failed to open audio device!");
 		return;
@@ -158,12 +449,50 @@ void FAudio_PlatformInit(FAudio *audio, uint32_t deviceIndex)
 
 	/* Give the output format to the engine */
 	audio->updateSize = device->bufferSize;
+	audio->deviceLatency = 2 * device->bufferSize; /* Ours, plus SDL's */
 	audio->mixFormat = &device->format;
 
 	/* Also give some info to the master voice */
 	audio->master->master.inputChannels = have.channels;
 	audio->master->master.inputSampleRate = have.freq;
 
+	/* The engine converts to the device's format itself */
+	device->periodBytes = FAudio_INTERNAL_SetDeviceFormat(
+		audio,
+		format
+	) * device->bufferSize * have.channels;
+
+	/* Render-ahead starts with a full ring of silence, so the first
+	 * periods are covered while the render thread gets going.
+	 */
+	audio->renderUnderruns = 0;
+	audio->lateCallbacks = 0;
+	device->lateCallback = (
+		2 * SDL_GetPerformanceFrequency() *
+		device->bufferSize / have.freq
+	);
+	if (audio->renderAhead > 0)
+	{
+		device->ringCount = audio->renderAhead;
+		device->ring = (uint8_t*) FAudio_INTERNAL_Malloc(
+			audio,
+			device->ringCount * device->periodBytes
+		);
+		FAudio_zero(
+			device->ring,
+			device->ringCount * device->periodBytes
+		);
+		SDL_AtomicSet(&device->ringFilled, (int) device->ringCount);
+		device->ringSpace = SDL_CreateSemaphore(0);
+		device->renderThread = FAudio_PlatformCreateThread(
+			FAudio_INTERNAL_RenderThread,
+			"FAudio Render",
+			device
+		);
+		FAudio_assert(device->renderThread != NULL);
+		audio->deviceLatency += device->ringCount * device->bufferSize;
+	}
+
 	/* Start the thread! */
 	SDL_PauseAudioDevice(device->device, 0);
 
@@ -173,15 +502,39 @@ void FAudio_PlatformInit(FAudio *audio, uint32_t deviceIndex)
 void FAudio_PlatformQuit(FAudio *audio)
 {
 	FAudioPlatformDevice *device = audio->platform;
-	SDL_CloseAudioDevice(
-		device->device
-	);
-	audio->pFree(device);
+	int32_t retval;
+#ifdef HAVE_ALSA
+	if (device->alsa != NULL)
+	{
+		FAudio_ALSA_Close(device->alsa);
+	}
+#endif /* HAVE_ALSA */
+	if (device->device != 0)
+	{
+		SDL_CloseAudioDevice(
+			device->device
+		);
+	}
+	if (device->renderThread != NULL)
+	{
+		SDL_AtomicSet(&device->renderQuit, 1);
+		SDL_SemPost(device->ringSpace);
+		FAudio_PlatformWaitThread(device->renderThread, &retval);
+		SDL_DestroySemaphore(device->ringSpace);
+		FAudio_INTERNAL_Free(audio, device->ring);
+	}
+	FAudio_INTERNAL_Free(audio, device);
 	audio->platform = NULL;
 }
 
 uint32_t FAudio_PlatformGetDeviceCount()
 {
+#ifdef HAVE_ALSA
+	if (FAudio_INTERNAL_UseALSA())
+	{
+		return FAudio_ALSA_GetDeviceCount();
+	}
+#endif /* HAVE_ALSA */
 	return SDL_GetNumAudioDevices(0) + 1;
 }
 
@@ -193,6 +546,9 @@ void FAudio_PlatformGetDeviceDetails(
 ) {
 	const char *name, *envvar;
 	int channels, rate;
+#ifdef HAVE_ALSA
+	char alsaName[256] = "";
+#endif /* HAVE_ALSA */
 
 	FAudio_zero(details, sizeof(FAudioDeviceDetails));
 	if (index > FAudio_PlatformGetDeviceCount())
@@ -208,7 +564,24 @@ void FAudio_PlatformGetDeviceDetails(
 	}
 	else
 	{
+#ifdef HAVE_ALSA
+		if (FAudio_INTERNAL_UseALSA())
+		{
+			FAudio_ALSA_GetDeviceName(
+				index,
+				1,
+				alsaName,
+				sizeof(alsaName)
+			);
+			name = alsaName;
+		}
+		else
+		{
+			name = SDL_GetAudioDeviceName(index - 1, 0);
+		}
+#else
 		name = SDL_GetAudioDeviceName(index - 1, 0);
+#endif /* HAVE_ALSA */
 		details->Role = FAudioNotDefaultDevice;
 	}
 	FAudio_UTF8_To_UTF16(
@@ -231,42 +604,6 @@ void FAudio_PlatformGetDeviceDetails(
 	WriteWaveFormatExtensible(&details->OutputFormat, channels, rate);
 }
 
-FAudioPlatformFixedRateSRC FAudio_PlatformInitFixedRateSRC(
-	uint32_t channels,
-	uint32_t inputRate,
-	uint32_t outputRate
-) {
-	return (FAudioPlatformFixedRateSRC) SDL_NewAudioStream(
-		AUDIO_F32,
-		channels,
-		inputRate,
-		AUDIO_F32,
-		channels,
-		outputRate
-	);
-}
-
-void FAudio_PlatformCloseFixedRateSRC(FAudioPlatformFixedRateSRC resampler)
-{
-	SDL_FreeAudioStream((SDL_AudioStream*) resampler);
-}
-
-uint32_t FAudio_PlatformResample(
-	FAudioPlatformFixedRateSRC resampler,
-	float *input,
-	uint32_t inLen,
-	float *output,
-	uint32_t outLen
-) {
-	SDL_AudioStream *stream = (SDL_AudioStream*) resampler;
-	SDL_AudioStreamPut(stream, input, inLen * sizeof(float));
-	return SDL_AudioStreamGet(
-		stream,
-		output,
-		outLen * sizeof(float)
-	) / sizeof(float);
-}
-
 /* Threading */
 
 FAudioThread FAudio_PlatformCreateThread(
@@ -291,11 +628,290 @@ void FAudio_PlatformThreadPriority(FAudioThreadPriority priority)
 	SDL_SetThreadPriority((SDL_ThreadPriority) priority);
 }
 
+#ifdef _WIN32
+typedef HANDLE (WINAPI *AvSetMmThreadCharacteristicsFunc)(LPCWSTR, LPDWORD);
+typedef BOOL (WINAPI *AvRevertMmThreadCharacteristicsFunc)(HANDLE);
+static AvSetMmThreadCharacteristicsFunc pAvSetMmThreadCharacteristicsW;
+static AvRevertMmThreadCharacteristicsFunc pAvRevertMmThreadCharacteristics;
+
+static void FAudio_INTERNAL_LoadAVRT()
+{
+	/* Never unloaded, MMCSS tasks would outlive it */
+	static volatile int32_t loaded = 0;
+	HMODULE avrt;
+	if (FAudio_PlatformAtomicGet(&loaded))
+	{
+		return;
+	}
+	avrt = LoadLibraryW(L"avrt.dll");
+	if (avrt != NULL)
+	{
+		pAvSetMmThreadCharacteristicsW = (AvSetMmThreadCharacteristicsFunc)
+			GetProcAddress(avrt, "AvSetMmThreadCharacteristicsW");
+		pAvRevertMmThreadCharacteristics = (AvRevertMmThreadCharacteristicsFunc)
+			GetProcAddress(avrt, "AvRevertMmThreadCharacteristics");
+	}
+	FAudio_PlatformAtomicCompareExchange(&loaded, 0, 1);
+}
+#endif /* _WIN32 */
+
+#if defined(__linux__) && defined(SDL_HINT_THREAD_FORCE_REALTIME_TIME_CRITICAL)
+static uint8_t FAudio_INTERNAL_RealtimeKit()
+{
+	/* SDL only asks RealtimeKit for TIME_CRITICAL threads with this hint.
+	 * It's the application's hint too, so put it back afterwards.
+	 */
+	const char *hint = SDL_GetHint(SDL_HINT_THREAD_FORCE_REALTIME_TIME_CRITICAL);
+	char *old = (hint != NULL) ? SDL_strdup(hint) : NULL;
+	int result;
+
+	SDL_SetHint(SDL_HINT_THREAD_FORCE_REALTIME_TIME_CRITICAL, "1");
+	result = SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL);
+	SDL_SetHint(SDL_HINT_THREAD_FORCE_REALTIME_TIME_CRITICAL, old);
+	SDL_free(old);
+	return result == 0;
+}
+#endif
+
+uint32_t FAudio_PlatformThreadScheduling(
+	FAudioThreadScheduler *scheduler,
+	FAudioThreadPriority priority,
+	uint32_t flags,
+	uint64_t affinityMask
+) {
+	uint32_t result = 0;
+#if defined(_WIN32)
+	DWORD taskIndex = 0;
+	DWORD_PTR processMask, systemMask;
+#elif defined(__linux__)
+	struct sched_param param;
+	cpu_set_t set;
+	int cpu;
+#endif
+
+	/* Priority. The token is an MMCSS handle, or the scheduler itself when
+	 * the thread was made realtime some other way.
+	 */
+	if (flags & FAUDIO_THREAD_REALTIME_EXT)
+	{
+		/* Keep what we got last time, or try again */
+		if (scheduler->token == NULL)
+		{
+#if defined(_WIN32)
+			/* MMCSS, the same class WASAPI clients use */
+			FAudio_INTERNAL_LoadAVRT();
+			if (pAvSetMmThreadCharacteristicsW != NULL)
+			{
+				scheduler->token = pAvSetMmThreadCharacteristicsW(
+					L"Pro Audio",
+					&taskIndex
+				);
+			}
+			if (	scheduler->token == NULL &&
+				SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL) == 0	)
+			{
+				/* No MMCSS, not undone with AvRevert */
+				scheduler->token = (void*) scheduler;
+			}
+#elif defined(__linux__)
+			/* SCHED_FIFO needs CAP_SYS_NICE or an RLIMIT_RTPRIO,
+			 * otherwise try RealtimeKit through SDL.
+			 */
+			param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 9;
+			if (sched_setscheduler(
+				0,
+#ifdef SCHED_RESET_ON_FORK
+				SCHED_FIFO | SCHED_RESET_ON_FORK,
+#else
+				SCHED_FIFO,
+#endif
+				&param
+			) == 0)
+			{
+				scheduler->token = (void*) scheduler;
+			}
+#ifdef SDL_HINT_THREAD_FORCE_REALTIME_TIME_CRITICAL
+			else if (FAudio_INTERNAL_RealtimeKit())
+			{
+				scheduler->token = (void*) scheduler;
+			}
+#endif
+#else
+			if (SDL_SetThreadPriority(SDL_THREAD_PRIORITY_TIME_CRITICAL) == 0)
+			{
+				scheduler->token = (void*) scheduler;
+			}
+#endif
+		}
+		if (scheduler->token != NULL)
+		{
+			result |= FAUDIO_THREAD_REALTIME_EXT;
+		}
+	}
+	else if (scheduler->token != NULL)
+	{
+#if defined(_WIN32)
+		if (scheduler->token != (void*) scheduler)
+		{
+			pAvRevertMmThreadCharacteristics((HANDLE) scheduler->token);
+		}
+#elif defined(__linux__)
+		param.sched_priority = 0;
+		sched_setscheduler(0, SCHED_OTHER, &param);
+#endif
+		scheduler->token = NULL;
+		SDL_SetThreadPriority((SDL_ThreadPriority) priority);
+	}
+
+	/* Affinity */
+	if (affinityMask != 0 || scheduler->affinityMask != 0)
+	{
+#if defined(_WIN32)
+		/* Only within this thread's processor group */
+		if (affinityMask == 0)
+		{
+			GetProcessAffinityMask(
+				GetCurrentProcess(),
+				&processMask,
+				&systemMask
+			);
+			SetThreadAffinityMask(GetCurrentThread(), processMask);
+		}
+		else if (SetThreadAffinityMask(
+			GetCurrentThread(),
+			(DWORD_PTR) affinityMask
+		) != 0) {
+			result |= FAUDIO_THREAD_AFFINITY_EXT;
+		}
+#elif defined(__linux__)
+		/* No mask means every CPU, which the kernel trims to our cpuset */
+		CPU_ZERO(&set);
+		for (cpu = 0; cpu < CPU_SETSIZE; cpu += 1)
+		{
+			if (	affinityMask == 0 ||
+				(cpu < 64 && (affinityMask & ((uint64_t) 1 << cpu)))	)
+			{
+				CPU_SET(cpu, &set);
+			}
+		}
+		if (	sched_setaffinity(0, sizeof(set), &set) == 0 &&
+			affinityMask != 0	)
+		{
+			result |= FAUDIO_THREAD_AFFINITY_EXT;
+		}
+#endif
+	}
+
+	scheduler->flags = flags;
+	scheduler->affinityMask = affinityMask;
+	return result;
+}
+
 uint64_t FAudio_PlatformGetThreadID()
 {
 	return (uint64_t) SDL_ThreadID();
 }
 
+#ifndef FAUDIO_DISABLE_LOCK_STATS
+
+/* Each mutex keeps its own LockStatsEXT counters. They're only written by
+ * the thread that just got the mutex, so they need no locking of their own.
+ */
+typedef struct FAudioPlatformMutex
+{
+	SDL_mutex *mutex;
+	FAudioLockStatsEXT stats;
+} FAudioPlatformMutex;
+
+FAudioMutex FAudio_PlatformCreateMutex()
+{
+	FAudioPlatformMutex *result = (FAudioPlatformMutex*) SDL_malloc(
+		sizeof(FAudioPlatformMutex)
+	);
+	result->mutex = SDL_CreateMutex();
+	FAudio_zero(&result->stats, sizeof(FAudioLockStatsEXT));
+	return (FAudioMutex) result;
+}
+
+void FAudio_PlatformDestroyMutex(FAudioMutex mutex)
+{
+	FAudioPlatformMutex *platformMutex = (FAudioPlatformMutex*) mutex;
+	if (platformMutex == NULL)
+	{
+		return;
+	}
+	SDL_DestroyMutex(platformMutex->mutex);
+	SDL_free(platformMutex);
+}
+
+void FAudio_PlatformLockMutex(FAudioMutex mutex)
+{
+	FAudioPlatformMutex *platformMutex = (FAudioPlatformMutex*) mutex;
+	uint64_t start, wait;
+
+	/* Same as SDL_LockMutex(NULL) */
+	if (platformMutex == NULL)
+	{
+		return;
+	}
+
+	/* Only waits have to be timed, so try first */
+	if (SDL_TryLockMutex(platformMutex->mutex) != 0)
+	{
+		start = FAudio_timecycles();
+		SDL_LockMutex(platformMutex->mutex);
+		wait = FAudio_timecycles() - start;
+
+		platformMutex->stats.ContendedAcquisitions += 1;
+		platformMutex->stats.WaitCycles += wait;
+		if (wait > platformMutex->stats.MaxWaitCycles)
+		{
+			platformMutex->stats.MaxWaitCycles = wait;
+		}
+		if (SDL_TLSGet(mixThreadTLS) != NULL)
+		{
+			platformMutex->stats.MixerContendedAcquisitions += 1;
+			platformMutex->stats.MixerWaitCycles += wait;
+		}
+	}
+	platformMutex->stats.Acquisitions += 1;
+}
+
+void FAudio_PlatformUnlockMutex(FAudioMutex mutex)
+{
+	FAudioPlatformMutex *platformMutex = (FAudioPlatformMutex*) mutex;
+	if (platformMutex == NULL)
+	{
+		return;
+	}
+	SDL_UnlockMutex(platformMutex->mutex);
+}
+
+void FAudio_PlatformGetMutexStats(FAudioMutex mutex, FAudioLockStatsEXT *stats)
+{
+	FAudioPlatformMutex *platformMutex = (FAudioPlatformMutex*) mutex;
+	if (platformMutex == NULL)
+	{
+		return;
+	}
+	stats->Acquisitions += platformMutex->stats.Acquisitions;
+	stats->ContendedAcquisitions += platformMutex->stats.ContendedAcquisitions;
+	stats->WaitCycles += platformMutex->stats.WaitCycles;
+	stats->MaxWaitCycles = FAudio_max(
+		stats->MaxWaitCycles,
+		platformMutex->stats.MaxWaitCycles
+	);
+	stats->MixerContendedAcquisitions += platformMutex->stats.MixerContendedAcquisitions;
+	stats->MixerWaitCycles += platformMutex->stats.MixerWaitCycles;
+}
+
+void FAudio_PlatformSetMixThread(uint8_t mixing)
+{
+	SDL_TLSSet(mixThreadTLS, mixing ? (void*) 1 : NULL, NULL);
+}
+
+#else
+
 FAudioMutex FAudio_PlatformCreateMutex()
 {
 	return (FAudioMutex) SDL_CreateMutex();
@@ -316,11 +932,77 @@ void FAudio_PlatformUnlockMutex(FAudioMutex mutex)
 	SDL_UnlockMutex((SDL_mutex*) mutex);
 }
 
+void FAudio_PlatformGetMutexStats(FAudioMutex mutex, FAudioLockStatsEXT *stats)
+{
+	/* No stats in this build */
+	(void) mutex;
+	(void) stats;
+}
+
+void FAudio_PlatformSetMixThread(uint8_t mixing)
+{
+	(void) mixing;
+}
+
+#endif /* FAUDIO_DISABLE_LOCK_STATS */
+
+FAudioSemaphore FAudio_PlatformCreateSemaphore(uint32_t initialValue)
+{
+	return (FAudioSemaphore) SDL_CreateSemaphore(initialValue);
+}
+
+void FAudio_PlatformDestroySemaphore(FAudioSemaphore semaphore)
+{
+	SDL_DestroySemaphore((SDL_sem*) semaphore);
+}
+
+void FAudio_PlatformWaitSemaphore(FAudioSemaphore semaphore)
+{
+	SDL_SemWait((SDL_sem*) semaphore);
+}
+
+uint8_t FAudio_PlatformWaitSemaphoreTimeout(
+	FAudioSemaphore semaphore,
+	uint32_t timeoutMS
+) {
+	return SDL_SemWaitTimeout((SDL_sem*) semaphore, timeoutMS) == 0;
+}
+
+void FAudio_PlatformPostSemaphore(FAudioSemaphore semaphore)
+{
+	SDL_SemPost((SDL_sem*) semaphore);
+}
+
+uint32_t FAudio_PlatformGetProcessorCount()
+{
+	return (uint32_t) SDL_GetCPUCount();
+}
+
 void FAudio_sleep(uint32_t ms)
 {
 	SDL_Delay(ms);
 }
 
+/* Atomics */
+
+int32_t FAudio_PlatformAtomicGet(volatile int32_t *value)
+{
+	return SDL_AtomicGet((SDL_atomic_t*) value);
+}
+
+int32_t FAudio_PlatformAtomicAdd(volatile int32_t *value, int32_t add)
+{
+	return SDL_AtomicAdd((SDL_atomic_t*) value, add);
+}
+
+uint8_t FAudio_PlatformAtomicCompareExchange(
+	volatile int32_t *value,
+	int32_t oldValue,
+	int32_t newValue
+) {
+	return SDL_AtomicCAS((SDL_atomic_t*) value, oldValue, newValue);
+}
+
 /* Time */
 
 uint32_t FAudio_timems()
@@ -328,6 +1010,31 @@ uint32_t FAudio_timems()
 	return SDL_GetTicks();
 }
 
+uint64_t FAudio_timecycles()
+{
+	/* The TSC where we can read it directly, it's both the cheapest clock
+	 * and the one XAudio2 counts in
+	 */
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+	return __rdtsc();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	return __builtin_ia32_rdtsc();
+#else
+	return SDL_GetPerformanceCounter();
+#endif
+}
+
+uint64_t FAudio_timeus()
+{
+	/* Split so the multiply can't overflow for fast counters */
+	uint64_t counter = SDL_GetPerformanceCounter();
+	uint64_t frequency = SDL_GetPerformanceFrequency();
+	return (
+		(counter / frequency) * 1000000 +
+		(counter % frequency) * 1000000 / frequency
+	);
+}
+
 /* FAudio I/O */
 
 FAudioIOStream* FAudio_fopen(const char *path)
@@ -358,10 +1065,111 @@ FAudioIOStream* FAudio_memopen(void *mem, int len)
 	return io;
 }
 
+static int FAUDIOCALL FAudio_INTERNAL_mmapclose(void *data)
+{
+	SDL_RWops *rwops = (SDL_RWops*) data;
+	void *base = rwops->hidden.mem.base;
+	size_t size = rwops->hidden.mem.stop - rwops->hidden.mem.base;
+
+	SDL_RWclose(rwops);
+#ifdef _WIN32
+	(void) size;
+	UnmapViewOfFile(base);
+#else
+	munmap(base, size);
+#endif
+	return 0;
+}
+
+FAudioIOStream* FAudio_mmapopen(const char *path)
+{
+	FAudioIOStream *io;
+	SDL_RWops *rwops;
+	void *base;
+	size_t size;
+#ifdef _WIN32
+	uint16_t widePath[MAX_PATH];
+	HANDLE file, mapping;
+	LARGE_INTEGER fileSize;
+
+	FAudio_UTF8_To_UTF16(path, widePath, sizeof(widePath));
+	file = CreateFileW(
+		(LPCWSTR) widePath,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL
+	);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return NULL;
+	}
+	if (	!GetFileSizeEx(file, &fileSize) ||
+		fileSize.QuadPart == 0 ||
+		fileSize.QuadPart > SDL_MAX_SINT32	)
+	{
+		CloseHandle(file);
+		return NULL;
+	}
+	size = (size_t) fileSize.QuadPart;
+
+	/* The view keeps the mapping and the file open */
+	mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL)
+	{
+		return NULL;
+	}
+	base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (base == NULL)
+	{
+		return NULL;
+	}
+#else
+	struct stat st;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		return NULL;
+	}
+	if (	fstat(fd, &st) < 0 ||
+		st.st_size == 0 ||
+		st.st_size > SDL_MAX_SINT32	)
+	{
+		close(fd);
+		return NULL;
+	}
+	size = (size_t) st.st_size;
+
+	/* Shared, so that every process playing this file uses the same pages */
+	base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+	{
+		return NULL;
+	}
+#endif
+
+	io = (FAudioIOStream*) FAudio_malloc(sizeof(FAudioIOStream));
+	rwops = SDL_RWFromConstMem(base, (int) size);
+	io->data = rwops;
+	io->read = (FAudio_readfunc) rwops->read;
+	io->seek = (FAudio_seekfunc) rwops->seek;
+	io->close = FAudio_INTERNAL_mmapclose;
+	io->lock = FAudio_PlatformCreateMutex();
+	return io;
+}
+
 uint8_t* FAudio_memptr(FAudioIOStream *io, size_t offset)
 {
 	SDL_RWops *rwops = (SDL_RWops*) io->data;
-	FAudio_assert(rwops->type == SDL_RWOPS_MEMORY);
+	FAudio_assert(	rwops->type == SDL_RWOPS_MEMORY ||
+			rwops->type == SDL_RWOPS_MEMORY_RO	);
 	return rwops->hidden.mem.base + offset;
 }
 
@@ -372,6 +1180,42 @@ void FAudio_close(FAudioIOStream *io)
 	FAudio_free(io);
 }
 
+void FAudio_PlatformWillNeed(const void *ptr, size_t len)
+{
+#ifdef _WIN32
+	/* PrefetchVirtualMemory is Windows 8+, let the pages fault in */
+	(void) ptr;
+	(void) len;
+#else
+	/* madvise wants a page-aligned start */
+	size_t page = (size_t) sysconf(_SC_PAGESIZE);
+	size_t start = (size_t) ptr & ~(page - 1);
+	madvise(
+		(void*) start,
+		((size_t) ptr + len) - start,
+		MADV_WILLNEED
+	);
+#endif
+}
+
+void* FAudio_PlatformOpenWriteFile(const char *path)
+{
+	return SDL_RWFromFile(path, "wb");
+}
+
+size_t FAUDIOCALL FAudio_PlatformWriteFile(
+	void *file,
+	const void *data,
+	size_t size
+) {
+	return SDL_RWwrite((SDL_RWops*) file, data, 1, size);
+}
+
+void FAudio_PlatformCloseWriteFile(void *file)
+{
+	SDL_RWclose((SDL_RWops*) file);
+}
+
 /* UTF8->UTF16 Conversion, taken from PhysicsFS */
 
 #define UNICODE_BOGUS_CHAR_VALUE 0xFFFFFFFF
@@ -0,0 +1,504 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2018 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+#include "FAudio_internal.h"
+
+/* Built-in Task Pool */
+
+static void FAudio_INTERNAL_InsertTask(
+	FAudioPoolTask **list,
+	FAudioPoolTask *task,
+	uint8_t byStart
+) {
+	/* After any task with the same time, so ties run in submission order */
+	if (byStart)
+	{
+		while (*list != NULL && (*list)->start <= task->start)
+		{
+			list = &(*list)->next;
+		}
+	}
+	else
+	{
+		while (*list != NULL && (*list)->deadline <= task->deadline)
+		{
+			list = &(*list)->next;
+		}
+	}
+	task->next = *list;
+	*list = task;
+}
+
+static int32_t FAUDIOCALL FAudio_INTERNAL_TaskPoolThread(void *data)
+{
+	FAudioTaskPoolEXT *pool = (FAudioTaskPoolEXT*) data;
+	FAudioPoolTask *task;
+	FAudioTaskFuncEXT func;
+	void *taskData;
+	uint64_t now;
+	uint32_t wait;
+
+	/* Mix tasks run here, so this has to keep up with the audio thread */
+	FAudio_PlatformThreadPriority(FAUDIO_THREAD_PRIORITY_HIGH);
+
+	FAudio_PlatformLockMutex(pool->lock);
+	while (!pool->quit)
+	{
+		now = FAudio_timeus();
+		while (pool->delayed != NULL && pool->delayed->start <= now)
+		{
+			task = pool->delayed;
+			pool->delayed = task->next;
+			FAudio_INTERNAL_InsertTask(&pool->ready, task, 0);
+		}
+
+		/* Earliest deadline first, whichever engine it's for */
+		task = pool->ready;
+		if (task == NULL)
+		{
+			if (pool->delayed == NULL)
+			{
+				FAudio_PlatformUnlockMutex(pool->lock);
+				FAudio_PlatformWaitSemaphore(pool->wake);
+			}
+			else
+			{
+				wait = (uint32_t) ((pool->delayed->start - now + 999) / 1000);
+				FAudio_PlatformUnlockMutex(pool->lock);
+				FAudio_PlatformWaitSemaphoreTimeout(pool->wake, wait);
+			}
+			FAudio_PlatformLockMutex(pool->lock);
+			continue;
+		}
+		pool->ready = task->next;
+		func = task->func;
+		taskData = task->data;
+		task->next = pool->freeTasks;
+		pool->freeTasks = task;
+		FAudio_PlatformUnlockMutex(pool->lock);
+
+		func(taskData);
+
+		FAudio_PlatformLockMutex(pool->lock);
+	}
+	FAudio_PlatformUnlockMutex(pool->lock);
+	return 0;
+}
+
+static void FAUDIOCALL FAudio_INTERNAL_TaskPoolSubmit(
+	void *user,
+	FAudioTaskFuncEXT func,
+	void *data,
+	uint32_t delayUs,
+	uint32_t deadlineUs
+) {
+	FAudioTaskPoolEXT *pool = (FAudioTaskPoolEXT*) user;
+	FAudioPoolTask *task;
+	uint64_t now = FAudio_timeus();
+
+	FAudio_PlatformLockMutex(pool->lock);
+	task = pool->freeTasks;
+	if (task != NULL)
+	{
+		pool->freeTasks = task->next;
+	}
+	else
+	{
+		/* Only until the pool has seen its busiest pass */
+		task = (FAudioPoolTask*) FAudio_malloc(sizeof(FAudioPoolTask));
+	}
+	task->func = func;
+	task->data = data;
+	task->start = now + delayUs;
+	task->deadline = now + FAudio_max(delayUs, deadlineUs);
+	FAudio_INTERNAL_InsertTask(
+		(delayUs > 0) ? &pool->delayed : &pool->ready,
+		task,
+		delayUs > 0
+	);
+	FAudio_PlatformUnlockMutex(pool->lock);
+	FAudio_PlatformPostSemaphore(pool->wake);
+}
+
+static uint32_t FAudio_INTERNAL_RemoveTasks(
+	FAudioPoolTask **list,
+	FAudioPoolTask **freeTasks,
+	FAudioTaskFuncEXT func,
+	void *data
+) {
+	FAudioPoolTask *task;
+	uint32_t removed = 0;
+
+	while (*list != NULL)
+	{
+		task = *list;
+		if (task->func == func && task->data == data)
+		{
+			*list = task->next;
+			task->next = *freeTasks;
+			*freeTasks = task;
+			removed += 1;
+		}
+		else
+		{
+			list = &task->next;
+		}
+	}
+	return removed;
+}
+
+static void FAudio_INTERNAL_FreeTaskList(FAudioPoolTask *task)
+{
+	FAudioPoolTask *next;
+	while (task != NULL)
+	{
+		next = task->next;
+		FAudio_free(task);
+		task = next;
+	}
+}
+
+/* Internal Task API */
+
+void FAudio_INTERNAL_SubmitTask(
+	FAudioTaskPoolEXT *pool,
+	FAudioTaskFuncEXT func,
+	void *data,
+	uint32_t delayUs,
+	uint32_t deadlineUs
+) {
+	pool->submit(pool->user, func, data, delayUs, deadlineUs);
+}
+
+uint32_t FAudio_INTERNAL_CancelTasks(
+	FAudioTaskPoolEXT *pool,
+	FAudioTaskFuncEXT func,
+	void *data
+) {
+	uint32_t cancelled;
+
+	/* Custom pools have to run everything they were given */
+	if (pool->threads == NULL)
+	{
+		return 0;
+	}
+
+	FAudio_PlatformLockMutex(pool->lock);
+	cancelled = FAudio_INTERNAL_RemoveTasks(
+		&pool->ready,
+		&pool->freeTasks,
+		func,
+		data
+	);
+	cancelled += FAudio_INTERNAL_RemoveTasks(
+		&pool->delayed,
+		&pool->freeTasks,
+		func,
+		data
+	);
+	FAudio_PlatformUnlockMutex(pool->lock);
+	return cancelled;
+}
+
+/* Pool Loops */
+
+#define FAUDIO_POOL_LOOP_STOPPED	0	/* Waiting for a wake */
+#define FAUDIO_POOL_LOOP_SCHEDULED	1	/* Delayed task submitted */
+#define FAUDIO_POOL_LOOP_QUEUED		2	/* Task submitted to run now */
+#define FAUDIO_POOL_LOOP_RUNNING	3
+#define FAUDIO_POOL_LOOP_RERUN		4	/* Woken while running */
+
+static void FAUDIOCALL FAudio_INTERNAL_PoolLoopTask(void *data);
+
+static void FAudio_INTERNAL_QueuePoolLoop(FAudioPoolLoop *loop, uint32_t delayMs)
+{
+	FAudio_PlatformAtomicAdd(&loop->pending, 1);
+	FAudio_INTERNAL_SubmitTask(
+		loop->pool,
+		FAudio_INTERNAL_PoolLoopTask,
+		loop,
+		delayMs * 1000,
+		delayMs * 1000 + loop->deadlineUs
+	);
+}
+
+static void FAUDIOCALL FAudio_INTERNAL_PoolLoopTask(void *data)
+{
+	FAudioPoolLoop *loop = (FAudioPoolLoop*) data;
+	int32_t state;
+	uint32_t wait;
+
+	/* A wake can leave a delayed task behind, which may now find the step
+	 * already done or running somewhere else
+	 */
+	do
+	{
+		state = FAudio_PlatformAtomicGet(&loop->state);
+		if (	state != FAUDIO_POOL_LOOP_QUEUED &&
+			state != FAUDIO_POOL_LOOP_SCHEDULED	)
+		{
+			FAudio_PlatformAtomicAdd(&loop->pending, -1);
+			return;
+		}
+	} while (!FAudio_PlatformAtomicCompareExchange(
+		&loop->state,
+		state,
+		FAUDIO_POOL_LOOP_RUNNING
+	));
+
+	wait = loop->step(loop->data);
+
+	if (	wait == 0 ||
+		!FAudio_PlatformAtomicCompareExchange(
+			&loop->state,
+			FAUDIO_POOL_LOOP_RUNNING,
+			(wait == FAUDIO_POOL_LOOP_IDLE) ?
+				FAUDIO_POOL_LOOP_STOPPED :
+				FAUDIO_POOL_LOOP_SCHEDULED
+		)	)
+	{
+		/* Nobody else moves it off RUNNING or RERUN, only to RERUN */
+		do
+		{
+			state = FAudio_PlatformAtomicGet(&loop->state);
+		} while (!FAudio_PlatformAtomicCompareExchange(
+			&loop->state,
+			state,
+			FAUDIO_POOL_LOOP_QUEUED
+		));
+		FAudio_INTERNAL_QueuePoolLoop(loop, 0);
+	}
+	else if (wait != FAUDIO_POOL_LOOP_IDLE)
+	{
+		FAudio_INTERNAL_QueuePoolLoop(loop, wait);
+	}
+
+	/* Last, StopPoolLoop frees the loop once this reaches 0 */
+	FAudio_PlatformAtomicAdd(&loop->pending, -1);
+}
+
+void FAudio_INTERNAL_StartPoolLoop(
+	FAudioPoolLoop *loop,
+	FAudioTaskPoolEXT *pool,
+	FAudioPoolLoopStep step,
+	void *data,
+	uint32_t deadlineUs
+) {
+	loop->pool = pool;
+	loop->step = step;
+	loop->data = data;
+	loop->deadlineUs = deadlineUs;
+	loop->state = FAUDIO_POOL_LOOP_STOPPED;
+	loop->pending = 0;
+}
+
+void FAudio_INTERNAL_WakePoolLoop(FAudioPoolLoop *loop)
+{
+	int32_t state;
+
+	while (1)
+	{
+		state = FAudio_PlatformAtomicGet(&loop->state);
+		if (	state == FAUDIO_POOL_LOOP_QUEUED ||
+			state == FAUDIO_POOL_LOOP_RERUN	)
+		{
+			return;
+		}
+		if (state == FAUDIO_POOL_LOOP_RUNNING)
+		{
+			if (FAudio_PlatformAtomicCompareExchange(
+				&loop->state,
+				state,
+				FAUDIO_POOL_LOOP_RERUN
+			)) {
+				return;
+			}
+		}
+		else if (FAudio_PlatformAtomicCompareExchange(
+			&loop->state,
+			state,
+			FAUDIO_POOL_LOOP_QUEUED
+		)) {
+			FAudio_INTERNAL_QueuePoolLoop(loop, 0);
+			return;
+		}
+	}
+}
+
+/* The owner has already told its step to stop, so all that's left is for the
+ * tasks that were submitted to come back. Built-in pools drop the ones that
+ * haven't started, the rest return right away.
+ */
+void FAudio_INTERNAL_StopPoolLoop(FAudioPoolLoop *loop)
+{
+	uint32_t cancelled;
+
+	while (1)
+	{
+		cancelled = FAudio_INTERNAL_CancelTasks(
+			loop->pool,
+			FAudio_INTERNAL_PoolLoopTask,
+			loop
+		);
+		if (cancelled > 0)
+		{
+			FAudio_PlatformAtomicAdd(&loop->pending, -((int32_t) cancelled));
+		}
+		if (FAudio_PlatformAtomicGet(&loop->pending) == 0)
+		{
+			break;
+		}
+		FAudio_sleep(1);
+	}
+	FAudio_zero(loop, sizeof(FAudioPoolLoop));
+}
+
+/* Public API */
+
+uint32_t FAudioCreateTaskPoolEXT(
+	FAudioTaskPoolEXT **ppPool,
+	uint32_t threadCount
+) {
+	FAudioTaskPoolEXT *pool;
+	uint32_t i;
+
+	if (threadCount == 0)
+	{
+		threadCount = FAudio_PlatformGetProcessorCount();
+	}
+
+	FAudio_PlatformAddRef();
+	pool = (FAudioTaskPoolEXT*) FAudio_malloc(sizeof(FAudioTaskPoolEXT));
+	if (pool == NULL)
+	{
+		FAudio_PlatformRelease();
+		*ppPool = NULL;
+		return FAUDIO_E_OUT_OF_MEMORY;
+	}
+	FAudio_zero(pool, sizeof(FAudioTaskPoolEXT));
+	pool->refcount = 1;
+	pool->threadCount = threadCount;
+	pool->submit = FAudio_INTERNAL_TaskPoolSubmit;
+	pool->user = pool;
+	pool->lock = FAudio_PlatformCreateMutex();
+	pool->wake = FAudio_PlatformCreateSemaphore(0);
+	pool->threads = (FAudioThread*) FAudio_malloc(
+		sizeof(FAudioThread) * threadCount
+	);
+	for (i = 0; i < threadCount; i += 1)
+	{
+		pool->threads[i] = FAudio_PlatformCreateThread(
+			FAudio_INTERNAL_TaskPoolThread,
+			"FAudio Task Pool",
+			pool
+		);
+		FAudio_assert(pool->threads[i] != NULL);
+	}
+
+	*ppPool = pool;
+	return 0;
+}
+
+uint32_t FAudioCreateCustomTaskPoolEXT(
+	FAudioTaskPoolEXT **ppPool,
+	uint32_t threadCount,
+	FAudioSubmitTaskFuncEXT submitFunc,
+	void *user
+) {
+	FAudioTaskPoolEXT *pool;
+
+	if (submitFunc == NULL)
+	{
+		*ppPool = NULL;
+		return FAUDIO_E_INVALID_ARG;
+	}
+	if (threadCount == 0)
+	{
+		threadCount = FAudio_PlatformGetProcessorCount();
+	}
+
+	pool = (FAudioTaskPoolEXT*) FAudio_malloc(sizeof(FAudioTaskPoolEXT));
+	if (pool == NULL)
+	{
+		*ppPool = NULL;
+		return FAUDIO_E_OUT_OF_MEMORY;
+	}
+	FAudio_zero(pool, sizeof(FAudioTaskPoolEXT));
+	pool->refcount = 1;
+	pool->threadCount = threadCount;
+	pool->submit = submitFunc;
+	pool->user = user;
+
+	*ppPool = pool;
+	return 0;
+}
+
+uint32_t FAudioTaskPoolEXT_AddRef(FAudioTaskPoolEXT *pool)
+{
+	return FAudio_PlatformAtomicAdd(&pool->refcount, 1) + 1;
+}
+
+uint32_t FAudioTaskPoolEXT_Release(FAudioTaskPoolEXT *pool)
+{
+	uint32_t refcount, i;
+
+	refcount = FAudio_PlatformAtomicAdd(&pool->refcount, -1) - 1;
+	if (refcount > 0)
+	{
+		return refcount;
+	}
+
+	/* Every engine drains its tasks before letting go of the pool, so
+	 * nothing is left queued by now
+	 */
+	if (pool->threads != NULL)
+	{
+		FAudio_PlatformLockMutex(pool->lock);
+		pool->quit = 1;
+		FAudio_PlatformUnlockMutex(pool->lock);
+		for (i = 0; i < pool->threadCount; i += 1)
+		{
+			FAudio_PlatformPostSemaphore(pool->wake);
+		}
+		for (i = 0; i < pool->threadCount; i += 1)
+		{
+			FAudio_PlatformWaitThread(pool->threads[i], NULL);
+		}
+		FAudio_INTERNAL_FreeTaskList(pool->ready);
+		FAudio_INTERNAL_FreeTaskList(pool->delayed);
+		FAudio_INTERNAL_FreeTaskList(pool->freeTasks);
+		FAudio_PlatformDestroySemaphore(pool->wake);
+		FAudio_PlatformDestroyMutex(pool->lock);
+		FAudio_free(pool->threads);
+		FAudio_free(pool);
+		FAudio_PlatformRelease();
+	}
+	else
+	{
+		FAudio_free(pool);
+	}
+	return 0;
+}
@@ -79,36 +79,296 @@
 
 /* Globals */
 
+/* Songs are decoded a tenth of a second at a time by the song thread, into a
+ * ring that's kept queued on the voice. OnBufferEnd runs on the mixer
+ * thread, so all it does is free up a buffer and wake the thread.
+ *
+ * There are two decks, each with a voice that's kept between songs. One
+ * plays the current song, the other is where the next song is prepared and
+ * where the last one fades out during a crossfade.
+ */
+#define SONG_BUFFER_COUNT 4
+#define SONG_BUFFER_DIVISOR 10
+#define SONG_FADE_STEP_MS 10
+
+typedef enum XNA_SongDeckState
+{
+	SONG_DECK_IDLE,
+	SONG_DECK_PREPARING,
+	SONG_DECK_PREPARED,
+	SONG_DECK_PLAYING,
+	SONG_DECK_FADING
+} XNA_SongDeckState;
+
+typedef struct XNA_SongDeck
+{
+	FAudioVoiceCallback callbacks; /* Must be first, see XNA_SongBufferEnd */
+	XNA_SongDeckState state;
+
+	FAudioSourceVoice *voice;
+	FAPO *visualizer;
+	uint16_t voiceChannels;
+	uint32_t voiceRate;
+
+	stb_vorbis *song;
+	stb_vorbis_info info;
+	float length;
+	uint8_t *cache;
+	uint32_t cacheBytes;
+	uint32_t bufferFrames;
+	uint32_t decoded;
+	volatile int32_t played;
+	volatile int32_t done;
+
+	float gain;
+	float fadeFrom;
+	uint32_t fadeStart;
+	uint32_t fadeLength;
+} XNA_SongDeck;
+
 static float songVolume = 1.0f;
 static FAudio *songAudio = NULL;
 static FAudioMasteringVoice *songMaster = NULL;
 
-static FAudioSourceVoice *songVoice = NULL;
-static FAudioVoiceCallback callbacks;
-static stb_vorbis *activeSong = NULL;
-static stb_vorbis_info activeSongInfo;
-static uint8_t *songCache;
+static XNA_SongDeck songDecks[2];
+static uint32_t songActive;
+static uint8_t songPaused;
+static uint32_t songPauseTime;
+
+/* songLock keeps the song thread away from the decks while they change */
+static FAudioMutex songLock;
+static FAudioSemaphore songWake;
+static FAudioSemaphore songReady;
+static FAudioThread songThread;
+static uint8_t songQuit;
+static char *songPrepareName;
+static uint32_t songPrepareSerial;
+
+/* Visualization, see XNA_GetSongVisualizationData */
+#define SONG_VIS_WINDOW 1024
+#define SONG_VIS_FLOOR_DB -60.0f
+
+static uint8_t songVisEnabled = 0;
+static FAudioFFT songVisFFT;
+static float songVisTwiddles[FAUDIO_FFT_TWIDDLES(SONG_VIS_WINDOW)];
+static float songVisHann[SONG_VIS_WINDOW];
+static uint32_t songVisReversed[SONG_VIS_WINDOW];
 
 /* Internal Functions */
 
-static void XNA_SongSubmitBuffer(FAudioVoiceCallback *callback, void *pBufferContext)
+/* Visualizer FAPO, on each deck's voice while visualization is enabled.
+ * Process keeps the last SONG_VIS_WINDOW frames, mixed down to mono, and
+ * publishes them in a parameter block. FAPOBase swaps the blocks without
+ * locking, so polling never holds up the mixer, and the FFT is left to
+ * whoever polls.
+ */
+
+typedef struct XNA_SongVisualizerBlock
+{
+	float samples[SONG_VIS_WINDOW];	/* Oldest first */
+} XNA_SongVisualizerBlock;
+
+typedef struct XNA_SongVisualizer
+{
+	FAPOBase base;
+	uint16_t channels;
+	uint32_t historyOffset;
+	float history[SONG_VIS_WINDOW];
+} XNA_SongVisualizer;
+
+static FAPORegistrationProperties SongVisualizerProperties =
+{
+	/* .clsid = */ {0},
+	/* .FriendlyName = */
+	{
+		'S', 'o', 'n', 'g', 'V', 'i', 's', 'u', 'a', 'l', 'i', 'z', 'e', 'r', '\0'
+	},
+	/*.CopyrightInfo = */
+	{
+		'C', 'o', 'p', 'y', 'r', 'i', 'g', 'h', 't', ' ', '(', 'c', ')',
+		'E', 't', 'h', 'a', 'n', ' ', 'L', 'e', 'e', '\0'
+	},
+	/*.MajorVersion = */ 0,
+	/*.MinorVersion = */ 0,
+	/*.Flags = */(
+		FAPO_FLAG_CHANNELS_MUST_MATCH |
+		FAPO_FLAG_FRAMERATE_MUST_MATCH |
+		FAPO_FLAG_BITSPERSAMPLE_MUST_MATCH |
+		FAPO_FLAG_BUFFERCOUNT_MUST_MATCH |
+		FAPO_FLAG_INPLACE_SUPPORTED |
+		FAPO_FLAG_INPLACE_REQUIRED
+	),
+	/*.MinInputBufferCount = */ 1,
+	/*.MaxInputBufferCount = */  1,
+	/*.MinOutputBufferCount = */ 1,
+	/*.MaxOutputBufferCount =*/ 1
+};
+
+static uint32_t XNA_SongVisualizer_LockForProcess(
+	XNA_SongVisualizer *fapo,
+	uint32_t InputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pInputLockedParameters,
+	uint32_t OutputLockedParameterCount,
+	const FAPOLockForProcessBufferParameters *pOutputLockedParameters
+) {
+	fapo->channels = pInputLockedParameters->pFormat->nChannels;
+	fapo->historyOffset = 0;
+	FAudio_zero(fapo->history, sizeof(fapo->history));
+	return FAPOBase_LockForProcess(
+		&fapo->base,
+		InputLockedParameterCount,
+		pInputLockedParameters,
+		OutputLockedParameterCount,
+		pOutputLockedParameters
+	);
+}
+
+static void XNA_SongVisualizer_Process(
+	XNA_SongVisualizer *fapo,
+	uint32_t InputProcessParameterCount,
+	const FAPOProcessBufferParameters* pInputProcessParameters,
+	uint32_t OutputProcessParameterCount,
+	FAPOProcessBufferParameters* pOutputProcessParameters,
+	int32_t IsEnabled
+) {
+	const float *samples = (const float*) pInputProcessParameters->pBuffer;
+	uint32_t frames = pInputProcessParameters->ValidFrameCount;
+	uint32_t i, c, tail;
+	float sum, scale;
+	XNA_SongVisualizerBlock *block;
+
+	if (!IsEnabled || frames == 0)
+	{
+		return;
+	}
+
+	/* Only the last window's worth of a long pass can be seen */
+	if (frames > SONG_VIS_WINDOW)
+	{
+		samples += (frames - SONG_VIS_WINDOW) * fapo->channels;
+		frames = SONG_VIS_WINDOW;
+	}
+	scale = 1.0f / fapo->channels;
+	for (i = 0; i < frames; i += 1)
+	{
+		sum = 0.0f;
+		if (pInputProcessParameters->BufferFlags != FAPO_BUFFER_SILENT)
+		{
+			for (c = 0; c < fapo->channels; c += 1)
+			{
+				sum += samples[(i * fapo->channels) + c];
+			}
+		}
+		fapo->history[fapo->historyOffset] = sum * scale;
+		fapo->historyOffset = (fapo->historyOffset + 1) % SONG_VIS_WINDOW;
+	}
+
+	/* Unroll the history so the block reads oldest first */
+	block = (XNA_SongVisualizerBlock*) FAPOBase_BeginProcess(&fapo->base);
+	tail = SONG_VIS_WINDOW - fapo->historyOffset;
+	FAudio_memcpy(
+		block->samples,
+		fapo->history + fapo->historyOffset,
+		tail * sizeof(float)
+	);
+	FAudio_memcpy(
+		block->samples + tail,
+		fapo->history,
+		fapo->historyOffset * sizeof(float)
+	);
+	FAPOBase_EndProcess(&fapo->base);
+}
+
+static void XNA_SongVisualizer_Free(void* fapo)
+{
+	XNA_SongVisualizer *visualizer = (XNA_SongVisualizer*) fapo;
+	FAudio_free(visualizer->base.m_pParameterBlocks);
+	FAudio_free(fapo);
+}
+
+static FAPO* XNA_SongVisualizer_Create()
+{
+	XNA_SongVisualizer *result = (XNA_SongVisualizer*) FAudio_malloc(
+		sizeof(XNA_SongVisualizer)
+	);
+	uint8_t *params = (uint8_t*) FAudio_malloc(
+		sizeof(XNA_SongVisualizerBlock) * 3
+	);
+	FAudio_zero(result, sizeof(XNA_SongVisualizer));
+	FAudio_zero(params, sizeof(XNA_SongVisualizerBlock) * 3);
+	CreateFAPOBaseWithCustomAllocatorEXT(
+		&result->base,
+		&SongVisualizerProperties,
+		params,
+		sizeof(XNA_SongVisualizerBlock),
+		1,
+		FAudio_malloc,
+		FAudio_free,
+		FAudio_realloc
+	);
+	result->base.base.LockForProcess = (LockForProcessFunc)
+		XNA_SongVisualizer_LockForProcess;
+	result->base.base.Process = (ProcessFunc)
+		XNA_SongVisualizer_Process;
+	result->base.Destructor = XNA_SongVisualizer_Free;
+	return &result->base.base;
+}
+
+static void XNA_SongVisualizer_Init()
+{
+	uint32_t k, i, r, m;
+
+	FAudio_INTERNAL_InitFFT(&songVisFFT, songVisTwiddles, SONG_VIS_WINDOW);
+	for (k = 0; k < SONG_VIS_WINDOW; k += 1)
+	{
+		/* Base-4 digit reversal, an FFT of 4^n points has n digits */
+		for (i = k, r = 0, m = SONG_VIS_WINDOW; m > 1; m /= 4)
+		{
+			r = (r * 4) + (i & 3);
+			i >>= 2;
+		}
+		songVisReversed[k] = r;
+		songVisHann[k] = (float) (0.5 - 0.5 * FAudio_cos(
+			2.0 * 3.14159265358979323846 * k / SONG_VIS_WINDOW
+		));
+	}
+}
+
+/* Decks */
+
+static void XNA_SongBufferEnd(FAudioVoiceCallback *callback, void *pBufferContext)
+{
+	XNA_SongDeck *deck = (XNA_SongDeck*) callback;
+	FAudio_PlatformAtomicAdd(&deck->played, 1);
+	FAudio_PlatformPostSemaphore(songWake);
+}
+
+/* Must be called with songLock held */
+static void XNA_SongSubmitBuffer(XNA_SongDeck *deck)
 {
 	FAudioBuffer buffer;
+	uint8_t *data = deck->cache + (
+		(deck->decoded % SONG_BUFFER_COUNT) *
+		deck->bufferFrames *
+		deck->info.channels *
+		sizeof(float)
+	);
 	uint32_t decoded = stb_vorbis_get_samples_float_interleaved(
-		activeSong,
-		activeSongInfo.channels,
-		(float*) songCache,
-		activeSongInfo.sample_rate
+		deck->song,
+		deck->info.channels,
+		(float*) data,
+		deck->bufferFrames * deck->info.channels
 	);
 	if (decoded == 0)
 	{
+		FAudio_PlatformAtomicCompareExchange(&deck->done, 0, 1);
 		return;
 	}
-	buffer.Flags = (decoded < activeSongInfo.sample_rate) ?
+	buffer.Flags = (decoded < deck->bufferFrames) ?
 		FAUDIO_END_OF_STREAM :
 		0;
-	buffer.AudioBytes = decoded * activeSongInfo.channels * sizeof(float);
-	buffer.pAudioData = songCache;
+	buffer.AudioBytes = decoded * deck->info.channels * sizeof(float);
+	buffer.pAudioData = data;
 	buffer.PlayBegin = 0;
 	buffer.PlayLength = decoded;
 	buffer.LoopBegin = 0;
@@ -116,30 +376,262 @@ static void XNA_SongSubmitBuffer(FAudioVoiceCallback *callback, void *pBufferCon
 	buffer.LoopCount = 0;
 	buffer.pContext = NULL;
 	FAudioSourceVoice_SubmitSourceBuffer(
-		songVoice,
+		deck->voice,
 		&buffer,
 		NULL
 	);
+	deck->decoded += 1;
+	if (decoded < deck->bufferFrames)
+	{
+		FAudio_PlatformAtomicCompareExchange(&deck->done, 0, 1);
+	}
+}
+
+/* Must be called with songLock held */
+static void XNA_SongFillRing(XNA_SongDeck *deck)
+{
+	while (	deck->song != NULL &&
+		!FAudio_PlatformAtomicGet(&deck->done) &&
+		deck->decoded - FAudio_PlatformAtomicGet(&deck->played) < SONG_BUFFER_COUNT	)
+	{
+		XNA_SongSubmitBuffer(deck);
+	}
+}
+
+/* Must be called with songLock held */
+static void XNA_SongSetGain(XNA_SongDeck *deck, float gain)
+{
+	deck->gain = gain;
+	FAudioVoice_SetVolume(deck->voice, songVolume * gain, 0);
+}
+
+/* Must be called with songLock held. The voice is kept for the next song. */
+static void XNA_SongDeckStop(XNA_SongDeck *deck)
+{
+	if (deck->voice != NULL)
+	{
+		/* Flushing calls OnBufferEnd for the whole ring before it
+		 * returns, so nothing counts against the next song.
+		 */
+		FAudioSourceVoice_Stop(deck->voice, 0, 0);
+		FAudioSourceVoice_FlushSourceBuffers(deck->voice);
+	}
+	if (deck->song != NULL)
+	{
+		stb_vorbis_close(deck->song);
+		deck->song = NULL;
+	}
+	deck->state = SONG_DECK_IDLE;
+	deck->decoded = 0;
+	deck->fadeLength = 0;
+	FAudio_PlatformAtomicCompareExchange(&deck->done, 1, 0);
+	FAudio_PlatformAtomicAdd(
+		&deck->played,
+		-FAudio_PlatformAtomicGet(&deck->played)
+	);
+}
+
+/* Must be called with songLock held */
+static void XNA_SongDeckDestroyVoice(XNA_SongDeck *deck)
+{
+	if (deck->voice != NULL)
+	{
+		FAudioVoice_DestroyVoice(deck->voice);
+		deck->voice = NULL;
+	}
+	if (deck->visualizer != NULL)
+	{
+		deck->visualizer->Release(deck->visualizer);
+		deck->visualizer = NULL;
+	}
+}
+
+/* Must be called with songLock held, on an idle deck */
+static void XNA_SongDeckLoad(XNA_SongDeck *deck, stb_vorbis *song)
+{
+	FAudioWaveFormatEx format;
+	FAudioEffectDescriptor visDesc;
+	FAudioEffectChain visChain;
+	uint32_t cacheBytes;
+
+	deck->song = song;
+	deck->info = stb_vorbis_get_info(song);
+	deck->length = stb_vorbis_stream_length_in_seconds(song);
+
+	/* Set format info */
+	format.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+	format.nChannels = deck->info.channels;
+	format.nSamplesPerSec = deck->info.sample_rate;
+	format.wBitsPerSample = sizeof(float) * 8;
+	format.nBlockAlign = format.nChannels * format.wBitsPerSample / 8;
+	format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+	format.cbSize = 0;
+
+	/* Only a new channel count needs a new voice */
+	if (deck->voice != NULL && deck->voiceChannels != format.nChannels)
+	{
+		XNA_SongDeckDestroyVoice(deck);
+	}
+	if (deck->voice == NULL)
+	{
+		deck->visualizer = XNA_SongVisualizer_Create();
+		visDesc.pEffect = deck->visualizer;
+		visDesc.InitialState = songVisEnabled;
+		visDesc.OutputChannels = format.nChannels;
+		visChain.EffectCount = 1;
+		visChain.pEffectDescriptors = &visDesc;
+		deck->callbacks.OnBufferEnd = XNA_SongBufferEnd;
+		FAudio_CreateSourceVoice(
+			songAudio,
+			&deck->voice,
+			&format,
+			0,
+			1.0f, /* No pitch shifting here! */
+			&deck->callbacks,
+			NULL,
+			&visChain
+		);
+		deck->voiceChannels = format.nChannels;
+		deck->voiceRate = format.nSamplesPerSec;
+	}
+	else if (deck->voiceRate != format.nSamplesPerSec)
+	{
+		/* The ring was flushed when the deck stopped, so this is OK */
+		FAudioSourceVoice_SetSourceSampleRate(
+			deck->voice,
+			format.nSamplesPerSec
+		);
+		deck->voiceRate = format.nSamplesPerSec;
+	}
+
+	/* Allocate decode ring, keeping the old one if it's big enough */
+	deck->bufferFrames = FAudio_max(
+		deck->info.sample_rate / SONG_BUFFER_DIVISOR,
+		1
+	);
+	cacheBytes = (
+		SONG_BUFFER_COUNT *
+		deck->bufferFrames *
+		format.nBlockAlign
+	);
+	if (cacheBytes > deck->cacheBytes)
+	{
+		deck->cache = (uint8_t*) FAudio_realloc(deck->cache, cacheBytes);
+		deck->cacheBytes = cacheBytes;
+	}
+
+	/* Fill the whole ring now, so playing it is just starting the voice */
+	deck->state = SONG_DECK_PREPARED;
+	XNA_SongFillRing(deck);
 }
 
-static void XNA_SongKill()
+/* Must be called with songLock held. Returns 1 while the fade is running. */
+static uint8_t XNA_SongDeckFade(XNA_SongDeck *deck)
 {
-	if (songVoice != NULL)
+	uint32_t elapsed;
+	float t;
+
+	if (deck->fadeLength == 0 || songPaused)
 	{
-		FAudioSourceVoice_Stop(songVoice, 0, 0);
-		FAudioVoice_DestroyVoice(songVoice);
-		songVoice = NULL;
+		return 0;
 	}
-	if (songCache != NULL)
+
+	elapsed = FAudio_timems() - deck->fadeStart;
+	if (elapsed >= deck->fadeLength)
 	{
-		FAudio_free(songCache);
-		songCache = NULL;
+		if (deck->state == SONG_DECK_FADING)
+		{
+			XNA_SongDeckStop(deck);
+		}
+		else
+		{
+			deck->fadeLength = 0;
+			XNA_SongSetGain(deck, 1.0f);
+		}
+		return 0;
 	}
-	if (activeSong != NULL)
+
+	/* Equal power, so the crossfade doesn't dip in the middle */
+	t = (float) elapsed / deck->fadeLength;
+	XNA_SongSetGain(
+		deck,
+		(deck->state == SONG_DECK_FADING) ?
+			deck->fadeFrom * (float) FAudio_cos(t * 1.57079632679) :
+			(float) FAudio_sin(t * 1.57079632679)
+	);
+	return 1;
+}
+
+static int32_t FAUDIOCALL XNA_SongThread(void *data)
+{
+	stb_vorbis *song;
+	char *name;
+	uint32_t serial, i;
+	uint8_t fading = 0;
+
+	for (;;)
 	{
-		stb_vorbis_close(activeSong);
-		activeSong = NULL;
+		/* Nothing needs the thread until a buffer ends or a song is
+		 * prepared, unless there's a fade to move along.
+		 */
+		if (fading)
+		{
+			FAudio_PlatformWaitSemaphoreTimeout(
+				songWake,
+				SONG_FADE_STEP_MS
+			);
+		}
+		else
+		{
+			FAudio_PlatformWaitSemaphore(songWake);
+		}
+		FAudio_PlatformLockMutex(songLock);
+		if (songQuit)
+		{
+			FAudio_PlatformUnlockMutex(songLock);
+			break;
+		}
+
+		/* Opening reads the file, so the decks aren't held up for it */
+		while (songPrepareName != NULL)
+		{
+			name = songPrepareName;
+			songPrepareName = NULL;
+			serial = songPrepareSerial;
+			FAudio_PlatformUnlockMutex(songLock);
+			song = stb_vorbis_open_filename(name, NULL, NULL);
+			FAudio_free(name);
+			FAudio_PlatformLockMutex(songLock);
+
+			if (serial != songPrepareSerial)
+			{
+				/* Replaced or cancelled while it was opening */
+				if (song != NULL)
+				{
+					stb_vorbis_close(song);
+				}
+				continue;
+			}
+			if (song != NULL)
+			{
+				XNA_SongDeckLoad(&songDecks[songActive ^ 1], song);
+			}
+			else
+			{
+				songDecks[songActive ^ 1].state = SONG_DECK_IDLE;
+			}
+			FAudio_PlatformPostSemaphore(songReady);
+		}
+
+		fading = 0;
+		for (i = 0; i < 2; i += 1)
+		{
+			XNA_SongFillRing(&songDecks[i]);
+			fading |= XNA_SongDeckFade(&songDecks[i]);
+		}
+		FAudio_PlatformUnlockMutex(songLock);
 	}
+	return 0;
 }
 
 /* "Public" API */
@@ -156,111 +648,278 @@ FAUDIOAPI void XNA_SongInit()
 		0,
 		NULL
 	);
+
+	XNA_SongVisualizer_Init();
+
+	FAudio_zero(songDecks, sizeof(songDecks));
+	songActive = 0;
+	songPaused = 0;
+	songPrepareName = NULL;
+	songPrepareSerial = 0;
+
+	songLock = FAudio_PlatformCreateMutex();
+	songWake = FAudio_PlatformCreateSemaphore(0);
+	songReady = FAudio_PlatformCreateSemaphore(0);
+	songQuit = 0;
+	songThread = FAudio_PlatformCreateThread(
+		XNA_SongThread,
+		"XNA Song Thread",
+		NULL
+	);
 }
 
 FAUDIOAPI void XNA_SongQuit()
 {
-	XNA_SongKill();
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(songLock);
+	songQuit = 1;
+	songPrepareSerial += 1;
+	if (songPrepareName != NULL)
+	{
+		FAudio_free(songPrepareName);
+		songPrepareName = NULL;
+	}
+	FAudio_PlatformUnlockMutex(songLock);
+	FAudio_PlatformPostSemaphore(songWake);
+	FAudio_PlatformWaitThread(songThread, NULL);
+
+	FAudio_PlatformLockMutex(songLock);
+	for (i = 0; i < 2; i += 1)
+	{
+		XNA_SongDeckStop(&songDecks[i]);
+		XNA_SongDeckDestroyVoice(&songDecks[i]);
+		if (songDecks[i].cache != NULL)
+		{
+			FAudio_free(songDecks[i].cache);
+			songDecks[i].cache = NULL;
+		}
+	}
+	FAudio_PlatformUnlockMutex(songLock);
+	FAudio_PlatformDestroySemaphore(songReady);
+	FAudio_PlatformDestroySemaphore(songWake);
+	FAudio_PlatformDestroyMutex(songLock);
+
 	FAudioVoice_DestroyVoice(songMaster);
 	FAudio_Release(songAudio);
 }
 
-FAUDIOAPI float XNA_PlaySong(const char *name)
+/* Starts opening and decoding a song on the song thread, replacing any song
+ * prepared earlier. If the last song is still fading out, it's cut off.
+ */
+FAUDIOAPI void XNA_PrepareSong(const char *name)
 {
-	FAudioWaveFormatEx format;
-	XNA_SongKill();
-
-	activeSong = stb_vorbis_open_filename(name, NULL, NULL);
-
-	/* Set format info */
-	activeSongInfo = stb_vorbis_get_info(activeSong);
-	format.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
-	format.nChannels = activeSongInfo.channels;
-	format.nSamplesPerSec = activeSongInfo.sample_rate;
-	format.wBitsPerSample = sizeof(float) * 8;
-	format.nBlockAlign = format.nChannels * format.wBitsPerSample / 8;
-	format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
-	format.cbSize = 0;
+	XNA_SongDeck *deck;
+	size_t len = FAudio_strlen(name) + 1;
+
+	FAudio_PlatformLockMutex(songLock);
+	deck = &songDecks[songActive ^ 1];
+	XNA_SongDeckStop(deck);
+	deck->state = SONG_DECK_PREPARING;
+	if (songPrepareName != NULL)
+	{
+		FAudio_free(songPrepareName);
+	}
+	songPrepareName = (char*) FAudio_malloc(len);
+	FAudio_memcpy(songPrepareName, name, len);
+	songPrepareSerial += 1;
+	FAudio_PlatformUnlockMutex(songLock);
+	FAudio_PlatformPostSemaphore(songWake);
+}
 
-	/* Allocate decode cache */
-	songCache = (uint8_t*) FAudio_malloc(format.nAvgBytesPerSec);
+/* Plays the prepared song, waiting for it if the song thread isn't done yet,
+ * and returns its length in seconds, or 0 if there was nothing to play. With
+ * a fadeSeconds above 0, the current song fades out while the new one fades
+ * in. Otherwise the current song stops right away.
+ */
+FAUDIOAPI float XNA_PlayPreparedSong(float fadeSeconds)
+{
+	XNA_SongDeck *current, *next;
+	uint32_t fadeLength = (fadeSeconds > 0.0f) ?
+		(uint32_t) (fadeSeconds * 1000.0f) :
+		0;
+	float length;
 
-	/* Init voice */
-	FAudio_zero(&callbacks, sizeof(FAudioVoiceCallback));
-	callbacks.OnBufferEnd = XNA_SongSubmitBuffer;
-	FAudio_CreateSourceVoice(
-		songAudio,
-		&songVoice,
-		&format,
-		0,
-		1.0f, /* No pitch shifting here! */
-		&callbacks,
-		NULL,
-		NULL
-	);
-	FAudioVoice_SetVolume(songVoice, songVolume, 0);
+	FAudio_PlatformLockMutex(songLock);
+	current = &songDecks[songActive];
+	next = &songDecks[songActive ^ 1];
+	while (next->state == SONG_DECK_PREPARING)
+	{
+		FAudio_PlatformUnlockMutex(songLock);
+		FAudio_PlatformWaitSemaphore(songReady);
+		FAudio_PlatformLockMutex(songLock);
+	}
+	if (next->state != SONG_DECK_PREPARED)
+	{
+		/* Nothing was prepared, or it couldn't be opened */
+		FAudio_PlatformUnlockMutex(songLock);
+		return 0.0f;
+	}
 
-	/* Okay, this song is decoding now */
-	stb_vorbis_seek_start(activeSong);
-	XNA_SongSubmitBuffer(NULL, NULL);
+	if (	current->state == SONG_DECK_PLAYING &&
+		fadeLength > 0 &&
+		!songPaused	)
+	{
+		current->state = SONG_DECK_FADING;
+		current->fadeFrom = current->gain;
+		current->fadeStart = FAudio_timems();
+		current->fadeLength = fadeLength;
+		next->fadeStart = current->fadeStart;
+		next->fadeLength = fadeLength;
+		XNA_SongSetGain(next, 0.0f);
+	}
+	else
+	{
+		XNA_SongDeckStop(current);
+		XNA_SongSetGain(next, 1.0f);
+	}
+	next->state = SONG_DECK_PLAYING;
+	songActive ^= 1;
+	songPaused = 0;
+	FAudioSourceVoice_Start(next->voice, 0, 0);
+	length = next->length;
+	FAudio_PlatformUnlockMutex(songLock);
+	FAudio_PlatformPostSemaphore(songWake);
+	return length;
+}
 
-	/* Finally. */
-	FAudioSourceVoice_Start(songVoice, 0, 0);
-	return stb_vorbis_stream_length_in_seconds(activeSong);
+FAUDIOAPI float XNA_PlaySong(const char *name)
+{
+	XNA_PrepareSong(name);
+	return XNA_PlayPreparedSong(0.0f);
 }
 
 FAUDIOAPI void XNA_PauseSong()
 {
-	if (songVoice == NULL)
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(songLock);
+	if (!songPaused)
 	{
-		return;
+		songPaused = 1;
+		songPauseTime = FAudio_timems();
+		for (i = 0; i < 2; i += 1)
+		{
+			if (	songDecks[i].state == SONG_DECK_PLAYING ||
+				songDecks[i].state == SONG_DECK_FADING	)
+			{
+				FAudioSourceVoice_Stop(songDecks[i].voice, 0, 0);
+			}
+		}
 	}
-	FAudioSourceVoice_Stop(songVoice, 0, 0);
+	FAudio_PlatformUnlockMutex(songLock);
 }
 
 FAUDIOAPI void XNA_ResumeSong()
 {
-	if (songVoice == NULL)
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(songLock);
+	if (songPaused)
 	{
-		return;
+		songPaused = 0;
+		for (i = 0; i < 2; i += 1)
+		{
+			if (	songDecks[i].state == SONG_DECK_PLAYING ||
+				songDecks[i].state == SONG_DECK_FADING	)
+			{
+				/* Fades pick up where they were paused */
+				songDecks[i].fadeStart += (
+					FAudio_timems() - songPauseTime
+				);
+				FAudioSourceVoice_Start(songDecks[i].voice, 0, 0);
+			}
+		}
 	}
-	FAudioSourceVoice_Start(songVoice, 0, 0);
+	FAudio_PlatformUnlockMutex(songLock);
+	FAudio_PlatformPostSemaphore(songWake);
 }
 
 FAUDIOAPI void XNA_StopSong()
 {
-	XNA_SongKill();
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(songLock);
+	for (i = 0; i < 2; i += 1)
+	{
+		if (	songDecks[i].state == SONG_DECK_PLAYING ||
+			songDecks[i].state == SONG_DECK_FADING	)
+		{
+			XNA_SongDeckStop(&songDecks[i]);
+		}
+	}
+	songPaused = 0;
+	FAudio_PlatformUnlockMutex(songLock);
 }
 
 FAUDIOAPI void XNA_SetSongVolume(float volume)
 {
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(songLock);
 	songVolume = volume;
-	if (songVoice != NULL)
+	for (i = 0; i < 2; i += 1)
 	{
-		FAudioVoice_SetVolume(songVoice, songVolume, 0);
+		if (songDecks[i].voice != NULL)
+		{
+			XNA_SongSetGain(&songDecks[i], songDecks[i].gain);
+		}
 	}
+	FAudio_PlatformUnlockMutex(songLock);
 }
 
 FAUDIOAPI uint32_t XNA_GetSongEnded()
 {
 	FAudioVoiceState state;
-	if (songVoice == NULL || activeSong == NULL)
+	XNA_SongDeck *deck = &songDecks[songActive];
+
+	/* Only this thread changes the state of the active deck */
+	if (deck->state != SONG_DECK_PLAYING)
 	{
 		return 1;
 	}
-	FAudioSourceVoice_GetState(songVoice, &state, 0);
-	return state.BuffersQueued == 0;
+	FAudioSourceVoice_GetState(deck->voice, &state, 0);
+
+	/* An empty queue may just mean the thread is behind */
+	return (	FAudio_PlatformAtomicGet(&deck->done) &&
+			state.BuffersQueued == 0	);
 }
 
 FAUDIOAPI void XNA_EnableVisualization(uint32_t enable)
 {
-	/* TODO: Enable/Disable FAPO effect */
+	uint32_t i;
+
+	FAudio_PlatformLockMutex(songLock);
+	songVisEnabled = (enable != 0);
+	for (i = 0; i < 2; i += 1)
+	{
+		if (songDecks[i].voice == NULL)
+		{
+			continue;
+		}
+		if (songVisEnabled)
+		{
+			FAudioVoice_EnableEffect(
+				songDecks[i].voice,
+				0,
+				FAUDIO_COMMIT_NOW
+			);
+		}
+		else
+		{
+			FAudioVoice_DisableEffect(
+				songDecks[i].voice,
+				0,
+				FAUDIO_COMMIT_NOW
+			);
+		}
+	}
+	FAudio_PlatformUnlockMutex(songLock);
 }
 
 FAUDIOAPI uint32_t XNA_VisualizationEnabled()
 {
-	/* TODO: Query FAPO effect enabled */
-	return 0;
+	return songVisEnabled;
 }
 
 FAUDIOAPI void XNA_GetSongVisualizationData(
@@ -268,7 +927,87 @@ FAUDIOAPI void XNA_GetSongVisualizationData(
 	float *samples,
 	uint32_t count
 ) {
-	/* TODO: Visualization FAPO that reads in Song samples, FFT analysis */
+	XNA_SongDeck *deck = &songDecks[songActive];
+	XNA_SongVisualizerBlock block;
+	float re[SONG_VIS_WINDOW];
+	float im[SONG_VIS_WINDOW];
+	float mag[SONG_VIS_WINDOW / 2];
+	float lo, hi, peak, db;
+	uint32_t i, bin, first, last, valid;
+
+	if (	!songVisEnabled ||
+		deck->state != SONG_DECK_PLAYING ||
+		count == 0	)
+	{
+		FAudio_zero(frequencies, sizeof(float) * count);
+		FAudio_zero(samples, sizeof(float) * count);
+		return;
+	}
+
+	/* Any thread may read the newest block, the mixer only swaps them.
+	 * FAudioVoice_GetEffectParameters would wait for the effect lock, held
+	 * for the whole mix pass, so ask the FAPO directly.
+	 */
+	deck->visualizer->GetParameters(
+		deck->visualizer,
+		&block,
+		sizeof(XNA_SongVisualizerBlock)
+	);
+
+	/* Samples: the newest ones, oldest first */
+	valid = FAudio_min(count, SONG_VIS_WINDOW);
+	FAudio_memcpy(
+		samples,
+		block.samples + SONG_VIS_WINDOW - valid,
+		valid * sizeof(float)
+	);
+	FAudio_zero(samples + valid, sizeof(float) * (count - valid));
+
+	/* Frequencies: Hann windowed FFT of the whole window... */
+	for (i = 0; i < SONG_VIS_WINDOW; i += 1)
+	{
+		re[i] = block.samples[i] * songVisHann[i];
+		im[i] = 0.0f;
+	}
+	FAudio_INTERNAL_FFT(&songVisFFT, re, im);
+	for (i = 1; i < SONG_VIS_WINDOW / 2; i += 1)
+	{
+		bin = songVisReversed[i];
+		mag[i] = FAudio_sqrtf(
+			(re[bin] * re[bin]) + (im[bin] * im[bin])
+		) * (4.0f / SONG_VIS_WINDOW); /* Full scale sine is 1 */
+	}
+
+	/* ... grouped into count log-spaced bands from 20Hz to Nyquist. Each
+	 * band takes its loudest bin and maps SONG_VIS_FLOOR_DB..0dB to 0..1.
+	 */
+	lo = 20.0f * SONG_VIS_WINDOW / deck->info.sample_rate;
+	hi = SONG_VIS_WINDOW / 2.0f;
+	for (i = 0; i < count; i += 1)
+	{
+		first = (uint32_t) (lo * FAudio_pow(hi / lo, (float) i / count));
+		last = (uint32_t) (lo * FAudio_pow(hi / lo, (float) (i + 1) / count));
+		first = FAudio_clamp(first, 1, SONG_VIS_WINDOW / 2 - 1);
+		last = FAudio_clamp(last, first, SONG_VIS_WINDOW / 2 - 1);
+		peak = 0.0f;
+		for (bin = first; bin <= last; bin += 1)
+		{
+			peak = FAudio_max(peak, mag[bin]);
+		}
+		if (peak > 0.0f)
+		{
+			db = 20.0f * (float) FAudio_log10(peak);
+			frequencies[i] = FAudio_clamp(
+				(db - SONG_VIS_FLOOR_DB) / -SONG_VIS_FLOOR_DB,
+				0.0f,
+				1.0f
+			);
+		}
+		else
+		{
+			frequencies[i] = 0.0f;
+		}
+	}
 }
 
 /* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -14,10 +14,17 @@ typedef uint8_t BOOL;
 
 #define XAUDIO2_ANY_PROCESSOR FAUDIO_DEFAULT_PROCESSOR
 #define XAUDIO2_COMMIT_NOW FAUDIO_COMMIT_NOW
+#define XAUDIO2_COMMIT_ALL FAUDIO_COMMIT_ALL
 #define XAUDIO2_END_OF_STREAM FAUDIO_END_OF_STREAM
+#define XAUDIO2_LOOP_INFINITE FAUDIO_LOOP_INFINITE
+#define XAUDIO2_VOICE_USEFILTER FAUDIO_VOICE_USEFILTER
 
+#define WAVE_FORMAT_PCM FAUDIO_FORMAT_PCM
+#define WAVE_FORMAT_ADPCM FAUDIO_FORMAT_MSADPCM
 #define WAVE_FORMAT_IEEE_FLOAT FAUDIO_FORMAT_IEEE_FLOAT
 
+#define LowPassFilter FAudioLowPassFilter
+
 #define AudioCategory_GameEffects FAudioStreamCategory_GameEffects
 
 #define GlobalDefaultDevice FAudioGlobalDefaultDevice
@@ -27,11 +34,15 @@ typedef FAudioBuffer XAUDIO2_BUFFER;
 typedef FAudioDeviceDetails XAUDIO2_DEVICE_DETAILS;
 typedef FAudioEffectChain XAUDIO2_EFFECT_CHAIN;
 typedef FAudioEffectDescriptor XAUDIO2_EFFECT_DESCRIPTOR;
+typedef FAudioFilterParameters XAUDIO2_FILTER_PARAMETERS;
+typedef FAudioSendDescriptor XAUDIO2_SEND_DESCRIPTOR;
 typedef FAudioVoiceDetails XAUDIO2_VOICE_DETAILS;
 typedef FAudioVoiceDetails XAUDIO27_VOICE_DETAILS;
 typedef FAudioVoiceState XAUDIO2_VOICE_STATE;
 typedef FAudioWaveFormatEx WAVEFORMATEX;
 typedef FAudioPerformanceData XAUDIO2_PERFORMANCE_DATA;
+typedef FAudioVoiceSends XAUDIO2_VOICE_SENDS;
+typedef FAudioADPCMCoefSet ADPCMCOEFSET;
 
 typedef FAudioEngineCallback IXAudio2EngineCallback;
 typedef FAudioVoiceCallback IXAudio2VoiceCallback;
@@ -39,6 +50,7 @@ typedef FAudioVoiceCallback IXAudio2VoiceCallback;
 typedef FAPO IXAPO;
 
 typedef FAudio IXAudio27;
+#define IXAudio27_CommitChanges FAudio_CommitOperationSet
 #define IXAudio27_CreateMasteringVoice FAudio_CreateMasteringVoice
 #define IXAudio27_CreateSourceVoice FAudio_CreateSourceVoice
 #define IXAudio27_CreateSubmixVoice FAudio_CreateSubmixVoice
@@ -53,6 +65,7 @@ typedef FAudio IXAudio27;
 #define IXAudio27_UnregisterForCallbacks FAudio_UnregisterForCallbacks
 
 typedef FAudio IXAudio2;
+#define IXAudio2_CommitChanges FAudio_CommitOperationSet
 #define IXAudio2_CreateMasteringVoice FAudio_CreateMasteringVoice
 #define IXAudio2_CreateSourceVoice FAudio_CreateSourceVoice
 #define IXAudio2_CreateSubmixVoice FAudio_CreateSubmixVoice
@@ -63,6 +76,8 @@ typedef FAudio IXAudio2;
 #define IXAudio2_StopEngine FAudio_StopEngine
 #define IXAudio2_UnregisterForCallbacks FAudio_UnregisterForCallbacks
 
+typedef FAudioVoice IXAudio2Voice;
+
 typedef FAudioMasteringVoice IXAudio2MasteringVoice;
 #define IXAudio2MasteringVoice_DestroyVoice FAudioVoice_DestroyVoice
 #define IXAudio2MasteringVoice_GetChannelMask FAudioMasteringVoice_GetChannelMask
@@ -72,10 +87,14 @@ typedef FAudioSourceVoice IXAudio27SourceVoice;
 #define IXAudio27SourceVoice_DestroyVoice FAudioVoice_DestroyVoice
 #define IXAudio27SourceVoice_ExitLoop FAudioSourceVoice_ExitLoop
 #define IXAudio27SourceVoice_FlushSourceBuffers FAudioSourceVoice_FlushSourceBuffers
+#define IXAudio27SourceVoice_GetFrequencyRatio FAudioSourceVoice_GetFrequencyRatio
 #define IXAudio27SourceVoice_GetState(a,b) FAudioSourceVoice_GetState(a,b,0)
 #define IXAudio27SourceVoice_GetVoiceDetails FAudioVoice_GetVoiceDetails
+#define IXAudio27SourceVoice_GetVolume FAudioVoice_GetVolume
 #define IXAudio27SourceVoice_SetChannelVolumes FAudioVoice_SetChannelVolumes
+#define IXAudio27SourceVoice_SetFrequencyRatio FAudioSourceVoice_SetFrequencyRatio
 #define IXAudio27SourceVoice_SetSourceSampleRate FAudioSourceVoice_SetSourceSampleRate
+#define IXAudio27SourceVoice_SetVolume FAudioVoice_SetVolume
 #define IXAudio27SourceVoice_Start FAudioSourceVoice_Start
 #define IXAudio27SourceVoice_Stop FAudioSourceVoice_Stop
 #define IXAudio27SourceVoice_SubmitSourceBuffer FAudioSourceVoice_SubmitSourceBuffer
@@ -84,10 +103,15 @@ typedef FAudioSourceVoice IXAudio2SourceVoice;
 #define IXAudio2SourceVoice_DestroyVoice FAudioVoice_DestroyVoice
 #define IXAudio2SourceVoice_ExitLoop FAudioSourceVoice_ExitLoop
 #define IXAudio2SourceVoice_FlushSourceBuffers FAudioSourceVoice_FlushSourceBuffers
+#define IXAudio2SourceVoice_GetFrequencyRatio FAudioSourceVoice_GetFrequencyRatio
 #define IXAudio2SourceVoice_GetState FAudioSourceVoice_GetState
 #define IXAudio2SourceVoice_GetVoiceDetails FAudioVoice_GetVoiceDetails
+#define IXAudio2SourceVoice_GetVolume FAudioVoice_GetVolume
 #define IXAudio2SourceVoice_SetChannelVolumes FAudioVoice_SetChannelVolumes
+#define IXAudio2SourceVoice_SetFilterParameters FAudioVoice_SetFilterParameters
+#define IXAudio2SourceVoice_SetFrequencyRatio FAudioSourceVoice_SetFrequencyRatio
 #define IXAudio2SourceVoice_SetSourceSampleRate FAudioSourceVoice_SetSourceSampleRate
+#define IXAudio2SourceVoice_SetVolume FAudioVoice_SetVolume
 #define IXAudio2SourceVoice_Start FAudioSourceVoice_Start
 #define IXAudio2SourceVoice_Stop FAudioSourceVoice_Stop
 #define IXAudio2SourceVoice_SubmitSourceBuffer FAudioSourceVoice_SubmitSourceBuffer
@@ -99,3 +123,4 @@ typedef FAudioSubmixVoice IXAudio27SubmixVoice;
 typedef FAudioSubmixVoice IXAudio2SubmixVoice;
 #define IXAudio2SubmixVoice_GetVoiceDetails FAudioVoice_GetVoiceDetails
 #define IXAudio2SubmixVoice_DestroyVoice FAudioVoice_DestroyVoice
+#define IXAudio2SubmixVoice_SetEffectChain FAudioVoice_SetEffectChain
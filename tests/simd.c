@@ -0,0 +1,1424 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2021 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+/* SIMD kernel tests
+ *
+ * Unlike xaudio2.c, this does not test the public API. The mixer kernels are
+ * built straight into this program, with the scalar versions forced on, and
+ * every kernel picked by FAudio_INTERNAL_InitSIMDFunctions for each SIMD tier
+ * the CPU supports is run against the scalar one on random sizes, strides and
+ * buffer alignments. The results have to match within a few ULPs, and each
+ * kernel is then timed on a typical period so new tiers can show their gains.
+ *
+ * Usage: faudio_simd_tests [trials per kernel, default 200]
+ */
+
+#define FAUDIO_SIMD_TESTS
+#include "../src/FAudio_internal_simd.c"
+
+#include <SDL.h>
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#define BENCH_CLOCK() __rdtsc()
+#define BENCH_UNIT "cycles"
+#elif defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define BENCH_CLOCK() __rdtsc()
+#define BENCH_UNIT "cycles"
+#else
+#define BENCH_CLOCK() SDL_GetPerformanceCounter()
+#define BENCH_UNIT "ticks"
+#endif
+
+#define MAX_CHANNELS 8
+#define MAX_FRAMES 1536
+#define MAX_RATIO 4
+#define BUFFER_FLOATS ((MAX_FRAMES * MAX_RATIO + 64) * MAX_CHANNELS)
+#define MAX_ALIGN 7 /* In floats, enough to misalign 32-byte loads */
+#define STATE_FLOATS (FAudio_max(SINC_HISTORY_FRAMES, FAUDIO_EQ_BANDS * 2) * MAX_CHANNELS)
+
+#define BENCH_FRAMES 1024
+#define BENCH_REPS 64
+#define BENCH_RUNS 9
+
+/* Kernels, as picked by InitSIMDFunctions for one tier */
+
+typedef struct KernelSet
+{
+	void (*convertU8)(const uint8_t *restrict, float *restrict, uint32_t);
+	void (*convertS16)(const int16_t *restrict, float *restrict, uint32_t);
+	void (*convertS24)(const uint8_t *restrict, float *restrict, uint32_t);
+	void (*unpackNibbles)(const uint8_t *restrict, int8_t *restrict, uint32_t);
+	void (*interleaveF32)(const float *const*, float *restrict, uint32_t, uint32_t);
+	void (*quantizeS16)(const float *restrict, int16_t *restrict, uint32_t, uint32_t *restrict);
+	void (*quantizeS24)(const float *restrict, uint8_t *restrict, uint32_t, uint32_t *restrict);
+	void (*quantizeS32)(const float *restrict, int32_t *restrict, uint32_t);
+	FAudioResampleCallback resampleMono;
+	FAudioResampleCallback resampleStereo;
+	FAudioResampleCallback resampleGeneric;
+	FAudioSincResampleCallback resampleSinc;
+	FAudioFixedResampleCallback resampleFixed;
+	FAudioResampleMixCallback resampleMixMono;
+	void (*amplify)(float*, uint32_t, float);
+	uint8_t (*isSilent)(const float*, uint32_t);
+	void (*framePeaks)(const float *restrict, float *restrict, uint32_t, uint32_t);
+	void (*channelLevels)(const float *restrict, float *restrict, float *restrict, uint32_t, uint32_t);
+	void (*filterVoice)(
+		const FAudioFilterParameters*,
+		FAudioFilterState*,
+		float*,
+		uint32_t,
+		uint16_t
+	);
+	FAudioCombBankCallback processCombBank;
+	FAudioBiquadCascadeCallback processBiquadCascade;
+	FAudioFFTCallback fft;
+	FAudioSpectrumMACCallback spectrumMAC;
+	F3DAudioEmitterLanesCallback emitterLanes;
+	FAudioMixCallback mix[12];
+} KernelSet;
+
+static const struct
+{
+	const char *name;
+	FAudioMixCallback *func;
+	uint32_t srcChans; /* 0 for any */
+	uint32_t dstChans;
+} mixers[12] =
+{
+	{ "Mix_Generic", &FAudio_INTERNAL_Mix_Generic, 0, 0 },
+	{ "Mix_1in_1out", &FAudio_INTERNAL_Mix_1in_1out, 1, 1 },
+	{ "Mix_1in_2out", &FAudio_INTERNAL_Mix_1in_2out, 1, 2 },
+	{ "Mix_1in_6out", &FAudio_INTERNAL_Mix_1in_6out, 1, 6 },
+	{ "Mix_1in_8out", &FAudio_INTERNAL_Mix_1in_8out, 1, 8 },
+	{ "Mix_2in_1out", &FAudio_INTERNAL_Mix_2in_1out, 2, 1 },
+	{ "Mix_2in_2out", &FAudio_INTERNAL_Mix_2in_2out, 2, 2 },
+	{ "Mix_2in_6out", &FAudio_INTERNAL_Mix_2in_6out, 2, 6 },
+	{ "Mix_2in_8out", &FAudio_INTERNAL_Mix_2in_8out, 2, 8 },
+	{ "Mix_6in_2out", &FAudio_INTERNAL_Mix_6in_2out, 6, 2 },
+	{ "Mix_6in_6out", &FAudio_INTERNAL_Mix_6in_6out, 6, 6 },
+	{ "Mix_8in_8out", &FAudio_INTERNAL_Mix_8in_8out, 8, 8 }
+};
+
+static void GetKernels(
+	KernelSet *set,
+	uint8_t hasSSE2,
+	uint8_t hasAVX2,
+	uint8_t hasNEON
+) {
+	uint32_t i;
+	FAudio_INTERNAL_InitSIMDFunctions(hasSSE2, hasAVX2, hasNEON);
+	set->convertU8 = FAudio_INTERNAL_Convert_U8_To_F32;
+	set->convertS16 = FAudio_INTERNAL_Convert_S16_To_F32;
+	set->convertS24 = FAudio_INTERNAL_Convert_S24_To_F32;
+	set->unpackNibbles = FAudio_INTERNAL_UnpackNibbles;
+	set->interleaveF32 = FAudio_INTERNAL_InterleaveF32;
+	set->quantizeS16 = FAudio_INTERNAL_Convert_F32_To_S16;
+	set->quantizeS24 = FAudio_INTERNAL_Convert_F32_To_S24;
+	set->quantizeS32 = FAudio_INTERNAL_Convert_F32_To_S32;
+	set->resampleMono = FAudio_INTERNAL_ResampleMono;
+	set->resampleStereo = FAudio_INTERNAL_ResampleStereo;
+	set->resampleGeneric = FAudio_INTERNAL_ResampleGeneric;
+	set->resampleSinc = FAudio_INTERNAL_ResampleSinc;
+	set->resampleFixed = FAudio_INTERNAL_ResampleFixed;
+	set->resampleMixMono = FAudio_INTERNAL_ResampleMixMono;
+	set->amplify = FAudio_INTERNAL_Amplify;
+	set->isSilent = FAudio_INTERNAL_IsSilent;
+	set->framePeaks = FAudio_INTERNAL_FramePeaks;
+	set->channelLevels = FAudio_INTERNAL_ChannelLevels;
+	set->filterVoice = FAudio_INTERNAL_FilterVoice;
+	set->processCombBank = FAudio_INTERNAL_ProcessCombBank;
+	set->processBiquadCascade = FAudio_INTERNAL_ProcessBiquadCascade;
+	set->fft = FAudio_INTERNAL_FFT;
+	set->spectrumMAC = FAudio_INTERNAL_SpectrumMAC;
+	set->emitterLanes = FAudio_INTERNAL_EmitterLanes;
+	for (i = 0; i < 12; i += 1)
+	{
+		set->mix[i] = *mixers[i].func;
+	}
+}
+
+/* Test cases */
+
+typedef struct Case
+{
+	/* Parameters */
+	uint32_t frames;	/* Output frames (or samples, for converters) */
+	uint32_t inFrames;
+	uint32_t channels;
+	uint32_t dstChans;
+	uint64_t step;
+	uint64_t offset;
+	uint32_t alignIn;
+	uint32_t alignOut;
+	float volume;
+	FAudioFilterParameters filter;
+	FAudioCombBank combBank;
+	FAudioBiquadCascade cascade;
+	FAudioFFT fft;
+	uint32_t mixer;
+	uint32_t dither[4];	/* All 0 for no dither */
+
+	/* Data, in is also the raw input of the converters */
+	float *in;
+	float *out;
+	float *matrix;
+	float state[STATE_FLOATS];
+	uint64_t resampleOffset;
+
+	/* What gets compared */
+	uint32_t outCount;
+	uint32_t stateCount;
+} Case;
+
+typedef struct Kernel
+{
+	const char *name;
+	float ulps; /* Tolerance, in ULPs at unit scale */
+	void (*prepare)(Case *c, uint8_t bench);
+	void (*run)(const KernelSet *k, Case *c);
+	int (*differs)(const KernelSet *a, const KernelSet *b, const Case *c);
+} Kernel;
+
+static uint32_t rngState = 0x12345678;
+
+static uint32_t Random(void)
+{
+	/* xorshift32, the same sequence on every platform */
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState;
+}
+
+static uint32_t RandomRange(uint32_t lo, uint32_t hi)
+{
+	return lo + (Random() % (hi - lo + 1));
+}
+
+static float RandomFloat(float lo, float hi)
+{
+	return lo + (hi - lo) * ((Random() >> 8) * (1.0f / 16777216.0f));
+}
+
+static void RandomFill(float *data, uint32_t count, float range)
+{
+	uint32_t i;
+	for (i = 0; i < count; i += 1)
+	{
+		data[i] = RandomFloat(-range, range);
+	}
+}
+
+static uint64_t RandomStep(uint8_t bench)
+{
+	if (bench)
+	{
+		return DOUBLE_TO_FIXED(44100.0 / 48000.0);
+	}
+	return DOUBLE_TO_FIXED(RandomFloat(1.0f / MAX_RATIO, (float) MAX_RATIO));
+}
+
+static uint32_t RandomFrames(uint8_t bench)
+{
+	return bench ? BENCH_FRAMES : RandomRange(1, MAX_FRAMES);
+}
+
+static uint32_t RandomAlign(uint8_t bench)
+{
+	return bench ? 0 : RandomRange(0, MAX_ALIGN);
+}
+
+/* Frames read by the linear resamplers, including the one past the end */
+static uint32_t ResampleInFrames(const Case *c)
+{
+	return (uint32_t) (
+		((c->offset & FIXED_FRACTION_MASK) + c->step * c->frames) >>
+		FIXED_PRECISION
+	) + EXTRA_DECODE_PADDING;
+}
+
+/* Converters */
+
+static void PrepareConvert(Case *c, uint8_t bench)
+{
+	c->frames = bench ? BENCH_FRAMES * 2 : RandomRange(1, MAX_FRAMES * 2);
+	c->channels = 1;
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench);
+	RandomFill(c->in, c->frames, 1.0f); /* Random bits, really */
+	c->outCount = c->frames;
+	c->stateCount = 0;
+}
+
+static void RunConvertU8(const KernelSet *k, Case *c)
+{
+	k->convertU8(
+		(const uint8_t*) c->in + c->alignIn,
+		c->out + c->alignOut,
+		c->frames
+	);
+}
+
+static int DiffersConvertU8(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->convertU8 != b->convertU8;
+}
+
+static void RunConvertS16(const KernelSet *k, Case *c)
+{
+	k->convertS16(
+		(const int16_t*) c->in + c->alignIn,
+		c->out + c->alignOut,
+		c->frames
+	);
+}
+
+static int DiffersConvertS16(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->convertS16 != b->convertS16;
+}
+
+static void RunConvertS24(const KernelSet *k, Case *c)
+{
+	k->convertS24(
+		(const uint8_t*) c->in + c->alignIn,
+		c->out + c->alignOut,
+		c->frames
+	);
+}
+
+static int DiffersConvertS24(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->convertS24 != b->convertS24;
+}
+
+/* Each byte unpacks to two nibbles, widened to float to be compared */
+static void PrepareUnpackNibbles(Case *c, uint8_t bench)
+{
+	PrepareConvert(c, bench);
+	c->outCount = c->frames * 2;
+}
+
+static void RunUnpackNibbles(const KernelSet *k, Case *c)
+{
+	static int8_t nibbles[MAX_FRAMES * 4];
+	uint32_t i;
+	k->unpackNibbles(
+		(const uint8_t*) c->in + c->alignIn,
+		nibbles,
+		c->frames
+	);
+	for (i = 0; i < c->frames * 2; i += 1)
+	{
+		c->out[c->alignOut + i] = nibbles[i];
+	}
+}
+
+static int DiffersUnpackNibbles(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->unpackNibbles != b->unpackNibbles;
+}
+
+/* One plane per channel, each MAX_FRAMES apart and misaligned the same way */
+static void PrepareInterleaveF32(Case *c, uint8_t bench)
+{
+	c->frames = RandomFrames(bench);
+	c->channels = bench ? 2 : RandomRange(1, MAX_CHANNELS);
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench);
+	RandomFill(c->in, MAX_FRAMES * c->channels + MAX_ALIGN, 1.0f);
+	c->outCount = c->frames * c->channels;
+	c->stateCount = 0;
+}
+
+static void RunInterleaveF32(const KernelSet *k, Case *c)
+{
+	const float *planes[MAX_CHANNELS];
+	uint32_t i;
+	for (i = 0; i < c->channels; i += 1)
+	{
+		planes[i] = c->in + c->alignIn + (i * MAX_FRAMES);
+	}
+	k->interleaveF32(
+		planes,
+		c->out + c->alignOut,
+		c->frames,
+		c->channels
+	);
+}
+
+static int DiffersInterleaveF32(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->interleaveF32 != b->interleaveF32;
+}
+
+/* Float to integer, a bit past full scale to test clamping. The integers are
+ * compared as floats, followed by the dither state the kernel left behind.
+ */
+
+static void PrepareQuantize(Case *c, uint8_t bench)
+{
+	uint32_t i;
+	uint8_t dither = bench || (Random() & 1);
+	c->frames = bench ? BENCH_FRAMES * 2 : RandomRange(1, MAX_FRAMES * 2);
+	c->channels = 1;
+	c->alignIn = RandomAlign(bench);
+	RandomFill(c->in, c->frames + c->alignIn, 1.25f);
+	for (i = 0; i < 4; i += 1)
+	{
+		c->dither[i] = dither ? (Random() | 1) : 0;
+	}
+	c->alignOut = RandomAlign(bench);
+	c->outCount = c->frames + 4;
+	c->stateCount = 0;
+}
+
+static uint32_t *QuantizeDither(Case *c, uint32_t *dither)
+{
+	if (c->dither[0] == 0)
+	{
+		return NULL;
+	}
+	FAudio_memcpy(dither, c->dither, sizeof(c->dither));
+	return dither;
+}
+
+static void QuantizeState(Case *c, const uint32_t *dither)
+{
+	uint32_t i;
+	for (i = 0; i < 4; i += 1)
+	{
+		c->out[c->alignOut + c->frames + i] = (dither != NULL) ?
+			(float) (dither[i] >> 8) :
+			0.0f;
+	}
+}
+
+static void PrepareQuantizeS16(Case *c, uint8_t bench)
+{
+	PrepareQuantize(c, bench);
+}
+
+static void RunQuantizeS16(const KernelSet *k, Case *c)
+{
+	static int16_t samples[MAX_FRAMES * 2];
+	uint32_t state[4], *dither = QuantizeDither(c, state);
+	uint32_t i;
+	k->quantizeS16(c->in + c->alignIn, samples, c->frames, dither);
+	for (i = 0; i < c->frames; i += 1)
+	{
+		c->out[c->alignOut + i] = samples[i];
+	}
+	QuantizeState(c, dither);
+}
+
+static int DiffersQuantizeS16(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->quantizeS16 != b->quantizeS16;
+}
+
+static void PrepareQuantizeS24(Case *c, uint8_t bench)
+{
+	PrepareQuantize(c, bench);
+}
+
+static void RunQuantizeS24(const KernelSet *k, Case *c)
+{
+	static uint8_t samples[MAX_FRAMES * 2 * 3];
+	uint32_t state[4], *dither = QuantizeDither(c, state);
+	uint32_t i;
+	k->quantizeS24(c->in + c->alignIn, samples, c->frames, dither);
+	for (i = 0; i < c->frames; i += 1)
+	{
+		c->out[c->alignOut + i] = (float) (int32_t) (
+			((uint32_t) samples[i * 3] << 8) |
+			((uint32_t) samples[i * 3 + 1] << 16) |
+			((uint32_t) samples[i * 3 + 2] << 24)
+		) / 256.0f;
+	}
+	QuantizeState(c, dither);
+}
+
+static int DiffersQuantizeS24(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->quantizeS24 != b->quantizeS24;
+}
+
+/* No dither for 32-bit, the top and bottom halves are compared separately
+ * since floats can't hold all of it
+ */
+static void PrepareQuantizeS32(Case *c, uint8_t bench)
+{
+	PrepareQuantize(c, bench);
+	c->outCount = c->frames * 2;
+}
+
+static void RunQuantizeS32(const KernelSet *k, Case *c)
+{
+	static int32_t samples[MAX_FRAMES * 2];
+	uint32_t i;
+	k->quantizeS32(c->in + c->alignIn, samples, c->frames);
+	for (i = 0; i < c->frames; i += 1)
+	{
+		c->out[c->alignOut + i * 2] = (float) (samples[i] >> 16);
+		c->out[c->alignOut + i * 2 + 1] = (float) (samples[i] & 0xFFFF);
+	}
+}
+
+static int DiffersQuantizeS32(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->quantizeS32 != b->quantizeS32;
+}
+
+/* Linear resamplers */
+
+static void PrepareResample(Case *c, uint8_t bench, uint32_t channels)
+{
+	c->frames = RandomFrames(bench);
+	c->channels = channels;
+	c->step = RandomStep(bench);
+	c->offset = bench ? 0 : DOUBLE_TO_FIXED(RandomFloat(0.0f, 0.999f));
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench) * channels; /* Caches hold whole frames */
+	c->inFrames = ResampleInFrames(c);
+	RandomFill(c->in, c->inFrames * c->channels + MAX_ALIGN, 1.0f);
+	c->outCount = c->frames * c->channels;
+	c->stateCount = 0;
+}
+
+static void PrepareResampleMono(Case *c, uint8_t bench)
+{
+	PrepareResample(c, bench, 1);
+}
+
+static void PrepareResampleStereo(Case *c, uint8_t bench)
+{
+	PrepareResample(c, bench, 2);
+}
+
+static void PrepareResampleGeneric(Case *c, uint8_t bench)
+{
+	PrepareResample(c, bench, bench ? 6 : RandomRange(1, MAX_CHANNELS));
+}
+
+#define RESAMPLE_RUN(name, func) \
+	static void Run##name(const KernelSet *k, Case *c) \
+	{ \
+		c->resampleOffset = c->offset; \
+		k->func( \
+			c->in + c->alignIn, \
+			c->out + c->alignOut, \
+			&c->resampleOffset, \
+			c->step, \
+			c->frames, \
+			(uint8_t) c->channels \
+		); \
+	} \
+	static int Differs##name( \
+		const KernelSet *a, \
+		const KernelSet *b, \
+		const Case *c \
+	) { \
+		return a->func != b->func; \
+	}
+RESAMPLE_RUN(ResampleMono, resampleMono)
+RESAMPLE_RUN(ResampleStereo, resampleStereo)
+RESAMPLE_RUN(ResampleGeneric, resampleGeneric)
+#undef RESAMPLE_RUN
+
+/* Windowed sinc resampler */
+
+static void PrepareResampleSinc(Case *c, uint8_t bench)
+{
+	PrepareResample(c, bench, bench ? 2 : RandomRange(1, MAX_CHANNELS));
+	c->stateCount = SINC_HISTORY_FRAMES * c->channels;
+	RandomFill(c->state, c->stateCount, 1.0f);
+}
+
+static void RunResampleSinc(const KernelSet *k, Case *c)
+{
+	c->resampleOffset = c->offset;
+	k->resampleSinc(
+		c->state,
+		c->in + c->alignIn,
+		c->out + c->alignOut,
+		&c->resampleOffset,
+		c->step,
+		c->frames,
+		(uint8_t) c->channels
+	);
+}
+
+static int DiffersResampleSinc(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->resampleSinc != b->resampleSinc;
+}
+
+/* Fixed-ratio submix resampler */
+
+static void PrepareResampleFixed(Case *c, uint8_t bench)
+{
+	c->frames = RandomFrames(bench);
+	c->channels = bench ? 2 : RandomRange(1, MAX_CHANNELS);
+	c->inFrames = FAudio_max(1, (uint32_t) (
+		c->frames * FIXED_TO_DOUBLE(RandomStep(bench))
+	));
+	c->step = ((uint64_t) c->inFrames << FIXED_PRECISION) / c->frames;
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench) * c->channels;
+	RandomFill(c->in, c->inFrames * c->channels + MAX_ALIGN, 1.0f);
+	c->outCount = c->frames * c->channels;
+	c->stateCount = c->channels;
+	RandomFill(c->state, c->stateCount, 1.0f);
+}
+
+static void RunResampleFixed(const KernelSet *k, Case *c)
+{
+	k->resampleFixed(
+		c->state,
+		c->in + c->alignIn,
+		c->inFrames,
+		c->out + c->alignOut,
+		c->frames,
+		c->step,
+		c->channels
+	);
+}
+
+static int DiffersResampleFixed(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->resampleFixed != b->resampleFixed;
+}
+
+/* Fused mono resample and mix */
+
+static void PrepareResampleMixMono(Case *c, uint8_t bench)
+{
+	PrepareResample(c, bench, 1);
+	c->dstChans = bench ? 2 : RandomRange(1, MAX_CHANNELS);
+	c->alignOut = RandomAlign(bench) * c->dstChans;
+	RandomFill(c->matrix, MIX_MATRIX_STRIDE(c->dstChans), 1.0f);
+	c->outCount = c->frames * c->dstChans;
+}
+
+static void RunResampleMixMono(const KernelSet *k, Case *c)
+{
+	k->resampleMixMono(
+		c->in + c->alignIn,
+		c->offset,
+		c->step,
+		c->frames,
+		c->dstChans,
+		c->out + c->alignOut,
+		c->matrix
+	);
+}
+
+static int DiffersResampleMixMono(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->resampleMixMono != b->resampleMixMono;
+}
+
+/* Volume */
+
+static void PrepareAmplify(Case *c, uint8_t bench)
+{
+	c->frames = bench ? BENCH_FRAMES * 2 : RandomRange(1, MAX_FRAMES * 2);
+	c->channels = 1;
+	c->volume = bench ? 0.5f : RandomFloat(0.0f, 2.0f);
+	c->alignOut = RandomAlign(bench);
+	c->outCount = c->frames;
+	c->stateCount = 0;
+}
+
+static void RunAmplify(const KernelSet *k, Case *c)
+{
+	k->amplify(c->out + c->alignOut, c->frames, c->volume);
+}
+
+static int DiffersAmplify(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->amplify != b->amplify;
+}
+
+/* Silence detection, on zeros with at most one sample that may or may not
+ * count as silence
+ */
+
+static void PrepareIsSilent(Case *c, uint8_t bench)
+{
+	static const float specials[] = { 0.0f, -0.0f, 1.0f, -FLT_MIN, FLT_MIN / 4.0f, NAN };
+	c->frames = bench ? BENCH_FRAMES * 2 : RandomRange(1, MAX_FRAMES * 2);
+	c->channels = 1;
+	c->alignIn = RandomAlign(bench);
+	FAudio_zero(c->in, sizeof(float) * (c->frames + MAX_ALIGN));
+	if (!bench)
+	{
+		c->in[c->alignIn + RandomRange(0, c->frames - 1)] = specials[
+			RandomRange(0, (sizeof(specials) / sizeof(specials[0])) - 1)
+		];
+	}
+	c->alignOut = 0;
+	c->outCount = 1;
+	c->stateCount = 0;
+}
+
+static void RunIsSilent(const KernelSet *k, Case *c)
+{
+	c->out[0] = (float) k->isSilent(c->in + c->alignIn, c->frames);
+}
+
+static int DiffersIsSilent(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->isSilent != b->isSilent;
+}
+
+/* Peak detection for the mastering limiter */
+
+static void PrepareFramePeaks(Case *c, uint8_t bench)
+{
+	c->frames = RandomFrames(bench);
+	c->channels = bench ? 8 : RandomRange(1, MAX_CHANNELS);
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench);
+	RandomFill(c->in, c->frames * c->channels + MAX_ALIGN, 1.0f);
+	c->outCount = c->frames;
+	c->stateCount = 0;
+}
+
+static void RunFramePeaks(const KernelSet *k, Case *c)
+{
+	k->framePeaks(
+		c->in + c->alignIn,
+		c->out + c->alignOut,
+		c->frames,
+		c->channels
+	);
+}
+
+static int DiffersFramePeaks(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->framePeaks != b->framePeaks;
+}
+
+/* Levels for the volume meter, the peaks then the sums of every channel */
+
+static void PrepareChannelLevels(Case *c, uint8_t bench)
+{
+	c->frames = RandomFrames(bench);
+	c->channels = bench ? 6 : RandomRange(1, MAX_CHANNELS);
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench);
+	RandomFill(c->in, c->frames * c->channels + MAX_ALIGN, 1.0f);
+	c->outCount = c->channels * 2;
+	c->stateCount = 0;
+}
+
+static void RunChannelLevels(const KernelSet *k, Case *c)
+{
+	k->channelLevels(
+		c->in + c->alignIn,
+		c->out + c->alignOut,
+		c->out + c->alignOut + c->channels,
+		c->frames,
+		c->channels
+	);
+}
+
+static int DiffersChannelLevels(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->channelLevels != b->channelLevels;
+}
+
+/* Filters */
+
+static void PrepareFilterVoice(Case *c, uint8_t bench)
+{
+	c->frames = RandomFrames(bench);
+	c->channels = bench ? 2 : RandomRange(1, MAX_CHANNELS);
+	c->filter.Type = bench ?
+		FAudioLowPassFilter :
+		(FAudioFilterType) RandomRange(0, 3);
+	c->filter.Frequency = bench ? 0.5f : RandomFloat(0.01f, 1.0f);
+	c->filter.OneOverQ = bench ? 1.0f : RandomFloat(0.1f, 1.5f);
+	c->alignOut = RandomAlign(bench) * c->channels;
+	c->outCount = c->frames * c->channels;
+	c->stateCount = 4 * c->channels;
+	RandomFill(c->state, c->stateCount, 0.1f);
+}
+
+static void RunFilterVoice(const KernelSet *k, Case *c)
+{
+	k->filterVoice(
+		&c->filter,
+		(FAudioFilterState*) c->state,
+		c->out + c->alignOut,
+		c->frames,
+		(uint16_t) c->channels
+	);
+}
+
+static int DiffersFilterVoice(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->filterVoice != b->filterVoice;
+}
+
+/* Reverb comb bank, with a short delay line so the feedback comes around */
+
+#define MAX_COMB_CAPACITY 128
+
+static void PrepareProcessCombBank(Case *c, uint8_t bench)
+{
+	FAudioCombBank *bank = &c->combBank;
+	uint32_t k;
+
+	c->frames = RandomFrames(bench);
+	c->channels = 1;
+	c->alignOut = RandomAlign(bench);
+	bank->capacity = RandomRange(2, MAX_COMB_CAPACITY);
+	bank->write_idx = RandomRange(0, bank->capacity - 1);
+	for (k = 0; k < FAUDIO_COMB_BANK_SIZE; k += 1)
+	{
+		/* Small enough to keep the loops stable */
+		bank->delay[k] = RandomRange(1, bank->capacity - 1);
+		bank->read_idx[k] = (
+			bank->write_idx - bank->delay[k] + bank->capacity
+		) % bank->capacity;
+		bank->feedback[k] = RandomFloat(-0.25f, 0.25f);
+		bank->high_shelving.a0[k] = RandomFloat(-0.5f, 0.5f);
+		bank->high_shelving.a1[k] = RandomFloat(-0.5f, 0.5f);
+		bank->high_shelving.b1[k] = RandomFloat(-0.5f, 0.5f);
+		bank->high_shelving.c0[k] = RandomFloat(-0.5f, 0.5f);
+		bank->high_shelving.d0[k] = RandomFloat(-0.5f, 0.5f);
+		bank->low_shelving.a0[k] = RandomFloat(-0.5f, 0.5f);
+		bank->low_shelving.a1[k] = RandomFloat(-0.5f, 0.5f);
+		bank->low_shelving.b1[k] = RandomFloat(-0.5f, 0.5f);
+		bank->low_shelving.c0[k] = RandomFloat(-0.5f, 0.5f);
+		bank->low_shelving.d0[k] = RandomFloat(-0.5f, 0.5f);
+	}
+
+	/* The delay lines come first, then the input */
+	RandomFill(
+		c->in,
+		(bank->capacity * FAUDIO_COMB_BANK_SIZE) + c->frames,
+		1.0f
+	);
+	c->outCount = c->frames;
+	c->stateCount = FAUDIO_COMB_BANK_SIZE * 2;
+	RandomFill(c->state, c->stateCount, 0.1f);
+}
+
+static void RunProcessCombBank(const KernelSet *k, Case *c)
+{
+	static float buffer[MAX_COMB_CAPACITY * FAUDIO_COMB_BANK_SIZE];
+	FAudioCombBank bank = c->combBank;
+
+	bank.buffer = buffer;
+	FAudio_memcpy(
+		buffer,
+		c->in,
+		sizeof(float) * bank.capacity * FAUDIO_COMB_BANK_SIZE
+	);
+	FAudio_memcpy(
+		bank.high_shelving.delay,
+		c->state,
+		sizeof(bank.high_shelving.delay)
+	);
+	FAudio_memcpy(
+		bank.low_shelving.delay,
+		c->state + FAUDIO_COMB_BANK_SIZE,
+		sizeof(bank.low_shelving.delay)
+	);
+	k->processCombBank(
+		&bank,
+		c->in + (bank.capacity * FAUDIO_COMB_BANK_SIZE),
+		c->out + c->alignOut,
+		c->frames
+	);
+	FAudio_memcpy(
+		c->state,
+		bank.high_shelving.delay,
+		sizeof(bank.high_shelving.delay)
+	);
+	FAudio_memcpy(
+		c->state + FAUDIO_COMB_BANK_SIZE,
+		bank.low_shelving.delay,
+		sizeof(bank.low_shelving.delay)
+	);
+}
+
+static int DiffersProcessCombBank(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->processCombBank != b->processCombBank;
+}
+
+/* EQ cascade, in place, with stable poles so the bands don't blow up */
+
+static void PrepareProcessBiquadCascade(Case *c, uint8_t bench)
+{
+	FAudioBiquadCascade *eq = &c->cascade;
+	uint32_t k;
+	float r, theta;
+
+	c->frames = RandomFrames(bench);
+	c->channels = bench ? 2 : RandomRange(1, MAX_CHANNELS);
+	c->alignOut = RandomAlign(bench);
+	eq->stride = FAUDIO_EQ_STRIDE(c->channels);
+	for (k = 0; k < FAUDIO_EQ_BANDS; k += 1)
+	{
+		r = RandomFloat(0.0f, 0.95f);
+		theta = RandomFloat(0.0f, 3.14159f);
+		eq->a0[k] = RandomFloat(0.5f, 1.5f);
+		eq->a1[k] = RandomFloat(-1.0f, 1.0f);
+		eq->a2[k] = RandomFloat(-0.5f, 0.5f);
+		eq->b1[k] = -2.0f * r * cosf(theta);
+		eq->b2[k] = r * r;
+	}
+	RandomFill(c->in, c->frames * c->channels, 1.0f);
+	c->outCount = c->frames * c->channels;
+	c->stateCount = FAUDIO_EQ_BANDS * 2 * eq->stride;
+	RandomFill(c->state, c->stateCount, 0.1f);
+
+	/* Padding lanes only ever hold zeros */
+	for (k = 0; k < FAUDIO_EQ_BANDS * 2; k += 1)
+	{
+		FAudio_zero(
+			c->state + (k * eq->stride) + c->channels,
+			sizeof(float) * (eq->stride - c->channels)
+		);
+	}
+}
+
+static void RunProcessBiquadCascade(const KernelSet *k, Case *c)
+{
+	FAudioBiquadCascade eq = c->cascade;
+
+	eq.delay = c->state;
+	FAudio_memcpy(
+		c->out + c->alignOut,
+		c->in,
+		sizeof(float) * c->frames * c->channels
+	);
+	k->processBiquadCascade(&eq, c->out + c->alignOut, c->frames, c->channels);
+}
+
+static int DiffersProcessBiquadCascade(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->processBiquadCascade != b->processBiquadCascade;
+}
+
+/* FFTs for the convolution reverb, in place, the real parts then the
+ * imaginary parts in out
+ */
+
+#define FFT_MAX_SIZE 1024
+
+static float fftTwiddles[FAUDIO_FFT_TWIDDLES(FFT_MAX_SIZE)];
+
+static void PrepareFFT(Case *c, uint8_t bench)
+{
+	c->frames = bench ? 256 : (16 << (2 * RandomRange(0, 3)));
+	c->channels = 1;
+	c->alignOut = RandomAlign(bench);
+	FAudio_INTERNAL_InitFFT(&c->fft, fftTwiddles, c->frames);
+	RandomFill(c->in, c->frames * 2, 1.0f);
+	c->outCount = c->frames * 2;
+	c->stateCount = 0;
+}
+
+static void RunFFT(const KernelSet *k, Case *c)
+{
+	FAudio_memcpy(
+		c->out + c->alignOut,
+		c->in,
+		sizeof(float) * c->frames * 2
+	);
+	k->fft(&c->fft, c->out + c->alignOut, c->out + c->alignOut + c->frames);
+}
+
+static int DiffersFFT(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->fft != b->fft;
+}
+
+/* Spectrum multiply-accumulate, in has x then h, out is the accumulator */
+
+static void PrepareSpectrumMAC(Case *c, uint8_t bench)
+{
+	c->frames = bench ? 256 : (RandomRange(1, MAX_FRAMES / 8) * 4);
+	c->channels = 1;
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench);
+	RandomFill(c->in, c->frames * 4 + MAX_ALIGN, 1.0f);
+	c->outCount = c->frames * 2;
+	c->stateCount = 0;
+}
+
+static void RunSpectrumMAC(const KernelSet *k, Case *c)
+{
+	const float *x = c->in + c->alignIn;
+	k->spectrumMAC(
+		c->out + c->alignOut,
+		c->out + c->alignOut + c->frames,
+		x,
+		x + c->frames,
+		x + (c->frames * 2),
+		x + (c->frames * 3),
+		c->frames
+	);
+}
+
+static int DiffersSpectrumMAC(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->spectrumMAC != b->spectrumMAC;
+}
+
+/* F3DAudio emitter geometry, in has the listener then the emitters, out gets
+ * every output array, with the NaNs of emitters on the listener replaced
+ */
+
+#define LANE_IN_FLOATS (10 * F3DAUDIO_BATCH_LANES)
+#define LANE_OUT_ARRAYS 12
+#define LANE_NAN -1000.0f
+
+static void PrepareEmitterLanes(Case *c, uint8_t bench)
+{
+	uint32_t i;
+	float *listener = c->in;
+	float *lanes = c->in + 15;
+	c->frames = bench ? F3DAUDIO_BATCH_LANES : (RandomRange(1, F3DAUDIO_BATCH_LANES / 4) * 4);
+	c->channels = 1;
+	c->alignOut = RandomAlign(bench);
+	RandomFill(listener, 15, 1.0f);
+	RandomFill(lanes, LANE_IN_FLOATS, 100.0f);
+	for (i = 0; i < F3DAUDIO_BATCH_LANES; i += 1)
+	{
+		/* Some emitters sit right on the listener */
+		if (!bench && RandomRange(0, 15) == 0)
+		{
+			lanes[0 * F3DAUDIO_BATCH_LANES + i] = listener[9];
+			lanes[1 * F3DAUDIO_BATCH_LANES + i] = listener[10];
+			lanes[2 * F3DAUDIO_BATCH_LANES + i] = listener[11];
+		}
+		lanes[9 * F3DAUDIO_BATCH_LANES + i] = RandomFloat(0.5f, 10.0f);
+	}
+	c->outCount = c->frames * LANE_OUT_ARRAYS;
+	c->stateCount = 0;
+}
+
+static void RunEmitterLanes(const KernelSet *k, Case *c)
+{
+	static F3DAudioEmitterLanes lanes;
+	F3DAudioListenerFrame listener;
+	const float *results = &lanes.toListener[0][0];
+	float *out = c->out + c->alignOut;
+	uint32_t i;
+
+	FAudio_memcpy(&listener, c->in, sizeof(listener));
+	FAudio_memcpy(lanes.position, c->in + 15, sizeof(float) * LANE_IN_FLOATS);
+	k->emitterLanes(&listener, &lanes, c->frames);
+	for (i = 0; i < LANE_OUT_ARRAYS; i += 1)
+	{
+		FAudio_memcpy(
+			out + (i * c->frames),
+			results + (i * F3DAUDIO_BATCH_LANES),
+			sizeof(float) * c->frames
+		);
+	}
+	for (i = 0; i < c->outCount; i += 1)
+	{
+		if (isnan(out[i]))
+		{
+			out[i] = LANE_NAN;
+		}
+	}
+}
+
+static int DiffersEmitterLanes(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->emitterLanes != b->emitterLanes;
+}
+
+/* Mixers, one test for all of them */
+
+static void PrepareMix(Case *c, uint8_t bench)
+{
+	c->mixer = bench ? c->mixer : RandomRange(0, 11);
+	c->channels = mixers[c->mixer].srcChans;
+	c->dstChans = mixers[c->mixer].dstChans;
+	if (c->channels == 0)
+	{
+		c->channels = bench ? 4 : RandomRange(1, MAX_CHANNELS);
+		c->dstChans = bench ? 2 : RandomRange(1, MAX_CHANNELS);
+	}
+	c->frames = RandomFrames(bench);
+	c->alignIn = RandomAlign(bench);
+	c->alignOut = RandomAlign(bench) * c->dstChans;
+	RandomFill(c->in, c->frames * c->channels + MAX_ALIGN, 1.0f);
+	RandomFill(c->matrix, c->channels * MIX_MATRIX_STRIDE(c->dstChans), 1.0f);
+	c->outCount = c->frames * c->dstChans;
+	c->stateCount = 0;
+}
+
+static void RunMix(const KernelSet *k, Case *c)
+{
+	k->mix[c->mixer](
+		c->frames,
+		c->channels,
+		c->dstChans,
+		c->in + c->alignIn,
+		c->out + c->alignOut,
+		c->matrix
+	);
+}
+
+static int DiffersMix(const KernelSet *a, const KernelSet *b, const Case *c)
+{
+	return a->mix[c->mixer] != b->mix[c->mixer];
+}
+
+#define KERNEL(name, ulps) \
+	{ #name, ulps, Prepare##name, Run##name, Differs##name }
+static const Kernel kernels[] =
+{
+	{ "ConvertU8", 0.0f, PrepareConvert, RunConvertU8, DiffersConvertU8 },
+	{ "ConvertS16", 0.0f, PrepareConvert, RunConvertS16, DiffersConvertS16 },
+	{ "ConvertS24", 1.0f, PrepareConvert, RunConvertS24, DiffersConvertS24 },
+	KERNEL(UnpackNibbles, 0.0f),
+	KERNEL(InterleaveF32, 0.0f),
+	KERNEL(QuantizeS16, 0.0f),
+	KERNEL(QuantizeS24, 0.0f),
+	KERNEL(QuantizeS32, 0.0f),
+	KERNEL(ResampleMono, 4.0f),
+	KERNEL(ResampleStereo, 4.0f),
+	KERNEL(ResampleGeneric, 4.0f),
+	KERNEL(ResampleSinc, 8.0f),
+	KERNEL(ResampleFixed, 4.0f),
+	KERNEL(ResampleMixMono, 8.0f),
+	KERNEL(Amplify, 0.0f),
+	KERNEL(IsSilent, 0.0f),
+	KERNEL(FramePeaks, 0.0f),
+	KERNEL(ChannelLevels, 64.0f),
+	KERNEL(FilterVoice, 0.0f),
+	KERNEL(ProcessCombBank, 0.0f),
+	KERNEL(ProcessBiquadCascade, 0.0f),
+	KERNEL(FFT, 0.0f),
+	KERNEL(SpectrumMAC, 0.0f),
+	KERNEL(EmitterLanes, 2.0f),
+	{ "Mix", 4.0f, PrepareMix, RunMix, DiffersMix }
+};
+#undef KERNEL
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+/* Tiers */
+
+typedef struct Tier
+{
+	const char *name;
+	uint8_t hasSSE2, hasAVX2, hasNEON;
+	uint8_t supported;
+	KernelSet kernels;
+} Tier;
+
+/* Errors are measured in ULPs of the larger of the result and 1.0, since the
+ * SIMD versions may round differently and most of the signal is near 0.
+ */
+static float ErrorULPs(float expected, float actual)
+{
+	float scale = FAudio_max(fabsf(expected), 1.0f);
+	if (expected == actual)
+	{
+		return 0.0f;
+	}
+	if (isnan(expected) || isnan(actual))
+	{
+		return FLT_MAX;
+	}
+	return fabsf(expected - actual) / (scale * FLT_EPSILON);
+}
+
+static float Compare(
+	const float *expected,
+	const float *actual,
+	uint32_t count,
+	uint32_t *worst
+) {
+	uint32_t i;
+	float err, maxErr = 0.0f;
+	for (i = 0; i < count; i += 1)
+	{
+		err = ErrorULPs(expected[i], actual[i]);
+		if (err > maxErr)
+		{
+			maxErr = err;
+			*worst = i;
+		}
+	}
+	return maxErr;
+}
+
+static uint32_t Verify(
+	const Kernel *kernel,
+	const Tier *scalar,
+	const Tier *tier,
+	Case *c,
+	float *initOut,
+	float *refOut,
+	uint32_t trials,
+	float *maxErr
+) {
+	uint32_t i, worst, failed = 0;
+	uint32_t outFloats;
+	float refState[STATE_FLOATS], initState[STATE_FLOATS];
+	uint64_t refOffset;
+	float err;
+
+	*maxErr = 0.0f;
+	for (i = 0; i < trials; i += 1)
+	{
+		kernel->prepare(c, 0);
+		if (!kernel->differs(&scalar->kernels, &tier->kernels, c))
+		{
+			continue;
+		}
+
+		/* Both runs start from the same output and state */
+		outFloats = c->alignOut + c->outCount + MAX_ALIGN;
+		RandomFill(initOut, outFloats, 1.5f);
+		FAudio_memcpy(initState, c->state, sizeof(c->state));
+
+		FAudio_memcpy(c->out, initOut, sizeof(float) * outFloats);
+		kernel->run(&scalar->kernels, c);
+		FAudio_memcpy(refOut, c->out, sizeof(float) * outFloats);
+		FAudio_memcpy(refState, c->state, sizeof(c->state));
+		refOffset = c->resampleOffset;
+
+		FAudio_memcpy(c->out, initOut, sizeof(float) * outFloats);
+		FAudio_memcpy(c->state, initState, sizeof(c->state));
+		kernel->run(&tier->kernels, c);
+
+		/* Everything outside the output has to be left alone */
+		worst = 0;
+		err = Compare(refOut, c->out, outFloats, &worst);
+		if (err > kernel->ulps)
+		{
+			printf(
+				"FAILED: %s %s: frames %u, channels %u->%u, align %u/%u: "
+				"out[%u] is %.9g, expected %.9g (%.1f ULPs)\n",
+				kernel->name,
+				tier->name,
+				c->frames,
+				c->channels,
+				c->dstChans,
+				c->alignIn,
+				c->alignOut,
+				worst,
+				c->out[worst],
+				refOut[worst],
+				err
+			);
+			failed += 1;
+		}
+		*maxErr = FAudio_max(*maxErr, err);
+
+		err = Compare(refState, c->state, c->stateCount, &worst);
+		if (err > kernel->ulps)
+		{
+			printf(
+				"FAILED: %s %s: frames %u, channels %u: "
+				"state[%u] is %.9g, expected %.9g\n",
+				kernel->name,
+				tier->name,
+				c->frames,
+				c->channels,
+				worst,
+				c->state[worst],
+				refState[worst]
+			);
+			failed += 1;
+		}
+		*maxErr = FAudio_max(*maxErr, err);
+
+		if (refOffset != c->resampleOffset)
+		{
+			printf(
+				"FAILED: %s %s: frames %u: resample offset is "
+				"%llu, expected %llu\n",
+				kernel->name,
+				tier->name,
+				c->frames,
+				(unsigned long long) c->resampleOffset,
+				(unsigned long long) refOffset
+			);
+			failed += 1;
+		}
+	}
+	return failed;
+}
+
+/* Best of a few runs, per output sample */
+static double Bench(const Kernel *kernel, const Tier *tier, Case *c)
+{
+	uint32_t run, rep;
+	uint64_t start, best = ~(uint64_t) 0;
+	float state[STATE_FLOATS];
+
+	kernel->prepare(c, 1);
+	RandomFill(c->out, c->outCount, 1.0f);
+	FAudio_memcpy(state, c->state, sizeof(state));
+	for (run = 0; run < BENCH_RUNS; run += 1)
+	{
+		start = BENCH_CLOCK();
+		for (rep = 0; rep < BENCH_REPS; rep += 1)
+		{
+			kernel->run(&tier->kernels, c);
+			FAudio_memcpy(c->state, state, sizeof(state));
+		}
+		best = FAudio_min(best, BENCH_CLOCK() - start);
+	}
+	return (double) best / ((double) BENCH_REPS * c->outCount);
+}
+
+int main(int argc, char **argv)
+{
+	Tier tiers[] =
+	{
+		{ "Scalar", 0, 0, 0, 1 },
+		{ "SSE2", 1, 0, 0, 0 },
+		{ "AVX2", 1, 1, 0, 0 },
+		{ "NEON", 0, 0, 1, 0 }
+	};
+	const uint32_t tierCount = sizeof(tiers) / sizeof(tiers[0]);
+	uint32_t trials = (argc > 1) ? (uint32_t) atoi(argv[1]) : 200;
+	uint32_t i, k, m, failed = 0;
+	float *inData, *outData, *initOut, *refOut, *matrix;
+	float maxErr;
+	double base, perSample;
+	Case c;
+
+	tiers[1].supported = SDL_HasSSE2();
+	tiers[2].supported = SDL_HasSSE2() && SDL_HasAVX2();
+	tiers[3].supported = SDL_HasNEON();
+	for (i = 0; i < tierCount; i += 1)
+	{
+		GetKernels(
+			&tiers[i].kernels,
+			tiers[i].hasSSE2,
+			tiers[i].hasAVX2,
+			tiers[i].hasNEON
+		);
+	}
+
+	inData = (float*) malloc(sizeof(float) * BUFFER_FLOATS);
+	outData = (float*) malloc(sizeof(float) * BUFFER_FLOATS);
+	initOut = (float*) malloc(sizeof(float) * BUFFER_FLOATS);
+	refOut = (float*) malloc(sizeof(float) * BUFFER_FLOATS);
+	matrix = (float*) malloc(sizeof(float) * MAX_CHANNELS * MAX_CHANNELS);
+
+	FAudio_zero(&c, sizeof(c));
+	c.in = inData;
+	c.out = outData;
+	c.matrix = matrix;
+
+	/* Correctness first, against the scalar kernels */
+	printf("%-16s %-8s %10s\n", "kernel", "tier", "max ULPs");
+	for (k = 0; k < KERNEL_COUNT; k += 1)
+	for (i = 1; i < tierCount; i += 1)
+	{
+		if (!tiers[i].supported)
+		{
+			continue;
+		}
+		failed += Verify(
+			&kernels[k],
+			&tiers[0],
+			&tiers[i],
+			&c,
+			initOut,
+			refOut,
+			trials,
+			&maxErr
+		);
+		printf("%-16s %-8s %10.1f\n", kernels[k].name, tiers[i].name, maxErr);
+	}
+
+	/* Then speed, on one period at 44.1kHz -> 48kHz */
+	printf("\n%-16s %-8s %10s %8s\n", "kernel", "tier", BENCH_UNIT "/smp", "speedup");
+	for (k = 0; k < KERNEL_COUNT; k += 1)
+	for (m = 0; m < ((kernels[k].run == RunMix) ? 12 : 1); m += 1)
+	{
+		c.mixer = m;
+		base = 0.0;
+		for (i = 0; i < tierCount; i += 1)
+		{
+			if (!tiers[i].supported)
+			{
+				continue;
+			}
+			if (	i > 0 &&
+				!kernels[k].differs(&tiers[0].kernels, &tiers[i].kernels, &c)	)
+			{
+				continue;
+			}
+			perSample = Bench(&kernels[k], &tiers[i], &c);
+			if (i == 0)
+			{
+				base = perSample;
+			}
+			printf(
+				"%-16s %-8s %10.3f %7.2fx\n",
+				(kernels[k].run == RunMix) ? mixers[m].name : kernels[k].name,
+				tiers[i].name,
+				perSample,
+				base / perSample
+			);
+		}
+	}
+
+	free(inData);
+	free(outData);
+	free(initOut);
+	free(refOut);
+	free(matrix);
+
+	if (failed > 0)
+	{
+		printf("\n%u comparisons failed\n", failed);
+		return 1;
+	}
+	printf("\nAll kernels match the scalar versions\n");
+	return 0;
+}
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -2,7 +2,8 @@
  *
  * This tests behavior of Microsoft's XAudio2. Tests in this file should be
  * written to the XAudio2 API. FAudio_compat.h provides conversion from XAudio2
- * to FAudio to verify FAudio's behavior.
+ * to FAudio to verify FAudio's behavior. Run with --perf to time mixing
+ * scenarios instead, see "Performance tests" below.
  *
  * Copyright (c) 2015-2018 Andrew Eikum for CodeWeavers
  * Copyright (c) 2018 Masanori Kakura
@@ -39,18 +40,20 @@
 #include "FAudio.h"
 #include "FAudioFX.h"
 #include "FAPO.h"
+#include "FAPOFX.h"
 
 #include "FAudio_compat.h"
 
 #include <stdarg.h>
-#include <stdlib.h>
-#include <string.h>
+#include <time.h>
 #include <unistd.h>
 #endif
 
 #include <inttypes.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 static void *FAtest_malloc(size_t len)
 {
@@ -1216,18 +1219,712 @@ static void test_setchannelvolumes(IXAudio2 *xa)
     IXAudio2MasteringVoice_DestroyVoice(master);
 }
 
+static void test_operationsets(IXAudio2 *xa)
+{
+    HRESULT hr;
+    IXAudio2MasteringVoice *master;
+    IXAudio2SourceVoice *src;
+    WAVEFORMATEX fmt;
+    float vol, ratio;
+    int i;
+
+    if(xaudio27)
+        hr = IXAudio27_CreateMasteringVoice((IXAudio27*)xa, &master, 2, 44100, 0, 0, NULL);
+    else
+        hr = IXAudio2_CreateMasteringVoice(xa, &master, 2, 44100, 0,
+#ifdef _WIN32
+                NULL /*WCHAR *deviceID*/, NULL, AudioCategory_GameEffects);
+#else
+                0 /*int deviceIndex*/, NULL);
+#endif
+    ok(hr == S_OK, "CreateMasteringVoice failed: %08x\n", hr);
+
+    fmt.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+    fmt.nChannels = 2;
+    fmt.nSamplesPerSec = 44100;
+    fmt.wBitsPerSample = 32;
+    fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+
+    XA2CALL(CreateSourceVoice, &src, &fmt, 0, 2.f, NULL, NULL, NULL);
+    ok(hr == S_OK, "CreateSourceVoice failed: %08x\n", hr);
+
+    hr = IXAudio2SourceVoice_SetVolume(src, 0.5f, 1);
+    ok(hr == S_OK, "SetVolume failed: %08x\n", hr);
+
+    hr = IXAudio2SourceVoice_SetFrequencyRatio(src, 2.f, 2);
+    ok(hr == S_OK, "SetFrequencyRatio failed: %08x\n", hr);
+
+    /* nothing changes until the set is committed */
+    FAtest_sleep(50);
+    IXAudio2SourceVoice_GetVolume(src, &vol);
+    ok(vol == 1.f, "Volume changed before commit: %f\n", vol);
+
+    XA2CALL(CommitChanges, 1);
+    ok(hr == S_OK, "CommitChanges failed: %08x\n", hr);
+
+    /* ... and then only on the next processing pass */
+    for(i = 0; i < 50; ++i){
+        IXAudio2SourceVoice_GetVolume(src, &vol);
+        if(vol != 1.f)
+            break;
+        FAtest_sleep(10);
+    }
+    ok(vol == 0.5f, "Committed volume not applied: %f\n", vol);
+
+    IXAudio2SourceVoice_GetFrequencyRatio(src, &ratio);
+    ok(ratio == 1.f, "Uncommitted ratio applied: %f\n", ratio);
+
+    XA2CALL(CommitChanges, XAUDIO2_COMMIT_ALL);
+    ok(hr == S_OK, "CommitChanges failed: %08x\n", hr);
+
+    for(i = 0; i < 50; ++i){
+        IXAudio2SourceVoice_GetFrequencyRatio(src, &ratio);
+        if(ratio != 1.f)
+            break;
+        FAtest_sleep(10);
+    }
+    ok(ratio == 2.f, "Committed ratio not applied: %f\n", ratio);
+
+    /* pending operations must not outlive their voice */
+    hr = IXAudio2SourceVoice_SetVolume(src, 0.25f, 3);
+    ok(hr == S_OK, "SetVolume failed: %08x\n", hr);
+
+    if(xaudio27)
+        IXAudio27SourceVoice_DestroyVoice((IXAudio27SourceVoice*)src);
+    else
+        IXAudio2SourceVoice_DestroyVoice(src);
+
+    XA2CALL(CommitChanges, XAUDIO2_COMMIT_ALL);
+    ok(hr == S_OK, "CommitChanges failed: %08x\n", hr);
+    FAtest_sleep(50);
+
+    IXAudio2MasteringVoice_DestroyVoice(master);
+}
+
+static void test_silent_voice(IXAudio2 *xa)
+{
+    HRESULT hr;
+    IXAudio2MasteringVoice *master;
+    IXAudio2SourceVoice *src;
+    WAVEFORMATEX fmt;
+    XAUDIO2_BUFFER buf;
+    XAUDIO2_VOICE_STATE state;
+    int i;
+
+    XA2CALL_0V(StopEngine);
+
+    if(xaudio27)
+        hr = IXAudio27_CreateMasteringVoice((IXAudio27*)xa, &master, 2, 44100, 0, 0, NULL);
+    else
+        hr = IXAudio2_CreateMasteringVoice(xa, &master, 2, 44100, 0,
+#ifdef _WIN32
+                NULL /*WCHAR *deviceID*/, NULL, AudioCategory_GameEffects);
+#else
+                0 /*int deviceIndex*/, NULL);
+#endif
+    ok(hr == S_OK, "CreateMasteringVoice failed: %08x\n", hr);
+
+    fmt.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
+    fmt.nChannels = 2;
+    fmt.nSamplesPerSec = 44100;
+    fmt.wBitsPerSample = 32;
+    fmt.nBlockAlign = fmt.nChannels * fmt.wBitsPerSample / 8;
+    fmt.nAvgBytesPerSec = fmt.nSamplesPerSec * fmt.nBlockAlign;
+    fmt.cbSize = 0;
+
+    XA2CALL(CreateSourceVoice, &src, &fmt, 0, 1.f, NULL, NULL, NULL);
+    ok(hr == S_OK, "CreateSourceVoice failed: %08x\n", hr);
+
+    /* an inaudible voice still has to play through its buffers */
+    hr = IXAudio2SourceVoice_SetVolume(src, 0.f, XAUDIO2_COMMIT_NOW);
+    ok(hr == S_OK, "SetVolume failed: %08x\n", hr);
+
+    memset(&buf, 0, sizeof(buf));
+    buf.AudioBytes = 4410 * fmt.nBlockAlign;
+    buf.pAudioData = FAtest_malloc(buf.AudioBytes);
+    fill_buf((float*)buf.pAudioData, &fmt, 440, 4410);
+
+    hr = IXAudio2SourceVoice_SubmitSourceBuffer(src, &buf, NULL);
+    ok(hr == S_OK, "SubmitSourceBuffer failed: %08x\n", hr);
+
+    hr = IXAudio2SourceVoice_Start(src, 0, XAUDIO2_COMMIT_NOW);
+    ok(hr == S_OK, "Start failed: %08x\n", hr);
+
+    XA2CALL_0(StartEngine);
+    ok(hr == S_OK, "StartEngine failed: %08x\n", hr);
+
+    for(i = 0; i < 100; ++i){
+        if(xaudio27)
+            IXAudio27SourceVoice_GetState((IXAudio27SourceVoice*)src, &state);
+        else
+            IXAudio2SourceVoice_GetState(src, &state, 0);
+        if(state.BuffersQueued == 0)
+            break;
+        FAtest_sleep(10);
+    }
+    ok(state.BuffersQueued == 0, "Silent voice didn't finish its buffer\n");
+    ok(state.SamplesPlayed == 4410, "Got wrong samples played: %u\n", (UINT32)state.SamplesPlayed);
+
+    if(xaudio27)
+        IXAudio27SourceVoice_DestroyVoice((IXAudio27SourceVoice*)src);
+    else
+        IXAudio2SourceVoice_DestroyVoice(src);
+    IXAudio2MasteringVoice_DestroyVoice(master);
+
+    FAtest_free((void*)buf.pAudioData);
+}
+
+/* Performance tests
+ *
+ * With --perf, the tests above are skipped and these scenarios are timed
+ * instead. Each one runs until the engine has made a number of processing
+ * passes, timing every pass from OnProcessingPassStart to
+ * OnProcessingPassEnd. Since those callbacks surround the whole mix on both
+ * FAudio and XAudio2, the same build run against each gives a like-for-like
+ * comparison:
+ *
+ *   faudio_tests.exe --perf --save native.txt        (XAudio2, on Windows)
+ *   faudio_tests --perf --baseline native.txt --threshold 25
+ *
+ * --baseline fails any scenario whose median or 95th percentile pass is more
+ * than --threshold percent (25 by default) slower than the baseline's, and
+ * --passes sets how many passes each scenario times (200 by default).
+ */
+
+#define PERF_MAX_BASELINES 32
+#define PERF_WARMUP_PASSES 20
+
+static struct _perf_state {
+    double *times;
+    double start;
+    volatile UINT32 count;
+    UINT32 warmup, passes;
+} perf_state;
+
+static struct _perf_result {
+    char name[64];
+    double p50, p95, p99, max;
+} perf_baselines[PERF_MAX_BASELINES];
+
+static UINT32 perf_baseline_count = 0;
+static UINT32 perf_passes = 200;
+static double perf_threshold = 25.0;
+static FILE *perf_save = NULL;
+
+#ifdef _WIN32
+static HRESULT (WINAPI *pCreateAudioReverb)(IUnknown**) = NULL;
+static HRESULT (__cdecl *pCreateFX27)(REFCLSID, IUnknown**) = NULL;
+static HRESULT (__cdecl *pCreateFX)(REFCLSID, IUnknown**) = NULL;
+typedef IUnknown perf_effect;
+#else
+typedef FAPO perf_effect;
+#endif
+
+static double perf_now(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter, freq;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&freq);
+    return counter.QuadPart * 1000000.0 / freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+#endif
+}
+
+static void WINAPI PERF_OnProcessingPassStart(IXAudio2EngineCallback *This)
+{
+    perf_state.start = perf_now();
+}
+
+static void WINAPI PERF_OnProcessingPassEnd(IXAudio2EngineCallback *This)
+{
+    double elapsed = perf_now() - perf_state.start;
+
+    if(perf_state.warmup > 0){
+        --perf_state.warmup;
+        return;
+    }
+    if(perf_state.count < perf_state.passes){
+        perf_state.times[perf_state.count] = elapsed;
+        ++perf_state.count;
+    }
+}
+
+#if _WIN32
+static IXAudio2EngineCallbackVtbl perf_ecb_vtbl = {
+    PERF_OnProcessingPassStart,
+    PERF_OnProcessingPassEnd,
+    ECB_OnCriticalError
+};
+
+static IXAudio2EngineCallback perf_ecb = { &perf_ecb_vtbl };
+#else
+static FAudioEngineCallback perf_ecb = {
+    ECB_OnCriticalError,
+    PERF_OnProcessingPassEnd,
+    PERF_OnProcessingPassStart
+};
+#endif
+
+static int perf_compare(const void *a, const void *b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static BOOL perf_load_baseline(const char *path)
+{
+    FILE *f;
+    char line[256];
+    struct _perf_result *r;
+
+    f = fopen(path, "r");
+    if(!f)
+        return FALSE;
+
+    while(fgets(line, sizeof(line), f) && perf_baseline_count < PERF_MAX_BASELINES){
+        if(line[0] == '#')
+            continue;
+        r = &perf_baselines[perf_baseline_count];
+        if(sscanf(line, "%63s %lf %lf %lf %lf", r->name, &r->p50, &r->p95, &r->p99, &r->max) == 5)
+            ++perf_baseline_count;
+    }
+
+    fclose(f);
+    return TRUE;
+}
+
+static const struct _perf_result *perf_find_baseline(const char *name)
+{
+    UINT32 i;
+    for(i = 0; i < perf_baseline_count; ++i)
+        if(!strcmp(perf_baselines[i].name, name))
+            return &perf_baselines[i];
+    return NULL;
+}
+
+static void perf_check(const char *name, const char *stat, double value, double baseline)
+{
+    double limit = baseline * (1.0 + perf_threshold / 100.0);
+    ok(value <= limit, "%s: %s pass took %.1f us, baseline is %.1f us + %.0f%%\n",
+            name, stat, value, baseline, perf_threshold);
+}
+
+/* Plays the scenario's voices until enough passes are timed, then reports */
+static void perf_run(IXAudio2 *xa, const char *scenario)
+{
+    HRESULT hr;
+    struct _perf_result result;
+    const struct _perf_result *baseline;
+    UINT32 waited, last;
+
+    snprintf(result.name, sizeof(result.name), "%s/%s",
+            xaudio27 ? "xaudio2.7" : "xaudio2.8", scenario);
+
+    perf_state.times = FAtest_malloc(sizeof(double) * perf_passes);
+    perf_state.count = 0;
+    perf_state.warmup = PERF_WARMUP_PASSES;
+    perf_state.passes = perf_passes;
+
+    XA2CALL(RegisterForCallbacks, &perf_ecb);
+    ok(hr == S_OK, "RegisterForCallbacks failed: %08x\n", hr);
+
+    XA2CALL_0(StartEngine);
+    ok(hr == S_OK, "StartEngine failed: %08x\n", hr);
+
+    /* Passes take as long as the device period, so just wait while they come */
+    last = 0;
+    for(waited = 0; perf_state.count < perf_passes && waited < 1000; waited += 10){
+        if(perf_state.count != last){
+            last = perf_state.count;
+            waited = 0;
+        }
+        FAtest_sleep(10);
+    }
+
+    XA2CALL_0V(StopEngine);
+    XA2CALL_V(UnregisterForCallbacks, &perf_ecb);
+
+    ok(perf_state.count == perf_passes, "%s: only %u of %u passes were made\n",
+            result.name, perf_state.count, perf_passes);
+    if(perf_state.count == 0){
+        FAtest_free(perf_state.times);
+        return;
+    }
+
+    qsort(perf_state.times, perf_state.count, sizeof(double), perf_compare);
+    result.p50 = perf_state.times[(perf_state.count - 1) * 50 / 100];
+    result.p95 = perf_state.times[(perf_state.count - 1) * 95 / 100];
+    result.p99 = perf_state.times[(perf_state.count - 1) * 99 / 100];
+    result.max = perf_state.times[perf_state.count - 1];
+    FAtest_free(perf_state.times);
+
+    fprintf(stdout, "%-36s %4u passes, p50 %8.1f  p95 %8.1f  p99 %8.1f  max %8.1f us\n",
+            result.name, perf_state.count, result.p50, result.p95, result.p99, result.max);
+
+    if(perf_save)
+        fprintf(perf_save, "%s %.1f %.1f %.1f %.1f\n",
+                result.name, result.p50, result.p95, result.p99, result.max);
+
+    baseline = perf_find_baseline(result.name);
+    if(baseline){
+        perf_check(result.name, "median", result.p50, baseline->p50);
+        perf_check(result.name, "95th percentile", result.p95, baseline->p95);
+    }else if(perf_baseline_count > 0)
+        fprintf(stdout, "%s: no baseline\n", result.name);
+}
+
+static HRESULT perf_create_master(IXAudio2 *xa, IXAudio2MasteringVoice **master, UINT32 channels)
+{
+    HRESULT hr;
+
+    if(xaudio27)
+        hr = IXAudio27_CreateMasteringVoice((IXAudio27*)xa, master, channels, 48000, 0, 0, NULL);
+    else
+        hr = IXAudio2_CreateMasteringVoice(xa, master, channels, 48000, 0,
+#ifdef _WIN32
+                NULL /*WCHAR *deviceID*/, NULL, AudioCategory_GameEffects);
+#else
+                0 /*int deviceIndex*/, NULL);
+#endif
+    ok(hr == S_OK, "CreateMasteringVoice failed: %08x\n", hr);
+    return hr;
+}
+
+static HRESULT perf_create_reverb(perf_effect **reverb)
+{
+    HRESULT hr;
+#ifdef _WIN32
+    if(xaudio27)
+        hr = CoCreateInstance(&CLSID_AudioReverb27, NULL,
+                CLSCTX_INPROC_SERVER, &IID_IUnknown, (void**)reverb);
+    else
+        hr = pCreateAudioReverb(reverb);
+#else
+    hr = FAudioCreateReverb(reverb, 0);
+#endif
+    ok(hr == S_OK, "Creating reverb failed: %08x\n", hr);
+    return hr;
+}
+
+static HRESULT perf_create_limiter(perf_effect **limiter)
+{
+    HRESULT hr;
+#ifdef _WIN32
+    HRESULT (__cdecl *create)(REFCLSID, IUnknown**) = xaudio27 ? pCreateFX27 : pCreateFX;
+    if(!create)
+        return E_FAIL;
+    hr = create(&CLSID_FXMasteringLimiter, limiter);
+#else
+    hr = FAPOFX_CreateFX(&FAPOFX_CLSID_FXMasteringLimiter, limiter, NULL, 0);
+#endif
+    ok(hr == S_OK, "Creating limiter failed: %08x\n", hr);
+    return hr;
+}
+
+static void perf_release_effect(perf_effect *effect)
+{
+#ifdef _WIN32
+    IUnknown_Release(effect);
+#else
+    effect->Release(effect);
+#endif
+}
+
+/* A second of a looping 441Hz triangle wave, mono PCM16 at 44100Hz */
+static void perf_fill_pcm16(WAVEFORMATEX *fmt, XAUDIO2_BUFFER *buf)
+{
+    int16_t *samples;
+    DWORD i;
+
+    fmt->wFormatTag = WAVE_FORMAT_PCM;
+    fmt->nChannels = 1;
+    fmt->nSamplesPerSec = 44100;
+    fmt->wBitsPerSample = 16;
+    fmt->nBlockAlign = fmt->nChannels * fmt->wBitsPerSample / 8;
+    fmt->nAvgBytesPerSec = fmt->nSamplesPerSec * fmt->nBlockAlign;
+    fmt->cbSize = 0;
+
+    memset(buf, 0, sizeof(*buf));
+    buf->AudioBytes = 44100 * fmt->nBlockAlign;
+    buf->pAudioData = FAtest_malloc(buf->AudioBytes);
+    buf->LoopCount = XAUDIO2_LOOP_INFINITE;
+
+    samples = (int16_t*)buf->pAudioData;
+    for(i = 0; i < 44100; ++i){
+        int32_t phase = i % 100;
+        samples[i] = (int16_t)((phase < 50 ? phase : 100 - phase) * 640 - 16000);
+    }
+}
+
+static void perf_pcm16_submix_reverb(IXAudio2 *xa)
+{
+    HRESULT hr;
+    IXAudio2MasteringVoice *master;
+    IXAudio2SubmixVoice *subs[2];
+    IXAudio2SourceVoice *srcs[256];
+    perf_effect *reverb;
+    WAVEFORMATEX fmt;
+    XAUDIO2_BUFFER buf;
+    XAUDIO2_EFFECT_DESCRIPTOR effect;
+    XAUDIO2_EFFECT_CHAIN chain;
+    XAUDIO2_SEND_DESCRIPTOR send;
+    XAUDIO2_VOICE_SENDS sends;
+    int i;
+
+    XA2CALL_0V(StopEngine);
+
+    if(perf_create_master(xa, &master, 2) != S_OK)
+        return;
+
+    for(i = 0; i < 2; ++i){
+        XA2CALL(CreateSubmixVoice, &subs[i], 2, 48000, 0, 0, NULL, NULL);
+        ok(hr == S_OK, "CreateSubmixVoice failed: %08x\n", hr);
+
+        if(perf_create_reverb(&reverb) == S_OK){
+            effect.InitialState = TRUE;
+            effect.OutputChannels = 2;
+            effect.pEffect = reverb;
+            chain.EffectCount = 1;
+            chain.pEffectDescriptors = &effect;
+            hr = IXAudio2SubmixVoice_SetEffectChain(subs[i], &chain);
+            ok(hr == S_OK, "SetEffectChain failed: %08x\n", hr);
+            perf_release_effect(reverb);
+        }
+    }
+
+    perf_fill_pcm16(&fmt, &buf);
+
+    sends.SendCount = 1;
+    sends.pSends = &send;
+    send.Flags = 0;
+    for(i = 0; i < 256; ++i){
+        send.pOutputVoice = (IXAudio2Voice*)subs[i % 2];
+        XA2CALL(CreateSourceVoice, &srcs[i], &fmt, 0, 1.f, NULL, &sends, NULL);
+        ok(hr == S_OK, "CreateSourceVoice failed: %08x\n", hr);
+
+        hr = IXAudio2SourceVoice_SubmitSourceBuffer(srcs[i], &buf, NULL);
+        ok(hr == S_OK, "SubmitSourceBuffer failed: %08x\n", hr);
+
+        hr = IXAudio2SourceVoice_Start(srcs[i], 0, XAUDIO2_COMMIT_NOW);
+        ok(hr == S_OK, "Start failed: %08x\n", hr);
+    }
+
+    perf_run(xa, "pcm16_submix_reverb");
+
+    for(i = 0; i < 256; ++i){
+        if(xaudio27)
+            IXAudio27SourceVoice_DestroyVoice((IXAudio27SourceVoice*)srcs[i]);
+        else
+            IXAudio2SourceVoice_DestroyVoice(srcs[i]);
+    }
+    IXAudio2SubmixVoice_DestroyVoice(subs[0]);
+    IXAudio2SubmixVoice_DestroyVoice(subs[1]);
+    IXAudio2MasteringVoice_DestroyVoice(master);
+
+    FAtest_free((void*)buf.pAudioData);
+}
+
+static void perf_adpcm_filters(IXAudio2 *xa)
+{
+    static const ADPCMCOEFSET coefs[7] = {
+        { 256, 0 }, { 512, -256 }, { 0, 0 }, { 192, 64 },
+        { 240, 0 }, { 460, -208 }, { 392, -232 }
+    };
+    struct {
+        WAVEFORMATEX wfx;
+        uint16_t wSamplesPerBlock;
+        uint16_t wNumCoef;
+        ADPCMCOEFSET aCoef[7];
+    } fmt;
+    HRESULT hr;
+    IXAudio2MasteringVoice *master;
+    IXAudio2SourceVoice *srcs[64];
+    XAUDIO2_BUFFER buf;
+    XAUDIO2_FILTER_PARAMETERS filter;
+    uint8_t *block;
+    uint32_t seed = 1;
+    int i, j;
+
+    XA2CALL_0V(StopEngine);
+
+    if(perf_create_master(xa, &master, 2) != S_OK)
+        return;
+
+    /* Mono MSADPCM in the usual 512 samples per block */
+    fmt.wfx.wFormatTag = WAVE_FORMAT_ADPCM;
+    fmt.wfx.nChannels = 1;
+    fmt.wfx.nSamplesPerSec = 44100;
+    fmt.wfx.wBitsPerSample = 4;
+    fmt.wfx.nBlockAlign = 7 + (512 - 2) / 2;
+    fmt.wfx.nAvgBytesPerSec = 44100 / 512 * fmt.wfx.nBlockAlign;
+    fmt.wfx.cbSize = sizeof(fmt) - sizeof(fmt.wfx);
+    fmt.wSamplesPerBlock = 512;
+    fmt.wNumCoef = 7;
+    memcpy(fmt.aCoef, coefs, sizeof(coefs));
+
+    /* About a second of blocks with noise in them, so decoding does work */
+    memset(&buf, 0, sizeof(buf));
+    buf.AudioBytes = 88 * fmt.wfx.nBlockAlign;
+    buf.pAudioData = FAtest_malloc(buf.AudioBytes);
+    buf.LoopCount = XAUDIO2_LOOP_INFINITE;
+    for(i = 0; i < 88; ++i){
+        block = (uint8_t*)buf.pAudioData + i * fmt.wfx.nBlockAlign;
+        memset(block, 0, 7);
+        block[0] = i % 7; /* predictor */
+        block[1] = 16; /* delta */
+        for(j = 7; j < fmt.wfx.nBlockAlign; ++j){
+            seed = seed * 1103515245 + 12345;
+            block[j] = (uint8_t)(seed >> 16);
+        }
+    }
+
+    filter.Type = LowPassFilter;
+    filter.OneOverQ = 1.f;
+    for(i = 0; i < 64; ++i){
+        XA2CALL(CreateSourceVoice, &srcs[i], &fmt.wfx, XAUDIO2_VOICE_USEFILTER, 1.f, NULL, NULL, NULL);
+        ok(hr == S_OK, "CreateSourceVoice failed: %08x\n", hr);
+
+        filter.Frequency = 0.1f + 0.8f * i / 64;
+        hr = IXAudio2SourceVoice_SetFilterParameters(srcs[i], &filter, XAUDIO2_COMMIT_NOW);
+        ok(hr == S_OK, "SetFilterParameters failed: %08x\n", hr);
+
+        hr = IXAudio2SourceVoice_SubmitSourceBuffer(srcs[i], &buf, NULL);
+        ok(hr == S_OK, "SubmitSourceBuffer failed: %08x\n", hr);
+
+        hr = IXAudio2SourceVoice_Start(srcs[i], 0, XAUDIO2_COMMIT_NOW);
+        ok(hr == S_OK, "Start failed: %08x\n", hr);
+    }
+
+    perf_run(xa, "adpcm_filters");
+
+    for(i = 0; i < 64; ++i){
+        if(xaudio27)
+            IXAudio27SourceVoice_DestroyVoice((IXAudio27SourceVoice*)srcs[i]);
+        else
+            IXAudio2SourceVoice_DestroyVoice(srcs[i]);
+    }
+    IXAudio2MasteringVoice_DestroyVoice(master);
+
+    FAtest_free((void*)buf.pAudioData);
+}
+
+static void perf_master71_limiter(IXAudio2 *xa)
+{
+    HRESULT hr;
+    IXAudio2MasteringVoice *master;
+    IXAudio2SourceVoice *srcs[64];
+    perf_effect *limiter;
+    WAVEFORMATEX fmt;
+    XAUDIO2_BUFFER buf;
+    XAUDIO2_EFFECT_DESCRIPTOR effect;
+    XAUDIO2_EFFECT_CHAIN chain;
+    int i;
+
+    XA2CALL_0V(StopEngine);
+
+    if(perf_create_master(xa, &master, 8) != S_OK)
+        return;
+
+    if(perf_create_limiter(&limiter) != S_OK){
+        fprintf(stdout, "XAPOFX not available, limiter test skipped\n");
+        IXAudio2MasteringVoice_DestroyVoice(master);
+        return;
+    }
+    effect.InitialState = TRUE;
+    effect.OutputChannels = 8;
+    effect.pEffect = limiter;
+    chain.EffectCount = 1;
+    chain.pEffectDescriptors = &effect;
+    hr = IXAudio2MasteringVoice_SetEffectChain(master, &chain);
+    ok(hr == S_OK, "SetEffectChain failed: %08x\n", hr);
+    perf_release_effect(limiter);
+
+    perf_fill_pcm16(&fmt, &buf);
+
+    for(i = 0; i < 64; ++i){
+        XA2CALL(CreateSourceVoice, &srcs[i], &fmt, 0, 1.f, NULL, NULL, NULL);
+        ok(hr == S_OK, "CreateSourceVoice failed: %08x\n", hr);
+
+        hr = IXAudio2SourceVoice_SubmitSourceBuffer(srcs[i], &buf, NULL);
+        ok(hr == S_OK, "SubmitSourceBuffer failed: %08x\n", hr);
+
+        hr = IXAudio2SourceVoice_Start(srcs[i], 0, XAUDIO2_COMMIT_NOW);
+        ok(hr == S_OK, "Start failed: %08x\n", hr);
+    }
+
+    perf_run(xa, "master71_limiter");
+
+    for(i = 0; i < 64; ++i){
+        if(xaudio27)
+            IXAudio27SourceVoice_DestroyVoice((IXAudio27SourceVoice*)srcs[i]);
+        else
+            IXAudio2SourceVoice_DestroyVoice(srcs[i]);
+    }
+    IXAudio2MasteringVoice_DestroyVoice(master);
+
+    FAtest_free((void*)buf.pAudioData);
+}
+
+static void perf_suite(IXAudio2 *xa)
+{
+    perf_pcm16_submix_reverb(xa);
+    perf_adpcm_filters(xa);
+    perf_master71_limiter(xa);
+}
+
 int main(int argc, char **argv)
 {
     HRESULT hr;
     IXAudio2 *xa;
     IXAudio27 *xa27 = NULL;
     UINT32 has_devices;
+    BOOL perf = FALSE;
+    int i;
 #ifdef _WIN32
-    HANDLE xa28dll;
+    HANDLE xa28dll, xapofxdll;
+#endif
 
+    for(i = 1; i < argc; ++i){
+        if(!strcmp(argv[i], "--perf"))
+            perf = TRUE;
+        else if(!strcmp(argv[i], "--passes") && i + 1 < argc)
+            perf_passes = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--threshold") && i + 1 < argc)
+            perf_threshold = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--baseline") && i + 1 < argc){
+            ++i;
+            if(!perf_load_baseline(argv[i])){
+                fprintf(stdout, "Could not read baseline %s\n", argv[i]);
+                return 1;
+            }
+        }else if(!strcmp(argv[i], "--save") && i + 1 < argc){
+            perf_save = fopen(argv[++i], "w");
+            if(!perf_save){
+                fprintf(stdout, "Could not write %s\n", argv[i]);
+                return 1;
+            }
+            fprintf(perf_save, "# scenario p50 p95 p99 max, in microseconds per pass\n");
+        }else{
+            fprintf(stdout, "Usage: %s [--perf [--passes N] [--baseline FILE] [--threshold PERCENT] [--save FILE]]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(perf_passes == 0)
+        perf_passes = 1;
 
+#ifdef _WIN32
     CoInitialize(NULL);
 
+    xapofxdll = LoadLibraryA("xapofx1_5.dll");
+    if(xapofxdll)
+        pCreateFX27 = (void*)GetProcAddress(xapofxdll, "CreateFX");
+
     hr = CoCreateInstance(&CLSID_XAudio27, NULL, CLSCTX_INPROC_SERVER,
             &IID_IXAudio27, (void**)&xa27);
 #else
@@ -1242,13 +1939,17 @@ int main(int argc, char **argv)
         ok(hr == S_OK, "Initialize failed: %08x\n", hr);
 
         has_devices = test_DeviceDetails(xa27);
-        if(has_devices){
+        if(has_devices && perf)
+            perf_suite((IXAudio2*)xa27);
+        else if(has_devices){
             test_simple_streaming((IXAudio2*)xa27);
             test_buffer_callbacks((IXAudio2*)xa27);
             test_looping((IXAudio2*)xa27);
             test_submix((IXAudio2*)xa27);
             test_flush((IXAudio2*)xa27);
             test_setchannelvolumes((IXAudio2*)xa27);
+            test_operationsets((IXAudio2*)xa27);
+            test_silent_voice((IXAudio2*)xa27);
         }else
             fprintf(stdout, "No audio devices available\n");
 
@@ -1262,6 +1963,8 @@ int main(int argc, char **argv)
     if(xa28dll){
         pXAudio2Create = (void*)GetProcAddress(xa28dll, "XAudio2Create");
         pCreateAudioVolumeMeter = (void*)GetProcAddress(xa28dll, "CreateAudioVolumeMeter");
+        pCreateAudioReverb = (void*)GetProcAddress(xa28dll, "CreateAudioReverb");
+        pCreateFX = (void*)GetProcAddress(xa28dll, "CreateFX");
         ok(pXAudio2Create != NULL && pCreateAudioVolumeMeter != NULL,
                 "xaudio2_8 doesn't have expected exports?\n");
 
@@ -1276,13 +1979,17 @@ int main(int argc, char **argv)
     if(hr == S_OK){
         xaudio27 = FALSE;
         has_devices = test_DeviceDetails(xa);
-        if(has_devices){
+        if(has_devices && perf)
+            perf_suite(xa);
+        else if(has_devices){
             test_simple_streaming(xa);
             test_buffer_callbacks(xa);
             test_looping(xa);
             test_submix(xa);
             test_flush(xa);
             test_setchannelvolumes(xa);
+            test_operationsets(xa);
+            test_silent_voice(xa);
         }else
             fprintf(stdout, "No audio devices available\n");
 
@@ -1290,6 +1997,9 @@ int main(int argc, char **argv)
     }else
         fprintf(stdout, "XAudio2.8 not available, tests skipped\n");
 
+    if(perf_save)
+        fclose(perf_save);
+
     fprintf(stdout, "Finished with %u successful tests and %u failed tests.\n",
             success_count, failure_count);
 
@@ -0,0 +1,660 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2018 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+/* benchmix - Headless engine throughput benchmark
+ *
+ * Every scenario is run on an offline engine (FAUDIO_OFFLINE_RENDER_EXT),
+ * once with no source voices and once with the requested voice count, so
+ * the fixed cost of the submixes, effects and master is left out of the
+ * per-voice number. The voice budget is how many voices of that kind the
+ * mix thread could get through in one device period.
+ *
+ * -P, -b and -c set the device period, the sub-block size (SubBlockMixEXT)
+ * and the master's channel count, to see how they scale.
+ *
+ * Usage: benchmix [-v voices] [-p passes] [-P period] [-b frames]
+ *                 [-c channels] [-x file.xwma]
+ */
+
+#include <FAudio.h>
+#include <FAudioFX.h>
+#include <FAPO.h>
+#include <SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define SAMPLE_RATE 48000
+#define DATA_FRAMES SAMPLE_RATE
+#define WARMUP_PASSES 8
+#define MAX_SUBMIX_DEPTH 4
+
+/* Allocation Counting */
+
+static uint32_t allocations = 0;
+
+static void* FAUDIOCALL CountingMalloc(size_t size)
+{
+	allocations += 1;
+	return malloc(size);
+}
+
+static void FAUDIOCALL CountingFree(void *ptr)
+{
+	free(ptr);
+}
+
+static void* FAUDIOCALL CountingRealloc(void *ptr, size_t size)
+{
+	allocations += 1;
+	return realloc(ptr, size);
+}
+
+/* Engine Settings */
+
+static uint32_t devicePeriod = 0;
+static uint32_t subBlockFrames = 0;
+static uint32_t masterChannels = 2;
+
+/* Source Data */
+
+typedef struct BenchFormat
+{
+	const char *name;
+	FAudioWaveFormatEx *format;
+	FAudioBuffer buffer;
+	FAudioBufferWMA bufferWMA;
+	uint8_t hasWMA;
+} BenchFormat;
+
+static float TestSignal(uint32_t frame, uint32_t channel)
+{
+	return 0.5f * sinf(
+		(float) frame * (0.031f + 0.017f * channel)
+	);
+}
+
+static FAudioWaveFormatEx* CreatePCMFormat(
+	uint16_t tag,
+	uint16_t channels,
+	uint16_t bits
+) {
+	FAudioWaveFormatEx *fmt = (FAudioWaveFormatEx*) calloc(
+		1,
+		sizeof(FAudioWaveFormatEx)
+	);
+	fmt->wFormatTag = tag;
+	fmt->nChannels = channels;
+	fmt->nSamplesPerSec = SAMPLE_RATE;
+	fmt->wBitsPerSample = bits;
+	fmt->nBlockAlign = channels * (bits / 8);
+	fmt->nAvgBytesPerSec = fmt->nBlockAlign * SAMPLE_RATE;
+	return fmt;
+}
+
+static void CreatePCM(
+	BenchFormat *bench,
+	const char *name,
+	uint16_t tag,
+	uint16_t channels,
+	uint16_t bits
+) {
+	uint32_t i, c, sample;
+	uint8_t *out;
+	int32_t value;
+	float f;
+
+	bench->name = name;
+	bench->format = CreatePCMFormat(tag, channels, bits);
+	bench->buffer.AudioBytes = DATA_FRAMES * bench->format->nBlockAlign;
+	out = (uint8_t*) malloc(bench->buffer.AudioBytes);
+	bench->buffer.pAudioData = out;
+
+	for (i = 0; i < DATA_FRAMES; i += 1)
+	for (c = 0; c < channels; c += 1)
+	{
+		f = TestSignal(i, c);
+		sample = i * channels + c;
+		if (tag == FAUDIO_FORMAT_IEEE_FLOAT)
+		{
+			memcpy(out + sample * 4, &f, 4);
+		}
+		else if (bits == 8)
+		{
+			out[sample] = (uint8_t) (128 + (int32_t) (f * 127.0f));
+		}
+		else if (bits == 16)
+		{
+			value = (int32_t) (f * 32767.0f);
+			out[sample * 2 + 0] = (uint8_t) value;
+			out[sample * 2 + 1] = (uint8_t) (value >> 8);
+		}
+		else if (bits == 24)
+		{
+			value = (int32_t) (f * 8388607.0f);
+			out[sample * 3 + 0] = (uint8_t) value;
+			out[sample * 3 + 1] = (uint8_t) (value >> 8);
+			out[sample * 3 + 2] = (uint8_t) (value >> 16);
+		}
+	}
+}
+
+/* MS-ADPCM blocks with valid headers and noisy nibbles. The content does not
+ * matter for timing, only that every block decodes the full way through.
+ */
+static void CreateMSADPCM(BenchFormat *bench, const char *name, uint16_t channels)
+{
+	static const int16_t coefs[7][2] =
+	{
+		{ 256, 0 }, { 512, -256 }, { 0, 0 }, { 192, 64 },
+		{ 240, 0 }, { 460, -208 }, { 392, -232 }
+	};
+	FAudioADPCMWaveFormat *fmt;
+	uint32_t i, c, blocks, blockFrames;
+	uint8_t *out, *block;
+	uint32_t seed = 0x1234;
+
+	fmt = (FAudioADPCMWaveFormat*) calloc(
+		1,
+		sizeof(FAudioADPCMWaveFormat) + sizeof(coefs)
+	);
+	fmt->wfx.wFormatTag = FAUDIO_FORMAT_MSADPCM;
+	fmt->wfx.nChannels = channels;
+	fmt->wfx.nSamplesPerSec = SAMPLE_RATE;
+	fmt->wfx.wBitsPerSample = 4;
+	fmt->wfx.nBlockAlign = 512 * channels;
+	fmt->wfx.cbSize = 4 + sizeof(coefs);
+	blockFrames = (512 - 6) * 2;
+	fmt->wSamplesPerBlock = (uint16_t) blockFrames;
+	fmt->wNumCoef = 7;
+	memcpy(fmt->aCoef, coefs, sizeof(coefs));
+	fmt->wfx.nAvgBytesPerSec = (
+		SAMPLE_RATE / blockFrames * fmt->wfx.nBlockAlign
+	);
+
+	blocks = DATA_FRAMES / blockFrames;
+	out = (uint8_t*) malloc(blocks * fmt->wfx.nBlockAlign);
+	for (i = 0; i < blocks; i += 1)
+	{
+		block = out + i * fmt->wfx.nBlockAlign;
+		for (c = 0; c < fmt->wfx.nBlockAlign; c += 1)
+		{
+			seed = seed * 1103515245 + 12345;
+			block[c] = (uint8_t) (seed >> 16);
+		}
+
+		/* Predictor 0, delta 16, both history samples 0 */
+		for (c = 0; c < channels; c += 1)
+		{
+			block[c] = 0;
+			block[channels + c * 2 + 0] = 16;
+			block[channels + c * 2 + 1] = 0;
+		}
+		memset(block + channels * 3, 0, channels * 4);
+	}
+
+	bench->name = name;
+	bench->format = &fmt->wfx;
+	bench->buffer.AudioBytes = blocks * fmt->wfx.nBlockAlign;
+	bench->buffer.pAudioData = out;
+}
+
+#ifdef HAVE_FFMPEG
+static uint8_t* FindChunk(
+	uint8_t *riff,
+	size_t len,
+	const char *fourcc,
+	uint32_t *size
+) {
+	size_t offset = 12;
+	uint32_t chunkSize;
+	while (offset + 8 <= len)
+	{
+		memcpy(&chunkSize, riff + offset + 4, 4);
+		if (memcmp(riff + offset, fourcc, 4) == 0)
+		{
+			*size = chunkSize;
+			return riff + offset + 8;
+		}
+		offset += 8 + chunkSize + (chunkSize & 1);
+	}
+	return NULL;
+}
+
+static uint8_t CreateXWMA(BenchFormat *bench, const char *path)
+{
+	uint8_t *riff, *chunk;
+	uint32_t size;
+	size_t len;
+	FILE *file;
+
+	file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Could not open %s\n", path);
+		return 0;
+	}
+	fseek(file, 0, SEEK_END);
+	len = (size_t) ftell(file);
+	fseek(file, 0, SEEK_SET);
+	riff = (uint8_t*) malloc(len);
+	len = fread(riff, 1, len, file);
+	fclose(file);
+	if (len < 12 || memcmp(riff + 8, "XWMA", 4) != 0)
+	{
+		fprintf(stderr, "%s is not an xWMA file\n", path);
+		return 0;
+	}
+
+	chunk = FindChunk(riff, len, "fmt ", &size);
+	bench->format = (FAudioWaveFormatEx*) chunk;
+	chunk = FindChunk(riff, len, "data", &size);
+	bench->buffer.pAudioData = chunk;
+	bench->buffer.AudioBytes = size;
+	chunk = FindChunk(riff, len, "dpds", &size);
+	bench->bufferWMA.pDecodedPacketCumulativeBytes = (uint32_t*) chunk;
+	bench->bufferWMA.PacketCount = size / sizeof(uint32_t);
+	if (	bench->format == NULL ||
+		bench->buffer.pAudioData == NULL ||
+		chunk == NULL	)
+	{
+		fprintf(stderr, "%s is missing fmt, data or dpds\n", path);
+		return 0;
+	}
+
+	bench->name = "xWMA";
+	bench->hasWMA = 1;
+	return 1;
+}
+#endif /* HAVE_FFMPEG */
+
+/* Scenarios */
+
+typedef struct BenchScenario
+{
+	float freqRatio;
+	uint32_t submixDepth;
+	uint8_t filter;
+	uint8_t reverb;
+} BenchScenario;
+
+typedef struct BenchResult
+{
+	double nsPerPass;
+	double allocsPerPass;
+	uint32_t periodFrames;
+} BenchResult;
+
+static void RunScenario(
+	const BenchFormat *bench,
+	const BenchScenario *scenario,
+	uint32_t voiceCount,
+	uint32_t passes,
+	BenchResult *result
+) {
+	FAudio *audio;
+	FAudioMasteringVoice *master;
+	FAudioSubmixVoice *submixes[MAX_SUBMIX_DEPTH];
+	FAudioSourceVoice **sources;
+	FAudioSendDescriptor send;
+	FAudioVoiceSends sends;
+	FAudioEffectDescriptor effect;
+	FAudioEffectChain chain;
+	FAudioFilterParameters filter;
+	FAudioBuffer buffer;
+	FAPO *reverb;
+	float *output;
+	uint32_t i, latency, depth;
+	uint64_t start, end;
+
+	FAudioCreateWithCustomAllocatorEXT(
+		&audio,
+		FAUDIO_OFFLINE_RENDER_EXT,
+		FAUDIO_DEFAULT_PROCESSOR,
+		CountingMalloc,
+		CountingFree,
+		CountingRealloc
+	);
+	if (devicePeriod > 0)
+	{
+		FAudio_SetDevicePeriodEXT(audio, devicePeriod);
+	}
+	FAudio_SetSubBlockSizeEXT(audio, subBlockFrames);
+	FAudio_CreateMasteringVoice(
+		audio,
+		&master,
+		masterChannels,
+		SAMPLE_RATE,
+		0,
+		0,
+		NULL
+	);
+	FAudio_GetDevicePeriodEXT(audio, &result->periodFrames, &latency);
+
+	/* Submix chain, the reverb goes on the one the sources send to */
+	depth = scenario->submixDepth;
+	if (scenario->reverb && depth == 0)
+	{
+		depth = 1;
+	}
+	sends.SendCount = 1;
+	sends.pSends = &send;
+	send.Flags = 0;
+	for (i = 0; i < depth; i += 1)
+	{
+		send.pOutputVoice = (i == 0) ?
+			(FAudioVoice*) master :
+			(FAudioVoice*) submixes[i - 1];
+		chain.EffectCount = 0;
+		if (scenario->reverb && i == depth - 1)
+		{
+			FAudioCreateReverbWithCustomAllocatorEXT(
+				&reverb,
+				0,
+				CountingMalloc,
+				CountingFree,
+				CountingRealloc
+			);
+			effect.pEffect = reverb;
+			effect.InitialState = 1;
+			effect.OutputChannels = 2;
+			chain.EffectCount = 1;
+			chain.pEffectDescriptors = &effect;
+		}
+		FAudio_CreateSubmixVoice(
+			audio,
+			&submixes[i],
+			2,
+			SAMPLE_RATE,
+			0,
+			depth - i,
+			&sends,
+			chain.EffectCount ? &chain : NULL
+		);
+		if (chain.EffectCount)
+		{
+			reverb->Release(reverb);
+		}
+	}
+	send.pOutputVoice = (depth == 0) ?
+		(FAudioVoice*) master :
+		(FAudioVoice*) submixes[depth - 1];
+
+	/* Sources, all looping forever */
+	sources = (FAudioSourceVoice**) calloc(
+		voiceCount + 1,
+		sizeof(FAudioSourceVoice*)
+	);
+	buffer = bench->buffer;
+	buffer.LoopCount = FAUDIO_LOOP_INFINITE;
+	filter.Type = FAudioLowPassFilter;
+	filter.Frequency = 0.25f;
+	filter.OneOverQ = 1.0f;
+	for (i = 0; i < voiceCount; i += 1)
+	{
+		FAudio_CreateSourceVoice(
+			audio,
+			&sources[i],
+			bench->format,
+			scenario->filter ? FAUDIO_VOICE_USEFILTER : 0,
+			FAUDIO_MAX_FREQ_RATIO,
+			NULL,
+			&sends,
+			NULL
+		);
+		if (scenario->filter)
+		{
+			FAudioVoice_SetFilterParameters(
+				sources[i],
+				&filter,
+				FAUDIO_COMMIT_NOW
+			);
+		}
+		FAudioSourceVoice_SetFrequencyRatio(
+			sources[i],
+			scenario->freqRatio,
+			FAUDIO_COMMIT_NOW
+		);
+		FAudioSourceVoice_SubmitSourceBuffer(
+			sources[i],
+			&buffer,
+			bench->hasWMA ? &bench->bufferWMA : NULL
+		);
+		FAudioSourceVoice_Start(sources[i], 0, FAUDIO_COMMIT_NOW);
+	}
+
+	/* Let the caches grow before anything is measured */
+	output = (float*) malloc(sizeof(float) * masterChannels * result->periodFrames);
+	for (i = 0; i < WARMUP_PASSES; i += 1)
+	{
+		FAudio_RenderEXT(audio, output, result->periodFrames);
+	}
+
+	allocations = 0;
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < passes; i += 1)
+	{
+		FAudio_RenderEXT(audio, output, result->periodFrames);
+	}
+	end = SDL_GetPerformanceCounter();
+	result->nsPerPass = (
+		(double) (end - start) * 1e9 /
+		(double) SDL_GetPerformanceFrequency() /
+		passes
+	);
+	result->allocsPerPass = (double) allocations / passes;
+
+	for (i = 0; i < voiceCount; i += 1)
+	{
+		FAudioVoice_DestroyVoice(sources[i]);
+	}
+	for (i = depth; i > 0; i -= 1)
+	{
+		FAudioVoice_DestroyVoice(submixes[i - 1]);
+	}
+	FAudioVoice_DestroyVoice(master);
+	FAudio_Release(audio);
+	free(sources);
+	free(output);
+}
+
+static void Report(
+	const BenchFormat *bench,
+	const BenchScenario *scenario,
+	uint32_t voiceCount,
+	uint32_t passes
+) {
+	BenchResult empty, full;
+	double nsPerVoice, budget;
+
+	RunScenario(bench, scenario, 0, passes, &empty);
+	RunScenario(bench, scenario, voiceCount, passes, &full);
+
+	nsPerVoice = (full.nsPerPass - empty.nsPerPass) / voiceCount;
+	if (nsPerVoice < 1.0)
+	{
+		nsPerVoice = 1.0;
+	}
+	budget = (
+		(double) full.periodFrames * 1e9 / SAMPLE_RATE -
+		empty.nsPerPass
+	) / nsPerVoice;
+
+	printf(
+		"%-14s %5.2f %5u %6u %6u | %10.1f %10.0f %12.2f\n",
+		bench->name,
+		scenario->freqRatio,
+		scenario->submixDepth,
+		scenario->filter,
+		scenario->reverb,
+		nsPerVoice,
+		budget > 0.0 ? budget : 0.0,
+		full.allocsPerPass
+	);
+}
+
+int main(int argc, char **argv)
+{
+	static const float ratios[] = { 1.0f, 0.75f, 1.5f };
+	static const uint32_t depths[] = { 1, MAX_SUBMIX_DEPTH };
+	BenchFormat formats[8];
+	BenchScenario scenario;
+	uint32_t formatCount;
+#ifdef HAVE_FFMPEG
+	const char *xwmaPath = NULL;
+#endif /* HAVE_FFMPEG */
+	uint32_t voiceCount = 64;
+	uint32_t passes = 200;
+	uint32_t i, j;
+
+	memset(formats, '\0', sizeof(formats));
+	for (i = 1; i < (uint32_t) argc; i += 1)
+	{
+		if (strcmp(argv[i], "-v") == 0 && i + 1 < (uint32_t) argc)
+		{
+			voiceCount = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-p") == 0 && i + 1 < (uint32_t) argc)
+		{
+			passes = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-P") == 0 && i + 1 < (uint32_t) argc)
+		{
+			devicePeriod = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < (uint32_t) argc)
+		{
+			subBlockFrames = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-c") == 0 && i + 1 < (uint32_t) argc)
+		{
+			masterChannels = (uint32_t) atoi(argv[++i]);
+		}
+#ifdef HAVE_FFMPEG
+		else if (strcmp(argv[i], "-x") == 0 && i + 1 < (uint32_t) argc)
+		{
+			xwmaPath = argv[++i];
+		}
+#endif /* HAVE_FFMPEG */
+		else
+		{
+			printf(
+				"Usage: %s [-v voices] [-p passes] [-P period]"
+				" [-b frames] [-c channels]",
+				argv[0]
+			);
+#ifdef HAVE_FFMPEG
+			printf(" [-x file.xwma]");
+#endif /* HAVE_FFMPEG */
+			printf("\n");
+			return 1;
+		}
+	}
+	if (voiceCount == 0 || passes == 0)
+	{
+		printf("Voice and pass counts must be above 0\n");
+		return 1;
+	}
+	if (masterChannels == 0 || masterChannels > FAUDIO_MAX_AUDIO_CHANNELS)
+	{
+		printf("Master channels must be from 1 to %d\n", FAUDIO_MAX_AUDIO_CHANNELS);
+		return 1;
+	}
+	if (subBlockFrames != 0 && (	subBlockFrames < FAUDIO_MIN_SUB_BLOCK_EXT ||
+					(subBlockFrames % 4) != 0	))
+	{
+		printf(
+			"Sub-blocks must be 0 or a multiple of 4 from %d\n",
+			FAUDIO_MIN_SUB_BLOCK_EXT
+		);
+		return 1;
+	}
+
+	CreatePCM(&formats[0], "PCM8 stereo", FAUDIO_FORMAT_PCM, 2, 8);
+	CreatePCM(&formats[1], "PCM16 mono", FAUDIO_FORMAT_PCM, 1, 16);
+	CreatePCM(&formats[2], "PCM16 stereo", FAUDIO_FORMAT_PCM, 2, 16);
+	CreatePCM(&formats[3], "PCM24 stereo", FAUDIO_FORMAT_PCM, 2, 24);
+	CreatePCM(&formats[4], "PCM32F stereo", FAUDIO_FORMAT_IEEE_FLOAT, 2, 32);
+	CreateMSADPCM(&formats[5], "ADPCM mono", 1);
+	CreateMSADPCM(&formats[6], "ADPCM stereo", 2);
+	formatCount = 7;
+#ifdef HAVE_FFMPEG
+	if (xwmaPath != NULL)
+	{
+		if (!CreateXWMA(&formats[7], xwmaPath))
+		{
+			return 1;
+		}
+		formatCount += 1;
+	}
+#endif /* HAVE_FFMPEG */
+
+	printf(
+		"%u voices, %u passes, one mix thread\n"
+		"%u channel master, sub-blocks of %u frames (0 is off)\n\n"
+		"%-14s %5s %5s %6s %6s | %10s %10s %12s\n",
+		voiceCount,
+		passes,
+		masterChannels,
+		subBlockFrames,
+		"format",
+		"ratio",
+		"depth",
+		"filter",
+		"reverb",
+		"ns/voice",
+		"budget",
+		"allocs/pass"
+	);
+
+	/* Decode and resample cost of every format... */
+	memset(&scenario, '\0', sizeof(scenario));
+	for (i = 0; i < formatCount; i += 1)
+	for (j = 0; j < sizeof(ratios) / sizeof(ratios[0]); j += 1)
+	{
+		scenario.freqRatio = ratios[j];
+		Report(&formats[i], &scenario, voiceCount, passes);
+	}
+
+	/* ... then the mix graph features, on the most common format */
+	scenario.freqRatio = 0.75f;
+	scenario.filter = 1;
+	Report(&formats[2], &scenario, voiceCount, passes);
+	scenario.filter = 0;
+	for (i = 0; i < sizeof(depths) / sizeof(depths[0]); i += 1)
+	{
+		scenario.submixDepth = depths[i];
+		Report(&formats[2], &scenario, voiceCount, passes);
+	}
+	scenario.submixDepth = 1;
+	scenario.reverb = 1;
+	Report(&formats[2], &scenario, voiceCount, passes);
+	return 0;
+}
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
@@ -0,0 +1,736 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2018 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+/* factstress - Headless FACT content stress test
+ *
+ * Loads an AudioEngine with its SoundBanks and WaveBanks onto an offline
+ * engine (FAUDIO_OFFLINE_RENDER_EXT), then keeps cues playing while the mix
+ * is rendered one device period per frame. Without -c every cue plays at
+ * once; with it, that many play and each one that stops makes room for the
+ * next. -r destroys and recreates that many playing cues every frame, and -3
+ * moves every cue around the listener with FACT3DCalculate/FACT3DApply.
+ *
+ * Frames are paced in real time, so that the FACT thread ticks the way it
+ * would in a game; -f renders as fast as possible instead.
+ *
+ * The limits make this usable as a gate for new content: the exit code is 2
+ * when the mix pass or tick 99th percentile, or the peak memory, goes over.
+ *
+ * Usage: factstress [-c cues] [-s seconds] [-r churn] [-3] [-f]
+ *                   [-M mix_us] [-T tick_us] [-P peak_kb]
+ *                   engine.xgs bank.xsb... bank.xwb...
+ */
+
+#include <FACT.h>
+#include <FACT3D.h>
+#include <SDL.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define SAMPLE_RATE 48000
+#define MAX_BANKS 32
+#define ALLOC_HEADER 16
+
+/* Allocation Tracking */
+
+static SDL_mutex *memoryLock = NULL;
+static size_t memoryUsage = 0;
+static size_t memoryPeak = 0;
+
+static void TrackAllocation(size_t added, size_t removed)
+{
+	SDL_LockMutex(memoryLock);
+	memoryUsage = memoryUsage + added - removed;
+	if (memoryUsage > memoryPeak)
+	{
+		memoryPeak = memoryUsage;
+	}
+	SDL_UnlockMutex(memoryLock);
+}
+
+static void* FAUDIOCALL TrackingMalloc(size_t size)
+{
+	uint8_t *block = (uint8_t*) malloc(ALLOC_HEADER + size);
+	if (block == NULL)
+	{
+		return NULL;
+	}
+	memcpy(block, &size, sizeof(size_t));
+	TrackAllocation(size, 0);
+	return block + ALLOC_HEADER;
+}
+
+static void FAUDIOCALL TrackingFree(void *ptr)
+{
+	size_t size;
+	if (ptr == NULL)
+	{
+		return;
+	}
+	memcpy(&size, (uint8_t*) ptr - ALLOC_HEADER, sizeof(size_t));
+	TrackAllocation(0, size);
+	free((uint8_t*) ptr - ALLOC_HEADER);
+}
+
+static void* FAUDIOCALL TrackingRealloc(void *ptr, size_t size)
+{
+	uint8_t *block;
+	size_t oldSize;
+	if (ptr == NULL)
+	{
+		return TrackingMalloc(size);
+	}
+	memcpy(&oldSize, (uint8_t*) ptr - ALLOC_HEADER, sizeof(size_t));
+	block = (uint8_t*) realloc((uint8_t*) ptr - ALLOC_HEADER, ALLOC_HEADER + size);
+	if (block == NULL)
+	{
+		return NULL;
+	}
+	memcpy(block, &size, sizeof(size_t));
+	TrackAllocation(size, oldSize);
+	return block + ALLOC_HEADER;
+}
+
+/* Timing */
+
+static double NowMicroseconds()
+{
+	return (
+		(double) SDL_GetPerformanceCounter() * 1e6 /
+		(double) SDL_GetPerformanceFrequency()
+	);
+}
+
+static int CompareFloats(const void *a, const void *b)
+{
+	float fa = *((const float*) a);
+	float fb = *((const float*) b);
+	return (fa > fb) - (fa < fb);
+}
+
+/* Sorts the samples, then prints and returns the 99th percentile */
+static float ReportPercentiles(const char *name, float *samples, uint32_t count)
+{
+	float p99;
+	if (count == 0)
+	{
+		printf("%-16s no samples\n", name);
+		return 0.0f;
+	}
+	qsort(samples, count, sizeof(float), CompareFloats);
+	p99 = samples[(count - 1) * 99 / 100];
+	printf(
+		"%-16s p50 %9.1f  p95 %9.1f  p99 %9.1f  max %9.1f us\n",
+		name,
+		samples[(count - 1) / 2],
+		samples[(count - 1) * 95 / 100],
+		p99,
+		samples[count - 1]
+	);
+	return p99;
+}
+
+/* Content */
+
+static uint8_t* LoadFile(const char *path, uint32_t *len)
+{
+	uint8_t *data;
+	FILE *file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Could not open %s\n", path);
+		return NULL;
+	}
+	fseek(file, 0, SEEK_END);
+	*len = (uint32_t) ftell(file);
+	fseek(file, 0, SEEK_SET);
+	data = (uint8_t*) malloc(*len);
+	*len = (uint32_t) fread(data, 1, *len, file);
+	fclose(file);
+	return data;
+}
+
+#define FILE_UNKNOWN		0
+#define FILE_SOUNDBANK		1
+#define FILE_WAVEBANK		2
+#define FILE_STREAMING_WAVEBANK	3
+
+/* Banks are told apart by their signature, and streaming WaveBanks by their
+ * flags, since they have to be opened as such
+ */
+static uint8_t GetFileKind(const char *path)
+{
+	uint8_t header[16];
+	uint32_t offset, flags;
+	uint8_t kind = FILE_UNKNOWN;
+	FILE *file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		return FILE_UNKNOWN;
+	}
+	if (fread(header, 1, sizeof(header), file) == sizeof(header))
+	{
+		if (memcmp(header, "SDBK", 4) == 0)
+		{
+			kind = FILE_SOUNDBANK;
+		}
+		else if (memcmp(header, "WBND", 4) == 0)
+		{
+			/* First segment is the bank data, which starts with flags */
+			kind = FILE_WAVEBANK;
+			memcpy(&offset, header + 12, sizeof(uint32_t));
+			if (	fseek(file, offset, SEEK_SET) == 0 &&
+				fread(&flags, 1, sizeof(flags), file) == sizeof(flags) &&
+				(flags & FACT_WAVEBANK_TYPE_MASK) == FACT_WAVEBANK_TYPE_STREAMING	)
+			{
+				kind = FILE_STREAMING_WAVEBANK;
+			}
+		}
+	}
+	fclose(file);
+	return kind;
+}
+
+typedef struct StressCue
+{
+	FACTSoundBank *bank;
+	uint16_t index;
+} StressCue;
+
+typedef struct StressState
+{
+	StressCue *cues;
+	uint32_t cueCount;
+	uint32_t nextCue;
+	uint32_t cuesPlayed;
+} StressState;
+
+static FACTCue* PlayNextCue(StressState *state)
+{
+	FACTCue *cue;
+	uint32_t i;
+
+	/* Some cues won't prepare, like ones whose WaveBank wasn't given */
+	for (i = 0; i < state->cueCount; i += 1)
+	{
+		StressCue *next = &state->cues[state->nextCue];
+		state->nextCue = (state->nextCue + 1) % state->cueCount;
+		if (FACTSoundBank_Prepare(next->bank, next->index, 0, 0, &cue) == 0)
+		{
+			FACTCue_Play(cue);
+			state->cuesPlayed += 1;
+			return cue;
+		}
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	FAudio *audio;
+	FAudioMasteringVoice *master;
+	FAudioVoiceDetails masterDetails;
+	FACTAudioEngine *engine;
+	FACTRuntimeParameters params;
+	FACTStreamingParameters streamParams;
+	FACTSoundBank *soundBanks[MAX_BANKS];
+	FACTWaveBank *waveBanks[MAX_BANKS];
+	const char *bankPaths[MAX_BANKS * 2];
+	const char *waveBankPaths[MAX_BANKS];
+	uint8_t *bankData[MAX_BANKS * 2];
+	uint8_t bankKinds[MAX_BANKS * 2];
+	uint32_t soundBankCount = 0, waveBankCount = 0, bankCount = 0;
+	FACTEngineStatsEXT stats, startStats;
+	FACTWaveBankStatsEXT bankStats;
+	F3DAUDIO_HANDLE f3d;
+	F3DAUDIO_LISTENER listener;
+	F3DAUDIO_EMITTER emitter;
+	F3DAUDIO_DSP_SETTINGS dsp;
+	float matrix[8] = { 0 };
+	StressState state;
+	FACTCue **slots;
+	uint32_t slotCount;
+	float *output, *passTimes, *tickTimes;
+	float mixP99, tickP99, angle, distance;
+	uint32_t i, j, len, frame, frameCount, period, latency, tickCount;
+	uint32_t cueState;
+	uint16_t numCues;
+	uint64_t lastTick, missedTicks;
+	double start, loadStart, passStart, wallTime, audioTime;
+	const char *enginePath = NULL;
+	uint32_t concurrency = 0;
+	uint32_t seconds = 10;
+	uint32_t churn = 0;
+	uint8_t use3D = 0;
+	uint8_t paced = 1;
+	double mixLimit = 0.0, tickLimit = 0.0, memoryLimit = 0.0;
+	int result = 0;
+
+	memset(&params, '\0', sizeof(params));
+	memoryLock = SDL_CreateMutex();
+	for (i = 1; i < (uint32_t) argc; i += 1)
+	{
+		if (strcmp(argv[i], "-c") == 0 && i + 1 < (uint32_t) argc)
+		{
+			concurrency = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < (uint32_t) argc)
+		{
+			seconds = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < (uint32_t) argc)
+		{
+			churn = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-M") == 0 && i + 1 < (uint32_t) argc)
+		{
+			mixLimit = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-T") == 0 && i + 1 < (uint32_t) argc)
+		{
+			tickLimit = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-P") == 0 && i + 1 < (uint32_t) argc)
+		{
+			memoryLimit = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-3") == 0)
+		{
+			use3D = 1;
+		}
+		else if (strcmp(argv[i], "-f") == 0)
+		{
+			paced = 0;
+		}
+		else if (argv[i][0] != '-' && enginePath == NULL)
+		{
+			enginePath = argv[i];
+		}
+		else if (argv[i][0] != '-' && bankCount < MAX_BANKS * 2)
+		{
+			/* Banks are loaded once the engine is up */
+			bankPaths[bankCount] = argv[i];
+			bankData[bankCount] = NULL;
+			bankKinds[bankCount] = GetFileKind(argv[i]);
+			if (bankKinds[bankCount] == FILE_UNKNOWN)
+			{
+				fprintf(stderr, "%s is not a SoundBank or WaveBank\n", argv[i]);
+				return 1;
+			}
+			bankCount += 1;
+		}
+		else
+		{
+			enginePath = NULL;
+			break;
+		}
+	}
+	if (enginePath == NULL || seconds == 0)
+	{
+		printf(
+			"Usage: %s [-c cues] [-s seconds] [-r churn] [-3] [-f]\n"
+			"       [-M mix_us] [-T tick_us] [-P peak_kb]\n"
+			"       engine.xgs bank.xsb... bank.xwb...\n",
+			argv[0]
+		);
+		return 1;
+	}
+
+	/* Offline engine, with FACT on top of it */
+	FAudioCreateWithCustomAllocatorEXT(
+		&audio,
+		FAUDIO_OFFLINE_RENDER_EXT,
+		FAUDIO_DEFAULT_PROCESSOR,
+		TrackingMalloc,
+		TrackingFree,
+		TrackingRealloc
+	);
+	FAudio_CreateMasteringVoice(audio, &master, 2, SAMPLE_RATE, 0, 0, NULL);
+	FAudio_GetDevicePeriodEXT(audio, &period, &latency);
+	FAudioVoice_GetVoiceDetails(master, &masterDetails);
+
+	params.pGlobalSettingsBuffer = LoadFile(enginePath, &len);
+	params.globalSettingsBufferSize = len;
+	if (params.pGlobalSettingsBuffer == NULL)
+	{
+		return 1;
+	}
+	params.pXAudio2 = audio;
+	params.pMasteringVoice = master;
+
+	/* FACT takes these over, keep the engine around for its stats */
+	FAudio_AddRef(audio);
+	FACTCreateEngineWithCustomAllocatorEXT(
+		0,
+		&engine,
+		TrackingMalloc,
+		TrackingFree,
+		TrackingRealloc
+	);
+	loadStart = NowMicroseconds();
+	if (FACTAudioEngine_Initialize(engine, &params) != 0)
+	{
+		fprintf(stderr, "Could not load %s\n", enginePath);
+		return 1;
+	}
+	printf(
+		"%-32s %9.2f ms\n",
+		enginePath,
+		(NowMicroseconds() - loadStart) / 1000.0
+	);
+	free(params.pGlobalSettingsBuffer);
+
+	/* WaveBanks first, so SoundBanks can find them */
+	for (i = 0; i < bankCount; i += 1)
+	{
+		uint32_t ret;
+		if (bankKinds[i] == FILE_SOUNDBANK || waveBankCount == MAX_BANKS)
+		{
+			continue;
+		}
+
+		if (bankKinds[i] == FILE_STREAMING_WAVEBANK)
+		{
+			memset(&streamParams, '\0', sizeof(streamParams));
+			streamParams.file = FAudio_fopen(bankPaths[i]);
+			streamParams.packetSize = 8;
+			loadStart = NowMicroseconds();
+			ret = FACTAudioEngine_CreateStreamingWaveBank(
+				engine,
+				&streamParams,
+				&waveBanks[waveBankCount]
+			);
+		}
+		else
+		{
+			bankData[i] = LoadFile(bankPaths[i], &len);
+			loadStart = NowMicroseconds();
+			ret = FACTAudioEngine_CreateInMemoryWaveBank(
+				engine,
+				bankData[i],
+				len,
+				0,
+				0,
+				&waveBanks[waveBankCount]
+			);
+		}
+		if (ret != 0)
+		{
+			fprintf(stderr, "Could not load %s\n", bankPaths[i]);
+			return 1;
+		}
+		printf(
+			"%-32s %9.2f ms, %s\n",
+			bankPaths[i],
+			(NowMicroseconds() - loadStart) / 1000.0,
+			(bankKinds[i] == FILE_STREAMING_WAVEBANK) ?
+				"streaming" :
+				"in memory"
+		);
+		waveBankPaths[waveBankCount] = bankPaths[i];
+		waveBankCount += 1;
+	}
+	for (i = 0; i < bankCount; i += 1)
+	{
+		if (bankKinds[i] != FILE_SOUNDBANK || soundBankCount == MAX_BANKS)
+		{
+			continue;
+		}
+
+		/* The data has to outlive the SoundBank */
+		bankData[i] = LoadFile(bankPaths[i], &len);
+		loadStart = NowMicroseconds();
+		if (FACTAudioEngine_CreateSoundBank(
+			engine,
+			bankData[i],
+			len,
+			0,
+			0,
+			&soundBanks[soundBankCount]
+		) != 0) {
+			fprintf(stderr, "Could not load %s\n", bankPaths[i]);
+			return 1;
+		}
+		FACTSoundBank_GetNumCues(soundBanks[soundBankCount], &numCues);
+		printf(
+			"%-32s %9.2f ms, %u cues\n",
+			bankPaths[i],
+			(NowMicroseconds() - loadStart) / 1000.0,
+			numCues
+		);
+		soundBankCount += 1;
+	}
+
+	/* Every cue of every SoundBank */
+	memset(&state, '\0', sizeof(state));
+	for (i = 0; i < soundBankCount; i += 1)
+	{
+		FACTSoundBank_GetNumCues(soundBanks[i], &numCues);
+		state.cues = (StressCue*) realloc(
+			state.cues,
+			sizeof(StressCue) * (state.cueCount + numCues)
+		);
+		for (j = 0; j < numCues; j += 1)
+		{
+			state.cues[state.cueCount].bank = soundBanks[i];
+			state.cues[state.cueCount].index = (uint16_t) j;
+			state.cueCount += 1;
+		}
+	}
+	if (state.cueCount == 0)
+	{
+		fprintf(stderr, "No cues to play\n");
+		return 1;
+	}
+	slotCount = (concurrency > 0) ? concurrency : state.cueCount;
+	slots = (FACTCue**) calloc(slotCount, sizeof(FACTCue*));
+
+	/* FACT3DInitialize needs the engine's SpeedOfSound */
+	if (	use3D &&
+		FACTAudioEngine_GetGlobalVariableIndex(
+			engine,
+			"SpeedOfSound"
+		) == FACTVARIABLEINDEX_INVALID	)
+	{
+		fprintf(stderr, "%s has no SpeedOfSound, 3D is off\n", enginePath);
+		use3D = 0;
+	}
+
+	/* Everything orbits a listener at the origin, facing forward */
+	if (use3D)
+	{
+		FACT3DInitialize(engine, f3d);
+		memset(&listener, '\0', sizeof(listener));
+		listener.OrientFront.z = 1.0f;
+		listener.OrientTop.y = 1.0f;
+		memset(&emitter, '\0', sizeof(emitter));
+		emitter.OrientFront.z = 1.0f;
+		emitter.OrientTop.y = 1.0f;
+		emitter.ChannelCount = 1;
+		emitter.CurveDistanceScaler = 1.0f;
+		emitter.DopplerScaler = 1.0f;
+		memset(&dsp, '\0', sizeof(dsp));
+		dsp.SrcChannelCount = 1;
+		dsp.DstChannelCount = masterDetails.InputChannels;
+		dsp.pMatrixCoefficients = matrix;
+	}
+
+	frameCount = seconds * SAMPLE_RATE / period;
+	output = (float*) malloc(
+		sizeof(float) * period * masterDetails.InputChannels
+	);
+	passTimes = (float*) malloc(sizeof(float) * frameCount);
+	tickTimes = (float*) malloc(sizeof(float) * frameCount);
+	tickCount = 0;
+	missedTicks = 0;
+	FACTAudioEngine_GetStatsEXT(engine, &startStats);
+	lastTick = startStats.TickCount;
+
+	printf(
+		"\n%u s of audio, %u frames of %u samples, %u cues at once%s%s\n"
+		"churning %u cues per frame%s\n\n",
+		seconds,
+		frameCount,
+		period,
+		slotCount,
+		use3D ? ", 3D" : "",
+		paced ? "" : ", unpaced",
+		churn,
+		(slotCount < state.cueCount || churn > 0) ? "" : " (none)"
+	);
+
+	start = NowMicroseconds();
+	for (frame = 0; frame < frameCount; frame += 1)
+	{
+		/* Replace whatever stopped */
+		for (i = 0; i < slotCount; i += 1)
+		{
+			if (slots[i] != NULL)
+			{
+				FACTCue_GetState(slots[i], &cueState);
+				if (cueState & FACT_STATE_STOPPED)
+				{
+					FACTCue_Destroy(slots[i]);
+					slots[i] = NULL;
+				}
+			}
+			if (slots[i] == NULL)
+			{
+				slots[i] = PlayNextCue(&state);
+			}
+		}
+
+		/* Churn, whether or not the cue was done */
+		for (i = 0; i < churn; i += 1)
+		{
+			j = (uint32_t) rand() % slotCount;
+			if (slots[j] != NULL)
+			{
+				FACTCue_Destroy(slots[j]);
+			}
+			slots[j] = PlayNextCue(&state);
+		}
+
+		if (use3D)
+		{
+			for (i = 0; i < slotCount; i += 1)
+			{
+				if (slots[i] == NULL)
+				{
+					continue;
+				}
+				angle = (
+					F3DAUDIO_2PI * i / slotCount +
+					frame * 0.01f
+				);
+				distance = 1.0f + 20.0f * (i % 8) / 8.0f;
+				emitter.Position.x = distance * sinf(angle);
+				emitter.Position.z = distance * cosf(angle);
+				emitter.Velocity.x = distance * cosf(angle);
+				emitter.Velocity.z = -distance * sinf(angle);
+				FACT3DCalculate(f3d, &listener, &emitter, &dsp);
+				FACT3DApply(&dsp, slots[i]);
+			}
+		}
+		FACTAudioEngine_DoWork(engine);
+
+		passStart = NowMicroseconds();
+		FAudio_RenderEXT(audio, output, period);
+		passTimes[frame] = (float) (NowMicroseconds() - passStart);
+
+		/* One tick per frame at most is sampled, the rest are counted */
+		FACTAudioEngine_GetStatsEXT(engine, &stats);
+		if (stats.TickCount != lastTick)
+		{
+			tickTimes[tickCount++] = (float) stats.LastTickMicroseconds;
+			missedTicks += stats.TickCount - lastTick - 1;
+			lastTick = stats.TickCount;
+		}
+
+		if (paced)
+		{
+			double due = start + (frame + 1) * 1e6 * period / SAMPLE_RATE;
+			double now = NowMicroseconds();
+			if (due > now)
+			{
+				SDL_Delay((uint32_t) ((due - now) / 1000.0));
+			}
+		}
+	}
+	wallTime = (NowMicroseconds() - start) / 1e6;
+	audioTime = (double) frameCount * period / SAMPLE_RATE;
+
+	/* Report */
+	printf(
+		"%-16s %u (%.1f per second)\n",
+		"cues played",
+		state.cuesPlayed,
+		state.cuesPlayed / audioTime
+	);
+	printf(
+		"%-16s created %.1f/s, reused %.1f/s, destroyed %.1f/s\n",
+		"voices",
+		(stats.VoicesCreated - startStats.VoicesCreated) / audioTime,
+		(stats.VoicesReused - startStats.VoicesReused) / audioTime,
+		(stats.VoicesDestroyed - startStats.VoicesDestroyed) / audioTime
+	);
+	printf(
+		"%-16s %u active, %u idle, %u virtual at the end\n",
+		"",
+		stats.ActiveVoices,
+		stats.IdleVoices,
+		stats.VirtualWaves
+	);
+	tickP99 = ReportPercentiles("tick", tickTimes, tickCount);
+	printf(
+		"%-16s %u sampled, %u more not sampled\n",
+		"",
+		tickCount,
+		(uint32_t) missedTicks
+	);
+	mixP99 = ReportPercentiles("mix pass", passTimes, frameCount);
+	printf(
+		"%-16s period is %.1f us, rendered at %.1fx real time\n",
+		"",
+		1e6 * period / SAMPLE_RATE,
+		audioTime / wallTime
+	);
+	for (i = 0; i < waveBankCount; i += 1)
+	{
+		FACTWaveBank_GetStatsEXT(waveBanks[i], &bankStats);
+		if (bankStats.ReadCount == 0)
+		{
+			continue;
+		}
+		printf(
+			"%-16s %.1f KB/s, %.1f us per read, %.1f us max, "
+			"%u late buffers\n",
+			waveBankPaths[i],
+			bankStats.BytesRead / 1024.0 / wallTime,
+			(double) bankStats.ReadMicroseconds / bankStats.ReadCount,
+			(double) bankStats.MaxReadMicroseconds,
+			bankStats.LateBuffers
+		);
+	}
+	printf("%-16s %.1f KB\n", "peak memory", memoryPeak / 1024.0);
+
+	/* Gate */
+	if (mixLimit > 0.0 && mixP99 > mixLimit)
+	{
+		printf("FAILED: mix pass p99 is over %.1f us\n", mixLimit);
+		result = 2;
+	}
+	if (tickLimit > 0.0 && tickP99 > tickLimit)
+	{
+		printf("FAILED: tick p99 is over %.1f us\n", tickLimit);
+		result = 2;
+	}
+	if (memoryLimit > 0.0 && memoryPeak / 1024.0 > memoryLimit)
+	{
+		printf("FAILED: peak memory is over %.1f KB\n", memoryLimit);
+		result = 2;
+	}
+
+	/* Releasing the engine destroys the cues and banks along with it */
+	FACTAudioEngine_Release(engine);
+	FAudio_Release(audio);
+	for (i = 0; i < bankCount; i += 1)
+	{
+		free(bankData[i]);
+	}
+	free(state.cues);
+	free(slots);
+	free(output);
+	free(passTimes);
+	free(tickTimes);
+	SDL_DestroyMutex(memoryLock);
+	return result;
+}
+
+/* vim: set noexpandtab shiftwidth=8 tabstop=8: */
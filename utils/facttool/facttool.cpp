@@ -55,6 +55,72 @@ std::vector<bool> wavebankShows;
 
 std::vector<FACTWave*> waves;
 
+/* Live stats, one sample per frame */
+#define GRAPH_LENGTH 256
+
+struct Graph
+{
+	float values[GRAPH_LENGTH];
+	int offset;
+
+	Graph() : offset(0)
+	{
+		SDL_memset(values, '\0', sizeof(values));
+	}
+
+	void Push(float value)
+	{
+		values[offset] = value;
+		offset = (offset + 1) % GRAPH_LENGTH;
+	}
+
+	void Plot(const char *label, const char *format)
+	{
+		char overlay[64];
+		SDL_snprintf(
+			overlay,
+			sizeof(overlay),
+			format,
+			values[(offset + GRAPH_LENGTH - 1) % GRAPH_LENGTH]
+		);
+		ImGui::PlotLines(
+			label,
+			values,
+			GRAPH_LENGTH,
+			offset,
+			overlay,
+			0.0f,
+			FLT_MAX,
+			ImVec2(0, 60)
+		);
+	}
+};
+
+struct EngineGraphs
+{
+	Graph tickTime;
+	Graph cuesUpdated;
+	Graph rpcEvaluations;
+	Graph activeVoices;
+	Graph virtualWaves;
+	Graph mixCPU;
+	Graph sourceVoices;
+	Graph memoryUsage;
+};
+std::vector<EngineGraphs*> engineGraphs;
+
+struct WaveBankGraphs
+{
+	Graph bytesRead;
+	Graph readTime;
+	uint64_t lastBytesRead;
+
+	WaveBankGraphs() : lastBytesRead(0)
+	{
+	}
+};
+std::vector<WaveBankGraphs*> wavebankGraphs;
+
 void FAudioTool_Init()
 {
 	/* Nothing to do... */
@@ -78,7 +144,18 @@ void FAudioTool_Quit()
 	for (size_t i = 0; i < engines.size(); i += 1)
 	{
 		FACTAudioEngine_ShutDown(engines[i]);
+		delete engineGraphs[i];
 	}
+	for (size_t i = 0; i < wavebankGraphs.size(); i += 1)
+	{
+		delete wavebankGraphs[i];
+	}
+}
+
+int FAudioTool_Bench(int argc, char **argv)
+{
+	printf("%s has no benchmark\n", TOOL_NAME);
+	return 1;
 }
 
 bool show_test_window = false;
@@ -168,6 +245,7 @@ void FAudioTool_Update()
 				engines.push_back(engine);
 				engineNames.push_back(enginename);
 				engineShows.push_back(true);
+				engineGraphs.push_back(new EngineGraphs());
 			}
 		}
 		ImGui::End();
@@ -177,6 +255,32 @@ void FAudioTool_Update()
 	for (size_t i = 0; i < engines.size(); i += 1)
 	{
 		FACTAudioEngine_DoWork(engines[i]);
+
+		/* Sample the stats even while hidden, so the graphs stay live */
+		FACTEngineStatsEXT stats;
+		FAudioPerformanceData perf;
+		FACTAudioEngine_GetStatsEXT(engines[i], &stats);
+		FAudio_GetPerformanceData(engines[i]->audio, &perf);
+		engineGraphs[i]->tickTime.Push(
+			stats.LastTickMicroseconds / 1000.0f
+		);
+		engineGraphs[i]->cuesUpdated.Push((float) stats.CuesUpdated);
+		engineGraphs[i]->rpcEvaluations.Push((float) stats.RPCEvaluations);
+		engineGraphs[i]->activeVoices.Push((float) stats.ActiveVoices);
+		engineGraphs[i]->virtualWaves.Push((float) stats.VirtualWaves);
+		engineGraphs[i]->mixCPU.Push(
+			(perf.TotalCyclesSinceLastQuery > 0) ?
+				100.0f * perf.AudioCyclesSinceLastQuery /
+					perf.TotalCyclesSinceLastQuery :
+				0.0f
+		);
+		engineGraphs[i]->sourceVoices.Push(
+			(float) perf.ActiveSourceVoiceCount
+		);
+		engineGraphs[i]->memoryUsage.Push(
+			perf.MemoryUsageInBytes / 1024.0f
+		);
+
 		if (engineShows[i])
 		{
 			/* Early out */
@@ -337,6 +441,41 @@ void FAudioTool_Update()
 				ImGui::TreePop();
 			}
 
+			/* Performance */
+			if (ImGui::CollapsingHeader("Performance"))
+			{
+				EngineGraphs *graphs = engineGraphs[i];
+				ImGui::Text("FACT");
+				graphs->tickTime.Plot("Tick Time", "%.3f ms");
+				ImGui::Text(
+					"Longest Tick: %.3f ms",
+					stats.MaxTickMicroseconds / 1000.0f
+				);
+				graphs->cuesUpdated.Plot("Cues Updated", "%.0f per tick");
+				graphs->rpcEvaluations.Plot("RPC Evaluations", "%.0f per tick");
+				graphs->activeVoices.Plot("Active Voices", "%.0f");
+				graphs->virtualWaves.Plot("Virtual Waves", "%.0f");
+				ImGui::Text("Idle Voices: %d", stats.IdleVoices);
+				ImGui::Text(
+					"Late Stream Buffers: %d",
+					stats.LateStreamBuffers
+				);
+
+				ImGui::Separator();
+				ImGui::Text("FAudio");
+				graphs->mixCPU.Plot("Mix CPU", "%.1f%%");
+				graphs->sourceVoices.Plot("Source Voices", "%.0f");
+				graphs->memoryUsage.Plot("Memory", "%.0f KB");
+				ImGui::Text(
+					"Latency: %d samples",
+					perf.CurrentLatencyInSamples
+				);
+				ImGui::Text(
+					"Glitches: %d",
+					perf.GlitchesSinceEngineStarted
+				);
+			}
+
 			ImGui::Separator();
 
 			/* Open SoundBank */
@@ -397,6 +536,7 @@ void FAudioTool_Update()
 					"WaveBank: " + std::string(wb->name)
 				);
 				wavebankShows.push_back(true);
+				wavebankGraphs.push_back(new WaveBankGraphs());
 			}
 
 			ImGui::Separator();
@@ -435,6 +575,8 @@ void FAudioTool_Update()
 							wavebankMems.erase(wavebankMems.begin() + j);
 							wavebankNames.erase(wavebankNames.begin() + j);
 							wavebankShows.erase(wavebankShows.begin() + j);
+							delete wavebankGraphs[j];
+							wavebankGraphs.erase(wavebankGraphs.begin() + j);
 							break;
 						}
 					}
@@ -445,6 +587,8 @@ void FAudioTool_Update()
 				engines.erase(engines.begin() + i);
 				engineNames.erase(engineNames.begin() + i);
 				engineShows.erase(engineShows.begin() + i);
+				delete engineGraphs[i];
+				engineGraphs.erase(engineGraphs.begin() + i);
 				i -= 1;
 			}
 
@@ -993,8 +1137,22 @@ void FAudioTool_Update()
 
 	/* WaveBank windows */
 	for (size_t i = 0; i < waveBanks.size(); i += 1)
-	if (wavebankShows[i])
 	{
+		/* Sample the stats even while hidden, so the graphs stay live */
+		FACTWaveBankStatsEXT wbStats;
+		FACTWaveBank_GetStatsEXT(waveBanks[i], &wbStats);
+		wavebankGraphs[i]->bytesRead.Push(
+			(wbStats.BytesRead - wavebankGraphs[i]->lastBytesRead) / 1024.0f
+		);
+		wavebankGraphs[i]->lastBytesRead = wbStats.BytesRead;
+		wavebankGraphs[i]->readTime.Push(
+			wbStats.LastReadMicroseconds / 1000.0f
+		);
+		if (!wavebankShows[i])
+		{
+			continue;
+		}
+
 		/* Early out */
 		if (!ImGui::Begin(wavebankNames[i].c_str()))
 		{
@@ -1011,11 +1169,34 @@ void FAudioTool_Update()
 			wavebankMems.erase(wavebankMems.begin() + i);
 			wavebankNames.erase(wavebankNames.begin() + i);
 			wavebankShows.erase(wavebankShows.begin() + i);
+			delete wavebankGraphs[i];
+			wavebankGraphs.erase(wavebankGraphs.begin() + i);
 			i -= 1;
 			ImGui::End();
 			continue;
 		}
 
+		/* Streaming */
+		if (ImGui::CollapsingHeader("Streaming"))
+		{
+			WaveBankGraphs *graphs = wavebankGraphs[i];
+			graphs->bytesRead.Plot("Read", "%.1f KB per frame");
+			graphs->readTime.Plot("Read Latency", "%.3f ms");
+			ImGui::Text("Reads: %d", (uint32_t) wbStats.ReadCount);
+			ImGui::Text(
+				"Average Read Latency: %.3f ms",
+				(wbStats.ReadCount > 0) ?
+					wbStats.ReadMicroseconds / 1000.0f /
+						wbStats.ReadCount :
+					0.0f
+			);
+			ImGui::Text(
+				"Longest Read: %.3f ms",
+				wbStats.MaxReadMicroseconds / 1000.0f
+			);
+			ImGui::Text("Late Buffers: %d", wbStats.LateBuffers);
+		}
+
 		/* Giant table of wavedata entries */
 		ImGui::Columns(12, "wavebankentries");
 		ImGui::Separator();
@@ -0,0 +1,180 @@
+#include "audio.h"
+#include "../uicommon/FAudioUI_bench.h"
+
+#include <FAudio.h>
+#include <SDL.h>
+#include <math.h>
+
+// the filters run per channel, so every layout a voice commonly has
+static const uint16_t bench_channels[] = { 1, 2, 6, 8 };
+
+static const struct
+{
+	const char *name;
+	FAudioFilterType type;
+} bench_filters[] =
+{
+	{ "lowpass", FAudioLowPassFilter },
+	{ "bandpass", FAudioBandPassFilter },
+	{ "highpass", FAudioHighPassFilter },
+	{ "notch", FAudioNotchFilter }
+};
+
+static const float bench_cutoff = 1000.0f;
+static const float bench_q = 1.0f;
+
+enum BenchMode
+{
+	BENCH_NO_FILTER,
+	BENCH_VOICE_FILTER,
+	BENCH_SEND_FILTER
+};
+
+// the filters only exist inside a voice, so this times whole offline mixes
+// of one source voice into the master, see OfflineRenderEXT
+static uint64_t bench_filter_run(
+	const float *signal,
+	uint16_t channels,
+	BenchMode mode,
+	FAudioFilterType type,
+	float *output
+) {
+	FAudio *faudio;
+	FAudioMasteringVoice *mastering_voice;
+	FAudioSourceVoice *voice;
+	FAudioWaveFormatEx waveFormat;
+	FAudioSendDescriptor send;
+	FAudioVoiceSends sends;
+	FAudioFilterParameters params;
+	FAudioBuffer buffer = { 0 };
+	uint32_t frames = Bench_FrameCount();
+	uint32_t offset, count;
+	uint64_t start, ticks = 0;
+
+	if (FAudioCreate(&faudio, FAUDIO_OFFLINE_RENDER_EXT, FAUDIO_DEFAULT_PROCESSOR) != 0)
+	{
+		return 0;
+	}
+	if (FAudio_CreateMasteringVoice(faudio, &mastering_voice, channels, BENCH_SAMPLERATE, 0, 0, NULL) != 0)
+	{
+		FAudio_Release(faudio);
+		return 0;
+	}
+
+	waveFormat.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+	waveFormat.nChannels = channels;
+	waveFormat.nSamplesPerSec = BENCH_SAMPLERATE;
+	waveFormat.nAvgBytesPerSec = BENCH_SAMPLERATE * channels * 4;
+	waveFormat.nBlockAlign = channels * 4;
+	waveFormat.wBitsPerSample = 32;
+	waveFormat.cbSize = 0;
+
+	// sends are only filtered for voices that have a filter of their own, so
+	// the send case also pays for the voice's (bypassed) filter
+	send.Flags = (mode == BENCH_SEND_FILTER) ? FAUDIO_SEND_USEFILTER : 0;
+	send.pOutputVoice = mastering_voice;
+	sends.SendCount = 1;
+	sends.pSends = &send;
+
+	FAudio_CreateSourceVoice(
+		faudio,
+		&voice,
+		&waveFormat,
+		(mode != BENCH_NO_FILTER) ? FAUDIO_VOICE_USEFILTER : 0,
+		FAUDIO_DEFAULT_FREQ_RATIO,
+		NULL,
+		&sends,
+		NULL
+	);
+
+	params.Type = type;
+	params.Frequency = (float) (2 * sin(PI * bench_cutoff / BENCH_SAMPLERATE));
+	params.OneOverQ = 1.0f / bench_q;
+	if (mode == BENCH_VOICE_FILTER)
+	{
+		FAudioVoice_SetFilterParameters(voice, &params, FAUDIO_COMMIT_NOW);
+	}
+	else if (mode == BENCH_SEND_FILTER)
+	{
+		FAudioVoice_SetOutputFilterParameters(voice, mastering_voice, &params, FAUDIO_COMMIT_NOW);
+	}
+
+	buffer.AudioBytes = 4 * frames * channels;
+	buffer.pAudioData = (const uint8_t *) signal;
+	buffer.Flags = FAUDIO_END_OF_STREAM;
+	FAudioSourceVoice_SubmitSourceBuffer(voice, &buffer, NULL);
+	FAudioSourceVoice_Start(voice, 0, FAUDIO_COMMIT_NOW);
+
+	for (offset = 0; offset < frames; offset += count)
+	{
+		count = SDL_min(BENCH_BLOCK_FRAMES, frames - offset);
+
+		start = Bench_Ticks();
+		FAudio_RenderEXT(faudio, output + offset * channels, count);
+		ticks += Bench_Ticks() - start;
+	}
+
+	FAudioVoice_DestroyVoice(voice);
+	FAudioVoice_DestroyVoice(mastering_voice);
+	FAudio_Release(faudio);
+	return ticks;
+}
+
+static void bench_filter_config(
+	const char *name,
+	const float *signal,
+	uint16_t channels,
+	BenchMode mode,
+	FAudioFilterType type,
+	float *output
+) {
+	uint32_t run;
+	uint64_t ticks, best = 0;
+
+	for (run = 0; run < Bench_RunCount(); run += 1)
+	{
+		ticks = bench_filter_run(signal, channels, mode, type, output);
+		if (run == 0 || ticks < best)
+		{
+			best = ticks;
+		}
+	}
+	Bench_Result(name, best, Bench_FrameCount(), output, Bench_FrameCount() * channels);
+}
+
+int FAudioTool_Bench(int argc, char **argv)
+{
+	float *signal, *output;
+	uint32_t frames, i, j;
+	char name[64];
+
+	if (!Bench_Init(argc, argv))
+	{
+		return 1;
+	}
+	frames = Bench_FrameCount();
+
+	for (i = 0; i < SDL_arraysize(bench_channels); i += 1)
+	{
+		signal = Bench_CreateSignal(bench_channels[i]);
+		output = (float*) SDL_malloc(sizeof(float) * frames * bench_channels[i]);
+
+		// the mix without any filter, to subtract from the ones below
+		SDL_snprintf(name, sizeof(name), "unfiltered %uch", bench_channels[i]);
+		bench_filter_config(name, signal, bench_channels[i], BENCH_NO_FILTER, FAudioLowPassFilter, output);
+
+		for (j = 0; j < SDL_arraysize(bench_filters); j += 1)
+		{
+			SDL_snprintf(name, sizeof(name), "voice %s %uch", bench_filters[j].name, bench_channels[i]);
+			bench_filter_config(name, signal, bench_channels[i], BENCH_VOICE_FILTER, bench_filters[j].type, output);
+
+			SDL_snprintf(name, sizeof(name), "send %s %uch", bench_filters[j].name, bench_channels[i]);
+			bench_filter_config(name, signal, bench_channels[i], BENCH_SEND_FILTER, bench_filters[j].type, output);
+		}
+
+		SDL_free(output);
+		SDL_free(signal);
+	}
+
+	return Bench_Quit();
+}
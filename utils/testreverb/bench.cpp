@@ -0,0 +1,150 @@
+#include "audio.h"
+#include "../uicommon/FAudioUI_bench.h"
+
+#include <FAudio.h>
+#include <FAudioFX.h>
+#include <FAPO.h>
+#include <SDL.h>
+#include <stdio.h>
+
+// every input/output layout the reverb supports, see FAudioFXReverb_LockForProcess
+static const struct
+{
+	uint16_t in_channels;
+	uint16_t out_channels;
+} bench_layouts[] =
+{
+	{ 1, 1 },
+	{ 1, 6 },
+	{ 1, 8 },
+	{ 2, 2 },
+	{ 2, 4 },
+	{ 2, 6 },
+	{ 2, 8 }
+};
+
+// a long tail, so the network is busy for the whole signal
+static const int bench_preset = 7; // Concert Hall
+
+static uint64_t bench_reverb_run(
+	const FAudioFXReverbParameters *params,
+	const float *signal,
+	uint16_t in_channels,
+	uint16_t out_channels,
+	float *output
+) {
+	FAPO *fapo;
+	FAudioWaveFormatEx in_format, out_format;
+	FAPOLockForProcessBufferParameters in_lock, out_lock;
+	FAPOProcessBufferParameters in_params, out_params;
+	float in_block[BENCH_BLOCK_FRAMES * 2];
+	uint32_t frames = Bench_FrameCount();
+	uint32_t offset, count;
+	uint64_t start, ticks = 0;
+
+	if (FAudioCreateReverb(&fapo, 0) != 0)
+	{
+		return 0;
+	}
+	fapo->SetParameters(fapo, params, sizeof(*params));
+
+	in_format.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+	in_format.nChannels = in_channels;
+	in_format.nSamplesPerSec = BENCH_SAMPLERATE;
+	in_format.wBitsPerSample = 32;
+	in_format.nBlockAlign = in_channels * 4;
+	in_format.nAvgBytesPerSec = BENCH_SAMPLERATE * in_format.nBlockAlign;
+	in_format.cbSize = 0;
+	out_format = in_format;
+	out_format.nChannels = out_channels;
+	out_format.nBlockAlign = out_channels * 4;
+	out_format.nAvgBytesPerSec = BENCH_SAMPLERATE * out_format.nBlockAlign;
+
+	in_lock.pFormat = &in_format;
+	in_lock.MaxFrameCount = BENCH_BLOCK_FRAMES;
+	out_lock.pFormat = &out_format;
+	out_lock.MaxFrameCount = BENCH_BLOCK_FRAMES;
+	fapo->LockForProcess(fapo, 1, &in_lock, 1, &out_lock);
+
+	for (offset = 0; offset < frames; offset += count)
+	{
+		count = SDL_min(BENCH_BLOCK_FRAMES, frames - offset);
+
+		// the reverb may clear its input, so it gets a copy like it would in a voice
+		SDL_memcpy(
+			in_block,
+			signal + offset * in_channels,
+			sizeof(float) * count * in_channels
+		);
+		in_params.pBuffer = in_block;
+		in_params.BufferFlags = FAPO_BUFFER_VALID;
+		in_params.ValidFrameCount = count;
+		out_params.pBuffer = output + offset * out_channels;
+		out_params.BufferFlags = FAPO_BUFFER_VALID;
+		out_params.ValidFrameCount = count;
+
+		start = Bench_Ticks();
+		fapo->Process(fapo, 1, &in_params, 1, &out_params, 1);
+		ticks += Bench_Ticks() - start;
+	}
+
+	fapo->UnlockForProcess(fapo);
+	fapo->Release(fapo);
+	return ticks;
+}
+
+int FAudioTool_Bench(int argc, char **argv)
+{
+	FAudioFXReverbParameters params;
+	float *signal, *output;
+	uint32_t frames, i, run;
+	uint64_t ticks, best;
+	char name[64];
+
+	if (!Bench_Init(argc, argv))
+	{
+		return 1;
+	}
+	frames = Bench_FrameCount();
+
+	ReverbConvertI3DL2ToNative(
+		(const FAudioFXReverbI3DL2Parameters *) &audio_reverb_presets_i3dl2[bench_preset],
+		&params
+	);
+
+	for (i = 0; i < SDL_arraysize(bench_layouts); i += 1)
+	{
+		signal = Bench_CreateSignal(bench_layouts[i].in_channels);
+		output = (float*) SDL_malloc(sizeof(float) * frames * bench_layouts[i].out_channels);
+
+		best = 0;
+		for (run = 0; run < Bench_RunCount(); run += 1)
+		{
+			ticks = bench_reverb_run(
+				&params,
+				signal,
+				bench_layouts[i].in_channels,
+				bench_layouts[i].out_channels,
+				output
+			);
+			if (run == 0 || ticks < best)
+			{
+				best = ticks;
+			}
+		}
+
+		SDL_snprintf(
+			name,
+			sizeof(name),
+			"reverb %u->%u",
+			bench_layouts[i].in_channels,
+			bench_layouts[i].out_channels
+		);
+		Bench_Result(name, best, frames, output, frames * bench_layouts[i].out_channels);
+
+		SDL_free(output);
+		SDL_free(signal);
+	}
+
+	return Bench_Quit();
+}
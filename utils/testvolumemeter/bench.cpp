@@ -0,0 +1,111 @@
+#include "../uicommon/FAudioUI_bench.h"
+
+#include <FAudio.h>
+#include <FAudioFX.h>
+#include <FAPO.h>
+#include <SDL.h>
+
+/* The meter takes any layout, these are the ones voices usually have */
+static const uint16_t bench_channels[] = { 1, 2, 4, 6, 8 };
+
+/* The output is the peak and RMS levels of every block, per channel */
+static uint64_t bench_volumemeter_run(
+	const float *signal,
+	uint16_t channels,
+	float *levels
+) {
+	FAPO *fapo;
+	FAudioWaveFormatEx format;
+	FAPOLockForProcessBufferParameters lock;
+	FAPOProcessBufferParameters params;
+	FAudioFXVolumeMeterLevels meter;
+	float block[BENCH_BLOCK_FRAMES * 8];
+	uint32_t frames = Bench_FrameCount();
+	uint32_t offset, count;
+	uint64_t start, ticks = 0;
+
+	if (FAudioCreateVolumeMeter(&fapo, 0) != 0)
+	{
+		return 0;
+	}
+
+	format.wFormatTag = FAUDIO_FORMAT_IEEE_FLOAT;
+	format.nChannels = channels;
+	format.nSamplesPerSec = BENCH_SAMPLERATE;
+	format.wBitsPerSample = 32;
+	format.nBlockAlign = channels * 4;
+	format.nAvgBytesPerSec = BENCH_SAMPLERATE * format.nBlockAlign;
+	format.cbSize = 0;
+
+	lock.pFormat = &format;
+	lock.MaxFrameCount = BENCH_BLOCK_FRAMES;
+	fapo->LockForProcess(fapo, 1, &lock, 1, &lock);
+
+	meter.ChannelCount = channels;
+	for (offset = 0; offset < frames; offset += count)
+	{
+		count = SDL_min(BENCH_BLOCK_FRAMES, frames - offset);
+
+		/* In place, like in a voice's effect chain */
+		SDL_memcpy(
+			block,
+			signal + offset * channels,
+			sizeof(float) * count * channels
+		);
+		params.pBuffer = block;
+		params.BufferFlags = FAPO_BUFFER_VALID;
+		params.ValidFrameCount = count;
+
+		start = Bench_Ticks();
+		fapo->Process(fapo, 1, &params, 1, &params, 1);
+		ticks += Bench_Ticks() - start;
+
+		meter.pPeakLevels = levels;
+		meter.pRMSLevels = levels + channels;
+		fapo->GetParameters(fapo, &meter, sizeof(meter));
+		levels += channels * 2;
+	}
+
+	fapo->UnlockForProcess(fapo);
+	fapo->Release(fapo);
+	return ticks;
+}
+
+int FAudioTool_Bench(int argc, char **argv)
+{
+	float *signal, *levels;
+	uint32_t frames, blocks, i, run;
+	uint64_t ticks, best;
+	char name[64];
+
+	if (!Bench_Init(argc, argv))
+	{
+		return 1;
+	}
+	frames = Bench_FrameCount();
+	blocks = (frames + BENCH_BLOCK_FRAMES - 1) / BENCH_BLOCK_FRAMES;
+
+	for (i = 0; i < SDL_arraysize(bench_channels); i += 1)
+	{
+		signal = Bench_CreateSignal(bench_channels[i]);
+		levels = (float*) SDL_malloc(sizeof(float) * blocks * bench_channels[i] * 2);
+
+		best = 0;
+		for (run = 0; run < Bench_RunCount(); run += 1)
+		{
+			ticks = bench_volumemeter_run(signal, bench_channels[i], levels);
+			if (run == 0 || ticks < best)
+			{
+				best = ticks;
+			}
+		}
+
+		SDL_snprintf(name, sizeof(name), "volumemeter %uch", bench_channels[i]);
+		Bench_Result(name, best, frames, levels, blocks * bench_channels[i] * 2);
+
+		SDL_free(levels);
+		SDL_free(signal);
+	}
+
+	return Bench_Quit();
+}
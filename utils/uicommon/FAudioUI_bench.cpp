@@ -0,0 +1,318 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2018 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+#include "FAudioUI_bench.h"
+
+#include <SDL.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Golden files are the outputs one after another, each as
+ * uint32 name length, name, uint32 float count, floats, in native byte order.
+ */
+static const char GOLDEN_MAGIC[8] = { 'F', 'A', 'B', 'E', 'N', 'C', 'H', '1' };
+
+struct GoldenOutput
+{
+	char *name;
+	uint32_t count;
+	float *data;
+};
+
+static uint32_t frameCount = BENCH_SAMPLERATE;
+static uint32_t runCount = 3;
+static double tolerance = 1e-4;
+static FILE *saveFile = NULL;
+static GoldenOutput *golden = NULL;
+static uint32_t goldenCount = 0;
+static uint32_t mismatches = 0;
+
+static uint8_t LoadGolden(const char *path)
+{
+	FILE *file;
+	char magic[8];
+	uint32_t length;
+	GoldenOutput *output;
+
+	file = fopen(path, "rb");
+	if (file == NULL)
+	{
+		fprintf(stderr, "Could not open %s\n", path);
+		return 0;
+	}
+	if (	fread(magic, sizeof(magic), 1, file) != 1 ||
+		memcmp(magic, GOLDEN_MAGIC, sizeof(magic)) != 0	)
+	{
+		fprintf(stderr, "%s is not a golden file\n", path);
+		fclose(file);
+		return 0;
+	}
+
+	while (fread(&length, sizeof(length), 1, file) == 1)
+	{
+		golden = (GoldenOutput*) realloc(
+			golden,
+			sizeof(GoldenOutput) * (goldenCount + 1)
+		);
+		output = &golden[goldenCount];
+		output->name = (char*) malloc(length + 1);
+		output->name[length] = '\0';
+		output->data = NULL;
+		if (	fread(output->name, 1, length, file) == length &&
+			fread(&output->count, sizeof(uint32_t), 1, file) == 1	)
+		{
+			output->data = (float*) malloc(sizeof(float) * output->count);
+			if (fread(output->data, sizeof(float), output->count, file) == output->count)
+			{
+				goldenCount += 1;
+				continue;
+			}
+		}
+
+		/* A record that got cut short is left out */
+		fprintf(stderr, "%s is truncated\n", path);
+		free(output->name);
+		free(output->data);
+		break;
+	}
+	fclose(file);
+	return 1;
+}
+
+static const GoldenOutput* FindGolden(const char *name)
+{
+	uint32_t i;
+	for (i = 0; i < goldenCount; i += 1)
+	{
+		if (strcmp(golden[i].name, name) == 0)
+		{
+			return &golden[i];
+		}
+	}
+	return NULL;
+}
+
+uint8_t Bench_Init(int argc, char **argv)
+{
+	int i;
+
+	for (i = 0; i < argc; i += 1)
+	{
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+		{
+			frameCount = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc)
+		{
+			runCount = (uint32_t) atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc)
+		{
+			tolerance = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+		{
+			if (!LoadGolden(argv[++i]))
+			{
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+		{
+			saveFile = fopen(argv[++i], "wb");
+			if (saveFile == NULL)
+			{
+				fprintf(stderr, "Could not write %s\n", argv[i]);
+				return 0;
+			}
+			fwrite(GOLDEN_MAGIC, sizeof(GOLDEN_MAGIC), 1, saveFile);
+		}
+		else
+		{
+			fprintf(
+				stderr,
+				"Usage: --bench [--frames N] [--runs N] [--save FILE]\n"
+				"               [--golden FILE] [--tolerance X]\n"
+			);
+			return 0;
+		}
+	}
+	if (frameCount < BENCH_BLOCK_FRAMES)
+	{
+		frameCount = BENCH_BLOCK_FRAMES;
+	}
+	if (runCount == 0)
+	{
+		runCount = 1;
+	}
+
+	printf(
+		"%u frames at %u Hz, best of %u runs\n\n",
+		frameCount,
+		BENCH_SAMPLERATE,
+		runCount
+	);
+	return 1;
+}
+
+int Bench_Quit()
+{
+	uint32_t i;
+
+	if (saveFile != NULL)
+	{
+		fclose(saveFile);
+	}
+	for (i = 0; i < goldenCount; i += 1)
+	{
+		free(golden[i].name);
+		free(golden[i].data);
+	}
+	free(golden);
+
+	if (mismatches > 0)
+	{
+		printf("\n%u outputs did not match\n", mismatches);
+		return 1;
+	}
+	return 0;
+}
+
+uint32_t Bench_FrameCount()
+{
+	return frameCount;
+}
+
+uint32_t Bench_RunCount()
+{
+	return runCount;
+}
+
+float* Bench_CreateSignal(uint32_t channels)
+{
+	float *signal;
+	uint32_t i, c, t;
+	uint32_t seed;
+	float env;
+
+	signal = (float*) SDL_malloc(sizeof(float) * frameCount * channels);
+	for (c = 0; c < channels; c += 1)
+	{
+		seed = 1 + c;
+		for (i = 0; i < frameCount; i += 1)
+		{
+			t = i % BENCH_SAMPLERATE;
+			if (t < BENCH_SAMPLERATE / 4)
+			{
+				/* Decaying noise, like a drum hit */
+				seed = seed * 1103515245 + 12345;
+				env = 1.0f - (float) t / (BENCH_SAMPLERATE / 4);
+				signal[i * channels + c] = env * env * (
+					((seed >> 16) & 0x7FFF) / 16383.5f - 1.0f
+				);
+			}
+			else if (t < BENCH_SAMPLERATE / 2)
+			{
+				/* A tone, higher for each channel */
+				signal[i * channels + c] = 0.5f * sinf(
+					2.0f * 3.14159265f * 220.0f * (c + 1) *
+					t / BENCH_SAMPLERATE
+				);
+			}
+			else
+			{
+				/* Silence, for tails to ring out in */
+				signal[i * channels + c] = 0.0f;
+			}
+		}
+	}
+	return signal;
+}
+
+uint64_t Bench_Ticks()
+{
+	return SDL_GetPerformanceCounter();
+}
+
+void Bench_Result(
+	const char *name,
+	uint64_t ticks,
+	uint64_t frames,
+	const float *output,
+	uint32_t outputCount
+) {
+	const GoldenOutput *expected;
+	double nsPerFrame, error;
+	uint32_t i, length;
+
+	nsPerFrame = (double) ticks * 1e9 /
+		SDL_GetPerformanceFrequency() /
+		(frames > 0 ? frames : 1);
+	printf("%-32s %10.2f ns/frame", name, nsPerFrame);
+
+	if (saveFile != NULL)
+	{
+		length = (uint32_t) strlen(name);
+		fwrite(&length, sizeof(length), 1, saveFile);
+		fwrite(name, 1, length, saveFile);
+		fwrite(&outputCount, sizeof(outputCount), 1, saveFile);
+		fwrite(output, sizeof(float), outputCount, saveFile);
+	}
+
+	if (goldenCount > 0)
+	{
+		expected = FindGolden(name);
+		if (expected == NULL)
+		{
+			printf("   not in golden file");
+		}
+		else if (expected->count != outputCount)
+		{
+			printf("   MISMATCH, %u values instead of %u", outputCount, expected->count);
+			mismatches += 1;
+		}
+		else
+		{
+			error = 0.0;
+			for (i = 0; i < outputCount; i += 1)
+			{
+				error = SDL_max(error, fabs(output[i] - expected->data[i]));
+			}
+			if (error > tolerance)
+			{
+				printf("   MISMATCH, max error %g", error);
+				mismatches += 1;
+			}
+			else
+			{
+				printf("   max error %g", error);
+			}
+		}
+	}
+	printf("\n");
+}
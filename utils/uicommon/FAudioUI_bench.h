@@ -0,0 +1,73 @@
+/* FAudio - XAudio Reimplementation for FNA
+ *
+ * Copyright (c) 2011-2018 Ethan Lee, Luigi Auriemma, and the MonoGame Team
+ *
+ * This software is provided 'as-is', without any express or implied warranty.
+ * In no event will the authors be held liable for any damages arising from
+ * the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ * claim that you wrote the original software. If you use this software in a
+ * product, an acknowledgment in the product documentation would be
+ * appreciated but is not required.
+ *
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ * misrepresented as being the original software.
+ *
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Ethan "flibitijibibo" Lee <flibitijibibo@flibitijibibo.com>
+ *
+ */
+
+#ifndef FAUDIOUI_BENCH_H
+#define FAUDIOUI_BENCH_H
+
+#include <stdint.h>
+
+/* Headless benchmarks for the test tools.
+ *
+ * Running a tool with --bench skips the window and calls its FAudioTool_Bench
+ * with the remaining arguments, which Bench_Init parses:
+ *
+ *	--frames N	Frames of signal per configuration (default 48000)
+ *	--runs N	Times each configuration is timed, the best one is kept
+ *	--save FILE	Write the output of every configuration to FILE
+ *	--golden FILE	Compare the output of every configuration to FILE
+ *	--tolerance X	Largest difference allowed against FILE (default 1e-4)
+ *
+ * A tool then runs each of its configurations over Bench_CreateSignal and
+ * hands the time it took and what came out to Bench_Result. Bench_Quit writes
+ * --save and returns the exit code, which is 1 if any output didn't match.
+ */
+
+#define BENCH_SAMPLERATE 48000
+#define BENCH_BLOCK_FRAMES 480
+
+uint8_t Bench_Init(int argc, char **argv);
+int Bench_Quit();
+
+uint32_t Bench_FrameCount();
+uint32_t Bench_RunCount();
+
+/* A second of noise bursts, tones and silence, repeated, different per
+ * channel. Free with SDL_free.
+ */
+float* Bench_CreateSignal(uint32_t channels);
+
+uint64_t Bench_Ticks();
+
+/* ticks is the best run's time, output is the same for every run */
+void Bench_Result(
+	const char *name,
+	uint64_t ticks,
+	uint64_t frames,
+	const float *output,
+	uint32_t outputCount
+);
+
+#endif /* FAUDIOUI_BENCH_H */
@@ -53,6 +53,7 @@ extern int TOOL_HEIGHT;
 extern void FAudioTool_Init();
 extern void FAudioTool_Update();
 extern void FAudioTool_Quit();
+extern int FAudioTool_Bench(int argc, char **argv);
 
 /* FAudioUI_ui.cpp */
 
@@ -196,6 +197,12 @@ int main(int argc, char **argv)
 	int tw, th;
 	GLuint fontTexture;
 
+	/* No window for benchmarks, see FAudioUI_bench.h */
+	if (argc > 1 && SDL_strcmp(argv[1], "--bench") == 0)
+	{
+		return FAudioTool_Bench(argc - 2, argv + 2);
+	}
+
 	/* Create window/context */
 	SDL_Init(SDL_INIT_VIDEO);
 	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);